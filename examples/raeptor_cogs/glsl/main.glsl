@@ -0,0 +1,9 @@
+#version 460 core
+#include <common/constants.glsl>
+#include <glsl/data.glsl>
+
+#pragma rgsl stage(vert)
+#include <common/main.vs>
+
+#pragma rgsl stage(frag)
+#include <common/main.fs>
\ No newline at end of file
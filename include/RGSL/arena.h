@@ -0,0 +1,103 @@
+/** ********************************************************************************
+ * @section Arena_Overview Overview
+ * @file arena.h
+ * @brief Header file for the arena allocator.
+ * @details
+ * Typical use cases:
+ * - Allocating the nodes of a syntax tree without one allocation per node, and releasing them at once.
+ * *********************************************************************************
+ * @section Arena_Header Header
+ * <RGSL/arena.h>
+ ***********************************************************************************
+ * @section Arena_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stddef.h>
+
+/**
+ * @brief Structure to hold a chunk of an arena.
+ * 
+ * Chunks are chained from the most recent one, and their memory follows the header.
+ */
+struct rgsl_arena_chunk {
+    struct rgsl_arena_chunk* next;
+    size_t size;
+    size_t used;
+};
+
+/**
+ * @brief Structure to hold an arena allocator.
+ * 
+ * Allocations are carved from chunks of growing size, and only released all
+ * together with the arena, so that building a tree costs no more than moving a
+ * pointer per node. The total size allocated is tracked for reports.
+ */
+struct rgsl_arena {
+    struct rgsl_arena_chunk* chunks;
+    size_t chunk_size;
+    size_t allocated;
+};
+
+/**
+ * @brief Initializes an empty arena.
+ * @param arena The arena to initialize.
+ * @param chunk_size The size of its first chunk, the next ones doubling up to 1 MiB.
+ */
+void rgsl_arena_init(struct rgsl_arena* arena, size_t chunk_size);
+
+/**
+ * @brief Allocates zeroed memory from an arena.
+ * @param arena The arena to allocate from.
+ * @param size The size of the allocation.
+ * @return The allocation, aligned for any type, valid until the arena is released.
+ */
+void* rgsl_arena_alloc(struct rgsl_arena* arena, size_t size);
+
+/**
+ * @brief Grows an array allocated from an arena.
+ * @param arena The arena of the array.
+ * @param array The array, or NULL.
+ * @param old_size The size of the array.
+ * @param new_size The size needed.
+ * @return The array, moved to a new allocation of new_size bytes with its content copied.
+ * 
+ * The old allocation is only released with the arena, arrays should be grown
+ * geometrically.
+ */
+void* rgsl_arena_grow(struct rgsl_arena* arena, void* array, size_t old_size, size_t new_size);
+
+/**
+ * @brief Releases every allocation of an arena, leaving it empty.
+ * @param arena The arena to release.
+ */
+void rgsl_arena_free(struct rgsl_arena* arena);
\ No newline at end of file
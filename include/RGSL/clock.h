@@ -0,0 +1,86 @@
+/** ********************************************************************************
+ * @section Clock_Overview Overview
+ * @file clock.h
+ * @brief Header file for monotonic time measurement.
+ * @details
+ * Typical use cases:
+ * - Measuring the time spent in each compilation step.
+ * *********************************************************************************
+ * @section Clock_Header Header
+ * <RGSL/clock.h>
+ ***********************************************************************************
+ * @section Clock_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+#pragma once
+
+/**
+ * @brief Returns the current time of a monotonic clock.
+ * @return The time in seconds, from an arbitrary origin.
+ * 
+ * This function is meant for measuring durations: only differences between
+ * two values are meaningful. It is not affected by changes of the system time.
+ * 
+ * @code{c}
+ * double start = rgsl_clock_seconds();
+ * compile_shader();
+ * rgsl_printf_info(2, "Compiled in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+ * @endcode
+ */
+double rgsl_clock_seconds();
+
+/**
+ * @brief Returns the time elapsed since a previous clock value.
+ * @param start A value previously returned by rgsl_clock_seconds.
+ * @return The elapsed time in milliseconds.
+ */
+double rgsl_clock_elapsed_ms(double start);
\ No newline at end of file
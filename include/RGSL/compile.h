@@ -55,11 +55,75 @@ struct rgsl_language_compiler_mapping {
 /**
  * @brief Compiles the given shader data into the desired output format.
  * @param shader The shader data to compile.
- * @param output_file The path to the output file where the compiled shader will be saved.
+ * @param out_output Pointer receiving the compiled shader, to be freed with rgsl_free_file_buffer.
+ * @param out_size Pointer receiving the size of the SPIR-V output in bytes, or 0 for text output.
  * @return true if compilation was successful, false otherwise.
  * 
- * This function compiles the provided shader code and writes the compiled output
- * to the specified output file. The compilation process may vary depending on
- * the shader language and stage.
+ * This function compiles the provided shader code to GLSL or SPIR-V, according to
+ * the global options. The compilation process may vary depending on the shader
+ * language and stage. Writing the output is left to the caller, so that it can
+ * overlap with the compilation of the next shader.
  */
-bool rgsl_compile_shader(struct rgsl_shader_data * shader, const char* output_file);
\ No newline at end of file
+bool rgsl_compile_shader(struct rgsl_shader_data * shader, char** out_output, size_t* out_size);
+
+/**
+ * @brief Compiles the GLSL code of a shader to SPIR-V with glslang.
+ * @param shader The shader, whose program is reused if validation already linked one.
+ * @param glsl_code The GLSL code, freed by this function.
+ * @param out_words Pointer receiving the SPIR-V words, to be freed with rgsl_free_file_buffer.
+ * @param out_size Pointer receiving the size of the SPIR-V in bytes.
+ * @return true if the code was compiled, false otherwise.
+ * 
+ * With specialization constants, the SPIR-V of identical code is reused (see
+ * rgsl_compile_finalize). When embedding,
+ * the interface hash of the shader is computed from the program.
+ */
+bool rgsl_compile_spirv(struct rgsl_shader_data* shader, char* glsl_code, char** out_words, size_t* out_size);
+
+/**
+ * @brief Emits the SPIR-V of a shader directly from its checked RGSL module.
+ * @param shader The shader, whose module is built.
+ * @param out_words Pointer receiving the SPIR-V words, to be freed with rgsl_free_file_buffer.
+ * @param out_size Pointer receiving the size of the SPIR-V in bytes.
+ * @return true if the module was emitted, false otherwise.
+ * 
+ * Neither GLSL nor glslang are involved; with --spirv-validate, the module is
+ * checked with the validator of SPIRV-Tools. When embedding, the interface hash
+ * of the shader is computed from the interface laid out by the backend.
+ */
+bool rgsl_compile_module_spirv(struct rgsl_shader_data* shader, char** out_words, size_t* out_size);
+
+/**
+ * @brief Checks SPIR-V with the validator of SPIRV-Tools, if --spirv-validate was given.
+ * @param shader The shader the SPIR-V was compiled from, named in the errors.
+ * @param words The SPIR-V words.
+ * @param size The size of the SPIR-V in bytes.
+ * @param vulkan_version The Vulkan version the SPIR-V is for (e.g. 120 for 1.2), or 0 for OpenGL.
+ * @return true if the SPIR-V is valid or validation was not requested, false otherwise.
+ */
+bool rgsl_validate_spirv(const struct rgsl_shader_data* shader, const char* words, size_t size, int vulkan_version);
+
+/**
+ * @brief Hashes the interface of a shader, for the generated C file.
+ * @param shader The shader, whose program is built from the code if it has none yet.
+ * @param glsl_code The GLSL code of the shader, or NULL if its program is built.
+ */
+void rgsl_hash_shader_interface(struct rgsl_shader_data* shader, const char* glsl_code);
+
+/**
+ * @brief Sets up the SPIR-V kept for reuse by rgsl_compile_shader.
+ * 
+ * With specialization constants, the SPIR-V of the last compiled shaders is kept,
+ * keyed by a hash of their stage, their path when includes are native, and their
+ * preprocessed code, so that variants left identical once their macros are
+ * promoted are only compiled once. The cache is shared by the compiling threads
+ * under a lock. Without this call, nothing is reused.
+ */
+void rgsl_compile_initialize();
+
+/**
+ * @brief Releases the SPIR-V kept for reuse by rgsl_compile_shader.
+ * 
+ * This function should be called once every shader has been compiled.
+ */
+void rgsl_compile_finalize();
\ No newline at end of file
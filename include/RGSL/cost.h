@@ -0,0 +1,116 @@
+/** ********************************************************************************
+ * @section Cost_Overview Overview
+ * @file cost.h
+ * @brief Header file for the static cost report of compiled SPIR-V.
+ * @details
+ * Typical use cases:
+ * - Spotting expensive shaders, and shaders becoming heavier, before they run on a device.
+ * *********************************************************************************
+ * @section Cost_Header Header
+ * <RGSL/cost.h>
+ ***********************************************************************************
+ * @section Cost_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Structure to hold the static cost of a SPIR-V module.
+ * 
+ * The instructions are counted in the function bodies, and split by class: arithmetic
+ * and logic (including extended instructions such as GLSL.std.450 calls), texture
+ * sampling and image access, conditional branches, discards and derivatives.
+ * 
+ * The loop depth is the deepest nesting of structured loops, and the live value
+ * count is the largest number of SSA values alive at once, estimated over the
+ * instructions in module order. Both are estimates of register pressure and
+ * divergence, not exact figures for a given device.
+ * 
+ * The interface counts exclude built-in variables, and the resources are split by
+ * kind: uniform blocks, storage blocks, samplers and images, loose uniforms and
+ * push constant blocks.
+ */
+struct rgsl_shader_cost {
+    size_t instructions;
+    size_t alu;
+    size_t texture;
+    size_t branches;
+    size_t discards;
+    size_t derivatives;
+    size_t loop_depth;
+    size_t live_values;
+    size_t inputs;
+    size_t outputs;
+    size_t uniform_blocks;
+    size_t storage_blocks;
+    size_t samplers;
+    size_t uniforms;
+    size_t push_constants;
+};
+
+/**
+ * @brief Computes the static cost of a SPIR-V module.
+ * @param words The SPIR-V words of the module.
+ * @param word_count The number of words.
+ * @param out_cost Pointer receiving the cost.
+ * @return true if the module could be walked, false if it is malformed.
+ */
+bool rgsl_analyze_spirv(const uint32_t* words, size_t word_count, struct rgsl_shader_cost* out_cost);
+
+/**
+ * @brief Tells whether a cost report was requested.
+ * @return true if --cost-report or --cost-baseline was given, false otherwise.
+ */
+bool rgsl_cost_report_enabled();
+
+/**
+ * @brief Adds the cost of one shader to the report.
+ * @param name The name of the shader in the report, usually its path.
+ * @param words The SPIR-V words of the shader.
+ * @param word_count The number of words.
+ * 
+ * A name already in the report gets a "#N" suffix, so that the variants of a
+ * shader keep distinct, stable names from one run to the next.
+ */
+void rgsl_cost_report_add(const char* name, const uint32_t* words, size_t word_count);
+
+/**
+ * @brief Prints and writes the cost report, then releases it.
+ * @return false if the report could not be written, or if a shader became notably
+ * heavier than in the baseline, true otherwise.
+ * 
+ * The report is printed as a table, written as JSON to the --cost-report file, and
+ * compared with the --cost-baseline file. A shader is flagged when one of its
+ * counts grows by more than --cost-threshold percent over the baseline.
+ */
+bool rgsl_cost_report_finalize();
\ No newline at end of file
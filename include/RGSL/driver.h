@@ -0,0 +1,86 @@
+/** ********************************************************************************
+ * @section Driver_Overview Overview
+ * @file driver.h
+ * @brief Header file for running the jobs of an invocation.
+ * @details
+ * Typical use cases:
+ * - Validating and compiling a list of shaders, collecting the failures.
+ * *********************************************************************************
+ * @section Driver_Header Header
+ * <RGSL/driver.h>
+ ***********************************************************************************
+ * @section Driver_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/manifest.h>
+
+/**
+ * @brief Runs the requested actions on every job of a manifest.
+ * @param manifest The jobs to run.
+ * @return The exit code of the invocation: 0 if every job succeeded, 1 otherwise.
+ * 
+ * A failing job does not stop the others. The failures are collected and
+ * summarized once every job has run. The shaders compiled with --embed are
+ * streamed to the packager as they complete and released right away, the
+ * package only replaces the output file if every job succeeded. The stages of a
+ * file holding several are packaged together, as one program.
+ * 
+ * When there are several jobs, they go through a pipeline: a reader thread reads
+ * the input files ahead and a writer thread writes the outputs behind, while the
+ * shaders are compiled on the calling thread. The stages are joined by bounded
+ * queues, so only a few shaders are held in memory at once. --serial-io runs
+ * every step on the calling thread instead.
+ */
+int rgsl_run_jobs(const struct rgsl_manifest* manifest);
\ No newline at end of file
@@ -39,6 +39,7 @@
  ***********************************************************************************/
 
 #pragma once
+#include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
@@ -75,33 +76,180 @@ void rgsl_glslang_initialize();
 void rgsl_glslang_finalize();
 
 /**
- * @brief Validates GLSL shader source code.
+ * @brief Opaque handle to a parsed and linked glslang shader program.
+ * 
+ * A program is created once per shader, then shared by validation and SPIR-V
+ * generation, so the shader is parsed only once whatever the requested actions.
+ */
+struct rgsl_glslang_program;
+
+/**
+ * @brief Parses and links GLSL shader source code.
  * @param source The GLSL shader source code as a null-terminated string.
+ * @param source_name The path of the shader file, used in the log and to resolve quoted includes. May be NULL.
  * @param stage_str The shader stage as a string (e.g., "vert", "frag").
- * @param out_log Pointer to a char pointer that will receive the validation log.
- * @return true if the shader code is valid, false otherwise.
+ * @param native_includes Whether #include directives are resolved by glslang (see below).
+ * @param spirv_rules Whether the source follows the GL_ARB_gl_spirv rules, required by
+ * specialization constants. Unassigned locations and bindings are then mapped automatically.
+ * @param out_log Pointer to a char pointer that will receive the parse and link log.
+ * @return A handle to the linked program, or NULL if the shader code is invalid.
+ * 
+ * This function uses the glslang library to parse and link the provided GLSL shader
+ * code for the specified shader stage. The log is returned via the out_log parameter,
+ * whether the shader is valid or not.
+ * 
+ * When native_includes is set, the source must enable GL_GOOGLE_include_directive.
+ * Included files are then resolved with rgsl_resolve_include and read through the
+ * include content cache, so a header shared by many shaders is read only once.
  * 
- * This function uses the glslang library to validate the provided GLSL shader code
- * for the specified shader stage. The validation log is returned via the out_log
- * parameter, which should be freed by the caller if not NULL.
+ * Once glslang is initialized, programs can be created on several threads at once,
+ * as long as none of them resolves includes natively.
  * 
- * @note The caller is responsible for freeing the out_log buffer.
+ * @note The caller is responsible for freeing the out_log buffer, and for destroying
+ * the returned program with rgsl_glslang_destroy_program.
  */
-bool rgsl_glslang_validate_glsl(const char* source, const char* stage_str, char** out_log);
+struct rgsl_glslang_program* rgsl_glslang_create_program(const char* source, const char* source_name, const char* stage_str, bool native_includes, bool spirv_rules, char** out_log);
 
 /**
- * @brief Compiles GLSL shader source code to SPIR-V.
- * @param source The GLSL shader source code as a null-terminated string.
- * @param stage The shader stage as a string (e.g., "vert", "frag").
- * @return A glslang_result_t structure containing the compilation result,
- * including SPIR-V words, word count, log, and success status.
+ * @brief Parses and links GLSL shader source code written for Vulkan.
+ * @param source The GLSL shader source code as a null-terminated string, includes spliced.
+ * @param source_name The path of the shader file, used in the log. May be NULL.
+ * @param stage_str The shader stage as a string (e.g., "vert", "frag").
+ * @param vulkan_version The Vulkan version, 100 times the major plus 10 times the minor (e.g. 120 for 1.2).
+ * @param out_log Pointer to a char pointer that will receive the parse and link log.
+ * @return A handle to the linked program, or NULL if the shader code is invalid or the version unknown.
+ * 
+ * As rgsl_glslang_create_program, under the GL_KHR_vulkan_glsl rules: VULKAN is
+ * defined, and the generated SPIR-V has the newest version the Vulkan version takes.
+ * Unassigned locations and bindings are mapped automatically.
+ */
+struct rgsl_glslang_program* rgsl_glslang_create_vulkan_program(const char* source, const char* source_name, const char* stage_str, int vulkan_version, char** out_log);
+
+/**
+ * @brief Generates the SPIR-V binary of a linked program.
+ * @param program The program returned by rgsl_glslang_create_program.
+ * @return A rgsl_glslang_result structure containing the SPIR-V words, word count,
+ * log, and success status.
+ * 
+ * The caller is responsible for freeing the log and words in the rgsl_glslang_result
+ * structure using rgsl_glslang_free_result.
+ */
+struct rgsl_glslang_result rgsl_glslang_generate_spirv(const struct rgsl_glslang_program* program);
+
+/**
+ * @brief Validates SPIR-V words with the validator of SPIRV-Tools.
+ * @param words The words of the module.
+ * @param word_count The number of words.
+ * @param vulkan_version The Vulkan version the module is for, as for rgsl_glslang_create_vulkan_program,
+ * or 0 for OpenGL 4.5.
+ * @return NULL if the module is valid for its environment, the messages of the validator otherwise.
  * 
- * This function compiles the provided GLSL shader code for the specified shader stage
- * into SPIR-V binary format. The resulting SPIR-V words and compilation log are
- * included in the returned rgsl_glslang_result structure. The caller is responsible for freeing
- * the log and words in the rgsl_glslang_result structure using rgsl_glslang_free_result.
+ * @note The caller is responsible for freeing the returned messages with free.
+ */
+char* rgsl_glslang_validate_spirv(const uint32_t* words, size_t word_count, int vulkan_version);
+
+/**
+ * @brief Describes the interface of a linked program from its reflection.
+ * @param program The program returned by rgsl_glslang_create_program.
+ * @return A null-terminated description, or NULL if the reflection could not be built.
+ * 
+ * The description lists the stage, the pipeline inputs and outputs, the uniforms,
+ * and the uniform and storage blocks with their types, sizes, offsets and layout
+ * qualifiers, one per line and sorted. Two shaders with the same description can
+ * share the same pipeline layout and vertex input state, whatever their code.
+ * 
+ * @note The caller is responsible for freeing the returned buffer with free.
+ */
+char* rgsl_glslang_describe_interface(struct rgsl_glslang_program* program);
+
+/**
+ * @brief Enumeration of the patterns found by the performance lint.
+ * 
+ * Each pattern is costly on tile-based mobile GPUs:
+ * - RGSL_LINT_DISCARD: a discard, which disables early depth testing.
+ * - RGSL_LINT_DIVERGENT_SAMPLING: texture sampling with implicit derivatives, or a
+ *   derivative, in control flow that may differ between the fragments of a quad.
+ * - RGSL_LINT_DYNAMIC_INDEXING: an array of 16 or more elements, or of unknown size,
+ *   indexed by a value that may differ between invocations.
+ * - RGSL_LINT_HIGHP_MATH: a transcendental or otherwise heavy function evaluated in
+ *   highp in an OpenGL ES fragment shader.
+ * - RGSL_LINT_PER_DRAW_WORK: arithmetic that only reads uniforms and constants, so
+ *   that every invocation recomputes the same value.
+ */
+enum rgsl_lint_rule {
+    RGSL_LINT_DISCARD,
+    RGSL_LINT_DIVERGENT_SAMPLING,
+    RGSL_LINT_DYNAMIC_INDEXING,
+    RGSL_LINT_HIGHP_MATH,
+    RGSL_LINT_PER_DRAW_WORK,
+    RGSL_LINT_RULE_COUNT
+};
+
+/**
+ * @brief Callback receiving the findings of the performance lint.
+ * @param rule The pattern found.
+ * @param file The name of the source string the finding is in, as given to glslang
+ * (the shader path, or the resolved path of a file included by glslang). May be NULL.
+ * @param line The 1-based line of the finding in that source string.
+ * @param message A description of the finding.
+ * @param user The user pointer given to rgsl_glslang_perf_lint.
+ */
+typedef void (*rgsl_glslang_lint_callback)(enum rgsl_lint_rule rule, const char* file, int line, const char* message, void* user);
+
+/**
+ * @brief Walks the syntax tree of a linked program for costly patterns.
+ * @param program The program returned by rgsl_glslang_create_program.
+ * @param callback The function called for each finding, in the order of the tree.
+ * @param user A pointer passed to the callback.
+ * 
+ * Whether a value may differ between the invocations of a draw is estimated first:
+ * inputs, function parameters and values written in such control flow vary, while
+ * uniforms, read-only buffers and constants do not. Local variables only assigned
+ * from values that do not vary are treated like them. A pattern is reported at
+ * most once per rule and line. A discard is only reported in fragment shaders
+ * writing a floating-point color, which blending could leave unchanged instead.
+ */
+void rgsl_glslang_perf_lint(const struct rgsl_glslang_program* program, rgsl_glslang_lint_callback callback, void* user);
+
+/**
+ * @brief Callback receiving the variables that can be declared mediump.
+ * @param name The name of the variable.
+ * @param type The GLSL name of its type (e.g. "vec4").
+ * @param line The first line of the source string the variable appears on, which
+ * is its declaration unless it is declared without initializer.
+ * @param reason Why lowering its precision is safe.
+ * @param user The user pointer given to rgsl_glslang_find_mediump_variables.
+ */
+typedef void (*rgsl_glslang_mediump_callback)(const char* name, const char* type, int line, const char* reason, void* user);
+
+/**
+ * @brief Finds the highp variables of an OpenGL ES fragment shader that can be mediump.
+ * @param program The program returned by rgsl_glslang_create_program.
+ * @param max_texture_size The size in texels of the largest texture sampled, or 0 if unknown.
+ * @param mediump_outputs true if every render target has at most 8 bits per channel, so that
+ * the color outputs can be mediump whatever their values.
+ * @param callback The function called for each variable.
+ * @param user A pointer passed to the callback.
+ * @return false if the program is not an OpenGL ES fragment shader, true otherwise.
+ * 
+ * The range of the values of each local variable is estimated from its assignments
+ * (constants, functions such as clamp, mix or smoothstep, and the samples of shadow
+ * samplers and normalized images; other texture samples are unbounded, textures may
+ * hold HDR colors, depths or data), and each use is followed to what it flows into.
+ * A variable is kept highp if its range is unknown or exceeds the one of mediump,
+ * or if it flows into an index, a divisor, a derivative, a texture coordinate, a
+ * function argument or a variable kept highp. Outputs follow the same rule, or are
+ * all mediump with mediump_outputs, and inputs are mediump when they are only
+ * written to mediump outputs, or only used as texture coordinates while the
+ * textures are small enough for mediump.
+ */
+bool rgsl_glslang_find_mediump_variables(const struct rgsl_glslang_program* program, int max_texture_size, bool mediump_outputs, rgsl_glslang_mediump_callback callback, void* user);
+
+/**
+ * @brief Destroys a program and the glslang shader it was linked from.
+ * @param program The program to destroy. May be NULL.
  */
-struct rgsl_glslang_result rgsl_glslang_compile_glsl(const char* source, const char* stage);
+void rgsl_glslang_destroy_program(struct rgsl_glslang_program* program);
 
 /**
  * @brief Frees the resources allocated in a rgsl_glslang_result structure.
@@ -71,6 +71,19 @@ size_t rgsl_read_file(const char* filename, char **out_buffer);
  */
 bool rgsl_write_file(const char* filename, const char* buffer, size_t size);
 
+/**
+ * @brief Writes the contents of a buffer to a file, unless the file already holds them.
+ * @param filename The path to the file to write.
+ * @param buffer The buffer containing the data to write.
+ * @param size The size of the buffer in bytes, or 0 to write until the null terminator.
+ * @param out_written Optional pointer receiving whether the file was written.
+ * @return true if the file holds the buffer on return, false otherwise.
+ * 
+ * An unchanged file keeps its modification time, so that build systems do not
+ * rebuild what depends on it.
+ */
+bool rgsl_write_file_if_changed(const char* filename, const char* buffer, size_t size, bool* out_written);
+
 /**
  * @brief Converts all CRLF line endings in a string to LF line endings.
  * @param str The input string with potential CRLF line endings.
@@ -118,3 +131,17 @@ void rgsl_free_file_buffer(char* buffer);
  * file cannot be opened, the function returns false.
  */
 bool rgsl_file_exists(const char* filename);
+
+
+/**
+ * @brief Lists the entries of a directory.
+ * @param path The path to the directory to list.
+ * @param callback Function called once per entry with its name, whether it is a
+ * directory, and the user pointer.
+ * @param user User pointer forwarded to the callback.
+ * @return true if the directory could be opened, false otherwise.
+ * 
+ * The "." and ".." entries are skipped. The entry names passed to the callback
+ * are only valid for the duration of the call.
+ */
+bool rgsl_list_directory(const char* path, void (*callback)(const char* entry, bool is_directory, void* user), void* user);
\ No newline at end of file
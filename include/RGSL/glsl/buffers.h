@@ -0,0 +1,76 @@
+/** ********************************************************************************
+ * @section GLSL_Buffers_Overview Overview
+ * @file buffers.h
+ * @brief Header file for the layout analysis of the std140 and std430 blocks of GLSL shaders.
+ * @details
+ * Typical use cases:
+ * - Reporting the padding of buffer and uniform blocks, reordering their members and mirroring them in C.
+ * *********************************************************************************
+ * @section GLSL_Buffers_Header Header
+ * <RGSL/glsl/buffers.h>
+ ***********************************************************************************
+ * @section GLSL_Buffers_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Tells whether the blocks of the shaders are laid out.
+ * @return true if --layout-report or --layout-reorder was given, false otherwise.
+ */
+bool rgsl_buffer_layouts_enabled();
+
+/**
+ * @brief Lays out the std140 and std430 blocks of the processed code, and the structures they hold.
+ * @param shader The shader, once preprocessed. Its layouts are replaced, and with
+ * --layout-reorder its processed code and line map are updated.
+ * 
+ * The blocks are the uniform and buffer blocks declared at file scope with an
+ * explicit std140 or std430 layout qualifier; the layout of the others is up to
+ * the implementation. Array sizes may be literals, macros or constant integers.
+ * The size, padding and reordering saving of each block and structure are
+ * reported, their offsets in verbose mode.
+ * 
+ * With --layout-reorder, members are reordered in the code when it saves bytes,
+ * by the same deterministic order (see rgsl_layout_block), so that every stage
+ * including a declaration reorders it alike. Only declarations of one member per
+ * line are moved, and structures are left as they are when they are built by a
+ * constructor or an initializer list, whose arguments follow the member order, or
+ * used by blocks of both packings.
+ * 
+ * The layouts are kept in dependency order in the shader, for the packager to
+ * mirror them in C. Blocks made of a single runtime array are not mirrored, the
+ * structure of their elements is.
+ */
+void rgsl_glsl_layout_buffers(struct rgsl_shader_data* shader);
\ No newline at end of file
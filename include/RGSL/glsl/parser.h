@@ -45,4 +45,45 @@
  * 
  * This array maps GLSL preprocessor directives to their corresponding handler functions.
  */
-extern const struct rgsl_directive_mapping GLSL_DIRECTIVE_MAPPINGS[];
\ No newline at end of file
+extern const struct rgsl_directive_mapping GLSL_DIRECTIVE_MAPPINGS[];
+
+/**
+ * @brief Handler of the #include directive, splicing the included file.
+ * 
+ * Shared by the languages including files the GLSL way. With native includes, the
+ * directive is left for glslang to resolve.
+ */
+int rgsl_glsl_handle_include_directive(struct rgsl_parser_state* state, const char* value, void* out);
+
+/**
+ * @brief Preprocesses a GLSL shader, unless it already was.
+ * @param shader The shader to preprocess. Its processed_code is set on success.
+ * @param native_includes Whether include directives are left for glslang to resolve.
+ * @return true if the shader was preprocessed, false otherwise.
+ * 
+ * The preprocessed code is kept in the shader, so that every action run on it
+ * shares one preprocessing pass. It is only redone when includes were left to
+ * glslang and are now to be spliced, spliced includes serve both modes.
+ */
+bool rgsl_glsl_preprocess_shader(struct rgsl_shader_data* shader, bool native_includes);
+
+/**
+ * @brief Rewrites the interface of preprocessed GLSL code, as the options request.
+ * @param shader The shader whose processed_code is rewritten.
+ * 
+ * Packs the loose uniforms with --pack-uniforms and lays out the buffer blocks with
+ * --layout-report or --layout-reorder. Run by rgsl_glsl_preprocess_shader, and on
+ * the stages split from a program file, which are preprocessed together.
+ */
+void rgsl_glsl_rewrite_interface(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Parses and links a GLSL shader with glslang, unless it already was.
+ * @param shader The shader to build. Its program is set on success.
+ * @param out_log Pointer receiving the glslang log, to be freed by the caller. May be NULL.
+ * @return true if the shader is valid, false otherwise.
+ * 
+ * The program is built from the code preprocessed with the --native-includes mode,
+ * then shared by validation and SPIR-V generation.
+ */
+bool rgsl_glsl_build_program(struct rgsl_shader_data* shader, char** out_log);
\ No newline at end of file
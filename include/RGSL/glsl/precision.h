@@ -0,0 +1,67 @@
+/** ********************************************************************************
+ * @section GLSL_Precision_Overview Overview
+ * @file precision.h
+ * @brief Header file for the precision demotion of GLES fragment shaders.
+ * @details
+ * Typical use cases:
+ * - Declaring mediump the variables of GLES fragment shaders that do not need highp.
+ * *********************************************************************************
+ * @section GLSL_Precision_Header Header
+ * <RGSL/glsl/precision.h>
+ ***********************************************************************************
+ * @section GLSL_Precision_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Tells whether the precision demotion was requested.
+ * @return true if --demote-precision was given, false otherwise.
+ */
+bool rgsl_precision_demotion_enabled();
+
+/**
+ * @brief Declares mediump the variables of a GLES fragment shader that can be.
+ * @param shader The shader the code was compiled from.
+ * @param code The compiled GLSL code, which is replaced by the rewritten one.
+ * 
+ * The variables are found by rgsl_glslang_find_mediump_variables, on the program
+ * of the shader when it was built from the same code. "mediump" is inserted in
+ * front of the type of their declaration, unless it already has a precision or
+ * declares several variables. Each change is printed with its reason as
+ * "<file>:<line>: <type> <name> -> mediump: <reason>", the location pointing to the
+ * source file through the line map of the shader.
+ * 
+ * The code of shaders that are not GLES fragment shaders is left as it is.
+ */
+void rgsl_glsl_demote_precision(struct rgsl_shader_data* shader, char** code);
\ No newline at end of file
@@ -0,0 +1,73 @@
+/** ********************************************************************************
+ * @section GLSL_Uniforms_Overview Overview
+ * @file uniforms.h
+ * @brief Header file for the packing of loose uniforms into a block.
+ * @details
+ * Typical use cases:
+ * - Replacing the glUniform* call of each loose uniform by a single buffer write.
+ * *********************************************************************************
+ * @section GLSL_Uniforms_Header Header
+ * <RGSL/glsl/uniforms.h>
+ ***********************************************************************************
+ * @section GLSL_Uniforms_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Tells whether the loose uniforms are packed into a block.
+ * @return true if --pack-uniforms was given, false otherwise.
+ */
+bool rgsl_uniform_packing_enabled();
+
+/**
+ * @brief Packs the loose uniforms of the processed code into one std140 block.
+ * @param shader The shader, once preprocessed. Its processed code, line map and
+ * uniform block are updated.
+ * 
+ * The loose uniforms are the declarations at file scope of a single scalar,
+ * vector or matrix (or an array of them, of literal size) with no layout
+ * qualifier, e.g. "uniform mat4 uViewMatrix;". Samplers, structures and uniforms
+ * with a layout qualifier stay as they are. The block, named
+ * "RGSLUniforms_<name>_<stage>", replaces the first declaration, and its members
+ * are reordered to minimize the padding (see rgsl_layout_block). The uses of the
+ * uniforms go through the instance "rgsl_uniforms" of the block: two stages of a
+ * program often share a uniform, which may not be a member of two blocks. The
+ * binding of the block is the one of --pack-uniforms-binding when the profile
+ * supports binding qualifiers (GLSL 4.20 and ESSL 3.10), the engine binds it by
+ * name otherwise.
+ * 
+ * Only the spliced code is seen: uniforms of files included natively by glslang
+ * stay loose.
+ */
+void rgsl_glsl_pack_uniforms(struct rgsl_shader_data* shader);
\ No newline at end of file
@@ -0,0 +1,156 @@
+/** ********************************************************************************
+ * @section Hashmap_Overview Overview
+ * @file hashmap.h
+ * @brief Header file for the string hash map.
+ * @details
+ * Typical use cases:
+ * - Caching lookups keyed by file paths or identifiers.
+ * *********************************************************************************
+ * @section Hashmap_Header Header
+ * <RGSL/hashmap.h>
+ ***********************************************************************************
+ * @section Hashmap_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Structure to hold a single hash map slot.
+ * 
+ * This structure contains the owned copy of the key, its cached hash and the
+ * value stored for it. A slot with a NULL key is empty.
+ */
+struct rgsl_hashmap_entry {
+    char* key;
+    uint64_t hash;
+    void* value;
+};
+
+/**
+ * @brief Structure to hold a 128-bit hash.
+ * 
+ * This structure contains the two 64-bit halves of the hash, low first.
+ */
+struct rgsl_hash128 {
+    uint64_t low;
+    uint64_t high;
+};
+
+/**
+ * @brief Structure to hold an open-addressing hash map with string keys.
+ * 
+ * This structure contains the slot array, its capacity (always a power of two)
+ * and the number of used slots. Keys are copied on insertion, values are stored
+ * as-is and are never freed by the map unless a release function is given.
+ */
+struct rgsl_hashmap {
+    struct rgsl_hashmap_entry* entries;
+    size_t capacity;
+    size_t count;
+};
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a buffer.
+ * @param data The buffer to hash.
+ * @param size The size of the buffer in bytes.
+ * @return The hash of the buffer.
+ */
+uint64_t rgsl_hash_bytes(const void* data, size_t size);
+
+/**
+ * @brief Computes the 64-bit FNV-1a hash of a null-terminated string.
+ * @param str The string to hash.
+ * @return The hash of the string.
+ */
+uint64_t rgsl_hash_string(const char* str);
+
+/**
+ * @brief Computes the 128-bit MurmurHash3 (x64 variant, seed 0) of a buffer.
+ * @param data The buffer to hash.
+ * @param size The size of the buffer in bytes.
+ * @return The hash of the buffer.
+ * 
+ * The bytes are read in little-endian order whatever the host, so the hash of
+ * a given buffer is stable across platforms and can be stored in generated files.
+ */
+struct rgsl_hash128 rgsl_hash128_bytes(const void* data, size_t size);
+
+/**
+ * @brief Initializes an empty hash map.
+ * @param map The hash map to initialize.
+ * 
+ * No memory is allocated until the first insertion.
+ */
+void rgsl_hashmap_init(struct rgsl_hashmap* map);
+
+/**
+ * @brief Frees all the memory owned by a hash map.
+ * @param map The hash map to free.
+ * @param release_value Optional function called on every stored value, or NULL.
+ * 
+ * The map is left empty and can be reused after this call.
+ */
+void rgsl_hashmap_free(struct rgsl_hashmap* map, void (*release_value)(void*));
+
+/**
+ * @brief Looks up a key in a hash map.
+ * @param map The hash map to search.
+ * @param key The key to look up.
+ * @param out_value Optional pointer receiving the stored value.
+ * @return true if the key is present, false otherwise.
+ */
+bool rgsl_hashmap_find(const struct rgsl_hashmap* map, const char* key, void** out_value);
+
+/**
+ * @brief Returns the value stored for a key.
+ * @param map The hash map to search.
+ * @param key The key to look up.
+ * @return The stored value, or NULL if the key is not present.
+ */
+void* rgsl_hashmap_get(const struct rgsl_hashmap* map, const char* key);
+
+/**
+ * @brief Inserts or replaces the value stored for a key.
+ * @param map The hash map to modify.
+ * @param key The key to insert. It is copied by the map.
+ * @param value The value to store.
+ * @return The previous value stored for the key, or NULL if there was none.
+ */
+void* rgsl_hashmap_set(struct rgsl_hashmap* map, const char* key, void* value);
+
+/**
+ * @brief Removes a key from a hash map.
+ * @param map The hash map to modify.
+ * @param key The key to remove.
+ * @param out_value Optional pointer receiving the removed value.
+ * @return true if the key was present and removed, false otherwise.
+ */
+bool rgsl_hashmap_remove(struct rgsl_hashmap* map, const char* key, void** out_value);
\ No newline at end of file
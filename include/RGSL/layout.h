@@ -0,0 +1,202 @@
+/** ********************************************************************************
+ * @section Layout_Overview Overview
+ * @file layout.h
+ * @brief Header file for the memory layout of uniform blocks.
+ * @details
+ * Typical use cases:
+ * - Laying out uniform blocks by the std140 rules, and mirroring them as C structures.
+ * *********************************************************************************
+ * @section Layout_Header Header
+ * <RGSL/layout.h>
+ ***********************************************************************************
+ * @section Layout_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <RGSL/text.h>
+
+/**
+ * @brief Enumeration of the scalar types of the GLSL types a block can hold.
+ */
+enum rgsl_scalar_kind {
+    RGSL_SCALAR_FLOAT,
+    RGSL_SCALAR_INT,
+    RGSL_SCALAR_UINT,
+    RGSL_SCALAR_BOOL
+};
+
+/**
+ * @brief Structure describing a GLSL scalar, vector or matrix type.
+ * 
+ * Vectors have one column, scalars one column and one row. Matrices are stored
+ * column-major, as GLSL does by default.
+ */
+struct rgsl_glsl_type {
+    const char* name;
+    enum rgsl_scalar_kind scalar;
+    uint32_t columns;
+    uint32_t rows;
+};
+
+/**
+ * @brief Enumeration of the memory layouts of blocks.
+ * 
+ * std430 is only available to buffer blocks, and packs arrays, matrices and
+ * structures tighter than std140 does.
+ */
+enum rgsl_layout_packing {
+    RGSL_LAYOUT_STD140,
+    RGSL_LAYOUT_STD430
+};
+
+/**
+ * @brief Enumeration of what a layout describes, which names it in reports and mirrors.
+ */
+enum rgsl_layout_kind {
+    RGSL_LAYOUT_STRUCT,
+    RGSL_LAYOUT_UNIFORM_BLOCK,
+    RGSL_LAYOUT_BUFFER_BLOCK
+};
+
+// Array size of the last member of a buffer block declared without size, e.g. "float data[];".
+#define RGSL_RUNTIME_ARRAY UINT32_MAX
+
+struct rgsl_block_layout;
+
+/**
+ * @brief Structure to hold a member of a block, and where the layout placed it.
+ * 
+ * Members are either of a scalar, vector or matrix type, or of a structure, laid
+ * out beforehand by the same rules. The precision is NULL when the declaration had
+ * none. The array size is 0 for members that are not arrays, and the stride is the
+ * distance between their elements otherwise. The column stride is the distance
+ * between the columns of matrices. The size of a runtime array is the one of one
+ * element. The index is the position of the member in its declaration.
+ */
+struct rgsl_block_member {
+    char* name;
+    const struct rgsl_glsl_type* type;
+    const struct rgsl_block_layout* structure;
+    const char* precision;
+    uint32_t array_size;
+    uint32_t offset;
+    uint32_t size;
+    uint32_t stride;
+    uint32_t column_stride;
+    uint32_t index;
+};
+
+/**
+ * @brief Structure to hold a block or a structure, and its layout.
+ * 
+ * The members are in the order of their offsets once laid out, and the size
+ * includes the padding at the end of the block, but not a runtime array. The
+ * mirror name is the name of the C structure mirroring the layout, NULL until the
+ * packager chooses it.
+ */
+struct rgsl_block_layout {
+    char* name;
+    char* mirror_name;
+    enum rgsl_layout_kind kind;
+    enum rgsl_layout_packing packing;
+    struct rgsl_block_member* members;
+    size_t member_count;
+    uint32_t alignment;
+    uint32_t size;
+    uint32_t padding;
+};
+
+/**
+ * @brief Looks up a scalar, vector or matrix type by its GLSL name.
+ * @param name The name to look up, not necessarily null-terminated.
+ * @param length The length of the name.
+ * @return The type, or NULL for the other types (samplers, structures, doubles...).
+ */
+const struct rgsl_glsl_type* rgsl_find_glsl_type(const char* name, size_t length);
+
+/**
+ * @brief Returns the name of a packing, as written in layout qualifiers.
+ * @param packing The packing.
+ * @return "std140" or "std430".
+ */
+const char* rgsl_layout_packing_name(enum rgsl_layout_packing packing);
+
+/**
+ * @brief Adds a member at the end of a block.
+ * @param block The block, zero-initialized before the first member.
+ * @param name The name of the member, not necessarily null-terminated.
+ * @param length The length of the name.
+ * @param type The type of the member, or NULL if it is a structure.
+ * @param structure The layout of the structure of the member, or NULL if it has a type.
+ * @param precision The precision qualifier of the member, or NULL.
+ * @param array_size The number of elements of the member, 0 if it is not an array,
+ * or RGSL_RUNTIME_ARRAY.
+ */
+void rgsl_block_add_member(struct rgsl_block_layout* block, const char* name, size_t length, const struct rgsl_glsl_type* type, const struct rgsl_block_layout* structure, const char* precision, uint32_t array_size);
+
+/**
+ * @brief Lays out a block by the std140 or std430 rules.
+ * @param block The block to lay out. The structures of its members must be laid
+ * out with the same packing.
+ * @param packing The packing rules.
+ * @param reorder true to reorder the members to minimize the padding, false to lay
+ * them out in their declaration order.
+ * 
+ * Members are reordered greedily: the next member is the one needing the least
+ * padding at the current offset, the most aligned one first on ties, so that
+ * vec3 members are followed by a scalar filling their last four bytes. A runtime
+ * array stays the last member.
+ */
+void rgsl_layout_block(struct rgsl_block_layout* block, enum rgsl_layout_packing packing, bool reorder);
+
+/**
+ * @brief Writes a C structure with the memory layout of a block.
+ * @param output The text receiving the structure.
+ * @param block The block, once laid out, and its mirror name chosen. The mirrors of
+ * the structures of its members must be written before.
+ * 
+ * Vectors are arrays of their scalar type, matrices arrays of padded columns,
+ * and the padding is made of explicit byte arrays, so that the structure needs no
+ * packing attribute. The offset of each member and the size of the structure are
+ * checked with _Static_assert, so that a compiler laying it out otherwise fails.
+ * A runtime array becomes a flexible array member.
+ */
+void rgsl_write_block_mirror(struct rgsl_text* output, const struct rgsl_block_layout* block);
+
+/**
+ * @brief Releases a block and its members.
+ * @param block The block to release. May be NULL. The structures of its members are
+ * not released.
+ */
+void rgsl_block_layout_free(struct rgsl_block_layout* block);
\ No newline at end of file
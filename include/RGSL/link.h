@@ -0,0 +1,87 @@
+/** ********************************************************************************
+ * @section Link_Overview Overview
+ * @file link.h
+ * @brief Header file for linking the SPIR-V modules of the stages of a program.
+ * @details
+ * Typical use cases:
+ * - Compiling the stages of a program file to one SPIR-V module, with an entry point per stage.
+ * *********************************************************************************
+ * @section Link_Header Header
+ * <RGSL/link.h>
+ ***********************************************************************************
+ * @section Link_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Checks whether the stages of program files are linked into one module.
+ * @return true if --program-module is set, false otherwise.
+ */
+bool rgsl_program_module_enabled();
+
+/**
+ * @brief Links the SPIR-V modules of the stages of a program into one module.
+ * @param modules The words of each module, in stage order.
+ * @param word_counts The number of words of each module.
+ * @param count The number of modules.
+ * @param out_words Pointer receiving the words of the linked module, to be freed
+ * by the caller.
+ * @param out_word_count Pointer receiving the number of words of the linked module.
+ * @return true if the modules were linked, false otherwise.
+ * 
+ * The linked module holds the entry points of every module, with their execution
+ * modes and interfaces. Capabilities, extensions and extended instruction sets
+ * are merged, and so are types and constants defined by the same instruction
+ * with the same decorations. Resources (uniforms, storage buffers, push
+ * constants) with the same type, decorations and name are kept once, as the
+ * stages of a GL program share them; so are functions with the same body,
+ * using the same resources and calling the same functions. Entry points and the
+ * inputs, outputs and private variables of the stages are never shared.
+ * 
+ * Modules holding an instruction the linker does not know the operands of, or
+ * different memory models, are not linked: the reason is printed at verbose
+ * level 1 and the stages are left in their own modules.
+ */
+bool rgsl_link_spirv_modules(const uint32_t* const* modules, const size_t* word_counts, size_t count, uint32_t** out_words, size_t* out_word_count);
+
+/**
+ * @brief Finds the name of the entry point of a stage in a SPIR-V module.
+ * @param words The words of the module.
+ * @param word_count The number of words of the module.
+ * @param stage The stage of the entry point (e.g. "vert", "frag").
+ * @return The name of the entry point, pointing into the words, or NULL if the
+ * module has none for the stage.
+ */
+const char* rgsl_spirv_entry_point(const uint32_t* words, size_t word_count, const char* stage);
\ No newline at end of file
@@ -0,0 +1,78 @@
+/** ********************************************************************************
+ * @section Lint_Overview Overview
+ * @file lint.h
+ * @brief Header file for the performance lint of shaders.
+ * @details
+ * Typical use cases:
+ * - Warning about shader patterns that are costly on tile-based mobile GPUs.
+ * *********************************************************************************
+ * @section Lint_Header Header
+ * <RGSL/lint.h>
+ ***********************************************************************************
+ * @section Lint_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Tells whether the performance lint was requested.
+ * @return true if --perf-lint was given, false otherwise.
+ */
+bool rgsl_perf_lint_enabled();
+
+/**
+ * @brief Checks the warnings suppressed on the command line.
+ * @return true if every ID given to --perf-lint-suppress is known, false otherwise.
+ * 
+ * The IDs are separated by commas or spaces, e.g. "P001,P003".
+ */
+bool rgsl_check_perf_lint();
+
+/**
+ * @brief Runs the performance lint on a shader and prints its warnings.
+ * @param shader The shader to lint. Its glslang program is built if needed, and
+ * kept for the other actions.
+ * 
+ * Each warning is printed as "<file>:<line>: <ID>: <message>", where the location
+ * points to the source file the user wrote, through the line map of the shader.
+ * A warning is not printed if its ID was given to --perf-lint-suppress, or if its
+ * line or the line above holds a "rgsl-lint: allow <ID>" comment. Discards are only
+ * reported in fragment shaders writing a floating-point color: a mask or ID pass
+ * writing integers, or a depth-only pass, has no blending to use instead. Only
+ * GLSL shaders are linted.
+ */
+void rgsl_perf_lint_shader(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Prints the number of warnings found by the lint, then resets it.
+ */
+void rgsl_perf_lint_finalize();
\ No newline at end of file
@@ -0,0 +1,155 @@
+/** ********************************************************************************
+ * @section Macro_Overview Overview
+ * @file macro.h
+ * @brief Header file for preprocessor macro functions.
+ * @details
+ * Typical use cases:
+ * - Tracking macro definitions and evaluating conditional directives.
+ * *********************************************************************************
+ * @section Macro_Header Header
+ * <RGSL/macro.h>
+ ***********************************************************************************
+ * @section Macro_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/hashmap.h>
+
+/**
+ * @brief Structure to hold a macro definition.
+ * 
+ * This structure contains the replacement text of a macro and flags describing
+ * whether it takes parameters and whether its value is reliable. A macro is
+ * uncertain when it was defined or undefined inside a region the preprocessor
+ * left for glslang to decide, so its value cannot be trusted anymore.
+ */
+struct rgsl_macro {
+    char* value;
+    bool function_like;
+    bool uncertain;
+};
+
+/**
+ * @brief Structure to hold the macros defined while preprocessing a shader.
+ * 
+ * This structure contains the macros keyed by name, whether the built-in
+ * macros depending on the #version directive (e.g. GL_ES, __VERSION__) are known,
+ * and whether files left to glslang (e.g. native includes) may have changed them.
+ * Once a table is incomplete, every conditional depending on a macro is unknown.
+ * 
+ * An undefined identifier in a conditional evaluates to 0, except when
+ * undefined_unknown is set: ES profiles reject it, so such conditionals are left
+ * for glslang to report.
+ */
+struct rgsl_macro_table {
+    struct rgsl_hashmap macros;
+    bool builtins_known;
+    bool incomplete;
+    bool undefined_unknown;
+};
+
+/**
+ * @brief Enumeration of the possible results of a conditional expression.
+ * 
+ * RGSL_CONDITION_UNKNOWN is returned when the expression depends on something
+ * only glslang knows (extension macros, function-like macros, uncertain macros)
+ * or cannot be parsed. The conditional is then left in the code for glslang.
+ */
+enum rgsl_condition_result {
+    RGSL_CONDITION_FALSE = 0,
+    RGSL_CONDITION_TRUE = 1,
+    RGSL_CONDITION_UNKNOWN = 2
+};
+
+/**
+ * @brief Initializes an empty macro table.
+ * @param table The macro table to initialize.
+ */
+void rgsl_macro_table_init(struct rgsl_macro_table* table);
+
+/**
+ * @brief Frees all the memory owned by a macro table.
+ * @param table The macro table to free.
+ */
+void rgsl_macro_table_free(struct rgsl_macro_table* table);
+
+/**
+ * @brief Initializes a macro table with a copy of the macros of another one.
+ * @param destination The macro table to initialize.
+ * @param source The macro table to copy.
+ */
+void rgsl_macro_table_copy(struct rgsl_macro_table* destination, const struct rgsl_macro_table* source);
+
+/**
+ * @brief Defines a macro from the value of a #define directive.
+ * @param table The macro table to modify.
+ * @param definition The directive value, e.g. "PI 3.14" or "SQR(x) ((x)*(x))".
+ * @param uncertain true if the definition is inside a region left to glslang.
+ * @return true if the definition is well-formed, false otherwise.
+ */
+bool rgsl_macro_define(struct rgsl_macro_table* table, const char* definition, bool uncertain);
+
+/**
+ * @brief Defines a macro from a command-line definition.
+ * @param table The macro table to modify.
+ * @param definition The definition, in the "NAME" or "NAME=VALUE" form.
+ * @return true if the definition is well-formed, false otherwise.
+ * 
+ * Macros defined without a value are defined to 1, as C compilers do.
+ */
+bool rgsl_macro_define_option(struct rgsl_macro_table* table, const char* definition);
+
+/**
+ * @brief Removes a macro definition.
+ * @param table The macro table to modify.
+ * @param name The name of the macro to remove.
+ * @param uncertain true if the directive is inside a region left to glslang.
+ */
+void rgsl_macro_undefine(struct rgsl_macro_table* table, const char* name, bool uncertain);
+
+/**
+ * @brief Evaluates the expression of an #if or #elif directive.
+ * @param table The macro table to evaluate the expression against.
+ * @param expression The expression to evaluate.
+ * @return The result of the evaluation.
+ * 
+ * The expression follows the GLSL preprocessor rules: integer arithmetic,
+ * comparison and logical operators, the defined operator and object-like macro
+ * expansion. Undefined identifiers evaluate to 0, except reserved names (GL_*
+ * and __*) that glslang may define on its own.
+ */
+enum rgsl_condition_result rgsl_macro_evaluate(const struct rgsl_macro_table* table, const char* expression);
+
+/**
+ * @brief Evaluates whether a macro is defined, for #ifdef and #ifndef directives.
+ * @param table The macro table to look the macro up in.
+ * @param name The name of the macro.
+ * @return The result of the evaluation.
+ */
+enum rgsl_condition_result rgsl_macro_evaluate_defined(const struct rgsl_macro_table* table, const char* name);
\ No newline at end of file
@@ -0,0 +1,164 @@
+/** ********************************************************************************
+ * @section Manifest_Overview Overview
+ * @file manifest.h
+ * @brief Header file for batch job lists (manifest and response files).
+ * @details
+ * Typical use cases:
+ * - Processing many shaders, each with its own options, in one invocation.
+ * *********************************************************************************
+ * @section Manifest_Header Header
+ * <RGSL/manifest.h>
+ ***********************************************************************************
+ * @section Manifest_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Structure to hold one shader to process and its own options.
+ * 
+ * This structure contains the input file and the options that override the
+ * global ones for this shader: output file, stage, profile and macros. A NULL
+ * member falls back to the corresponding command-line option. The defines are
+ * defined in addition to the ones given on the command line.
+ */
+struct rgsl_job {
+    const char* input_file;
+    const char* output_file;
+    const char* stage;
+    const char* profile;
+    const char** defines;
+};
+
+/**
+ * @brief Structure to hold the list of jobs of an invocation.
+ */
+struct rgsl_manifest {
+    struct rgsl_job* jobs;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * @brief Splits a text into arguments, as a shell would.
+ * @param text The text to split.
+ * @param out_count Optional pointer receiving the number of arguments.
+ * @return A NULL-terminated array of arguments, to be freed with rgsl_free_arguments.
+ * 
+ * Arguments are separated by whitespace. Single or double quotes group an argument
+ * containing whitespace, and a backslash escapes the next character inside double
+ * quotes. A '#' at the start of an argument comments out the rest of the line.
+ */
+char** rgsl_split_arguments(const char* text, size_t* out_count);
+
+/**
+ * @brief Frees an array returned by rgsl_split_arguments.
+ * @param arguments The array to free. May be NULL.
+ */
+void rgsl_free_arguments(char** arguments);
+
+/**
+ * @brief Expands the response files given on the command line.
+ * @param argc The number of arguments.
+ * @param argv The arguments, where "@file" is replaced by the arguments listed in file.
+ * @param out_argc Pointer receiving the number of expanded arguments.
+ * @return The NULL-terminated expanded arguments, or NULL if a response file could not be read.
+ * 
+ * Response files may themselves reference other response files. The returned
+ * array and its arguments live until the end of the process.
+ */
+const char** rgsl_expand_response_files(int argc, const char** argv, int* out_argc);
+
+/**
+ * @brief Initializes an empty manifest.
+ * @param manifest The manifest to initialize.
+ */
+void rgsl_manifest_init(struct rgsl_manifest* manifest);
+
+/**
+ * @brief Appends a job to a manifest.
+ * @param manifest The manifest to append to.
+ * @param job The job to append. Its members are copied as is, not duplicated.
+ */
+void rgsl_manifest_add_job(struct rgsl_manifest* manifest, const struct rgsl_job* job);
+
+/**
+ * @brief Loads the jobs listed in a manifest file.
+ * @param manifest The manifest the jobs are appended to.
+ * @param path The path of the manifest file.
+ * @return true if the file was loaded, false if it could not be read or is malformed.
+ * 
+ * Each non-empty line describes one job: the input file followed by its own options,
+ * with the same syntax as the command line:
+ * 
+ * @code{.txt}
+ * # input            options
+ * glsl/main.vs       -o build/main.vs.spv -D MODE=2
+ * gles/main.fs       -o build/main.fs.glsl --profile 300es
+ * common/blit.glsl   -o build/blit.spv --stage frag
+ * @endcode
+ * 
+ * Supported options are -o/--output, --stage, --profile and -D/--define.
+ * Paths are relative to the working directory.
+ */
+bool rgsl_manifest_load(struct rgsl_manifest* manifest, const char* path);
+
+/**
+ * @brief Frees the memory owned by a manifest.
+ * @param manifest The manifest to free.
+ * 
+ * Only the job array is freed: the strings loaded from manifest files live until
+ * the end of the process, as shaders and packagers may refer to them.
+ */
+void rgsl_manifest_free(struct rgsl_manifest* manifest);
\ No newline at end of file
@@ -0,0 +1,167 @@
+/** ********************************************************************************
+ * @section Memory_Overview Overview
+ * @file memory.h
+ * @brief Header file for the instrumented allocator and the memory report.
+ * @details
+ * Typical use cases:
+ * - Accounting the allocations of each phase and shader, and reporting their peaks.
+ * *********************************************************************************
+ * @section Memory_Header Header
+ * <RGSL/memory.h>
+ ***********************************************************************************
+ * @section Memory_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Enumeration of the phases the allocations are accounted to.
+ * 
+ * Each thread is in one phase at a time, RGSL_PHASE_SETUP outside of any job.
+ * RGSL_PHASE_GLSLANG covers the calls into glslang and SPIRV-Tools, whose own
+ * pool allocators are only seen through the resident set size sampled around them.
+ */
+enum rgsl_memory_phase {
+    RGSL_PHASE_SETUP,
+    RGSL_PHASE_READ,
+    RGSL_PHASE_PREPROCESS,
+    RGSL_PHASE_COMPILE,
+    RGSL_PHASE_GLSLANG,
+    RGSL_PHASE_PACKAGE,
+    RGSL_PHASE_WRITE,
+    RGSL_PHASE_COUNT
+};
+
+/**
+ * @brief Allocation functions of RGSL, accounted with --mem-report.
+ * 
+ * They behave as their C library counterparts, with which their pointers may be
+ * mixed: the size of a block is asked to the C library, never stored next to it.
+ * Without --mem-report, they only add a test of a flag to the C library calls.
+ */
+void* rgsl_malloc(size_t size);
+void* rgsl_calloc(size_t count, size_t size);
+void* rgsl_realloc(void* pointer, size_t size);
+void rgsl_free(void* pointer);
+char* rgsl_strdup(const char* str);
+
+/**
+ * @brief Checks whether the allocations are accounted, with --mem-report.
+ * @return true if they are, false otherwise.
+ */
+bool rgsl_memory_report_enabled();
+
+/**
+ * @brief Starts accounting the allocations, if --mem-report is given.
+ * 
+ * Called once the options are parsed, before any thread is started. The blocks
+ * allocated before are not accounted, nor are their frees.
+ */
+void rgsl_memory_report_start();
+
+/**
+ * @brief Prints the memory report and writes it as JSON, then stops accounting.
+ * @return true if the report was written, false otherwise.
+ * 
+ * The report holds, for each phase and each shader, the count and bytes of the
+ * allocations made, the peak of the bytes allocated by RGSL and still in use
+ * while it was running, and the peak resident set size sampled during it.
+ */
+bool rgsl_memory_report_finalize();
+
+/**
+ * @brief Switches the phase of the calling thread.
+ * @param phase The phase the next allocations of the thread are accounted to.
+ * @return The previous phase, to be given back to rgsl_memory_leave_phase.
+ * 
+ * With the memory report, the resident set size is sampled when the outermost
+ * phase of a shader scope starts and ends (the read, compile and write steps of a
+ * job), and around RGSL_PHASE_GLSLANG, but not on the other nested switches.
+ * 
+ * @code{c}
+ * enum rgsl_memory_phase previous = rgsl_memory_enter_phase(RGSL_PHASE_PREPROCESS);
+ * shader->processed_code = rgsl_parse_shader(GLSL_DIRECTIVE_MAPPINGS, shader, false);
+ * rgsl_memory_leave_phase(previous);
+ * @endcode
+ */
+enum rgsl_memory_phase rgsl_memory_enter_phase(enum rgsl_memory_phase phase);
+
+/**
+ * @brief Restores the phase of the calling thread.
+ * @param previous The phase returned by rgsl_memory_enter_phase.
+ */
+void rgsl_memory_leave_phase(enum rgsl_memory_phase previous);
+
+/**
+ * @brief Accounts the next allocations of the calling thread to a shader as well.
+ * @param shader The path of the shader, kept by reference.
+ * 
+ * The read, compile and write steps of a job run on different threads, each in
+ * its own scope, and are accounted to the same shader. Scopes may be nested.
+ */
+void rgsl_memory_begin_shader(const char* shader);
+
+/**
+ * @brief Ends the scope of rgsl_memory_begin_shader.
+ */
+void rgsl_memory_end_shader();
+
+/**
+ * @brief Structure to hold the phase and shader scope of a thread.
+ * 
+ * rgsl_thread_create hands them over to the threads it starts, so that the
+ * allocations of the workers of a shader are accounted to it.
+ */
+struct rgsl_memory_context {
+    enum rgsl_memory_phase phase;
+    size_t shader;
+};
+
+/**
+ * @brief Saves the phase and shader scope of the calling thread.
+ * @param out_context Pointer receiving the context.
+ */
+void rgsl_memory_save_context(struct rgsl_memory_context* out_context);
+
+/**
+ * @brief Gives the calling thread a saved phase and shader scope.
+ * @param context The context saved by rgsl_memory_save_context, on another thread.
+ */
+void rgsl_memory_restore_context(const struct rgsl_memory_context* context);
+
+/**
+ * @brief Samples the resident set size of the process.
+ * @param out_peak Pointer receiving the peak resident set size so far, or NULL.
+ * @return The resident set size in bytes, or 0 if it is unknown on this platform.
+ */
+size_t rgsl_memory_rss(size_t* out_peak);
\ No newline at end of file
@@ -41,14 +41,163 @@
 #include <stdbool.h>
 #include <RGSL/rgsl.h>
 
+#include <stdio.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/text.h>
+#include <RGSL/usage.h>
+
+/**
+ * @brief Incremental writer of an embedded shader package.
+ *
+ * Each blob is written out as soon as its shader is added, so that only the small
+ * table entries are kept until the end and memory does not grow with the blobs.
+ * The single output file is written to "<output>.tmp" and renamed once complete,
+ * a failed or aborted package never replaces the previous output.
+ *
+ * Shaders with identical code, such as variants only differing by specialization
+ * constants, share one blob: the blobs are indexed by their content hash.
+ *
+ * With --pack-uniforms or --layout-report, the C mirrors of the blocks of each
+ * shader are written before its blob (in the index file with --split-embed).
+ * Mirrors are indexed by their structure name, so that identical blocks are
+ * written once, and blocks of the same name but another layout get a suffix.
+ *
+ * With --targets, each shader gets one blob per target, and a second table,
+ * rgsl_shader_targets, points at the blobs of each shader by target.
+ * 
+ * The stages of a program file (see program.h) are added between
+ * rgsl_packager_begin_program and rgsl_packager_end_program, so that their blobs
+ * follow each other. A third table, rgsl_shader_programs, points at the blobs of
+ * each program, and is only written if the package has programs.
+ * 
+ * With --shared-chunks, the GLSL code of each shader is stored as chunks, and
+ * each chunk once whatever the number of shaders holding it: the chunks are
+ * indexed by their content hash. Each blob then points at an rgsl_glsl_source,
+ * the chunks of its shader with their lengths, to be given as they are to
+ * glShaderSource.
+ * 
+ * With --usage-profile, the layout of the blobs is recorded and replayed against
+ * the profile once the package is written, reporting the pages the startup of the
+ * engine faults in (see usage.h). With --split-cold, the blobs of the shaders not
+ * used at startup are written to "<output>_cold.c" instead, a package of its own
+ * with its rgsl_cold_shaders and rgsl_cold_shader_programs tables, to be loaded
+ * when the engine first needs one of them.
+ */
+struct rgsl_packager {
+    const char* output_file;
+    char* temp_file;
+    FILE* file;
+    struct rgsl_text output;
+    struct rgsl_text declarations;
+    struct rgsl_text entries;
+    struct rgsl_text targets;
+    struct rgsl_text programs;
+    const struct rgsl_usage_profile* profile;
+    char* cold_output_file;
+    char* cold_temp_file;
+    FILE* cold_file;
+    struct rgsl_text cold_entries;
+    struct rgsl_text cold_programs;
+    struct rgsl_usage_blob* layout;
+    size_t layout_count;
+    size_t layout_capacity;
+    struct rgsl_hashmap used_keys;
+    struct rgsl_hashmap blobs;
+    struct rgsl_hashmap mirrors;
+    struct rgsl_hashmap chunks;
+    size_t count;
+    size_t program_first;
+    size_t cold_count;
+    size_t program_first_cold;
+    char* program_name;
+    size_t text_size;
+    size_t chunk_size;
+    bool split;
+    bool spirv;
+    bool chunked;
+    bool cold_split;
+    bool cold;
+    bool success;
+};
+
+/**
+ * @brief Checks whether the GLSL code of the embedded shaders is stored as shared chunks.
+ * @return true if --shared-chunks is set, false otherwise.
+ */
+bool rgsl_shared_chunks_enabled();
+
+/**
+ * @brief Cuts the code of a shader into the chunks it is embedded as.
+ * @param shader The shader, holding the GLSL code to embed and, for GLSL shaders,
+ * the line map of its preprocessed code.
+ * 
+ * A chunk ends where the lines of the code start coming from another file, so
+ * that the text of each include is a chunk of its own, found as is in every
+ * shader including it. Code without a matching line map (e.g. written by the
+ * RGSL backend) is cut after each directive and each top-level declaration
+ * closing a brace (functions, structures, blocks) instead.
+ */
+void rgsl_find_shader_chunks(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Starts a package written to the given output file.
+ * @param packager The packager to initialize.
+ * @param output_file The C source file receiving the package.
+ * @return true if the output could be opened, false otherwise.
+ *
+ * rgsl_packager_end must be called even when this function fails.
+ */
+bool rgsl_packager_begin(struct rgsl_packager* packager, const char* output_file);
+
+/**
+ * @brief Writes the blob of one shader to the package.
+ * @param packager The packager to write to.
+ * @param shader The shader to package, holding its final code.
+ * @return true if the blob was written, false otherwise.
+ *
+ * The shader is not referenced afterwards and may be released right away.
+ * With --split-embed, the blob is written to its own C file, named after the
+ * output file and the shader (e.g. shaders_main_vert.c for shaders.c). The file
+ * is only rewritten when its content changes, so that a build system compiles
+ * the blobs in parallel and recompiles only the changed shaders.
+ */
+bool rgsl_packager_add(struct rgsl_packager* packager, const struct rgsl_shader_data* shader);
+
+/**
+ * @brief Starts the group of blobs of a program.
+ * @param packager The packager to write to.
+ * @param name The name of the program, shared by its stages.
+ *
+ * The stages of the program are then added with rgsl_packager_add.
+ */
+void rgsl_packager_begin_program(struct rgsl_packager* packager, const char* name);
+
+/**
+ * @brief Ends the group of blobs of a program, recording it in the program table.
+ * @param packager The packager to write to.
+ */
+void rgsl_packager_end_program(struct rgsl_packager* packager);
+
+/**
+ * @brief Writes the table of the package and releases the packager.
+ * @param packager The packager to finish.
+ * @param commit false to abort the package, leaving the previous output in place.
+ * @return true if the package was completely written, false otherwise.
+ *
+ * With --split-embed, the output file only holds the table, referring to the
+ * blobs through extern declarations.
+ */
+bool rgsl_packager_end(struct rgsl_packager* packager, bool commit);
+
 /**
  * @brief Packages the given shaders into a C source file format.
- * @param shaders An array of shader_data structures containing shader codes to package.
+ * @param shaders An array of shader_data structures containing shader codes to package,
+ * terminated by an entry with a NULL code.
+ * @param profile The usage profile ordering the blobs, or NULL for the one of --usage-profile.
  * @return true if packaging was successful, false otherwise.
- * 
- * This function takes an array of shader_data structures, each containing shader code
- * and its associated metadata, and writes them into a C source file specified in the
- * global RGSL options. The output file contains an array of shader blobs that can be
- * included in C/C++ projects.
+ *
+ * Convenience wrapper over rgsl_packager_begin, rgsl_packager_add and rgsl_packager_end
+ * writing to the output file of the global RGSL options. With a profile, the
+ * shaders are added by first use (see rgsl_usage_order).
  */
-bool rgsl_package_shaders(struct rgsl_shader_data* shaders);
\ No newline at end of file
+bool rgsl_package_shaders(struct rgsl_shader_data* shaders, struct rgsl_usage_profile* profile);
\ No newline at end of file
@@ -39,32 +39,103 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
 #include <RGSL/rgsl.h>
+#include <RGSL/macro.h>
+
+/**
+ * @brief Structure to track a file spliced into the processed code.
+ * 
+ * This structure holds the path of a file whose content is being parsed and the
+ * length of the processed code that follows its content. Since the code after
+ * the spliced content is never edited while parsing it, the content ends where
+ * only tail_length characters remain.
+ * 
+ * It also holds the index of the file in the line map of the shader, and the
+ * number of the line of that file being parsed.
+ */
+struct rgsl_include_frame {
+    char* path;
+    size_t tail_length;
+    uint32_t file;
+    uint32_t line;
+};
+
+/**
+ * @brief Structure to track an open conditional directive (#if, #ifdef, #ifndef).
+ * 
+ * This structure holds whether the enclosing region is active, whether the current
+ * branch is active, whether a branch was already taken, and whether the conditional
+ * is left in the code for glslang because it could not be evaluated.
+ */
+struct rgsl_condition_frame {
+    bool parent_active;
+    bool branch_active;
+    bool branch_taken;
+    bool passthrough;
+    bool seen_else;
+};
 
 /**
  * @brief Structure to maintain the state of the parser.
  * 
  * This structure holds information about the current state of the shader
  * parsing process, including the shader being processed, the processed code,
- * current line pointers, and flags for directive handling.
+ * current line pointers, the stack of files being parsed, the map of the
+ * processed lines to their source, the macro table,
+ * the stack of open conditionals, the lines to insert after the #version
+ * directive, and flags for directive handling.
+ * 
+ * When native_includes is set, include directives are left in the code for
+ * glslang to resolve instead of being spliced.
+ * 
+ * In files holding several stages (see program.h), stage_count counts the stage
+ * pragmas met so far, and stage_macros keeps the macros defined by the shared
+ * prologue, which every stage section starts from.
+ * 
+ * in_comment tells whether the current line starts inside a block comment, where
+ * directives are not recognized.
  */
 struct rgsl_parser_state {
     struct rgsl_shader_data* shader;
     char* processed_code;
+    size_t processed_length;
     char* current_line;
     char* line_end;
+    struct rgsl_include_frame* include_stack;
+    size_t include_depth;
+    size_t include_capacity;
+    struct rgsl_line_map* line_map;
+    struct rgsl_macro_table macros;
+    struct rgsl_condition_frame* conditions;
+    size_t condition_depth;
+    size_t condition_capacity;
+    char* preamble;
+    size_t preamble_length;
+    size_t version_line_end;
     bool version_directive_found;
+    bool reprocess_replacement;
+    bool native_includes;
+    struct rgsl_macro_table stage_macros;
+    size_t stage_count;
+    bool in_comment;
 };
 
 /**
  * @brief Structure to map preprocessor directives to their handler functions.
  * 
- * This structure holds the name of a preprocessor directive and a pointer to the function
- * that handles that directive.
+ * This structure holds the name of a preprocessor directive, a pointer to the function
+ * that handles that directive, and whether the directive is a conditional one that
+ * must also be handled inside skipped regions.
+ * 
+ * A handler may store a dynamically allocated replacement for the directive line in
+ * its out parameter. The replacement is parsed again, unless the handler clears the
+ * reprocess_replacement flag of the parser state.
  */
 struct rgsl_directive_mapping {
     const char* directive;
     int (*handler_func)(struct rgsl_parser_state*, const char* value, void* out);
+    bool conditional;
 };
 
 /**
@@ -110,16 +181,147 @@ void rgsl_free_directive(struct rgsl_directive* directive);
  */
 bool rgsl_process_directive(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], const struct rgsl_directive directive, struct rgsl_parser_state* state);
 
+/**
+ * @brief Checks whether the current line is in an active region.
+ * @param state The current state of the parser.
+ * @return true if the current line is kept in the processed code, false if it is skipped.
+ */
+bool rgsl_parser_is_active(const struct rgsl_parser_state* state);
+
+/**
+ * @brief Checks whether the current line is inside a conditional left to glslang.
+ * @param state The current state of the parser.
+ * @return true if glslang may or may not compile the current line.
+ * 
+ * Macros defined or undefined in such regions are marked as uncertain.
+ */
+bool rgsl_parser_is_uncertain(const struct rgsl_parser_state* state);
+
+/**
+ * @brief Handlers for the conditional and macro directives.
+ * 
+ * These handlers are shared by every language whose preprocessor follows the
+ * GLSL (and C) rules. Conditionals that can be evaluated are removed from the
+ * processed code along with their inactive branches; the others are kept for
+ * glslang. #define and #undef directives update the macro table and are kept.
+ */
+int rgsl_handle_if_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_ifdef_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_ifndef_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_elif_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_else_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_endif_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_define_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_undef_directive(struct rgsl_parser_state* state, const char* value, void* out);
+int rgsl_handle_pragma_directive(struct rgsl_parser_state* state, const char* value, void* out);
+
+/**
+ * @brief Reads the value of a #pragma directive starting a stage section.
+ * @param value The value of the directive, e.g. "rgsl stage(vert)".
+ * @param out_stage Pointer receiving the stage, or NULL if it is unknown.
+ * @return true if the directive is a stage pragma, false for any other pragma.
+ */
+bool rgsl_read_stage_pragma(const char* value, const char** out_stage);
+
+/**
+ * @brief Returns the path of the file the current line comes from.
+ * @param state The current state of the parser.
+ * @return The path of the file being parsed, or NULL if unknown.
+ */
+const char* rgsl_parser_current_file(const struct rgsl_parser_state* state);
+
+/**
+ * @brief Marks the content replacing the current line as coming from another file.
+ * @param state The current state of the parser.
+ * @param path The path of the spliced file. It is copied by the parser.
+ * 
+ * This function should be called by directive handlers before returning the
+ * content of an included file, so that nested quoted includes are resolved
+ * relative to that file.
+ */
+void rgsl_parser_push_file(struct rgsl_parser_state* state, const char* path);
+
+/**
+ * @brief Finds the source of a line of the processed code.
+ * @param map The line map built with the processed code.
+ * @param line The 1-based line number in the processed code.
+ * @param out_file Pointer receiving the path of the source file.
+ * @param out_line Pointer receiving the 1-based line number in that file.
+ * @return true if the line comes from a source file, false if it was inserted
+ * by the preprocessor or is out of the map.
+ */
+bool rgsl_line_map_lookup(const struct rgsl_line_map* map, int line, const char** out_file, int* out_line);
+
+/**
+ * @brief Points the messages of glslang at the lines of the source files.
+ * @param map The line map built with the processed code.
+ * @param name The name the processed code was given to glslang, usually the shader path.
+ * @param log The info log of glslang.
+ * @return The allocated log, each "<name>:<line>:" of the processed code replaced
+ * by the file and line it comes from.
+ * 
+ * Spliced includes and inserted lines shift the processed code, so that glslang
+ * would otherwise report the same error at another line with and without
+ * --native-includes. The lines of the files glslang includes itself are left as is.
+ */
+char* rgsl_line_map_rewrite_log(const struct rgsl_line_map* map, const char* name, const char* log);
+
+/**
+ * @brief Inserts lines of one origin in a line map.
+ * @param map The line map to update.
+ * @param index The 0-based index of the first inserted line, clamped to the end of the map.
+ * @param count The number of lines to insert.
+ * @param origin The origin of the inserted lines, {0, 0} for generated lines.
+ * 
+ * Used by the passes rewriting the processed code, so that the lines following
+ * their insertions keep pointing to their source.
+ */
+void rgsl_line_map_insert(struct rgsl_line_map* map, size_t index, size_t count, struct rgsl_line_origin origin);
+
+/**
+ * @brief Appends lines of another line map to a line map.
+ * @param map The line map to extend. If it has no files yet, those of source are copied.
+ * @param source The line map holding the lines to append, with the same files as map.
+ * @param first The 0-based index of the first line of source to append.
+ * @param count The number of lines to append.
+ */
+void rgsl_line_map_append(struct rgsl_line_map* map, const struct rgsl_line_map* source, size_t first, size_t count);
+
+/**
+ * @brief Releases the memory owned by a line map, leaving it empty.
+ * @param map The line map to release.
+ */
+void rgsl_line_map_free(struct rgsl_line_map* map);
+
+/**
+ * @brief Adds a line to insert after the #version directive.
+ * @param state The current state of the parser.
+ * @param line The line to insert, without its newline. It is copied by the parser.
+ * 
+ * Lines are inserted in the order they are added, and a line already added is
+ * ignored, so handlers may request the same extension for every directive.
+ */
+void rgsl_parser_add_preamble(struct rgsl_parser_state* state, const char* line);
+
 /**
  * @brief Parses the shader code, handling preprocessor directives.
  * @param DIRECTIVE_MAPPINGS An array of directive mappings to handle different directives.
  * @param shader_code The original shader code to parse.
+ * @param native_includes Whether include directives are left for glslang to resolve.
  * @return A pointer to the processed shader code with directives handled.
  * 
  * This function processes the provided shader code line by line, checking for
  * preprocessor directives and applying the corresponding transformations based
- * on the provided directive mappings.
+ * on the provided directive mappings. Macros given on the command line, then
+ * the macros of the shader, are defined before parsing and inserted after the
+ * #version directive. The map of the processed lines to their source is stored
+ * in the line_map of the shader.
+ * 
+ * Stage pragmas (see program.h) are kept in the code, each section starting
+ * again from the macros of the prologue, and the declarations of the
+ * specialization constants are inserted before the first one.
  * 
+ * @return NULL if a directive could not be processed.
  * @note The returned string is dynamically allocated and should be freed by the caller.
  */
-char * rgsl_parse_shader(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], struct rgsl_shader_data* shader);
\ No newline at end of file
+char * rgsl_parse_shader(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], struct rgsl_shader_data* shader, bool native_includes);
\ No newline at end of file
@@ -0,0 +1,92 @@
+/** ********************************************************************************
+ * @section Program_Overview Overview
+ * @file program.h
+ * @brief Multi-stage shader files sharing one preprocessing pass.
+ * @details
+ * Typical use cases:
+ * - Keep the stages of a program in one file, marked with #pragma rgsl stage(vert).
+ * *********************************************************************************
+ * @section Program_Header Header
+ * <RGSL/program.h>
+ ***********************************************************************************
+ * @section Program_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Checks whether shader code holds several stages.
+ * @param code The source code of the shader.
+ * @return true if a line of the code is a stage pragma, false otherwise.
+ * 
+ * A program file starts with a prologue shared by its stages (the #version
+ * directive, includes, common declarations), followed by one section per stage,
+ * each starting with a line such as:
+ * 
+ *     #pragma rgsl stage(vert)
+ * 
+ * The stage pragmas must be in the file itself, outside of any conditional.
+ */
+bool rgsl_is_program_code(const char* code);
+
+/**
+ * @brief Preprocesses a program file once and splits it into its stages.
+ * @param program The loaded program file. Its code is preprocessed, the
+ * intermediates are released before returning.
+ * @param out_stages Pointer receiving the stage shaders, in the order of the file,
+ * to be released with rgsl_release_shader and freed by the caller.
+ * @param out_count Pointer receiving the number of stages.
+ * @return true if the program was split, false otherwise.
+ * 
+ * Includes are spliced and conditionals resolved once for the whole file; every
+ * section starts again from the macros of the prologue, so that a section does
+ * not see the macros of the previous ones. Each stage gets the processed prologue
+ * followed by its section as preprocessed code, with a line map pointing at the
+ * lines of the file, and is compiled as a shader of its own: it shares the name
+ * and path of the program and gets the stage of its pragma.
+ */
+bool rgsl_split_program(struct rgsl_shader_data* program, struct rgsl_shader_data** out_stages, size_t* out_count);
+
+/**
+ * @brief Parses the stages of a program, one thread per stage.
+ * @param stages The stages split from a program.
+ * @param count The number of stages.
+ * 
+ * GLSL stages are parsed and linked with glslang when a requested action needs
+ * the program, RGSL stages are parsed and checked into their module. The results
+ * are kept in the stages, so that the actions run on them afterwards, in stage
+ * order on the calling thread, start from there. A stage failing to build is left
+ * as is, the action needing it builds it again and reports the errors.
+ */
+void rgsl_build_program_stages(struct rgsl_shader_data* stages, size_t count);
\ No newline at end of file
@@ -0,0 +1,92 @@
+/** ********************************************************************************
+ * @section Resolver_Overview Overview
+ * @file resolver.h
+ * @brief Header file for include path resolution functions.
+ * @details
+ * Typical use cases:
+ * - Resolving include directives against the include search paths.
+ * *********************************************************************************
+ * @section Resolver_Header Header
+ * <RGSL/resolver.h>
+ ***********************************************************************************
+ * @section Resolver_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+/**
+ * @brief Resolves an included file name to the path of an existing file.
+ * @param name The name written in the include directive, without delimiters.
+ * @param includer_path The path of the including file for quoted includes, or NULL
+ * for system includes.
+ * @return A dynamically allocated path to the included file, or NULL if it could
+ * not be found.
+ * 
+ * Quoted includes are first looked up relative to the directory of the including
+ * file, then in the include paths. System includes are only looked up in the
+ * include paths, in the order they were given on the command line.
+ * 
+ * Each searched directory is listed once into a hashed index, so that resolving
+ * a name costs a hash lookup per include path instead of a file open. Both found
+ * and missing names are cached until rgsl_resolver_invalidate is called.
+ * 
+ * @note The returned string is dynamically allocated and should be freed by the caller.
+ */
+char* rgsl_resolve_include(const char* name, const char* includer_path);
+
+/**
+ * @brief Reads an included file through the include content cache.
+ * @param path The path of the file, as returned by rgsl_resolve_include.
+ * @param out_content Pointer receiving the content of the file, with LF line endings.
+ * @param out_size Optional pointer receiving the size of the content in bytes.
+ * @return true if the file could be read, false otherwise.
+ * 
+ * Every file is read from disk once and shared by all the shaders including it.
+ * The content is owned by the cache and stays valid until the file is invalidated.
+ */
+bool rgsl_resolver_read(const char* path, const char** out_content, size_t* out_size);
+
+/**
+ * @brief Invalidates the cached directory listings and lookups.
+ * @param path The path of a file that was created, modified or deleted, or NULL
+ * to drop every cached entry.
+ * 
+ * This function should be called by long-running modes (e.g. watch or server modes)
+ * whenever the file system changes, so that new files become visible, removed
+ * files stop resolving and modified files are read again.
+ */
+void rgsl_resolver_invalidate(const char* path);
+
+/**
+ * @brief Frees all the memory held by the include resolver.
+ * 
+ * This function should be called once all shaders have been processed.
+ */
+void rgsl_resolver_finalize();
\ No newline at end of file
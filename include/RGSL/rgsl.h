@@ -39,6 +39,8 @@
 
 #pragma once
 #include <stdbool.h>
+#include <stdint.h>
+#include <RGSL/hashmap.h>
 
 /**
  * @brief Structure to hold shader profile information.
@@ -50,19 +52,108 @@ struct rgsl_shader_profile {
     const char* name;
 };
 
+struct rgsl_glslang_program;
+struct rgsl_block_layout;
+struct rgsl_module;
+struct rgsl_target_output;
+
+/**
+ * @brief Structure to hold the value of a specialization constant.
+ * 
+ * This structure contains the ID of the constant and its raw 32-bit value,
+ * laid out like the data of a VkSpecializationInfo.
+ */
+struct rgsl_specialization {
+    uint32_t constant_id;
+    uint32_t value;
+};
+
+/**
+ * @brief Structure to locate a line of the preprocessed code in its source file.
+ * 
+ * The file is an index in the files of the line map, and the line is 1-based.
+ * Lines inserted by the preprocessor (e.g. the macros given on the command line)
+ * have no source, and a line of 0.
+ */
+struct rgsl_line_origin {
+    uint32_t file;
+    uint32_t line;
+};
+
+/**
+ * @brief Structure to map the lines of the preprocessed code to their source.
+ * 
+ * This structure holds the paths of the shader and of the files spliced into it,
+ * and the origin of each line of the preprocessed code, so that diagnostics on
+ * that code can point to the line the user wrote.
+ */
+struct rgsl_line_map {
+    char** files;
+    size_t file_count;
+    struct rgsl_line_origin* lines;
+    size_t line_count;
+    size_t line_capacity;
+};
+
 /**
  * @brief Structure to hold shader data.
  * 
  * This structure contains information about a shader, including its name,
- * source code, word count, language, stage, and profile.
+ * source file path, source code, word count, language, stage, and profile.
+ * The profile requested for the shader (version 0 if none) replaces the one of
+ * its #version directive, and its own macros are defined after the global ones.
+ * 
+ * It also holds the intermediate results shared by the actions run on the shader:
+ * the preprocessed code (and whether its includes are left to glslang) with the
+ * map of its lines to the source files, and the glslang program parsed and linked
+ * from it. Each is built once, by the first action needing it, and released with
+ * rgsl_release_shader_intermediates.
+ * 
+ * The values given to macros promoted to specialization constants (see spec.h)
+ * are kept as specializations instead of being defined.
+ * 
+ * Shaders compiled for embedding also keep the hash of their interface, computed
+ * from the reflection of the program (zero if it could not be built).
+ * 
+ * With --pack-uniforms, the block the loose uniforms were packed into is kept
+ * (NULL if the shader has none), so that the packager can mirror it in C. With
+ * --layout-report, so are the layouts of its std140 and std430 blocks and of the
+ * structures they hold, in dependency order.
+ * 
+ * RGSL shaders keep the module parsed and checked from their preprocessed code,
+ * which every backend emits from.
+ * 
+ * With --targets, the code compiled for each target is kept in the target outputs
+ * (see target.h) instead of the code.
+ * 
+ * With --shared-chunks, the GLSL code to embed is cut into chunks (see packager.h),
+ * kept as the offset in the code of the end of each chunk.
  */
 struct rgsl_shader_data {
     const char* name;
+    const char* path;
     char* code;
     size_t word_count;
     const char* language;
     const char* stage;
     struct rgsl_shader_profile profile;
+    struct rgsl_shader_profile requested_profile;
+    const char** defines;
+    char* processed_code;
+    struct rgsl_line_map line_map;
+    bool native_includes;
+    struct rgsl_glslang_program* program;
+    struct rgsl_specialization* specializations;
+    size_t specialization_count;
+    struct rgsl_hash128 interface_hash;
+    struct rgsl_block_layout* uniform_block;
+    struct rgsl_block_layout** layouts;
+    size_t layout_count;
+    struct rgsl_module* module;
+    struct rgsl_target_output* target_outputs;
+    size_t target_output_count;
+    size_t* chunk_ends;
+    size_t chunk_count;
 };
 
 /**
@@ -108,8 +199,40 @@ enum rgsl_action {
 struct rgsl_options {
     const char** input_files;
     const char* output_file;
+    const char* manifest_file;
     const char** include_paths;
+    const char** defines;
+    const char** spec_constants;
+    const char* stage;
+    const char* profile;
     enum rgsl_action action;
+    int native_includes; // int, as argparse stores OPT_BOOLEAN values as int
+    int serial_io;
+    int split_embed;
+    int shared_chunks;
+    const char* cost_report;
+    const char* cost_baseline;
+    int cost_threshold;
+    int perf_lint;
+    const char* perf_lint_suppress;
+    int demote_precision;
+    int mediump_texture_size;
+    int mediump_outputs;
+    int pack_uniforms;
+    int pack_uniforms_binding;
+    int layout_report;
+    int layout_reorder;
+    int benchmark;
+    const char* targets;
+    int glslang_spirv;
+    int spirv_validate;
+    int program_module;
+    const char* log_json;
+    const char* mem_report;
+    const char* usage_profile;
+    int startup_time;
+    int split_cold;
+    int usage_faults;
     bool show_version;
     int verbose;
 };
@@ -150,6 +273,14 @@ void rgsl_print_version();
  */
 const char* rgsl_determine_shader_stage(const char* filename);
 
+/**
+ * @brief Finds a shader stage from its name.
+ * @param name The name of the stage (e.g. "vert", "frag"), not necessarily null-terminated.
+ * @param length The length of the name.
+ * @return The stage, as returned by rgsl_determine_shader_stage, or NULL if unknown.
+ */
+const char* rgsl_find_shader_stage(const char* name, size_t length);
+
 /**
  * @brief Determines the shader language based on the filename extension.
  * @param filename The name of the shader file.
@@ -169,4 +300,30 @@ const char* rgsl_determine_shader_language(const char* filename);
  * This function extracts the base name of the shader file (without path and extension)
  * to be used as the shader name.
  */
-const char* rgsl_determine_shader_name(const char* filename);
\ No newline at end of file
+const char* rgsl_determine_shader_name(const char* filename);
+
+/**
+ * @brief Parses a shader profile given on the command line.
+ * @param text The profile, as a version optionally followed by a profile name (e.g. "450", "300es", "330 core").
+ * @param out_profile Pointer receiving the parsed profile.
+ * @return true if the profile is valid, false otherwise.
+ * 
+ * The profile name defaults to "core", or "es" for version 100. It must be one of
+ * "core", "compatibility" or "es".
+ */
+bool rgsl_parse_profile(const char* text, struct rgsl_shader_profile* out_profile);
+
+/**
+ * @brief Releases the intermediate results held by a shader.
+ * @param shader The shader whose preprocessed code, line map and glslang program are released.
+ * 
+ * This function can be called as soon as no more action needs them, e.g. before
+ * keeping the compiled shader for packaging.
+ */
+void rgsl_release_shader_intermediates(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Releases all the memory owned by a shader.
+ * @param shader The shader whose name, code and intermediate results are released.
+ */
+void rgsl_release_shader(struct rgsl_shader_data* shader);
\ No newline at end of file
@@ -0,0 +1,429 @@
+/** ********************************************************************************
+ * @section RGSL_AST_Overview Overview
+ * @file ast.h
+ * @brief Header file for the syntax tree of RGSL shaders.
+ * @details
+ * Typical use cases:
+ * - Holding a parsed and checked RGSL shader, for its backends to emit.
+ * *********************************************************************************
+ * @section RGSL_AST_Header Header
+ * <RGSL/rgsl/ast.h>
+ ***********************************************************************************
+ * @section RGSL_AST_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <RGSL/arena.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/rgsl/lexer.h>
+#include <RGSL/rgsl/types.h>
+
+/**
+ * @brief Enumeration of the precision qualifiers.
+ */
+enum rgsl_precision {
+    RGSL_PRECISION_NONE,
+    RGSL_PRECISION_LOW,
+    RGSL_PRECISION_MEDIUM,
+    RGSL_PRECISION_HIGH
+};
+
+/**
+ * @brief Enumeration of the interpolation qualifiers.
+ */
+enum rgsl_interpolation {
+    RGSL_INTERPOLATION_NONE,
+    RGSL_INTERPOLATION_SMOOTH,
+    RGSL_INTERPOLATION_FLAT,
+    RGSL_INTERPOLATION_NOPERSPECTIVE
+};
+
+// Memory qualifiers of buffer blocks and their members.
+#define RGSL_MEMORY_READONLY 1
+#define RGSL_MEMORY_WRITEONLY 2
+#define RGSL_MEMORY_COHERENT 4
+#define RGSL_MEMORY_VOLATILE 8
+#define RGSL_MEMORY_RESTRICT 16
+
+/**
+ * @brief Enumeration of where variables are stored.
+ */
+enum rgsl_storage {
+    RGSL_STORAGE_LOCAL,
+    RGSL_STORAGE_GLOBAL,
+    RGSL_STORAGE_PARAMETER,
+    RGSL_STORAGE_IN,
+    RGSL_STORAGE_OUT,
+    RGSL_STORAGE_UNIFORM,
+    RGSL_STORAGE_BUFFER,
+    RGSL_STORAGE_BUILTIN
+};
+
+/**
+ * @brief Enumeration of the directions of function parameters.
+ */
+enum rgsl_direction {
+    RGSL_DIRECTION_IN,
+    RGSL_DIRECTION_OUT,
+    RGSL_DIRECTION_INOUT
+};
+
+/**
+ * @brief Structure to hold the layout qualifiers of a declaration.
+ * 
+ * Qualifiers that were not given are -1. The packing is an enum rgsl_layout_packing.
+ */
+struct rgsl_layout_qualifiers {
+    int32_t location;
+    int32_t binding;
+    int32_t constant_id;
+    int32_t packing;
+};
+
+/**
+ * @brief Union holding the value of a constant scalar.
+ */
+union rgsl_scalar_value {
+    float f;
+    int32_t i;
+    uint32_t u;
+    bool b;
+};
+
+/**
+ * @brief Enumeration of the kinds of expressions.
+ * 
+ * Names are parsed as RGSL_EXPR_VARIABLE, and fields as RGSL_EXPR_FIELD, which
+ * the checker turns into RGSL_EXPR_SWIZZLE on vectors and scalars. Implicit
+ * conversions are made explicit by the checker as RGSL_EXPR_CONVERT.
+ */
+enum rgsl_expr_kind {
+    RGSL_EXPR_LITERAL,
+    RGSL_EXPR_VARIABLE,
+    RGSL_EXPR_UNARY,
+    RGSL_EXPR_BINARY,
+    RGSL_EXPR_ASSIGN,
+    RGSL_EXPR_CONDITIONAL,
+    RGSL_EXPR_SEQUENCE,
+    RGSL_EXPR_CALL,
+    RGSL_EXPR_CONSTRUCT,
+    RGSL_EXPR_INDEX,
+    RGSL_EXPR_FIELD,
+    RGSL_EXPR_SWIZZLE,
+    RGSL_EXPR_LENGTH,
+    RGSL_EXPR_CONVERT
+};
+
+struct rgsl_variable;
+struct rgsl_function;
+
+/**
+ * @brief Structure to hold an expression.
+ * 
+ * The operator of unary, binary and assignment expressions is the kind of its
+ * token (e.g. RGSL_TOKEN_PLUS_EQUAL). The operands are, in order, the operand of
+ * unary expressions, fields, swizzles, lengths and conversions, the sides of
+ * binary expressions, assignments, sequences and indexing, and the condition and
+ * branches of conditionals. Calls and constructors have arguments instead.
+ * 
+ * The name is the one of variables, fields and called functions, interned so
+ * that equal names have the same address. Literals keep the text of their token,
+ * NULL once the checker converted them to another type.
+ * 
+ * The type is set by the checker, as is the value of scalar expressions whose
+ * value is constant.
+ */
+struct rgsl_expr {
+    enum rgsl_expr_kind kind;
+    enum rgsl_token_kind op;
+    uint32_t line;
+    bool postfix;
+    bool constant;
+    const struct rgsl_type* type;
+    union rgsl_scalar_value value;
+    struct rgsl_expr* operands[3];
+    struct rgsl_expr** arguments;
+    uint32_t argument_count;
+    const char* name;
+    uint32_t text_length;
+    struct rgsl_variable* variable;
+    struct rgsl_function* function;
+    const struct rgsl_builtin_function* builtin;
+    uint32_t field;
+    uint8_t swizzle[4];
+    uint32_t swizzle_count;
+};
+
+/**
+ * @brief Enumeration of the kinds of statements.
+ */
+enum rgsl_stmt_kind {
+    RGSL_STMT_BLOCK,
+    RGSL_STMT_DECLARATION,
+    RGSL_STMT_EXPRESSION,
+    RGSL_STMT_IF,
+    RGSL_STMT_FOR,
+    RGSL_STMT_WHILE,
+    RGSL_STMT_DO_WHILE,
+    RGSL_STMT_SWITCH,
+    RGSL_STMT_CASE,
+    RGSL_STMT_DEFAULT,
+    RGSL_STMT_BREAK,
+    RGSL_STMT_CONTINUE,
+    RGSL_STMT_RETURN,
+    RGSL_STMT_DISCARD,
+    RGSL_STMT_EMPTY
+};
+
+/**
+ * @brief Structure to hold a statement.
+ * 
+ * Statements are chained by next. The body is the first statement of blocks, the
+ * body of loops and switches (a block), and the branch taken by if statements.
+ * The expression is the one of expression statements, the condition of if
+ * statements and loops, the selector of switches, the label of cases and the
+ * value returned. For loops start with their init statements, declarations
+ * chained like in a block, and end with their step expression.
+ */
+struct rgsl_stmt {
+    enum rgsl_stmt_kind kind;
+    uint32_t line;
+    struct rgsl_stmt* next;
+    struct rgsl_stmt* body;
+    struct rgsl_stmt* else_branch;
+    struct rgsl_stmt* init;
+    struct rgsl_expr* expr;
+    struct rgsl_expr* step;
+    struct rgsl_variable* variable;
+};
+
+struct rgsl_block;
+
+/**
+ * @brief Structure to hold a variable.
+ * 
+ * Members of anonymous blocks are variables too, with their block and index.
+ * The instance of a named block is a variable of the type of its block. Built-in
+ * variables are created on first use. Constant scalars initialized by a constant
+ * expression keep its value, so that they may size arrays and label cases. The
+ * ID is the index of the variable in its module.
+ */
+struct rgsl_variable {
+    const char* name;
+    const struct rgsl_type* type;
+    enum rgsl_storage storage;
+    enum rgsl_direction direction;
+    enum rgsl_interpolation interpolation;
+    enum rgsl_precision precision;
+    uint32_t memory;
+    bool is_const;
+    bool constant;
+    union rgsl_scalar_value value;
+    struct rgsl_layout_qualifiers layout;
+    struct rgsl_expr* initializer;
+    struct rgsl_block* block;
+    uint32_t member;
+    const struct rgsl_builtin_variable* builtin;
+    uint32_t line;
+    uint32_t id;
+};
+
+/**
+ * @brief Structure to hold a field of a structure or a member of a block.
+ */
+struct rgsl_field {
+    const char* name;
+    const struct rgsl_type* type;
+    enum rgsl_precision precision;
+    uint32_t memory;
+    uint32_t line;
+};
+
+/**
+ * @brief Structure to hold a structure declaration, or the members of a block.
+ */
+struct rgsl_struct_decl {
+    const char* name;
+    struct rgsl_field* fields;
+    uint32_t field_count;
+    uint32_t line;
+    struct rgsl_type* type;
+};
+
+/**
+ * @brief Structure to hold a uniform or buffer block.
+ * 
+ * The instance is the variable of a named block, and the members the variables of
+ * the members of an anonymous one, NULL otherwise. Blocks are laid out with std140
+ * (uniform blocks) or std430 (buffer blocks) when no packing is given.
+ */
+struct rgsl_block {
+    struct rgsl_struct_decl members;
+    enum rgsl_storage storage;
+    struct rgsl_layout_qualifiers layout;
+    uint32_t memory;
+    struct rgsl_variable* instance;
+    struct rgsl_variable** member_variables;
+};
+
+/**
+ * @brief Structure to hold a function, declared or defined.
+ * 
+ * The definition is the function defining a prototype, or the function itself
+ * if it has a body. The ID is the index of the function in its module.
+ */
+struct rgsl_function {
+    const char* name;
+    const struct rgsl_type* return_type;
+    struct rgsl_variable** parameters;
+    uint32_t parameter_count;
+    struct rgsl_stmt* body;
+    struct rgsl_function* definition;
+    struct rgsl_function* next_overload;
+    uint32_t line;
+    uint32_t id;
+};
+
+/**
+ * @brief Enumeration of the kinds of global declarations.
+ * 
+ * Default precision statements apply to the float, int or sampler type of their
+ * declaration; layout declarations set the local size of compute shaders.
+ */
+enum rgsl_global_kind {
+    RGSL_GLOBAL_VARIABLE,
+    RGSL_GLOBAL_STRUCT,
+    RGSL_GLOBAL_BLOCK,
+    RGSL_GLOBAL_FUNCTION,
+    RGSL_GLOBAL_PRECISION,
+    RGSL_GLOBAL_LAYOUT
+};
+
+/**
+ * @brief Structure to hold a global declaration, chained in declaration order.
+ */
+struct rgsl_global {
+    enum rgsl_global_kind kind;
+    uint32_t line;
+    struct rgsl_global* next;
+    struct rgsl_variable* variable;
+    struct rgsl_struct_decl* structure;
+    struct rgsl_block* block;
+    struct rgsl_function* function;
+    const struct rgsl_type* precision_type;
+    enum rgsl_precision precision;
+};
+
+/**
+ * @brief Structure to hold an RGSL shader, parsed and checked.
+ * 
+ * Every node is allocated in the arena of the module, released at once. The
+ * diagnostics point to the source files through the line map of the shader, the
+ * errors being counted. The requirements are the first GLSL and ESSL versions
+ * providing every feature the shader uses (the ESSL one 0 if OpenGL ES lacks one),
+ * each with the feature setting it, for the backends to report.
+ */
+struct rgsl_module {
+    struct rgsl_arena arena;
+    const char* path;
+    const char* stage;
+    const struct rgsl_line_map* line_map;
+    struct rgsl_global* globals;
+    struct rgsl_global* last_global;
+    struct rgsl_function* entry_point;
+    uint32_t local_size[3];
+    uint32_t variable_count;
+    uint32_t function_count;
+    size_t token_count;
+    uint32_t error_count;
+    bool quiet;
+    uint32_t desktop_version;
+    const char* desktop_feature;
+    uint32_t es_version;
+    const char* es_feature;
+};
+
+/**
+ * @brief Initializes an empty module.
+ * @param module The module to initialize.
+ * @param path The path of the shader, for diagnostics.
+ * @param stage The stage of the shader.
+ * @param line_map The map of the lines of the preprocessed code to their source.
+ */
+void rgsl_module_init(struct rgsl_module* module, const char* path, const char* stage, const struct rgsl_line_map* line_map);
+
+/**
+ * @brief Releases a module and every node of its tree.
+ * @param module The module to release.
+ */
+void rgsl_module_free(struct rgsl_module* module);
+
+/**
+ * @brief Appends a global declaration to a module.
+ * @param module The module.
+ * @param kind The kind of declaration.
+ * @param line The line of the declaration.
+ * @return The declaration, zeroed but for its kind and line.
+ */
+struct rgsl_global* rgsl_module_add_global(struct rgsl_module* module, enum rgsl_global_kind kind, uint32_t line);
+
+/**
+ * @brief Reports an error on a line of the preprocessed code of a module.
+ * @param module The module, whose error count is incremented.
+ * @param line The 1-based line of the preprocessed code.
+ * @param format The printf-style format of the message.
+ * 
+ * The message is printed as "file:line: error: message", the file and line being
+ * the ones of the source the line comes from. Nothing is printed in quiet mode.
+ */
+void rgsl_module_error(struct rgsl_module* module, uint32_t line, const char* format, ...);
+
+/**
+ * @brief Reports a warning on a line of the preprocessed code of a module.
+ * @param module The module.
+ * @param line The 1-based line of the preprocessed code.
+ * @param format The printf-style format of the message.
+ */
+void rgsl_module_warning(struct rgsl_module* module, uint32_t line, const char* format, ...);
+
+/**
+ * @brief Records that a module uses a feature only provided by some versions.
+ * @param module The module.
+ * @param feature The name of the feature, for diagnostics.
+ * @param desktop_version The first GLSL version providing it.
+ * @param es_version The first ESSL version providing it, 0 if none does.
+ */
+void rgsl_module_require(struct rgsl_module* module, const char* feature, uint32_t desktop_version, uint32_t es_version);
\ No newline at end of file
@@ -0,0 +1,64 @@
+/** ********************************************************************************
+ * @section Benchmark_Overview Overview
+ * @file benchmark.h
+ * @brief Header file for the throughput benchmark of the RGSL frontend.
+ * @details
+ * Typical use cases:
+ * - Measuring how fast the lexer and the parser go through large shaders.
+ * *********************************************************************************
+ * @section Benchmark_Header Header
+ * <RGSL/rgsl/benchmark.h>
+ ***********************************************************************************
+ * @section Benchmark_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+
+/**
+ * @brief Tells whether a benchmark of the frontend was requested.
+ * @return true if --benchmark was given a positive number of iterations, false otherwise.
+ */
+bool rgsl_rgsl_benchmark_enabled();
+
+/**
+ * @brief Measures the throughput of the RGSL frontend on a preprocessed shader.
+ * 
+ * The preprocessed code is lexed alone, then parsed and checked into throwaway modules,
+ * --benchmark times each, and the best pass of each is reported in MB/s and millions of
+ * tokens per second. The best pass is the least disturbed by the rest of the system.
+ * When SPIR-V is requested, the emission of SPIR-V from the syntax tree is timed against
+ * the emission of GLSL compiled by glslang, the way --glslang-spirv goes.
+ * 
+ * @param shader The shader, preprocessed and checked without errors.
+ */
+void rgsl_rgsl_benchmark(const struct rgsl_shader_data* shader);
\ No newline at end of file
@@ -0,0 +1,62 @@
+/** ********************************************************************************
+ * @section RGSL_Checker_Overview Overview
+ * @file checker.h
+ * @brief Header file for the semantic checks of RGSL shaders.
+ * @details
+ * Typical use cases:
+ * - Resolving the names and types of a parsed RGSL module, and rejecting what does not port to every backend.
+ * *********************************************************************************
+ * @section RGSL_Checker_Header Header
+ * <RGSL/rgsl/checker.h>
+ ***********************************************************************************
+ * @section RGSL_Checker_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl/ast.h>
+
+/**
+ * @brief Resolves and checks a parsed module.
+ * @param module The module, parsed without error.
+ * @return true if the module is valid, false otherwise.
+ * 
+ * Names are bound to their declarations, every expression is given its type,
+ * array sizes and case labels are folded, and the implicit conversions are made
+ * explicit with conversion nodes, so that backends lacking them (GLSL ES, SPIR-V)
+ * emit the tree as is. Integer literals converted to float, or to uint when they
+ * are not negative, are converted in place.
+ * 
+ * The module also records the lowest versions of desktop GLSL and GLSL ES
+ * providing the features the shader cannot do without, through
+ * rgsl_module_require.
+ */
+bool rgsl_rgsl_check(struct rgsl_module* module);
\ No newline at end of file
@@ -48,4 +48,16 @@
  * 
  * This function compiles the provided shader code and writes the compiled output.
  */
-bool rgsl_rgsl_compile_shader(struct rgsl_shader_data * shader, char** output);
\ No newline at end of file
+bool rgsl_rgsl_compile_shader(struct rgsl_shader_data * shader, char** output);
+
+/**
+ * @brief Compiles a shader to SPIR-V directly from its syntax tree.
+ * @param shader The shader data to compile.
+ * @param out_words Pointer receiving the SPIR-V words, to be freed with rgsl_free_file_buffer.
+ * @param out_size Pointer receiving the size of the SPIR-V in bytes.
+ * @return true if compilation was successful, false otherwise.
+ * 
+ * This is the SPIR-V path of RGSL shaders, unless --glslang-spirv compiles their
+ * GLSL output with glslang instead.
+ */
+bool rgsl_rgsl_compile_spirv(struct rgsl_shader_data* shader, char** out_words, size_t* out_size);
\ No newline at end of file
@@ -0,0 +1,76 @@
+/** ********************************************************************************
+ * @section RGSL_GLSL_Overview Overview
+ * @file glsl.h
+ * @brief Header file for the GLSL backend of RGSL.
+ * @details
+ * Typical use cases:
+ * - Emitting a checked RGSL module as desktop GLSL or GLSL ES source.
+ * *********************************************************************************
+ * @section RGSL_GLSL_Header Header
+ * <RGSL/rgsl/glsl.h>
+ ***********************************************************************************
+ * @section RGSL_GLSL_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl/ast.h>
+
+/**
+ * @brief Chooses the GLSL profile a module is emitted for.
+ * @param module The checked module.
+ * @param requested The profile requested with --profile, version 0 if none.
+ * @param out_profile Pointer receiving the chosen profile.
+ * @return true if the module can be emitted for the profile, false otherwise.
+ * 
+ * Without a request, the lowest desktop version from 3.30 core providing every
+ * feature of the module is chosen, including the ones that could be dropped:
+ * varying locations (4.10) and bindings (4.20). A requested profile lacking a
+ * feature the shader needs, such as buffer blocks or a built-in function, is an
+ * error.
+ */
+bool rgsl_glsl_choose_profile(struct rgsl_module* module, const struct rgsl_shader_profile* requested, struct rgsl_shader_profile* out_profile);
+
+/**
+ * @brief Emits a module as GLSL source.
+ * @param module The checked module.
+ * @param profile The profile to emit for, chosen by rgsl_glsl_choose_profile.
+ * @param output The text receiving the source.
+ * 
+ * The features the profile lacks but the shader can do without are dropped:
+ * locations of varyings silently, as the stages are then matched by name, and
+ * bindings with a warning, as the application must then set them. GLSL ES output
+ * declares the default precisions its types need. Implicit conversions are
+ * written as constructors, and parentheses only where precedence needs them.
+ */
+void rgsl_glsl_emit(struct rgsl_module* module, const struct rgsl_shader_profile* profile, struct rgsl_text* output);
\ No newline at end of file
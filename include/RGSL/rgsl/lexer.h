@@ -0,0 +1,209 @@
+/** ********************************************************************************
+ * @section RGSL_Lexer_Overview Overview
+ * @file lexer.h
+ * @brief Header file for the lexer of RGSL sources.
+ * @details
+ * Typical use cases:
+ * - Splitting preprocessed RGSL code into tokens, without allocating them.
+ * *********************************************************************************
+ * @section RGSL_Lexer_Header Header
+ * <RGSL/rgsl/lexer.h>
+ ***********************************************************************************
+ * @section RGSL_Lexer_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * @brief Enumeration of the kinds of RGSL tokens.
+ * 
+ * Keywords are kept in alphabetical order, between RGSL_TOKEN_FIRST_KEYWORD and
+ * RGSL_TOKEN_LAST_KEYWORD, so that they are looked up by binary search over their
+ * spellings. Type names are identifiers, resolved by the parser.
+ */
+enum rgsl_token_kind {
+    RGSL_TOKEN_END,
+    RGSL_TOKEN_ERROR,
+    RGSL_TOKEN_IDENTIFIER,
+    RGSL_TOKEN_INT_LITERAL,
+    RGSL_TOKEN_UINT_LITERAL,
+    RGSL_TOKEN_FLOAT_LITERAL,
+    RGSL_TOKEN_DIRECTIVE,
+
+    RGSL_TOKEN_BREAK,
+    RGSL_TOKEN_BUFFER,
+    RGSL_TOKEN_CASE,
+    RGSL_TOKEN_COHERENT,
+    RGSL_TOKEN_CONST,
+    RGSL_TOKEN_CONTINUE,
+    RGSL_TOKEN_DEFAULT,
+    RGSL_TOKEN_DISCARD,
+    RGSL_TOKEN_DO,
+    RGSL_TOKEN_ELSE,
+    RGSL_TOKEN_FALSE,
+    RGSL_TOKEN_FLAT,
+    RGSL_TOKEN_FOR,
+    RGSL_TOKEN_HIGHP,
+    RGSL_TOKEN_IF,
+    RGSL_TOKEN_IN,
+    RGSL_TOKEN_INOUT,
+    RGSL_TOKEN_LAYOUT,
+    RGSL_TOKEN_LOWP,
+    RGSL_TOKEN_MEDIUMP,
+    RGSL_TOKEN_NOPERSPECTIVE,
+    RGSL_TOKEN_OUT,
+    RGSL_TOKEN_PRECISION,
+    RGSL_TOKEN_READONLY,
+    RGSL_TOKEN_RESTRICT,
+    RGSL_TOKEN_RETURN,
+    RGSL_TOKEN_SMOOTH,
+    RGSL_TOKEN_STRUCT,
+    RGSL_TOKEN_SWITCH,
+    RGSL_TOKEN_TRUE,
+    RGSL_TOKEN_UNIFORM,
+    RGSL_TOKEN_VOLATILE,
+    RGSL_TOKEN_WHILE,
+    RGSL_TOKEN_WRITEONLY,
+
+    RGSL_TOKEN_LEFT_PAREN,
+    RGSL_TOKEN_RIGHT_PAREN,
+    RGSL_TOKEN_LEFT_BRACKET,
+    RGSL_TOKEN_RIGHT_BRACKET,
+    RGSL_TOKEN_LEFT_BRACE,
+    RGSL_TOKEN_RIGHT_BRACE,
+    RGSL_TOKEN_DOT,
+    RGSL_TOKEN_COMMA,
+    RGSL_TOKEN_SEMICOLON,
+    RGSL_TOKEN_COLON,
+    RGSL_TOKEN_QUESTION,
+    RGSL_TOKEN_PLUS,
+    RGSL_TOKEN_MINUS,
+    RGSL_TOKEN_STAR,
+    RGSL_TOKEN_SLASH,
+    RGSL_TOKEN_PERCENT,
+    RGSL_TOKEN_AMPERSAND,
+    RGSL_TOKEN_BAR,
+    RGSL_TOKEN_CARET,
+    RGSL_TOKEN_TILDE,
+    RGSL_TOKEN_BANG,
+    RGSL_TOKEN_LESS,
+    RGSL_TOKEN_GREATER,
+    RGSL_TOKEN_EQUAL,
+    RGSL_TOKEN_PLUS_PLUS,
+    RGSL_TOKEN_MINUS_MINUS,
+    RGSL_TOKEN_LEFT_SHIFT,
+    RGSL_TOKEN_RIGHT_SHIFT,
+    RGSL_TOKEN_LESS_EQUAL,
+    RGSL_TOKEN_GREATER_EQUAL,
+    RGSL_TOKEN_EQUAL_EQUAL,
+    RGSL_TOKEN_BANG_EQUAL,
+    RGSL_TOKEN_AND_AND,
+    RGSL_TOKEN_OR_OR,
+    RGSL_TOKEN_XOR_XOR,
+    RGSL_TOKEN_PLUS_EQUAL,
+    RGSL_TOKEN_MINUS_EQUAL,
+    RGSL_TOKEN_STAR_EQUAL,
+    RGSL_TOKEN_SLASH_EQUAL,
+    RGSL_TOKEN_PERCENT_EQUAL,
+    RGSL_TOKEN_AMPERSAND_EQUAL,
+    RGSL_TOKEN_BAR_EQUAL,
+    RGSL_TOKEN_CARET_EQUAL,
+    RGSL_TOKEN_LEFT_SHIFT_EQUAL,
+    RGSL_TOKEN_RIGHT_SHIFT_EQUAL,
+
+    RGSL_TOKEN_KIND_COUNT
+};
+
+#define RGSL_TOKEN_FIRST_KEYWORD RGSL_TOKEN_BREAK
+#define RGSL_TOKEN_LAST_KEYWORD RGSL_TOKEN_WRITEONLY
+
+/**
+ * @brief Structure to hold a token.
+ * 
+ * The token points into the lexed code, which must outlive it. The line is the
+ * 1-based line of the code its first character is on. Directive tokens span the
+ * whole directive line, "#" included, and error tokens the unexpected characters.
+ */
+struct rgsl_token {
+    enum rgsl_token_kind kind;
+    uint32_t length;
+    const char* start;
+    uint32_t line;
+};
+
+/**
+ * @brief Structure to hold the state of a lexer over a code buffer.
+ */
+struct rgsl_lexer {
+    const char* cursor;
+    const char* end;
+    uint32_t line;
+    bool line_start;
+};
+
+/**
+ * @brief Starts lexing a code buffer.
+ * @param lexer The lexer to initialize.
+ * @param code The code to lex, not necessarily null-terminated.
+ * @param length The length of the code.
+ * @param line The line number of the first line of the code.
+ */
+void rgsl_lexer_init(struct rgsl_lexer* lexer, const char* code, size_t length, uint32_t line);
+
+/**
+ * @brief Reads the next token.
+ * @param lexer The lexer to read from.
+ * @param token The token read, RGSL_TOKEN_END at the end of the code.
+ * 
+ * Spaces and comments are skipped. Characters are classified by table, and
+ * operators read by a finite automaton, so that the cost of a token only depends
+ * on its length.
+ */
+void rgsl_lexer_next(struct rgsl_lexer* lexer, struct rgsl_token* token);
+
+/**
+ * @brief Returns the spelling of a keyword or operator, or a description of the other tokens.
+ * @param kind The kind of token.
+ * @return The spelling, e.g. "while", "+=" or "identifier".
+ */
+const char* rgsl_token_spelling(enum rgsl_token_kind kind);
+
+/**
+ * @brief Returns the precedence of a binary operator.
+ * @param kind The kind of token.
+ * @return From 1 for "||" to 11 for "*", "/" and "%", or 0 if the token is not a
+ * binary operator. Assignments, "?:" and "," bind looser than every binary operator.
+ */
+uint32_t rgsl_token_precedence(enum rgsl_token_kind kind);
\ No newline at end of file
@@ -1,15 +1,15 @@
 /** ********************************************************************************
- * @section GLSL_Parser_Overview Overview
+ * @section RGSL_Parser_Overview Overview
  * @file parser.h
  * @brief Header file for shader parsing functions.
  * @details
  * Typical use cases:
- * - Parsing GLSL shader code.
+ * - Parsing RGSL shader code into a checked syntax tree.
  * *********************************************************************************
- * @section GLSL_Parser_Header Header
- * <RGSL/glsl/parser.h>
+ * @section RGSL_Parser_Header Header
+ * <RGSL/rgsl/parser.h>
  ***********************************************************************************
- * @section GLSL_Parser_Metadata Metadata
+ * @section RGSL_Parser_Metadata Metadata
  * @author Estorc
  * @version v1.0
  * @copyright Copyright (c) 2025 Estorc MIT License.
@@ -37,5 +37,39 @@
  * SOFTWARE.
  ***********************************************************************************/
 
+
 #pragma once
-#include <RGSL/parser.h>
\ No newline at end of file
+#include <RGSL/parser.h>
+#include <RGSL/rgsl/ast.h>
+
+/**
+ * @brief External declaration of RGSL directive mappings.
+ * 
+ * RGSL shares the includes, macros and conditionals of GLSL. It has no #version
+ * directive, the profile of the output being chosen by --profile or from the
+ * features the shader uses.
+ */
+extern const struct rgsl_directive_mapping RGSL_DIRECTIVE_MAPPINGS[];
+
+/**
+ * @brief Parses preprocessed RGSL code into a module.
+ * @param module The module receiving the declarations, initialized.
+ * @param code The preprocessed code.
+ * @param length The length of the code.
+ * @return true if the code was parsed without error.
+ * 
+ * The #define directives left in the code by the preprocessor are applied while
+ * parsing, object-like macros being expanded from their definition without
+ * copying it.
+ */
+bool rgsl_rgsl_parse(struct rgsl_module* module, const char* code, size_t length);
+
+/**
+ * @brief Preprocesses, parses and checks an RGSL shader, unless it already was.
+ * @param shader The shader to build. Its processed code and module are set on success.
+ * @return true if the shader is valid RGSL, false otherwise.
+ * 
+ * The module is kept in the shader, so that validation and compilation share one
+ * parse. It is released with the other intermediates of the shader.
+ */
+bool rgsl_rgsl_build_module(struct rgsl_shader_data* shader);
\ No newline at end of file
@@ -0,0 +1,74 @@
+/** ********************************************************************************
+ * @section RGSL_SPIRV_Overview Overview
+ * @file spirv.h
+ * @brief Header file for the SPIR-V backend of RGSL.
+ * @details
+ * Typical use cases:
+ * - Emitting a checked RGSL module as SPIR-V, without going through GLSL and glslang.
+ * *********************************************************************************
+ * @section RGSL_SPIRV_Header Header
+ * <RGSL/rgsl/spirv.h>
+ ***********************************************************************************
+ * @section RGSL_SPIRV_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <RGSL/rgsl/ast.h>
+
+/**
+ * @brief Emits a module as SPIR-V 1.0 for the OpenGL 4.5 environment.
+ * @param module The checked module.
+ * @param out_words Pointer receiving the allocated words of the module, to be freed by the caller.
+ * @param out_word_count Pointer receiving the number of words.
+ * @return true if the module was emitted, false if it uses something the backend
+ * cannot express, reported as an error of the module.
+ * 
+ * Local scalars and vectors live in SSA form, their phis placed on the fly while
+ * the structured control flow is emitted; other locals are function variables.
+ * Scalar constant expressions are folded, and specialization constants become
+ * OpSpecConstant with --spec-constant. Inputs, outputs, uniforms and blocks
+ * without location or binding get the first free ones, in declaration order, as
+ * glslang does when mapping the IO of GLSL.
+ */
+bool rgsl_spirv_emit(struct rgsl_module* module, uint32_t** out_words, size_t* out_word_count);
+
+/**
+ * @brief Describes the interface of a module, as rgsl_spirv_emit lays it out.
+ * @param module The checked module.
+ * @return The allocated description, one sorted line per input, output, uniform,
+ * block and block member, with its type, location, binding or offset, after a
+ * "stage" line. To be freed by the caller.
+ */
+char* rgsl_spirv_describe_interface(struct rgsl_module* module);
\ No newline at end of file
@@ -0,0 +1,301 @@
+/** ********************************************************************************
+ * @section RGSL_Types_Overview Overview
+ * @file types.h
+ * @brief Header file for the types and built-ins of RGSL.
+ * @details
+ * Typical use cases:
+ * - Looking up the built-in types, functions and variables of RGSL, and matching calls to them.
+ * *********************************************************************************
+ * @section RGSL_Types_Header Header
+ * <RGSL/rgsl/types.h>
+ ***********************************************************************************
+ * @section RGSL_Types_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <RGSL/layout.h>
+#include <RGSL/text.h>
+
+/**
+ * @brief Enumeration of the kinds of RGSL types.
+ */
+enum rgsl_type_kind {
+    RGSL_TYPE_VOID,
+    RGSL_TYPE_SCALAR,
+    RGSL_TYPE_VECTOR,
+    RGSL_TYPE_MATRIX,
+    RGSL_TYPE_SAMPLER,
+    RGSL_TYPE_STRUCT,
+    RGSL_TYPE_ARRAY,
+    RGSL_TYPE_ERROR
+};
+
+/**
+ * @brief Enumeration of the dimensions of samplers.
+ */
+enum rgsl_sampler_dim {
+    RGSL_SAMPLER_2D,
+    RGSL_SAMPLER_3D,
+    RGSL_SAMPLER_CUBE,
+    RGSL_SAMPLER_2D_ARRAY
+};
+
+/**
+ * @brief Enumeration of the built-in types, in the order of their table.
+ */
+enum rgsl_builtin_type {
+    RGSL_BUILTIN_VOID,
+    RGSL_BUILTIN_FLOAT, RGSL_BUILTIN_VEC2, RGSL_BUILTIN_VEC3, RGSL_BUILTIN_VEC4,
+    RGSL_BUILTIN_INT, RGSL_BUILTIN_IVEC2, RGSL_BUILTIN_IVEC3, RGSL_BUILTIN_IVEC4,
+    RGSL_BUILTIN_UINT, RGSL_BUILTIN_UVEC2, RGSL_BUILTIN_UVEC3, RGSL_BUILTIN_UVEC4,
+    RGSL_BUILTIN_BOOL, RGSL_BUILTIN_BVEC2, RGSL_BUILTIN_BVEC3, RGSL_BUILTIN_BVEC4,
+    RGSL_BUILTIN_MAT2, RGSL_BUILTIN_MAT2X3, RGSL_BUILTIN_MAT2X4,
+    RGSL_BUILTIN_MAT3X2, RGSL_BUILTIN_MAT3, RGSL_BUILTIN_MAT3X4,
+    RGSL_BUILTIN_MAT4X2, RGSL_BUILTIN_MAT4X3, RGSL_BUILTIN_MAT4,
+    RGSL_BUILTIN_SAMPLER2D, RGSL_BUILTIN_SAMPLER3D, RGSL_BUILTIN_SAMPLERCUBE, RGSL_BUILTIN_SAMPLER2DARRAY,
+    RGSL_BUILTIN_ISAMPLER2D, RGSL_BUILTIN_ISAMPLER3D, RGSL_BUILTIN_ISAMPLERCUBE, RGSL_BUILTIN_ISAMPLER2DARRAY,
+    RGSL_BUILTIN_USAMPLER2D, RGSL_BUILTIN_USAMPLER3D, RGSL_BUILTIN_USAMPLERCUBE, RGSL_BUILTIN_USAMPLER2DARRAY,
+    RGSL_BUILTIN_SAMPLER2DSHADOW, RGSL_BUILTIN_SAMPLERCUBESHADOW, RGSL_BUILTIN_SAMPLER2DARRAYSHADOW,
+    RGSL_BUILTIN_ERROR,
+    RGSL_BUILTIN_TYPE_COUNT
+};
+
+struct rgsl_struct_decl;
+struct rgsl_expr;
+
+/**
+ * @brief Structure describing an RGSL type.
+ * 
+ * Like in layout.h, vectors have one column of rows components, and scalars one
+ * column and one row. The scalar kind of samplers is the one of the values they
+ * return. Built-in types are unique, so that they compare by address; structure
+ * and array types are allocated in the arena of their module, and arrays compare
+ * by element type and size. The size of an array is written by the checker, from
+ * its size expression (NULL if it was declared without size), and is
+ * RGSL_RUNTIME_ARRAY for the last member of a buffer block.
+ */
+struct rgsl_type {
+    enum rgsl_type_kind kind;
+    const char* name;
+    enum rgsl_scalar_kind scalar;
+    uint32_t columns;
+    uint32_t rows;
+    enum rgsl_sampler_dim dim;
+    bool shadow;
+    const struct rgsl_type* element;
+    struct rgsl_expr* size_expr;
+    uint32_t array_size;
+    const struct rgsl_struct_decl* structure;
+};
+
+/**
+ * @brief Enumeration of the parameter and result kinds of built-in functions.
+ * 
+ * The generic kinds take a scalar or vector (the vector kinds only a vector) of
+ * the same size N in every parameter and the result of one call. The matrix kind
+ * takes the same float matrix M, the sampler kind any sampler S, and the texture
+ * kinds the coordinates, gradients and offsets of S.
+ */
+enum rgsl_builtin_kind {
+    RGSL_ARG_NONE,
+    RGSL_ARG_GEN_FLOAT,
+    RGSL_ARG_GEN_INT,
+    RGSL_ARG_GEN_UINT,
+    RGSL_ARG_GEN_BOOL,
+    RGSL_ARG_VEC_FLOAT,
+    RGSL_ARG_VEC_INT,
+    RGSL_ARG_VEC_UINT,
+    RGSL_ARG_VEC_BOOL,
+    RGSL_ARG_FLOAT,
+    RGSL_ARG_INT,
+    RGSL_ARG_UINT,
+    RGSL_ARG_BOOL,
+    RGSL_ARG_VEC2,
+    RGSL_ARG_VEC3,
+    RGSL_ARG_MAT,
+    RGSL_ARG_SQUARE_MAT,
+    RGSL_ARG_TRANSPOSED_MAT,
+    RGSL_ARG_SAMPLER,
+    RGSL_ARG_COORD,
+    RGSL_ARG_FETCH_COORD,
+    RGSL_ARG_GRADIENT,
+    RGSL_ARG_OFFSET,
+    RGSL_ARG_TEXEL,
+    RGSL_ARG_SIZE
+};
+
+// Built-in function only available to fragment shaders.
+#define RGSL_BUILTIN_FRAGMENT_ONLY 1
+// Built-in texture function not taking shadow samplers.
+#define RGSL_BUILTIN_NO_SHADOW 2
+// Built-in texture function not taking cube samplers.
+#define RGSL_BUILTIN_NO_CUBE 4
+
+/**
+ * @brief Structure describing an overload of a built-in function.
+ * 
+ * The versions are the first GLSL and ESSL versions declaring it, the ESSL one 0
+ * if OpenGL ES has none.
+ */
+struct rgsl_builtin_function {
+    const char* name;
+    uint8_t result;
+    uint8_t parameters[4];
+    uint8_t flags;
+    uint16_t desktop_version;
+    uint16_t es_version;
+};
+
+/**
+ * @brief Structure holding how the arguments of a call match a built-in function.
+ * 
+ * Each argument is converted to its parameter type, and the cost is the number of
+ * arguments needing a conversion.
+ */
+struct rgsl_builtin_match {
+    const struct rgsl_type* parameters[4];
+    const struct rgsl_type* result;
+    uint32_t cost;
+};
+
+/**
+ * @brief Structure describing a built-in variable.
+ * 
+ * The stage is the one of the shaders declaring it, and the variable is an
+ * output if shaders write it. The versions are as for built-in functions.
+ */
+struct rgsl_builtin_variable {
+    const char* name;
+    enum rgsl_builtin_type type;
+    const char* stage;
+    bool output;
+    uint16_t desktop_version;
+    uint16_t es_version;
+};
+
+/**
+ * @brief Returns a built-in type.
+ * @param id The built-in type.
+ * @return The unique description of the type.
+ */
+const struct rgsl_type* rgsl_builtin_type(enum rgsl_builtin_type id);
+
+/**
+ * @brief Looks up a built-in type by name.
+ * @param name The name, not necessarily null-terminated.
+ * @param length The length of the name.
+ * @return The type, or NULL if no built-in type has that name. "mat3x3" returns mat3.
+ */
+const struct rgsl_type* rgsl_find_builtin_type(const char* name, size_t length);
+
+/**
+ * @brief Returns the scalar or vector type of a scalar kind and size.
+ * @param scalar The scalar kind of the components.
+ * @param size The number of components, from 1 (a scalar) to 4.
+ * @return The type.
+ */
+const struct rgsl_type* rgsl_vector_type(enum rgsl_scalar_kind scalar, uint32_t size);
+
+/**
+ * @brief Returns the float matrix type of a size.
+ * @param columns The number of columns, from 2 to 4.
+ * @param rows The number of rows, from 2 to 4.
+ * @return The type.
+ */
+const struct rgsl_type* rgsl_matrix_type(uint32_t columns, uint32_t rows);
+
+/**
+ * @brief Checks whether two types are the same.
+ * @param a The first type.
+ * @param b The second type.
+ * @return true if the types are the same, arrays being compared by element type and size.
+ */
+bool rgsl_type_equal(const struct rgsl_type* a, const struct rgsl_type* b);
+
+/**
+ * @brief Checks whether a type is a scalar or vector of numbers (not booleans).
+ * @param type The type.
+ * @return true for int, uint and float scalars and vectors.
+ */
+bool rgsl_type_is_numeric(const struct rgsl_type* type);
+
+/**
+ * @brief Checks whether a type holds a sampler, in itself or in an array or structure.
+ * @param type The type.
+ * @return true if values of the type are opaque.
+ */
+bool rgsl_type_is_opaque(const struct rgsl_type* type);
+
+/**
+ * @brief Writes the name of a type, as in diagnostics.
+ * @param output The text receiving the name, e.g. "vec3", "Light" or "float[4]".
+ * @param type The type.
+ */
+void rgsl_type_write(struct rgsl_text* output, const struct rgsl_type* type);
+
+/**
+ * @brief Checks whether a value of a type converts implicitly to another.
+ * @param from The type of the value.
+ * @param to The type needed.
+ * @return true if the types are the same, or if int or uint scalars or vectors
+ * convert to float ones of the same size.
+ */
+bool rgsl_type_converts(const struct rgsl_type* from, const struct rgsl_type* to);
+
+/**
+ * @brief Finds the overloads of a built-in function.
+ * @param name The name of the function, null-terminated.
+ * @param out_count Pointer receiving the number of overloads.
+ * @return The first overload, the others following it, or NULL if no built-in
+ * function has that name.
+ */
+const struct rgsl_builtin_function* rgsl_find_builtin_functions(const char* name, size_t* out_count);
+
+/**
+ * @brief Matches the arguments of a call with an overload of a built-in function.
+ * @param function The overload.
+ * @param arguments The types of the arguments.
+ * @param count The number of arguments.
+ * @param out_match Pointer receiving the parameter and result types.
+ * @return true if the arguments match, maybe through implicit conversions.
+ */
+bool rgsl_match_builtin_function(const struct rgsl_builtin_function* function, const struct rgsl_type* const* arguments, size_t count, struct rgsl_builtin_match* out_match);
+
+/**
+ * @brief Finds a built-in variable.
+ * @param name The name of the variable, null-terminated.
+ * @return The variable, or NULL if no built-in variable has that name.
+ */
+const struct rgsl_builtin_variable* rgsl_find_builtin_variable(const char* name);
\ No newline at end of file
@@ -0,0 +1,115 @@
+/** ********************************************************************************
+ * @section Spec_Overview Overview
+ * @file spec.h
+ * @brief Header file for macros promoted to SPIR-V specialization constants.
+ * @details
+ * Typical use cases:
+ * - Collapsing shader variants that only differ by a constant into one SPIR-V blob.
+ * *********************************************************************************
+ * @section Spec_Header Header
+ * <RGSL/spec.h>
+ ***********************************************************************************
+ * @section Spec_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <RGSL/text.h>
+
+/**
+ * @brief Enumeration of specialization constant types.
+ * 
+ * The type of a constant is deduced from the literal of its default value:
+ * true/false, an integer, an integer with a u suffix, or a floating-point number.
+ */
+enum rgsl_spec_type {
+    RGSL_SPEC_BOOL,
+    RGSL_SPEC_INT,
+    RGSL_SPEC_UINT,
+    RGSL_SPEC_FLOAT
+};
+
+/**
+ * @brief Tells whether macros are promoted to specialization constants.
+ * @return true if --spec-constant was given and SPIR-V is generated, false otherwise.
+ * 
+ * Specialization constants only exist in SPIR-V, so the promoted macros stay
+ * ordinary macros for the other actions.
+ */
+bool rgsl_spec_constants_enabled();
+
+/**
+ * @brief Checks the --spec-constant options.
+ * @return true if every option is a valid name with an optional valid default, false otherwise.
+ */
+bool rgsl_check_spec_constants();
+
+/**
+ * @brief Returns the number of promoted macros.
+ * @return The number of --spec-constant options, or 0 if they are not enabled.
+ */
+size_t rgsl_spec_constant_count();
+
+/**
+ * @brief Looks up a promoted macro by name.
+ * @param name The name to look up, not necessarily null-terminated.
+ * @param length The length of the name.
+ * @return The constant ID of the macro, or -1 if it is not promoted.
+ * 
+ * Constant IDs are the positions of the macros in the --spec-constant options,
+ * so they are the same for every shader of a run.
+ */
+int rgsl_find_spec_constant(const char* name, size_t length);
+
+/**
+ * @brief Converts a macro value to the raw value of a specialization constant.
+ * @param constant_id The ID of the constant.
+ * @param text The value given to the macro, e.g. with -D NAME=VALUE.
+ * @param out_value Pointer receiving the 32-bit value, as expected by VkSpecializationInfo.
+ * @return true if the value is a literal convertible to the type of the constant, false otherwise.
+ */
+bool rgsl_spec_constant_value(size_t constant_id, const char* text, uint32_t* out_value);
+
+/**
+ * @brief Writes the declarations of every promoted macro.
+ * @param output The text receiving the declarations.
+ * 
+ * Each macro becomes a line such as
+ * "layout(constant_id = 0) const highp int RENDERER_MODE = 0;".
+ */
+void rgsl_write_spec_constant_declarations(struct rgsl_text* output);
+
+/**
+ * @brief Writes an enumeration of the constant IDs, for the generated C file.
+ * @param output The text receiving the enumeration.
+ */
+void rgsl_write_spec_constant_enum(struct rgsl_text* output);
\ No newline at end of file
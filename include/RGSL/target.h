@@ -0,0 +1,203 @@
+/** ********************************************************************************
+ * @section Target_Overview Overview
+ * @file target.h
+ * @brief Header file for the compilation of one shader to several targets.
+ * @details
+ * Typical use cases:
+ * - Emitting desktop GLSL, OpenGL ES GLSL and SPIR-V from a single parse of an RGSL shader.
+ * *********************************************************************************
+ * @section Target_Header Header
+ * <RGSL/target.h>
+ ***********************************************************************************
+ * @section Target_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/text.h>
+
+// Most targets a single run can compile each shader to.
+#define RGSL_MAX_TARGETS 8
+
+/**
+ * @brief Structure to hold a target of --targets.
+ * 
+ * A target is a GLSL profile written as by --profile (e.g. 330core, 300es),
+ * spirv for SPIR-V for OpenGL, or vulkan1.0 to vulkan1.3 for SPIR-V for Vulkan,
+ * compiled by glslang from GLSL 4.50 (GLSL shaders only). The Vulkan version is
+ * 100 times the major plus 10 times the minor (e.g. 120), 0 for other targets.
+ */
+struct rgsl_target {
+    char* name;
+    struct rgsl_shader_profile profile;
+    bool spirv;
+    int vulkan;
+};
+
+/**
+ * @brief Structure to hold the code compiled for one target.
+ * 
+ * The profile is the one the code was written for. The code is GLSL text, or
+ * SPIR-V words of the given size in bytes for SPIR-V targets.
+ */
+struct rgsl_target_output {
+    const struct rgsl_target* target;
+    struct rgsl_shader_profile profile;
+    char* code;
+    size_t size;
+};
+
+/**
+ * @brief Tells whether the shaders are compiled to several targets.
+ * @return true if --targets was given, false otherwise.
+ */
+bool rgsl_targets_enabled();
+
+/**
+ * @brief Parses the --targets option.
+ * @return true if the option is absent or a valid list of distinct targets, false otherwise.
+ */
+bool rgsl_check_targets();
+
+/**
+ * @brief Returns the number of targets.
+ * @return The number of targets of --targets, 0 if it was not given.
+ */
+size_t rgsl_target_count();
+
+/**
+ * @brief Returns a target.
+ * @param index The position of the target in --targets.
+ * @return The target.
+ */
+const struct rgsl_target* rgsl_get_target(size_t index);
+
+/**
+ * @brief Releases the parsed targets.
+ */
+void rgsl_targets_finalize();
+
+/**
+ * @brief Builds the path a target is written to, the output path followed by the target name.
+ * @param output_file The path given with --output.
+ * @param target The target.
+ * @return The allocated path (e.g. "main.frag.300es"), to be freed by the caller.
+ */
+char* rgsl_target_output_path(const char* output_file, const struct rgsl_target* target);
+
+/**
+ * @brief Compiles a shader to every target.
+ * @param shader The shader, whose outputs are stored in its target outputs.
+ * @return true if every target was compiled, false otherwise.
+ * 
+ * An RGSL shader is parsed and checked once, then every backend emits from the
+ * same module: the GLSL targets on worker threads, while the SPIR-V target is
+ * emitted on the calling thread.
+ * 
+ * A GLSL shader is preprocessed once, its #version directives dropped and the
+ * conditionals on the version macros kept. Each target puts its own #version,
+ * the default precisions of GLSL ES and a macro naming it (e.g. RGSL_TARGET_300ES)
+ * ahead of the shared body, then glslang validates it, or compiles it for SPIR-V
+ * targets, on a worker thread.
+ */
+bool rgsl_compile_targets(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Writes the GLSL code of a target from the body shared by the targets.
+ * @param target The target.
+ * @param body The preprocessed GLSL shader, without #version directive.
+ * @return The allocated code, to be freed by the caller.
+ * 
+ * The body follows the #version directive of the target, the default precisions
+ * of GLSL ES for ES targets, and the definition of the macro naming the target.
+ */
+char* rgsl_target_glsl_code(const struct rgsl_target* target, const char* body);
+
+/**
+ * @brief Parses and links the GLSL code of a target with glslang.
+ * @param target The target, whose environment the code follows.
+ * @param shader The shader the code comes from.
+ * @param code The code, written by rgsl_target_glsl_code.
+ * @param out_log Pointer receiving the glslang log, to be freed by the caller.
+ * @return The linked program, or NULL if the code is invalid for the target.
+ */
+struct rgsl_glslang_program* rgsl_create_target_program(const struct rgsl_target* target, const struct rgsl_shader_data* shader, const char* code, char** out_log);
+
+/**
+ * @brief Releases the target outputs of a shader.
+ * @param shader The shader.
+ */
+void rgsl_release_target_outputs(struct rgsl_shader_data* shader);
+
+/**
+ * @brief Tells whether one of the targets produces the given kind of code.
+ * @param spirv true to look for a SPIR-V target, false for a GLSL one.
+ * @return true if such a target was given, false otherwise.
+ */
+bool rgsl_has_target(bool spirv);
+
+/**
+ * @brief Writes the enumerator naming a target in the generated C file.
+ * @param output The text receiving the name.
+ * @param target The target.
+ */
+void rgsl_write_target_name(struct rgsl_text* output, const struct rgsl_target* target);
+
+/**
+ * @brief Writes an enumeration of the targets, for the generated C file.
+ * @param output The text receiving the enumeration.
+ * 
+ * Each target is named after its option, e.g. RGSL_TARGET_300ES, in the order of
+ * --targets, and RGSL_TARGET_COUNT follows the last one.
+ */
+void rgsl_write_target_enum(struct rgsl_text* output);
+
+/**
+ * @brief Writes the types describing what each target runs on, for the generated C file.
+ * @param output The text receiving the types.
+ * 
+ * The rgsl_api enumeration names the graphics APIs, and the rgsl_target_info structure
+ * gives the API and version a target needs.
+ */
+void rgsl_write_target_info_types(struct rgsl_text* output);
+
+/**
+ * @brief Writes the table of the targets and the function choosing one, for the generated C file.
+ * @param output The text receiving the definitions.
+ * 
+ * rgsl_select_target(api, version) returns the target of the given API with the
+ * highest version the device supports, or RGSL_TARGET_COUNT if none fits. Versions
+ * are those of GLSL for OpenGL and OpenGL ES (e.g. 330, 300), 450 for SPIR-V on
+ * OpenGL, and 100 times the major plus 10 times the minor for Vulkan (e.g. 120).
+ */
+void rgsl_write_target_infos(struct rgsl_text* output);
\ No newline at end of file
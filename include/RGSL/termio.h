@@ -5,6 +5,7 @@
  * @details
  * Typical use cases:
  * - Printing informational and error messages to the terminal.
+ * - Grouping the messages of each shader, and writing them as JSON lines.
  * *********************************************************************************
  * @section Termio_Header Header
  * <RGSL/termio.h>
@@ -39,6 +40,56 @@
 
 #pragma once
 #include <stdio.h>
+#include <stdarg.h>
+#include <stdbool.h>
+
+/**
+ * @brief Initializes the lock serializing the messages of concurrent threads.
+ * 
+ * Called by rgsl_initialize, before any thread is started.
+ */
+void rgsl_log_initialize();
+
+/**
+ * @brief Closes the JSON log file, and releases the lock.
+ */
+void rgsl_log_finalize();
+
+/**
+ * @brief Writes the messages as JSON lines to a file, instead of the terminal.
+ * @param path The path of the file, or "-" for stdout.
+ * @return true if the file was opened, false otherwise.
+ * 
+ * Each message becomes one object with its time in milliseconds since
+ * rgsl_log_initialize, its level, its shader (or null) and its text:
+ * 
+ * @code{json}
+ * {"time_ms": 12.500, "level": "info", "shader": "shaders/main.vs", "message": "Compiled shader written to main.vert"}
+ * @endcode
+ */
+bool rgsl_log_open_json(const char* path);
+
+/**
+ * @brief Starts holding back the messages of the calling thread, until the shader is done.
+ * @param shader The name of the shader the messages are about, kept by reference.
+ * 
+ * Messages are appended to a buffer of the calling thread, which rgsl_log_end_shader
+ * writes at once, so that those of shaders handled by concurrent threads never
+ * interleave. They are written in the order they were printed, each to its own
+ * stream. Scopes may be nested, only the outermost one is written.
+ * 
+ * @code{c}
+ * rgsl_log_begin_shader(job->input_file);
+ * bool success = rgsl_compile_job(item);
+ * rgsl_log_end_shader();
+ * @endcode
+ */
+void rgsl_log_begin_shader(const char* shader);
+
+/**
+ * @brief Ends the scope of rgsl_log_begin_shader, writing the messages held back.
+ */
+void rgsl_log_end_shader();
 
 /**
  * @brief Prints a formatted message to the specified output stream.
@@ -46,8 +97,9 @@
  * @param prefix The prefix to include in the message (e.g., "Info", "Error").
  * @param message The message to print.
  * 
- * This function prints a message prefixed with "[RGSL <prefix>]" to the given output stream.
- * It flushes the stream to ensure immediate output.
+ * This function prints a message prefixed with "[RGSL <prefix>]" to the given output stream,
+ * or as a JSON line with rgsl_log_open_json. Inside a shader scope, it is held back
+ * until the scope ends; otherwise, it is written at once under the log lock.
  * 
  * @code{c}
  * rgsl_fprint(stdout, "Info", "This is an informational message.");
@@ -64,7 +116,8 @@ void rgsl_fprint(FILE *stream, const char* prefix, const char* message);
  * 
  * This function formats a message according to the specified format string and
  * variable arguments. The formatted message is stored in a dynamically allocated
- * buffer pointed to by out_buffer. The caller is responsible for freeing the buffer.
+ * buffer pointed to by out_buffer, of the exact size. The caller is responsible for
+ * freeing the buffer. out_buffer is set to NULL if the format is invalid.
  * 
  * @code{c}
  * char* buffer = NULL;
@@ -86,7 +139,7 @@ void rgsl_format_parser(const char* format, va_list args, char** out_buffer);
  * @param ... Additional arguments for the format string.
  * 
  * This function prints a formatted message prefixed with "[RGSL <prefix>]" to the given output stream.
- * It utilizes a dynamic buffer to accommodate messages of varying lengths.
+ * Messages are formatted on the stack, only longer ones allocate a buffer.
  */
 void rgsl_fprintf(FILE *stream, const char* prefix, const char* format, ...);
 
@@ -111,7 +164,7 @@ void rgsl_print_info(int verbose_level, const char* message);
  * @param ... Additional arguments for the format string.
  * 
  * This function prints a formatted informational message prefixed with "[RGSL Info]" to stdout.
- * It utilizes the rgsl_fprintf function for formatted output.
+ * The verbosity level is checked first: a filtered message is never formatted.
  * 
  * @code{c}
  * rgsl_printf_info("Shader %s compiled successfully in %d ms.\n", shader_name, time_ms);
@@ -119,6 +172,33 @@ void rgsl_print_info(int verbose_level, const char* message);
  */
 void rgsl_printf_info(int verbose_level, const char* format, ...);
 
+/**
+ * @brief Prints a warning message to the standard error stream.
+ * @param message The warning message to print.
+ * 
+ * This function prints a warning message prefixed with "[RGSL Warning]" to stderr,
+ * whatever the verbosity level.
+ * 
+ * @code{c}
+ * rgsl_print_warning("The shader discards fragments.\n");
+ * @endcode
+ */
+void rgsl_print_warning(const char* message);
+
+/**
+ * @brief Prints a formatted warning message to the standard error stream.
+ * @param format The format string (printf-style).
+ * @param ... Additional arguments for the format string.
+ * 
+ * This function prints a formatted warning message prefixed with "[RGSL Warning]" to stderr.
+ * It utilizes the rgsl_fprintf function for formatted output.
+ * 
+ * @code{c}
+ * rgsl_printf_warning("%s:%d: texture sampled in divergent control flow\n", path, line);
+ * @endcode
+ */
+void rgsl_printf_warning(const char* format, ...);
+
 /**
  * @brief Prints an error message to the standard error stream.
  * @param message The error message to print.
@@ -144,4 +224,4 @@ void rgsl_print_error(const char* message);
  * rgsl_printf_error("Failed to compile shader %s: %s\n", shader_name, error_message);
  * @endcode
  */
-void rgsl_printf_error(const char* format, ...);
+void rgsl_printf_error(const char* format, ...);
\ No newline at end of file
@@ -0,0 +1,115 @@
+/** ********************************************************************************
+ * @section Text_Overview Overview
+ * @file text.h
+ * @brief Header file for growable text buffers.
+ * @details
+ * Typical use cases:
+ * - Generating C sources or reports before writing them.
+ * *********************************************************************************
+ * @section Text_Header Header
+ * <RGSL/text.h>
+ ***********************************************************************************
+ * @section Text_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+#pragma once
+#include <stddef.h>
+
+/**
+ * @brief Structure to hold a growable, null-terminated text buffer.
+ * 
+ * A zero-initialized structure is a valid empty text.
+ */
+struct rgsl_text {
+    char* data;
+    size_t length;
+    size_t capacity;
+};
+
+/**
+ * @brief Initializes an empty text.
+ * @param text The text to initialize.
+ */
+void rgsl_text_init(struct rgsl_text* text);
+
+/**
+ * @brief Frees the memory owned by a text.
+ * @param text The text to free.
+ */
+void rgsl_text_free(struct rgsl_text* text);
+
+/**
+ * @brief Empties a text, keeping its memory for reuse.
+ * @param text The text to clear.
+ */
+void rgsl_text_clear(struct rgsl_text* text);
+
+/**
+ * @brief Appends characters to a text.
+ * @param text The text to append to.
+ * @param str The characters to append.
+ * @param length The number of characters to append.
+ */
+void rgsl_text_append(struct rgsl_text* text, const char* str, size_t length);
+
+/**
+ * @brief Appends a formatted string to a text.
+ * @param text The text to append to.
+ * @param format The printf-style format string.
+ * @param ... The values to format.
+ * 
+ * @code{c}
+ * struct rgsl_text text = {0};
+ * rgsl_text_printf(&text, "static const uint32_t words_%zu[] = {\n", index);
+ * @endcode
+ */
+void rgsl_text_printf(struct rgsl_text* text, const char* format, ...);
\ No newline at end of file
@@ -0,0 +1,168 @@
+/** ********************************************************************************
+ * @section Thread_Overview Overview
+ * @file thread.h
+ * @brief Header file for portable threads and synchronization primitives.
+ * @details
+ * Typical use cases:
+ * - Running pipeline stages or compilation jobs concurrently.
+ * *********************************************************************************
+ * @section Thread_Header Header
+ * <RGSL/thread.h>
+ ***********************************************************************************
+ * @section Thread_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+
+#ifdef _WIN32
+#include <windows.h>
+typedef HANDLE rgsl_thread;
+typedef CRITICAL_SECTION rgsl_mutex;
+typedef CONDITION_VARIABLE rgsl_cond;
+#else
+#include <pthread.h>
+typedef pthread_t rgsl_thread;
+typedef pthread_mutex_t rgsl_mutex;
+typedef pthread_cond_t rgsl_cond;
+#endif
+
+// Storage class of the variables each thread has its own copy of.
+#ifdef _MSC_VER
+#define RGSL_THREAD_LOCAL __declspec(thread)
+#else
+#define RGSL_THREAD_LOCAL __thread
+#endif
+
+/**
+ * @brief Starts a new thread.
+ * @param thread Pointer receiving the thread handle.
+ * @param func The function run by the thread.
+ * @param user The argument given to func.
+ * @return true if the thread was started, false otherwise.
+ */
+bool rgsl_thread_create(rgsl_thread* thread, void (*func)(void* user), void* user);
+
+/**
+ * @brief Waits for a thread to finish, and releases its handle.
+ * @param thread The thread to wait for.
+ */
+void rgsl_thread_join(rgsl_thread thread);
+
+/**
+ * @brief Mutex and condition variable functions.
+ * 
+ * These functions are thin wrappers over the Win32 and POSIX primitives.
+ * rgsl_cond_wait releases the mutex while waiting and locks it again before returning.
+ */
+void rgsl_mutex_init(rgsl_mutex* mutex);
+void rgsl_mutex_destroy(rgsl_mutex* mutex);
+void rgsl_mutex_lock(rgsl_mutex* mutex);
+void rgsl_mutex_unlock(rgsl_mutex* mutex);
+void rgsl_cond_init(rgsl_cond* cond);
+void rgsl_cond_destroy(rgsl_cond* cond);
+void rgsl_cond_wait(rgsl_cond* cond, rgsl_mutex* mutex);
+void rgsl_cond_signal(rgsl_cond* cond);
+void rgsl_cond_broadcast(rgsl_cond* cond);
+
+/**
+ * @brief Structure to hold a bounded, blocking, multi-producer multi-consumer queue.
+ * 
+ * Producers block while the queue is full, so the memory held by the items in
+ * flight stays bounded. Consumers block while it is empty, until it is closed.
+ */
+struct rgsl_queue {
+    void** items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    bool closed;
+    rgsl_mutex mutex;
+    rgsl_cond not_empty;
+    rgsl_cond not_full;
+};
+
+/**
+ * @brief Initializes an empty queue.
+ * @param queue The queue to initialize.
+ * @param capacity The maximum number of items in the queue.
+ */
+void rgsl_queue_init(struct rgsl_queue* queue, size_t capacity);
+
+/**
+ * @brief Frees the memory owned by a queue. The remaining items are not released.
+ * @param queue The queue to free.
+ */
+void rgsl_queue_free(struct rgsl_queue* queue);
+
+/**
+ * @brief Appends an item to a queue, waiting while it is full.
+ * @param queue The queue to append to.
+ * @param item The item to append.
+ * @return true if the item was appended, false if the queue is closed.
+ */
+bool rgsl_queue_push(struct rgsl_queue* queue, void* item);
+
+/**
+ * @brief Removes the oldest item of a queue, waiting while it is empty.
+ * @param queue The queue to remove from.
+ * @param out_item Pointer receiving the item.
+ * @return true if an item was removed, false if the queue is closed and empty.
+ */
+bool rgsl_queue_pop(struct rgsl_queue* queue, void** out_item);
+
+/**
+ * @brief Closes a queue: no more items can be pushed, and consumers stop once it is empty.
+ * @param queue The queue to close.
+ */
+void rgsl_queue_close(struct rgsl_queue* queue);
\ No newline at end of file
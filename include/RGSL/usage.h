@@ -0,0 +1,195 @@
+/** ********************************************************************************
+ * @section Usage_Overview Overview
+ * @file usage.h
+ * @brief Header file for runtime usage profiles and the pack layout they drive.
+ * @details
+ * Typical use cases:
+ * - Ordering the blobs of a package by first use, and simulating the page faults of startup.
+ * *********************************************************************************
+ * @section Usage_Header Header
+ * <RGSL/usage.h>
+ ***********************************************************************************
+ * @section Usage_Metadata Metadata
+ * @author Estorc
+ * @version v1.0
+ * @copyright Copyright (c) 2025 Estorc MIT License.
+ **********************************************************************************/
+/*                             This file is part of
+ *                                     RGSL
+ *                       (https://github.com/Estorc/RGSL)
+ ***********************************************************************************
+ * Copyright (c) 2025 Estorc.
+ * This file is licensed under the MIT License.
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ ***********************************************************************************/
+
+
+
+
+#pragma once
+#include <stdbool.h>
+#include <stddef.h>
+#include <RGSL/hashmap.h>
+
+/**
+ * @brief Structure to hold the usage of one shader, recorded by the engine.
+ * 
+ * The name is the one of its blobs in the package (e.g. "shader_main", shared by
+ * the stages of a shader) or the path of its file as given to rgsl.
+ */
+struct rgsl_usage_entry {
+    char* name;
+    double first_use_ms;
+    size_t uses;
+};
+
+/**
+ * @brief Structure to hold a runtime usage profile.
+ * 
+ * This structure contains the entries of the profile, indexed by name, and the
+ * position of each job in the order of the command line, kept to compare the
+ * layout with it. The shaders first used within startup_ms are startup shaders,
+ * every shader of the profile when startup_ms is 0.
+ */
+struct rgsl_usage_profile {
+    struct rgsl_usage_entry* entries;
+    size_t count;
+    struct rgsl_hashmap index;
+    struct rgsl_hashmap job_order;
+    double startup_ms;
+};
+
+/**
+ * @brief Structure to hold one blob of a package, as laid out by the packager.
+ * 
+ * Blobs sharing their content hash share their bytes, laid out where the first
+ * of them is. Cold blobs are laid out in the cold part of the package.
+ */
+struct rgsl_usage_blob {
+    const char* path;
+    char* name;
+    struct rgsl_hash128 content_hash;
+    size_t size;
+    bool cold;
+};
+
+/**
+ * @brief Loads the profile given with --usage-profile, if any.
+ * @return true if there is no profile or it was loaded, false otherwise.
+ */
+bool rgsl_check_usage_profile();
+
+/**
+ * @brief Releases the profile loaded by rgsl_check_usage_profile.
+ */
+void rgsl_usage_profile_finalize();
+
+/**
+ * @brief Returns the profile given with --usage-profile.
+ * @return The profile, or NULL if none was given.
+ */
+struct rgsl_usage_profile* rgsl_global_usage_profile();
+
+/**
+ * @brief Checks whether the shaders out of startup are packaged apart, with --split-cold.
+ * @return true if they are, false otherwise.
+ */
+bool rgsl_cold_split_enabled();
+
+/**
+ * @brief Loads a usage profile file.
+ * @param profile The profile to initialize.
+ * @param path The path of the profile file.
+ * @return true if the file was loaded, false if it could not be read or is malformed.
+ * 
+ * Each line holds a shader, the time of its first use in milliseconds and its
+ * number of uses, separated by whitespace. '#' starts a comment:
+ * 
+ * @code
+ * # shader          first use (ms)  uses
+ * shader_main       12.5            3600
+ * shader_mask       13.0            3600
+ * shader_blur       5400            12
+ * @endcode
+ */
+bool rgsl_usage_profile_load(struct rgsl_usage_profile* profile, const char* path);
+
+/**
+ * @brief Frees the memory owned by a usage profile.
+ * @param profile The profile to free.
+ */
+void rgsl_usage_profile_free(struct rgsl_usage_profile* profile);
+
+/**
+ * @brief Looks up the usage of a shader.
+ * @param profile The profile to search.
+ * @param path The path of the shader file.
+ * @param name The name of the shader, its blobs being named "shader_<name>".
+ * @return The entry of the shader, or NULL if it is not in the profile.
+ */
+const struct rgsl_usage_entry* rgsl_usage_profile_find(const struct rgsl_usage_profile* profile, const char* path, const char* name);
+
+/**
+ * @brief Checks whether a shader is used at startup.
+ * @param profile The profile to search.
+ * @param path The path of the shader file.
+ * @param name The name of the shader.
+ * @return true if the shader is first used within the startup time, false otherwise.
+ */
+bool rgsl_usage_is_startup(const struct rgsl_usage_profile* profile, const char* path, const char* name);
+
+/**
+ * @brief Orders shaders by first use, the startup shaders first.
+ * @param profile The profile, also recording the previous order of the shaders.
+ * @param paths The paths of the shaders, in the order of the command line.
+ * @param names The names of the shaders.
+ * @param count The number of shaders.
+ * @param out_order Array of count indices receiving the index of each shader in the new order.
+ * 
+ * The startup shaders come first, by first use, then the other shaders of the
+ * profile, by first use, then the shaders never used, in their previous order.
+ * Shaders first used at the same time are ordered by decreasing number of uses.
+ */
+void rgsl_usage_order(struct rgsl_usage_profile* profile, const char* const* paths, const char* const* names, size_t count, size_t* out_order);
+
+/**
+ * @brief Counts the pages a profile faults in over a layout of the blobs of a package.
+ * @param profile The profile, whose shaders are touched in order of first use.
+ * @param blobs The blobs of the package.
+ * @param order Array of count indices giving the blobs in the order they are laid out.
+ * @param count The number of blobs.
+ * @param parts Whether the cold blobs are laid out apart, from a page of their own.
+ * @param out_startup Pointer receiving the faults of the startup shaders.
+ * @param out_total Pointer receiving the faults of the whole profile.
+ * 
+ * Each blob is touched whole on the first use of its shader, in pages of 4 KiB
+ * that stay resident. Blobs sharing their content share their pages.
+ */
+void rgsl_usage_count_faults(const struct rgsl_usage_profile* profile, const struct rgsl_usage_blob* blobs, const size_t* order, size_t count, bool parts, size_t* out_startup, size_t* out_total);
+
+/**
+ * @brief Replays the profile over a package layout, counting the pages it faults in.
+ * @param profile The profile, whose shaders are touched in order of first use.
+ * @param blobs The blobs of the package, in the order they were written.
+ * @param count The number of blobs.
+ * 
+ * Each blob is touched whole on the first use of its shader, in pages of 4 KiB
+ * that stay resident, once in the given layout and once with every blob in the
+ * order of the command line. The faults of startup and of the whole profile are
+ * printed for both. This is a diagnostic, run by the packager with --usage-faults.
+ */
+void rgsl_usage_simulate_faults(const struct rgsl_usage_profile* profile, const struct rgsl_usage_blob* blobs, size_t count);
\ No newline at end of file
@@ -0,0 +1,64 @@
+#include <RGSL/arena.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Alignment of every allocation, enough for any scalar type.
+#define RGSL_ARENA_ALIGNMENT 16
+#define RGSL_ARENA_MAX_CHUNK_SIZE (1024 * 1024)
+
+static size_t rgsl_arena_align(size_t size) {
+    return (size + RGSL_ARENA_ALIGNMENT - 1) & ~(size_t)(RGSL_ARENA_ALIGNMENT - 1);
+}
+
+void rgsl_arena_init(struct rgsl_arena* arena, size_t chunk_size) {
+    arena->chunks = NULL;
+    arena->chunk_size = chunk_size;
+    arena->allocated = 0;
+}
+
+void* rgsl_arena_alloc(struct rgsl_arena* arena, size_t size) {
+    size = rgsl_arena_align(size);
+    struct rgsl_arena_chunk* chunk = arena->chunks;
+    if (chunk == NULL || chunk->used + size > chunk->size) {
+        size_t chunk_size = arena->chunk_size;
+        if (arena->chunk_size < RGSL_ARENA_MAX_CHUNK_SIZE) {
+            arena->chunk_size *= 2;
+        }
+        if (chunk_size < size) {
+            chunk_size = size;
+        }
+        chunk = (struct rgsl_arena_chunk *)rgsl_malloc(rgsl_arena_align(sizeof(struct rgsl_arena_chunk)) + chunk_size);
+        if (chunk == NULL) {
+            return NULL;
+        }
+        chunk->next = arena->chunks;
+        chunk->size = chunk_size;
+        chunk->used = 0;
+        arena->chunks = chunk;
+    }
+    void* memory = (char *)chunk + rgsl_arena_align(sizeof(struct rgsl_arena_chunk)) + chunk->used;
+    chunk->used += size;
+    arena->allocated += size;
+    memset(memory, 0, size);
+    return memory;
+}
+
+void* rgsl_arena_grow(struct rgsl_arena* arena, void* array, size_t old_size, size_t new_size) {
+    void* grown = rgsl_arena_alloc(arena, new_size);
+    if (grown != NULL && array != NULL) {
+        memcpy(grown, array, old_size < new_size ? old_size : new_size);
+    }
+    return grown;
+}
+
+void rgsl_arena_free(struct rgsl_arena* arena) {
+    struct rgsl_arena_chunk* chunk = arena->chunks;
+    while (chunk != NULL) {
+        struct rgsl_arena_chunk* next = chunk->next;
+        rgsl_free(chunk);
+        chunk = next;
+    }
+    arena->chunks = NULL;
+    arena->allocated = 0;
+}
\ No newline at end of file
@@ -0,0 +1,30 @@
+#include <RGSL/clock.h>
+
+#ifdef _WIN32
+#include <windows.h>
+
+double rgsl_clock_seconds() {
+    static LARGE_INTEGER frequency;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    LARGE_INTEGER counter;
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)frequency.QuadPart;
+}
+#else
+#ifndef _POSIX_C_SOURCE
+#define _POSIX_C_SOURCE 199309L // clock_gettime
+#endif
+#include <time.h>
+
+double rgsl_clock_seconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + (double)now.tv_nsec * 1e-9;
+}
+#endif
+
+double rgsl_clock_elapsed_ms(double start) {
+    return (rgsl_clock_seconds() - start) * 1000.0;
+}
\ No newline at end of file
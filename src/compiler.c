@@ -1,9 +1,17 @@
 #include <RGSL/glsl/compile.h>
 #include <RGSL/rgsl/compile.h>
+#include <RGSL/rgsl/spirv.h>
 #include <RGSL/compile.h>
 #include <RGSL/fileio.h>
+#include <RGSL/parser.h>
 #include <RGSL/termio.h>
+#include <RGSL/clock.h>
+#include <RGSL/spec.h>
+#include <RGSL/text.h>
+#include <RGSL/cost.h>
 #include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <RGSL/thread.h>
 #include <string.h>
 #include <stdlib.h>
 
@@ -22,46 +30,237 @@ bool (* const rgsl_select_language_compiler(const char* language))(struct rgsl_s
     return NULL;
 }
 
-bool rgsl_compile_shader(struct rgsl_shader_data *shader, const char* output_file) {
-    bool success = true;
-    char * output = NULL;
-    rgsl_printf_info(1, "Shader language detected: %s\n", shader->language);
-    bool (*compiler_func)(struct rgsl_shader_data *, char**) = rgsl_select_language_compiler(shader->language);
-    size_t spv_size = 0;
-    if (compiler_func != NULL) {
-        success &= compiler_func(shader, &output);
-        if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
-            struct rgsl_glslang_result glslang_result = rgsl_glslang_compile_glsl(output, shader->stage);
-            rgsl_free_file_buffer(output);
-            output = NULL;
-            if (glslang_result.success) {
-                spv_size = glslang_result.word_count * sizeof(uint32_t);
-                output = (char *)malloc(spv_size);
-                memcpy(output, glslang_result.words, spv_size);
-            } else {
-                rgsl_printf_error("GLSL to SPIR-V compilation failed:\n%s\n", glslang_result.log);
-                success = false;
-            }
+// Number of recent SPIR-V results kept, variants of a shader are usually listed together.
+#define RGSL_SPIRV_CACHE_SIZE 16
+
+/**
+ * SPIR-V generated from one preprocessed source, reused by the identical variants
+ * left once macros are promoted to specialization constants. The key hashes the
+ * stage, the path of the shader when includes are native, and the code.
+ */
+struct rgsl_spirv_cache_entry {
+    struct rgsl_hash128 key;
+    char* words;
+    size_t size;
+    struct rgsl_hash128 interface_hash;
+};
+
+static struct rgsl_spirv_cache_entry spirv_cache[RGSL_SPIRV_CACHE_SIZE];
+static size_t spirv_cache_next;
+static rgsl_mutex spirv_cache_mutex;
+static bool spirv_cache_ready = false;
+
+static struct rgsl_hash128 rgsl_spirv_cache_key(const struct rgsl_shader_data* shader, const char* glsl_code) {
+    // Native includes are resolved from the directory of the shader, so it is part of the source.
+    struct rgsl_text source;
+    rgsl_text_init(&source);
+    rgsl_text_printf(&source, "%s\n%s\n", shader->stage, shader->native_includes ? shader->path : "");
+    rgsl_text_append(&source, glsl_code, strlen(glsl_code));
+    struct rgsl_hash128 key = rgsl_hash128_bytes(source.data, source.length);
+    rgsl_text_free(&source);
+    return key;
+}
+
+static bool rgsl_spirv_cache_find(struct rgsl_hash128 key, char** out_words, size_t* out_size, struct rgsl_hash128* out_interface_hash) {
+    // The entry is copied under the lock, another thread may replace it right after.
+    bool found = false;
+    rgsl_mutex_lock(&spirv_cache_mutex);
+    for (size_t i = 0; i < RGSL_SPIRV_CACHE_SIZE && !found; i++) {
+        const struct rgsl_spirv_cache_entry* entry = &spirv_cache[i];
+        if (entry->words != NULL && entry->key.low == key.low && entry->key.high == key.high) {
+            *out_words = (char *)rgsl_malloc(entry->size);
+            memcpy(*out_words, entry->words, entry->size);
+            *out_size = entry->size;
+            *out_interface_hash = entry->interface_hash;
+            found = true;
+        }
+    }
+    rgsl_mutex_unlock(&spirv_cache_mutex);
+    return found;
+}
+
+static void rgsl_spirv_cache_store(struct rgsl_hash128 key, const char* words, size_t size, struct rgsl_hash128 interface_hash) {
+    rgsl_mutex_lock(&spirv_cache_mutex);
+    struct rgsl_spirv_cache_entry* entry = &spirv_cache[spirv_cache_next];
+    spirv_cache_next = (spirv_cache_next + 1) % RGSL_SPIRV_CACHE_SIZE;
+    rgsl_free(entry->words);
+    entry->key = key;
+    entry->words = (char *)rgsl_malloc(size);
+    memcpy(entry->words, words, size);
+    entry->size = size;
+    entry->interface_hash = interface_hash;
+    rgsl_mutex_unlock(&spirv_cache_mutex);
+}
+
+void rgsl_compile_initialize() {
+    rgsl_mutex_init(&spirv_cache_mutex);
+    spirv_cache_ready = true;
+}
+
+void rgsl_compile_finalize() {
+    if (!spirv_cache_ready) {
+        return;
+    }
+    for (size_t i = 0; i < RGSL_SPIRV_CACHE_SIZE; i++) {
+        rgsl_free(spirv_cache[i].words);
+        spirv_cache[i].words = NULL;
+    }
+    spirv_cache_next = 0;
+    spirv_cache_ready = false;
+    rgsl_mutex_destroy(&spirv_cache_mutex);
+}
+
+void rgsl_hash_shader_interface(struct rgsl_shader_data* shader, const char* glsl_code) {
+    // Text output is not linked by compilation, the program is only built here if validation did not.
+    if (shader->program == NULL && glsl_code != NULL) {
+        char* log = NULL;
+        shader->program = rgsl_glslang_create_program(glsl_code, shader->path, shader->stage, shader->native_includes, rgsl_spec_constants_enabled(), &log);
+        rgsl_free(log);
+    }
+    char* description = (shader->program != NULL) ? rgsl_glslang_describe_interface(shader->program) : NULL;
+    if (description == NULL) {
+        rgsl_printf_info(1, "Could not reflect the interface of %s, its interface hash is left to zero.\n", shader->path);
+        return;
+    }
+    rgsl_printf_info(3, "Interface of %s:\n%s", shader->path, description);
+    shader->interface_hash = rgsl_hash128_bytes(description, strlen(description));
+    rgsl_free(description);
+}
+
+bool rgsl_validate_spirv(const struct rgsl_shader_data* shader, const char* words, size_t size, int vulkan_version) {
+    if (!rgsl_global_options.spirv_validate) {
+        return true;
+    }
+    char* messages = rgsl_glslang_validate_spirv((const uint32_t *)words, size / sizeof(uint32_t), vulkan_version);
+    if (messages != NULL) {
+        rgsl_printf_error("Invalid SPIR-V generated for %s:\n%s", shader->path, messages);
+        rgsl_free(messages);
+        return false;
+    }
+    rgsl_printf_info(2, "SPIR-V of %s is valid\n", shader->path);
+    return true;
+}
+
+bool rgsl_compile_spirv(struct rgsl_shader_data* shader, char* glsl_code, char** out_words, size_t* out_size) {
+    *out_words = NULL;
+    *out_size = 0;
+    // Only variants of promoted macros compile to identical code, the others skip the cache.
+    bool cached = spirv_cache_ready && rgsl_spec_constants_enabled();
+    struct rgsl_hash128 cache_key = {0};
+    if (cached) {
+        cache_key = rgsl_spirv_cache_key(shader, glsl_code);
+    }
+    char* words = NULL;
+    size_t size = 0;
+    if (cached && rgsl_spirv_cache_find(cache_key, &words, &size, &shader->interface_hash)) {
+        rgsl_printf_info(2, "Reusing the SPIR-V of an identical variant for %s\n", shader->path);
+        rgsl_free_file_buffer(glsl_code);
+    } else {
+        // Reuse the program linked during validation, if any.
+        char* log = NULL;
+        if (shader->program == NULL) {
+            shader->program = rgsl_glslang_create_program(glsl_code, shader->path, shader->stage, shader->native_includes, rgsl_spec_constants_enabled(), &log);
+        }
+        // The GLSL of GLSL shaders is their processed code, RGSL shaders report their errors themselves.
+        if (log != NULL && shader->path != NULL && strcmp(shader->language, "glsl") == 0) {
+            char* mapped = rgsl_line_map_rewrite_log(&shader->line_map, shader->path, log);
+            rgsl_free(log);
+            log = mapped;
+        }
+        rgsl_free_file_buffer(glsl_code);
+        if (shader->program == NULL) {
+            rgsl_printf_error("GLSL to SPIR-V compilation failed:\n%s\n", log);
+            rgsl_free(log);
+            return false;
+        }
+        rgsl_free(log);
+        double start = rgsl_clock_seconds();
+        struct rgsl_glslang_result glslang_result = rgsl_glslang_generate_spirv(shader->program);
+        rgsl_printf_info(2, "Generated SPIR-V in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+        if (!glslang_result.success) {
+            rgsl_printf_error("GLSL to SPIR-V compilation failed:\n%s\n", glslang_result.log);
             rgsl_glslang_free_result(&glslang_result);
+            return false;
         }
-        if (success) {
-            if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
-                rgsl_free_file_buffer(shader->code);
-                shader->code = output;
-                shader->word_count = spv_size / sizeof(uint32_t);
-            } else {
-                if (rgsl_write_file(output_file, output, spv_size)) {
-                    rgsl_printf_info(1, "Compiled shader written to %s\n", output_file);
-                } else {
-                    rgsl_printf_error("Failed to open output file: %s\n", output_file);
-                    success = false;
-                }
-                rgsl_free_file_buffer(output);
-            }
+        size = glslang_result.word_count * sizeof(uint32_t);
+        words = (char *)rgsl_malloc(size);
+        memcpy(words, glslang_result.words, size);
+        rgsl_glslang_free_result(&glslang_result);
+        if (!rgsl_validate_spirv(shader, words, size, 0)) {
+            rgsl_free(words);
+            return false;
         }
-    } else {
+        if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
+            rgsl_hash_shader_interface(shader, NULL);
+        }
+        if (cached) {
+            rgsl_spirv_cache_store(cache_key, words, size, shader->interface_hash);
+        }
+    }
+    if (rgsl_cost_report_enabled()) {
+        rgsl_cost_report_add(shader->path, (const uint32_t*)words, size / sizeof(uint32_t));
+    }
+    *out_words = words;
+    *out_size = size;
+    return true;
+}
+
+bool rgsl_compile_module_spirv(struct rgsl_shader_data* shader, char** out_words, size_t* out_size) {
+    *out_words = NULL;
+    *out_size = 0;
+    double start = rgsl_clock_seconds();
+    uint32_t* words = NULL;
+    size_t word_count = 0;
+    if (!rgsl_spirv_emit(shader->module, &words, &word_count)) {
+        rgsl_printf_error("RGSL to SPIR-V compilation failed for %s\n", shader->path);
+        return false;
+    }
+    rgsl_printf_info(2, "Emitted SPIR-V from the RGSL syntax tree in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+    size_t size = word_count * sizeof(uint32_t);
+    if (!rgsl_validate_spirv(shader, (const char *)words, size, 0)) {
+        rgsl_free(words);
+        return false;
+    }
+    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
+        char* description = rgsl_spirv_describe_interface(shader->module);
+        rgsl_printf_info(3, "Interface of %s:\n%s", shader->path, description);
+        shader->interface_hash = rgsl_hash128_bytes(description, strlen(description));
+        rgsl_free(description);
+    }
+    if (rgsl_cost_report_enabled()) {
+        rgsl_cost_report_add(shader->path, words, word_count);
+    }
+    *out_words = (char *)words;
+    *out_size = size;
+    return true;
+}
+
+bool rgsl_compile_shader(struct rgsl_shader_data *shader, char** out_output, size_t* out_size) {
+    char * output = NULL;
+    size_t spv_size = 0;
+    *out_output = NULL;
+    *out_size = 0;
+    rgsl_printf_info(1, "Shader language detected: %s\n", shader->language);
+    bool (*compiler_func)(struct rgsl_shader_data *, char**) = rgsl_select_language_compiler(shader->language);
+    if (compiler_func == NULL) {
         rgsl_printf_error("No compiler found for language: %s\n", shader->language);
         return false;
     }
+    // RGSL shaders go to SPIR-V without GLSL, unless --glslang-spirv asks for glslang.
+    bool native_spirv = (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) && !rgsl_global_options.glslang_spirv && compiler_func == &rgsl_rgsl_compile_shader;
+    bool success = native_spirv ? rgsl_rgsl_compile_spirv(shader, &output, &spv_size) : compiler_func(shader, &output);
+    if (success && !native_spirv && (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV)) {
+        char* glsl_code = output;
+        success = rgsl_compile_spirv(shader, glsl_code, &output, &spv_size);
+    } else if (success && (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED)) {
+        rgsl_hash_shader_interface(shader, output);
+    }
+    rgsl_release_shader_intermediates(shader);
+    if (success) {
+        *out_output = output;
+        *out_size = spv_size;
+    } else {
+        rgsl_free_file_buffer(output);
+    }
     return success;
 }
\ No newline at end of file
@@ -0,0 +1,552 @@
+#include <RGSL/cost.h>
+#include <RGSL/termio.h>
+#include <RGSL/fileio.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stddef.h>
+
+#define RGSL_SPIRV_MAGIC 0x07230203u
+#define RGSL_SPIRV_HEADER_WORDS 5
+
+enum rgsl_spirv_opcode {
+    RGSL_OP_EXT_INST = 12,
+    RGSL_OP_TYPE_IMAGE = 25,
+    RGSL_OP_TYPE_SAMPLER = 26,
+    RGSL_OP_TYPE_SAMPLED_IMAGE = 27,
+    RGSL_OP_TYPE_ARRAY = 28,
+    RGSL_OP_TYPE_RUNTIME_ARRAY = 29,
+    RGSL_OP_TYPE_STRUCT = 30,
+    RGSL_OP_TYPE_POINTER = 32,
+    RGSL_OP_FUNCTION = 54,
+    RGSL_OP_FUNCTION_PARAMETER = 55,
+    RGSL_OP_FUNCTION_END = 56,
+    RGSL_OP_VARIABLE = 59,
+    RGSL_OP_DECORATE = 71,
+    RGSL_OP_MEMBER_DECORATE = 72,
+    RGSL_OP_LOOP_MERGE = 246,
+    RGSL_OP_SELECTION_MERGE = 247,
+    RGSL_OP_LABEL = 248,
+    RGSL_OP_LINE = 8,
+    RGSL_OP_NO_LINE = 317
+};
+
+enum rgsl_spirv_storage_class {
+    RGSL_STORAGE_UNIFORM_CONSTANT = 0,
+    RGSL_STORAGE_INPUT = 1,
+    RGSL_STORAGE_UNIFORM = 2,
+    RGSL_STORAGE_OUTPUT = 3,
+    RGSL_STORAGE_PUSH_CONSTANT = 9,
+    RGSL_STORAGE_STORAGE_BUFFER = 12
+};
+
+enum rgsl_spirv_decoration {
+    RGSL_DECORATION_BUFFER_BLOCK = 3,
+    RGSL_DECORATION_BUILT_IN = 11
+};
+
+enum rgsl_cost_class {
+    RGSL_COST_OTHER,
+    RGSL_COST_ALU,
+    RGSL_COST_TEXTURE,
+    RGSL_COST_BRANCH,
+    RGSL_COST_DISCARD,
+    RGSL_COST_DERIVATIVE
+};
+
+/**
+ * Range of opcodes sharing a cost class.
+ */
+struct rgsl_opcode_class {
+    uint32_t first;
+    uint32_t last;
+    enum rgsl_cost_class cost_class;
+};
+
+static const struct rgsl_opcode_class OPCODE_CLASSES[] = {
+    {12, 12, RGSL_COST_ALU},            // OpExtInst
+    {87, 99, RGSL_COST_TEXTURE},        // OpImageSample* to OpImageWrite
+    {109, 124, RGSL_COST_ALU},          // Conversions
+    {126, 152, RGSL_COST_ALU},          // Arithmetic
+    {154, 205, RGSL_COST_ALU},          // Relational, logical and bit operations
+    {207, 215, RGSL_COST_DERIVATIVE},   // OpDPdx to OpFwidthCoarse
+    {250, 251, RGSL_COST_BRANCH},       // OpBranchConditional, OpSwitch
+    {252, 252, RGSL_COST_DISCARD},      // OpKill
+    {305, 315, RGSL_COST_TEXTURE},      // OpImageSparse*
+    {4416, 4416, RGSL_COST_DISCARD},    // OpTerminateInvocation
+    {5380, 5380, RGSL_COST_DISCARD}     // OpDemoteToHelperInvocationEXT
+};
+
+// Instructions of function bodies without a result id.
+static const uint32_t NO_RESULT_OPCODES[] = {
+    0, 8, 56, 62, 63, 64, 99, 218, 219, 224, 225, 228, 246, 247, 249, 250, 251, 252, 253, 254, 255, 256, 257, 317, 4416, 5380
+};
+
+/**
+ * Column of the report, also naming the JSON field.
+ */
+struct rgsl_cost_field {
+    const char* name;
+    const char* header;
+    size_t offset;
+};
+
+static const struct rgsl_cost_field COST_FIELDS[] = {
+    {"instructions", "Instr", offsetof(struct rgsl_shader_cost, instructions)},
+    {"alu", "ALU", offsetof(struct rgsl_shader_cost, alu)},
+    {"texture", "Tex", offsetof(struct rgsl_shader_cost, texture)},
+    {"branches", "Branch", offsetof(struct rgsl_shader_cost, branches)},
+    {"discards", "Kill", offsetof(struct rgsl_shader_cost, discards)},
+    {"derivatives", "Deriv", offsetof(struct rgsl_shader_cost, derivatives)},
+    {"loop_depth", "Loops", offsetof(struct rgsl_shader_cost, loop_depth)},
+    {"live_values", "Live", offsetof(struct rgsl_shader_cost, live_values)},
+    {"inputs", "In", offsetof(struct rgsl_shader_cost, inputs)},
+    {"outputs", "Out", offsetof(struct rgsl_shader_cost, outputs)},
+    {"uniform_blocks", "UBO", offsetof(struct rgsl_shader_cost, uniform_blocks)},
+    {"storage_blocks", "SSBO", offsetof(struct rgsl_shader_cost, storage_blocks)},
+    {"samplers", "Smp", offsetof(struct rgsl_shader_cost, samplers)},
+    {"uniforms", "Unif", offsetof(struct rgsl_shader_cost, uniforms)},
+    {"push_constants", "Push", offsetof(struct rgsl_shader_cost, push_constants)}
+};
+
+#define RGSL_COST_FIELD_COUNT (sizeof(COST_FIELDS) / sizeof(COST_FIELDS[0]))
+
+/**
+ * Per-id facts collected while walking a module.
+ */
+struct rgsl_spirv_id {
+    uint32_t opcode;
+    uint32_t storage;
+    uint32_t target;
+    size_t definition;
+    size_t last_use;
+    bool buffer_block;
+    bool built_in;
+    bool local;
+};
+
+/**
+ * Cost of one shader of the report.
+ */
+struct rgsl_cost_entry {
+    char* name;
+    struct rgsl_shader_cost cost;
+};
+
+static struct rgsl_cost_entry* cost_entries;
+static size_t cost_entry_count;
+static size_t cost_entry_capacity;
+
+static size_t* rgsl_cost_field(struct rgsl_shader_cost* cost, size_t field) {
+    return (size_t*)((char*)cost + COST_FIELDS[field].offset);
+}
+
+static enum rgsl_cost_class rgsl_classify_opcode(uint32_t opcode) {
+    size_t num_classes = sizeof(OPCODE_CLASSES) / sizeof(OPCODE_CLASSES[0]);
+    for (size_t i = 0; i < num_classes; i++) {
+        if (opcode >= OPCODE_CLASSES[i].first && opcode <= OPCODE_CLASSES[i].last) {
+            return OPCODE_CLASSES[i].cost_class;
+        }
+    }
+    return RGSL_COST_OTHER;
+}
+
+static bool rgsl_opcode_has_result(uint32_t opcode) {
+    size_t num_opcodes = sizeof(NO_RESULT_OPCODES) / sizeof(NO_RESULT_OPCODES[0]);
+    for (size_t i = 0; i < num_opcodes; i++) {
+        if (NO_RESULT_OPCODES[i] == opcode) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static size_t rgsl_max_live_values(const struct rgsl_spirv_id* ids, const uint32_t* values, size_t value_count, size_t start, size_t end) {
+    // Each value lives from its definition to its last use, count the overlaps with a sweep.
+    size_t length = end - start + 1;
+    long* deltas = (long*)rgsl_calloc(length + 1, sizeof(long));
+    for (size_t i = 0; i < value_count; i++) {
+        const struct rgsl_spirv_id* id = &ids[values[i]];
+        if (id->last_use > id->definition) {
+            deltas[id->definition - start]++;
+            deltas[id->last_use - start]--;
+        }
+    }
+    long live = 0;
+    long max_live = 0;
+    for (size_t i = 0; i < length; i++) {
+        live += deltas[i];
+        if (live > max_live) {
+            max_live = live;
+        }
+    }
+    rgsl_free(deltas);
+    return (size_t)max_live;
+}
+
+static void rgsl_count_variable(const struct rgsl_spirv_id* ids, uint32_t bound, uint32_t pointer_type, uint32_t variable, uint32_t storage, struct rgsl_shader_cost* cost) {
+    uint32_t type = (pointer_type < bound) ? ids[pointer_type].target : 0;
+    while (type != 0 && type < bound && (ids[type].opcode == RGSL_OP_TYPE_ARRAY || ids[type].opcode == RGSL_OP_TYPE_RUNTIME_ARRAY)) {
+        type = ids[type].target;
+    }
+    bool built_in = ids[variable].built_in || (type < bound && ids[type].built_in);
+    uint32_t type_opcode = (type < bound) ? ids[type].opcode : 0;
+    bool buffer_block = type < bound && ids[type].buffer_block;
+    switch (storage) {
+        case RGSL_STORAGE_INPUT:
+            cost->inputs += built_in ? 0 : 1;
+            break;
+        case RGSL_STORAGE_OUTPUT:
+            cost->outputs += built_in ? 0 : 1;
+            break;
+        case RGSL_STORAGE_UNIFORM:
+            if (buffer_block) {
+                cost->storage_blocks++;
+            } else {
+                cost->uniform_blocks++;
+            }
+            break;
+        case RGSL_STORAGE_STORAGE_BUFFER:
+            cost->storage_blocks++;
+            break;
+        case RGSL_STORAGE_PUSH_CONSTANT:
+            cost->push_constants++;
+            break;
+        case RGSL_STORAGE_UNIFORM_CONSTANT:
+            if (type_opcode == RGSL_OP_TYPE_IMAGE || type_opcode == RGSL_OP_TYPE_SAMPLER || type_opcode == RGSL_OP_TYPE_SAMPLED_IMAGE) {
+                cost->samplers++;
+            } else {
+                cost->uniforms++;
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+bool rgsl_analyze_spirv(const uint32_t* words, size_t word_count, struct rgsl_shader_cost* out_cost) {
+    memset(out_cost, 0, sizeof(struct rgsl_shader_cost));
+    if (word_count < RGSL_SPIRV_HEADER_WORDS || words[0] != RGSL_SPIRV_MAGIC) {
+        return false;
+    }
+    uint32_t bound = words[3];
+    struct rgsl_spirv_id* ids = (struct rgsl_spirv_id*)rgsl_calloc(bound + 1, sizeof(struct rgsl_spirv_id));
+    uint32_t* values = (uint32_t*)rgsl_malloc((bound + 1) * sizeof(uint32_t));
+    uint32_t* loops = (uint32_t*)rgsl_malloc((bound + 1) * sizeof(uint32_t));
+    size_t value_count = 0;
+    size_t loop_depth = 0;
+    size_t function_start = 0;
+    bool in_function = false;
+    bool valid = true;
+
+    size_t position = 0;
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < word_count; position++) {
+        const uint32_t* instruction = words + offset;
+        uint32_t opcode = instruction[0] & 0xFFFFu;
+        uint32_t length = instruction[0] >> 16;
+        if (length == 0 || offset + length > word_count) {
+            valid = false;
+            break;
+        }
+        offset += length;
+
+        if (!in_function) {
+            // Module-level declarations only feed the interface and resource counts.
+            if ((opcode == RGSL_OP_DECORATE || opcode == RGSL_OP_MEMBER_DECORATE) && length >= 3) {
+                uint32_t target = instruction[1];
+                uint32_t decoration = instruction[(opcode == RGSL_OP_DECORATE) ? 2 : 3];
+                if (target < bound && (opcode == RGSL_OP_DECORATE || length >= 4)) {
+                    ids[target].buffer_block |= (decoration == RGSL_DECORATION_BUFFER_BLOCK);
+                    ids[target].built_in |= (decoration == RGSL_DECORATION_BUILT_IN);
+                }
+            } else if (opcode == RGSL_OP_TYPE_POINTER && length >= 4 && instruction[1] < bound) {
+                ids[instruction[1]].opcode = opcode;
+                ids[instruction[1]].storage = instruction[2];
+                ids[instruction[1]].target = instruction[3];
+            } else if ((opcode == RGSL_OP_TYPE_ARRAY || opcode == RGSL_OP_TYPE_RUNTIME_ARRAY) && length >= 3 && instruction[1] < bound) {
+                ids[instruction[1]].opcode = opcode;
+                ids[instruction[1]].target = instruction[2];
+            } else if (opcode >= RGSL_OP_TYPE_IMAGE && opcode <= RGSL_OP_TYPE_STRUCT && length >= 2 && instruction[1] < bound) {
+                ids[instruction[1]].opcode = opcode;
+            } else if (opcode == RGSL_OP_VARIABLE && length >= 4 && instruction[2] < bound) {
+                rgsl_count_variable(ids, bound, instruction[1], instruction[2], instruction[3], out_cost);
+            } else if (opcode == RGSL_OP_FUNCTION) {
+                in_function = true;
+                function_start = position;
+                value_count = 0;
+                loop_depth = 0;
+            }
+            continue;
+        }
+
+        if (opcode == RGSL_OP_FUNCTION_END) {
+            size_t live = rgsl_max_live_values(ids, values, value_count, function_start, position);
+            if (live > out_cost->live_values) {
+                out_cost->live_values = live;
+            }
+            for (size_t i = 0; i < value_count; i++) {
+                ids[values[i]].local = false;
+            }
+            in_function = false;
+            continue;
+        }
+        if (opcode == RGSL_OP_LABEL && length >= 2) {
+            // Blocks are laid out in structured order, a loop ends at its merge block.
+            if (loop_depth > 0 && loops[loop_depth - 1] == instruction[1]) {
+                loop_depth--;
+            }
+            continue;
+        }
+        if (opcode == RGSL_OP_LOOP_MERGE && length >= 2) {
+            if (loop_depth <= bound) {
+                loops[loop_depth++] = instruction[1];
+            }
+            if (loop_depth > out_cost->loop_depth) {
+                out_cost->loop_depth = loop_depth;
+            }
+            continue;
+        }
+        if (opcode == RGSL_OP_SELECTION_MERGE || opcode == RGSL_OP_LINE || opcode == RGSL_OP_NO_LINE) {
+            continue;
+        }
+
+        if (opcode != RGSL_OP_FUNCTION_PARAMETER) {
+            out_cost->instructions++;
+            switch (rgsl_classify_opcode(opcode)) {
+                case RGSL_COST_ALU: out_cost->alu++; break;
+                case RGSL_COST_TEXTURE: out_cost->texture++; break;
+                case RGSL_COST_BRANCH: out_cost->branches++; break;
+                case RGSL_COST_DISCARD: out_cost->discards++; break;
+                case RGSL_COST_DERIVATIVE: out_cost->derivatives++; break;
+                default: break;
+            }
+        }
+
+        // Any operand naming a value of the function is taken as a use of it.
+        bool has_result = rgsl_opcode_has_result(opcode) && length >= 3;
+        for (uint32_t i = 1; i < length; i++) {
+            uint32_t operand = instruction[i];
+            if ((!has_result || i != 2) && operand < bound && ids[operand].local) {
+                ids[operand].last_use = position;
+            }
+        }
+        if (has_result && opcode != RGSL_OP_VARIABLE && instruction[2] < bound && !ids[instruction[2]].local) {
+            struct rgsl_spirv_id* id = &ids[instruction[2]];
+            id->local = true;
+            id->definition = position;
+            id->last_use = position;
+            values[value_count++] = instruction[2];
+        }
+    }
+
+    rgsl_free(loops);
+    rgsl_free(values);
+    rgsl_free(ids);
+    return valid && !in_function;
+}
+
+bool rgsl_cost_report_enabled() {
+    return rgsl_global_options.cost_report != NULL || rgsl_global_options.cost_baseline != NULL;
+}
+
+void rgsl_cost_report_add(const char* name, const uint32_t* words, size_t word_count) {
+    struct rgsl_shader_cost cost;
+    if (!rgsl_analyze_spirv(words, word_count, &cost)) {
+        rgsl_printf_error("Could not analyze the SPIR-V of %s for the cost report\n", name);
+        return;
+    }
+    size_t occurrences = 1;
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        size_t name_length = strlen(name);
+        if (strncmp(cost_entries[i].name, name, name_length) == 0 && (cost_entries[i].name[name_length] == '\0' || cost_entries[i].name[name_length] == '#')) {
+            occurrences++;
+        }
+    }
+    if (cost_entry_count == cost_entry_capacity) {
+        cost_entry_capacity = cost_entry_capacity ? cost_entry_capacity * 2 : 16;
+        cost_entries = (struct rgsl_cost_entry*)rgsl_realloc(cost_entries, cost_entry_capacity * sizeof(struct rgsl_cost_entry));
+    }
+    struct rgsl_cost_entry* entry = &cost_entries[cost_entry_count++];
+    size_t length = strlen(name) + 24;
+    entry->name = (char*)rgsl_malloc(length);
+    if (occurrences > 1) {
+        snprintf(entry->name, length, "%s#%zu", name, occurrences);
+    } else {
+        snprintf(entry->name, length, "%s", name);
+    }
+    entry->cost = cost;
+}
+
+static void rgsl_print_cost_table() {
+    int name_width = 6;
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        int length = (int)strlen(cost_entries[i].name);
+        name_width = (length > name_width) ? length : name_width;
+    }
+    printf("%-*s", name_width, "Shader");
+    for (size_t field = 0; field < RGSL_COST_FIELD_COUNT; field++) {
+        printf(" %6s", COST_FIELDS[field].header);
+    }
+    printf("\n");
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        printf("%-*s", name_width, cost_entries[i].name);
+        for (size_t field = 0; field < RGSL_COST_FIELD_COUNT; field++) {
+            printf(" %6zu", *rgsl_cost_field(&cost_entries[i].cost, field));
+        }
+        printf("\n");
+    }
+    fflush(stdout);
+}
+
+static void rgsl_write_json_string(struct rgsl_text* output, const char* str) {
+    rgsl_text_append(output, "\"", 1);
+    for (const char* c = str; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            rgsl_text_append(output, "\\", 1);
+        }
+        rgsl_text_append(output, c, 1);
+    }
+    rgsl_text_append(output, "\"", 1);
+}
+
+static bool rgsl_write_cost_json(const char* path) {
+    struct rgsl_text output;
+    rgsl_text_init(&output);
+    rgsl_text_printf(&output, "{\n  \"shaders\": [\n");
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        rgsl_text_printf(&output, "    {\"name\": ");
+        rgsl_write_json_string(&output, cost_entries[i].name);
+        for (size_t field = 0; field < RGSL_COST_FIELD_COUNT; field++) {
+            rgsl_text_printf(&output, ", \"%s\": %zu", COST_FIELDS[field].name, *rgsl_cost_field(&cost_entries[i].cost, field));
+        }
+        rgsl_text_printf(&output, "}%s\n", (i + 1 < cost_entry_count) ? "," : "");
+    }
+    rgsl_text_printf(&output, "  ]\n}\n");
+    bool success = rgsl_write_file(path, output.data, output.length);
+    rgsl_text_free(&output);
+    if (!success) {
+        rgsl_printf_error("Failed to write cost report: %s\n", path);
+    }
+    return success;
+}
+
+static const char* rgsl_skip_json_space(const char* c) {
+    while (*c == ' ' || *c == '\t' || *c == '\n' || *c == '\r' || *c == ',' || *c == ':') {
+        c++;
+    }
+    return c;
+}
+
+static const char* rgsl_read_json_string(const char* c, struct rgsl_text* out) {
+    // c is past the opening quote.
+    rgsl_text_clear(out);
+    for (; *c != '\0' && *c != '"'; c++) {
+        if (*c == '\\' && c[1] != '\0') {
+            c++;
+        }
+        rgsl_text_append(out, c, 1);
+    }
+    rgsl_text_append(out, "", 0);
+    return (*c == '"') ? c + 1 : c;
+}
+
+static const char* rgsl_read_baseline_entry(const char* c, struct rgsl_text* name, struct rgsl_shader_cost* cost) {
+    // Reads one flat object of the format written by rgsl_write_cost_json, c is past its '{'.
+    struct rgsl_text key;
+    rgsl_text_init(&key);
+    memset(cost, 0, sizeof(struct rgsl_shader_cost));
+    rgsl_text_clear(name);
+    for (c = rgsl_skip_json_space(c); *c == '"'; c = rgsl_skip_json_space(c)) {
+        c = rgsl_read_json_string(c + 1, &key);
+        c = rgsl_skip_json_space(c);
+        if (*c == '"') {
+            c = rgsl_read_json_string(c + 1, name);
+            continue;
+        }
+        char* end;
+        unsigned long long value = strtoull(c, &end, 10);
+        for (size_t field = 0; field < RGSL_COST_FIELD_COUNT && key.data != NULL; field++) {
+            if (strcmp(key.data, COST_FIELDS[field].name) == 0) {
+                *rgsl_cost_field(cost, field) = (size_t)value;
+            }
+        }
+        c = (end != c) ? end : c + 1;
+    }
+    rgsl_text_free(&key);
+    return (*c == '}') ? c + 1 : c;
+}
+
+static size_t rgsl_compare_cost(const char* name, struct rgsl_shader_cost* baseline, struct rgsl_shader_cost* cost) {
+    size_t regressions = 0;
+    for (size_t field = 0; field < RGSL_COST_FIELD_COUNT; field++) {
+        size_t before = *rgsl_cost_field(baseline, field);
+        size_t after = *rgsl_cost_field(cost, field);
+        // A count appearing from zero is always notable, as is a growth over the threshold.
+        if (after > before && (before == 0 || (after - before) * 100 > before * (size_t)rgsl_global_options.cost_threshold)) {
+            rgsl_printf_error("%s: %s grew from %zu to %zu\n", name, COST_FIELDS[field].name, before, after);
+            regressions++;
+        }
+    }
+    return regressions;
+}
+
+static bool rgsl_compare_cost_baseline(const char* path) {
+    char* content = NULL;
+    rgsl_read_file(path, &content);
+    if (content == NULL) {
+        rgsl_printf_error("Failed to read cost baseline: %s\n", path);
+        return false;
+    }
+    bool* matched = (bool*)rgsl_calloc(cost_entry_count + 1, sizeof(bool));
+    struct rgsl_text name;
+    rgsl_text_init(&name);
+    size_t regressions = 0;
+    const char* array = strchr(content, '[');
+    for (const char* c = array ? array + 1 : content; (c = strchr(c, '{')) != NULL;) {
+        struct rgsl_shader_cost baseline;
+        c = rgsl_read_baseline_entry(c + 1, &name, &baseline);
+        for (size_t i = 0; i < cost_entry_count && name.data != NULL; i++) {
+            if (!matched[i] && strcmp(cost_entries[i].name, name.data) == 0) {
+                matched[i] = true;
+                regressions += rgsl_compare_cost(cost_entries[i].name, &baseline, &cost_entries[i].cost);
+                break;
+            }
+        }
+    }
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        if (!matched[i]) {
+            rgsl_printf_info(1, "%s is not in the cost baseline\n", cost_entries[i].name);
+        }
+    }
+    rgsl_text_free(&name);
+    rgsl_free(matched);
+    rgsl_free_file_buffer(content);
+    if (regressions > 0) {
+        rgsl_printf_error("%zu cost regressions over %d%% against %s\n", regressions, rgsl_global_options.cost_threshold, path);
+    }
+    return regressions == 0;
+}
+
+bool rgsl_cost_report_finalize() {
+    bool success = true;
+    if (rgsl_cost_report_enabled() && cost_entry_count > 0) {
+        rgsl_print_cost_table();
+        if (rgsl_global_options.cost_report != NULL) {
+            success &= rgsl_write_cost_json(rgsl_global_options.cost_report);
+        }
+        if (rgsl_global_options.cost_baseline != NULL) {
+            success &= rgsl_compare_cost_baseline(rgsl_global_options.cost_baseline);
+        }
+    }
+    for (size_t i = 0; i < cost_entry_count; i++) {
+        rgsl_free(cost_entries[i].name);
+    }
+    rgsl_free(cost_entries);
+    cost_entries = NULL;
+    cost_entry_count = 0;
+    cost_entry_capacity = 0;
+    return success;
+}
\ No newline at end of file
@@ -0,0 +1,502 @@
+#include <RGSL/driver.h>
+#include <RGSL/validator.h>
+#include <RGSL/compile.h>
+#include <RGSL/packager.h>
+#include <RGSL/usage.h>
+#include <RGSL/lint.h>
+#include <RGSL/target.h>
+#include <RGSL/program.h>
+#include <RGSL/link.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/termio.h>
+#include <RGSL/fileio.h>
+#include <RGSL/thread.h>
+#include <RGSL/clock.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+// Number of shaders read ahead of, and waiting to be written behind, the compiled one.
+#define RGSL_PIPELINE_DEPTH 8
+
+/**
+ * One job moving through the reader, compile and writer stages.
+ * Each stage only touches the item between popping and pushing it.
+ * 
+ * The job of a program file (see program.h) gets one item per stage, each with
+ * its own output file "<output>.<stage>", which are written and packaged together.
+ * With --program-module, the stages share one module written to "<output>".
+ */
+struct rgsl_pipeline_item {
+    const struct rgsl_job* job;
+    char* raw_code;
+    char* output;
+    size_t output_size;
+    const char* output_file;
+    struct rgsl_shader_data shader;
+    struct rgsl_pipeline_item* stages;
+    size_t stage_count;
+    char* stage_output_file;
+    bool success;
+};
+
+/**
+ * Queues joining the stages, and the items of every job.
+ */
+struct rgsl_pipeline {
+    struct rgsl_pipeline_item* items;
+    size_t count;
+    struct rgsl_queue read_queue;
+    struct rgsl_queue write_queue;
+    struct rgsl_packager* packager;
+};
+
+static bool rgsl_read_job_file(struct rgsl_pipeline_item* item) {
+    const char* shader_file = item->job->input_file;
+    rgsl_printf_info(3, "Input file: %s\n", shader_file);
+    if (!rgsl_file_exists(shader_file)) {
+        rgsl_printf_error("Input file does not exist: %s\n", shader_file);
+        return false;
+    }
+    rgsl_read_file(shader_file, &item->raw_code);
+    if (item->raw_code == NULL) {
+        rgsl_printf_error("Failed to read shader file: %s\n", shader_file);
+        return false;
+    }
+    return true;
+}
+
+static bool rgsl_read_job(struct rgsl_pipeline_item* item) {
+    rgsl_log_begin_shader(item->job->input_file);
+    rgsl_memory_begin_shader(item->job->input_file);
+    enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_READ);
+    bool success = rgsl_read_job_file(item);
+    rgsl_memory_leave_phase(phase);
+    rgsl_memory_end_shader();
+    rgsl_log_end_shader();
+    return success;
+}
+
+static bool rgsl_load_job_shader(const struct rgsl_job* job, const char* raw_shader_code, struct rgsl_shader_data* shader) {
+    const char* shader_file = job->input_file;
+    shader->name = rgsl_determine_shader_name(shader_file);
+    shader->path = shader_file;
+    shader->code = rgsl_crlf_to_lf(raw_shader_code);
+    shader->language = rgsl_determine_shader_language(shader_file);
+    shader->defines = job->defines;
+
+    const char* stage = job->stage ? job->stage : rgsl_global_options.stage;
+    shader->stage = stage ? stage : rgsl_determine_shader_stage(shader_file);
+    const char* profile = job->profile ? job->profile : rgsl_global_options.profile;
+    if (shader->name == NULL) {
+        rgsl_printf_error("Could not determine shader name from file: %s\n", shader_file);
+        return false;
+    }
+    if (shader->code == NULL) {
+        rgsl_printf_error("Failed to read shader file: %s\n", shader_file);
+        return false;
+    }
+    if (shader->language == NULL) {
+        rgsl_printf_error("Could not determine shader language from file extension: %s\n", shader_file);
+        return false;
+    }
+    if (shader->stage == NULL && !rgsl_is_program_code(shader->code)) {
+        rgsl_printf_error("Could not determine shader stage from file extension: %s\n", shader_file);
+        return false;
+    }
+    if (profile != NULL && !rgsl_parse_profile(profile, &shader->requested_profile)) {
+        rgsl_printf_error("Invalid shader profile: %s\n", profile);
+        return false;
+    }
+    return true;
+}
+
+// Runs the requested actions on a loaded shader, item->output_file is where it compiles to.
+static bool rgsl_compile_loaded_shader(struct rgsl_pipeline_item* item) {
+    struct rgsl_shader_data* shader = &item->shader;
+    const char* shader_file = item->job->input_file;
+    bool success = true;
+    if (rgsl_perf_lint_enabled()) {
+        // The program built for the lint is kept for the actions below.
+        rgsl_perf_lint_shader(shader);
+    }
+    if (rgsl_global_options.action & RGSL_ACTION_VALIDATE) {
+        success = rgsl_validate_shader(shader);
+        if (success) {
+            rgsl_printf_info(1, "Shader %s is valid.\n", shader_file);
+        } else {
+            rgsl_printf_error("Shader %s is invalid.\n", shader_file);
+        }
+    }
+    if (success && (rgsl_global_options.action & RGSL_ACTION_COMPILE || rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV)) {
+        if (!item->output_file) {
+            rgsl_printf_error("Output file must be specified for compilation of %s using --output\n", shader_file);
+            success = false;
+        } else if (rgsl_targets_enabled()) {
+            rgsl_printf_info(1, "Compiling shader %s to %zu targets...\n", shader_file, rgsl_target_count());
+            success = rgsl_compile_targets(shader);
+        } else {
+            rgsl_printf_info(1, "Compiling shader %s to %s...\n", shader_file, item->output_file);
+            success = rgsl_compile_shader(shader, &item->output, &item->output_size);
+        }
+    }
+    if (success && item->output != NULL && (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED)) {
+        // Embedded shaders are handed to the packager instead of being written.
+        rgsl_free_file_buffer(shader->code);
+        shader->code = item->output;
+        shader->word_count = item->output_size / sizeof(uint32_t);
+        item->output = NULL;
+        if (rgsl_shared_chunks_enabled()) {
+            // Cut while the line map of the preprocessed code is still there.
+            rgsl_find_shader_chunks(shader);
+        }
+    }
+
+    rgsl_release_shader_intermediates(shader);
+    if (!success) {
+        rgsl_release_shader(shader);
+    }
+    return success;
+}
+
+// Replaces the SPIR-V of the stages of a program by one module with an entry point per stage.
+static void rgsl_link_program(struct rgsl_pipeline_item* item) {
+    const char* path = item->job->input_file;
+    bool embedded = (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) != 0;
+    const uint32_t** modules = (const uint32_t**)rgsl_malloc(item->stage_count * sizeof(const uint32_t*));
+    size_t* word_counts = (size_t *)rgsl_malloc(item->stage_count * sizeof(size_t));
+    size_t total = 0;
+    for (size_t i = 0; i < item->stage_count; i++) {
+        const struct rgsl_pipeline_item* stage = &item->stages[i];
+        modules[i] = (const uint32_t*)(embedded ? stage->shader.code : stage->output);
+        word_counts[i] = embedded ? stage->shader.word_count : stage->output_size / sizeof(uint32_t);
+        total += word_counts[i];
+    }
+    uint32_t* words;
+    size_t word_count;
+    bool linked = rgsl_link_spirv_modules(modules, word_counts, item->stage_count, &words, &word_count);
+    rgsl_free(modules);
+    rgsl_free(word_counts);
+    if (!linked) {
+        rgsl_printf_info(1, "The stages of %s are left in their own modules\n", path);
+        return;
+    }
+    // Always validated, a linking error must not reach the engine.
+    char* messages = rgsl_glslang_validate_spirv(words, word_count, 0);
+    if (messages != NULL) {
+        rgsl_printf_warning("The module linked from the stages of %s is invalid, they are left in their own modules:\n%s", path, messages);
+        rgsl_free(messages);
+        rgsl_free(words);
+        return;
+    }
+    rgsl_printf_info(1, "Linked the %zu stages of %s into one module of %zu words, instead of %zu\n", item->stage_count, path, word_count, total);
+
+    size_t size = word_count * sizeof(uint32_t);
+    for (size_t i = 0; i < item->stage_count; i++) {
+        struct rgsl_pipeline_item* stage = &item->stages[i];
+        // Embedded stages share the blob of the module, written ones the first output.
+        char* copy = NULL;
+        if (embedded || i == 0) {
+            copy = (char *)rgsl_malloc(size);
+            memcpy(copy, words, size);
+        }
+        if (embedded) {
+            rgsl_free_file_buffer(stage->shader.code);
+            stage->shader.code = copy;
+            stage->shader.word_count = word_count;
+        } else {
+            rgsl_free_file_buffer(stage->output);
+            stage->output = copy;
+            stage->output_size = (copy != NULL) ? size : 0;
+        }
+    }
+    item->stages[0].output_file = item->output_file;
+    rgsl_free(words);
+}
+
+static bool rgsl_compile_program(struct rgsl_pipeline_item* item) {
+    struct rgsl_shader_data* stages;
+    size_t count;
+    rgsl_printf_info(1, "Splitting program %s into its stages...\n", item->job->input_file);
+    bool success = rgsl_split_program(&item->shader, &stages, &count);
+    rgsl_release_shader(&item->shader);
+    if (!success) {
+        return false;
+    }
+    // The stages are parsed in parallel, then their actions run in order on this thread.
+    rgsl_build_program_stages(stages, count);
+    item->stages = (struct rgsl_pipeline_item*)rgsl_calloc(count, sizeof(struct rgsl_pipeline_item));
+    item->stage_count = count;
+    for (size_t i = 0; i < count; i++) {
+        struct rgsl_pipeline_item* stage = &item->stages[i];
+        stage->job = item->job;
+        stage->shader = stages[i];
+        if (item->output_file != NULL) {
+            size_t length = strlen(item->output_file) + strlen(stage->shader.stage) + 2;
+            stage->stage_output_file = (char *)rgsl_malloc(length);
+            snprintf(stage->stage_output_file, length, "%s.%s", item->output_file, stage->shader.stage);
+            stage->output_file = stage->stage_output_file;
+        }
+        stage->success = rgsl_compile_loaded_shader(stage);
+        success &= stage->success;
+    }
+    rgsl_free(stages);
+    if (success && count > 1 && rgsl_program_module_enabled() && item->output_file != NULL) {
+        rgsl_link_program(item);
+    }
+    return success;
+}
+
+static bool rgsl_compile_shader_job(struct rgsl_pipeline_item* item) {
+    struct rgsl_shader_data* shader = &item->shader;
+    bool success = rgsl_load_job_shader(item->job, item->raw_code, shader);
+    rgsl_free_file_buffer(item->raw_code);
+    item->raw_code = NULL;
+    item->output_file = item->job->output_file ? item->job->output_file : rgsl_global_options.output_file;
+    if (!success) {
+        rgsl_release_shader(shader);
+        return false;
+    }
+    if (rgsl_is_program_code(shader->code)) {
+        return rgsl_compile_program(item);
+    }
+    return rgsl_compile_loaded_shader(item);
+}
+
+// The messages of each stage of a job are written together, never interleaved with those of the reader and writer threads.
+static bool rgsl_compile_job(struct rgsl_pipeline_item* item) {
+    rgsl_log_begin_shader(item->job->input_file);
+    rgsl_memory_begin_shader(item->job->input_file);
+    enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_COMPILE);
+    bool success = rgsl_compile_shader_job(item);
+    rgsl_memory_leave_phase(phase);
+    rgsl_memory_end_shader();
+    rgsl_log_end_shader();
+    return success;
+}
+
+static bool rgsl_write_target_outputs(struct rgsl_pipeline_item* item) {
+    bool success = true;
+    struct rgsl_shader_data* shader = &item->shader;
+    for (size_t i = 0; i < shader->target_output_count; i++) {
+        const struct rgsl_target_output* output = &shader->target_outputs[i];
+        char* path = rgsl_target_output_path(item->output_file, output->target);
+        if (rgsl_write_file(path, output->code, output->size)) {
+            rgsl_printf_info(1, "Compiled shader written to %s\n", path);
+        } else {
+            rgsl_printf_error("Failed to open output file: %s\n", path);
+            success = false;
+        }
+        rgsl_free(path);
+    }
+    rgsl_release_target_outputs(shader);
+    return success;
+}
+
+// Embedded outputs are left to the packager.
+static bool rgsl_job_has_output(const struct rgsl_pipeline_item* item) {
+    return item->output != NULL || (item->shader.target_output_count > 0 && !(rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED));
+}
+
+static bool rgsl_write_job(struct rgsl_pipeline_item* item) {
+    if (item->shader.target_output_count > 0) {
+        return rgsl_write_target_outputs(item);
+    }
+    bool success = rgsl_write_file(item->output_file, item->output, item->output_size);
+    if (success) {
+        rgsl_printf_info(1, "Compiled shader written to %s\n", item->output_file);
+    } else {
+        rgsl_printf_error("Failed to open output file: %s\n", item->output_file);
+    }
+    rgsl_free_file_buffer(item->output);
+    item->output = NULL;
+    return success;
+}
+
+static bool rgsl_finish_shader(struct rgsl_pipeline_item* item, struct rgsl_packager* packager) {
+    // Nothing of the shader outlives this step, so memory stays flat whatever the job count.
+    bool success = item->success;
+    if (success && rgsl_job_has_output(item)) {
+        success = rgsl_write_job(item);
+    }
+    if (success && packager != NULL) {
+        enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_PACKAGE);
+        success = rgsl_packager_add(packager, &item->shader);
+        rgsl_memory_leave_phase(phase);
+    }
+    rgsl_release_shader(&item->shader);
+    return success;
+}
+
+static bool rgsl_finish_program(struct rgsl_pipeline_item* item, struct rgsl_packager* packager) {
+    // The stages are packaged next to each other, as one program.
+    bool success = item->success;
+    if (packager != NULL) {
+        rgsl_packager_begin_program(packager, item->stages[0].shader.name);
+    }
+    for (size_t i = 0; i < item->stage_count; i++) {
+        success &= rgsl_finish_shader(&item->stages[i], packager);
+        rgsl_free(item->stages[i].stage_output_file);
+    }
+    if (packager != NULL) {
+        rgsl_packager_end_program(packager);
+    }
+    rgsl_free(item->stages);
+    item->stages = NULL;
+    item->stage_count = 0;
+    return success;
+}
+
+static bool rgsl_finish_job(struct rgsl_pipeline_item* item, struct rgsl_packager* packager) {
+    rgsl_log_begin_shader(item->job->input_file);
+    rgsl_memory_begin_shader(item->job->input_file);
+    enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_WRITE);
+    bool success = (item->stages != NULL) ? rgsl_finish_program(item, packager) : rgsl_finish_shader(item, packager);
+    rgsl_memory_leave_phase(phase);
+    rgsl_memory_end_shader();
+    rgsl_log_end_shader();
+    return success;
+}
+
+static void rgsl_pipeline_reader(void* user) {
+    struct rgsl_pipeline* pipeline = (struct rgsl_pipeline*)user;
+    for (size_t i = 0; i < pipeline->count; i++) {
+        struct rgsl_pipeline_item* item = &pipeline->items[i];
+        item->success = rgsl_read_job(item);
+        if (!rgsl_queue_push(&pipeline->read_queue, item)) {
+            break;
+        }
+    }
+    rgsl_queue_close(&pipeline->read_queue);
+}
+
+static void rgsl_pipeline_writer(void* user) {
+    struct rgsl_pipeline* pipeline = (struct rgsl_pipeline*)user;
+    void* value;
+    while (rgsl_queue_pop(&pipeline->write_queue, &value)) {
+        struct rgsl_pipeline_item* item = (struct rgsl_pipeline_item*)value;
+        item->success = rgsl_finish_job(item, pipeline->packager);
+    }
+}
+
+static void rgsl_run_serial(struct rgsl_pipeline* pipeline) {
+    for (size_t i = 0; i < pipeline->count; i++) {
+        struct rgsl_pipeline_item* item = &pipeline->items[i];
+        item->success = rgsl_read_job(item) && rgsl_compile_job(item);
+        item->success = rgsl_finish_job(item, pipeline->packager);
+    }
+}
+
+static bool rgsl_run_pipelined(struct rgsl_pipeline* pipeline) {
+    rgsl_queue_init(&pipeline->read_queue, RGSL_PIPELINE_DEPTH);
+    rgsl_queue_init(&pipeline->write_queue, RGSL_PIPELINE_DEPTH);
+    rgsl_thread reader;
+    rgsl_thread writer;
+    if (!rgsl_thread_create(&reader, rgsl_pipeline_reader, pipeline)) {
+        rgsl_queue_free(&pipeline->write_queue);
+        rgsl_queue_free(&pipeline->read_queue);
+        return false;
+    }
+    if (!rgsl_thread_create(&writer, rgsl_pipeline_writer, pipeline)) {
+        rgsl_queue_close(&pipeline->read_queue);
+        rgsl_thread_join(reader);
+        rgsl_queue_free(&pipeline->write_queue);
+        rgsl_queue_free(&pipeline->read_queue);
+        return false;
+    }
+
+    // Compilation stays on this thread: glslang and the include caches are not shared.
+    void* value;
+    while (rgsl_queue_pop(&pipeline->read_queue, &value)) {
+        struct rgsl_pipeline_item* item = (struct rgsl_pipeline_item*)value;
+        if (item->success) {
+            item->success = rgsl_compile_job(item);
+        }
+        rgsl_queue_push(&pipeline->write_queue, item);
+    }
+    rgsl_queue_close(&pipeline->write_queue);
+    rgsl_thread_join(reader);
+    rgsl_thread_join(writer);
+    rgsl_queue_free(&pipeline->write_queue);
+    rgsl_queue_free(&pipeline->read_queue);
+    return true;
+}
+
+// The packager writes the blobs as they come, so the jobs are run in the order of the package.
+static void rgsl_order_jobs_by_usage(struct rgsl_pipeline* pipeline, const struct rgsl_manifest* manifest, struct rgsl_usage_profile* profile) {
+    size_t count = manifest->count;
+    const char** paths = (const char**)rgsl_malloc(count * sizeof(char*));
+    const char** names = (const char**)rgsl_malloc(count * sizeof(char*));
+    size_t* order = (size_t *)rgsl_malloc(count * sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        paths[i] = manifest->jobs[i].input_file;
+        names[i] = rgsl_determine_shader_name(paths[i]);
+    }
+    rgsl_usage_order(profile, paths, names, count, order);
+    for (size_t i = 0; i < count; i++) {
+        pipeline->items[i].job = &manifest->jobs[order[i]];
+        rgsl_free((void*)names[i]);
+    }
+    rgsl_free(order);
+    rgsl_free(names);
+    rgsl_free(paths);
+}
+
+int rgsl_run_jobs(const struct rgsl_manifest* manifest) {
+    bool embed = (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) != 0;
+    struct rgsl_packager packager;
+    if (embed && !rgsl_packager_begin(&packager, rgsl_global_options.output_file)) {
+        rgsl_packager_end(&packager, false);
+        return 1;
+    }
+
+    struct rgsl_pipeline pipeline;
+    pipeline.count = manifest->count;
+    pipeline.items = (struct rgsl_pipeline_item*)rgsl_calloc(manifest->count, sizeof(struct rgsl_pipeline_item));
+    pipeline.packager = embed ? &packager : NULL;
+    for (size_t i = 0; i < manifest->count; i++) {
+        pipeline.items[i].job = &manifest->jobs[i];
+    }
+    struct rgsl_usage_profile* profile = embed ? rgsl_global_usage_profile() : NULL;
+    if (profile != NULL) {
+        rgsl_order_jobs_by_usage(&pipeline, manifest, profile);
+    }
+
+    // Reading shader N+1 and writing shader N-1 overlap with compiling shader N.
+    double start = rgsl_clock_seconds();
+    bool pipelined = manifest->count > 1 && !rgsl_global_options.serial_io && rgsl_run_pipelined(&pipeline);
+    if (!pipelined) {
+        rgsl_run_serial(&pipeline);
+    }
+    rgsl_printf_info(2, "Processed %zu shaders in %.3f ms (%s I/O)\n", manifest->count, rgsl_clock_elapsed_ms(start), pipelined ? "pipelined" : "serial");
+
+    const char** failures = (const char**)rgsl_malloc(sizeof(char*) * (manifest->count + 1));
+    size_t failure_count = 0;
+    for (size_t i = 0; i < manifest->count; i++) {
+        if (!pipeline.items[i].success) {
+            failures[failure_count++] = pipeline.items[i].job->input_file;
+        }
+    }
+    rgsl_free(pipeline.items);
+
+    if (embed) {
+        enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_PACKAGE);
+        if (failure_count > 0) {
+            rgsl_print_error("Shaders are not packaged since some of them failed\n");
+            rgsl_packager_end(&packager, false);
+        } else if (!rgsl_packager_end(&packager, true)) {
+            failures[failure_count++] = rgsl_global_options.output_file;
+        }
+        rgsl_memory_leave_phase(phase);
+    }
+
+    if (manifest->count > 1) {
+        rgsl_printf_info(1, "%zu of %zu shaders processed successfully.\n", manifest->count - failure_count, manifest->count);
+    }
+    for (size_t i = 0; i < failure_count && manifest->count > 1; i++) {
+        rgsl_printf_error("Failed: %s\n", failures[i]);
+    }
+    rgsl_free(failures);
+    return failure_count > 0 ? 1 : 0;
+}
\ No newline at end of file
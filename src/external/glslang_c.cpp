@@ -1,10 +1,24 @@
 #include <RGSL/external/glslang_c.h>
 
+extern "C" {
+#include <RGSL/resolver.h>
+#include <RGSL/memory.h>
+}
+
 #include <glslang/Public/ShaderLang.h>
+#include <glslang/Include/Types.h>
+#include <glslang/MachineIndependent/localintermediate.h>
 #include <SPIRV/GlslangToSpv.h>
+#include <spirv-tools/libspirv.hpp>
 
 #include <vector>
 #include <string>
+#include <algorithm>
+#include <unordered_set>
+#include <map>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
 
 #ifdef WIN32
 #define strdup _strdup
@@ -131,6 +145,90 @@ static EShLanguage StageFromString(const char* s) {
     return EShLangCount;
 }
 
+// Included files are shared with the RGSL preprocessor, but their own #version
+// directive must go: glslang only accepts one, at the top of the shader.
+static void BlankVersionDirectives(std::string& content) {
+    size_t line_start = 0;
+    while (line_start < content.size()) {
+        size_t line_end = content.find('\n', line_start);
+        if (line_end == std::string::npos) {
+            line_end = content.size();
+        }
+        size_t cursor = content.find_first_not_of(" \t", line_start);
+        if (cursor < line_end && content[cursor] == '#') {
+            cursor = content.find_first_not_of(" \t", cursor + 1);
+            if (cursor < line_end && content.compare(cursor, 7, "version") == 0) {
+                content.replace(line_start, line_end - line_start, line_end - line_start, ' ');
+            }
+        }
+        line_start = line_end + 1;
+    }
+}
+
+// Resolves #include directives with the RGSL include resolver, so that glslang
+// follows the same search rules and shares the include content cache.
+class RGSLIncluder : public glslang::TShader::Includer {
+public:
+    IncludeResult* includeSystem(const char* header_name, const char* /*includer_name*/, size_t /*inclusion_depth*/) override {
+        return Include(header_name, nullptr);
+    }
+
+    IncludeResult* includeLocal(const char* header_name, const char* includer_name, size_t /*inclusion_depth*/) override {
+        return Include(header_name, includer_name != nullptr ? includer_name : "");
+    }
+
+    void releaseInclude(IncludeResult* result) override {
+        if (result != nullptr) {
+            delete static_cast<std::string*>(result->userData);
+            delete result;
+        }
+    }
+
+private:
+    static IncludeResult* Include(const char* header_name, const char* includer_path) {
+        char* path = rgsl_resolve_include(header_name, includer_path);
+        if (path == nullptr) {
+            return nullptr;
+        }
+        const char* content = nullptr;
+        size_t size = 0;
+        if (!rgsl_resolver_read(path, &content, &size)) {
+            rgsl_free(path);
+            return nullptr;
+        }
+        std::string* data = new std::string(content, size);
+        BlankVersionDirectives(*data);
+        IncludeResult* result = new IncludeResult(path, data->data(), data->size(), data);
+        rgsl_free(path);
+        return result;
+    }
+};
+
+// Accounts a call into glslang or SPIRV-Tools to its memory phase, whose pool
+// allocators are only seen through the resident set size sampled around it.
+class GlslangPhase {
+public:
+    GlslangPhase() : previous(rgsl_memory_enter_phase(RGSL_PHASE_GLSLANG)) {}
+    ~GlslangPhase() { rgsl_memory_leave_phase(previous); }
+
+private:
+    enum rgsl_memory_phase previous;
+};
+
+struct rgsl_glslang_program {
+    EShLanguage stage;
+    glslang::TShader shader;
+    glslang::TProgram program; // Destroyed before the shader it references
+
+    explicit rgsl_glslang_program(EShLanguage stage) : stage(stage), shader(stage) {}
+};
+
+// The resource limits never change, build them once for every shader.
+static const TBuiltInResource& GetResources() {
+    static const TBuiltInResource resources = InitResources();
+    return resources;
+}
+
 void rgsl_glslang_initialize() {
     glslang::InitializeProcess();
 }
@@ -139,65 +237,107 @@ void rgsl_glslang_finalize() {
     glslang::FinalizeProcess();
 }
 
-bool rgsl_glslang_validate_glsl(const char* source, const char* stage_str, char** out_log) {
-    EShLanguage stage = StageFromString(stage_str);
-    if (stage == EShLangCount) {
-        *out_log = strdup("Invalid shader stage specified.");
-        return false;
-    }
+// Vulkan versions, with the environments glslang and SPIRV-Tools know them by.
+struct VulkanEnvironment {
+    int version;
+    glslang::EShTargetClientVersion client;
+    glslang::EShTargetLanguageVersion spirv;
+    spv_target_env validation;
+};
 
-    glslang::TShader shader(stage);
-    shader.setStrings(&source, 1);
+static const VulkanEnvironment VULKAN_ENVIRONMENTS[] = {
+    {100, glslang::EShTargetVulkan_1_0, glslang::EShTargetSpv_1_0, SPV_ENV_VULKAN_1_0},
+    {110, glslang::EShTargetVulkan_1_1, glslang::EShTargetSpv_1_3, SPV_ENV_VULKAN_1_1},
+    {120, glslang::EShTargetVulkan_1_2, glslang::EShTargetSpv_1_5, SPV_ENV_VULKAN_1_2},
+    {130, glslang::EShTargetVulkan_1_3, glslang::EShTargetSpv_1_6, SPV_ENV_VULKAN_1_3},
+};
 
-    EShMessages messages = EShMsgDefault;
-    TBuiltInResource resources = InitResources();
-    if (!shader.parse(&resources, 100, false, messages)) {
-        *out_log = strdup(shader.getInfoLog());
-        return false;
+static const VulkanEnvironment* FindVulkanEnvironment(int version) {
+    for (const VulkanEnvironment& environment : VULKAN_ENVIRONMENTS) {
+        if (environment.version == version) {
+            return &environment;
+        }
     }
+    return nullptr;
+}
 
-    glslang::TProgram program;
-    program.addShader(&shader);
-    if (!program.link(messages)) {
-        *out_log = strdup(program.getInfoLog());
-        return false;
+// Parses and links a program whose environment is already set.
+static struct rgsl_glslang_program* BuildProgram(rgsl_glslang_program* program, bool native_includes, EShMessages messages, bool map_io, char** out_log) {
+    bool parsed;
+    if (native_includes) {
+        RGSLIncluder includer;
+        parsed = program->shader.parse(&GetResources(), 100, false, messages, includer);
+    } else {
+        parsed = program->shader.parse(&GetResources(), 100, false, messages);
+    }
+    if (!parsed) {
+        *out_log = rgsl_strdup(program->shader.getInfoLog());
+        delete program;
+        return nullptr;
     }
 
-    *out_log = strdup(program.getInfoLog());
-    return true;
+    program->program.addShader(&program->shader);
+    if (!program->program.link(messages) || (map_io && !program->program.mapIO())) {
+        *out_log = rgsl_strdup(program->program.getInfoLog());
+        delete program;
+        return nullptr;
+    }
+
+    *out_log = rgsl_strdup(program->program.getInfoLog());
+    return program;
 }
 
-struct rgsl_glslang_result rgsl_glslang_compile_glsl(const char* source, const char* stage_str) {
-    struct rgsl_glslang_result result = {};
+struct rgsl_glslang_program* rgsl_glslang_create_program(const char* source, const char* source_name, const char* stage_str, bool native_includes, bool spirv_rules, char** out_log) {
+    GlslangPhase phase;
     EShLanguage stage = StageFromString(stage_str);
     if (stage == EShLangCount) {
-        result.log = strdup("Invalid shader stage specified.");
-        result.success = 0;
-        return result;
+        *out_log = rgsl_strdup("Invalid shader stage specified.");
+        return nullptr;
     }
 
-    glslang::TShader shader(stage);
-    shader.setStrings(&source, 1);
+    rgsl_glslang_program* program = new rgsl_glslang_program(stage);
+    const char* name = source_name != nullptr ? source_name : "";
+    program->shader.setStringsWithLengthsAndNames(&source, nullptr, &name, 1);
 
     EShMessages messages = EShMsgDefault;
-    TBuiltInResource resources = InitResources();
-    if (!shader.parse(&resources, 100, false, messages)) {
-        result.log = strdup(shader.getInfoLog());
-        result.success = 0;
-        return result;
+    if (spirv_rules) {
+        // Specialization constants only exist under the GL_ARB_gl_spirv rules.
+        program->shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientOpenGL, 100);
+        program->shader.setEnvClient(glslang::EShClientOpenGL, glslang::EShTargetOpenGL_450);
+        program->shader.setEnvTarget(glslang::EShTargetSpv, glslang::EShTargetSpv_1_0);
+        program->shader.setAutoMapLocations(true);
+        program->shader.setAutoMapBindings(true);
+        messages = (EShMessages)(messages | EShMsgSpvRules);
     }
+    return BuildProgram(program, native_includes, messages, spirv_rules, out_log);
+}
 
-    glslang::TProgram program;
-    program.addShader(&shader);
-    if (!program.link(messages)) {
-        result.log = strdup(program.getInfoLog());
-        result.success = 0;
-        return result;
+struct rgsl_glslang_program* rgsl_glslang_create_vulkan_program(const char* source, const char* source_name, const char* stage_str, int vulkan_version, char** out_log) {
+    GlslangPhase phase;
+    EShLanguage stage = StageFromString(stage_str);
+    const VulkanEnvironment* environment = FindVulkanEnvironment(vulkan_version);
+    if (stage == EShLangCount || environment == nullptr) {
+        *out_log = rgsl_strdup(stage == EShLangCount ? "Invalid shader stage specified." : "Unknown Vulkan version.");
+        return nullptr;
     }
 
-    glslang::TIntermediate* intermediate = program.getIntermediate(stage);
+    rgsl_glslang_program* program = new rgsl_glslang_program(stage);
+    const char* name = source_name != nullptr ? source_name : "";
+    program->shader.setStringsWithLengthsAndNames(&source, nullptr, &name, 1);
+    program->shader.setEnvInput(glslang::EShSourceGlsl, stage, glslang::EShClientVulkan, 100);
+    program->shader.setEnvClient(glslang::EShClientVulkan, environment->client);
+    program->shader.setEnvTarget(glslang::EShTargetSpv, environment->spirv);
+    program->shader.setAutoMapLocations(true);
+    program->shader.setAutoMapBindings(true);
+    return BuildProgram(program, false, (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules), true, out_log);
+}
+
+struct rgsl_glslang_result rgsl_glslang_generate_spirv(const struct rgsl_glslang_program* program) {
+    GlslangPhase phase;
+    struct rgsl_glslang_result result = {};
+    glslang::TIntermediate* intermediate = program->program.getIntermediate(program->stage);
     if (!intermediate) {
-        result.log = strdup("Failed to get intermediate representation.");
+        result.log = rgsl_strdup("Failed to get intermediate representation.");
         result.success = 0;
         return result;
     }
@@ -206,17 +346,1121 @@ struct rgsl_glslang_result rgsl_glslang_compile_glsl(const char* source, const c
     GlslangToSpv(*intermediate, spirv);
 
     size_t word_count = spirv.size();
-    uint32_t* words = (uint32_t*)malloc(word_count * sizeof(uint32_t));
+    uint32_t* words = (uint32_t*)rgsl_malloc(word_count * sizeof(uint32_t));
     memcpy(words, spirv.data(), word_count * sizeof(uint32_t));
 
     result.words = words;
     result.word_count = word_count;
-    result.log = strdup(program.getInfoLog());
+    result.log = rgsl_strdup("");
     result.success = 1;
     return result;
 }
 
+char* rgsl_glslang_validate_spirv(const uint32_t* words, size_t word_count, int vulkan_version) {
+    GlslangPhase phase;
+    const VulkanEnvironment* environment = FindVulkanEnvironment(vulkan_version);
+    spvtools::SpirvTools tools(environment != nullptr ? environment->validation : SPV_ENV_OPENGL_4_5);
+    std::string messages;
+    tools.SetMessageConsumer([&messages](spv_message_level_t, const char*, const spv_position_t& position, const char* message) {
+        messages += "word " + std::to_string(position.index) + ": " + message + "\n";
+    });
+    if (tools.Validate(words, word_count)) {
+        return nullptr;
+    }
+    return rgsl_strdup(messages.empty() ? "invalid SPIR-V\n" : messages.c_str());
+}
+
+static std::string DescribeObject(const char* kind, const glslang::TObjectReflection& object) {
+    const glslang::TType* type = object.getType();
+    std::string line = kind;
+    line += ' ';
+    line += object.name;
+    line += " type " + std::to_string(object.glDefineType);
+    line += " size " + std::to_string(object.size);
+    line += " offset " + std::to_string(object.offset);
+    line += " array " + std::to_string(object.topLevelArraySize);
+    line += " binding " + std::to_string(object.getBinding());
+    if (type != nullptr) {
+        line += " set " + std::to_string(type->getQualifier().hasSet() ? (int)type->getQualifier().layoutSet : -1);
+        line += " location " + std::to_string(type->getQualifier().hasLocation() ? (int)type->getQualifier().layoutLocation : -1);
+    }
+    return line;
+}
+
+char* rgsl_glslang_describe_interface(struct rgsl_glslang_program* program) {
+    GlslangPhase phase;
+    if (!program->program.buildReflection(EShReflectionDefault | EShReflectionSeparateBuffers)) {
+        return nullptr;
+    }
+    const glslang::TProgram& reflection = program->program;
+    std::vector<std::string> lines;
+    for (int i = 0; i < reflection.getNumPipeInputs(); i++) {
+        lines.push_back(DescribeObject("in", reflection.getPipeInput(i)));
+    }
+    for (int i = 0; i < reflection.getNumPipeOutputs(); i++) {
+        lines.push_back(DescribeObject("out", reflection.getPipeOutput(i)));
+    }
+    for (int i = 0; i < reflection.getNumUniformVariables(); i++) {
+        lines.push_back(DescribeObject("uniform", reflection.getUniform(i)));
+    }
+    for (int i = 0; i < reflection.getNumUniformBlocks(); i++) {
+        lines.push_back(DescribeObject("block", reflection.getUniformBlock(i)));
+    }
+    for (int i = 0; i < reflection.getNumBufferVariables(); i++) {
+        lines.push_back(DescribeObject("buffer", reflection.getBufferVariable(i)));
+    }
+    for (int i = 0; i < reflection.getNumBufferBlocks(); i++) {
+        lines.push_back(DescribeObject("storage", reflection.getBufferBlock(i)));
+    }
+
+    // Reflection order follows the declarations, which must not change the interface.
+    std::sort(lines.begin(), lines.end());
+    std::string description = std::string("stage ") + std::to_string((int)program->stage) + "\n";
+    for (const std::string& line : lines) {
+        description += line;
+        description += '\n';
+    }
+    return rgsl_strdup(description.c_str());
+}
+
+// Built-in functions the performance lint knows, and whether they are notably
+// slower in highp than in mediump on mobile GPUs.
+struct LintFunction {
+    glslang::TOperator op;
+    const char* name;
+    bool heavy;
+};
+
+static const LintFunction LINT_FUNCTIONS[] = {
+    {glslang::EOpAdd, "operator +", false},
+    {glslang::EOpSub, "operator -", false},
+    {glslang::EOpMul, "operator *", false},
+    {glslang::EOpDiv, "operator /", false},
+    {glslang::EOpMod, "mod", false},
+    {glslang::EOpVectorTimesScalar, "operator *", false},
+    {glslang::EOpVectorTimesMatrix, "operator *", false},
+    {glslang::EOpMatrixTimesVector, "operator *", false},
+    {glslang::EOpMatrixTimesScalar, "operator *", false},
+    {glslang::EOpMatrixTimesMatrix, "operator *", false},
+    {glslang::EOpRadians, "radians", false},
+    {glslang::EOpDegrees, "degrees", false},
+    {glslang::EOpSin, "sin", true},
+    {glslang::EOpCos, "cos", true},
+    {glslang::EOpTan, "tan", true},
+    {glslang::EOpAsin, "asin", true},
+    {glslang::EOpAcos, "acos", true},
+    {glslang::EOpAtan, "atan", true},
+    {glslang::EOpSinh, "sinh", true},
+    {glslang::EOpCosh, "cosh", true},
+    {glslang::EOpTanh, "tanh", true},
+    {glslang::EOpPow, "pow", true},
+    {glslang::EOpExp, "exp", true},
+    {glslang::EOpLog, "log", true},
+    {glslang::EOpExp2, "exp2", true},
+    {glslang::EOpLog2, "log2", true},
+    {glslang::EOpSqrt, "sqrt", true},
+    {glslang::EOpInverseSqrt, "inversesqrt", true},
+    {glslang::EOpSmoothStep, "smoothstep", true},
+    {glslang::EOpLength, "length", true},
+    {glslang::EOpDistance, "distance", true},
+    {glslang::EOpNormalize, "normalize", true},
+    {glslang::EOpRefract, "refract", true},
+    {glslang::EOpDot, "dot", false},
+    {glslang::EOpCross, "cross", false},
+    {glslang::EOpReflect, "reflect", false},
+    {glslang::EOpFaceForward, "faceforward", false},
+    {glslang::EOpMix, "mix", false},
+    {glslang::EOpClamp, "clamp", false},
+    {glslang::EOpMin, "min", false},
+    {glslang::EOpMax, "max", false},
+    {glslang::EOpStep, "step", false},
+    {glslang::EOpFract, "fract", false},
+    {glslang::EOpFloor, "floor", false},
+    {glslang::EOpCeil, "ceil", false},
+    {glslang::EOpAbs, "abs", false},
+    {glslang::EOpSign, "sign", false},
+    {glslang::EOpTranspose, "transpose", false},
+    {glslang::EOpDeterminant, "determinant", true},
+    {glslang::EOpMatrixInverse, "inverse", true},
+    {glslang::EOpOuterProduct, "outerProduct", false},
+};
+
+// Arrays at least this long are costly to index with a value that varies.
+static const int LARGE_ARRAY_SIZE = 16;
+
+static const LintFunction* FindLintFunction(glslang::TOperator op) {
+    for (const LintFunction& function : LINT_FUNCTIONS) {
+        if (function.op == op) {
+            return &function;
+        }
+    }
+    return nullptr;
+}
+
+// Sampling functions computing their level of detail from derivatives.
+static bool IsImplicitLodSampling(glslang::TOperator op) {
+    switch (op) {
+    case glslang::EOpTexture:
+    case glslang::EOpTextureProj:
+    case glslang::EOpTextureOffset:
+    case glslang::EOpTextureProjOffset:
+    case glslang::EOpTextureClamp:
+    case glslang::EOpTextureOffsetClamp:
+    case glslang::EOpSparseTexture:
+    case glslang::EOpSparseTextureOffset:
+    case glslang::EOpSparseTextureClamp:
+    case glslang::EOpSparseTextureOffsetClamp:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool IsDerivative(glslang::TOperator op) {
+    switch (op) {
+    case glslang::EOpDPdx:
+    case glslang::EOpDPdy:
+    case glslang::EOpFwidth:
+    case glslang::EOpDPdxFine:
+    case glslang::EOpDPdyFine:
+    case glslang::EOpFwidthFine:
+    case glslang::EOpDPdxCoarse:
+    case glslang::EOpDPdyCoarse:
+    case glslang::EOpFwidthCoarse:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Operations whose result differs between invocations, whatever their operands.
+static bool HasSideEffects(glslang::TOperator op) {
+    if (op > glslang::EOpImageGuardBegin && op < glslang::EOpImageGuardEnd) {
+        return true;
+    }
+    switch (op) {
+    case glslang::EOpFunctionCall:
+    case glslang::EOpAtomicAdd:
+    case glslang::EOpAtomicMin:
+    case glslang::EOpAtomicMax:
+    case glslang::EOpAtomicAnd:
+    case glslang::EOpAtomicOr:
+    case glslang::EOpAtomicXor:
+    case glslang::EOpAtomicExchange:
+    case glslang::EOpAtomicCompSwap:
+    case glslang::EOpAtomicLoad:
+    case glslang::EOpAtomicStore:
+    case glslang::EOpAtomicCounterIncrement:
+    case glslang::EOpAtomicCounterDecrement:
+    case glslang::EOpAtomicCounter:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Walks the control flow of a tree, knowing which variables vary between the
+// invocations of a draw, and how many enclosing conditions vary.
+class UniformityTraverser : public glslang::TIntermTraverser {
+public:
+    explicit UniformityTraverser(std::unordered_set<long long>& varying) : varying(varying) {}
+
+    bool IsUniform(glslang::TIntermNode* node) const {
+        if (node == nullptr || node->getAsConstantUnion() != nullptr) {
+            return true;
+        }
+        if (glslang::TIntermSymbol* symbol = node->getAsSymbolNode()) {
+            const glslang::TQualifier& qualifier = symbol->getQualifier();
+            if (qualifier.specConstant) {
+                return true;
+            }
+            switch (qualifier.storage) {
+            case glslang::EvqConst:
+            case glslang::EvqUniform:
+                return true;
+            case glslang::EvqBuffer:
+                return qualifier.readonly;
+            case glslang::EvqTemporary:
+            case glslang::EvqGlobal:
+            case glslang::EvqConstReadOnly:
+                return varying.count(symbol->getId()) == 0;
+            default:
+                return false;
+            }
+        }
+        if (glslang::TIntermBinary* binary = node->getAsBinaryNode()) {
+            return IsUniform(binary->getLeft()) && IsUniform(binary->getRight());
+        }
+        if (glslang::TIntermUnary* unary = node->getAsUnaryNode()) {
+            return !HasSideEffects(unary->getOp()) && IsUniform(unary->getOperand());
+        }
+        if (glslang::TIntermSelection* selection = node->getAsSelectionNode()) {
+            return IsUniform(selection->getCondition()) && IsUniform(selection->getTrueBlock()) && IsUniform(selection->getFalseBlock());
+        }
+        if (glslang::TIntermAggregate* aggregate = node->getAsAggregate()) {
+            if (HasSideEffects(aggregate->getOp())) {
+                return false;
+            }
+            for (glslang::TIntermNode* child : aggregate->getSequence()) {
+                if (!IsUniform(child)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool visitSelection(glslang::TVisit, glslang::TIntermSelection* node) override {
+        node->getCondition()->traverse(this);
+        int divergent = IsUniform(node->getCondition()) ? 0 : 1;
+        divergence += divergent;
+        if (node->getTrueBlock() != nullptr) {
+            node->getTrueBlock()->traverse(this);
+        }
+        if (node->getFalseBlock() != nullptr) {
+            node->getFalseBlock()->traverse(this);
+        }
+        divergence -= divergent;
+        return false;
+    }
+
+    bool visitSwitch(glslang::TVisit, glslang::TIntermSwitch* node) override {
+        node->getCondition()->traverse(this);
+        int divergent = IsUniform(node->getCondition()) ? 0 : 1;
+        divergence += divergent;
+        node->getBody()->traverse(this);
+        divergence -= divergent;
+        return false;
+    }
+
+    bool visitLoop(glslang::TVisit, glslang::TIntermLoop* node) override {
+        // The test is evaluated again after each iteration, under its own divergence.
+        int divergent = IsUniform(node->getTest()) ? 0 : 1;
+        divergence += divergent;
+        if (node->getTest() != nullptr) {
+            node->getTest()->traverse(this);
+        }
+        if (node->getBody() != nullptr) {
+            node->getBody()->traverse(this);
+        }
+        if (node->getTerminal() != nullptr) {
+            node->getTerminal()->traverse(this);
+        }
+        divergence -= divergent;
+        return false;
+    }
+
+protected:
+    std::unordered_set<long long>& varying;
+    int divergence = 0;
+};
+
+// Finds the variables that may vary between invocations. A variable varies once a
+// varying value, or any write in varying control flow, reaches it; since this may
+// change the conditions seen earlier, the tree is walked until nothing changes.
+class UniformityAnalysis : public UniformityTraverser {
+public:
+    explicit UniformityAnalysis(std::unordered_set<long long>& varying) : UniformityTraverser(varying) {}
+
+    void Run(glslang::TIntermNode* root) {
+        do {
+            changed = false;
+            divergence = 0;
+            root->traverse(this);
+        } while (changed);
+    }
+
+    bool visitBinary(glslang::TVisit, glslang::TIntermBinary* node) override {
+        if (node->modifiesState() && (divergence > 0 || !IsUniform(node->getLeft()) || !IsUniform(node->getRight()))) {
+            MarkVarying(node->getLeft());
+        }
+        return true;
+    }
+
+    bool visitUnary(glslang::TVisit, glslang::TIntermUnary* node) override {
+        if (node->modifiesState() && divergence > 0) {
+            MarkVarying(node->getOperand());
+        }
+        return true;
+    }
+
+    bool visitAggregate(glslang::TVisit, glslang::TIntermAggregate* node) override {
+        glslang::TIntermSequence& sequence = node->getSequence();
+        if (node->getOp() == glslang::EOpFunction && !sequence.empty() && sequence[0]->getAsAggregate() != nullptr) {
+            // Functions may be called with any argument.
+            for (glslang::TIntermNode* parameter : sequence[0]->getAsAggregate()->getSequence()) {
+                MarkVarying(parameter->getAsTyped());
+            }
+        } else if (node->getOp() == glslang::EOpFunctionCall) {
+            const glslang::TQualifierList& qualifiers = node->getQualifierList();
+            for (size_t i = 0; i < sequence.size() && i < qualifiers.size(); i++) {
+                if (qualifiers[i] == glslang::EvqOut || qualifiers[i] == glslang::EvqInOut) {
+                    MarkVarying(sequence[i]->getAsTyped());
+                }
+            }
+        }
+        return true;
+    }
+
+private:
+    void MarkVarying(glslang::TIntermTyped* target) {
+        // Writing an element or a component makes the whole variable vary.
+        while (target != nullptr && target->getAsBinaryNode() != nullptr) {
+            target = target->getAsBinaryNode()->getLeft();
+        }
+        glslang::TIntermSymbol* symbol = (target != nullptr) ? target->getAsSymbolNode() : nullptr;
+        if (symbol != nullptr && varying.insert(symbol->getId()).second) {
+            changed = true;
+        }
+    }
+
+    bool changed = false;
+};
+
+// Reports the costly patterns of a tree, once the varying variables are known.
+// Tells whether a fragment shader writes a floating-point color, which blending
+// could leave unchanged instead of a discard. Integer outputs (masks, object
+// IDs) and depth-only passes have no such alternative.
+static bool WritesBlendableColor(glslang::TIntermNode* root) {
+    glslang::TIntermAggregate* aggregate = root->getAsAggregate();
+    if (aggregate == nullptr) {
+        return false;
+    }
+    for (glslang::TIntermNode* child : aggregate->getSequence()) {
+        glslang::TIntermAggregate* objects = child->getAsAggregate();
+        if (objects == nullptr || objects->getOp() != glslang::EOpLinkerObjects) {
+            continue;
+        }
+        for (glslang::TIntermNode* object : objects->getSequence()) {
+            glslang::TIntermSymbol* symbol = object->getAsSymbolNode();
+            if (symbol == nullptr) {
+                continue;
+            }
+            glslang::TStorageQualifier storage = symbol->getQualifier().storage;
+            glslang::TBasicType type = symbol->getBasicType();
+            bool floating = type == glslang::EbtFloat || type == glslang::EbtFloat16 || type == glslang::EbtDouble;
+            if (storage == glslang::EvqFragColor || storage == glslang::EvqFragData || (storage == glslang::EvqVaryingOut && floating)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+class PerformanceLint : public UniformityTraverser {
+public:
+    PerformanceLint(std::unordered_set<long long>& varying, EShLanguage stage, bool es, bool blendable, rgsl_glslang_lint_callback callback, void* user)
+        : UniformityTraverser(varying), fragment(stage == EShLangFragment), es(es), blendable(blendable), callback(callback), user(user) {}
+
+    bool visitBranch(glslang::TVisit, glslang::TIntermBranch* node) override {
+        glslang::TOperator op = node->getFlowOp();
+        if (blendable && (op == glslang::EOpKill || op == glslang::EOpTerminateInvocation || op == glslang::EOpDemote)) {
+            Report(RGSL_LINT_DISCARD, node, "discard disables early depth testing for the whole draw; prefer alpha blending, or a separate mask pass");
+        }
+        return true;
+    }
+
+    bool visitBinary(glslang::TVisit, glslang::TIntermBinary* node) override {
+        if (ReportPerDrawWork(node)) {
+            return false;
+        }
+        if (node->getOp() == glslang::EOpIndexIndirect && !IsUniform(node->getRight())) {
+            const glslang::TType& type = node->getLeft()->getType();
+            if (type.isArray() && (type.isUnsizedArray() || type.getOuterArraySize() >= LARGE_ARRAY_SIZE)) {
+                std::string size = type.isUnsizedArray() ? std::string("runtime-sized") : std::to_string(type.getOuterArraySize()) + " elements";
+                Report(RGSL_LINT_DYNAMIC_INDEXING, node, "'" + DescribeArray(node->getLeft()) + "' (" + size + ") is indexed by a value that varies per invocation, each access is a separate memory load");
+            }
+        }
+        return true;
+    }
+
+    bool visitUnary(glslang::TVisit, glslang::TIntermUnary* node) override {
+        if (ReportPerDrawWork(node)) {
+            return false;
+        }
+        CheckOperation(node, node->getOp());
+        return true;
+    }
+
+    bool visitAggregate(glslang::TVisit, glslang::TIntermAggregate* node) override {
+        if (ReportPerDrawWork(node)) {
+            return false;
+        }
+        CheckOperation(node, node->getOp());
+        return true;
+    }
+
+private:
+    void CheckOperation(glslang::TIntermTyped* node, glslang::TOperator op) {
+        if (fragment && divergence > 0 && IsImplicitLodSampling(op)) {
+            Report(RGSL_LINT_DIVERGENT_SAMPLING, node, "texture sampled with implicit derivatives in control flow that varies per fragment; sample before branching or use an explicit LOD");
+        } else if (fragment && divergence > 0 && IsDerivative(op)) {
+            Report(RGSL_LINT_DIVERGENT_SAMPLING, node, "derivative computed in control flow that varies per fragment; compute it before branching");
+        }
+        const LintFunction* function = FindLintFunction(op);
+        if (es && fragment && function != nullptr && function->heavy
+            && node->getBasicType() == glslang::EbtFloat && node->getQualifier().precision == glslang::EpqHigh) {
+            Report(RGSL_LINT_HIGHP_MATH, node, std::string(function->name) + "() is evaluated in highp in a fragment shader; mediump is usually precise enough for colors");
+        }
+    }
+
+    // Whether a value only reads uniforms and constants, and reads at least one uniform.
+    static bool IsPerDraw(glslang::TIntermNode* node, bool& reads_uniform) {
+        if (node->getAsConstantUnion() != nullptr) {
+            return true;
+        }
+        if (glslang::TIntermSymbol* symbol = node->getAsSymbolNode()) {
+            const glslang::TQualifier& qualifier = symbol->getQualifier();
+            if (qualifier.storage == glslang::EvqUniform) {
+                reads_uniform = true;
+                return true;
+            }
+            return qualifier.storage == glslang::EvqConst || qualifier.specConstant;
+        }
+        if (glslang::TIntermBinary* binary = node->getAsBinaryNode()) {
+            return !binary->modifiesState() && IsPerDraw(binary->getLeft(), reads_uniform) && IsPerDraw(binary->getRight(), reads_uniform);
+        }
+        if (glslang::TIntermUnary* unary = node->getAsUnaryNode()) {
+            return !unary->modifiesState() && !HasSideEffects(unary->getOp()) && IsPerDraw(unary->getOperand(), reads_uniform);
+        }
+        if (glslang::TIntermAggregate* aggregate = node->getAsAggregate()) {
+            if (HasSideEffects(aggregate->getOp())) {
+                return false;
+            }
+            for (glslang::TIntermNode* child : aggregate->getSequence()) {
+                if (!IsPerDraw(child, reads_uniform)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        return false;
+    }
+
+    bool ReportPerDrawWork(glslang::TIntermOperator* node) {
+        // Only the outermost such expression is reported, its operands are not walked.
+        const LintFunction* function = FindLintFunction(node->getOp());
+        bool reads_uniform = false;
+        if ((function == nullptr && !IsImplicitLodSampling(node->getOp())) || !IsPerDraw(node, reads_uniform) || !reads_uniform) {
+            return false;
+        }
+        std::string name = (function != nullptr) ? function->name : "texture";
+        if (function == nullptr || strncmp(name.c_str(), "operator", 8) != 0) {
+            name += "()";
+        }
+        Report(RGSL_LINT_PER_DRAW_WORK, node, name + " only reads uniforms and constants, so every invocation computes the same value; compute it once per draw");
+        return true;
+    }
+
+    static std::string DescribeArray(glslang::TIntermTyped* array) {
+        if (glslang::TIntermSymbol* symbol = array->getAsSymbolNode()) {
+            return symbol->getName().c_str();
+        }
+        glslang::TIntermBinary* binary = array->getAsBinaryNode();
+        if (binary != nullptr && binary->getOp() == glslang::EOpIndexDirectStruct && binary->getRight()->getAsConstantUnion() != nullptr) {
+            const glslang::TTypeList* members = binary->getLeft()->getType().getStruct();
+            int index = binary->getRight()->getAsConstantUnion()->getConstArray()[0].getIConst();
+            if (members != nullptr && index >= 0 && index < (int)members->size()) {
+                return (*members)[index].type->getFieldName().c_str();
+            }
+        }
+        return "array";
+    }
+
+    void Report(enum rgsl_lint_rule rule, const glslang::TIntermNode* node, const std::string& message) {
+        const glslang::TSourceLoc& loc = node->getLoc();
+        const char* file = (loc.name != nullptr) ? loc.name->c_str() : nullptr;
+        std::string key = std::to_string((int)rule) + ":" + std::to_string(loc.line) + ":" + (file != nullptr ? file : "");
+        if (reported.insert(key).second) {
+            callback(rule, file, loc.line, message.c_str(), user);
+        }
+    }
+
+    bool fragment;
+    bool es;
+    bool blendable;
+    rgsl_glslang_lint_callback callback;
+    void* user;
+    std::unordered_set<std::string> reported;
+};
+
+void rgsl_glslang_perf_lint(const struct rgsl_glslang_program* program, rgsl_glslang_lint_callback callback, void* user) {
+    GlslangPhase phase;
+    glslang::TIntermediate* intermediate = program->program.getIntermediate(program->stage);
+    if (intermediate == nullptr || intermediate->getTreeRoot() == nullptr) {
+        return;
+    }
+    std::unordered_set<long long> varying;
+    UniformityAnalysis analysis(varying);
+    analysis.Run(intermediate->getTreeRoot());
+    bool blendable = program->stage == EShLangFragment && WritesBlendableColor(intermediate->getTreeRoot());
+    PerformanceLint lint(varying, program->stage, intermediate->getProfile() == EEsProfile, blendable, callback, user);
+    intermediate->getTreeRoot()->traverse(&lint);
+}
+
+// Largest magnitude mediump is guaranteed to hold in OpenGL ES 3.0.
+static const double MEDIUMP_MAX = 16384.0;
+
+// mediump only guarantees a relative precision of 2^-10: near 1.0, a normalized
+// coordinate moves by 1/1024, a quarter texel of a 256-texel texture.
+static const int MEDIUMP_TEXTURE_SIZE = 256;
+
+// Passes after which the range of a variable that still grows is given up.
+static const int RANGE_WIDENING_PASS = 4;
+
+// Interval holding every component of a value, empty until a value is assigned.
+struct ValueRange {
+    bool bounded;
+    double low;
+    double high;
+
+    static ValueRange Empty() { return {true, HUGE_VAL, -HUGE_VAL}; }
+    static ValueRange Unbounded() { return {false, -HUGE_VAL, HUGE_VAL}; }
+    static ValueRange Between(double low, double high) { return {true, low, high}; }
+
+    bool IsEmpty() const { return bounded && low > high; }
+    bool operator==(const ValueRange& other) const { return bounded == other.bounded && (!bounded || (low == other.low && high == other.high)); }
+    bool operator!=(const ValueRange& other) const { return !(*this == other); }
+};
+
+static ValueRange Hull(const ValueRange& a, const ValueRange& b) {
+    if (!a.bounded || !b.bounded) {
+        return ValueRange::Unbounded();
+    }
+    return ValueRange::Between(std::min(a.low, b.low), std::max(a.high, b.high));
+}
+
+static ValueRange Combine(glslang::TOperator op, const ValueRange& a, const ValueRange& b) {
+    if (!a.bounded || !b.bounded || a.IsEmpty() || b.IsEmpty()) {
+        return (a.IsEmpty() || b.IsEmpty()) && a.bounded && b.bounded ? ValueRange::Empty() : ValueRange::Unbounded();
+    }
+    switch (op) {
+    case glslang::EOpAdd:
+    case glslang::EOpAddAssign:
+        return ValueRange::Between(a.low + b.low, a.high + b.high);
+    case glslang::EOpSub:
+    case glslang::EOpSubAssign:
+        return ValueRange::Between(a.low - b.high, a.high - b.low);
+    case glslang::EOpMul:
+    case glslang::EOpMulAssign:
+    case glslang::EOpVectorTimesScalar:
+    case glslang::EOpVectorTimesScalarAssign:
+    case glslang::EOpMatrixTimesScalar:
+    case glslang::EOpMatrixTimesScalarAssign: {
+        double products[4] = {a.low * b.low, a.low * b.high, a.high * b.low, a.high * b.high};
+        return ValueRange::Between(*std::min_element(products, products + 4), *std::max_element(products, products + 4));
+    }
+    case glslang::EOpDiv:
+    case glslang::EOpDivAssign:
+        if (b.low > 0.0 || b.high < 0.0) {
+            double quotients[4] = {a.low / b.low, a.low / b.high, a.high / b.low, a.high / b.high};
+            return ValueRange::Between(*std::min_element(quotients, quotients + 4), *std::max_element(quotients, quotients + 4));
+        }
+        return ValueRange::Unbounded();
+    default:
+        return ValueRange::Unbounded();
+    }
+}
+
+static std::string FormatRangeBound(double value) {
+    char buffer[32];
+    snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
+}
+
+static std::string GlslTypeName(const glslang::TType& type) {
+    if (type.isMatrix()) {
+        int columns = type.getMatrixCols();
+        int rows = type.getMatrixRows();
+        return (columns == rows) ? "mat" + std::to_string(columns) : "mat" + std::to_string(columns) + "x" + std::to_string(rows);
+    }
+    if (type.isVector()) {
+        return "vec" + std::to_string(type.getVectorSize());
+    }
+    return "float";
+}
+
+// Works out which highp variables of a GLES fragment shader can be mediump, from
+// the range of their values and from what their values flow into.
+class PrecisionAnalysis {
+public:
+    PrecisionAnalysis(int max_texture_size, bool mediump_outputs)
+        : small_textures(max_texture_size > 0 && max_texture_size <= MEDIUMP_TEXTURE_SIZE), max_texture_size(max_texture_size), mediump_outputs(mediump_outputs) {}
+
+    void Run(glslang::TIntermNode* root, rgsl_glslang_mediump_callback callback, void* user) {
+        for (int pass = 0; ; pass++) {
+            changed = false;
+            widening = pass >= RANGE_WIDENING_PASS;
+            for (auto& entry : variables) {
+                entry.second.sinks.clear();
+            }
+            Walk(root, Sink{SINK_NONE, 0});
+            if (!changed) {
+                break;
+            }
+        }
+        Decide();
+        std::vector<const Variable*> demoted;
+        for (const auto& entry : variables) {
+            if (entry.second.mediump) {
+                demoted.push_back(&entry.second);
+            }
+        }
+        std::sort(demoted.begin(), demoted.end(), [](const Variable* a, const Variable* b) { return a->line < b->line; });
+        for (const Variable* variable : demoted) {
+            callback(variable->name.c_str(), variable->type.c_str(), variable->line, variable->reason.c_str(), user);
+        }
+    }
+
+private:
+    enum SinkKind {
+        SINK_NONE,          // Discarded, or only compared.
+        SINK_VARIABLE,      // Assigned to a variable.
+        SINK_COORDINATE,    // Texture coordinate.
+        SINK_PRECISE        // Index, divisor, derivative, function argument...
+    };
+
+    struct Sink {
+        SinkKind kind;
+        long long variable;
+    };
+
+    enum VariableKind {
+        VARIABLE_LOCAL,
+        VARIABLE_INPUT,
+        VARIABLE_OUTPUT
+    };
+
+    struct Variable {
+        std::string name;
+        std::string type;
+        VariableKind kind;
+        int line;
+        ValueRange range;
+        std::vector<Sink> sinks;
+        bool mediump;
+        std::string reason;
+    };
+
+    // Float variables of the shader that are highp and may be declared otherwise.
+    Variable* Track(glslang::TIntermSymbol* symbol) {
+        auto found = variables.find(symbol->getId());
+        if (found != variables.end()) {
+            found->second.line = std::min(found->second.line, symbol->getLoc().line);
+            return &found->second;
+        }
+        const glslang::TQualifier& qualifier = symbol->getQualifier();
+        if (symbol->getBasicType() != glslang::EbtFloat || qualifier.precision != glslang::EpqHigh
+            || strncmp(symbol->getName().c_str(), "gl_", 3) == 0) {
+            return nullptr;
+        }
+        VariableKind kind;
+        switch (qualifier.storage) {
+        case glslang::EvqTemporary:
+            kind = VARIABLE_LOCAL;
+            break;
+        case glslang::EvqVaryingIn:
+            kind = VARIABLE_INPUT;
+            break;
+        case glslang::EvqVaryingOut:
+            kind = VARIABLE_OUTPUT;
+            break;
+        default:
+            return nullptr;
+        }
+        Variable variable;
+        variable.name = symbol->getName().c_str();
+        variable.type = GlslTypeName(symbol->getType());
+        variable.kind = kind;
+        variable.line = symbol->getLoc().line;
+        variable.range = (kind == VARIABLE_INPUT) ? ValueRange::Unbounded() : ValueRange::Empty();
+        variable.mediump = false;
+        return &(variables[symbol->getId()] = variable);
+    }
+
+    ValueRange Evaluate(glslang::TIntermNode* node) const {
+        if (glslang::TIntermConstantUnion* constant = node->getAsConstantUnion()) {
+            const glslang::TConstUnionArray& values = constant->getConstArray();
+            ValueRange range = ValueRange::Empty();
+            for (int i = 0; i < values.size(); i++) {
+                double value;
+                switch (values[i].getType()) {
+                case glslang::EbtFloat: case glslang::EbtDouble: value = values[i].getDConst(); break;
+                case glslang::EbtInt: value = values[i].getIConst(); break;
+                case glslang::EbtUint: value = values[i].getUConst(); break;
+                case glslang::EbtBool: value = values[i].getBConst() ? 1.0 : 0.0; break;
+                default: return ValueRange::Unbounded();
+                }
+                range = ValueRange::Between(std::min(range.low, value), std::max(range.high, value));
+            }
+            return range;
+        }
+        if (glslang::TIntermSymbol* symbol = node->getAsSymbolNode()) {
+            auto found = variables.find(symbol->getId());
+            return (found != variables.end()) ? found->second.range : ValueRange::Unbounded();
+        }
+        if (glslang::TIntermBinary* binary = node->getAsBinaryNode()) {
+            switch (binary->getOp()) {
+            case glslang::EOpIndexDirect:
+            case glslang::EOpIndexIndirect:
+            case glslang::EOpVectorSwizzle:
+                return Evaluate(binary->getLeft());
+            default:
+                return binary->modifiesState() ? ValueRange::Unbounded() : Combine(binary->getOp(), Evaluate(binary->getLeft()), Evaluate(binary->getRight()));
+            }
+        }
+        if (glslang::TIntermUnary* unary = node->getAsUnaryNode()) {
+            ValueRange operand = Evaluate(unary->getOperand());
+            switch (unary->getOp()) {
+            case glslang::EOpNegative:
+                return operand.bounded ? ValueRange::Between(-operand.high, -operand.low) : operand;
+            case glslang::EOpAbs:
+                return operand.bounded ? ValueRange::Between(0.0, std::max(std::fabs(operand.low), std::fabs(operand.high))) : operand;
+            case glslang::EOpFloor:
+            case glslang::EOpCeil:
+            case glslang::EOpRound:
+            case glslang::EOpTrunc:
+                return operand.bounded ? ValueRange::Between(std::floor(operand.low), std::ceil(operand.high)) : operand;
+            case glslang::EOpFract:
+                return ValueRange::Between(0.0, 1.0);
+            case glslang::EOpSin:
+            case glslang::EOpCos:
+            case glslang::EOpNormalize:
+            case glslang::EOpSign:
+                return ValueRange::Between(-1.0, 1.0);
+            default:
+                return ValueRange::Unbounded();
+            }
+        }
+        if (glslang::TIntermAggregate* aggregate = node->getAsAggregate()) {
+            const glslang::TIntermSequence& arguments = aggregate->getSequence();
+            glslang::TOperator op = aggregate->getOp();
+            if (op > glslang::EOpConstructGuardStart && op < glslang::EOpConstructGuardEnd) {
+                ValueRange range = ValueRange::Empty();
+                for (glslang::TIntermNode* argument : arguments) {
+                    range = Hull(range, Evaluate(argument));
+                }
+                return range;
+            }
+            if ((op > glslang::EOpTextureGuardBegin && op < glslang::EOpTextureGuardEnd) || op == glslang::EOpImageLoad) {
+                return SampledRange(aggregate);
+            }
+            switch (op) {
+            case glslang::EOpStep:
+            case glslang::EOpSmoothStep:
+                return ValueRange::Between(0.0, 1.0);
+            case glslang::EOpClamp: {
+                ValueRange low = Evaluate(arguments[1]);
+                ValueRange high = Evaluate(arguments[2]);
+                return (low.bounded && high.bounded) ? ValueRange::Between(low.low, high.high) : ValueRange::Unbounded();
+            }
+            case glslang::EOpMin:
+            case glslang::EOpMax: {
+                ValueRange a = Evaluate(arguments[0]);
+                ValueRange b = Evaluate(arguments[1]);
+                if (!a.bounded || !b.bounded) {
+                    return ValueRange::Unbounded();
+                }
+                return (op == glslang::EOpMin) ? ValueRange::Between(std::min(a.low, b.low), std::min(a.high, b.high))
+                                               : ValueRange::Between(std::max(a.low, b.low), std::max(a.high, b.high));
+            }
+            case glslang::EOpMix: {
+                ValueRange weight = Evaluate(arguments[2]);
+                if (!weight.bounded || weight.low < 0.0 || weight.high > 1.0) {
+                    return ValueRange::Unbounded();
+                }
+                return Hull(Evaluate(arguments[0]), Evaluate(arguments[1]));
+            }
+            default:
+                return ValueRange::Unbounded();
+            }
+        }
+        if (glslang::TIntermSelection* selection = node->getAsSelectionNode()) {
+            if (selection->getTrueBlock() != nullptr && selection->getFalseBlock() != nullptr) {
+                return Hull(Evaluate(selection->getTrueBlock()), Evaluate(selection->getFalseBlock()));
+            }
+        }
+        return ValueRange::Unbounded();
+    }
+
+    // Float textures may hold anything (HDR colors, depths, data), only the sampler proves a range:
+    // comparisons with a shadow sampler return [0, 1], images declare their normalized format.
+    static ValueRange SampledRange(glslang::TIntermAggregate* aggregate) {
+        const glslang::TIntermSequence& arguments = aggregate->getSequence();
+        glslang::TIntermTyped* sampler = arguments.empty() ? nullptr : arguments[0]->getAsTyped();
+        if (aggregate->getBasicType() != glslang::EbtFloat || sampler == nullptr || sampler->getBasicType() != glslang::EbtSampler) {
+            return ValueRange::Unbounded();
+        }
+        const glslang::TType& type = sampler->getType();
+        if (type.getSampler().isShadow()) {
+            return ValueRange::Between(0.0, 1.0);
+        }
+        if (type.getSampler().isImage()) {
+            switch (type.getQualifier().layoutFormat) {
+            case glslang::ElfRgba16: case glslang::ElfRgb10A2: case glslang::ElfRgba8:
+            case glslang::ElfRg16: case glslang::ElfRg8: case glslang::ElfR16: case glslang::ElfR8:
+                return ValueRange::Between(0.0, 1.0);
+            case glslang::ElfRgba16Snorm: case glslang::ElfRgba8Snorm: case glslang::ElfRg16Snorm:
+            case glslang::ElfRg8Snorm: case glslang::ElfR16Snorm: case glslang::ElfR8Snorm:
+                return ValueRange::Between(-1.0, 1.0);
+            default:
+                break;
+            }
+        }
+        return ValueRange::Unbounded();
+    }
+
+    static bool WithinMediump(const ValueRange& range) {
+        return range.bounded && !range.IsEmpty() && std::fabs(range.low) <= MEDIUMP_MAX && std::fabs(range.high) <= MEDIUMP_MAX;
+    }
+
+    void Use(glslang::TIntermSymbol* symbol, Sink sink) {
+        Variable* variable = Track(symbol);
+        if (variable != nullptr && sink.kind != SINK_NONE) {
+            variable->sinks.push_back(sink);
+        }
+    }
+
+    void Assign(glslang::TIntermSymbol* symbol, const ValueRange& value) {
+        Variable* variable = (symbol != nullptr) ? Track(symbol) : nullptr;
+        if (variable == nullptr) {
+            return;
+        }
+        ValueRange range = variable->range.IsEmpty() ? value : (value.IsEmpty() ? variable->range : Hull(variable->range, value));
+        if (range != variable->range) {
+            // A range still growing after a few passes is given up, which ends the iteration.
+            variable->range = widening ? ValueRange::Unbounded() : range;
+            changed = true;
+        }
+    }
+
+    // Variable written by an assignment, after walking the indices of its target.
+    glslang::TIntermSymbol* Target(glslang::TIntermTyped* node) {
+        while (glslang::TIntermBinary* binary = node->getAsBinaryNode()) {
+            if (binary->getOp() == glslang::EOpIndexIndirect) {
+                Walk(binary->getRight(), Sink{SINK_PRECISE, 0});
+            }
+            node = binary->getLeft();
+        }
+        return node->getAsSymbolNode();
+    }
+
+    // The sink of the operands of an operation producing a value of the given type.
+    static Sink OperandSink(glslang::TBasicType type, Sink sink) {
+        switch (type) {
+        case glslang::EbtFloat:
+            return sink;
+        case glslang::EbtBool:
+        case glslang::EbtVoid:
+            return Sink{SINK_NONE, 0};
+        default:
+            return Sink{SINK_PRECISE, 0};
+        }
+    }
+
+    void Walk(glslang::TIntermNode* node, Sink sink) {
+        if (node == nullptr || node->getAsConstantUnion() != nullptr) {
+            return;
+        }
+        if (glslang::TIntermSymbol* symbol = node->getAsSymbolNode()) {
+            Use(symbol, sink);
+            return;
+        }
+        if (glslang::TIntermBinary* binary = node->getAsBinaryNode()) {
+            if (binary->modifiesState()) {
+                glslang::TIntermSymbol* target = Target(binary->getLeft());
+                ValueRange value = (binary->getOp() == glslang::EOpAssign)
+                    ? Evaluate(binary->getRight())
+                    : Combine(binary->getOp(), Evaluate(binary->getLeft()), Evaluate(binary->getRight()));
+                Walk(binary->getRight(), (target != nullptr) ? Sink{SINK_VARIABLE, target->getId()} : Sink{SINK_PRECISE, 0});
+                Assign(target, value);
+                return;
+            }
+            switch (binary->getOp()) {
+            case glslang::EOpIndexDirect:
+            case glslang::EOpIndexDirectStruct:
+            case glslang::EOpVectorSwizzle:
+                Walk(binary->getLeft(), sink);
+                return;
+            case glslang::EOpIndexIndirect:
+            case glslang::EOpDiv:
+                // A divisor scales the error of the quotient, like an index picks a value.
+                Walk(binary->getLeft(), sink);
+                Walk(binary->getRight(), Sink{SINK_PRECISE, 0});
+                return;
+            default:
+                Walk(binary->getLeft(), OperandSink(binary->getBasicType(), sink));
+                Walk(binary->getRight(), OperandSink(binary->getBasicType(), sink));
+                return;
+            }
+        }
+        if (glslang::TIntermUnary* unary = node->getAsUnaryNode()) {
+            if (unary->modifiesState()) {
+                // Increments have no range to speak of.
+                Assign(Target(unary->getOperand()), ValueRange::Unbounded());
+                return;
+            }
+            Walk(unary->getOperand(), IsDerivative(unary->getOp()) ? Sink{SINK_PRECISE, 0} : OperandSink(unary->getBasicType(), sink));
+            return;
+        }
+        if (glslang::TIntermAggregate* aggregate = node->getAsAggregate()) {
+            WalkAggregate(aggregate, sink);
+            return;
+        }
+        if (glslang::TIntermSelection* selection = node->getAsSelectionNode()) {
+            Walk(selection->getCondition(), Sink{SINK_NONE, 0});
+            Sink branch_sink = (selection->getBasicType() == glslang::EbtVoid) ? Sink{SINK_NONE, 0} : sink;
+            Walk(selection->getTrueBlock(), branch_sink);
+            Walk(selection->getFalseBlock(), branch_sink);
+            return;
+        }
+        if (glslang::TIntermSwitch* node_switch = node->getAsSwitchNode()) {
+            Walk(node_switch->getCondition(), Sink{SINK_NONE, 0});
+            Walk(node_switch->getBody(), Sink{SINK_NONE, 0});
+            return;
+        }
+        if (glslang::TIntermLoop* loop = node->getAsLoopNode()) {
+            Walk(loop->getTest(), Sink{SINK_NONE, 0});
+            Walk(loop->getBody(), Sink{SINK_NONE, 0});
+            Walk(loop->getTerminal(), Sink{SINK_NONE, 0});
+            return;
+        }
+        if (glslang::TIntermBranch* branch = node->getAsBranchNode()) {
+            // Values returned by helper functions go wherever their callers use them.
+            Walk(branch->getExpression(), in_main ? Sink{SINK_NONE, 0} : Sink{SINK_PRECISE, 0});
+        }
+    }
+
+    void WalkAggregate(glslang::TIntermAggregate* aggregate, Sink sink) {
+        const glslang::TIntermSequence& arguments = aggregate->getSequence();
+        glslang::TOperator op = aggregate->getOp();
+        switch (op) {
+        case glslang::EOpParameters:
+            return;
+        case glslang::EOpFunction:
+            in_main = strncmp(aggregate->getName().c_str(), "main(", 5) == 0;
+            for (glslang::TIntermNode* child : arguments) {
+                Walk(child, Sink{SINK_NONE, 0});
+            }
+            return;
+        case glslang::EOpSequence:
+        case glslang::EOpLinkerObjects:
+            for (glslang::TIntermNode* child : arguments) {
+                Walk(child, Sink{SINK_NONE, 0});
+            }
+            return;
+        case glslang::EOpComma:
+            for (size_t i = 0; i < arguments.size(); i++) {
+                Walk(arguments[i], (i + 1 == arguments.size()) ? sink : Sink{SINK_NONE, 0});
+            }
+            return;
+        case glslang::EOpFunctionCall:
+            for (size_t i = 0; i < arguments.size(); i++) {
+                glslang::TStorageQualifier storage = aggregate->getQualifierList().empty() ? glslang::EvqIn : aggregate->getQualifierList()[i];
+                if (storage == glslang::EvqOut || storage == glslang::EvqInOut) {
+                    Assign(Target(arguments[i]->getAsTyped()), ValueRange::Unbounded());
+                }
+                Walk(arguments[i], Sink{SINK_PRECISE, 0});
+            }
+            return;
+        default:
+            break;
+        }
+        if (op > glslang::EOpTextureGuardBegin && op < glslang::EOpTextureGuardEnd) {
+            for (size_t i = 0; i < arguments.size(); i++) {
+                Walk(arguments[i], (i == 0) ? Sink{SINK_NONE, 0} : (i == 1) ? Sink{SINK_COORDINATE, 0} : Sink{SINK_PRECISE, 0});
+            }
+            return;
+        }
+        Sink operand_sink = IsDerivative(op) ? Sink{SINK_PRECISE, 0} : OperandSink(aggregate->getBasicType(), sink);
+        for (glslang::TIntermNode* child : arguments) {
+            Walk(child, operand_sink);
+        }
+    }
+
+    void Decide() {
+        for (auto& entry : variables) {
+            Variable& variable = entry.second;
+            switch (variable.kind) {
+            case VARIABLE_OUTPUT:
+                // Float, depth or velocity targets keep every bit of their outputs, only 8-bit targets do not.
+                if (WithinMediump(variable.range)) {
+                    variable.mediump = true;
+                    variable.reason = "output holding values within [" + FormatRangeBound(variable.range.low) + ", " + FormatRangeBound(variable.range.high) + "]";
+                } else {
+                    variable.mediump = mediump_outputs;
+                    variable.reason = "color output, stored in a render target of at most 8 bits per channel";
+                }
+                break;
+            case VARIABLE_LOCAL:
+                variable.mediump = WithinMediump(variable.range);
+                variable.reason = "holds values within [" + FormatRangeBound(variable.range.low) + ", " + FormatRangeBound(variable.range.high) + "]";
+                break;
+            case VARIABLE_INPUT: {
+                bool coordinate = false;
+                variable.mediump = !variable.sinks.empty();
+                for (const Sink& sink : variable.sinks) {
+                    coordinate |= sink.kind == SINK_COORDINATE;
+                }
+                if (coordinate) {
+                    variable.mediump = small_textures;
+                    variable.reason = "texture coordinate of textures of at most " + std::to_string(max_texture_size) + " texels";
+                } else {
+                    variable.reason = "only used to compute colors";
+                }
+                break;
+            }
+            }
+        }
+        // Values flowing into a variable kept highp, or into precise uses, stay highp.
+        for (bool removed = true; removed; ) {
+            removed = false;
+            for (auto& entry : variables) {
+                Variable& variable = entry.second;
+                if (!variable.mediump || variable.kind == VARIABLE_OUTPUT) {
+                    continue;
+                }
+                for (const Sink& sink : variable.sinks) {
+                    bool safe = (sink.kind == SINK_VARIABLE) ? variables.count(sink.variable) != 0 && variables[sink.variable].mediump
+                              : (sink.kind == SINK_COORDINATE) ? variable.kind == VARIABLE_INPUT && small_textures
+                              : false;
+                    if (!safe) {
+                        variable.mediump = false;
+                        removed = true;
+                        break;
+                    }
+                }
+            }
+        }
+    }
+
+    bool small_textures;
+    int max_texture_size;
+    bool mediump_outputs;
+    std::map<long long, Variable> variables;
+    bool changed = false;
+    bool widening = false;
+    bool in_main = false;
+};
+
+bool rgsl_glslang_find_mediump_variables(const struct rgsl_glslang_program* program, int max_texture_size, bool mediump_outputs, rgsl_glslang_mediump_callback callback, void* user) {
+    GlslangPhase phase;
+    glslang::TIntermediate* intermediate = program->program.getIntermediate(program->stage);
+    if (program->stage != EShLangFragment || intermediate == nullptr || intermediate->getProfile() != EEsProfile || intermediate->getTreeRoot() == nullptr) {
+        return false;
+    }
+    PrecisionAnalysis analysis(max_texture_size, mediump_outputs);
+    analysis.Run(intermediate->getTreeRoot(), callback, user);
+    return true;
+}
+
+void rgsl_glslang_destroy_program(struct rgsl_glslang_program* program) {
+    GlslangPhase phase;
+    delete program;
+}
+
 void rgsl_glslang_free_result(struct rgsl_glslang_result* r) {
-    free((void*)r->words);
-    free((void*)r->log);
+    rgsl_free((void*)r->words);
+    rgsl_free((void*)r->log);
 }
@@ -1,8 +1,15 @@
 #include <RGSL/fileio.h>
+#include <RGSL/memory.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#endif
+
 size_t rgsl_read_file(const char* filename, char **out_buffer) {
     FILE *file;
     fopen_s(&file, filename, "rb");
@@ -12,7 +19,7 @@ size_t rgsl_read_file(const char* filename, char **out_buffer) {
     fseek(file, 0, SEEK_END);
     size_t file_size = ftell(file);
     fseek(file, 0, SEEK_SET);
-    *out_buffer = (char *)malloc((file_size + 1) * sizeof(char));
+    *out_buffer = (char *)rgsl_malloc((file_size + 1) * sizeof(char));
     if (*out_buffer == NULL) {
         fclose(file);
         return 0;
@@ -42,9 +49,26 @@ bool rgsl_write_file(const char* filename, const char* buffer, size_t size) {
     return valid;
 }
 
+bool rgsl_write_file_if_changed(const char* filename, const char* buffer, size_t size, bool* out_written) {
+    if (size == 0) {
+        size = strlen(buffer);
+    }
+    char* existing = NULL;
+    size_t existing_size = rgsl_read_file(filename, &existing);
+    bool unchanged = existing != NULL && existing_size == size && memcmp(existing, buffer, size) == 0;
+    rgsl_free(existing);
+    if (out_written != NULL) {
+        *out_written = !unchanged;
+    }
+    if (unchanged) {
+        return true;
+    }
+    return rgsl_write_file(filename, buffer, size);
+}
+
 char *rgsl_crlf_to_lf(const char* str) {
     size_t len = strlen(str);
-    char *buffer = (char *)malloc(len + 1);
+    char *buffer = (char *)rgsl_malloc(len + 1);
     if (!buffer) {
         return NULL;
     }
@@ -58,12 +82,12 @@ char *rgsl_crlf_to_lf(const char* str) {
         }
     }
     buffer[j] = '\0';
-    buffer = (char *)realloc(buffer, j + 1);
+    buffer = (char *)rgsl_realloc(buffer, j + 1);
     return buffer;
 }
 
 void rgsl_free_file_buffer(char* buffer) {
-    free(buffer);
+    rgsl_free(buffer);
 }
 
 bool rgsl_file_exists(const char* filename) {
@@ -74,4 +98,43 @@ bool rgsl_file_exists(const char* filename) {
         return true;
     }
     return false;
+}
+
+bool rgsl_list_directory(const char* path, void (*callback)(const char* entry, bool is_directory, void* user), void* user) {
+#ifdef _WIN32
+    size_t pattern_length = strlen(path) + 3;
+    char *pattern = (char *)rgsl_malloc(pattern_length);
+    snprintf(pattern, pattern_length, "%s\\*", path);
+    WIN32_FIND_DATAA find_data;
+    HANDLE handle = FindFirstFileA(pattern, &find_data);
+    rgsl_free(pattern);
+    if (handle == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+    do {
+        if (strcmp(find_data.cFileName, ".") == 0 || strcmp(find_data.cFileName, "..") == 0) {
+            continue;
+        }
+        callback(find_data.cFileName, (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0, user);
+    } while (FindNextFileA(handle, &find_data));
+    FindClose(handle);
+#else
+    DIR *directory = opendir(path);
+    if (directory == NULL) {
+        return false;
+    }
+    struct dirent *entry;
+    while ((entry = readdir(directory)) != NULL) {
+        if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) {
+            continue;
+        }
+#ifdef DT_DIR
+        callback(entry->d_name, entry->d_type == DT_DIR, user);
+#else
+        callback(entry->d_name, false, user);
+#endif
+    }
+    closedir(directory);
+#endif
+    return true;
 }
\ No newline at end of file
@@ -0,0 +1,651 @@
+#include <RGSL/glsl/buffers.h>
+#include <RGSL/parser.h>
+#include <RGSL/layout.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/termio.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// No packing qualifier: shared or packed, laid out by the implementation.
+#define RGSL_NO_PACKING -1
+
+static const char* const PRECISION_QUALIFIERS[] = {"lowp", "mediump", "highp"};
+
+// Qualifiers of block members and blocks with no effect on their layout.
+static const char* const MEMORY_QUALIFIERS[] = {"readonly", "writeonly", "coherent", "volatile", "restrict"};
+
+/**
+ * Token of the processed code, with the 0-based index of its line.
+ */
+struct rgsl_token {
+    const char* start;
+    size_t length;
+    size_t line;
+};
+
+/**
+ * Member of a declaration, as written, and the lines of its declaration.
+ */
+struct rgsl_member_declaration {
+    const struct rgsl_token* name;
+    const struct rgsl_glsl_type* type;
+    struct rgsl_declaration* structure;
+    const char* precision;
+    uint32_t array_size;
+    size_t first_line;
+    size_t last_line;
+};
+
+/**
+ * Structure or block declared at file scope, and its layouts in each packing it is used with,
+ * with the first block using it in each.
+ * Movable declarations have one member per declaration, on lines of their own.
+ */
+struct rgsl_declaration {
+    const struct rgsl_token* name;
+    enum rgsl_layout_kind kind;
+    int packing;
+    struct rgsl_member_declaration* members;
+    size_t member_count;
+    size_t open_line;
+    bool supported;
+    bool movable;
+    bool used[2];
+    const struct rgsl_declaration* users[2];
+    struct rgsl_block_layout* layouts[2];
+};
+
+struct rgsl_layout_parser {
+    struct rgsl_token* tokens;
+    size_t count;
+    size_t capacity;
+    size_t position;
+    struct rgsl_hashmap constants;
+    struct rgsl_declaration** declarations;
+    size_t declaration_count;
+};
+
+bool rgsl_buffer_layouts_enabled() {
+    return rgsl_global_options.layout_report != 0 || rgsl_global_options.layout_reorder != 0;
+}
+
+static bool rgsl_token_is(const struct rgsl_token* token, const char* text) {
+    return token != NULL && strlen(text) == token->length && strncmp(token->start, text, token->length) == 0;
+}
+
+static bool rgsl_token_is_identifier(const struct rgsl_token* token) {
+    return token != NULL && (isalpha((unsigned char)token->start[0]) || token->start[0] == '_');
+}
+
+static bool rgsl_token_in(const struct rgsl_token* token, const char* const* words, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        if (rgsl_token_is(token, words[i])) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static const struct rgsl_token* rgsl_peek(const struct rgsl_layout_parser* parser, size_t offset) {
+    return parser->position + offset < parser->count ? &parser->tokens[parser->position + offset] : NULL;
+}
+
+static void rgsl_add_token(struct rgsl_layout_parser* parser, const char* start, size_t length, size_t line) {
+    if (parser->count == parser->capacity) {
+        parser->capacity = parser->capacity ? parser->capacity * 2 : 256;
+        parser->tokens = (struct rgsl_token *)rgsl_realloc(parser->tokens, parser->capacity * sizeof(struct rgsl_token));
+    }
+    parser->tokens[parser->count].start = start;
+    parser->tokens[parser->count].length = length;
+    parser->tokens[parser->count].line = line;
+    parser->count++;
+}
+
+static bool rgsl_parse_integer(const char* start, size_t length, uint32_t* out_value) {
+    char literal[32];
+    if (length == 0 || length >= sizeof(literal) || !isdigit((unsigned char)start[0])) {
+        return false;
+    }
+    memcpy(literal, start, length);
+    literal[length] = '\0';
+    char* end = NULL;
+    unsigned long value = strtoul(literal, &end, 0);
+    if (*end == 'u' || *end == 'U') {
+        end++;
+    }
+    *out_value = (uint32_t)value;
+    return *end == '\0';
+}
+
+static void rgsl_set_constant(struct rgsl_layout_parser* parser, const char* name, size_t length, uint32_t value) {
+    char* key = (char *)rgsl_malloc(length + 1);
+    memcpy(key, name, length);
+    key[length] = '\0';
+    rgsl_hashmap_set(&parser->constants, key, (void *)(uintptr_t)value);
+    rgsl_free(key);
+}
+
+// Keeps the value of "#define NAME <integer>", which array sizes may use.
+static void rgsl_scan_define(struct rgsl_layout_parser* parser, const char* c, const char* end) {
+    while (c < end && (*c == ' ' || *c == '\t')) {
+        c++;
+    }
+    if (end - c < 7 || strncmp(c, "define", 6) != 0 || (c[6] != ' ' && c[6] != '\t')) {
+        return;
+    }
+    c += 6;
+    while (c < end && (*c == ' ' || *c == '\t')) {
+        c++;
+    }
+    const char* name = c;
+    while (c < end && (isalnum((unsigned char)*c) || *c == '_')) {
+        c++;
+    }
+    size_t name_length = (size_t)(c - name);
+    while (c < end && (*c == ' ' || *c == '\t')) {
+        c++;
+    }
+    const char* value = c;
+    while (c < end && isalnum((unsigned char)*c)) {
+        c++;
+    }
+    uint32_t number;
+    const char* rest = c;
+    while (rest < end && (*rest == ' ' || *rest == '\t' || *rest == '\r')) {
+        rest++;
+    }
+    bool comment = end - rest >= 2 && rest[0] == '/' && (rest[1] == '/' || rest[1] == '*');
+    if (name_length > 0 && value > name + name_length && (rest == end || comment) && rgsl_parse_integer(value, (size_t)(c - value), &number)) {
+        rgsl_set_constant(parser, name, name_length, number);
+    }
+}
+
+static void rgsl_tokenize(struct rgsl_layout_parser* parser, const char* code) {
+    size_t line = 0;
+    bool line_start = true;
+    for (const char* c = code; *c != '\0'; ) {
+        if (*c == '\n') {
+            line++;
+            line_start = true;
+            c++;
+        } else if (*c == ' ' || *c == '\t' || *c == '\r') {
+            c++;
+        } else if (c[0] == '/' && c[1] == '/') {
+            while (*c != '\0' && *c != '\n') {
+                c++;
+            }
+        } else if (c[0] == '/' && c[1] == '*') {
+            c += 2;
+            while (*c != '\0' && !(c[0] == '*' && c[1] == '/')) {
+                line += (*c == '\n');
+                c++;
+            }
+            c += (*c != '\0') ? 2 : 0;
+        } else if (*c == '#' && line_start) {
+            // Directives declare nothing, only the values of their integer macros are kept.
+            const char* end = c + 1;
+            while (*end != '\0' && (*end != '\n' || end[-1] == '\\')) {
+                line += (*end == '\n');
+                end++;
+            }
+            rgsl_scan_define(parser, c + 1, end);
+            c = end;
+        } else {
+            size_t length = 1;
+            if (isalpha((unsigned char)*c) || *c == '_') {
+                while (isalnum((unsigned char)c[length]) || c[length] == '_') {
+                    length++;
+                }
+            } else if (isdigit((unsigned char)*c)) {
+                while (isalnum((unsigned char)c[length]) || c[length] == '.') {
+                    length++;
+                }
+            }
+            rgsl_add_token(parser, c, length, line);
+            line_start = false;
+            c += length;
+        }
+    }
+}
+
+static bool rgsl_token_value(const struct rgsl_layout_parser* parser, const struct rgsl_token* token, uint32_t* out_value) {
+    if (token == NULL) {
+        return false;
+    }
+    if (rgsl_parse_integer(token->start, token->length, out_value)) {
+        return true;
+    }
+    if (!rgsl_token_is_identifier(token)) {
+        return false;
+    }
+    char* key = (char *)rgsl_malloc(token->length + 1);
+    memcpy(key, token->start, token->length);
+    key[token->length] = '\0';
+    void* value = NULL;
+    bool found = rgsl_hashmap_find(&parser->constants, key, &value);
+    rgsl_free(key);
+    *out_value = (uint32_t)(uintptr_t)value;
+    return found;
+}
+
+static struct rgsl_declaration* rgsl_find_structure(const struct rgsl_layout_parser* parser, const struct rgsl_token* name) {
+    for (size_t i = 0; i < parser->declaration_count; i++) {
+        struct rgsl_declaration* declaration = parser->declarations[i];
+        if (declaration->kind == RGSL_LAYOUT_STRUCT && declaration->name->length == name->length
+            && strncmp(declaration->name->start, name->start, name->length) == 0) {
+            return declaration;
+        }
+    }
+    return NULL;
+}
+
+// Parses "[N]" or "[]" after a name, the size being 0 without brackets and RGSL_RUNTIME_ARRAY for "[]".
+static bool rgsl_parse_array_size(struct rgsl_layout_parser* parser, uint32_t* out_size) {
+    *out_size = 0;
+    if (!rgsl_token_is(rgsl_peek(parser, 0), "[")) {
+        return true;
+    }
+    if (rgsl_token_is(rgsl_peek(parser, 1), "]")) {
+        *out_size = RGSL_RUNTIME_ARRAY;
+        parser->position += 2;
+    } else if (rgsl_token_value(parser, rgsl_peek(parser, 1), out_size) && *out_size > 0 && rgsl_token_is(rgsl_peek(parser, 2), "]")) {
+        parser->position += 3;
+    } else {
+        return false;
+    }
+    // Arrays of arrays are not laid out.
+    return !rgsl_token_is(rgsl_peek(parser, 0), "[");
+}
+
+static bool rgsl_parse_member_declaration(struct rgsl_layout_parser* parser, struct rgsl_declaration* declaration, size_t end) {
+    size_t first = parser->position;
+    const char* precision = NULL;
+    while (parser->position < end) {
+        const struct rgsl_token* token = rgsl_peek(parser, 0);
+        const char* found = NULL;
+        for (size_t i = 0; i < sizeof(PRECISION_QUALIFIERS) / sizeof(PRECISION_QUALIFIERS[0]); i++) {
+            found = rgsl_token_is(token, PRECISION_QUALIFIERS[i]) ? PRECISION_QUALIFIERS[i] : found;
+        }
+        if (found == NULL && !rgsl_token_in(token, MEMORY_QUALIFIERS, sizeof(MEMORY_QUALIFIERS) / sizeof(MEMORY_QUALIFIERS[0]))) {
+            break;
+        }
+        precision = found != NULL ? found : precision;
+        parser->position++;
+    }
+    // Members with a layout qualifier (offset, row_major...) or of other types are not laid out.
+    const struct rgsl_token* type_name = rgsl_peek(parser, 0);
+    if (parser->position >= end || !rgsl_token_is_identifier(type_name)) {
+        return false;
+    }
+    const struct rgsl_glsl_type* type = rgsl_find_glsl_type(type_name->start, type_name->length);
+    struct rgsl_declaration* structure = type == NULL ? rgsl_find_structure(parser, type_name) : NULL;
+    if (type == NULL && structure == NULL) {
+        return false;
+    }
+    parser->position++;
+    size_t declarator_count = 0;
+    while (true) {
+        const struct rgsl_token* name = rgsl_peek(parser, 0);
+        if (parser->position >= end || !rgsl_token_is_identifier(name)) {
+            return false;
+        }
+        parser->position++;
+        uint32_t array_size;
+        if (!rgsl_parse_array_size(parser, &array_size)) {
+            return false;
+        }
+        declaration->members = (struct rgsl_member_declaration *)rgsl_realloc(declaration->members, (declaration->member_count + 1) * sizeof(struct rgsl_member_declaration));
+        struct rgsl_member_declaration* member = &declaration->members[declaration->member_count++];
+        member->name = name;
+        member->type = type;
+        member->structure = structure;
+        member->precision = precision;
+        member->array_size = array_size;
+        member->first_line = parser->tokens[first].line;
+        declarator_count++;
+        if (rgsl_token_is(rgsl_peek(parser, 0), ";")) {
+            break;
+        }
+        if (!rgsl_token_is(rgsl_peek(parser, 0), ",")) {
+            return false;
+        }
+        parser->position++;
+    }
+    size_t last = parser->position++;
+    for (size_t i = declaration->member_count - declarator_count; i < declaration->member_count; i++) {
+        declaration->members[i].last_line = parser->tokens[last].line;
+    }
+    bool whole_lines = parser->tokens[first - 1].line < parser->tokens[first].line
+        && (last + 1 >= parser->count || parser->tokens[last + 1].line > parser->tokens[last].line);
+    declaration->movable &= whole_lines && declarator_count == 1;
+    return true;
+}
+
+// Parses the members of a declaration, from its opening brace, and leaves the parser after its closing one.
+static void rgsl_parse_members(struct rgsl_layout_parser* parser, struct rgsl_declaration* declaration) {
+    declaration->open_line = parser->tokens[parser->position].line;
+    size_t end = parser->position + 1;
+    for (int depth = 1; end < parser->count; end++) {
+        depth += rgsl_token_is(&parser->tokens[end], "{") - rgsl_token_is(&parser->tokens[end], "}");
+        if (depth == 0) {
+            break;
+        }
+    }
+    parser->position++;
+    declaration->supported = true;
+    declaration->movable = true;
+    while (declaration->supported && parser->position < end) {
+        declaration->supported = rgsl_parse_member_declaration(parser, declaration, end);
+    }
+    for (size_t i = 0; i < declaration->member_count; i++) {
+        // Only the last member of a buffer block may be a runtime array.
+        bool last_buffer_member = declaration->kind == RGSL_LAYOUT_BUFFER_BLOCK && i + 1 == declaration->member_count;
+        declaration->supported &= declaration->members[i].array_size != RGSL_RUNTIME_ARRAY || last_buffer_member;
+    }
+    declaration->supported &= declaration->member_count > 0;
+    parser->position = end + 1;
+}
+
+static struct rgsl_declaration* rgsl_add_declaration(struct rgsl_layout_parser* parser, const struct rgsl_token* name, enum rgsl_layout_kind kind, int packing) {
+    struct rgsl_declaration* declaration = (struct rgsl_declaration *)rgsl_calloc(1, sizeof(struct rgsl_declaration));
+    declaration->name = name;
+    declaration->kind = kind;
+    declaration->packing = packing;
+    parser->declarations = (struct rgsl_declaration **)rgsl_realloc(parser->declarations, (parser->declaration_count + 1) * sizeof(struct rgsl_declaration*));
+    parser->declarations[parser->declaration_count++] = declaration;
+    return declaration;
+}
+
+// Parses "layout(...) [qualifiers] uniform|buffer Name {", the parser being on "layout".
+static void rgsl_parse_block(struct rgsl_layout_parser* parser) {
+    int packing = RGSL_NO_PACKING;
+    bool row_major = false;
+    parser->position += 2;
+    while (parser->position < parser->count && !rgsl_token_is(rgsl_peek(parser, 0), ")")) {
+        const struct rgsl_token* token = rgsl_peek(parser, 0);
+        packing = rgsl_token_is(token, "std140") ? RGSL_LAYOUT_STD140 : rgsl_token_is(token, "std430") ? RGSL_LAYOUT_STD430 : packing;
+        row_major |= rgsl_token_is(token, "row_major");
+        parser->position++;
+    }
+    parser->position++;
+    while (rgsl_token_in(rgsl_peek(parser, 0), MEMORY_QUALIFIERS, sizeof(MEMORY_QUALIFIERS) / sizeof(MEMORY_QUALIFIERS[0]))) {
+        parser->position++;
+    }
+    const struct rgsl_token* storage = rgsl_peek(parser, 0);
+    bool uniform = rgsl_token_is(storage, "uniform");
+    if ((!uniform && !rgsl_token_is(storage, "buffer")) || !rgsl_token_is_identifier(rgsl_peek(parser, 1)) || !rgsl_token_is(rgsl_peek(parser, 2), "{")) {
+        return;
+    }
+    struct rgsl_declaration* declaration = rgsl_add_declaration(parser, rgsl_peek(parser, 1), uniform ? RGSL_LAYOUT_UNIFORM_BLOCK : RGSL_LAYOUT_BUFFER_BLOCK, packing);
+    parser->position += 2;
+    rgsl_parse_members(parser, declaration);
+    // Row-major matrices are laid out by rows, which the mirrors do not support.
+    declaration->supported &= !row_major;
+}
+
+static void rgsl_parse_declarations(struct rgsl_layout_parser* parser) {
+    int depth = 0;
+    while (parser->position < parser->count) {
+        const struct rgsl_token* token = rgsl_peek(parser, 0);
+        uint32_t value;
+        if (depth == 0 && rgsl_token_is(token, "struct") && rgsl_token_is_identifier(rgsl_peek(parser, 1)) && rgsl_token_is(rgsl_peek(parser, 2), "{")) {
+            struct rgsl_declaration* declaration = rgsl_add_declaration(parser, rgsl_peek(parser, 1), RGSL_LAYOUT_STRUCT, RGSL_NO_PACKING);
+            parser->position += 2;
+            rgsl_parse_members(parser, declaration);
+        } else if (depth == 0 && rgsl_token_is(token, "layout") && rgsl_token_is(rgsl_peek(parser, 1), "(")) {
+            rgsl_parse_block(parser);
+        } else if (rgsl_token_is(token, "const") && (rgsl_token_is(rgsl_peek(parser, 1), "int") || rgsl_token_is(rgsl_peek(parser, 1), "uint"))
+            && rgsl_token_is_identifier(rgsl_peek(parser, 2)) && rgsl_token_is(rgsl_peek(parser, 3), "=")
+            && rgsl_peek(parser, 4) != NULL && rgsl_parse_integer(rgsl_peek(parser, 4)->start, rgsl_peek(parser, 4)->length, &value) && rgsl_token_is(rgsl_peek(parser, 5), ";")) {
+            rgsl_set_constant(parser, rgsl_peek(parser, 2)->start, rgsl_peek(parser, 2)->length, value);
+            parser->position += 6;
+        } else {
+            depth += rgsl_token_is(token, "{") - rgsl_token_is(token, "}");
+            parser->position++;
+        }
+    }
+}
+
+static bool rgsl_declaration_supported(const struct rgsl_declaration* declaration) {
+    for (size_t i = 0; declaration->supported && i < declaration->member_count; i++) {
+        if (declaration->members[i].structure != NULL && !rgsl_declaration_supported(declaration->members[i].structure)) {
+            return false;
+        }
+    }
+    return declaration->supported;
+}
+
+static void rgsl_mark_structures(const struct rgsl_declaration* declaration, int packing, const struct rgsl_declaration* user) {
+    for (size_t i = 0; i < declaration->member_count; i++) {
+        struct rgsl_declaration* structure = declaration->members[i].structure;
+        if (structure != NULL) {
+            structure->used[packing] = true;
+            structure->users[packing] = structure->users[packing] != NULL ? structure->users[packing] : user;
+            rgsl_mark_structures(structure, packing, user);
+        }
+    }
+}
+
+static struct rgsl_block_layout* rgsl_build_layout(const struct rgsl_declaration* declaration, int packing) {
+    struct rgsl_block_layout* block = (struct rgsl_block_layout *)rgsl_calloc(1, sizeof(struct rgsl_block_layout));
+    // A structure used by blocks of both packings has a mirror for each.
+    bool both_packings = declaration->used[RGSL_LAYOUT_STD140] && declaration->used[RGSL_LAYOUT_STD430];
+    size_t length = declaration->name->length + 8;
+    block->name = (char *)rgsl_malloc(length);
+    snprintf(block->name, length, both_packings ? "%.*s_%s" : "%.*s", (int)declaration->name->length, declaration->name->start, rgsl_layout_packing_name((enum rgsl_layout_packing)packing));
+    block->kind = declaration->kind;
+    for (size_t i = 0; i < declaration->member_count; i++) {
+        const struct rgsl_member_declaration* member = &declaration->members[i];
+        const struct rgsl_block_layout* structure = member->structure != NULL ? member->structure->layouts[packing] : NULL;
+        rgsl_block_add_member(block, member->name->start, member->name->length, member->type, structure, member->precision, member->array_size);
+    }
+    return block;
+}
+
+// Tells why the members of a declaration may not be moved, or NULL if they may.
+static const char* rgsl_reorder_obstacle(const struct rgsl_layout_parser* parser, const struct rgsl_declaration* declaration) {
+    if (!declaration->movable) {
+        return "its members do not each have lines of their own";
+    }
+    if (declaration->kind != RGSL_LAYOUT_STRUCT) {
+        return NULL;
+    }
+    if (declaration->used[RGSL_LAYOUT_STD140] && declaration->used[RGSL_LAYOUT_STD430]) {
+        return "it is used by blocks of both packings";
+    }
+    for (size_t i = 0; i + 1 < parser->count; i++) {
+        const struct rgsl_token* token = &parser->tokens[i];
+        bool constructor = token->length == declaration->name->length && strncmp(token->start, declaration->name->start, token->length) == 0
+            && rgsl_token_is(&parser->tokens[i + 1], "(");
+        if (constructor || (rgsl_token_is(token, "=") && rgsl_token_is(&parser->tokens[i + 1], "{"))) {
+            return "its member order is relied on by a constructor or an initializer list";
+        }
+    }
+    return NULL;
+}
+
+// Moves the lines of the members of a declaration in the order of its layout, each with the comment lines above it.
+static void rgsl_reorder_lines(const struct rgsl_declaration* declaration, const struct rgsl_block_layout* block, size_t* order) {
+    size_t target = declaration->open_line + 1;
+    for (size_t i = 0; i < block->member_count; i++) {
+        uint32_t index = block->members[i].index;
+        size_t first = index == 0 ? declaration->open_line + 1 : declaration->members[index - 1].last_line + 1;
+        for (size_t line = first; line <= declaration->members[index].last_line; line++) {
+            order[target++] = line;
+        }
+    }
+}
+
+static void rgsl_apply_line_order(struct rgsl_shader_data* shader, const size_t* order, size_t line_count) {
+    const char** lines = (const char **)rgsl_malloc(line_count * sizeof(const char*));
+    size_t* lengths = (size_t *)rgsl_malloc(line_count * sizeof(size_t));
+    const char* line = shader->processed_code;
+    for (size_t i = 0; i < line_count; i++) {
+        lines[i] = line;
+        lengths[i] = strcspn(line, "\n");
+        line += lengths[i] + (line[lengths[i]] == '\n');
+    }
+    struct rgsl_text code = {0};
+    struct rgsl_line_origin* origins = (struct rgsl_line_origin *)rgsl_malloc(line_count * sizeof(struct rgsl_line_origin));
+    for (size_t i = 0; i < line_count; i++) {
+        rgsl_text_append(&code, lines[order[i]], lengths[order[i]]);
+        if (lines[i][lengths[i]] == '\n') {
+            rgsl_text_append(&code, "\n", 1);
+        }
+        struct rgsl_line_origin generated = {0, 0};
+        origins[i] = order[i] < shader->line_map.line_count ? shader->line_map.lines[order[i]] : generated;
+    }
+    for (size_t i = 0; i < line_count && i < shader->line_map.line_count; i++) {
+        shader->line_map.lines[i] = origins[i];
+    }
+    rgsl_free(shader->processed_code);
+    shader->processed_code = code.data;
+    rgsl_free(origins);
+    rgsl_free(lengths);
+    rgsl_free(lines);
+}
+
+static void rgsl_member_order(struct rgsl_text* output, const struct rgsl_block_layout* block) {
+    for (size_t i = 0; i < block->member_count; i++) {
+        rgsl_text_printf(output, "%s%s", i > 0 ? ", " : "", block->members[i].name);
+    }
+}
+
+static void rgsl_report_layout(const struct rgsl_block_layout* block, const struct rgsl_declaration* declaration, const char* source, int source_line) {
+    static const char* const KIND_NAMES[] = {"structure", "uniform block", "buffer block"};
+    const char* packing = rgsl_layout_packing_name(block->packing);
+    const struct rgsl_block_member* last = &block->members[block->member_count - 1];
+    if (block->kind == RGSL_LAYOUT_STRUCT) {
+        const struct rgsl_token* user = declaration->users[block->packing]->name;
+        rgsl_printf_info(1, "%s:%d: %s %s (%s, in %.*s): %u bytes per element, %u of padding\n", source, source_line, KIND_NAMES[block->kind], block->name,
+            packing, (int)user->length, user->start, block->size, block->padding);
+    } else if (last->array_size == RGSL_RUNTIME_ARRAY && block->member_count == 1) {
+        rgsl_printf_info(1, "%s:%d: %s %s (%s): %u bytes per element of %s[]\n", source, source_line, KIND_NAMES[block->kind], block->name, packing, last->stride, last->name);
+    } else if (last->array_size == RGSL_RUNTIME_ARRAY) {
+        rgsl_printf_info(1, "%s:%d: %s %s (%s): %u bytes with %u of padding, then %u bytes per element of %s[]\n", source, source_line, KIND_NAMES[block->kind],
+            block->name, packing, block->size, block->padding, last->stride, last->name);
+    } else {
+        rgsl_printf_info(1, "%s:%d: %s %s (%s): %u bytes, %u of padding\n", source, source_line, KIND_NAMES[block->kind], block->name, packing, block->size, block->padding);
+    }
+    for (size_t i = 0; i < block->member_count; i++) {
+        const struct rgsl_block_member* member = &block->members[i];
+        char array[16] = "";
+        if (member->array_size == RGSL_RUNTIME_ARRAY) {
+            snprintf(array, sizeof(array), "[]");
+        } else if (member->array_size > 0) {
+            snprintf(array, sizeof(array), "[%u]", member->array_size);
+        }
+        rgsl_printf_info(2, "    %4u: %s %s%s (%u bytes%s)\n", member->offset, member->structure != NULL ? member->structure->name : member->type->name,
+            member->name, array, member->size, member->array_size == RGSL_RUNTIME_ARRAY ? " per element" : "");
+    }
+}
+
+static void rgsl_layout_declaration(struct rgsl_shader_data* shader, const struct rgsl_layout_parser* parser, struct rgsl_declaration* declaration, int packing, size_t* order) {
+    struct rgsl_block_layout* block = rgsl_build_layout(declaration, packing);
+    rgsl_layout_block(block, (enum rgsl_layout_packing)packing, false);
+    uint32_t size = block->size;
+    rgsl_layout_block(block, (enum rgsl_layout_packing)packing, true);
+    uint32_t saving = size - block->size;
+
+    const char* source = shader->path;
+    int source_line = (int)declaration->name->line + 1;
+    if (!rgsl_line_map_lookup(&shader->line_map, source_line, &source, &source_line)) {
+        source = shader->path;
+        source_line = (int)declaration->name->line + 1;
+    }
+    struct rgsl_text members = {0};
+    rgsl_member_order(&members, block);
+    const char* obstacle = saving > 0 ? rgsl_reorder_obstacle(parser, declaration) : NULL;
+    if (saving > 0 && rgsl_global_options.layout_reorder && obstacle == NULL) {
+        rgsl_reorder_lines(declaration, block, order);
+        rgsl_report_layout(block, declaration, source, source_line);
+        rgsl_printf_info(1, "%s:%d: reordered the members of %s as {%s}, saving %u bytes\n", source, source_line, block->name, members.data, saving);
+    } else {
+        rgsl_layout_block(block, (enum rgsl_layout_packing)packing, false);
+        rgsl_report_layout(block, declaration, source, source_line);
+        if (saving > 0 && rgsl_global_options.layout_reorder) {
+            rgsl_printf_info(1, "%s:%d: ordering the members of %s as {%s} would save %u bytes, but %s\n", source, source_line, block->name, members.data, saving, obstacle);
+        } else if (saving > 0) {
+            rgsl_printf_info(1, "%s:%d: ordering the members of %s as {%s} would save %u bytes (--layout-reorder)\n", source, source_line, block->name, members.data, saving);
+        }
+    }
+    rgsl_text_free(&members);
+
+    declaration->layouts[packing] = block;
+    shader->layouts = (struct rgsl_block_layout **)rgsl_realloc(shader->layouts, (shader->layout_count + 1) * sizeof(struct rgsl_block_layout*));
+    shader->layouts[shader->layout_count++] = block;
+}
+
+static void rgsl_release_layouts(struct rgsl_shader_data* shader) {
+    for (size_t i = 0; i < shader->layout_count; i++) {
+        rgsl_block_layout_free(shader->layouts[i]);
+    }
+    rgsl_free(shader->layouts);
+    shader->layouts = NULL;
+    shader->layout_count = 0;
+}
+
+void rgsl_glsl_layout_buffers(struct rgsl_shader_data* shader) {
+    rgsl_release_layouts(shader);
+    struct rgsl_layout_parser parser = {0};
+    rgsl_hashmap_init(&parser.constants);
+    rgsl_tokenize(&parser, shader->processed_code);
+    rgsl_parse_declarations(&parser);
+
+    // Structures are laid out in the packing of the blocks using them, before them.
+    for (size_t i = 0; i < parser.declaration_count; i++) {
+        const struct rgsl_declaration* declaration = parser.declarations[i];
+        if (declaration->kind == RGSL_LAYOUT_STRUCT) {
+            continue;
+        }
+        bool packed_uniforms = shader->uniform_block != NULL && declaration->name->length == strlen(shader->uniform_block->name)
+            && strncmp(declaration->name->start, shader->uniform_block->name, declaration->name->length) == 0;
+        if (declaration->packing == RGSL_NO_PACKING) {
+            rgsl_printf_info(2, "The block %.*s of %s has no std140 or std430 layout, it is not laid out.\n", (int)declaration->name->length, declaration->name->start, shader->path);
+        } else if (!rgsl_declaration_supported(declaration)) {
+            rgsl_printf_info(2, "The block %.*s of %s has members that cannot be laid out, it is not laid out.\n", (int)declaration->name->length, declaration->name->start, shader->path);
+        } else if (!packed_uniforms) {
+            parser.declarations[i]->used[declaration->packing] = true;
+            rgsl_mark_structures(declaration, declaration->packing, declaration);
+        }
+    }
+    size_t line_count = 1;
+    for (const char* c = shader->processed_code; *c != '\0'; c++) {
+        line_count += (*c == '\n');
+    }
+    size_t* order = (size_t *)rgsl_malloc(line_count * sizeof(size_t));
+    for (size_t i = 0; i < line_count; i++) {
+        order[i] = i;
+    }
+    for (size_t i = 0; i < parser.declaration_count; i++) {
+        struct rgsl_declaration* declaration = parser.declarations[i];
+        for (int packing = RGSL_LAYOUT_STD140; packing <= RGSL_LAYOUT_STD430; packing++) {
+            if (declaration->used[packing]) {
+                rgsl_layout_declaration(shader, &parser, declaration, packing, order);
+            }
+        }
+    }
+    if (rgsl_global_options.layout_reorder) {
+        bool moved = false;
+        for (size_t i = 0; i < line_count && !moved; i++) {
+            moved = order[i] != i;
+        }
+        if (moved) {
+            rgsl_apply_line_order(shader, order, line_count);
+        }
+    }
+    rgsl_free(order);
+
+    for (size_t i = 0; i < parser.declaration_count; i++) {
+        rgsl_free(parser.declarations[i]->members);
+        rgsl_free(parser.declarations[i]);
+    }
+    rgsl_free(parser.declarations);
+    rgsl_free(parser.tokens);
+    rgsl_hashmap_free(&parser.constants, NULL);
+}
\ No newline at end of file
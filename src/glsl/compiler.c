@@ -1,13 +1,20 @@
 #include <RGSL/glsl/compile.h>
 #include <RGSL/glsl/parser.h>
+#include <RGSL/glsl/precision.h>
 #include <RGSL/termio.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
 
 bool rgsl_glsl_compile_shader(struct rgsl_shader_data * shader, char** output) {
-    rgsl_print_info(1, "Preprocessing GLSL shader code...\n");
-    *output = rgsl_parse_shader(GLSL_DIRECTIVE_MAPPINGS, shader);
-    if (*output == NULL) {
-        rgsl_print_error("Failed to preprocess GLSL shader code.\n");
+    // Text output must stand alone, so includes are only left to glslang for SPIR-V.
+    bool native_includes = rgsl_global_options.native_includes != 0 && (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV);
+    if (!rgsl_glsl_preprocess_shader(shader, native_includes)) {
+        *output = NULL;
         return false;
     }
+    *output = rgsl_strdup(shader->processed_code);
+    if (rgsl_precision_demotion_enabled() && !(rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV)) {
+        rgsl_glsl_demote_precision(shader, output);
+    }
     return true;
 }
\ No newline at end of file
@@ -1,68 +1,228 @@
 #include <RGSL/glsl/parser.h>
+#include <RGSL/glsl/uniforms.h>
+#include <RGSL/glsl/buffers.h>
 #include <RGSL/fileio.h>
+#include <RGSL/resolver.h>
 #include <RGSL/termio.h>
+#include <RGSL/clock.h>
+#include <RGSL/spec.h>
+#include <RGSL/target.h>
 #include <RGSL/rgsl.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 int rgsl_glsl_handle_include_directive(struct rgsl_parser_state* state, const char* value, void* out) {
-    // Placeholder for handling #include directive
     rgsl_printf_info(2, "Handling #include directive with value: %s\n", value);
+    if (state->native_includes) {
+        // glslang resolves the directive itself, through the same resolver.
+        // The included file may define anything, so later conditionals are left to glslang too.
+        rgsl_parser_add_preamble(state, "#extension GL_GOOGLE_include_directive : require");
+        state->macros.incomplete = true;
+        return 0;
+    }
     if (out != NULL) {
         char **replaced_line = (char **)out;
+        char closing;
         if (value[0] == '<') {
-            // System include
-            size_t rel_size = strlen(value) - 1 - strlen(strchr(value, '>'));
-            for (size_t i = 0; rgsl_global_options.include_paths[i] != NULL; i++) {
-                size_t len = strlen(rgsl_global_options.include_paths[i]) + rel_size + 2;
-                char *possible_path = (char *)malloc(len);
-                snprintf(possible_path, len, "%s/%s", rgsl_global_options.include_paths[i], value + 1);
-                if (rgsl_file_exists(possible_path)) {
-                    char *file_content;
-                    rgsl_read_file(possible_path, &file_content);
-                    if (file_content != NULL) {
-                        *replaced_line = file_content;
-                        free(possible_path);
-                        return 0; // Success
-                    }
-                }
-                free(possible_path);
+            closing = '>'; // System include
+        } else if (value[0] == '\"') {
+            closing = '\"'; // Local include
+        } else {
+            rgsl_printf_error("Malformed #include directive: %s\n", value);
+            return -1;
+        }
+        const char* name_end = strchr(value + 1, closing);
+        if (name_end == NULL) {
+            rgsl_printf_error("Malformed #include directive: %s\n", value);
+            return -1;
+        }
+        size_t name_length = (size_t)(name_end - (value + 1));
+        char *name = (char *)rgsl_malloc(name_length + 1);
+        memcpy(name, value + 1, name_length);
+        name[name_length] = '\0';
+
+        const char* includer_path = NULL;
+        if (closing == '\"') {
+            includer_path = rgsl_parser_current_file(state);
+            if (includer_path == NULL) {
+                includer_path = "";
             }
+        }
+        char *path = rgsl_resolve_include(name, includer_path);
+        if (path == NULL) {
             rgsl_printf_error("Included file %s not found in search paths.\n", value);
+            rgsl_free(name);
             return -1; // File not found
-        } else if (value[0] == '\"') {
-            // Local include
-            rgsl_print_error("Local includes not yet implemented.\n");
-            return -1; // Not implemented
         }
+        rgsl_free(name);
+
+        const char *file_content = NULL;
+        if (!rgsl_resolver_read(path, &file_content, NULL)) {
+            rgsl_printf_error("Failed to read included file: %s\n", path);
+            rgsl_free(path);
+            return -1;
+        }
+        rgsl_parser_push_file(state, path);
+        *replaced_line = rgsl_strdup(file_content);
+        rgsl_free(path);
     }
     return 0; // Success
 }
 
+static void rgsl_glsl_define_version_macros(struct rgsl_macro_table* macros, const struct rgsl_shader_profile* profile) {
+    // Mirror the macros glslang predefines, so conditionals on them can be evaluated.
+    char definition[32];
+    snprintf(definition, sizeof(definition), "__VERSION__ %d", profile->version);
+    rgsl_macro_define(macros, definition, false);
+    if (strcmp(profile->name, "es") == 0 || profile->version == 100) {
+        rgsl_macro_define(macros, "GL_ES 1", false);
+        macros->undefined_unknown = true;
+    } else if (strcmp(profile->name, "compatibility") == 0) {
+        rgsl_macro_define(macros, "GL_compatibility_profile 1", false);
+    } else if (profile->version >= 150) {
+        rgsl_macro_define(macros, "GL_core_profile 1", false);
+    }
+    macros->builtins_known = true;
+}
+
+static void rgsl_glsl_format_profile(const struct rgsl_shader_profile* profile, char* buffer, size_t size) {
+    // Before GLSL 1.50, only ES shaders name their profile.
+    if (strcmp(profile->name, "es") == 0 ? profile->version != 100 : profile->version >= 150) {
+        snprintf(buffer, size, "%d %s", profile->version, profile->name);
+    } else {
+        snprintf(buffer, size, "%d", profile->version);
+    }
+}
+
 int rgsl_glsl_handle_version_directive(struct rgsl_parser_state* state, const char* value, void* out) {
-    // Placeholder for handling #version directive
     rgsl_printf_info(2, "Handling #version directive with value: %s\n", value);
+    if (rgsl_targets_enabled()) {
+        // The body is shared by every target, each gets its own directive. The macros
+        // depending on the version stay unknown, so the conditionals on them are kept.
+        // An ES target rejects undefined identifiers in conditionals, leave those too.
+        state->macros.undefined_unknown = true;
+        char **replaced_line = (char **)out;
+        *replaced_line = rgsl_strdup("");
+        return 0;
+    }
+    if (!state->version_directive_found && state->stage_count > 0) {
+        rgsl_printf_error("The #version directive must precede the first stage pragma.\n");
+        return -1;
+    }
+    const struct rgsl_shader_profile* requested = &state->shader->requested_profile;
+    if (!state->version_directive_found && requested->version != 0) {
+        char requested_value[64];
+        rgsl_glsl_format_profile(requested, requested_value, sizeof(requested_value));
+        if (strcmp(value, requested_value) != 0) {
+            // The replaced directive is processed again, and then matches the requested profile.
+            size_t length = strlen(requested_value) + 10;
+            char **replaced_line = (char **)out;
+            *replaced_line = (char *)rgsl_malloc(length);
+            snprintf(*replaced_line, length, "#version %s", requested_value);
+            return 0;
+        }
+    }
     if (!state->version_directive_found) {
         state->shader->profile.version = atoi(value);
-        const char* profile_start = strchr(value, ' ');
-        if (profile_start != NULL) {
-            char * profile_name = _strdup(profile_start + 1);
-            profile_name[strcspn(profile_name, "\n")] = '\0'; // Remove newline
-            state->shader->profile.name = profile_name;
-        } else {
-            state->shader->profile.name = "core"; // Default profile
+        state->shader->profile.name = "core"; // Default profile
+        if (strchr(value, ' ') != NULL) {
+            // Known profiles get the static names, so that no shader leaves a copy behind.
+            char text[64];
+            snprintf(text, sizeof(text), "%.*s", (int)strcspn(value, "\n"), value);
+            struct rgsl_shader_profile profile;
+            if (rgsl_parse_profile(text, &profile)) {
+                state->shader->profile.name = profile.name;
+            }
         }
         state->version_directive_found = true;
+        state->version_line_end = (size_t)(state->line_end - state->processed_code);
+        if (*state->line_end == '\n') {
+            state->version_line_end++;
+        }
+        rgsl_glsl_define_version_macros(&state->macros, &state->shader->profile);
     } else {
         char **replaced_line = (char **)out;
-        *replaced_line = malloc(1 * sizeof(char));
+        *replaced_line = rgsl_malloc(1 * sizeof(char));
         (*replaced_line)[0] = '\0'; // Remove duplicate version directive
     }
     return 0; // Success
 }
 
 const struct rgsl_directive_mapping GLSL_DIRECTIVE_MAPPINGS[] = {
-    {"include", rgsl_glsl_handle_include_directive},
-    {"version", rgsl_glsl_handle_version_directive},
-    {NULL, NULL} // Sentinel to mark the end of the array
-};
\ No newline at end of file
+    {"include", rgsl_glsl_handle_include_directive, false},
+    {"version", rgsl_glsl_handle_version_directive, false},
+    {"define", rgsl_handle_define_directive, false},
+    {"undef", rgsl_handle_undef_directive, false},
+    {"pragma", rgsl_handle_pragma_directive, false},
+    {"if", rgsl_handle_if_directive, true},
+    {"ifdef", rgsl_handle_ifdef_directive, true},
+    {"ifndef", rgsl_handle_ifndef_directive, true},
+    {"elif", rgsl_handle_elif_directive, true},
+    {"else", rgsl_handle_else_directive, true},
+    {"endif", rgsl_handle_endif_directive, true},
+    {NULL, NULL, false} // Sentinel to mark the end of the array
+};
+
+void rgsl_glsl_rewrite_interface(struct rgsl_shader_data* shader) {
+    if (rgsl_uniform_packing_enabled()) {
+        rgsl_glsl_pack_uniforms(shader);
+    }
+    if (rgsl_buffer_layouts_enabled()) {
+        rgsl_glsl_layout_buffers(shader);
+    }
+}
+
+bool rgsl_glsl_preprocess_shader(struct rgsl_shader_data* shader, bool native_includes) {
+    // Spliced includes serve both modes, only code left to glslang is redone without it.
+    if (shader->processed_code != NULL && (shader->native_includes == native_includes || !shader->native_includes)) {
+        return true;
+    }
+    rgsl_free(shader->processed_code);
+    rgsl_print_info(1, "Preprocessing GLSL shader code...\n");
+    double start = rgsl_clock_seconds();
+    shader->processed_code = rgsl_parse_shader(GLSL_DIRECTIVE_MAPPINGS, shader, native_includes);
+    shader->native_includes = native_includes;
+    if (shader->processed_code == NULL) {
+        rgsl_print_error("Failed to preprocess GLSL shader code.\n");
+        return false;
+    }
+    rgsl_glsl_rewrite_interface(shader);
+    rgsl_printf_info(2, "Preprocessed in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+    return true;
+}
+
+bool rgsl_glsl_build_program(struct rgsl_shader_data* shader, char** out_log) {
+    if (shader->program != NULL) {
+        return true;
+    }
+    bool targets = rgsl_targets_enabled();
+    if (!rgsl_glsl_preprocess_shader(shader, !targets && rgsl_global_options.native_includes != 0)) {
+        return false;
+    }
+    rgsl_print_info(1, "Parsing GLSL shader code with glslang...\n");
+    double start = rgsl_clock_seconds();
+    char* log = NULL;
+    if (targets) {
+        // The body has no #version of its own, the first target stands for the others.
+        char* code = rgsl_target_glsl_code(rgsl_get_target(0), shader->processed_code);
+        shader->program = rgsl_create_target_program(rgsl_get_target(0), shader, code, &log);
+        rgsl_free(code);
+    } else {
+        shader->program = rgsl_glslang_create_program(shader->processed_code, shader->path, shader->stage, shader->native_includes, rgsl_spec_constants_enabled(), &log);
+        if (log != NULL && shader->path != NULL) {
+            char* mapped = rgsl_line_map_rewrite_log(&shader->line_map, shader->path, log);
+            rgsl_free(log);
+            log = mapped;
+        }
+    }
+    rgsl_printf_info(2, "Parsed and linked with glslang in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+    if (out_log != NULL) {
+        *out_log = log;
+    } else {
+        rgsl_free(log);
+    }
+    return shader->program != NULL;
+}
\ No newline at end of file
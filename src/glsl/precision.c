@@ -0,0 +1,221 @@
+#include <RGSL/glsl/precision.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/parser.h>
+#include <RGSL/termio.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define RGSL_MEDIUMP_QUALIFIER "mediump "
+
+/**
+ * Code being rewritten, handed to the callback of the glslang analysis, with the
+ * offsets of the declarations to qualify.
+ */
+struct rgsl_precision_context {
+    const struct rgsl_shader_data* shader;
+    const char* code;
+    size_t* offsets;
+    size_t offset_count;
+    size_t offset_capacity;
+};
+
+static const char* const PRECISION_QUALIFIERS[] = {"lowp", "mediump", "highp"};
+
+bool rgsl_precision_demotion_enabled() {
+    return rgsl_global_options.demote_precision != 0;
+}
+
+static bool rgsl_is_identifier_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+static const char* rgsl_find_line(const char* code, int line) {
+    const char* start = code;
+    for (int i = 1; i < line && start != NULL; i++) {
+        start = strchr(start, '\n');
+        start = (start != NULL) ? start + 1 : NULL;
+    }
+    return start;
+}
+
+static bool rgsl_word_at(const char* str, const char* word, size_t length) {
+    return strncmp(str, word, length) == 0 && !rgsl_is_identifier_char(str[length]);
+}
+
+// Whether a position of the code is in a comment, where declarations are only text.
+static bool rgsl_in_comment(const char* code, const char* position) {
+    bool line_comment = false;
+    bool block_comment = false;
+    for (const char* c = code; c < position; c++) {
+        if (line_comment) {
+            line_comment = *c != '\n';
+        } else if (block_comment) {
+            if (c[0] == '*' && c[1] == '/') {
+                block_comment = false;
+                c++;
+            }
+        } else if (c[0] == '/' && c[1] == '/') {
+            line_comment = true;
+            c++;
+        } else if (c[0] == '/' && c[1] == '*') {
+            block_comment = true;
+            c++;
+        }
+    }
+    return line_comment || block_comment;
+}
+
+// Whether the word before the type of a declaration is a precision qualifier.
+static bool rgsl_has_precision(const char* code, const char* type) {
+    const char* end = type;
+    while (end > code && isspace((unsigned char)end[-1])) {
+        end--;
+    }
+    const char* start = end;
+    while (start > code && rgsl_is_identifier_char(start[-1])) {
+        start--;
+    }
+    for (size_t i = 0; i < sizeof(PRECISION_QUALIFIERS) / sizeof(PRECISION_QUALIFIERS[0]); i++) {
+        size_t length = strlen(PRECISION_QUALIFIERS[i]);
+        if ((size_t)(end - start) == length && strncmp(start, PRECISION_QUALIFIERS[i], length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether the declaration goes on with other declarators, which share its qualifiers.
+static bool rgsl_declares_several(const char* name_end) {
+    int depth = 0;
+    for (const char* c = name_end; *c != '\0' && *c != ';'; c++) {
+        if (*c == '(' || *c == '[' || *c == '{') {
+            depth++;
+        } else if (*c == ')' || *c == ']' || *c == '}') {
+            depth--;
+        } else if (*c == ',' && depth == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * Finds "<type> <name>" on a line, as a declaration the qualifier can be inserted in.
+ * Returns the offset of the type, or -1 if the line declares no such variable or if
+ * its declaration cannot take the qualifier.
+ */
+static long rgsl_find_declaration(const char* code, const char* line, const char* type, const char* name, bool* out_found) {
+    size_t line_length = strcspn(line, "\n");
+    size_t type_length = strlen(type);
+    size_t name_length = strlen(name);
+    for (size_t i = 0; i + type_length < line_length; i++) {
+        if ((i > 0 && rgsl_is_identifier_char(line[i - 1])) || !rgsl_word_at(line + i, type, type_length)) {
+            continue;
+        }
+        const char* after = line + i + type_length;
+        const char* name_start = after;
+        while (*name_start == ' ' || *name_start == '\t') {
+            name_start++;
+        }
+        if (name_start == after || !rgsl_word_at(name_start, name, name_length) || rgsl_in_comment(code, line + i)) {
+            continue;
+        }
+        *out_found = true;
+        if (rgsl_has_precision(code, line + i) || rgsl_declares_several(name_start + name_length)) {
+            return -1;
+        }
+        return (long)(line + i - code);
+    }
+    return -1;
+}
+
+static void rgsl_report_demotion(const struct rgsl_shader_data* shader, int line, const char* type, const char* name, const char* reason, const char* outcome) {
+    const char* source = shader->path;
+    int source_line = line;
+    if (!rgsl_line_map_lookup(&shader->line_map, line, &source, &source_line)) {
+        source = shader->path;
+        source_line = line;
+    }
+    rgsl_printf_info(1, "%s:%d: %s %s -> %s: %s\n", source != NULL ? source : shader->name, source_line, type, name, outcome, reason);
+}
+
+static void rgsl_demote_variable(const char* name, const char* type, int line, const char* reason, void* user) {
+    struct rgsl_precision_context* context = (struct rgsl_precision_context*)user;
+    // Variables declared without initializer first appear on a later line than their declaration.
+    for (int declaration_line = line; declaration_line > 0; declaration_line--) {
+        const char* start = rgsl_find_line(context->code, declaration_line);
+        bool found = false;
+        long offset = (start != NULL) ? rgsl_find_declaration(context->code, start, type, name, &found) : -1;
+        if (!found) {
+            continue;
+        }
+        if (offset < 0) {
+            rgsl_report_demotion(context->shader, declaration_line, type, name, "its declaration already has a precision, or declares other variables", "kept");
+            return;
+        }
+        if (context->offset_count == context->offset_capacity) {
+            context->offset_capacity = context->offset_capacity ? context->offset_capacity * 2 : 8;
+            context->offsets = (size_t*)rgsl_realloc(context->offsets, context->offset_capacity * sizeof(size_t));
+        }
+        context->offsets[context->offset_count++] = (size_t)offset;
+        rgsl_report_demotion(context->shader, declaration_line, type, name, reason, "mediump");
+        return;
+    }
+    rgsl_printf_info(2, "No declaration of %s %s found in %s, it stays highp.\n", type, name, context->shader->path);
+}
+
+static int rgsl_compare_offsets(const void* a, const void* b) {
+    size_t left = *(const size_t*)a;
+    size_t right = *(const size_t*)b;
+    return (left > right) - (left < right);
+}
+
+void rgsl_glsl_demote_precision(struct rgsl_shader_data* shader, char** code) {
+    if (*code == NULL || strcmp(shader->stage, "frag") != 0 || shader->profile.name == NULL || strcmp(shader->profile.name, "es") != 0) {
+        return;
+    }
+    // A program built with native includes does not see the spliced lines of the text output.
+    struct rgsl_glslang_program* program = NULL;
+    bool temporary = rgsl_global_options.native_includes != 0;
+    if (temporary) {
+        char* log = NULL;
+        program = rgsl_glslang_create_program(*code, shader->path, shader->stage, false, false, &log);
+        rgsl_free(log);
+    } else if (rgsl_glsl_build_program(shader, NULL)) {
+        program = shader->program;
+    }
+    if (program == NULL) {
+        rgsl_printf_info(2, "%s does not build, its precision is not demoted.\n", shader->path);
+        return;
+    }
+
+    struct rgsl_precision_context context = {0};
+    context.shader = shader;
+    context.code = *code;
+    rgsl_glslang_find_mediump_variables(program, rgsl_global_options.mediump_texture_size, rgsl_global_options.mediump_outputs != 0, rgsl_demote_variable, &context);
+    if (temporary) {
+        rgsl_glslang_destroy_program(program);
+    }
+    if (context.offset_count == 0) {
+        rgsl_printf_info(1, "No variable of %s can be demoted to mediump.\n", shader->path);
+        return;
+    }
+
+    qsort(context.offsets, context.offset_count, sizeof(size_t), rgsl_compare_offsets);
+    struct rgsl_text text = {0};
+    size_t copied = 0;
+    for (size_t i = 0; i < context.offset_count; i++) {
+        rgsl_text_append(&text, *code + copied, context.offsets[i] - copied);
+        rgsl_text_append(&text, RGSL_MEDIUMP_QUALIFIER, strlen(RGSL_MEDIUMP_QUALIFIER));
+        copied = context.offsets[i];
+    }
+    rgsl_text_append(&text, *code + copied, strlen(*code + copied));
+    rgsl_free(*code);
+    *code = text.data;
+    rgsl_free(context.offsets);
+}
\ No newline at end of file
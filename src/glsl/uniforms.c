@@ -0,0 +1,266 @@
+#include <RGSL/glsl/uniforms.h>
+#include <RGSL/parser.h>
+#include <RGSL/layout.h>
+#include <RGSL/termio.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// Instance name of the blocks, which keeps their members out of the global scope of the program.
+#define RGSL_UNIFORM_INSTANCE "rgsl_uniforms"
+
+static const char* const PRECISION_QUALIFIERS[] = {"lowp", "mediump", "highp"};
+
+bool rgsl_uniform_packing_enabled() {
+    return rgsl_global_options.pack_uniforms != 0;
+}
+
+static const char* rgsl_skip_spaces(const char* c, const char* end) {
+    while (c < end && (*c == ' ' || *c == '\t' || *c == '\r')) {
+        c++;
+    }
+    return c;
+}
+
+static size_t rgsl_word_length(const char* c, const char* end) {
+    size_t length = 0;
+    if (c < end && (isalpha((unsigned char)*c) || *c == '_')) {
+        while (c + length < end && (isalnum((unsigned char)c[length]) || c[length] == '_')) {
+            length++;
+        }
+    }
+    return length;
+}
+
+static const char* rgsl_find_precision(const char* word, size_t length) {
+    for (size_t i = 0; i < sizeof(PRECISION_QUALIFIERS) / sizeof(PRECISION_QUALIFIERS[0]); i++) {
+        if (strlen(PRECISION_QUALIFIERS[i]) == length && strncmp(PRECISION_QUALIFIERS[i], word, length) == 0) {
+            return PRECISION_QUALIFIERS[i];
+        }
+    }
+    return NULL;
+}
+
+// Adds the uniform declared by a line to the block, if the line is a loose uniform declaration.
+static bool rgsl_parse_loose_uniform(const char* line, size_t length, struct rgsl_block_layout* block) {
+    const char* end = line + length;
+    const char* c = rgsl_skip_spaces(line, end);
+    size_t word = rgsl_word_length(c, end);
+    if (word != strlen("uniform") || strncmp(c, "uniform", word) != 0) {
+        return false;
+    }
+    c = rgsl_skip_spaces(c + word, end);
+    word = rgsl_word_length(c, end);
+    const char* precision = rgsl_find_precision(c, word);
+    if (precision != NULL) {
+        c = rgsl_skip_spaces(c + word, end);
+        word = rgsl_word_length(c, end);
+    }
+    const struct rgsl_glsl_type* type = rgsl_find_glsl_type(c, word);
+    if (type == NULL) {
+        return false;
+    }
+    const char* name = rgsl_skip_spaces(c + word, end);
+    size_t name_length = rgsl_word_length(name, end);
+    if (name_length == 0 || name == c + word) {
+        return false;
+    }
+    c = rgsl_skip_spaces(name + name_length, end);
+    uint32_t array_size = 0;
+    if (c < end && *c == '[') {
+        c = rgsl_skip_spaces(c + 1, end);
+        while (c < end && isdigit((unsigned char)*c)) {
+            array_size = array_size * 10 + (uint32_t)(*c++ - '0');
+        }
+        c = rgsl_skip_spaces(c, end);
+        if (array_size == 0 || c == end || *c != ']') {
+            return false;
+        }
+        c = rgsl_skip_spaces(c + 1, end);
+    }
+    if (c == end || *c != ';') {
+        return false;
+    }
+    c = rgsl_skip_spaces(c + 1, end);
+    if (c != end && (end - c < 2 || c[0] != '/' || c[1] != '/')) {
+        return false;
+    }
+    rgsl_block_add_member(block, name, name_length, type, NULL, precision, array_size);
+    return true;
+}
+
+// Follows the braces of a line, outside of comments, to know whether the next one is at file scope.
+static void rgsl_scan_scope(const char* line, size_t length, int* depth, bool* in_comment) {
+    for (size_t i = 0; i < length; i++) {
+        if (*in_comment) {
+            if (line[i] == '*' && i + 1 < length && line[i + 1] == '/') {
+                *in_comment = false;
+                i++;
+            }
+        } else if (line[i] == '/' && i + 1 < length && line[i + 1] == '/') {
+            return;
+        } else if (line[i] == '/' && i + 1 < length && line[i + 1] == '*') {
+            *in_comment = true;
+            i++;
+        } else if (line[i] == '{') {
+            (*depth)++;
+        } else if (line[i] == '}') {
+            (*depth)--;
+        }
+    }
+}
+
+static char* rgsl_uniform_block_name(const struct rgsl_shader_data* shader) {
+    size_t length = strlen("RGSLUniforms__") + strlen(shader->name) + strlen(shader->stage) + 1;
+    char* name = (char *)rgsl_malloc(length);
+    snprintf(name, length, "RGSLUniforms_%s_%s", shader->name, shader->stage);
+    for (char* c = name; *c != '\0'; c++) {
+        if (!isalnum((unsigned char)*c)) {
+            *c = '_';
+        }
+    }
+    return name;
+}
+
+static bool rgsl_profile_supports_binding(const struct rgsl_shader_profile* profile) {
+    bool es = profile->name != NULL && strcmp(profile->name, "es") == 0;
+    return profile->version >= (es ? 310 : 420);
+}
+
+static void rgsl_write_uniform_block(struct rgsl_text* output, const struct rgsl_shader_data* shader, const struct rgsl_block_layout* block) {
+    if (rgsl_profile_supports_binding(&shader->profile)) {
+        rgsl_text_printf(output, "layout(std140, binding = %d) uniform %s {\n", rgsl_global_options.pack_uniforms_binding, block->name);
+    } else {
+        rgsl_text_printf(output, "layout(std140) uniform %s {\n", block->name);
+    }
+    for (size_t i = 0; i < block->member_count; i++) {
+        const struct rgsl_block_member* member = &block->members[i];
+        rgsl_text_printf(output, "    %s%s%s %s", member->precision != NULL ? member->precision : "", member->precision != NULL ? " " : "", member->type->name, member->name);
+        if (member->array_size > 0) {
+            rgsl_text_printf(output, "[%u]", member->array_size);
+        }
+        rgsl_text_printf(output, ";\n");
+    }
+    rgsl_text_printf(output, "} " RGSL_UNIFORM_INSTANCE ";\n");
+}
+
+static bool rgsl_is_block_member(const struct rgsl_block_layout* block, const char* word, size_t length) {
+    for (size_t i = 0; i < block->member_count; i++) {
+        if (strlen(block->members[i].name) == length && strncmp(block->members[i].name, word, length) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Whether the word at a position follows another word, as the name of a declaration follows its type.
+// In directives, only the name of a macro is a declaration, its value uses the uniforms.
+static bool rgsl_follows_type(const char* line, size_t position) {
+    size_t end = position;
+    while (end > 0 && (line[end - 1] == ' ' || line[end - 1] == '\t')) {
+        end--;
+    }
+    size_t start = end;
+    while (start > 0 && (isalnum((unsigned char)line[start - 1]) || line[start - 1] == '_')) {
+        start--;
+    }
+    const char* directive = rgsl_skip_spaces(line, line + position);
+    const char* keyword = (directive < line + position && *directive == '#') ? "define" : "return";
+    bool after_keyword = end - start == strlen(keyword) && strncmp(line + start, keyword, end - start) == 0;
+    return start < end && (*directive == '#' ? after_keyword : !after_keyword);
+}
+
+// Appends a line, its uses of the packed uniforms going through the instance of the block.
+static void rgsl_append_rewritten_line(struct rgsl_text* output, const char* line, size_t length, const struct rgsl_block_layout* block, bool* in_comment) {
+    size_t copied = 0;
+    for (size_t i = 0; i < length; ) {
+        if (*in_comment) {
+            *in_comment = !(line[i] == '*' && i + 1 < length && line[i + 1] == '/');
+            i += *in_comment ? 1 : 2;
+        } else if (line[i] == '/' && i + 1 < length && line[i + 1] == '/') {
+            break;
+        } else if (line[i] == '/' && i + 1 < length && line[i + 1] == '*') {
+            *in_comment = true;
+            i += 2;
+        } else if (isalpha((unsigned char)line[i]) || line[i] == '_') {
+            size_t word = rgsl_word_length(line + i, line + length);
+            // Members of other structures may share the name of a uniform, in accesses and declarations.
+            bool member_access = i > 0 && line[i - 1] == '.';
+            if (!member_access && !rgsl_follows_type(line, i) && rgsl_is_block_member(block, line + i, word)) {
+                rgsl_text_append(output, line + copied, i - copied);
+                rgsl_text_append(output, RGSL_UNIFORM_INSTANCE ".", strlen(RGSL_UNIFORM_INSTANCE "."));
+                copied = i;
+            }
+            i += word;
+        } else if (isdigit((unsigned char)line[i])) {
+            while (i < length && (isalnum((unsigned char)line[i]) || line[i] == '.')) {
+                i++;
+            }
+        } else {
+            i++;
+        }
+    }
+    rgsl_text_append(output, line + copied, length - copied);
+}
+
+void rgsl_glsl_pack_uniforms(struct rgsl_shader_data* shader) {
+    rgsl_block_layout_free(shader->uniform_block);
+    shader->uniform_block = NULL;
+
+    struct rgsl_block_layout* block = (struct rgsl_block_layout *)rgsl_calloc(1, sizeof(struct rgsl_block_layout));
+    size_t* packed_lines = NULL;
+    int depth = 0;
+    bool in_comment = false;
+    size_t line_index = 0;
+    for (const char* line = shader->processed_code; *line != '\0'; line_index++) {
+        size_t length = strcspn(line, "\n");
+        if (depth == 0 && !in_comment && rgsl_parse_loose_uniform(line, length, block)) {
+            packed_lines = (size_t *)rgsl_realloc(packed_lines, block->member_count * sizeof(size_t));
+            packed_lines[block->member_count - 1] = line_index;
+        }
+        rgsl_scan_scope(line, length, &depth, &in_comment);
+        line += length + (line[length] == '\n');
+    }
+    if (block->member_count == 0) {
+        rgsl_printf_info(2, "No loose uniform to pack in %s\n", shader->path);
+        rgsl_block_layout_free(block);
+        return;
+    }
+    block->name = rgsl_uniform_block_name(shader);
+    block->kind = RGSL_LAYOUT_UNIFORM_BLOCK;
+    rgsl_layout_block(block, RGSL_LAYOUT_STD140, true);
+
+    // The declarations become empty lines, so that the following lines keep their number.
+    struct rgsl_text code = {0};
+    size_t packed = 0;
+    line_index = 0;
+    in_comment = false;
+    for (const char* line = shader->processed_code; *line != '\0'; line_index++) {
+        size_t length = strcspn(line, "\n");
+        if (line_index == packed_lines[0]) {
+            rgsl_write_uniform_block(&code, shader, block);
+        }
+        if (packed < block->member_count && line_index == packed_lines[packed]) {
+            packed++;
+        } else {
+            rgsl_append_rewritten_line(&code, line, length, block, &in_comment);
+        }
+        if (line[length] == '\n') {
+            rgsl_text_append(&code, "\n", 1);
+        }
+        line += length + (line[length] == '\n');
+    }
+    struct rgsl_line_origin generated = {0, 0};
+    rgsl_line_map_insert(&shader->line_map, packed_lines[0], block->member_count + 2, generated);
+    rgsl_free(shader->processed_code);
+    shader->processed_code = code.data;
+    rgsl_free(packed_lines);
+
+    rgsl_printf_info(1, "Packed %zu loose uniforms of %s into the std140 block %s (%u bytes, %u of padding)\n",
+        block->member_count, shader->path, block->name, block->size, block->padding);
+    shader->uniform_block = block;
+}
\ No newline at end of file
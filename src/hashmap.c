@@ -0,0 +1,203 @@
+#include <RGSL/hashmap.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RGSL_HASHMAP_INITIAL_CAPACITY 16
+
+uint64_t rgsl_hash_bytes(const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ULL;
+    }
+    return hash;
+}
+
+uint64_t rgsl_hash_string(const char* str) {
+    return rgsl_hash_bytes(str, strlen(str));
+}
+
+static uint64_t rgsl_rotl64(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static uint64_t rgsl_fmix64(uint64_t k) {
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+
+static uint64_t rgsl_read_le64(const unsigned char* bytes, size_t count) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < count; i++) {
+        value |= (uint64_t)bytes[i] << (8 * i);
+    }
+    return value;
+}
+
+struct rgsl_hash128 rgsl_hash128_bytes(const void* data, size_t size) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    const uint64_t c1 = 0x87c37b91114253d5ULL;
+    const uint64_t c2 = 0x4cf5ad432745937fULL;
+    uint64_t h1 = 0;
+    uint64_t h2 = 0;
+
+    size_t block_count = size / 16;
+    for (size_t i = 0; i < block_count; i++) {
+        uint64_t k1 = rgsl_read_le64(bytes + i * 16, 8);
+        uint64_t k2 = rgsl_read_le64(bytes + i * 16 + 8, 8);
+        k1 *= c1; k1 = rgsl_rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+        h1 = rgsl_rotl64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+        k2 *= c2; k2 = rgsl_rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+        h2 = rgsl_rotl64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+    }
+
+    const unsigned char* tail = bytes + block_count * 16;
+    size_t tail_size = size & 15;
+    if (tail_size > 8) {
+        uint64_t k2 = rgsl_read_le64(tail + 8, tail_size - 8);
+        k2 *= c2; k2 = rgsl_rotl64(k2, 33); k2 *= c1; h2 ^= k2;
+    }
+    if (tail_size > 0) {
+        uint64_t k1 = rgsl_read_le64(tail, tail_size < 8 ? tail_size : 8);
+        k1 *= c1; k1 = rgsl_rotl64(k1, 31); k1 *= c2; h1 ^= k1;
+    }
+
+    h1 ^= (uint64_t)size;
+    h2 ^= (uint64_t)size;
+    h1 += h2;
+    h2 += h1;
+    h1 = rgsl_fmix64(h1);
+    h2 = rgsl_fmix64(h2);
+    h1 += h2;
+    h2 += h1;
+    struct rgsl_hash128 hash = {h1, h2};
+    return hash;
+}
+
+void rgsl_hashmap_init(struct rgsl_hashmap* map) {
+    map->entries = NULL;
+    map->capacity = 0;
+    map->count = 0;
+}
+
+void rgsl_hashmap_free(struct rgsl_hashmap* map, void (*release_value)(void*)) {
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->entries[i].key != NULL) {
+            rgsl_free(map->entries[i].key);
+            if (release_value != NULL) {
+                release_value(map->entries[i].value);
+            }
+        }
+    }
+    rgsl_free(map->entries);
+    rgsl_hashmap_init(map);
+}
+
+static size_t rgsl_hashmap_slot(const struct rgsl_hashmap* map, const char* key, uint64_t hash) {
+    size_t mask = map->capacity - 1;
+    size_t slot = (size_t)hash & mask;
+    while (map->entries[slot].key != NULL) {
+        if (map->entries[slot].hash == hash && strcmp(map->entries[slot].key, key) == 0) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static bool rgsl_hashmap_grow(struct rgsl_hashmap* map) {
+    size_t new_capacity = map->capacity ? map->capacity * 2 : RGSL_HASHMAP_INITIAL_CAPACITY;
+    struct rgsl_hashmap_entry* new_entries = (struct rgsl_hashmap_entry*)rgsl_calloc(new_capacity, sizeof(struct rgsl_hashmap_entry));
+    if (new_entries == NULL) {
+        return false;
+    }
+    for (size_t i = 0; i < map->capacity; i++) {
+        if (map->entries[i].key != NULL) {
+            size_t slot = (size_t)map->entries[i].hash & (new_capacity - 1);
+            while (new_entries[slot].key != NULL) {
+                slot = (slot + 1) & (new_capacity - 1);
+            }
+            new_entries[slot] = map->entries[i];
+        }
+    }
+    rgsl_free(map->entries);
+    map->entries = new_entries;
+    map->capacity = new_capacity;
+    return true;
+}
+
+bool rgsl_hashmap_find(const struct rgsl_hashmap* map, const char* key, void** out_value) {
+    if (map->count == 0) {
+        return false;
+    }
+    size_t slot = rgsl_hashmap_slot(map, key, rgsl_hash_string(key));
+    if (map->entries[slot].key == NULL) {
+        return false;
+    }
+    if (out_value != NULL) {
+        *out_value = map->entries[slot].value;
+    }
+    return true;
+}
+
+void* rgsl_hashmap_get(const struct rgsl_hashmap* map, const char* key) {
+    void* value = NULL;
+    rgsl_hashmap_find(map, key, &value);
+    return value;
+}
+
+void* rgsl_hashmap_set(struct rgsl_hashmap* map, const char* key, void* value) {
+    // Keep the load factor under 3/4 so probe sequences stay short.
+    if ((map->count + 1) * 4 > map->capacity * 3 && !rgsl_hashmap_grow(map)) {
+        return NULL;
+    }
+    uint64_t hash = rgsl_hash_string(key);
+    size_t slot = rgsl_hashmap_slot(map, key, hash);
+    struct rgsl_hashmap_entry* entry = &map->entries[slot];
+    if (entry->key != NULL) {
+        void* previous = entry->value;
+        entry->value = value;
+        return previous;
+    }
+    entry->key = rgsl_strdup(key);
+    entry->hash = hash;
+    entry->value = value;
+    map->count++;
+    return NULL;
+}
+
+bool rgsl_hashmap_remove(struct rgsl_hashmap* map, const char* key, void** out_value) {
+    if (map->count == 0) {
+        return false;
+    }
+    size_t mask = map->capacity - 1;
+    size_t slot = rgsl_hashmap_slot(map, key, rgsl_hash_string(key));
+    if (map->entries[slot].key == NULL) {
+        return false;
+    }
+    if (out_value != NULL) {
+        *out_value = map->entries[slot].value;
+    }
+    rgsl_free(map->entries[slot].key);
+    map->entries[slot].key = NULL;
+    map->count--;
+
+    // Backward-shift the following entries of the probe run instead of leaving a tombstone.
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; map->entries[next].key != NULL; next = (next + 1) & mask) {
+        size_t home = (size_t)map->entries[next].hash & mask;
+        bool movable = (hole <= next) ? (home <= hole || home > next) : (home <= hole && home > next);
+        if (movable) {
+            map->entries[hole] = map->entries[next];
+            map->entries[next].key = NULL;
+            hole = next;
+        }
+    }
+    return true;
+}
\ No newline at end of file
@@ -0,0 +1,267 @@
+#include <RGSL/layout.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+// std140 rounds the alignment of arrays and matrix columns up to the one of a vec4.
+#define RGSL_STD140_VEC4_ALIGNMENT 16
+
+static const struct rgsl_glsl_type GLSL_TYPES[] = {
+    {"float", RGSL_SCALAR_FLOAT, 1, 1},
+    {"vec2", RGSL_SCALAR_FLOAT, 1, 2},
+    {"vec3", RGSL_SCALAR_FLOAT, 1, 3},
+    {"vec4", RGSL_SCALAR_FLOAT, 1, 4},
+    {"int", RGSL_SCALAR_INT, 1, 1},
+    {"ivec2", RGSL_SCALAR_INT, 1, 2},
+    {"ivec3", RGSL_SCALAR_INT, 1, 3},
+    {"ivec4", RGSL_SCALAR_INT, 1, 4},
+    {"uint", RGSL_SCALAR_UINT, 1, 1},
+    {"uvec2", RGSL_SCALAR_UINT, 1, 2},
+    {"uvec3", RGSL_SCALAR_UINT, 1, 3},
+    {"uvec4", RGSL_SCALAR_UINT, 1, 4},
+    {"bool", RGSL_SCALAR_BOOL, 1, 1},
+    {"bvec2", RGSL_SCALAR_BOOL, 1, 2},
+    {"bvec3", RGSL_SCALAR_BOOL, 1, 3},
+    {"bvec4", RGSL_SCALAR_BOOL, 1, 4},
+    {"mat2", RGSL_SCALAR_FLOAT, 2, 2},
+    {"mat3", RGSL_SCALAR_FLOAT, 3, 3},
+    {"mat4", RGSL_SCALAR_FLOAT, 4, 4},
+    {"mat2x2", RGSL_SCALAR_FLOAT, 2, 2},
+    {"mat2x3", RGSL_SCALAR_FLOAT, 2, 3},
+    {"mat2x4", RGSL_SCALAR_FLOAT, 2, 4},
+    {"mat3x2", RGSL_SCALAR_FLOAT, 3, 2},
+    {"mat3x3", RGSL_SCALAR_FLOAT, 3, 3},
+    {"mat3x4", RGSL_SCALAR_FLOAT, 3, 4},
+    {"mat4x2", RGSL_SCALAR_FLOAT, 4, 2},
+    {"mat4x3", RGSL_SCALAR_FLOAT, 4, 3},
+    {"mat4x4", RGSL_SCALAR_FLOAT, 4, 4}
+};
+
+// C type of each scalar kind, bool being stored as a 32-bit integer.
+static const char* const SCALAR_C_TYPES[] = {"float", "int32_t", "uint32_t", "uint32_t"};
+
+static const char* const PACKING_NAMES[] = {"std140", "std430"};
+
+static const char* const LAYOUT_KIND_NAMES[] = {"structure", "uniform block", "buffer block"};
+
+const struct rgsl_glsl_type* rgsl_find_glsl_type(const char* name, size_t length) {
+    for (size_t i = 0; i < sizeof(GLSL_TYPES) / sizeof(GLSL_TYPES[0]); i++) {
+        if (strlen(GLSL_TYPES[i].name) == length && strncmp(GLSL_TYPES[i].name, name, length) == 0) {
+            return &GLSL_TYPES[i];
+        }
+    }
+    return NULL;
+}
+
+const char* rgsl_layout_packing_name(enum rgsl_layout_packing packing) {
+    return PACKING_NAMES[packing];
+}
+
+void rgsl_block_add_member(struct rgsl_block_layout* block, const char* name, size_t length, const struct rgsl_glsl_type* type, const struct rgsl_block_layout* structure, const char* precision, uint32_t array_size) {
+    block->members = (struct rgsl_block_member *)rgsl_realloc(block->members, (block->member_count + 1) * sizeof(struct rgsl_block_member));
+    struct rgsl_block_member* member = &block->members[block->member_count];
+    member->name = (char *)rgsl_malloc(length + 1);
+    memcpy(member->name, name, length);
+    member->name[length] = '\0';
+    member->type = type;
+    member->structure = structure;
+    member->precision = precision;
+    member->array_size = array_size;
+    member->offset = 0;
+    member->size = 0;
+    member->stride = 0;
+    member->column_stride = 0;
+    member->index = (uint32_t)block->member_count++;
+}
+
+static uint32_t rgsl_align_up(uint32_t value, uint32_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Alignment of a vector, a vec3 being aligned like a vec4 but only taking 12 bytes.
+static uint32_t rgsl_vector_alignment(uint32_t rows) {
+    return (rows == 3 ? 4 : rows) * 4;
+}
+
+static uint32_t rgsl_member_alignment(const struct rgsl_block_member* member, enum rgsl_layout_packing packing) {
+    uint32_t alignment = member->structure != NULL ? member->structure->alignment : rgsl_vector_alignment(member->type->rows);
+    bool matrix = member->type != NULL && member->type->columns > 1;
+    if (packing == RGSL_LAYOUT_STD140 && (member->array_size > 0 || matrix)) {
+        alignment = rgsl_align_up(alignment, RGSL_STD140_VEC4_ALIGNMENT);
+    }
+    return alignment;
+}
+
+// Places a member at an offset, and computes its size and strides.
+static void rgsl_place_member(struct rgsl_block_member* member, enum rgsl_layout_packing packing, uint32_t offset) {
+    uint32_t alignment = rgsl_member_alignment(member, packing);
+    uint32_t element_size;
+    if (member->structure != NULL) {
+        element_size = member->structure->size;
+    } else if (member->type->columns > 1) {
+        // Matrices are arrays of their columns.
+        member->column_stride = rgsl_vector_alignment(member->type->rows);
+        if (packing == RGSL_LAYOUT_STD140) {
+            member->column_stride = rgsl_align_up(member->column_stride, RGSL_STD140_VEC4_ALIGNMENT);
+        }
+        element_size = member->type->columns * member->column_stride;
+    } else {
+        element_size = member->type->rows * 4;
+    }
+    member->offset = rgsl_align_up(offset, alignment);
+    member->size = element_size;
+    if (member->array_size > 0) {
+        member->stride = rgsl_align_up(element_size, alignment);
+        member->size = member->array_size == RGSL_RUNTIME_ARRAY ? member->stride : member->stride * member->array_size;
+    }
+}
+
+static void rgsl_restore_declaration_order(struct rgsl_block_layout* block) {
+    for (size_t i = 1; i < block->member_count; i++) {
+        struct rgsl_block_member member = block->members[i];
+        size_t j = i;
+        while (j > 0 && block->members[j - 1].index > member.index) {
+            block->members[j] = block->members[j - 1];
+            j--;
+        }
+        block->members[j] = member;
+    }
+}
+
+void rgsl_layout_block(struct rgsl_block_layout* block, enum rgsl_layout_packing packing, bool reorder) {
+    rgsl_restore_declaration_order(block);
+    block->packing = packing;
+    block->alignment = 4;
+    block->padding = 0;
+    uint32_t offset = 0;
+    for (size_t i = 0; i < block->member_count; i++) {
+        size_t chosen = i;
+        if (reorder) {
+            uint32_t best_padding = UINT32_MAX;
+            uint32_t best_alignment = 0;
+            for (size_t j = i; j < block->member_count; j++) {
+                if (block->members[j].array_size == RGSL_RUNTIME_ARRAY) {
+                    continue;
+                }
+                uint32_t alignment = rgsl_member_alignment(&block->members[j], packing);
+                uint32_t padding = rgsl_align_up(offset, alignment) - offset;
+                if (padding < best_padding || (padding == best_padding && alignment > best_alignment)) {
+                    best_padding = padding;
+                    best_alignment = alignment;
+                    chosen = j;
+                }
+            }
+        }
+        // Moving the chosen member keeps the others in their declaration order.
+        struct rgsl_block_member member = block->members[chosen];
+        memmove(&block->members[i + 1], &block->members[i], (chosen - i) * sizeof(struct rgsl_block_member));
+        rgsl_place_member(&member, packing, offset);
+        uint32_t alignment = rgsl_member_alignment(&member, packing);
+        block->alignment = alignment > block->alignment ? alignment : block->alignment;
+        block->padding += member.offset - offset;
+        offset = member.array_size == RGSL_RUNTIME_ARRAY ? member.offset : member.offset + member.size;
+        block->members[i] = member;
+    }
+    if (packing == RGSL_LAYOUT_STD140) {
+        block->alignment = rgsl_align_up(block->alignment, RGSL_STD140_VEC4_ALIGNMENT);
+    }
+    block->size = rgsl_align_up(offset, block->alignment);
+    block->padding += block->size - offset;
+}
+
+static void rgsl_write_padding(struct rgsl_text* output, uint32_t bytes, size_t* pad_count) {
+    if (bytes > 0) {
+        rgsl_text_printf(output, "    uint8_t _rgsl_pad%zu[%u];\n", (*pad_count)++, bytes);
+    }
+}
+
+static const char* rgsl_mirror_name(const struct rgsl_block_layout* block) {
+    return block->mirror_name != NULL ? block->mirror_name : block->name;
+}
+
+static void rgsl_write_mirror_member(struct rgsl_text* output, const struct rgsl_block_member* member) {
+    const struct rgsl_glsl_type* type = member->type;
+    if (member->structure != NULL) {
+        rgsl_text_printf(output, "    struct %s %s", rgsl_mirror_name(member->structure), member->name);
+    } else {
+        rgsl_text_printf(output, "    %s %s", SCALAR_C_TYPES[type->scalar], member->name);
+    }
+    if (member->array_size == RGSL_RUNTIME_ARRAY) {
+        rgsl_text_printf(output, "[]");
+    } else if (member->array_size > 0) {
+        rgsl_text_printf(output, "[%u]", member->array_size);
+    }
+    // Array elements and matrix columns are padded to their alignment.
+    uint32_t element_size = 0;
+    bool padded = false;
+    if (type != NULL && type->columns > 1) {
+        rgsl_text_printf(output, "[%u][%u]", type->columns, member->column_stride / 4);
+        element_size = type->columns * member->column_stride;
+        padded = member->column_stride > type->rows * 4;
+    } else if (type != NULL) {
+        element_size = type->rows * 4;
+        uint32_t components = member->array_size > 0 ? member->stride / 4 : type->rows;
+        if (components > 1) {
+            rgsl_text_printf(output, "[%u]", components);
+        }
+        padded = member->array_size > 0 && member->stride > element_size;
+    }
+    rgsl_text_printf(output, "; // %s", member->structure != NULL ? member->structure->name : type->name);
+    if (member->array_size == RGSL_RUNTIME_ARRAY) {
+        rgsl_text_printf(output, "[]");
+    } else if (member->array_size > 0) {
+        rgsl_text_printf(output, "[%u]", member->array_size);
+    }
+    if (padded) {
+        bool columns = type->columns > 1;
+        rgsl_text_printf(output, ", %s padded to %u bytes", columns ? "columns" : "elements", columns ? member->column_stride : member->stride);
+    }
+    rgsl_text_printf(output, "\n");
+}
+
+void rgsl_write_block_mirror(struct rgsl_text* output, const struct rgsl_block_layout* block) {
+    const char* packing = PACKING_NAMES[block->packing];
+    const char* struct_name = rgsl_mirror_name(block);
+    if (block->kind == RGSL_LAYOUT_UNIFORM_BLOCK) {
+        rgsl_text_printf(output, "// %s mirror of the uniform block %s, uploaded with a single buffer write.\n", packing, block->name);
+    } else {
+        rgsl_text_printf(output, "// %s mirror of the %s %s.\n", packing, LAYOUT_KIND_NAMES[block->kind], block->name);
+    }
+    rgsl_text_printf(output, "struct %s {\n", struct_name);
+    uint32_t offset = 0;
+    size_t pad_count = 0;
+    bool runtime_array = false;
+    for (size_t i = 0; i < block->member_count; i++) {
+        const struct rgsl_block_member* member = &block->members[i];
+        rgsl_write_padding(output, member->offset - offset, &pad_count);
+        rgsl_write_mirror_member(output, member);
+        runtime_array = member->array_size == RGSL_RUNTIME_ARRAY;
+        offset = member->offset + member->size;
+    }
+    if (!runtime_array) {
+        rgsl_write_padding(output, block->size - offset, &pad_count);
+    }
+    rgsl_text_printf(output, "};\n");
+    for (size_t i = 0; i < block->member_count; i++) {
+        rgsl_text_printf(output, "_Static_assert(offsetof(struct %s, %s) == %u, \"%s offset of %s.%s\");\n",
+            struct_name, block->members[i].name, block->members[i].offset, packing, block->name, block->members[i].name);
+    }
+    // The size of a structure ending with a flexible array member is only known to the compiler.
+    if (!runtime_array) {
+        rgsl_text_printf(output, "_Static_assert(sizeof(struct %s) == %u, \"%s size of %s\");\n", struct_name, block->size, packing, block->name);
+    }
+    rgsl_text_printf(output, "\n");
+}
+
+void rgsl_block_layout_free(struct rgsl_block_layout* block) {
+    if (block == NULL) {
+        return;
+    }
+    for (size_t i = 0; i < block->member_count; i++) {
+        rgsl_free(block->members[i].name);
+    }
+    rgsl_free(block->members);
+    rgsl_free(block->mirror_name);
+    rgsl_free(block->name);
+    rgsl_free(block);
+}
\ No newline at end of file
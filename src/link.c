@@ -0,0 +1,1088 @@
+#include <RGSL/link.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/termio.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+
+#define RGSL_SPIRV_MAGIC 0x07230203u
+#define RGSL_SPIRV_HEADER_WORDS 5
+
+// Marks the IDs defined in the function being keyed, numbered by definition.
+#define RGSL_LINK_LOCAL_ID 0x80000000u
+
+enum rgsl_link_opcode {
+    RGSL_LINK_OP_SOURCE_CONTINUED = 2,
+    RGSL_LINK_OP_SOURCE = 3,
+    RGSL_LINK_OP_SOURCE_EXTENSION = 4,
+    RGSL_LINK_OP_NAME = 5,
+    RGSL_LINK_OP_MEMBER_NAME = 6,
+    RGSL_LINK_OP_STRING = 7,
+    RGSL_LINK_OP_LINE = 8,
+    RGSL_LINK_OP_EXTENSION = 10,
+    RGSL_LINK_OP_EXT_INST_IMPORT = 11,
+    RGSL_LINK_OP_MEMORY_MODEL = 14,
+    RGSL_LINK_OP_ENTRY_POINT = 15,
+    RGSL_LINK_OP_EXECUTION_MODE = 16,
+    RGSL_LINK_OP_CAPABILITY = 17,
+    RGSL_LINK_OP_FUNCTION = 54,
+    RGSL_LINK_OP_FUNCTION_END = 56,
+    RGSL_LINK_OP_FUNCTION_CALL = 57,
+    RGSL_LINK_OP_VARIABLE = 59,
+    RGSL_LINK_OP_DECORATE = 71,
+    RGSL_LINK_OP_MEMBER_DECORATE = 72,
+    RGSL_LINK_OP_NO_LINE = 317,
+    RGSL_LINK_OP_MODULE_PROCESSED = 330,
+    RGSL_LINK_OP_EXECUTION_MODE_ID = 331,
+    RGSL_LINK_OP_DECORATE_ID = 332,
+    RGSL_LINK_OP_DECORATE_STRING = 5632,
+    RGSL_LINK_OP_MEMBER_DECORATE_STRING = 5633
+};
+
+/**
+ * Sections of a module, in the order of the logical layout.
+ */
+enum rgsl_link_section {
+    RGSL_LINK_CAPABILITIES,
+    RGSL_LINK_EXTENSIONS,
+    RGSL_LINK_IMPORTS,
+    RGSL_LINK_MEMORY_MODEL,
+    RGSL_LINK_ENTRY_POINTS,
+    RGSL_LINK_EXECUTION_MODES,
+    RGSL_LINK_DEBUG,
+    RGSL_LINK_ANNOTATIONS,
+    RGSL_LINK_GLOBALS,
+    RGSL_LINK_FUNCTIONS,
+    RGSL_LINK_SECTION_COUNT
+};
+
+/**
+ * Operands of an opcode, one character per operand:
+ * 't' result type, 'r' result, 'i' ID, 'l' literal word, 's' literal string,
+ * 'm' memory operands, 'g' image operands, 'w' literal and label pairs of
+ * OpSwitch, 'o' operation of OpSpecConstantOp. A '*' repeats the previous
+ * operand up to the end of the instruction, trailing operands are optional.
+ */
+struct rgsl_link_opcode_operands {
+    uint32_t opcode;
+    const char* operands;
+};
+
+static const struct rgsl_link_opcode_operands OPCODE_OPERANDS[] = {
+    {0, ""},            // OpNop
+    {1, "tr"},          // OpUndef
+    {2, "s"},           // OpSourceContinued
+    {3, "llis"},        // OpSource
+    {4, "s"},           // OpSourceExtension
+    {5, "is"},          // OpName
+    {6, "ils"},         // OpMemberName
+    {7, "rs"},          // OpString
+    {8, "ill"},         // OpLine
+    {10, "s"},          // OpExtension
+    {11, "rs"},         // OpExtInstImport
+    {12, "trili*"},     // OpExtInst
+    {14, "ll"},         // OpMemoryModel
+    {15, "lisi*"},      // OpEntryPoint
+    {16, "il*"},        // OpExecutionMode
+    {17, "l"},          // OpCapability
+    {19, "r"},          // OpTypeVoid
+    {20, "r"},          // OpTypeBool
+    {21, "rll"},        // OpTypeInt
+    {22, "rl*"},        // OpTypeFloat
+    {23, "ril"},        // OpTypeVector
+    {24, "ril"},        // OpTypeMatrix
+    {25, "ril*"},       // OpTypeImage
+    {26, "r"},          // OpTypeSampler
+    {27, "ri"},         // OpTypeSampledImage
+    {28, "rii"},        // OpTypeArray
+    {29, "ri"},         // OpTypeRuntimeArray
+    {30, "ri*"},        // OpTypeStruct
+    {31, "rs"},         // OpTypeOpaque
+    {32, "rli"},        // OpTypePointer
+    {33, "ri*"},        // OpTypeFunction
+    {41, "tr"},         // OpConstantTrue
+    {42, "tr"},         // OpConstantFalse
+    {43, "trl*"},       // OpConstant
+    {44, "tri*"},       // OpConstantComposite
+    {45, "trlll"},      // OpConstantSampler
+    {46, "tr"},         // OpConstantNull
+    {48, "tr"},         // OpSpecConstantTrue
+    {49, "tr"},         // OpSpecConstantFalse
+    {50, "trl*"},       // OpSpecConstant
+    {51, "tri*"},       // OpSpecConstantComposite
+    {52, "tro"},        // OpSpecConstantOp
+    {54, "trli"},       // OpFunction
+    {55, "tr"},         // OpFunctionParameter
+    {56, ""},           // OpFunctionEnd
+    {57, "tri*"},       // OpFunctionCall
+    {59, "trli"},       // OpVariable
+    {60, "triii"},      // OpImageTexelPointer
+    {61, "trim"},       // OpLoad
+    {62, "iim"},        // OpStore
+    {63, "iimm"},       // OpCopyMemory
+    {64, "iiimm"},      // OpCopyMemorySized
+    {65, "tri*"},       // OpAccessChain
+    {66, "tri*"},       // OpInBoundsAccessChain
+    {67, "tri*"},       // OpPtrAccessChain
+    {68, "tril"},       // OpArrayLength
+    {70, "tri*"},       // OpInBoundsPtrAccessChain
+    {71, "il*"},        // OpDecorate
+    {72, "il*"},        // OpMemberDecorate
+    {77, "trii"},       // OpVectorExtractDynamic
+    {78, "triii"},      // OpVectorInsertDynamic
+    {79, "triil*"},     // OpVectorShuffle
+    {80, "tri*"},       // OpCompositeConstruct
+    {81, "tril*"},      // OpCompositeExtract
+    {82, "triil*"},     // OpCompositeInsert
+    {83, "tri"},        // OpCopyObject
+    {84, "tri"},        // OpTranspose
+    {86, "trii"},       // OpSampledImage
+    {87, "triig"},      // OpImageSampleImplicitLod
+    {88, "triig"},      // OpImageSampleExplicitLod
+    {89, "triiig"},     // OpImageSampleDrefImplicitLod
+    {90, "triiig"},     // OpImageSampleDrefExplicitLod
+    {91, "triig"},      // OpImageSampleProjImplicitLod
+    {92, "triig"},      // OpImageSampleProjExplicitLod
+    {93, "triiig"},     // OpImageSampleProjDrefImplicitLod
+    {94, "triiig"},     // OpImageSampleProjDrefExplicitLod
+    {95, "triig"},      // OpImageFetch
+    {96, "triiig"},     // OpImageGather
+    {97, "triiig"},     // OpImageDrefGather
+    {98, "triig"},      // OpImageRead
+    {99, "iiig"},       // OpImageWrite
+    {100, "tri"},       // OpImage
+    {101, "tri"},       // OpImageQueryFormat
+    {102, "tri"},       // OpImageQueryOrder
+    {103, "trii"},      // OpImageQuerySizeLod
+    {104, "tri"},       // OpImageQuerySize
+    {105, "trii"},      // OpImageQueryLod
+    {106, "tri"},       // OpImageQueryLevels
+    {107, "tri"},       // OpImageQuerySamples
+    {109, "tri"},       // OpConvertFToU
+    {110, "tri"},       // OpConvertFToS
+    {111, "tri"},       // OpConvertSToF
+    {112, "tri"},       // OpConvertUToF
+    {113, "tri"},       // OpUConvert
+    {114, "tri"},       // OpSConvert
+    {115, "tri"},       // OpFConvert
+    {116, "tri"},       // OpQuantizeToF16
+    {124, "tri"},       // OpBitcast
+    {126, "tri"},       // OpSNegate
+    {127, "tri"},       // OpFNegate
+    {128, "trii"},      // OpIAdd
+    {129, "trii"},      // OpFAdd
+    {130, "trii"},      // OpISub
+    {131, "trii"},      // OpFSub
+    {132, "trii"},      // OpIMul
+    {133, "trii"},      // OpFMul
+    {134, "trii"},      // OpUDiv
+    {135, "trii"},      // OpSDiv
+    {136, "trii"},      // OpFDiv
+    {137, "trii"},      // OpUMod
+    {138, "trii"},      // OpSRem
+    {139, "trii"},      // OpSMod
+    {140, "trii"},      // OpFRem
+    {141, "trii"},      // OpFMod
+    {142, "trii"},      // OpVectorTimesScalar
+    {143, "trii"},      // OpMatrixTimesScalar
+    {144, "trii"},      // OpVectorTimesMatrix
+    {145, "trii"},      // OpMatrixTimesVector
+    {146, "trii"},      // OpMatrixTimesMatrix
+    {147, "trii"},      // OpOuterProduct
+    {148, "trii"},      // OpDot
+    {149, "trii"},      // OpIAddCarry
+    {150, "trii"},      // OpISubBorrow
+    {151, "trii"},      // OpUMulExtended
+    {152, "trii"},      // OpSMulExtended
+    {154, "tri"},       // OpAny
+    {155, "tri"},       // OpAll
+    {156, "tri"},       // OpIsNan
+    {157, "tri"},       // OpIsInf
+    {158, "tri"},       // OpIsFinite
+    {159, "tri"},       // OpIsNormal
+    {160, "tri"},       // OpSignBitSet
+    {161, "trii"},      // OpLessOrGreater
+    {162, "trii"},      // OpOrdered
+    {163, "trii"},      // OpUnordered
+    {164, "trii"},      // OpLogicalEqual
+    {165, "trii"},      // OpLogicalNotEqual
+    {166, "trii"},      // OpLogicalOr
+    {167, "trii"},      // OpLogicalAnd
+    {168, "tri"},       // OpLogicalNot
+    {169, "triii"},     // OpSelect
+    {170, "trii"},      // OpIEqual
+    {171, "trii"},      // OpINotEqual
+    {172, "trii"},      // OpUGreaterThan
+    {173, "trii"},      // OpSGreaterThan
+    {174, "trii"},      // OpUGreaterThanEqual
+    {175, "trii"},      // OpSGreaterThanEqual
+    {176, "trii"},      // OpULessThan
+    {177, "trii"},      // OpSLessThan
+    {178, "trii"},      // OpULessThanEqual
+    {179, "trii"},      // OpSLessThanEqual
+    {180, "trii"},      // OpFOrdEqual
+    {181, "trii"},      // OpFUnordEqual
+    {182, "trii"},      // OpFOrdNotEqual
+    {183, "trii"},      // OpFUnordNotEqual
+    {184, "trii"},      // OpFOrdLessThan
+    {185, "trii"},      // OpFUnordLessThan
+    {186, "trii"},      // OpFOrdGreaterThan
+    {187, "trii"},      // OpFUnordGreaterThan
+    {188, "trii"},      // OpFOrdLessThanEqual
+    {189, "trii"},      // OpFUnordLessThanEqual
+    {190, "trii"},      // OpFOrdGreaterThanEqual
+    {191, "trii"},      // OpFUnordGreaterThanEqual
+    {194, "trii"},      // OpShiftRightLogical
+    {195, "trii"},      // OpShiftRightArithmetic
+    {196, "trii"},      // OpShiftLeftLogical
+    {197, "trii"},      // OpBitwiseOr
+    {198, "trii"},      // OpBitwiseXor
+    {199, "trii"},      // OpBitwiseAnd
+    {200, "tri"},       // OpNot
+    {201, "triiii"},    // OpBitFieldInsert
+    {202, "triii"},     // OpBitFieldSExtract
+    {203, "triii"},     // OpBitFieldUExtract
+    {204, "tri"},       // OpBitReverse
+    {205, "tri"},       // OpBitCount
+    {207, "tri"},       // OpDPdx
+    {208, "tri"},       // OpDPdy
+    {209, "tri"},       // OpFwidth
+    {210, "tri"},       // OpDPdxFine
+    {211, "tri"},       // OpDPdyFine
+    {212, "tri"},       // OpFwidthFine
+    {213, "tri"},       // OpDPdxCoarse
+    {214, "tri"},       // OpDPdyCoarse
+    {215, "tri"},       // OpFwidthCoarse
+    {218, ""},          // OpEmitVertex
+    {219, ""},          // OpEndPrimitive
+    {220, "i"},         // OpEmitStreamVertex
+    {221, "i"},         // OpEndStreamPrimitive
+    {224, "iii"},       // OpControlBarrier
+    {225, "ii"},        // OpMemoryBarrier
+    {227, "triii"},     // OpAtomicLoad
+    {228, "iiii"},      // OpAtomicStore
+    {229, "triiii"},    // OpAtomicExchange
+    {230, "triiiiii"},  // OpAtomicCompareExchange
+    {231, "triiiiii"},  // OpAtomicCompareExchangeWeak
+    {232, "triii"},     // OpAtomicIIncrement
+    {233, "triii"},     // OpAtomicIDecrement
+    {234, "triiii"},    // OpAtomicIAdd
+    {235, "triiii"},    // OpAtomicISub
+    {236, "triiii"},    // OpAtomicSMin
+    {237, "triiii"},    // OpAtomicUMin
+    {238, "triiii"},    // OpAtomicSMax
+    {239, "triiii"},    // OpAtomicUMax
+    {240, "triiii"},    // OpAtomicAnd
+    {241, "triiii"},    // OpAtomicOr
+    {242, "triiii"},    // OpAtomicXor
+    {245, "tri*"},      // OpPhi
+    {246, "iil*"},      // OpLoopMerge
+    {247, "il"},        // OpSelectionMerge
+    {248, "r"},         // OpLabel
+    {249, "i"},         // OpBranch
+    {250, "iiil*"},     // OpBranchConditional
+    {251, "iiw"},       // OpSwitch
+    {252, ""},          // OpKill
+    {253, ""},          // OpReturn
+    {254, "i"},         // OpReturnValue
+    {255, ""},          // OpUnreachable
+    {317, ""},          // OpNoLine
+    {330, "s"},         // OpModuleProcessed
+    {331, "ili*"},      // OpExecutionModeId
+    {332, "ili*"},      // OpDecorateId
+    {400, "tri"},       // OpCopyLogical
+    {4416, ""},         // OpTerminateInvocation
+    {5380, ""},         // OpDemoteToHelperInvocation
+    {5381, "tr"},       // OpIsHelperInvocationEXT
+    {5632, "ils*"},     // OpDecorateString
+    {5633, "ills*"}     // OpMemberDecorateString
+};
+
+// IDs following the mask of image operands: one per operand, two for Grad.
+#define RGSL_IMAGE_OPERANDS_WITH_ID 0x103FFu
+#define RGSL_IMAGE_OPERAND_GRAD 0x4u
+
+// Memory operands followed by a literal (Aligned), then by a scope ID.
+#define RGSL_MEMORY_OPERAND_ALIGNED 0x2u
+#define RGSL_MEMORY_OPERAND_AVAILABLE 0x8u
+#define RGSL_MEMORY_OPERAND_VISIBLE 0x10u
+
+// Operations of OpSpecConstantOp taking literals after their IDs.
+#define RGSL_LINK_OP_VECTOR_SHUFFLE 79
+#define RGSL_LINK_OP_COMPOSITE_EXTRACT 81
+#define RGSL_LINK_OP_COMPOSITE_INSERT 82
+
+// Storage classes of the resources, shared by the stages declaring them alike.
+static const uint32_t RESOURCE_STORAGE_CLASSES[] = {
+    0,  // UniformConstant
+    2,  // Uniform
+    9,  // PushConstant
+    12  // StorageBuffer
+};
+
+// Execution models of the stages, in the order of the stage names.
+static const char* const STAGE_NAMES[] = {"vert", "tesc", "tese", "geom", "frag", "comp"};
+static const uint32_t EXECUTION_MODELS[] = {0, 1, 2, 3, 4, 5};
+
+/**
+ * Growable array of words, a section of the linked module or a scratch buffer.
+ */
+struct rgsl_link_words {
+    uint32_t* data;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * A function of a module: its ID and its words, from OpFunction to OpFunctionEnd.
+ */
+struct rgsl_link_function {
+    uint32_t id;
+    size_t start;
+    size_t end;
+    bool keyed;
+};
+
+/**
+ * A module being linked, and the IDs of the linked module given to its IDs.
+ * An ID is dropped when its definition is replaced by an identical one, of this
+ * module or of a previous one. The annotations are indexed by target.
+ */
+struct rgsl_link_module {
+    const uint32_t* words;
+    size_t word_count;
+    uint32_t bound;
+    uint32_t* ids;
+    bool* dropped;
+    uint32_t* locals;
+    uint32_t* decoration_first;
+    uint32_t* decorations;
+    struct rgsl_link_function* functions;
+    size_t function_count;
+    size_t function_start;
+};
+
+/**
+ * State of the linker: the modules, the definitions interned by key, and the
+ * sections of the linked module.
+ */
+struct rgsl_linker {
+    struct rgsl_link_module* modules;
+    size_t count;
+    uint32_t next_id;
+    struct rgsl_hashmap definitions;
+    struct rgsl_hashmap emitted;
+    struct rgsl_link_words key;
+    struct rgsl_link_words positions;
+    struct rgsl_link_words sections[RGSL_LINK_SECTION_COUNT];
+};
+
+bool rgsl_program_module_enabled() {
+    return rgsl_global_options.program_module != 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Words and operands                                                         */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_link_push(struct rgsl_link_words* words, uint32_t word) {
+    if (words->count == words->capacity) {
+        words->capacity = (words->capacity != 0) ? words->capacity * 2 : 64;
+        words->data = (uint32_t *)rgsl_realloc(words->data, words->capacity * sizeof(uint32_t));
+    }
+    words->data[words->count++] = word;
+}
+
+static void rgsl_link_push_words(struct rgsl_link_words* words, const uint32_t* data, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        rgsl_link_push(words, data[i]);
+    }
+}
+
+static void rgsl_link_words_free(struct rgsl_link_words* words) {
+    rgsl_free(words->data);
+    words->data = NULL;
+    words->count = words->capacity = 0;
+}
+
+static const char* rgsl_link_find_operands(uint32_t opcode) {
+    size_t low = 0;
+    size_t high = sizeof(OPCODE_OPERANDS) / sizeof(OPCODE_OPERANDS[0]);
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (OPCODE_OPERANDS[middle].opcode < opcode) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    size_t count = sizeof(OPCODE_OPERANDS) / sizeof(OPCODE_OPERANDS[0]);
+    return (low < count && OPCODE_OPERANDS[low].opcode == opcode) ? OPCODE_OPERANDS[low].operands : NULL;
+}
+
+// Number of words of the literal string at a position, 0 if it is not terminated.
+static size_t rgsl_link_string_words(const uint32_t* words, size_t position, size_t end) {
+    for (size_t i = position; i < end; i++) {
+        uint32_t word = words[i];
+        if ((word & 0xFFu) == 0 || (word & 0xFF00u) == 0 || (word & 0xFF0000u) == 0 || (word & 0xFF000000u) == 0) {
+            return i - position + 1;
+        }
+    }
+    return 0;
+}
+
+static unsigned rgsl_link_bit_count(uint32_t value) {
+    unsigned count = 0;
+    for (; value != 0; value &= value - 1) {
+        count++;
+    }
+    return count;
+}
+
+static void rgsl_link_push_ids(struct rgsl_link_words* positions, size_t* position, size_t count) {
+    for (size_t i = 0; i < count; i++) {
+        rgsl_link_push(positions, (uint32_t)(*position)++);
+    }
+}
+
+/**
+ * Finds the positions of the IDs an instruction uses, after its result (if any).
+ * Returns false if the opcode is unknown or the operands do not fit its words.
+ */
+static bool rgsl_link_find_ids(const uint32_t* instruction, struct rgsl_link_words* positions, size_t* out_result) {
+    uint32_t opcode = instruction[0] & 0xFFFFu;
+    size_t length = instruction[0] >> 16;
+    const char* operands = rgsl_link_find_operands(opcode);
+    positions->count = 0;
+    *out_result = 0;
+    if (operands == NULL) {
+        return false;
+    }
+    size_t position = 1;
+    const char* kind = operands;
+    while (position < length) {
+        if (*kind == '\0') {
+            return false;
+        }
+        switch (*kind) {
+        case 't':
+        case 'i':
+            rgsl_link_push(positions, (uint32_t)position++);
+            break;
+        case 'r':
+            *out_result = position++;
+            break;
+        case 'l':
+            position++;
+            break;
+        case 's': {
+            size_t count = rgsl_link_string_words(instruction, position, length);
+            if (count == 0) {
+                return false;
+            }
+            position += count;
+            break;
+        }
+        case 'm': {
+            uint32_t mask = instruction[position++];
+            position += (mask & RGSL_MEMORY_OPERAND_ALIGNED) ? 1 : 0;
+            rgsl_link_push_ids(positions, &position, ((mask & RGSL_MEMORY_OPERAND_AVAILABLE) ? 1 : 0) + ((mask & RGSL_MEMORY_OPERAND_VISIBLE) ? 1 : 0));
+            break;
+        }
+        case 'g': {
+            uint32_t mask = instruction[position++];
+            rgsl_link_push_ids(positions, &position, rgsl_link_bit_count(mask & RGSL_IMAGE_OPERANDS_WITH_ID) + ((mask & RGSL_IMAGE_OPERAND_GRAD) ? 1 : 0));
+            break;
+        }
+        case 'w':
+            for (; position + 1 < length; position += 2) {
+                rgsl_link_push(positions, (uint32_t)(position + 1));
+            }
+            break;
+        case 'o': {
+            uint32_t operation = instruction[position++];
+            size_t ids = length - position;
+            if (operation == RGSL_LINK_OP_COMPOSITE_EXTRACT) {
+                ids = 1;
+            } else if (operation == RGSL_LINK_OP_VECTOR_SHUFFLE || operation == RGSL_LINK_OP_COMPOSITE_INSERT) {
+                ids = 2;
+            }
+            if (ids > length - position) {
+                return false;
+            }
+            rgsl_link_push_ids(positions, &position, ids);
+            position = length; // The literals of the operation
+            break;
+        }
+        }
+        if (kind[1] != '*') {
+            kind++;
+        }
+    }
+    return position == length;
+}
+
+static enum rgsl_link_section rgsl_link_section_of(uint32_t opcode) {
+    switch (opcode) {
+    case RGSL_LINK_OP_CAPABILITY:
+        return RGSL_LINK_CAPABILITIES;
+    case RGSL_LINK_OP_EXTENSION:
+        return RGSL_LINK_EXTENSIONS;
+    case RGSL_LINK_OP_EXT_INST_IMPORT:
+        return RGSL_LINK_IMPORTS;
+    case RGSL_LINK_OP_MEMORY_MODEL:
+        return RGSL_LINK_MEMORY_MODEL;
+    case RGSL_LINK_OP_ENTRY_POINT:
+        return RGSL_LINK_ENTRY_POINTS;
+    case RGSL_LINK_OP_EXECUTION_MODE:
+    case RGSL_LINK_OP_EXECUTION_MODE_ID:
+        return RGSL_LINK_EXECUTION_MODES;
+    case RGSL_LINK_OP_SOURCE_CONTINUED:
+    case RGSL_LINK_OP_SOURCE:
+    case RGSL_LINK_OP_SOURCE_EXTENSION:
+    case RGSL_LINK_OP_NAME:
+    case RGSL_LINK_OP_MEMBER_NAME:
+    case RGSL_LINK_OP_STRING:
+    case RGSL_LINK_OP_MODULE_PROCESSED:
+        return RGSL_LINK_DEBUG;
+    case RGSL_LINK_OP_DECORATE:
+    case RGSL_LINK_OP_MEMBER_DECORATE:
+    case RGSL_LINK_OP_DECORATE_ID:
+    case RGSL_LINK_OP_DECORATE_STRING:
+    case RGSL_LINK_OP_MEMBER_DECORATE_STRING:
+        return RGSL_LINK_ANNOTATIONS;
+    default:
+        return RGSL_LINK_GLOBALS;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Reading the modules                                                        */
+/* -------------------------------------------------------------------------- */
+
+// Checks the instructions of a module, indexes its annotations and its functions.
+static bool rgsl_link_read_module(struct rgsl_linker* linker, struct rgsl_link_module* module, size_t index) {
+    const uint32_t* words = module->words;
+    if (module->word_count < RGSL_SPIRV_HEADER_WORDS || words[0] != RGSL_SPIRV_MAGIC) {
+        rgsl_printf_info(1, "Stage %zu is not a SPIR-V module\n", index);
+        return false;
+    }
+    module->bound = words[3];
+    module->ids = (uint32_t *)rgsl_calloc(module->bound, sizeof(uint32_t));
+    module->dropped = (bool *)rgsl_calloc(module->bound, sizeof(bool));
+    module->locals = (uint32_t *)rgsl_calloc(module->bound, sizeof(uint32_t));
+    module->decoration_first = (uint32_t *)rgsl_calloc((size_t)module->bound + 1, sizeof(uint32_t));
+    size_t decoration_count = 0;
+    size_t capacity = 0;
+    module->function_start = module->word_count;
+    struct rgsl_link_function* function = NULL;
+
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->word_count; ) {
+        size_t length = words[offset] >> 16;
+        uint32_t opcode = words[offset] & 0xFFFFu;
+        size_t result;
+        if (length == 0 || offset + length > module->word_count) {
+            rgsl_printf_info(1, "Stage %zu has a truncated instruction at word %zu\n", index, offset);
+            return false;
+        }
+        if (!rgsl_link_find_ids(&words[offset], &linker->positions, &result)) {
+            rgsl_printf_info(1, "Stage %zu holds the opcode %u, whose operands the linker does not know\n", index, (unsigned)opcode);
+            return false;
+        }
+        for (size_t i = 0; i < linker->positions.count; i++) {
+            if (words[offset + linker->positions.data[i]] >= module->bound) {
+                rgsl_printf_info(1, "Stage %zu uses an ID out of its bound at word %zu\n", index, offset);
+                return false;
+            }
+        }
+        if (result != 0 && (words[offset + result] == 0 || words[offset + result] >= module->bound)) {
+            rgsl_printf_info(1, "Stage %zu defines an ID out of its bound at word %zu\n", index, offset);
+            return false;
+        }
+        if (function == NULL && module->function_count > 0 && opcode != RGSL_LINK_OP_FUNCTION) {
+            rgsl_printf_info(1, "Stage %zu has an instruction between its functions at word %zu\n", index, offset);
+            return false;
+        }
+        if (rgsl_link_section_of(opcode) == RGSL_LINK_ANNOTATIONS && module->function_count == 0) {
+            module->decoration_first[words[offset + 1]]++;
+            decoration_count++;
+        }
+        if (opcode == RGSL_LINK_OP_FUNCTION) {
+            if (module->function_count == capacity) {
+                capacity = (capacity != 0) ? capacity * 2 : 8;
+                module->functions = (struct rgsl_link_function *)rgsl_realloc(module->functions, capacity * sizeof(struct rgsl_link_function));
+            }
+            function = &module->functions[module->function_count++];
+            function->id = words[offset + 2];
+            function->start = offset;
+            function->keyed = false;
+            if (module->function_count == 1) {
+                module->function_start = offset;
+            }
+        } else if (opcode == RGSL_LINK_OP_FUNCTION_END && function != NULL) {
+            function->end = offset + length;
+            function = NULL;
+        }
+        offset += length;
+    }
+    if (function != NULL) {
+        rgsl_printf_info(1, "Stage %zu has a function without end\n", index);
+        return false;
+    }
+
+    // Counting sort of the annotations by target, in module order.
+    uint32_t total = 0;
+    for (uint32_t id = 0; id <= module->bound; id++) {
+        uint32_t count = module->decoration_first[id];
+        module->decoration_first[id] = total;
+        total += count;
+    }
+    module->decorations = (uint32_t *)rgsl_malloc((decoration_count + 1) * sizeof(uint32_t));
+    uint32_t* next = (uint32_t *)rgsl_calloc(module->bound, sizeof(uint32_t));
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->function_start; offset += words[offset] >> 16) {
+        if (rgsl_link_section_of(words[offset] & 0xFFFFu) == RGSL_LINK_ANNOTATIONS) {
+            uint32_t target = words[offset + 1];
+            module->decorations[module->decoration_first[target] + next[target]++] = (uint32_t)offset;
+        }
+    }
+    rgsl_free(next);
+    return true;
+}
+
+static void rgsl_link_module_free(struct rgsl_link_module* module) {
+    rgsl_free(module->ids);
+    rgsl_free(module->dropped);
+    rgsl_free(module->locals);
+    rgsl_free(module->decoration_first);
+    rgsl_free(module->decorations);
+    rgsl_free(module->functions);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Mapping the IDs                                                            */
+/* -------------------------------------------------------------------------- */
+
+// Gives an ID its own ID in the linked module.
+static void rgsl_link_new_id(struct rgsl_linker* linker, struct rgsl_link_module* module, uint32_t id) {
+    module->ids[id] = linker->next_id++;
+}
+
+/**
+ * Gives an ID the ID of the same definition, if one was keyed already, or its own.
+ * Returns true if the definition is dropped.
+ */
+static bool rgsl_link_intern(struct rgsl_linker* linker, struct rgsl_link_module* module, uint32_t id, const char* prefix, const void* key, size_t size) {
+    struct rgsl_hash128 hash = rgsl_hash128_bytes(key, size);
+    char name[40];
+    snprintf(name, sizeof(name), "%s%016" PRIx64 "%016" PRIx64, prefix, hash.low, hash.high);
+    void* existing;
+    if (rgsl_hashmap_find(&linker->definitions, name, &existing)) {
+        module->ids[id] = (uint32_t)(uintptr_t)existing;
+        module->dropped[id] = true;
+        return true;
+    }
+    rgsl_link_new_id(linker, module, id);
+    rgsl_hashmap_set(&linker->definitions, name, (void*)(uintptr_t)module->ids[id]);
+    return false;
+}
+
+/**
+ * Appends the key of the annotations of an ID, without their target.
+ * Returns false if one of them uses other IDs, which keys cannot express.
+ */
+static bool rgsl_link_key_decorations(struct rgsl_linker* linker, const struct rgsl_link_module* module, uint32_t id) {
+    for (uint32_t i = module->decoration_first[id]; i < module->decoration_first[id + 1]; i++) {
+        const uint32_t* decoration = &module->words[module->decorations[i]];
+        if ((decoration[0] & 0xFFFFu) == RGSL_LINK_OP_DECORATE_ID) {
+            return false;
+        }
+        rgsl_link_push(&linker->key, decoration[0]);
+        rgsl_link_push_words(&linker->key, decoration + 2, (decoration[0] >> 16) - 2);
+    }
+    return true;
+}
+
+/**
+ * Appends the key of an instruction: its words, the IDs replaced by their linked
+ * IDs, or by their number for the IDs local to a function. The result is left out.
+ * Returns false if an ID is not mapped yet.
+ */
+static bool rgsl_link_key_instruction(struct rgsl_linker* linker, const struct rgsl_link_module* module, const uint32_t* instruction) {
+    size_t result;
+    size_t length = instruction[0] >> 16;
+    rgsl_link_find_ids(instruction, &linker->positions, &result);
+    size_t next = 0;
+    rgsl_link_push(&linker->key, instruction[0]);
+    for (size_t position = 1; position < length; position++) {
+        uint32_t word = instruction[position];
+        if (position == result) {
+            continue;
+        }
+        if (next < linker->positions.count && linker->positions.data[next] == position) {
+            next++;
+            if (module->locals[word] != 0) {
+                word = RGSL_LINK_LOCAL_ID | module->locals[word];
+            } else if (module->ids[word] != 0) {
+                word = module->ids[word];
+            } else {
+                return false;
+            }
+        }
+        rgsl_link_push(&linker->key, word);
+    }
+    return true;
+}
+
+static bool rgsl_link_is_resource(uint32_t storage_class) {
+    for (size_t i = 0; i < sizeof(RESOURCE_STORAGE_CLASSES) / sizeof(RESOURCE_STORAGE_CLASSES[0]); i++) {
+        if (RESOURCE_STORAGE_CLASSES[i] == storage_class) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Appends the key of the name of an ID, resources being matched by name as in a linked GL program.
+static void rgsl_link_key_name(struct rgsl_linker* linker, const struct rgsl_link_module* module, uint32_t id) {
+    const uint32_t* words = module->words;
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->function_start; offset += words[offset] >> 16) {
+        if ((words[offset] & 0xFFFFu) == RGSL_LINK_OP_NAME && words[offset + 1] == id) {
+            rgsl_link_push_words(&linker->key, &words[offset + 2], (words[offset] >> 16) - 2);
+            return;
+        }
+    }
+}
+
+// Maps the imports, strings and global definitions of a module, interning what may be shared.
+static void rgsl_link_map_globals(struct rgsl_linker* linker, struct rgsl_link_module* module) {
+    const uint32_t* words = module->words;
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->function_start; offset += words[offset] >> 16) {
+        uint32_t opcode = words[offset] & 0xFFFFu;
+        size_t length = words[offset] >> 16;
+        size_t result;
+        rgsl_link_find_ids(&words[offset], &linker->positions, &result);
+        if (result == 0) {
+            continue;
+        }
+        uint32_t id = words[offset + result];
+        if (opcode == RGSL_LINK_OP_EXT_INST_IMPORT) {
+            rgsl_link_intern(linker, module, id, "I", &words[offset + 2], (length - 2) * sizeof(uint32_t));
+        } else if (opcode == RGSL_LINK_OP_STRING) {
+            rgsl_link_intern(linker, module, id, "S", &words[offset + 2], (length - 2) * sizeof(uint32_t));
+        } else if (opcode == RGSL_LINK_OP_VARIABLE && !rgsl_link_is_resource(words[offset + 3])) {
+            // Every stage keeps its own inputs, outputs and private variables.
+            rgsl_link_new_id(linker, module, id);
+        } else {
+            linker->key.count = 0;
+            if (opcode == RGSL_LINK_OP_VARIABLE) {
+                rgsl_link_key_name(linker, module, id);
+            }
+            if (rgsl_link_key_instruction(linker, module, &words[offset]) && rgsl_link_key_decorations(linker, module, id)) {
+                rgsl_link_intern(linker, module, id, "T", linker->key.data, linker->key.count * sizeof(uint32_t));
+            } else {
+                rgsl_link_new_id(linker, module, id);
+            }
+        }
+    }
+}
+
+static bool rgsl_link_is_entry_point(const struct rgsl_link_module* module, uint32_t function) {
+    const uint32_t* words = module->words;
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->function_start; offset += words[offset] >> 16) {
+        if ((words[offset] & 0xFFFFu) == RGSL_LINK_OP_ENTRY_POINT && words[offset + 2] == function) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Numbers the IDs defined in a function, by definition order, 0 when leaving it.
+static void rgsl_link_number_locals(struct rgsl_linker* linker, struct rgsl_link_module* module, const struct rgsl_link_function* function, bool clear) {
+    const uint32_t* words = module->words;
+    uint32_t number = 0;
+    for (size_t offset = function->start; offset < function->end; offset += words[offset] >> 16) {
+        size_t result;
+        rgsl_link_find_ids(&words[offset], &linker->positions, &result);
+        if (result != 0) {
+            module->locals[words[offset + result]] = clear ? 0 : ++number;
+        }
+    }
+}
+
+// Keys the body of a function, with the annotations of its IDs.
+static bool rgsl_link_key_function(struct rgsl_linker* linker, struct rgsl_link_module* module, const struct rgsl_link_function* function) {
+    const uint32_t* words = module->words;
+    linker->key.count = 0;
+    rgsl_link_number_locals(linker, module, function, false);
+    bool keyed = true;
+    for (size_t offset = function->start; keyed && offset < function->end; offset += words[offset] >> 16) {
+        size_t result;
+        keyed = rgsl_link_key_instruction(linker, module, &words[offset]);
+        rgsl_link_find_ids(&words[offset], &linker->positions, &result);
+        if (keyed && result != 0) {
+            keyed = rgsl_link_key_decorations(linker, module, words[offset + result]);
+        }
+    }
+    rgsl_link_number_locals(linker, module, function, true);
+    return keyed;
+}
+
+// Maps the IDs of a function after those of the functions it calls, so that its key can use them.
+static void rgsl_link_map_function(struct rgsl_linker* linker, struct rgsl_link_module* module, struct rgsl_link_function* function) {
+    if (function->keyed) {
+        return;
+    }
+    function->keyed = true; // Recursion is not allowed, a cycle is keyed as unmapped calls.
+    const uint32_t* words = module->words;
+    for (size_t offset = function->start; offset < function->end; offset += words[offset] >> 16) {
+        if ((words[offset] & 0xFFFFu) != RGSL_LINK_OP_FUNCTION_CALL) {
+            continue;
+        }
+        for (size_t i = 0; i < module->function_count; i++) {
+            if (module->functions[i].id == words[offset + 3]) {
+                rgsl_link_map_function(linker, module, &module->functions[i]);
+            }
+        }
+    }
+    // Entry points stay apart, each is bound to the interface of its stage.
+    if (!rgsl_link_is_entry_point(module, function->id) && rgsl_link_key_function(linker, module, function)) {
+        if (rgsl_link_intern(linker, module, function->id, "F", linker->key.data, linker->key.count * sizeof(uint32_t))) {
+            return;
+        }
+    } else {
+        rgsl_link_new_id(linker, module, function->id);
+    }
+    for (size_t offset = function->start; offset < function->end; offset += words[offset] >> 16) {
+        size_t result;
+        rgsl_link_find_ids(&words[offset], &linker->positions, &result);
+        if (result != 0 && words[offset + result] != function->id) {
+            rgsl_link_new_id(linker, module, words[offset + result]);
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Writing the linked module                                                  */
+/* -------------------------------------------------------------------------- */
+
+// Appends an instruction to a section, its IDs replaced by their linked IDs.
+static bool rgsl_link_emit(struct rgsl_linker* linker, const struct rgsl_link_module* module, const uint32_t* instruction, enum rgsl_link_section section) {
+    size_t result;
+    size_t length = instruction[0] >> 16;
+    struct rgsl_link_words* output = &linker->sections[section];
+    size_t start = output->count;
+    rgsl_link_find_ids(instruction, &linker->positions, &result);
+    rgsl_link_push_words(output, instruction, length);
+    if (result != 0) {
+        output->data[start + result] = module->ids[instruction[result]];
+    }
+    for (size_t i = 0; i < linker->positions.count; i++) {
+        uint32_t* word = &output->data[start + linker->positions.data[i]];
+        *word = module->ids[*word];
+        if (*word == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Whether an instruction that is the same in several modules was emitted already.
+static bool rgsl_link_emitted(struct rgsl_linker* linker, const uint32_t* instruction) {
+    struct rgsl_hash128 hash = rgsl_hash128_bytes(instruction, (instruction[0] >> 16) * sizeof(uint32_t));
+    char name[36];
+    snprintf(name, sizeof(name), "%016" PRIx64 "%016" PRIx64, hash.low, hash.high);
+    if (rgsl_hashmap_find(&linker->emitted, name, NULL)) {
+        return true;
+    }
+    rgsl_hashmap_set(&linker->emitted, name, NULL);
+    return false;
+}
+
+static bool rgsl_link_emit_module(struct rgsl_linker* linker, const struct rgsl_link_module* module, size_t index) {
+    const uint32_t* words = module->words;
+    bool success = true;
+    size_t next_function = 0;
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; success && offset < module->word_count; ) {
+        const uint32_t* instruction = &words[offset];
+        uint32_t opcode = instruction[0] & 0xFFFFu;
+        if (offset >= module->function_start) {
+            // Functions are copied whole, unless an identical one was.
+            const struct rgsl_link_function* function = &module->functions[next_function++];
+            if (!module->dropped[function->id]) {
+                for (size_t at = function->start; success && at < function->end; at += words[at] >> 16) {
+                    success = rgsl_link_emit(linker, module, &words[at], RGSL_LINK_FUNCTIONS);
+                }
+            }
+            offset = function->end;
+            continue;
+        }
+        offset += instruction[0] >> 16;
+        enum rgsl_link_section section = rgsl_link_section_of(opcode);
+        size_t result;
+        rgsl_link_find_ids(instruction, &linker->positions, &result);
+        if (result != 0 && module->dropped[instruction[result]]) {
+            continue;
+        }
+        switch (section) {
+        case RGSL_LINK_CAPABILITIES:
+        case RGSL_LINK_EXTENSIONS:
+            if (!rgsl_link_emitted(linker, instruction)) {
+                rgsl_link_push_words(&linker->sections[section], instruction, instruction[0] >> 16);
+            }
+            continue;
+        case RGSL_LINK_MEMORY_MODEL:
+            if (index == 0) {
+                rgsl_link_push_words(&linker->sections[section], instruction, instruction[0] >> 16);
+            }
+            continue;
+        case RGSL_LINK_DEBUG:
+            if (opcode == RGSL_LINK_OP_SOURCE || opcode == RGSL_LINK_OP_SOURCE_CONTINUED || opcode == RGSL_LINK_OP_SOURCE_EXTENSION) {
+                // The stages come from one file, its source is described once.
+                if (index != 0) {
+                    continue;
+                }
+            } else if (opcode == RGSL_LINK_OP_MODULE_PROCESSED) {
+                if (rgsl_link_emitted(linker, instruction)) {
+                    continue;
+                }
+            } else if (opcode != RGSL_LINK_OP_STRING && (module->ids[instruction[1]] == 0 || module->dropped[instruction[1]])) {
+                continue; // Names of a dropped definition, or of the locals of a dropped function
+            }
+            break;
+        case RGSL_LINK_ANNOTATIONS:
+            // The annotations of a dropped definition are part of its key, they are the same.
+            if (module->ids[instruction[1]] == 0 || module->dropped[instruction[1]]) {
+                continue;
+            }
+            break;
+        default:
+            break;
+        }
+        success = rgsl_link_emit(linker, module, instruction, section);
+    }
+    return success;
+}
+
+// Checks that the modules agree on what cannot be merged.
+static bool rgsl_link_check_modules(const struct rgsl_linker* linker) {
+    const uint32_t* memory_model = NULL;
+    for (size_t i = 0; i < linker->count; i++) {
+        const struct rgsl_link_module* module = &linker->modules[i];
+        for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < module->function_start; offset += module->words[offset] >> 16) {
+            if ((module->words[offset] & 0xFFFFu) != RGSL_LINK_OP_MEMORY_MODEL) {
+                continue;
+            }
+            if (memory_model == NULL) {
+                memory_model = &module->words[offset];
+            } else if (memcmp(memory_model, &module->words[offset], 3 * sizeof(uint32_t)) != 0) {
+                rgsl_printf_info(1, "Stage %zu has another memory model than the first one\n", i);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+bool rgsl_link_spirv_modules(const uint32_t* const* modules, const size_t* word_counts, size_t count, uint32_t** out_words, size_t* out_word_count) {
+    *out_words = NULL;
+    *out_word_count = 0;
+    struct rgsl_linker linker = {0};
+    linker.modules = (struct rgsl_link_module *)rgsl_calloc(count, sizeof(struct rgsl_link_module));
+    linker.count = count;
+    linker.next_id = 1;
+    rgsl_hashmap_init(&linker.definitions);
+    rgsl_hashmap_init(&linker.emitted);
+
+    bool success = true;
+    for (size_t i = 0; success && i < count; i++) {
+        linker.modules[i].words = modules[i];
+        linker.modules[i].word_count = word_counts[i];
+        success = rgsl_link_read_module(&linker, &linker.modules[i], i);
+    }
+    success = success && rgsl_link_check_modules(&linker);
+    // Every ID is mapped before any is written, annotations come before their targets.
+    for (size_t i = 0; success && i < count; i++) {
+        struct rgsl_link_module* module = &linker.modules[i];
+        rgsl_link_map_globals(&linker, module);
+        for (size_t j = 0; j < module->function_count; j++) {
+            rgsl_link_map_function(&linker, module, &module->functions[j]);
+        }
+    }
+    for (size_t i = 0; success && i < count; i++) {
+        success = rgsl_link_emit_module(&linker, &linker.modules[i], i);
+        if (!success) {
+            rgsl_printf_info(1, "Stage %zu uses an ID it does not define\n", i);
+        }
+    }
+
+    if (success) {
+        size_t total = RGSL_SPIRV_HEADER_WORDS;
+        for (size_t i = 0; i < RGSL_LINK_SECTION_COUNT; i++) {
+            total += linker.sections[i].count;
+        }
+        uint32_t* words = (uint32_t *)rgsl_malloc(total * sizeof(uint32_t));
+        // The linked module needs the latest version of its modules.
+        uint32_t version = 0;
+        for (size_t i = 0; i < count; i++) {
+            version = (modules[i][1] > version) ? modules[i][1] : version;
+        }
+        words[0] = RGSL_SPIRV_MAGIC;
+        words[1] = version;
+        words[2] = modules[0][2];
+        words[3] = linker.next_id;
+        words[4] = 0;
+        size_t at = RGSL_SPIRV_HEADER_WORDS;
+        for (size_t i = 0; i < RGSL_LINK_SECTION_COUNT; i++) {
+            if (linker.sections[i].count > 0) {
+                memcpy(words + at, linker.sections[i].data, linker.sections[i].count * sizeof(uint32_t));
+                at += linker.sections[i].count;
+            }
+        }
+        *out_words = words;
+        *out_word_count = total;
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        rgsl_link_module_free(&linker.modules[i]);
+    }
+    rgsl_free(linker.modules);
+    for (size_t i = 0; i < RGSL_LINK_SECTION_COUNT; i++) {
+        rgsl_link_words_free(&linker.sections[i]);
+    }
+    rgsl_link_words_free(&linker.key);
+    rgsl_link_words_free(&linker.positions);
+    rgsl_hashmap_free(&linker.definitions, NULL);
+    rgsl_hashmap_free(&linker.emitted, NULL);
+    return success;
+}
+
+static uint32_t rgsl_link_execution_model(const char* stage) {
+    for (size_t i = 0; i < sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]); i++) {
+        if (strcmp(stage, STAGE_NAMES[i]) == 0) {
+            return EXECUTION_MODELS[i];
+        }
+    }
+    return UINT32_MAX;
+}
+
+const char* rgsl_spirv_entry_point(const uint32_t* words, size_t word_count, const char* stage) {
+    uint32_t model = rgsl_link_execution_model(stage);
+    if (word_count < RGSL_SPIRV_HEADER_WORDS || words[0] != RGSL_SPIRV_MAGIC) {
+        return NULL;
+    }
+    for (size_t offset = RGSL_SPIRV_HEADER_WORDS; offset < word_count; ) {
+        size_t length = words[offset] >> 16;
+        uint32_t opcode = words[offset] & 0xFFFFu;
+        if (length == 0 || offset + length > word_count || opcode == RGSL_LINK_OP_FUNCTION) {
+            return NULL;
+        }
+        if (opcode == RGSL_LINK_OP_ENTRY_POINT && length > 3 && words[offset + 1] == model && rgsl_link_string_words(words, offset + 3, offset + length) != 0) {
+            return (const char*)&words[offset + 3];
+        }
+        offset += length;
+    }
+    return NULL;
+}
\ No newline at end of file
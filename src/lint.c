@@ -0,0 +1,153 @@
+#include <RGSL/lint.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/parser.h>
+#include <RGSL/resolver.h>
+#include <RGSL/termio.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/external/glslang_c.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Comment allowing warnings on its line and the next one, e.g. "// rgsl-lint: allow P001".
+#define RGSL_LINT_ALLOW_MARKER "rgsl-lint: allow"
+
+/**
+ * Stable ID and summary of a warning, in the order of enum rgsl_lint_rule.
+ * IDs are never reused, so that suppressions keep their meaning.
+ */
+struct rgsl_lint_warning {
+    const char* id;
+    const char* summary;
+};
+
+static const struct rgsl_lint_warning LINT_WARNINGS[RGSL_LINT_RULE_COUNT] = {
+    {"P001", "discard in a shader writing a blendable color"},
+    {"P002", "texture sampling in non-uniform control flow"},
+    {"P003", "dynamic indexing of a large array"},
+    {"P004", "highp math in a GLES fragment shader"},
+    {"P005", "per-draw value recomputed per invocation"}
+};
+
+/**
+ * Shader being linted, handed to the callback of the glslang walker.
+ */
+struct rgsl_lint_context {
+    const struct rgsl_shader_data* shader;
+};
+
+static bool suppressed_rules[RGSL_LINT_RULE_COUNT];
+static size_t warning_count;
+static size_t allowed_count;
+static size_t linted_count;
+
+bool rgsl_perf_lint_enabled() {
+    return rgsl_global_options.perf_lint != 0;
+}
+
+bool rgsl_check_perf_lint() {
+    const char* list = rgsl_global_options.perf_lint_suppress;
+    while (list != NULL && *list != '\0') {
+        size_t length = strcspn(list, ", ");
+        if (length > 0) {
+            size_t rule = 0;
+            while (rule < RGSL_LINT_RULE_COUNT && (strlen(LINT_WARNINGS[rule].id) != length || strncmp(LINT_WARNINGS[rule].id, list, length) != 0)) {
+                rule++;
+            }
+            if (rule == RGSL_LINT_RULE_COUNT) {
+                rgsl_printf_error("Unknown performance warning ID: %.*s\n", (int)length, list);
+                return false;
+            }
+            suppressed_rules[rule] = true;
+        }
+        list += length;
+        list += (*list != '\0');
+    }
+    return true;
+}
+
+static bool rgsl_line_allows(const char* code, int line, const char* id) {
+    const char* start = code;
+    for (int i = 1; i < line && start != NULL; i++) {
+        start = strchr(start, '\n');
+        start = (start != NULL) ? start + 1 : NULL;
+    }
+    if (start == NULL || line <= 0) {
+        return false;
+    }
+    size_t length = strcspn(start, "\n");
+    size_t marker_length = strlen(RGSL_LINT_ALLOW_MARKER);
+    size_t id_length = strlen(id);
+    for (size_t i = 0; i + marker_length <= length; i++) {
+        if (strncmp(start + i, RGSL_LINT_ALLOW_MARKER, marker_length) == 0) {
+            for (size_t j = i + marker_length; j + id_length <= length; j++) {
+                if (strncmp(start + j, id, id_length) == 0) {
+                    return true;
+                }
+            }
+            return false;
+        }
+    }
+    return false;
+}
+
+static bool rgsl_source_allows(const struct rgsl_shader_data* shader, const char* file, int line, const char* id) {
+    const char* code = NULL;
+    if (shader->path != NULL && strcmp(file, shader->path) == 0) {
+        code = shader->code;
+    } else if (!rgsl_resolver_read(file, &code, NULL)) {
+        return false;
+    }
+    return code != NULL && (rgsl_line_allows(code, line, id) || rgsl_line_allows(code, line - 1, id));
+}
+
+static void rgsl_report_lint_warning(enum rgsl_lint_rule rule, const char* file, int line, const char* message, void* user) {
+    const struct rgsl_lint_context* context = (const struct rgsl_lint_context*)user;
+    const struct rgsl_shader_data* shader = context->shader;
+    if (suppressed_rules[rule]) {
+        return;
+    }
+    // glslang sees the preprocessed code under the shader path, only its own includes have other names.
+    const char* source = file;
+    int source_line = line;
+    if (file == NULL || file[0] == '\0' || (shader->path != NULL && strcmp(file, shader->path) == 0)) {
+        source = shader->path;
+        if (!rgsl_line_map_lookup(&shader->line_map, line, &source, &source_line)) {
+            source = shader->path;
+            source_line = line;
+        }
+    }
+    if (source == NULL) {
+        source = shader->name;
+    }
+    const char* id = LINT_WARNINGS[rule].id;
+    if (rgsl_source_allows(shader, source, source_line, id)) {
+        allowed_count++;
+        return;
+    }
+    warning_count++;
+    rgsl_printf_warning("%s:%d: %s: %s\n", source, source_line, id, message);
+}
+
+void rgsl_perf_lint_shader(struct rgsl_shader_data* shader) {
+    if (strcmp(shader->language, "glsl") != 0) {
+        rgsl_printf_info(2, "The performance lint only supports GLSL, %s is not linted.\n", shader->path);
+        return;
+    }
+    if (!rgsl_glsl_build_program(shader, NULL)) {
+        rgsl_printf_info(2, "%s does not build, it is not linted.\n", shader->path);
+        return;
+    }
+    struct rgsl_lint_context context;
+    context.shader = shader;
+    rgsl_glslang_perf_lint(shader->program, rgsl_report_lint_warning, &context);
+    linted_count++;
+}
+
+void rgsl_perf_lint_finalize() {
+    if (rgsl_perf_lint_enabled()) {
+        rgsl_printf_info(1, "Performance lint: %zu warnings in %zu shaders (%zu allowed in the source).\n", warning_count, linted_count, allowed_count);
+    }
+    warning_count = 0;
+    allowed_count = 0;
+    linted_count = 0;
+}
\ No newline at end of file
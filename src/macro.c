@@ -0,0 +1,501 @@
+#include <RGSL/macro.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <ctype.h>
+
+#define RGSL_MACRO_MAX_EXPANSION_DEPTH 64
+
+// Built-in macros glslang defines from the #version directive.
+static const char* const VERSION_BUILTINS[] = {
+    "__VERSION__",
+    "GL_ES",
+    "GL_core_profile",
+    "GL_compatibility_profile",
+    NULL
+};
+
+static void rgsl_release_macro(void* value) {
+    struct rgsl_macro* macro = (struct rgsl_macro*)value;
+    rgsl_free(macro->value);
+    rgsl_free(macro);
+}
+
+void rgsl_macro_table_init(struct rgsl_macro_table* table) {
+    rgsl_hashmap_init(&table->macros);
+    table->builtins_known = false;
+    table->incomplete = false;
+    table->undefined_unknown = false;
+}
+
+void rgsl_macro_table_free(struct rgsl_macro_table* table) {
+    rgsl_hashmap_free(&table->macros, rgsl_release_macro);
+}
+
+static bool rgsl_is_identifier_start(char c) {
+    return isalpha((unsigned char)c) || c == '_';
+}
+
+static bool rgsl_is_identifier_char(char c) {
+    return isalnum((unsigned char)c) || c == '_';
+}
+
+static void rgsl_macro_set(struct rgsl_macro_table* table, const char* name, size_t name_length,
+                           const char* value, size_t value_length, bool function_like, bool uncertain) {
+    struct rgsl_macro* macro = (struct rgsl_macro*)rgsl_malloc(sizeof(struct rgsl_macro));
+    macro->value = (char*)rgsl_malloc(value_length + 1);
+    memcpy(macro->value, value, value_length);
+    macro->value[value_length] = '\0';
+    macro->function_like = function_like;
+    macro->uncertain = uncertain;
+
+    char* key = (char*)rgsl_malloc(name_length + 1);
+    memcpy(key, name, name_length);
+    key[name_length] = '\0';
+    struct rgsl_macro* previous = (struct rgsl_macro*)rgsl_hashmap_set(&table->macros, key, macro);
+    if (previous != NULL) {
+        rgsl_release_macro(previous);
+    }
+    rgsl_free(key);
+}
+
+void rgsl_macro_table_copy(struct rgsl_macro_table* destination, const struct rgsl_macro_table* source) {
+    rgsl_macro_table_init(destination);
+    for (size_t i = 0; i < source->macros.capacity; i++) {
+        const struct rgsl_hashmap_entry* entry = &source->macros.entries[i];
+        if (entry->key == NULL) {
+            continue;
+        }
+        const struct rgsl_macro* macro = (const struct rgsl_macro*)entry->value;
+        rgsl_macro_set(destination, entry->key, strlen(entry->key), macro->value, strlen(macro->value), macro->function_like, macro->uncertain);
+    }
+    destination->builtins_known = source->builtins_known;
+    destination->incomplete = source->incomplete;
+    destination->undefined_unknown = source->undefined_unknown;
+}
+
+bool rgsl_macro_define(struct rgsl_macro_table* table, const char* definition, bool uncertain) {
+    const char* name = definition;
+    if (!rgsl_is_identifier_start(*name)) {
+        return false;
+    }
+    const char* name_end = name;
+    while (rgsl_is_identifier_char(*name_end)) {
+        name_end++;
+    }
+    // A parenthesis right after the name, without space, makes a function-like macro.
+    bool function_like = (*name_end == '(');
+    const char* value = name_end;
+    if (function_like) {
+        value = strchr(name_end, ')');
+        if (value == NULL) {
+            return false;
+        }
+        value++;
+    }
+    while (*value == ' ' || *value == '\t') {
+        value++;
+    }
+    size_t value_length = strlen(value);
+    while (value_length > 0 && isspace((unsigned char)value[value_length - 1])) {
+        value_length--;
+    }
+    rgsl_macro_set(table, name, (size_t)(name_end - name), value, value_length, function_like, uncertain);
+    return true;
+}
+
+bool rgsl_macro_define_option(struct rgsl_macro_table* table, const char* definition) {
+    const char* name_end = definition;
+    if (!rgsl_is_identifier_start(*name_end)) {
+        return false;
+    }
+    while (rgsl_is_identifier_char(*name_end)) {
+        name_end++;
+    }
+    if (*name_end == '\0') {
+        rgsl_macro_set(table, definition, (size_t)(name_end - definition), "1", 1, false, false);
+        return true;
+    }
+    if (*name_end != '=') {
+        return false;
+    }
+    rgsl_macro_set(table, definition, (size_t)(name_end - definition), name_end + 1, strlen(name_end + 1), false, false);
+    return true;
+}
+
+void rgsl_macro_undefine(struct rgsl_macro_table* table, const char* name, bool uncertain) {
+    size_t name_length = 0;
+    while (rgsl_is_identifier_char(name[name_length])) {
+        name_length++;
+    }
+    if (uncertain) {
+        // glslang may or may not see the #undef, keep the name around as unreliable.
+        rgsl_macro_set(table, name, name_length, "", 0, false, true);
+        return;
+    }
+    char* key = (char*)rgsl_malloc(name_length + 1);
+    memcpy(key, name, name_length);
+    key[name_length] = '\0';
+    void* previous;
+    if (rgsl_hashmap_remove(&table->macros, key, &previous)) {
+        rgsl_release_macro(previous);
+    }
+    rgsl_free(key);
+}
+
+static bool rgsl_is_reserved_name(const char* name) {
+    return strncmp(name, "GL_", 3) == 0 || strncmp(name, "__", 2) == 0;
+}
+
+static bool rgsl_is_version_builtin(const char* name) {
+    for (size_t i = 0; VERSION_BUILTINS[i] != NULL; i++) {
+        if (strcmp(name, VERSION_BUILTINS[i]) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+enum rgsl_condition_result rgsl_macro_evaluate_defined(const struct rgsl_macro_table* table, const char* name) {
+    void* value;
+    if (table->incomplete) {
+        return RGSL_CONDITION_UNKNOWN;
+    }
+    if (rgsl_hashmap_find(&table->macros, name, &value)) {
+        return ((struct rgsl_macro*)value)->uncertain ? RGSL_CONDITION_UNKNOWN : RGSL_CONDITION_TRUE;
+    }
+    if (rgsl_is_reserved_name(name) && !(table->builtins_known && rgsl_is_version_builtin(name))) {
+        return RGSL_CONDITION_UNKNOWN;
+    }
+    return RGSL_CONDITION_FALSE;
+}
+
+/**
+ * Expression evaluation.
+ * Tokens are read from a stack of sources: the expression itself, then the
+ * values of the object-like macros being expanded.
+ */
+
+enum rgsl_expression_token_type {
+    RGSL_TOKEN_END,
+    RGSL_TOKEN_NUMBER,
+    RGSL_TOKEN_IDENTIFIER,
+    RGSL_TOKEN_OPERATOR,
+    RGSL_TOKEN_INVALID
+};
+
+struct rgsl_expression_token {
+    enum rgsl_expression_token_type type;
+    int64_t number;
+    char text[64];
+};
+
+struct rgsl_expression_source {
+    const char* cursor;
+    char macro_name[64];
+};
+
+struct rgsl_expression_state {
+    const struct rgsl_macro_table* table;
+    struct rgsl_expression_source sources[RGSL_MACRO_MAX_EXPANSION_DEPTH];
+    size_t depth;
+    struct rgsl_expression_token token;
+    bool unknown;
+    bool error;
+};
+
+static const char* const OPERATORS[] = {
+    "||", "&&", "==", "!=", "<=", ">=", "<<", ">>",
+    "(", ")", "!", "~", "+", "-", "*", "/", "%", "<", ">", "&", "^", "|", "?", ":",
+    NULL
+};
+
+static bool rgsl_is_being_expanded(const struct rgsl_expression_state* state, const char* name) {
+    for (size_t i = 1; i < state->depth; i++) {
+        if (strcmp(state->sources[i].macro_name, name) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void rgsl_read_raw_token(struct rgsl_expression_state* state) {
+    struct rgsl_expression_token* token = &state->token;
+    for (;;) {
+        const char** cursor = &state->sources[state->depth - 1].cursor;
+        while (**cursor == ' ' || **cursor == '\t' || **cursor == '\r') {
+            (*cursor)++;
+        }
+        if ((*cursor)[0] == '/' && (*cursor)[1] == '*') {
+            const char* comment_end = strstr(*cursor + 2, "*/");
+            *cursor = (comment_end != NULL) ? comment_end + 2 : *cursor + strlen(*cursor);
+            continue;
+        }
+        if (**cursor == '\0' || **cursor == '\n' || ((*cursor)[0] == '/' && (*cursor)[1] == '/')) {
+            if (state->depth > 1) {
+                state->depth--; // End of a macro expansion, resume the enclosing source
+                continue;
+            }
+            token->type = RGSL_TOKEN_END;
+            return;
+        }
+        break;
+    }
+
+    const char** cursor = &state->sources[state->depth - 1].cursor;
+    const char* start = *cursor;
+    if (isdigit((unsigned char)*start)) {
+        char* end;
+        token->type = RGSL_TOKEN_NUMBER;
+        token->number = (int64_t)strtoll(start, &end, 0);
+        while (*end == 'u' || *end == 'U') {
+            end++;
+        }
+        if (end == start || rgsl_is_identifier_char(*end) || *end == '.') {
+            token->type = RGSL_TOKEN_INVALID; // Floating-point or malformed literal
+        }
+        *cursor = end;
+        return;
+    }
+    if (rgsl_is_identifier_start(*start)) {
+        const char* end = start;
+        while (rgsl_is_identifier_char(*end)) {
+            end++;
+        }
+        size_t length = (size_t)(end - start);
+        *cursor = end;
+        if (length >= sizeof(token->text)) {
+            token->type = RGSL_TOKEN_INVALID;
+            return;
+        }
+        memcpy(token->text, start, length);
+        token->text[length] = '\0';
+        token->type = RGSL_TOKEN_IDENTIFIER;
+        return;
+    }
+    for (size_t i = 0; OPERATORS[i] != NULL; i++) {
+        size_t length = strlen(OPERATORS[i]);
+        if (strncmp(start, OPERATORS[i], length) == 0) {
+            memcpy(token->text, start, length);
+            token->text[length] = '\0';
+            token->type = RGSL_TOKEN_OPERATOR;
+            *cursor = start + length;
+            return;
+        }
+    }
+    token->type = RGSL_TOKEN_INVALID;
+    *cursor = start + 1;
+}
+
+static void rgsl_next_token(struct rgsl_expression_state* state) {
+    for (;;) {
+        rgsl_read_raw_token(state);
+        if (state->token.type != RGSL_TOKEN_IDENTIFIER || strcmp(state->token.text, "defined") == 0) {
+            return;
+        }
+        if (state->table->incomplete) {
+            state->unknown = true;
+            return;
+        }
+        void* value;
+        if (!rgsl_hashmap_find(&state->table->macros, state->token.text, &value)) {
+            return;
+        }
+        const struct rgsl_macro* macro = (const struct rgsl_macro*)value;
+        if (macro->uncertain || macro->function_like) {
+            state->unknown = true;
+            return;
+        }
+        if (rgsl_is_being_expanded(state, state->token.text)) {
+            return; // Self-referencing macros are not expanded again
+        }
+        if (state->depth == RGSL_MACRO_MAX_EXPANSION_DEPTH) {
+            state->error = true;
+            return;
+        }
+        state->sources[state->depth].cursor = macro->value;
+        strcpy(state->sources[state->depth].macro_name, state->token.text);
+        state->depth++;
+    }
+}
+
+static bool rgsl_accept_operator(struct rgsl_expression_state* state, const char* op) {
+    if (state->token.type == RGSL_TOKEN_OPERATOR && strcmp(state->token.text, op) == 0) {
+        rgsl_next_token(state);
+        return true;
+    }
+    return false;
+}
+
+static int64_t rgsl_parse_conditional(struct rgsl_expression_state* state);
+
+static int64_t rgsl_parse_defined(struct rgsl_expression_state* state) {
+    // The operand of defined must not be expanded, so read it raw.
+    rgsl_read_raw_token(state);
+    bool parenthesized = false;
+    if (state->token.type == RGSL_TOKEN_OPERATOR && strcmp(state->token.text, "(") == 0) {
+        parenthesized = true;
+        rgsl_read_raw_token(state);
+    }
+    if (state->token.type != RGSL_TOKEN_IDENTIFIER) {
+        state->error = true;
+        return 0;
+    }
+    enum rgsl_condition_result result = rgsl_macro_evaluate_defined(state->table, state->token.text);
+    if (result == RGSL_CONDITION_UNKNOWN) {
+        state->unknown = true;
+    }
+    rgsl_next_token(state);
+    if (parenthesized && !rgsl_accept_operator(state, ")")) {
+        state->error = true;
+    }
+    return result == RGSL_CONDITION_TRUE;
+}
+
+static int64_t rgsl_parse_primary(struct rgsl_expression_state* state) {
+    struct rgsl_expression_token* token = &state->token;
+    if (token->type == RGSL_TOKEN_NUMBER) {
+        int64_t value = token->number;
+        rgsl_next_token(state);
+        return value;
+    }
+    if (token->type == RGSL_TOKEN_IDENTIFIER) {
+        if (strcmp(token->text, "defined") == 0) {
+            return rgsl_parse_defined(state);
+        }
+        // Remaining identifiers are not defined as object-like macros.
+        if (rgsl_is_reserved_name(token->text) && !(state->table->builtins_known && rgsl_is_version_builtin(token->text))) {
+            state->unknown = true;
+        } else if (state->table->undefined_unknown) {
+            state->unknown = true; // An error for glslang, not a 0
+        }
+        rgsl_next_token(state);
+        return 0;
+    }
+    if (token->type == RGSL_TOKEN_OPERATOR) {
+        if (rgsl_accept_operator(state, "(")) {
+            int64_t value = rgsl_parse_conditional(state);
+            if (!rgsl_accept_operator(state, ")")) {
+                state->error = true;
+            }
+            return value;
+        }
+        if (rgsl_accept_operator(state, "!")) {
+            return !rgsl_parse_primary(state);
+        }
+        if (rgsl_accept_operator(state, "~")) {
+            return ~rgsl_parse_primary(state);
+        }
+        if (rgsl_accept_operator(state, "-")) {
+            return -rgsl_parse_primary(state);
+        }
+        if (rgsl_accept_operator(state, "+")) {
+            return rgsl_parse_primary(state);
+        }
+    }
+    state->error = true;
+    return 0;
+}
+
+/**
+ * Binary operators by increasing precedence level, as in C.
+ */
+static const char* const BINARY_LEVELS[][4] = {
+    {"||", NULL},
+    {"&&", NULL},
+    {"|", NULL},
+    {"^", NULL},
+    {"&", NULL},
+    {"==", "!=", NULL},
+    {"<", ">", "<=", ">="},
+    {"<<", ">>", NULL},
+    {"+", "-", NULL},
+    {"*", "/", "%", NULL}
+};
+
+static int64_t rgsl_apply_binary(struct rgsl_expression_state* state, const char* op, int64_t lhs, int64_t rhs) {
+    switch (op[0]) {
+        case '|': return op[1] == '|' ? (lhs || rhs) : (lhs | rhs);
+        case '&': return op[1] == '&' ? (lhs && rhs) : (lhs & rhs);
+        case '^': return lhs ^ rhs;
+        case '=': return lhs == rhs;
+        case '!': return lhs != rhs;
+        case '<':
+            if (op[1] == '<') return (rhs >= 0 && rhs < 64) ? (int64_t)((uint64_t)lhs << rhs) : 0;
+            return op[1] == '=' ? (lhs <= rhs) : (lhs < rhs);
+        case '>':
+            if (op[1] == '>') return (rhs >= 0 && rhs < 64) ? (lhs >> rhs) : 0;
+            return op[1] == '=' ? (lhs >= rhs) : (lhs > rhs);
+        case '+': return lhs + rhs;
+        case '-': return lhs - rhs;
+        case '*': return lhs * rhs;
+        case '/':
+        case '%':
+            if (rhs == 0) {
+                state->error = true; // Let glslang report the division by zero
+                return 0;
+            }
+            return op[0] == '/' ? lhs / rhs : lhs % rhs;
+        default:
+            state->error = true;
+            return 0;
+    }
+}
+
+static int64_t rgsl_parse_binary(struct rgsl_expression_state* state, size_t level) {
+    size_t num_levels = sizeof(BINARY_LEVELS) / sizeof(BINARY_LEVELS[0]);
+    if (level == num_levels) {
+        return rgsl_parse_primary(state);
+    }
+    int64_t lhs = rgsl_parse_binary(state, level + 1);
+    while (!state->error && state->token.type == RGSL_TOKEN_OPERATOR) {
+        const char* op = NULL;
+        for (size_t i = 0; i < 4 && BINARY_LEVELS[level][i] != NULL; i++) {
+            if (strcmp(state->token.text, BINARY_LEVELS[level][i]) == 0) {
+                op = BINARY_LEVELS[level][i];
+                break;
+            }
+        }
+        if (op == NULL) {
+            break;
+        }
+        rgsl_next_token(state);
+        int64_t rhs = rgsl_parse_binary(state, level + 1);
+        lhs = rgsl_apply_binary(state, op, lhs, rhs);
+    }
+    return lhs;
+}
+
+static int64_t rgsl_parse_conditional(struct rgsl_expression_state* state) {
+    int64_t condition = rgsl_parse_binary(state, 0);
+    if (rgsl_accept_operator(state, "?")) {
+        int64_t when_true = rgsl_parse_conditional(state);
+        if (!rgsl_accept_operator(state, ":")) {
+            state->error = true;
+            return 0;
+        }
+        int64_t when_false = rgsl_parse_conditional(state);
+        return condition ? when_true : when_false;
+    }
+    return condition;
+}
+
+enum rgsl_condition_result rgsl_macro_evaluate(const struct rgsl_macro_table* table, const char* expression) {
+    struct rgsl_expression_state state;
+    state.table = table;
+    state.sources[0].cursor = expression;
+    state.sources[0].macro_name[0] = '\0';
+    state.depth = 1;
+    state.unknown = false;
+    state.error = false;
+    rgsl_next_token(&state);
+    int64_t value = rgsl_parse_conditional(&state);
+    if (state.token.type != RGSL_TOKEN_END) {
+        state.error = true;
+    }
+    if (state.unknown || state.error) {
+        return RGSL_CONDITION_UNKNOWN;
+    }
+    return value ? RGSL_CONDITION_TRUE : RGSL_CONDITION_FALSE;
+}
\ No newline at end of file
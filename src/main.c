@@ -1,10 +1,18 @@
-#include <RGSL/validator.h>
+#include <RGSL/driver.h>
+#include <RGSL/manifest.h>
+#include <RGSL/termio.h>
+#include <RGSL/resolver.h>
 #include <RGSL/compile.h>
+#include <RGSL/spec.h>
+#include <RGSL/cost.h>
+#include <RGSL/lint.h>
+#include <RGSL/target.h>
+#include <RGSL/link.h>
 #include <RGSL/packager.h>
-#include <RGSL/termio.h>
-#include <RGSL/fileio.h>
+#include <RGSL/usage.h>
 #include <RGSL/rgsl.h>
 #include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
 #include <argparse/argparse.h>
 #include <stdlib.h>
 #include <string.h>
@@ -25,38 +33,122 @@ static int on_include_option(struct argparse *self, const struct argparse_option
     }
 
     if (rgsl_global_options.include_paths == NULL) {
-        rgsl_global_options.include_paths = (const char**)malloc(sizeof(char*) * 2);
+        rgsl_global_options.include_paths = (const char**)rgsl_malloc(sizeof(char*) * 2);
         rgsl_global_options.include_paths[0] = NULL;
     }
 
-    rgsl_global_options.include_paths = realloc(rgsl_global_options.include_paths, sizeof(char*) * (count + 1));
+    rgsl_global_options.include_paths = rgsl_realloc(rgsl_global_options.include_paths, sizeof(char*) * (count + 1));
     rgsl_global_options.include_paths[count++] = NULL;
-    rgsl_global_options.include_paths[count - 2] = _strdup(value);
+    rgsl_global_options.include_paths[count - 2] = rgsl_strdup(value);
+
+    return 0;
+}
+
+static int on_define_option(struct argparse *self, const struct argparse_option *option) {
+    (void)option;
+    static int count = 0;
+
+    const char *value;
+    if (self->optvalue) {
+        value = self->optvalue;
+        self->optvalue = NULL;
+    } else if (self->argc > 1) {
+        self->argc--;
+        value = *++self->argv;
+    } else {
+        rgsl_print_error("The --define option requires a value\n");
+        return -1;
+    }
+
+    rgsl_global_options.defines = rgsl_realloc(rgsl_global_options.defines, sizeof(char*) * (count + 2));
+    rgsl_global_options.defines[count++] = rgsl_strdup(value);
+    rgsl_global_options.defines[count] = NULL;
+
+    return 0;
+}
+
+static int on_spec_constant_option(struct argparse *self, const struct argparse_option *option) {
+    (void)option;
+    static int count = 0;
+
+    const char *value;
+    if (self->optvalue) {
+        value = self->optvalue;
+        self->optvalue = NULL;
+    } else if (self->argc > 1) {
+        self->argc--;
+        value = *++self->argv;
+    } else {
+        rgsl_print_error("The --spec-constant option requires a value\n");
+        return -1;
+    }
+
+    rgsl_global_options.spec_constants = rgsl_realloc(rgsl_global_options.spec_constants, sizeof(char*) * (count + 2));
+    rgsl_global_options.spec_constants[count++] = rgsl_strdup(value);
+    rgsl_global_options.spec_constants[count] = NULL;
 
     return 0;
 }
 
 int main(int argc, const char** argv) {
     rgsl_initialize();
-    struct rgsl_shader_data* shaders = NULL;
+    argv = rgsl_expand_response_files(argc, argv, &argc);
+    if (argv == NULL) {
+        return 1;
+    }
     struct argparse_option options[] = {
         OPT_GROUP("File options"),
         OPT_STRING('o', "output", &rgsl_global_options.output_file, "output file"),
+        OPT_STRING(0, "manifest", &rgsl_global_options.manifest_file, "file listing the input files, each with its own options"),
         OPT_STRING('I', "include", NULL, "additional include paths", on_include_option),
+        OPT_STRING('D', "define", NULL, "define a macro (NAME or NAME=VALUE)", on_define_option),
+        OPT_STRING(0, "stage", &rgsl_global_options.stage, "shader stage, instead of the one of the file extension (vert, frag, ...)"),
+        OPT_STRING(0, "profile", &rgsl_global_options.profile, "shader profile replacing the #version directive (e.g. 450, 300es)"),
+        OPT_STRING(0, "spec-constant", NULL, "with --spirv, promote a macro to a specialization constant (NAME or NAME=DEFAULT)", on_spec_constant_option),
+        OPT_BOOLEAN(0, "pack-uniforms", &rgsl_global_options.pack_uniforms, "pack the loose uniforms of each shader into one std140 block, mirrored as a C struct with --embed"),
+        OPT_INTEGER(0, "pack-uniforms-binding", &rgsl_global_options.pack_uniforms_binding, "with --pack-uniforms, binding of the blocks where the profile supports it (default 0)"),
+        OPT_BOOLEAN(0, "layout-report", &rgsl_global_options.layout_report, "report the size and padding of the std140/std430 blocks and their structs, mirrored as C structs with --embed"),
+        OPT_BOOLEAN(0, "layout-reorder", &rgsl_global_options.layout_reorder, "like --layout-report, reordering the members of the blocks and structs to minimize their padding"),
+        OPT_BOOLEAN(0, "demote-precision", &rgsl_global_options.demote_precision, "declare mediump the variables of GLES fragment shaders that do not need highp, in the GLSL output"),
+        OPT_INTEGER(0, "mediump-texture-size", &rgsl_global_options.mediump_texture_size, "with --demote-precision, size in texels of the largest texture sampled, allowing mediump texture coordinates up to 256"),
+        OPT_BOOLEAN(0, "mediump-outputs", &rgsl_global_options.mediump_outputs, "with --demote-precision, declare mediump every color output, all render targets having at most 8 bits per channel"),
+        OPT_STRING(0, "targets", &rgsl_global_options.targets, "comma-separated targets every shader is compiled to from one parse, written to <output>.<target> (e.g. 330core,300es,spirv,vulkan1.2)"),
+        OPT_BOOLEAN(0, "glslang-spirv", &rgsl_global_options.glslang_spirv, "compile RGSL shaders to SPIR-V through GLSL and glslang, instead of directly from their syntax tree"),
+        OPT_BOOLEAN(0, "spirv-validate", &rgsl_global_options.spirv_validate, "check the SPIR-V of every shader with the SPIRV-Tools validator"),
+        OPT_BOOLEAN(0, "program-module", &rgsl_global_options.program_module, "with --spirv, compile the stages of each program file to one module with an entry point per stage"),
+        OPT_BOOLEAN(0, "native-includes", &rgsl_global_options.native_includes, "let glslang resolve #include directives instead of splicing them"),
         OPT_GROUP("Action options (choose at least one)"),
         OPT_BIT('V', "validate", &rgsl_global_options.action, "validate the input shader file", NULL, RGSL_ACTION_VALIDATE, 0),
         OPT_BIT('C', "compile", &rgsl_global_options.action, "compile the input shader file", NULL, RGSL_ACTION_COMPILE, 0),
         OPT_BIT('S', "spirv", &rgsl_global_options.action, "compile the input shader to SPIR-V", NULL, RGSL_ACTION_COMPILE_SPIRV, 0),
         OPT_BIT(0, "embed", &rgsl_global_options.action, "merge the input shaders to an embeddable C array", NULL, RGSL_ACTION_COMPILE_EMBED, 0),
+        OPT_BOOLEAN(0, "split-embed", &rgsl_global_options.split_embed, "with --embed, write one C file per shader next to the output, which holds the index table"),
+        OPT_BOOLEAN(0, "shared-chunks", &rgsl_global_options.shared_chunks, "with --embed of GLSL code, store the text of each include once, each shader pointing at its chunks for glShaderSource"),
+        OPT_STRING(0, "usage-profile", &rgsl_global_options.usage_profile, "with --embed, lay the blobs out by first use from a runtime usage profile, startup shaders first"),
+        OPT_INTEGER(0, "startup-time", &rgsl_global_options.startup_time, "with --usage-profile, time in milliseconds ending startup (default 0, every profiled shader)"),
+        OPT_BOOLEAN(0, "split-cold", &rgsl_global_options.split_cold, "with --usage-profile, write the shaders not used at startup to <output>_cold.c, to be loaded lazily"),
+        OPT_BOOLEAN(0, "usage-faults", &rgsl_global_options.usage_faults, "with --usage-profile, replay the profile over the package and print the pages it faults in, against the command-line order"),
+        OPT_GROUP("Report options"),
+        OPT_STRING(0, "cost-report", &rgsl_global_options.cost_report, "with --spirv, print the static cost of the shaders and write it as JSON to the given file"),
+        OPT_STRING(0, "cost-baseline", &rgsl_global_options.cost_baseline, "with --spirv, fail if a shader became heavier than in the given JSON cost report"),
+        OPT_INTEGER(0, "cost-threshold", &rgsl_global_options.cost_threshold, "growth in percent of a cost over the baseline that fails (default 10)"),
+        OPT_BOOLEAN(0, "perf-lint", &rgsl_global_options.perf_lint, "warn about patterns that are costly on tile-based GPUs, with IDs P001 to P005"),
+        OPT_STRING(0, "perf-lint-suppress", &rgsl_global_options.perf_lint_suppress, "comma-separated IDs of the performance warnings not to report (e.g. P001,P004)"),
+        OPT_STRING(0, "mem-report", &rgsl_global_options.mem_report, "account the allocations of each phase and shader, print their peaks and write them as JSON to the given file"),
+        OPT_INTEGER(0, "benchmark", &rgsl_global_options.benchmark, "time the given number of passes of the RGSL lexer and parser over each RGSL shader, in MB/s and tokens/s"),
         OPT_GROUP("Misc options"),
         OPT_HELP(),
+        OPT_BOOLEAN(0, "serial-io", &rgsl_global_options.serial_io, "read and write the files on the compilation thread, instead of overlapping them with compilation"),
         OPT_BOOLEAN('v', "version", &rgsl_global_options.show_version, "show version information and exit"),
         OPT_INTEGER(0, "verbose", &rgsl_global_options.verbose, "set verbosity level (0=quiet, 1=normal, 2=verbose)", NULL, 1),
+        OPT_STRING(0, "log-json", &rgsl_global_options.log_json, "write the messages as JSON lines to the given file (- for stdout) instead of the terminal"),
         OPT_END(),
     };
 
     const char * const usages[] = {
         "rgsl [options] <input file>...",
+        "rgsl [options] --manifest <file>",
+        "rgsl @<response file>",
         NULL,
     };
 
@@ -73,99 +165,126 @@ int main(int argc, const char** argv) {
         return 0;
     }
 
-    if (!rgsl_global_options.input_files) {
+    if (rgsl_global_options.log_json != NULL && !rgsl_log_open_json(rgsl_global_options.log_json)) {
+        return 1;
+    }
+
+    struct rgsl_manifest manifest;
+    rgsl_manifest_init(&manifest);
+    for (size_t i = 0; rgsl_global_options.input_files != NULL && rgsl_global_options.input_files[i] != NULL; i++) {
+        struct rgsl_job job = {0};
+        job.input_file = rgsl_global_options.input_files[i];
+        rgsl_manifest_add_job(&manifest, &job);
+    }
+    if (rgsl_global_options.manifest_file != NULL && !rgsl_manifest_load(&manifest, rgsl_global_options.manifest_file)) {
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+    size_t shared_outputs = 0;
+    for (size_t i = 0; i < manifest.count; i++) {
+        if (manifest.jobs[i].output_file == NULL) {
+            shared_outputs++;
+        }
+    }
+
+    if (manifest.count == 0) {
         rgsl_print_error("No input file specified\n");
         argparse_usage(&argparse);
+        rgsl_manifest_free(&manifest);
         return 1;
     }
 
     if (rgsl_global_options.action == RGSL_ACTION_NONE) {
         rgsl_print_error("At least one action (--validate or --compile) must be specified\n");
         argparse_usage(&argparse);
+        rgsl_manifest_free(&manifest);
         return 1;
     }
 
-    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
-        size_t num_inputs;
-        for (num_inputs = 0; rgsl_global_options.input_files[num_inputs] != NULL; num_inputs++);
-        shaders = (struct rgsl_shader_data*)malloc(sizeof(struct rgsl_shader_data) * (num_inputs + 1));
-        shaders[num_inputs] = (struct rgsl_shader_data){0};
-    } else if (rgsl_global_options.input_files[1] != NULL) {
+    bool compiles = (rgsl_global_options.action & (RGSL_ACTION_COMPILE | RGSL_ACTION_COMPILE_SPIRV)) != 0;
+    if (compiles && !(rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) && shared_outputs > 1) {
         rgsl_print_info(0, "Multiple input files detected. To embed multiple shaders into a single C array, use the --embed option.\n");
-        rgsl_print_error("Only one input file can be processed at a time unless using --embed\n");
+        rgsl_print_error("Only one input file can be compiled to the --output file unless using --embed; give the others their own output in a manifest\n");
         argparse_usage(&argparse);
+        rgsl_manifest_free(&manifest);
         return 1;
     }
 
-    rgsl_glslang_initialize();
-    for (int i = 0; rgsl_global_options.input_files[i] != NULL; i++) {
-        const char* input_file = rgsl_global_options.input_files[i];
-        rgsl_printf_info(3, "Input file: %s\n", input_file);
+    if (rgsl_cost_report_enabled() && !(rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV)) {
+        rgsl_print_error("The cost report is computed from SPIR-V and requires --spirv\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
 
-        if (!rgsl_file_exists(input_file)) {
-            rgsl_printf_error("Input file does not exist: %s\n", input_file);
-            return 1;
-        }
+    if (rgsl_shared_chunks_enabled() && (!(rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) || (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) || rgsl_targets_enabled())) {
+        rgsl_print_error("Shared chunks store the GLSL code of --embed, and require neither --spirv nor --targets\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
 
-        struct rgsl_shader_data shader;
-        const char* shader_file = input_file;
-        char* raw_shader_code;
-        rgsl_read_file(shader_file, &raw_shader_code);
-        shader.name = rgsl_determine_shader_name(shader_file);
-        shader.code = rgsl_crlf_to_lf(raw_shader_code);
-        shader.language = rgsl_determine_shader_language(shader_file);
-        shader.stage = rgsl_determine_shader_stage(shader_file);
-        rgsl_free_file_buffer(raw_shader_code);
-        if (shader.name == NULL) {
-            rgsl_printf_error("Could not determine shader name from file: %s\n", shader_file);
-            return 1;
-        }
-        if (shader.code == NULL) {
-            rgsl_printf_error("Failed to read shader file: %s\n", shader_file);
-            return 1;
-        }
-        if (shader.language == NULL) {
-            rgsl_printf_error("Could not determine shader language from file extension: %s\n", shader_file);
-            rgsl_free_file_buffer(shader.code);
-            return 1;
-        }
-        if (shader.stage == NULL) {
-            rgsl_printf_error("Could not determine shader stage from file extension: %s\n", shader_file);
-            rgsl_free_file_buffer(shader.code);
-            return 1;
-        }
+    if (rgsl_program_module_enabled() && (!(rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) || rgsl_targets_enabled())) {
+        rgsl_print_error("The stages of a program are linked into one module with --spirv, and without --targets\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
 
-        if (rgsl_global_options.action & RGSL_ACTION_VALIDATE) {
-            bool is_valid = rgsl_validate_shader(&shader);
-            if (is_valid) {
-                rgsl_printf_info(1, "Shader %s is valid.\n", shader_file);
-            } else {
-                rgsl_printf_error("Shader %s is invalid.\n", shader_file);
-                return 1;
-            }
-        }
-        if (rgsl_global_options.action & RGSL_ACTION_COMPILE || rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
-            if (!rgsl_global_options.output_file) {
-                rgsl_print_error("Output file must be specified for compilation using --output\n");
-                rgsl_free_file_buffer(shader.code);
-                return 1;
-            }
-            rgsl_printf_info(1, "Compiling shader %s to %s...\n", shader_file, rgsl_global_options.output_file);
-            rgsl_compile_shader(&shader, rgsl_global_options.output_file);
-        }
-        if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
-            shaders[i] = shader;
-        } else {
-            rgsl_free_file_buffer(shader.code);
-        }
+    if (rgsl_global_options.usage_profile != NULL && !(rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED)) {
+        rgsl_print_error("A usage profile lays out the package of --embed, which it requires\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
     }
-    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED) {
-        rgsl_package_shaders(shaders);
-        for (int i = 0; shaders[i].code != NULL; i++) {
-            rgsl_free_file_buffer(shaders[i].code);
-        }
-        free(shaders);
+
+    if (rgsl_global_options.usage_faults && rgsl_global_options.usage_profile == NULL) {
+        rgsl_print_error("--usage-faults replays the profile of --usage-profile, which it requires\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+
+    if (rgsl_cold_split_enabled() && (rgsl_global_options.usage_profile == NULL || rgsl_global_options.split_embed || rgsl_shared_chunks_enabled() || rgsl_targets_enabled())) {
+        rgsl_print_error("--split-cold requires --usage-profile, and neither --split-embed, --shared-chunks nor --targets\n");
+        rgsl_manifest_free(&manifest);
+        return 1;
     }
+
+    if (!rgsl_check_perf_lint()) {
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+
+    if (!rgsl_check_spec_constants()) {
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+
+    if (!rgsl_check_targets()) {
+        rgsl_targets_finalize();
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+
+    if (!rgsl_check_usage_profile()) {
+        rgsl_targets_finalize();
+        rgsl_manifest_free(&manifest);
+        return 1;
+    }
+
+    rgsl_memory_report_start();
+    rgsl_glslang_initialize();
+    rgsl_compile_initialize();
+    int exit_code = rgsl_run_jobs(&manifest);
+    rgsl_manifest_free(&manifest);
+    if (!rgsl_cost_report_finalize()) {
+        exit_code = 1;
+    }
+    if (!rgsl_memory_report_finalize()) {
+        exit_code = 1;
+    }
+    rgsl_perf_lint_finalize();
+    rgsl_targets_finalize();
+    rgsl_usage_profile_finalize();
+    rgsl_compile_finalize();
+    rgsl_resolver_finalize();
     rgsl_glslang_finalize();
-    return 0;
+    rgsl_log_finalize();
+    return exit_code;
 }
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include <RGSL/manifest.h>
+#include <RGSL/fileio.h>
+#include <RGSL/termio.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+#define RGSL_MAX_RESPONSE_FILE_DEPTH 16
+
+/**
+ * Options accepted on a manifest line, with the function storing their value in the job.
+ */
+struct rgsl_manifest_option {
+    char short_name;
+    const char* long_name;
+    void (*set_func)(struct rgsl_job* job, const char* value);
+};
+
+static void rgsl_set_job_output(struct rgsl_job* job, const char* value) {
+    job->output_file = rgsl_strdup(value);
+}
+
+static void rgsl_set_job_stage(struct rgsl_job* job, const char* value) {
+    job->stage = rgsl_strdup(value);
+}
+
+static void rgsl_set_job_profile(struct rgsl_job* job, const char* value) {
+    job->profile = rgsl_strdup(value);
+}
+
+static void rgsl_add_job_define(struct rgsl_job* job, const char* value) {
+    size_t count = 0;
+    while (job->defines != NULL && job->defines[count] != NULL) {
+        count++;
+    }
+    job->defines = (const char**)rgsl_realloc((void*)job->defines, sizeof(char*) * (count + 2));
+    job->defines[count] = rgsl_strdup(value);
+    job->defines[count + 1] = NULL;
+}
+
+static const struct rgsl_manifest_option MANIFEST_OPTIONS[] = {
+    {'o', "output", rgsl_set_job_output},
+    {0, "stage", rgsl_set_job_stage},
+    {0, "profile", rgsl_set_job_profile},
+    {'D', "define", rgsl_add_job_define},
+    {0, NULL, NULL} // Sentinel to mark the end of the array
+};
+
+char** rgsl_split_arguments(const char* text, size_t* out_count) {
+    size_t count = 0;
+    size_t capacity = 8;
+    char** arguments = (char**)rgsl_malloc(sizeof(char*) * capacity);
+    char* argument = (char*)rgsl_malloc(strlen(text) + 1);
+    const char* cursor = text;
+    for (;;) {
+        while (isspace((unsigned char)*cursor)) {
+            cursor++;
+        }
+        if (*cursor == '\0') {
+            break;
+        }
+        if (*cursor == '#') {
+            while (*cursor != '\n' && *cursor != '\0') {
+                cursor++;
+            }
+            continue;
+        }
+        size_t length = 0;
+        char quote = '\0';
+        for (; *cursor != '\0' && (quote != '\0' || !isspace((unsigned char)*cursor)); cursor++) {
+            if (quote == '\0' && (*cursor == '\"' || *cursor == '\'')) {
+                quote = *cursor;
+            } else if (quote != '\0' && *cursor == quote) {
+                quote = '\0';
+            } else if (quote == '\"' && *cursor == '\\' && cursor[1] != '\0') {
+                argument[length++] = *++cursor;
+            } else {
+                argument[length++] = *cursor;
+            }
+        }
+        if (count + 1 == capacity) {
+            capacity *= 2;
+            arguments = (char**)rgsl_realloc(arguments, sizeof(char*) * capacity);
+        }
+        arguments[count] = (char*)rgsl_malloc(length + 1);
+        memcpy(arguments[count], argument, length);
+        arguments[count++][length] = '\0';
+    }
+    rgsl_free(argument);
+    arguments[count] = NULL;
+    if (out_count != NULL) {
+        *out_count = count;
+    }
+    return arguments;
+}
+
+void rgsl_free_arguments(char** arguments) {
+    for (size_t i = 0; arguments != NULL && arguments[i] != NULL; i++) {
+        rgsl_free(arguments[i]);
+    }
+    rgsl_free(arguments);
+}
+
+static void rgsl_append_argument(const char*** expanded, int* count, const char* argument) {
+    *expanded = (const char**)rgsl_realloc((void*)*expanded, sizeof(char*) * (*count + 2));
+    (*expanded)[(*count)++] = argument;
+    (*expanded)[*count] = NULL;
+}
+
+static bool rgsl_append_expanded_argument(const char*** expanded, int* count, const char* argument, int depth) {
+    if (argument[0] != '@') {
+        rgsl_append_argument(expanded, count, argument);
+        return true;
+    }
+    if (depth == RGSL_MAX_RESPONSE_FILE_DEPTH) {
+        rgsl_printf_error("Response files nested too deeply: %s\n", argument + 1);
+        return false;
+    }
+    char* content = NULL;
+    rgsl_read_file(argument + 1, &content);
+    if (content == NULL) {
+        rgsl_printf_error("Failed to read response file: %s\n", argument + 1);
+        return false;
+    }
+    // The arguments are referenced by the options, they are never freed.
+    char** arguments = rgsl_split_arguments(content, NULL);
+    rgsl_free_file_buffer(content);
+    bool success = true;
+    for (size_t i = 0; success && arguments[i] != NULL; i++) {
+        success = rgsl_append_expanded_argument(expanded, count, arguments[i], depth + 1);
+    }
+    rgsl_free(arguments);
+    return success;
+}
+
+const char** rgsl_expand_response_files(int argc, const char** argv, int* out_argc) {
+    const char** expanded = NULL;
+    int count = 0;
+    // argv[0] is the program name, never a response file.
+    rgsl_append_argument(&expanded, &count, argv[0]);
+    for (int i = 1; i < argc; i++) {
+        if (!rgsl_append_expanded_argument(&expanded, &count, argv[i], 0)) {
+            rgsl_free((void*)expanded);
+            return NULL;
+        }
+    }
+    *out_argc = count;
+    return expanded;
+}
+
+void rgsl_manifest_init(struct rgsl_manifest* manifest) {
+    manifest->jobs = NULL;
+    manifest->count = 0;
+    manifest->capacity = 0;
+}
+
+void rgsl_manifest_add_job(struct rgsl_manifest* manifest, const struct rgsl_job* job) {
+    if (manifest->count == manifest->capacity) {
+        manifest->capacity = manifest->capacity ? manifest->capacity * 2 : 16;
+        manifest->jobs = (struct rgsl_job*)rgsl_realloc(manifest->jobs, sizeof(struct rgsl_job) * manifest->capacity);
+    }
+    manifest->jobs[manifest->count++] = *job;
+}
+
+static const struct rgsl_manifest_option* rgsl_find_manifest_option(const char* argument, const char** out_inline_value) {
+    *out_inline_value = NULL;
+    for (size_t i = 0; MANIFEST_OPTIONS[i].long_name != NULL; i++) {
+        const struct rgsl_manifest_option* option = &MANIFEST_OPTIONS[i];
+        if (argument[0] == '-' && argument[1] == '-') {
+            size_t length = strlen(option->long_name);
+            if (strncmp(argument + 2, option->long_name, length) == 0 && (argument[2 + length] == '\0' || argument[2 + length] == '=')) {
+                if (argument[2 + length] == '=') {
+                    *out_inline_value = argument + 3 + length;
+                }
+                return option;
+            }
+        } else if (option->short_name != 0 && argument[1] == option->short_name) {
+            if (argument[2] != '\0') {
+                *out_inline_value = argument + 2;
+            }
+            return option;
+        }
+    }
+    return NULL;
+}
+
+static bool rgsl_parse_manifest_line(const char* path, size_t line_number, char** arguments, struct rgsl_job* job) {
+    for (size_t i = 0; arguments[i] != NULL; i++) {
+        const char* argument = arguments[i];
+        if (argument[0] != '-') {
+            if (job->input_file != NULL) {
+                rgsl_printf_error("%s:%zu: more than one input file on a line: %s\n", path, line_number, argument);
+                return false;
+            }
+            job->input_file = rgsl_strdup(argument);
+            continue;
+        }
+        const char* value;
+        const struct rgsl_manifest_option* option = rgsl_find_manifest_option(argument, &value);
+        if (option == NULL) {
+            rgsl_printf_error("%s:%zu: unknown option: %s\n", path, line_number, argument);
+            return false;
+        }
+        if (value == NULL) {
+            value = arguments[++i];
+            if (value == NULL) {
+                rgsl_printf_error("%s:%zu: the %s option requires a value\n", path, line_number, argument);
+                return false;
+            }
+        }
+        option->set_func(job, value);
+    }
+    if (job->input_file == NULL) {
+        rgsl_printf_error("%s:%zu: missing input file\n", path, line_number);
+        return false;
+    }
+    return true;
+}
+
+bool rgsl_manifest_load(struct rgsl_manifest* manifest, const char* path) {
+    char* raw_content = NULL;
+    rgsl_read_file(path, &raw_content);
+    if (raw_content == NULL) {
+        rgsl_printf_error("Failed to read manifest file: %s\n", path);
+        return false;
+    }
+    char* content = rgsl_crlf_to_lf(raw_content);
+    rgsl_free_file_buffer(raw_content);
+
+    bool success = true;
+    size_t first_job = manifest->count;
+    size_t line_number = 0;
+    for (char* line = content; success && line != NULL; ) {
+        char* line_end = strchr(line, '\n');
+        if (line_end != NULL) {
+            *line_end = '\0';
+        }
+        line_number++;
+        size_t count;
+        char** arguments = rgsl_split_arguments(line, &count);
+        if (count > 0) {
+            struct rgsl_job job = {0};
+            success = rgsl_parse_manifest_line(path, line_number, arguments, &job);
+            if (success) {
+                rgsl_manifest_add_job(manifest, &job);
+            }
+        }
+        rgsl_free_arguments(arguments);
+        line = (line_end != NULL) ? line_end + 1 : NULL;
+    }
+    rgsl_free(content);
+    rgsl_printf_info(2, "Loaded %zu jobs from manifest %s\n", manifest->count - first_job, path);
+    return success;
+}
+
+void rgsl_manifest_free(struct rgsl_manifest* manifest) {
+    rgsl_free(manifest->jobs);
+    rgsl_manifest_init(manifest);
+}
\ No newline at end of file
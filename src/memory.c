@@ -0,0 +1,326 @@
+#include <RGSL/memory.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/thread.h>
+#include <RGSL/termio.h>
+#include <RGSL/fileio.h>
+#include <RGSL/text.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#include <malloc.h>
+#define rgsl_block_size(pointer) _msize(pointer)
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define rgsl_block_size(pointer) malloc_size(pointer)
+#else
+#include <malloc.h>
+#define rgsl_block_size(pointer) malloc_usable_size(pointer)
+#endif
+
+/**
+ * Allocations made in a phase or for a shader, and the peaks reached meanwhile.
+ */
+struct rgsl_memory_usage {
+    size_t allocations;
+    size_t bytes;
+    size_t peak;
+    size_t peak_rss;
+};
+
+struct rgsl_memory_shader {
+    const char* name;
+    struct rgsl_memory_usage usage;
+};
+
+/**
+ * Shader scope of a thread, its index is one past the shader in memory_shaders.
+ */
+struct rgsl_memory_scope {
+    size_t shader;
+    int depth;
+};
+
+static const char* const PHASE_NAMES[RGSL_PHASE_COUNT] = {
+    "setup", "read", "preprocess", "compile", "glslang", "package", "write"
+};
+
+static RGSL_THREAD_LOCAL enum rgsl_memory_phase memory_phase = RGSL_PHASE_SETUP;
+static RGSL_THREAD_LOCAL struct rgsl_memory_scope memory_scope;
+static RGSL_THREAD_LOCAL int memory_phase_depth = 0;
+
+// The bookkeeping below uses the C library directly, it is never accounted itself.
+static bool memory_enabled = false;
+static rgsl_mutex memory_mutex;
+static struct rgsl_memory_usage memory_total;
+static size_t memory_live = 0;
+static struct rgsl_memory_usage memory_phases[RGSL_PHASE_COUNT];
+static struct rgsl_memory_shader* memory_shaders = NULL;
+static size_t memory_shader_count = 0;
+static size_t memory_shader_capacity = 0;
+
+static void rgsl_update_usage(struct rgsl_memory_usage* usage, size_t added, size_t rss) {
+    if (added > 0) {
+        usage->allocations++;
+        usage->bytes += added;
+        usage->peak = (memory_live > usage->peak) ? memory_live : usage->peak;
+    }
+    usage->peak_rss = (rss > usage->peak_rss) ? rss : usage->peak_rss;
+}
+
+// Frees of blocks allocated before the report started are never below zero.
+static void rgsl_memory_account(size_t added, size_t removed, size_t rss) {
+    rgsl_mutex_lock(&memory_mutex);
+    memory_live -= (removed < memory_live) ? removed : memory_live;
+    memory_live += added;
+    rgsl_update_usage(&memory_total, added, rss);
+    rgsl_update_usage(&memory_phases[memory_phase], added, rss);
+    if (memory_scope.shader > 0) {
+        rgsl_update_usage(&memory_shaders[memory_scope.shader - 1].usage, added, rss);
+    }
+    rgsl_mutex_unlock(&memory_mutex);
+}
+
+void* rgsl_malloc(size_t size) {
+    void* pointer = malloc(size);
+    if (memory_enabled && pointer != NULL) {
+        rgsl_memory_account(rgsl_block_size(pointer), 0, 0);
+    }
+    return pointer;
+}
+
+void* rgsl_calloc(size_t count, size_t size) {
+    void* pointer = calloc(count, size);
+    if (memory_enabled && pointer != NULL) {
+        rgsl_memory_account(rgsl_block_size(pointer), 0, 0);
+    }
+    return pointer;
+}
+
+void* rgsl_realloc(void* pointer, size_t size) {
+    if (!memory_enabled) {
+        return realloc(pointer, size);
+    }
+    size_t removed = (pointer != NULL) ? rgsl_block_size(pointer) : 0;
+    void* resized = realloc(pointer, size);
+    if (resized != NULL) {
+        rgsl_memory_account(rgsl_block_size(resized), removed, 0);
+    }
+    return resized;
+}
+
+void rgsl_free(void* pointer) {
+    if (memory_enabled && pointer != NULL) {
+        rgsl_memory_account(0, rgsl_block_size(pointer), 0);
+    }
+    free(pointer);
+}
+
+char* rgsl_strdup(const char* str) {
+    size_t size = strlen(str) + 1;
+    char* copy = (char *)rgsl_malloc(size);
+    if (copy != NULL) {
+        memcpy(copy, str, size);
+    }
+    return copy;
+}
+
+size_t rgsl_memory_rss(size_t* out_peak) {
+    size_t rss = 0;
+    size_t peak = 0;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        rss = counters.WorkingSetSize;
+        peak = counters.PeakWorkingSetSize;
+    }
+#else
+    // Linux only, other systems report an unknown size.
+    FILE* file = NULL;
+    fopen_s(&file, "/proc/self/status", "r");
+    if (file != NULL) {
+        char line[128];
+        unsigned long long kilobytes;
+        while (fgets(line, sizeof(line), file) != NULL) {
+            if (sscanf(line, "VmRSS: %llu kB", &kilobytes) == 1) {
+                rss = (size_t)kilobytes * 1024;
+            } else if (sscanf(line, "VmHWM: %llu kB", &kilobytes) == 1) {
+                peak = (size_t)kilobytes * 1024;
+            }
+        }
+        fclose(file);
+    }
+#endif
+    if (out_peak != NULL) {
+        *out_peak = peak;
+    }
+    return rss;
+}
+
+bool rgsl_memory_report_enabled() {
+    return rgsl_global_options.mem_report != NULL;
+}
+
+void rgsl_memory_report_start() {
+    if (!rgsl_memory_report_enabled()) {
+        return;
+    }
+    rgsl_mutex_init(&memory_mutex);
+    memory_enabled = true;
+}
+
+// Samples the resident set size, shared by the phase ending and the one starting.
+static void rgsl_memory_switch_phase(enum rgsl_memory_phase phase, bool sample) {
+    size_t rss = sample ? rgsl_memory_rss(NULL) : 0;
+    if (sample) {
+        rgsl_memory_account(0, 0, rss);
+    }
+    memory_phase = phase;
+    if (sample) {
+        rgsl_memory_account(0, 0, rss);
+    }
+}
+
+enum rgsl_memory_phase rgsl_memory_enter_phase(enum rgsl_memory_phase phase) {
+    enum rgsl_memory_phase previous = memory_phase;
+    // The steps of a shader and the calls into glslang are sampled, the other nested switches
+    // are too frequent to read the size on.
+    bool outermost = (memory_phase_depth++ == 0) && memory_scope.shader > 0;
+    rgsl_memory_switch_phase(phase, memory_enabled && (outermost || phase == RGSL_PHASE_GLSLANG));
+    return previous;
+}
+
+void rgsl_memory_leave_phase(enum rgsl_memory_phase previous) {
+    bool outermost = (--memory_phase_depth == 0) && memory_scope.shader > 0;
+    rgsl_memory_switch_phase(previous, memory_enabled && (outermost || memory_phase == RGSL_PHASE_GLSLANG));
+}
+
+static size_t rgsl_find_memory_shader(const char* name) {
+    // The steps of a job are close to each other, look from the latest shader.
+    for (size_t i = memory_shader_count; i > 0; i--) {
+        if (strcmp(memory_shaders[i - 1].name, name) == 0) {
+            return i;
+        }
+    }
+    if (memory_shader_count == memory_shader_capacity) {
+        memory_shader_capacity = memory_shader_capacity ? memory_shader_capacity * 2 : 16;
+        memory_shaders = (struct rgsl_memory_shader *)realloc(memory_shaders, memory_shader_capacity * sizeof(struct rgsl_memory_shader));
+    }
+    memset(&memory_shaders[memory_shader_count], 0, sizeof(struct rgsl_memory_shader));
+    memory_shaders[memory_shader_count].name = name;
+    return ++memory_shader_count;
+}
+
+void rgsl_memory_begin_shader(const char* shader) {
+    if (!memory_enabled || memory_scope.depth++ > 0) {
+        return;
+    }
+    rgsl_mutex_lock(&memory_mutex);
+    memory_scope.shader = rgsl_find_memory_shader(shader);
+    rgsl_mutex_unlock(&memory_mutex);
+}
+
+void rgsl_memory_end_shader() {
+    if (!memory_enabled || memory_scope.depth == 0 || --memory_scope.depth > 0) {
+        return;
+    }
+    memory_scope.shader = 0;
+}
+
+void rgsl_memory_save_context(struct rgsl_memory_context* out_context) {
+    out_context->phase = memory_phase;
+    out_context->shader = memory_scope.shader;
+}
+
+void rgsl_memory_restore_context(const struct rgsl_memory_context* context) {
+    memory_phase = context->phase;
+    memory_scope.shader = context->shader;
+    memory_scope.depth = (context->shader > 0) ? 1 : 0;
+    memory_phase_depth = memory_scope.depth; // A worker of a shader runs within the phase of its step
+}
+
+static void rgsl_print_memory_row(int name_width, const char* name, const struct rgsl_memory_usage* usage) {
+    printf("%-*s %11zu %11.1f %11.1f %11.1f\n", name_width, name, usage->allocations,
+        (double)usage->bytes / 1024.0, (double)usage->peak / 1024.0, (double)usage->peak_rss / 1024.0);
+}
+
+static void rgsl_print_memory_table() {
+    int name_width = 10;
+    for (size_t i = 0; i < memory_shader_count; i++) {
+        int length = (int)strlen(memory_shaders[i].name);
+        name_width = (length > name_width) ? length : name_width;
+    }
+    printf("%-*s %11s %11s %11s %11s\n", name_width, "Phase", "Allocs", "Bytes (KiB)", "Peak (KiB)", "RSS (KiB)");
+    for (size_t phase = 0; phase < RGSL_PHASE_COUNT; phase++) {
+        rgsl_print_memory_row(name_width, PHASE_NAMES[phase], &memory_phases[phase]);
+    }
+    printf("%-*s %11s %11s %11s %11s\n", name_width, "Shader", "Allocs", "Bytes (KiB)", "Peak (KiB)", "RSS (KiB)");
+    for (size_t i = 0; i < memory_shader_count; i++) {
+        rgsl_print_memory_row(name_width, memory_shaders[i].name, &memory_shaders[i].usage);
+    }
+    rgsl_print_memory_row(name_width, "Total", &memory_total);
+    fflush(stdout);
+}
+
+static void rgsl_write_memory_usage(struct rgsl_text* output, const char* name, const struct rgsl_memory_usage* usage) {
+    rgsl_text_append(output, "{\"name\": \"", 10);
+    for (const char* c = name; *c != '\0'; c++) {
+        if (*c == '"' || *c == '\\') {
+            rgsl_text_append(output, "\\", 1);
+        }
+        rgsl_text_append(output, c, 1);
+    }
+    rgsl_text_printf(output, "\", \"allocations\": %zu, \"bytes\": %zu, \"peak\": %zu, \"peak_rss\": %zu}",
+        usage->allocations, usage->bytes, usage->peak, usage->peak_rss);
+}
+
+static bool rgsl_write_memory_json(const char* path, size_t peak_rss) {
+    struct rgsl_text output;
+    rgsl_text_init(&output);
+    rgsl_text_printf(&output, "{\n  \"allocations\": %zu,\n  \"bytes\": %zu,\n  \"peak\": %zu,\n  \"peak_rss\": %zu,\n  \"phases\": [\n",
+        memory_total.allocations, memory_total.bytes, memory_total.peak, peak_rss);
+    for (size_t phase = 0; phase < RGSL_PHASE_COUNT; phase++) {
+        rgsl_text_append(&output, "    ", 4);
+        rgsl_write_memory_usage(&output, PHASE_NAMES[phase], &memory_phases[phase]);
+        rgsl_text_printf(&output, "%s\n", (phase + 1 < RGSL_PHASE_COUNT) ? "," : "");
+    }
+    rgsl_text_printf(&output, "  ],\n  \"shaders\": [\n");
+    for (size_t i = 0; i < memory_shader_count; i++) {
+        rgsl_text_append(&output, "    ", 4);
+        rgsl_write_memory_usage(&output, memory_shaders[i].name, &memory_shaders[i].usage);
+        rgsl_text_printf(&output, "%s\n", (i + 1 < memory_shader_count) ? "," : "");
+    }
+    rgsl_text_printf(&output, "  ]\n}\n");
+    bool success = rgsl_write_file(path, output.data, output.length);
+    rgsl_text_free(&output);
+    if (!success) {
+        rgsl_printf_error("Failed to write memory report: %s\n", path);
+    }
+    return success;
+}
+
+bool rgsl_memory_report_finalize() {
+    if (!memory_enabled) {
+        return true;
+    }
+    size_t peak_rss = 0;
+    size_t rss = rgsl_memory_rss(&peak_rss);
+    rgsl_memory_account(0, 0, rss);
+    // The report itself is not accounted.
+    memory_enabled = false;
+    rgsl_mutex_destroy(&memory_mutex);
+    peak_rss = (peak_rss > memory_total.peak_rss) ? peak_rss : memory_total.peak_rss;
+
+    rgsl_print_memory_table();
+    rgsl_printf_info(1, "Peak of %.1f KiB allocated by RGSL in %zu allocations, peak resident set size of %.1f KiB\n",
+        (double)memory_total.peak / 1024.0, memory_total.allocations, (double)peak_rss / 1024.0);
+    bool success = rgsl_write_memory_json(rgsl_global_options.mem_report, peak_rss);
+    free(memory_shaders);
+    memory_shaders = NULL;
+    memory_shader_count = 0;
+    memory_shader_capacity = 0;
+    return success;
+}
\ No newline at end of file
@@ -1,9 +1,20 @@
 #include <RGSL/packager.h>
 #include <RGSL/termio.h>
+#include <RGSL/fileio.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/text.h>
+#include <RGSL/spec.h>
+#include <RGSL/layout.h>
+#include <RGSL/target.h>
+#include <RGSL/link.h>
+#include <RGSL/glsl/uniforms.h>
+#include <RGSL/memory.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
 #include <stdint.h>
+#include <inttypes.h>
+#include <ctype.h>
 
 static const struct rgsl_stage_mapping STAGE_MAPPINGS[] = {
     {"vert", "RGSL_VERTEX"},
@@ -11,41 +22,105 @@ static const struct rgsl_stage_mapping STAGE_MAPPINGS[] = {
     {"comp", "RGSL_COMPUTE"}
 };
 
-void write_embedded_spirv(FILE *output_file, const uint32_t* spirv_words, size_t word_count) {
-    fprintf(output_file, "\t{\n\t\t");
+void write_embedded_spirv(struct rgsl_text *output, const uint32_t* spirv_words, size_t word_count) {
+    rgsl_text_printf(output, "\t{\n\t\t");
     for (size_t i = 0, j = 1; i < word_count; i++, j++) {
-        fprintf(output_file, "0x%08X", spirv_words[i]);
+        rgsl_text_printf(output, "0x%08X", spirv_words[i]);
         if (i < word_count - 1) {
             if (j == 10) {
-                fprintf(output_file, ",\n\t\t");
+                rgsl_text_printf(output, ",\n\t\t");
                 j = 0;
             } else {
-                fprintf(output_file, ", ");
+                rgsl_text_printf(output, ", ");
             }
         } else {
-            fprintf(output_file, "\n");
+            rgsl_text_printf(output, "\n");
         }
     }
-    fprintf(output_file, "\t};\n");
+    rgsl_text_printf(output, "\t};\n");
 }
 
-void write_embedded_glsl(FILE *output_file, const char* glsl_code) {
+void write_embedded_glsl(struct rgsl_text *output, const char* glsl_code, size_t length) {
     const char* ptr = glsl_code;
-    fprintf(output_file, "\t\t\"");
-    for (;*ptr != '\0'; ptr++) {
+    rgsl_text_printf(output, "\t\t\"");
+    for (;ptr != glsl_code + length; ptr++) {
         if (*ptr == '\n') {
-            fprintf(output_file, "\\n\"\n\t\t\"");
+            rgsl_text_printf(output, "\\n\"\n\t\t\"");
         } else if (*ptr == '\r') {
             continue; // Skip carriage returns
         } else if (*ptr == '\"') {
-            fprintf(output_file, "\\\"");
+            rgsl_text_printf(output, "\\\"");
         } else if (*ptr == '\\') {
-            fprintf(output_file, "\\\\");
+            rgsl_text_printf(output, "\\\\");
         } else {
-            fprintf(output_file, "%c", *ptr);
+            rgsl_text_append(output, ptr, 1);
         }
     }
-    fprintf(output_file, "\",\n");
+    rgsl_text_printf(output, "\"");
+}
+
+// Writes a prefixed name as a C string literal, shader names come from file names and may hold any character.
+static void rgsl_write_name_literal(struct rgsl_text *output, const char* prefix, const char* name) {
+    rgsl_text_printf(output, "\"%s", prefix);
+    for (const char* ptr = name; *ptr != '\0'; ptr++) {
+        if (*ptr == '\"' || *ptr == '\\') {
+            rgsl_text_printf(output, "\\%c", *ptr);
+        } else if (!isprint((unsigned char)*ptr)) {
+            rgsl_text_printf(output, "\\%03o", (unsigned)(unsigned char)*ptr);
+        } else {
+            rgsl_text_append(output, ptr, 1);
+        }
+    }
+    rgsl_text_printf(output, "\"");
+}
+
+bool rgsl_shared_chunks_enabled() {
+    return rgsl_global_options.shared_chunks != 0;
+}
+
+static void rgsl_add_chunk_end(struct rgsl_shader_data* shader, size_t* capacity, size_t end) {
+    if (shader->chunk_count == *capacity) {
+        *capacity = (*capacity != 0) ? *capacity * 2 : 8;
+        shader->chunk_ends = (size_t *)rgsl_realloc(shader->chunk_ends, *capacity * sizeof(size_t));
+    }
+    shader->chunk_ends[shader->chunk_count++] = end;
+}
+
+void rgsl_find_shader_chunks(struct rgsl_shader_data* shader) {
+    rgsl_free(shader->chunk_ends);
+    shader->chunk_ends = NULL;
+    shader->chunk_count = 0;
+    const char* code = shader->code;
+    size_t line_count = 0;
+    for (const char* line = code; *line != '\0'; line_count++) {
+        const char* end = strchr(line, '\n');
+        line = (end != NULL) ? end + 1 : line + strlen(line);
+    }
+    // The output of GLSL shaders is their preprocessed code, line for line.
+    const struct rgsl_line_map* map = &shader->line_map;
+    bool mapped = strcmp(shader->language, "glsl") == 0 && map->line_count == line_count;
+
+    size_t capacity = 0;
+    size_t index = 0;
+    int depth = 0;
+    bool closed = false;
+    for (const char* line = code; *line != '\0'; index++) {
+        const char* end = strchr(line, '\n');
+        end = (end != NULL) ? end + 1 : line + strlen(line);
+        bool cut = mapped ? (index > 0 && map->lines[index].file != map->lines[index - 1].file) : closed;
+        if (cut && line != code) {
+            rgsl_add_chunk_end(shader, &capacity, (size_t)(line - code));
+        }
+        bool brace = false;
+        for (const char* c = line; c != end; c++) {
+            depth += (*c == '{') ? 1 : (*c == '}') ? -1 : 0;
+            brace |= (*c == '}');
+        }
+        // Directives, such as #version, differ between shaders more than the declarations.
+        closed = depth == 0 && (brace || *line == '#');
+        line = end;
+    }
+    rgsl_add_chunk_end(shader, &capacity, strlen(code));
 }
 
 const char* rgsl_get_stage_enum(const char* stage) {
@@ -58,20 +133,44 @@ const char* rgsl_get_stage_enum(const char* stage) {
     return "RGSL_UNKNOWN_STAGE";
 }
 
-bool rgsl_package_shaders(struct rgsl_shader_data* shaders) {
-    bool success = true;
-
-    FILE *output_file;
-    fopen_s(&output_file, rgsl_global_options.output_file, "w");
-    if (output_file == NULL) {
-        rgsl_printf_error("Failed to open output file for packaging: %s\n", rgsl_global_options.output_file);
-        return false;
-    }
+static void rgsl_write_header(struct rgsl_text *output) {
+    rgsl_text_printf(output, "// Generated by RGSL Shader Packager\n\n");
+    rgsl_text_printf(output, "#include <stdint.h>\n");
+    rgsl_text_printf(output, "#include <stddef.h>\n\n");
+}
 
-    fprintf(output_file, "// Generated by RGSL Shader Packager\n\n");
-    fprintf(output_file, "#include <stdint.h>\n\n");
+static void rgsl_write_glsl_source_definition(struct rgsl_text *output) {
+    rgsl_text_printf(output,
+        "struct rgsl_glsl_source {\n"
+        "    int count;\n"
+        "    const char *const *strings;\n"
+        "    const int *lengths;\n"
+        "};\n"
+        "\n"
+    );
+}
 
-    fprintf(output_file, 
+static void rgsl_write_blob_definition(struct rgsl_text *output) {
+    bool specialized = rgsl_spec_constant_count() > 0;
+    if (specialized) {
+        rgsl_text_printf(output,
+        "struct rgsl_specialization {\n"
+        "    uint32_t constant_id;\n"
+        "    uint32_t value;\n"
+        "};\n"
+        "\n"
+        );
+        rgsl_write_spec_constant_enum(output);
+    }
+    bool targets = rgsl_targets_enabled();
+    if (targets) {
+        rgsl_write_target_enum(output);
+        rgsl_write_target_info_types(output);
+    }
+    if (rgsl_shared_chunks_enabled()) {
+        rgsl_write_glsl_source_definition(output);
+    }
+    rgsl_text_printf(output,
         "enum rgsl_stage {\n"
         "    RGSL_VERTEX,\n"
         "    RGSL_FRAGMENT,\n"
@@ -85,51 +184,656 @@ bool rgsl_package_shaders(struct rgsl_shader_data* shaders) {
         "    int version;\n"
         "    const char *profile;\n"
     );
-    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
-        fprintf(output_file,
+    if (targets) {
+        rgsl_text_printf(output,
+        "    enum rgsl_target target;\n"
+        );
+    }
+    rgsl_text_printf(output,
+        "    uint64_t content_hash[2];\n"
+        "    uint64_t interface_hash[2];\n"
+    );
+    if (targets) {
+        // Blobs of the SPIR-V target fill the words, the others the text.
+        if (rgsl_has_target(true)) {
+            rgsl_text_printf(output,
+            "    const uint32_t *spirv_words;\n"
+            "    size_t word_count;\n"
+            );
+        }
+        if (rgsl_has_target(false)) {
+            rgsl_text_printf(output,
+            "    const char *glsl_code;\n"
+            );
+        }
+    } else if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
+        rgsl_text_printf(output,
         "    const uint32_t *spirv_words;\n"
         "    size_t word_count;\n"
         );
+        if (rgsl_program_module_enabled()) {
+            // The stages of a program share its module, each selects its entry point.
+            rgsl_text_printf(output,
+            "    const char *entry_point;\n"
+            );
+        }
+    } else if (rgsl_shared_chunks_enabled()) {
+        rgsl_text_printf(output,
+        "    const struct rgsl_glsl_source *glsl_source;\n"
+        );
     } else {
-        fprintf(output_file,
+        rgsl_text_printf(output,
         "    const char *glsl_code;\n"
         );
     }
-    fprintf(output_file,
+    if (specialized) {
+        rgsl_text_printf(output,
+        "    const struct rgsl_specialization *specializations;\n"
+        "    size_t specialization_count;\n"
+        );
+    }
+    if (rgsl_uniform_packing_enabled()) {
+        rgsl_text_printf(output,
+        "    const char *uniform_block;\n"
+        "    uint32_t uniform_block_size;\n"
+        );
+    }
+    rgsl_text_printf(output,
         "};\n\n"
     );
+    if (targets) {
+        rgsl_text_printf(output,
+        "struct rgsl_shader_targets {\n"
+        "    const char *name;\n"
+        "    enum rgsl_stage stage;\n"
+        "    const struct rgsl_shader_blob *blobs[RGSL_TARGET_COUNT];\n"
+        "};\n\n"
+        );
+    }
+}
+
+// Writes the code fields of a blob compiled for one of the --targets.
+static void rgsl_write_target_code(struct rgsl_text *output, const struct rgsl_target_output* target_output, const char* code_symbol) {
+    bool spirv = target_output->target->spirv;
+    if (rgsl_has_target(true)) {
+        rgsl_text_printf(output, "\t\t%s,\n", spirv ? code_symbol : "NULL");
+        rgsl_text_printf(output, "\t\t%zu,\n", spirv ? target_output->size / sizeof(uint32_t) : 0);
+    }
+    if (rgsl_has_target(false)) {
+        rgsl_text_printf(output, "\t\t%s,\n", spirv ? "NULL" : code_symbol);
+    }
+}
 
-    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
-        for (size_t i = 0; shaders[i].code != NULL; i++) {
-            fprintf(output_file, "static const uint32_t __rgsl__spirv_words_%zu[] = \n", i);
-            write_embedded_spirv(output_file, (const uint32_t*)shaders[i].code, shaders[i].word_count);
+static void rgsl_write_blob_entry(struct rgsl_text *output, const struct rgsl_shader_data* shader, const struct rgsl_target_output* target_output, const char* code_symbol, struct rgsl_hash128 content_hash, const char* specialization_symbol) {
+    const struct rgsl_shader_profile* profile = (target_output != NULL) ? &target_output->profile : &shader->profile;
+    rgsl_text_printf(output, "\t{\n");
+
+    rgsl_text_printf(output, "\t\t");
+    rgsl_write_name_literal(output, "shader_", shader->name);
+    rgsl_text_printf(output, ",\n");
+    rgsl_text_printf(output, "\t\t%s,\n", rgsl_get_stage_enum(shader->stage));
+    rgsl_text_printf(output, "\t\t%d,\n", profile->version);
+    rgsl_text_printf(output, "\t\t\"%s\",\n", profile->name);
+    if (target_output != NULL) {
+        rgsl_text_printf(output, "\t\t");
+        rgsl_write_target_name(output, target_output->target);
+        rgsl_text_printf(output, ",\n");
+    }
+    rgsl_text_printf(output, "\t\t{0x%016" PRIx64 "ULL, 0x%016" PRIx64 "ULL},\n", content_hash.low, content_hash.high);
+    rgsl_text_printf(output, "\t\t{0x%016" PRIx64 "ULL, 0x%016" PRIx64 "ULL},\n", shader->interface_hash.low, shader->interface_hash.high);
+
+    if (target_output != NULL) {
+        rgsl_write_target_code(output, target_output, code_symbol);
+    } else {
+        rgsl_text_printf(output, "\t\t%s,\n", code_symbol);
+    }
+    if (target_output == NULL && (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV)) {
+        rgsl_text_printf(output, "\t\t%zu,\n", shader->word_count);
+        if (rgsl_program_module_enabled()) {
+            const char* entry_point = rgsl_spirv_entry_point((const uint32_t*)shader->code, shader->word_count, shader->stage);
+            if (entry_point != NULL) {
+                rgsl_text_printf(output, "\t\t\"%s\",\n", entry_point);
+            } else {
+                rgsl_text_printf(output, "\t\tNULL,\n");
+            }
+        }
+    }
+    if (rgsl_spec_constant_count() > 0) {
+        rgsl_text_printf(output, "\t\t%s,\n", specialization_symbol != NULL ? specialization_symbol : "NULL");
+        rgsl_text_printf(output, "\t\t%zu,\n", shader->specialization_count);
+    }
+    if (rgsl_uniform_packing_enabled()) {
+        const struct rgsl_block_layout* block = shader->uniform_block;
+        if (block != NULL) {
+            rgsl_text_printf(output, "\t\t\"%s\",\n\t\t%u,\n", block->name, block->size);
+        } else {
+            rgsl_text_printf(output, "\t\tNULL,\n\t\t0,\n");
         }
     }
+    rgsl_text_printf(output, "\t},\n");
+}
 
-    fprintf(output_file, "const struct rgsl_shader_blob rgsl_shaders[] = {\n");
+static bool rgsl_flush_text(FILE *output_file, struct rgsl_text *output) {
+    bool success = fwrite(output->data, 1, output->length, output_file) == output->length;
+    rgsl_text_clear(output);
+    return success;
+}
 
-    for (size_t i = 0; shaders[i].code != NULL; i++) {
-        struct rgsl_shader_data shader = shaders[i];
-        const char* shader_code = shader.code;
-        const size_t word_count = shader.word_count;
-        
-        fprintf(output_file, "\t{\n");
+static char* rgsl_unique_shader_key(struct rgsl_hashmap* used_keys, const struct rgsl_shader_data* shader, const char* target_name) {
+    // Keys name both the symbols and the files, they must be valid C identifiers.
+    size_t length = strlen(shader->name) + strlen(shader->stage) + (target_name != NULL ? strlen(target_name) + 1 : 0) + 24;
+    char* key = (char *)rgsl_malloc(length);
+    snprintf(key, length, "%s_%s%s%s", shader->name, shader->stage, target_name != NULL ? "_" : "", target_name != NULL ? target_name : "");
+    for (char* c = key; *c != '\0'; c++) {
+        if (!isalnum((unsigned char)*c)) {
+            *c = '_';
+        }
+    }
+    size_t base_length = strlen(key);
+    for (size_t suffix = 2; rgsl_hashmap_find(used_keys, key, NULL); suffix++) {
+        snprintf(key + base_length, length - base_length, "_%zu", suffix);
+    }
+    rgsl_hashmap_set(used_keys, key, NULL);
+    return key;
+}
 
-        fprintf(output_file, "\t\t\"shader_%s\",\n", shader.name);
-        fprintf(output_file, "\t\t%s,\n", rgsl_get_stage_enum(shader.stage));
-        fprintf(output_file, "\t\t%d,\n", shader.profile.version);
-        fprintf(output_file, "\t\t\"%s\",\n", shader.profile.name);
+static char* rgsl_split_file_path(const char* index_path, const char* key) {
+    size_t base_length = strlen(index_path);
+    if (base_length > 2 && strcmp(index_path + base_length - 2, ".c") == 0) {
+        base_length -= 2;
+    }
+    size_t length = base_length + strlen(key) + 4;
+    char* path = (char *)rgsl_malloc(length);
+    snprintf(path, length, "%.*s_%s.c", (int)base_length, index_path, key);
+    return path;
+}
 
-        if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
-            fprintf(output_file, "\t\t__rgsl__spirv_words_%zu,\n", i);
-            fprintf(output_file, "\t\t%zu,\n", word_count);
-        } else {
-            write_embedded_glsl(output_file, shader_code);
+static bool rgsl_write_generated_file(const char* path, const struct rgsl_text* output) {
+    bool written;
+    if (!rgsl_write_file_if_changed(path, output->data, output->length, &written)) {
+        rgsl_printf_error("Failed to write output file for packaging: %s\n", path);
+        return false;
+    }
+    rgsl_printf_info(2, written ? "Written %s\n" : "Unchanged %s\n", path);
+    return true;
+}
+
+// The blobs are written as they come, into a temporary file renamed once complete.
+static bool rgsl_open_package_file(const char* output_file, char** out_temp_file, FILE** out_file) {
+    size_t length = strlen(output_file) + 5;
+    *out_temp_file = (char *)rgsl_malloc(length);
+    snprintf(*out_temp_file, length, "%s.tmp", output_file);
+    fopen_s(out_file, *out_temp_file, "w");
+    if (*out_file == NULL) {
+        rgsl_printf_error("Failed to open output file for packaging: %s\n", *out_temp_file);
+        rgsl_free(*out_temp_file);
+        *out_temp_file = NULL;
+        return false;
+    }
+    return true;
+}
+
+static bool rgsl_close_package_file(const char* output_file, char* temp_file, FILE* file, bool success, bool commit) {
+    success &= fclose(file) == 0;
+    if (success) {
+        remove(output_file);
+        success &= rename(temp_file, output_file) == 0;
+    }
+    if (!success) {
+        remove(temp_file);
+        if (commit) {
+            rgsl_printf_error("Failed to write output file for packaging: %s\n", output_file);
+        }
+    }
+    rgsl_free(temp_file);
+    return success;
+}
+
+bool rgsl_packager_begin(struct rgsl_packager* packager, const char* output_file) {
+    packager->output_file = output_file;
+    packager->temp_file = NULL;
+    packager->file = NULL;
+    packager->profile = rgsl_global_usage_profile();
+    packager->cold_output_file = NULL;
+    packager->cold_temp_file = NULL;
+    packager->cold_file = NULL;
+    packager->layout = NULL;
+    packager->layout_count = 0;
+    packager->layout_capacity = 0;
+    rgsl_text_init(&packager->output);
+    rgsl_text_init(&packager->declarations);
+    rgsl_text_init(&packager->entries);
+    rgsl_text_init(&packager->targets);
+    rgsl_text_init(&packager->programs);
+    rgsl_text_init(&packager->cold_entries);
+    rgsl_text_init(&packager->cold_programs);
+    rgsl_hashmap_init(&packager->used_keys);
+    rgsl_hashmap_init(&packager->blobs);
+    rgsl_hashmap_init(&packager->mirrors);
+    rgsl_hashmap_init(&packager->chunks);
+    packager->count = 0;
+    packager->program_first = 0;
+    packager->cold_count = 0;
+    packager->program_first_cold = 0;
+    packager->program_name = NULL;
+    packager->text_size = 0;
+    packager->chunk_size = 0;
+    packager->split = rgsl_global_options.split_embed != 0;
+    packager->spirv = (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) != 0;
+    packager->chunked = rgsl_shared_chunks_enabled() && !packager->spirv;
+    packager->cold_split = rgsl_cold_split_enabled() && packager->profile != NULL && !packager->split;
+    packager->cold = false;
+    packager->success = true;
+    if (packager->split) {
+        return true;
+    }
+
+    if (!rgsl_open_package_file(output_file, &packager->temp_file, &packager->file)) {
+        packager->success = false;
+        return false;
+    }
+    rgsl_write_header(&packager->output);
+    rgsl_write_blob_definition(&packager->output);
+    packager->success &= rgsl_flush_text(packager->file, &packager->output);
+    if (packager->cold_split) {
+        // The shaders not used at startup form a package of their own, loaded later.
+        packager->cold_output_file = rgsl_split_file_path(output_file, "cold");
+        if (!rgsl_open_package_file(packager->cold_output_file, &packager->cold_temp_file, &packager->cold_file)) {
+            packager->success = false;
+            return false;
         }
-        fprintf(output_file, "\t},\n");
+        rgsl_write_header(&packager->output);
+        rgsl_write_blob_definition(&packager->output);
+        packager->success &= rgsl_flush_text(packager->cold_file, &packager->output);
     }
+    return packager->success;
+}
+
+static void rgsl_write_specializations(struct rgsl_text* output, const struct rgsl_shader_data* shader, const char* symbol) {
+    rgsl_text_printf(output, "static const struct rgsl_specialization %s[] = {\n", symbol);
+    for (size_t i = 0; i < shader->specialization_count; i++) {
+        rgsl_text_printf(output, "\t{%u, 0x%08X},\n", (unsigned)shader->specializations[i].constant_id, (unsigned)shader->specializations[i].value);
+    }
+    rgsl_text_printf(output, "};\n");
+}
+
+// Writes the mirror of a layout once, choosing the name of its structure.
+static void rgsl_write_mirror(struct rgsl_packager* packager, struct rgsl_block_layout* block) {
+    // Shaders of different directories often share a name, and then usually their blocks.
+    size_t length = strlen(block->name) + 24;
+    rgsl_free(block->mirror_name);
+    block->mirror_name = (char *)rgsl_malloc(length);
+    snprintf(block->mirror_name, length, "%s", block->name);
+    struct rgsl_text mirror = {0};
+    for (size_t suffix = 2; ; suffix++) {
+        rgsl_text_clear(&mirror);
+        rgsl_write_block_mirror(&mirror, block);
+        const char* written = (const char*)rgsl_hashmap_get(&packager->mirrors, block->mirror_name);
+        if (written == NULL) {
+            rgsl_hashmap_set(&packager->mirrors, block->mirror_name, rgsl_strdup(mirror.data));
+            rgsl_text_append(packager->split ? &packager->declarations : &packager->output, mirror.data, mirror.length);
+            break;
+        }
+        if (strcmp(written, mirror.data) == 0) {
+            break;
+        }
+        snprintf(block->mirror_name, length, "%s_%zu", block->name, suffix);
+    }
+    rgsl_text_free(&mirror);
+}
+
+static void rgsl_write_mirrors(struct rgsl_packager* packager, const struct rgsl_shader_data* shader) {
+    if (shader->uniform_block != NULL) {
+        rgsl_write_mirror(packager, shader->uniform_block);
+    }
+    // The layouts come in dependency order, each structure is named before the mirrors using it.
+    for (size_t i = 0; i < shader->layout_count; i++) {
+        struct rgsl_block_layout* block = shader->layouts[i];
+        bool runtime_array_only = block->member_count == 1 && block->members[0].array_size == RGSL_RUNTIME_ARRAY;
+        if (!runtime_array_only) {
+            rgsl_write_mirror(packager, block);
+        }
+    }
+}
+
+// Number of characters of GLSL code once embedded, carriage returns being skipped.
+static size_t rgsl_embedded_glsl_length(const char* code, size_t length) {
+    size_t embedded = length;
+    for (size_t i = 0; i < length; i++) {
+        embedded -= (code[i] == '\r') ? 1 : 0;
+    }
+    return embedded;
+}
+
+// Writes a chunk once, returns the symbol of the chunk, declared in the current output.
+static const char* rgsl_packager_add_chunk(struct rgsl_packager* packager, const char* chunk, size_t length) {
+    struct rgsl_hash128 hash = rgsl_hash128_bytes(chunk, length);
+    char hash_key[33];
+    snprintf(hash_key, sizeof(hash_key), "%016" PRIx64 "%016" PRIx64, hash.low, hash.high);
+    const char* symbol = (const char*)rgsl_hashmap_get(&packager->chunks, hash_key);
+    if (symbol != NULL) {
+        if (packager->split) {
+            // Defined by the file of the first shader holding it.
+            rgsl_text_printf(&packager->output, "extern const char %s[];\n", symbol);
+        }
+        return symbol;
+    }
+    char name[48];
+    snprintf(name, sizeof(name), "__rgsl__glsl_chunk_%zu", packager->chunks.count);
+    rgsl_text_printf(&packager->output, "%sconst char %s[] = \n", packager->split ? "" : "static ", name);
+    write_embedded_glsl(&packager->output, chunk, length);
+    rgsl_text_printf(&packager->output, ";\n");
+    packager->chunk_size += length;
+    char* copy = rgsl_strdup(name);
+    rgsl_hashmap_set(&packager->chunks, hash_key, copy);
+    return copy;
+}
+
+// Writes the chunks of a shader not written yet, then the table of its chunks.
+static void rgsl_write_glsl_source(struct rgsl_packager* packager, const struct rgsl_shader_data* shader, const char* symbol, const char* linkage) {
+    struct rgsl_text strings = {0};
+    struct rgsl_text lengths = {0};
+    size_t whole = strlen(shader->code);
+    size_t count = (shader->chunk_count > 0) ? shader->chunk_count : 1;
+    size_t start = 0;
+    if (packager->split) {
+        rgsl_write_glsl_source_definition(&packager->output);
+    }
+    for (size_t i = 0; i < count; i++) {
+        size_t end = (shader->chunk_count > 0) ? shader->chunk_ends[i] : whole;
+        const char* chunk = shader->code + start;
+        const char* chunk_symbol = rgsl_packager_add_chunk(packager, chunk, end - start);
+        rgsl_text_printf(&strings, "%s%s", i > 0 ? ", " : "", chunk_symbol);
+        rgsl_text_printf(&lengths, "%s%zu", i > 0 ? ", " : "", rgsl_embedded_glsl_length(chunk, end - start));
+        start = end;
+    }
+    rgsl_text_printf(&packager->output, "static const char *const %s_strings[] = {%s};\n", symbol, strings.data);
+    rgsl_text_printf(&packager->output, "static const int %s_lengths[] = {%s};\n", symbol, lengths.data);
+    rgsl_text_printf(&packager->output, "%sconst struct rgsl_glsl_source %s = {%zu, %s_strings, %s_lengths};\n", linkage, symbol, count, symbol, symbol);
+    rgsl_text_free(&strings);
+    rgsl_text_free(&lengths);
+}
+
+// Records where a blob is laid out, replayed against the usage profile once the package is written.
+static void rgsl_record_blob(struct rgsl_packager* packager, const struct rgsl_shader_data* shader, struct rgsl_hash128 content_hash, size_t size) {
+    if (packager->profile == NULL) {
+        return;
+    }
+    if (packager->layout_count == packager->layout_capacity) {
+        packager->layout_capacity = (packager->layout_capacity != 0) ? packager->layout_capacity * 2 : 64;
+        packager->layout = (struct rgsl_usage_blob *)rgsl_realloc(packager->layout, packager->layout_capacity * sizeof(struct rgsl_usage_blob));
+    }
+    struct rgsl_usage_blob* blob = &packager->layout[packager->layout_count++];
+    blob->path = shader->path;
+    blob->name = rgsl_strdup(shader->name);
+    blob->content_hash = content_hash;
+    blob->size = size;
+    blob->cold = packager->cold;
+}
 
-    fprintf(output_file, "};\n");
+// Writes one blob of a shader, its code or the code compiled for one target.
+static bool rgsl_packager_add_blob(struct rgsl_packager* packager, const struct rgsl_shader_data* shader, const struct rgsl_target_output* target_output, const char* specialization_symbol) {
+    bool spirv = (target_output != NULL) ? target_output->target->spirv : packager->spirv;
+    const char* code = (target_output != NULL) ? target_output->code : shader->code;
+    size_t word_count = (target_output != NULL) ? target_output->size / sizeof(uint32_t) : shader->word_count;
+    // Hashed as embedded, so the engine can key its caches without hashing at startup.
+    size_t code_size = spirv ? word_count * sizeof(uint32_t) : strlen(code);
+    struct rgsl_hash128 content_hash = rgsl_hash128_bytes(code, code_size);
+    // The cold part is another translation unit, it cannot share the static blobs of the main one.
+    char hash_key[34];
+    snprintf(hash_key, sizeof(hash_key), "%s%016" PRIx64 "%016" PRIx64, packager->cold ? "c" : "", content_hash.low, content_hash.high);
+    struct rgsl_text* entries = packager->cold ? &packager->cold_entries : &packager->entries;
+    FILE* file = packager->cold ? packager->cold_file : packager->file;
+    rgsl_record_blob(packager, shader, content_hash, code_size);
 
+    if (packager->chunked && !spirv) {
+        packager->text_size += code_size;
+    }
+    // Variants only differing by specialization constants share one blob.
+    const char* shared_symbol = (const char*)rgsl_hashmap_get(&packager->blobs, hash_key);
+    if (shared_symbol != NULL) {
+        rgsl_printf_info(2, "Shader %s shares the blob %s\n", shader->path, shared_symbol);
+        rgsl_write_blob_entry(entries, shader, target_output, shared_symbol, content_hash, specialization_symbol);
+        packager->count++;
+        packager->cold_count += packager->cold ? 1 : 0;
+        if (!packager->split) {
+            packager->success &= rgsl_flush_text(file, &packager->output);
+        }
+        return packager->success;
+    }
+
+    char* key = NULL;
+    char code_symbol[96];
+    bool chunked = packager->chunked && !spirv && target_output == NULL;
+    const char* symbol_format = spirv ? "__rgsl__spirv_words_" : chunked ? "__rgsl__glsl_source_" : "__rgsl__glsl_code_";
+    if (packager->split) {
+        key = rgsl_unique_shader_key(&packager->used_keys, shader, target_output != NULL ? target_output->target->name : NULL);
+        snprintf(code_symbol, sizeof(code_symbol), "%s%.64s", symbol_format, key);
+        rgsl_write_header(&packager->output);
+    } else {
+        snprintf(code_symbol, sizeof(code_symbol), "%s%zu", symbol_format, packager->count);
+    }
+    // Blobs of the single file are only used by its table, split ones are shared with the index.
+    const char* linkage = packager->split ? "" : "static ";
+    char entry_symbol[100];
+    snprintf(entry_symbol, sizeof(entry_symbol), chunked ? "&%s" : "%s", code_symbol);
+    if (spirv) {
+        rgsl_text_printf(&packager->output, "%sconst uint32_t %s[] = \n", linkage, code_symbol);
+        write_embedded_spirv(&packager->output, (const uint32_t*)code, word_count);
+        rgsl_text_printf(&packager->declarations, "extern const uint32_t %s[];\n", code_symbol);
+    } else if (chunked) {
+        rgsl_write_glsl_source(packager, shader, code_symbol, linkage);
+        rgsl_text_printf(&packager->declarations, "extern const struct rgsl_glsl_source %s;\n", code_symbol);
+    } else {
+        rgsl_text_printf(&packager->output, "%sconst char %s[] = \n", linkage, code_symbol);
+        write_embedded_glsl(&packager->output, code, strlen(code));
+        rgsl_text_printf(&packager->output, ";\n");
+        rgsl_text_printf(&packager->declarations, "extern const char %s[];\n", code_symbol);
+    }
+    rgsl_write_blob_entry(entries, shader, target_output, entry_symbol, content_hash, specialization_symbol);
+    rgsl_hashmap_set(&packager->blobs, hash_key, rgsl_strdup(entry_symbol));
+    packager->count++;
+    packager->cold_count += packager->cold ? 1 : 0;
+
+    if (packager->split) {
+        // Each shader gets its own translation unit, rebuilt only when its blob changes.
+        char* path = rgsl_split_file_path(packager->output_file, key);
+        packager->success &= rgsl_write_generated_file(path, &packager->output);
+        rgsl_text_clear(&packager->output);
+        rgsl_free(path);
+        rgsl_free(key);
+    } else {
+        packager->success &= rgsl_flush_text(file, &packager->output);
+    }
+    return packager->success;
+}
+
+bool rgsl_packager_add(struct rgsl_packager* packager, const struct rgsl_shader_data* shader) {
+    if (!packager->success) {
+        return false;
+    }
+    packager->cold = packager->cold_split && !rgsl_usage_is_startup(packager->profile, shader->path, shader->name);
+    if (packager->cold) {
+        // The mirrors describe the blocks to the engine, they stay in the main file.
+        rgsl_write_mirrors(packager, shader);
+        packager->success &= rgsl_flush_text(packager->file, &packager->output);
+    }
+    char specialization_symbol[64];
+    if (shader->specialization_count > 0) {
+        // Specializations are small, they stay next to the table.
+        snprintf(specialization_symbol, sizeof(specialization_symbol), "__rgsl__specializations_%zu", packager->count);
+        rgsl_write_specializations(packager->split ? &packager->declarations : &packager->output, shader, specialization_symbol);
+    }
+    if (!packager->cold) {
+        rgsl_write_mirrors(packager, shader);
+    }
+    const char* specializations = shader->specialization_count > 0 ? specialization_symbol : NULL;
+    if (shader->target_output_count == 0) {
+        return rgsl_packager_add_blob(packager, shader, NULL, specializations);
+    }
+
+    // One blob per target, and a row of the target table pointing at them.
+    rgsl_text_printf(&packager->targets, "\t{");
+    rgsl_write_name_literal(&packager->targets, "shader_", shader->name);
+    rgsl_text_printf(&packager->targets, ", %s, {", rgsl_get_stage_enum(shader->stage));
+    for (size_t i = 0; i < shader->target_output_count; i++) {
+        rgsl_text_printf(&packager->targets, "%s&rgsl_shaders[%zu]", i > 0 ? ", " : "", packager->count);
+        rgsl_packager_add_blob(packager, shader, &shader->target_outputs[i], specializations);
+    }
+    rgsl_text_printf(&packager->targets, "}},\n");
+    return packager->success;
+}
+
+void rgsl_packager_begin_program(struct rgsl_packager* packager, const char* name) {
+    packager->program_first = packager->count;
+    packager->program_first_cold = packager->cold_count;
+    rgsl_free(packager->program_name);
+    packager->program_name = rgsl_strdup(name);
+}
+
+void rgsl_packager_end_program(struct rgsl_packager* packager) {
+    // The stages share the name of the program, so the profile puts them in the same part.
+    size_t cold_stages = packager->cold_count - packager->program_first_cold;
+    if (cold_stages > 0) {
+        rgsl_text_printf(&packager->cold_programs, "\t{");
+        rgsl_write_name_literal(&packager->cold_programs, "program_", packager->program_name);
+        rgsl_text_printf(&packager->cold_programs, ", &rgsl_cold_shaders[%zu], %zu},\n", packager->program_first_cold, cold_stages);
+    } else {
+        size_t first = packager->program_first - packager->program_first_cold;
+        rgsl_text_printf(&packager->programs, "\t{");
+        rgsl_write_name_literal(&packager->programs, "program_", packager->program_name);
+        rgsl_text_printf(&packager->programs, ", &rgsl_shaders[%zu], %zu},\n", first, packager->count - packager->program_first);
+    }
+    rgsl_free(packager->program_name);
+    packager->program_name = NULL;
+}
+
+static void rgsl_write_programs(struct rgsl_text* output, const struct rgsl_text* programs, const char* table) {
+    rgsl_text_printf(output,
+        "\n"
+        "struct rgsl_shader_program {\n"
+        "    const char *name;\n"
+        "    const struct rgsl_shader_blob *blobs;\n"
+        "    size_t blob_count;\n"
+        "};\n"
+        "\n"
+        "const struct rgsl_shader_program %s[] = {\n",
+        table
+    );
+    rgsl_text_append(output, programs->data, programs->length);
+    rgsl_text_printf(output, "};\n");
+}
+
+// Writes the tables of the cold part, empty ones holding a zeroed row to stay valid C.
+static bool rgsl_write_cold_tables(struct rgsl_packager* packager) {
+    rgsl_text_printf(&packager->output, "const struct rgsl_shader_blob rgsl_cold_shaders[] = {\n");
+    if (packager->cold_entries.length > 0) {
+        rgsl_text_append(&packager->output, packager->cold_entries.data, packager->cold_entries.length);
+    } else {
+        rgsl_text_printf(&packager->output, "\t{0},\n");
+    }
+    rgsl_text_printf(&packager->output, "};\n");
+    rgsl_text_printf(&packager->output, "const size_t rgsl_cold_shader_count = %zu;\n", packager->cold_count);
+    if (packager->cold_programs.length > 0) {
+        rgsl_write_programs(&packager->output, &packager->cold_programs, "rgsl_cold_shader_programs");
+    }
+    return rgsl_flush_text(packager->cold_file, &packager->output);
+}
+
+bool rgsl_packager_end(struct rgsl_packager* packager, bool commit) {
+    bool success = packager->success && commit;
+    if (success) {
+        if (packager->split) {
+            rgsl_write_header(&packager->output);
+            rgsl_write_blob_definition(&packager->output);
+            rgsl_text_append(&packager->output, packager->declarations.data != NULL ? packager->declarations.data : "", packager->declarations.length);
+            rgsl_text_printf(&packager->output, "\n");
+        }
+        rgsl_text_printf(&packager->output, "const struct rgsl_shader_blob rgsl_shaders[] = {\n");
+        rgsl_text_append(&packager->output, packager->entries.data != NULL ? packager->entries.data : "", packager->entries.length);
+        rgsl_text_printf(&packager->output, "};\n");
+        if (rgsl_targets_enabled()) {
+            rgsl_text_printf(&packager->output, "\nconst struct rgsl_shader_targets rgsl_shader_targets[] = {\n");
+            rgsl_text_append(&packager->output, packager->targets.data != NULL ? packager->targets.data : "", packager->targets.length);
+            rgsl_text_printf(&packager->output, "};\n");
+            rgsl_write_target_infos(&packager->output);
+        }
+        if (packager->programs.length > 0) {
+            rgsl_write_programs(&packager->output, &packager->programs, "rgsl_shader_programs");
+        }
+        if (packager->split) {
+            success &= rgsl_write_generated_file(packager->output_file, &packager->output);
+        } else {
+            success &= rgsl_flush_text(packager->file, &packager->output);
+        }
+    }
+    if (packager->cold_file != NULL) {
+        if (success) {
+            success &= rgsl_write_cold_tables(packager);
+        }
+        success = rgsl_close_package_file(packager->cold_output_file, packager->cold_temp_file, packager->cold_file, success, commit);
+    }
+    if (packager->file != NULL) {
+        success = rgsl_close_package_file(packager->output_file, packager->temp_file, packager->file, success, commit);
+    }
+    rgsl_text_free(&packager->output);
+    rgsl_text_free(&packager->declarations);
+    rgsl_text_free(&packager->entries);
+    rgsl_text_free(&packager->targets);
+    rgsl_text_free(&packager->programs);
+    rgsl_text_free(&packager->cold_entries);
+    rgsl_text_free(&packager->cold_programs);
+    rgsl_free(packager->cold_output_file);
+    rgsl_free(packager->program_name);
+    rgsl_printf_info(2, "Packaged %zu shaders in %zu blobs\n", packager->count, packager->blobs.count);
+    if (packager->cold_split) {
+        rgsl_printf_info(1, "Packaged %zu shaders used at startup, and %zu apart\n", packager->count - packager->cold_count, packager->cold_count);
+    }
+    if (success && packager->profile != NULL && rgsl_global_options.usage_faults) {
+        rgsl_usage_simulate_faults(packager->profile, packager->layout, packager->layout_count);
+    }
+    for (size_t i = 0; i < packager->layout_count; i++) {
+        rgsl_free(packager->layout[i].name);
+    }
+    rgsl_free(packager->layout);
+    if (packager->chunked) {
+        rgsl_printf_info(1, "Stored %zu bytes of GLSL code in %zu shared chunks, instead of %zu\n", packager->chunk_size, packager->chunks.count, packager->text_size);
+    }
+    rgsl_hashmap_free(&packager->used_keys, NULL);
+    rgsl_hashmap_free(&packager->blobs, rgsl_free);
+    rgsl_hashmap_free(&packager->mirrors, rgsl_free);
+    rgsl_hashmap_free(&packager->chunks, rgsl_free);
     return success;
+}
+
+bool rgsl_package_shaders(struct rgsl_shader_data* shaders, struct rgsl_usage_profile* profile) {
+    size_t count = 0;
+    while (shaders[count].code != NULL) {
+        count++;
+    }
+    size_t* order = (size_t *)rgsl_malloc((count > 0 ? count : 1) * sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    profile = (profile != NULL) ? profile : rgsl_global_usage_profile();
+    if (profile != NULL && count > 0) {
+        const char** paths = (const char**)rgsl_malloc(count * sizeof(char*));
+        const char** names = (const char**)rgsl_malloc(count * sizeof(char*));
+        for (size_t i = 0; i < count; i++) {
+            paths[i] = shaders[i].path;
+            names[i] = shaders[i].name;
+        }
+        rgsl_usage_order(profile, paths, names, count, order);
+        rgsl_free(paths);
+        rgsl_free(names);
+    }
+
+    struct rgsl_packager packager;
+    bool success = rgsl_packager_begin(&packager, rgsl_global_options.output_file);
+    packager.profile = profile;
+    for (size_t i = 0; success && i < count; i++) {
+        success = rgsl_packager_add(&packager, &shaders[order[i]]);
+    }
+    rgsl_free(order);
+    return rgsl_packager_end(&packager, success);
 }
\ No newline at end of file
@@ -1,101 +1,843 @@
 #include <RGSL/parser.h>
 #include <RGSL/termio.h>
+#include <RGSL/spec.h>
+#include <RGSL/text.h>
+#include <RGSL/memory.h>
 #include <stdlib.h>
 #include <string.h>
+#include <ctype.h>
+
+static const char* rgsl_find_comment_end(const char* cursor) {
+    // Returns the position after the "*/" closing a block comment on this line, or NULL.
+    for (; *cursor != '\n' && *cursor != '\0'; cursor++) {
+        if (cursor[0] == '*' && cursor[1] == '/') {
+            return cursor + 2;
+        }
+    }
+    return NULL;
+}
+
+static bool rgsl_line_ends_in_comment(const char* cursor, bool in_comment) {
+    // Follows the block comments of a line, knowing whether it starts inside one.
+    while (*cursor != '\n' && *cursor != '\0') {
+        if (in_comment) {
+            cursor = rgsl_find_comment_end(cursor);
+            if (cursor == NULL) {
+                return true;
+            }
+            in_comment = false;
+        } else if (cursor[0] == '/' && cursor[1] == '/') {
+            return false;
+        } else if (cursor[0] == '/' && cursor[1] == '*') {
+            cursor += 2;
+            in_comment = true;
+        } else {
+            cursor++;
+        }
+    }
+    return in_comment;
+}
 
 bool rgsl_read_preprocessor_directives(/* in */ const char* line,
                                       /* out */ struct rgsl_directive* directive) {
-    const size_t DIRECTIVE_NAME_SIZE = 64;
-    const size_t DIRECTIVE_VALUE_SIZE = 256;                               
     if (directive == NULL) {
         return false;
     }
-    directive->name = (char *)malloc(DIRECTIVE_NAME_SIZE * sizeof(char));
-    directive->value = (char *)malloc(DIRECTIVE_VALUE_SIZE * sizeof(char));
-    if (line[0] == '#') {
-        int i = 1;
-        while (line[i] != ' ' && line[i] != '\0') {
-            directive->name[i - 1] = line[i];
-            i++;
+    directive->name = NULL;
+    directive->value = NULL;
+    const char* cursor = line;
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    if (*cursor != '#') {
+        return false;
+    }
+    cursor++;
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    const char* name_start = cursor;
+    while (isalnum((unsigned char)*cursor) || *cursor == '_') {
+        cursor++;
+    }
+    size_t name_length = (size_t)(cursor - name_start);
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    // Comments are not part of the value: a block comment counts as a space, and
+    // one left open stops the value like a line comment does.
+    directive->value = (char *)rgsl_malloc(strcspn(cursor, "\n") + 1);
+    size_t value_length = 0;
+    while (*cursor != '\n' && *cursor != '\0' && !(cursor[0] == '/' && cursor[1] == '/')) {
+        if (cursor[0] == '/' && cursor[1] == '*') {
+            const char* comment_end = rgsl_find_comment_end(cursor + 2);
+            if (comment_end == NULL) {
+                break;
+            }
+            cursor = comment_end;
+            if (value_length > 0) {
+                directive->value[value_length++] = ' ';
+            }
+            continue;
+        }
+        directive->value[value_length++] = *cursor++;
+    }
+    while (value_length > 0 && isspace((unsigned char)directive->value[value_length - 1])) {
+        value_length--;
+    }
+    directive->value[value_length] = '\0';
+
+    directive->name = (char *)rgsl_malloc(name_length + 1);
+    memcpy(directive->name, name_start, name_length);
+    directive->name[name_length] = '\0';
+    return true;
+}
+
+void rgsl_free_directive(struct rgsl_directive* directive) {
+    if (directive != NULL) {
+        rgsl_free(directive->name);
+        rgsl_free(directive->value);
+    }
+}
+
+static const struct rgsl_directive_mapping* rgsl_find_directive(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], const char* name) {
+    for (size_t i = 0; DIRECTIVE_MAPPINGS[i].directive != NULL; i++) {
+        if (strcmp(name, DIRECTIVE_MAPPINGS[i].directive) == 0) {
+            return &DIRECTIVE_MAPPINGS[i];
+        }
+    }
+    return NULL;
+}
+
+bool rgsl_process_directive(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], const struct rgsl_directive directive, struct rgsl_parser_state* state) {
+    const struct rgsl_directive_mapping* mapping = rgsl_find_directive(DIRECTIVE_MAPPINGS, directive.name);
+    if (mapping == NULL) {
+        return true;
+    }
+    char * replaced_line = NULL;
+    state->reprocess_replacement = true;
+    int result = mapping->handler_func(state, directive.value, &replaced_line);
+    if (result != 0) {
+        rgsl_printf_error("Error processing directive %s with value %s\n", directive.name, directive.value);
+        rgsl_free(replaced_line);
+        return false;
+    }
+    if (replaced_line != NULL && rgsl_line_ends_in_comment(state->current_line, false)) {
+        // The block comment opened after the directive goes on past its line, so does the replacement.
+        size_t length = strlen(replaced_line);
+        replaced_line = (char *)rgsl_realloc(replaced_line, length + 4);
+        memcpy(replaced_line + length, " /*", 4);
+    }
+    if (replaced_line != NULL) {
+        size_t replaced_length = strlen(replaced_line);
+        size_t original_length = state->line_end - state->current_line;
+        size_t line_offset = state->current_line - state->processed_code;
+        size_t line_end_offset = state->line_end - state->processed_code;
+        if (replaced_length <= original_length) {
+            memcpy(state->current_line, replaced_line, replaced_length);
+            // Fill the rest with spaces to maintain line length
+            memset(state->current_line + replaced_length, ' ', original_length - replaced_length);
+        } else {
+            size_t tail_length = state->processed_length - line_end_offset;
+            state->processed_length += replaced_length - original_length;
+            state->processed_code = (char *)rgsl_realloc(state->processed_code, state->processed_length + 1);
+            state->current_line = state->processed_code + line_offset;
+            state->line_end = state->processed_code + line_end_offset;
+            memmove(state->current_line + replaced_length, state->line_end, tail_length + 1);
+            memcpy(state->current_line, replaced_line, replaced_length);
+            state->line_end = state->current_line + replaced_length;
+        }
+        if (state->reprocess_replacement) {
+            // This make like the line never existed so it can be reprocessed.
+            // Pointing before the line would leave the buffer when it is the first one.
+            state->line_end = NULL;
+        }
+        rgsl_free(replaced_line);
+    }
+    return true;
+}
+
+const char* rgsl_parser_current_file(const struct rgsl_parser_state* state) {
+    if (state->include_depth == 0) {
+        return NULL;
+    }
+    return state->include_stack[state->include_depth - 1].path;
+}
+
+bool rgsl_line_map_lookup(const struct rgsl_line_map* map, int line, const char** out_file, int* out_line) {
+    if (line <= 0 || (size_t)line > map->line_count || map->lines[line - 1].line == 0) {
+        return false;
+    }
+    const struct rgsl_line_origin* origin = &map->lines[line - 1];
+    *out_file = map->files[origin->file];
+    *out_line = (int)origin->line;
+    return true;
+}
+
+char* rgsl_line_map_rewrite_log(const struct rgsl_line_map* map, const char* name, const char* log) {
+    struct rgsl_text output;
+    rgsl_text_init(&output);
+    size_t name_length = strlen(name);
+    const char* cursor = log;
+    while (*cursor != '\0') {
+        const char* found = name_length > 0 ? strstr(cursor, name) : NULL;
+        if (found == NULL) {
+            rgsl_text_append(&output, cursor, strlen(cursor));
+            break;
+        }
+        // Only "<name>:<line>:" references are rewritten, the name alone may be part of a message.
+        const char* number = found + name_length;
+        char* end = NULL;
+        long line = (number[0] == ':' && isdigit((unsigned char)number[1])) ? strtol(number + 1, &end, 10) : 0;
+        const char* file;
+        int file_line;
+        if (end != NULL && *end == ':' && rgsl_line_map_lookup(map, (int)line, &file, &file_line)) {
+            rgsl_text_append(&output, cursor, (size_t)(found - cursor));
+            rgsl_text_printf(&output, "%s:%d", file, file_line);
+            cursor = end;
+        } else {
+            rgsl_text_append(&output, cursor, (size_t)(number - cursor));
+            cursor = number;
+        }
+    }
+    if (output.data == NULL) {
+        return rgsl_strdup("");
+    }
+    return output.data;
+}
+
+void rgsl_line_map_append(struct rgsl_line_map* map, const struct rgsl_line_map* source, size_t first, size_t count) {
+    if (map->file_count == 0 && source->file_count > 0) {
+        map->files = (char **)rgsl_malloc(source->file_count * sizeof(char*));
+        for (size_t i = 0; i < source->file_count; i++) {
+            map->files[i] = rgsl_strdup(source->files[i]);
         }
-        directive->name[i - 1] = '\0';
-        while (line[i] == ' ') {
-            i++;
+        map->file_count = source->file_count;
+    }
+    if (first >= source->line_count) {
+        return;
+    }
+    if (count > source->line_count - first) {
+        count = source->line_count - first;
+    }
+    struct rgsl_line_origin none = {0, 0};
+    size_t index = map->line_count;
+    rgsl_line_map_insert(map, index, count, none);
+    memcpy(map->lines + index, source->lines + first, count * sizeof(struct rgsl_line_origin));
+}
+
+void rgsl_line_map_free(struct rgsl_line_map* map) {
+    for (size_t i = 0; i < map->file_count; i++) {
+        rgsl_free(map->files[i]);
+    }
+    rgsl_free(map->files);
+    rgsl_free(map->lines);
+    memset(map, 0, sizeof(struct rgsl_line_map));
+}
+
+static uint32_t rgsl_line_map_add_file(struct rgsl_line_map* map, const char* path) {
+    for (size_t i = 0; i < map->file_count; i++) {
+        if (strcmp(map->files[i], path) == 0) {
+            return (uint32_t)i;
         }
-        int j = 0;
-        while (line[i] != '\n' && line[i] != '\0') {
-            directive->value[j++] = line[i++];
+    }
+    map->files = (char **)rgsl_realloc(map->files, (map->file_count + 1) * sizeof(char*));
+    map->files[map->file_count] = rgsl_strdup(path);
+    return (uint32_t)map->file_count++;
+}
+
+void rgsl_line_map_insert(struct rgsl_line_map* map, size_t index, size_t count, struct rgsl_line_origin origin) {
+    if (map->line_count + count > map->line_capacity) {
+        while (map->line_count + count > map->line_capacity) {
+            map->line_capacity = map->line_capacity ? map->line_capacity * 2 : 256;
         }
-        directive->value[j] = '\0';
+        map->lines = (struct rgsl_line_origin *)rgsl_realloc(map->lines, map->line_capacity * sizeof(struct rgsl_line_origin));
+    }
+    if (index > map->line_count) {
+        index = map->line_count;
+    }
+    memmove(map->lines + index + count, map->lines + index, (map->line_count - index) * sizeof(struct rgsl_line_origin));
+    for (size_t i = 0; i < count; i++) {
+        map->lines[index + i] = origin;
+    }
+    map->line_count += count;
+}
+
+static void rgsl_parser_map_line(struct rgsl_parser_state* state) {
+    struct rgsl_line_origin origin = {0, 0};
+    if (state->include_depth > 0) {
+        struct rgsl_include_frame* frame = &state->include_stack[state->include_depth - 1];
+        origin.file = frame->file;
+        origin.line = frame->line++;
+    }
+    rgsl_line_map_insert(state->line_map, state->line_map->line_count, 1, origin);
+}
+
+void rgsl_parser_push_file(struct rgsl_parser_state* state, const char* path) {
+    if (state->include_depth == state->include_capacity) {
+        state->include_capacity = state->include_capacity ? state->include_capacity * 2 : 8;
+        state->include_stack = (struct rgsl_include_frame *)rgsl_realloc(state->include_stack, state->include_capacity * sizeof(struct rgsl_include_frame));
+    }
+    struct rgsl_include_frame* frame = &state->include_stack[state->include_depth++];
+    frame->path = rgsl_strdup(path);
+    frame->tail_length = state->processed_length - (size_t)(state->line_end - state->processed_code);
+    frame->file = rgsl_line_map_add_file(state->line_map, path);
+    frame->line = 1;
+}
+
+static void rgsl_parser_pop_finished_files(struct rgsl_parser_state* state) {
+    size_t remaining = state->processed_length - (size_t)(state->current_line - state->processed_code);
+    while (state->include_depth > 1 && remaining <= state->include_stack[state->include_depth - 1].tail_length) {
+        struct rgsl_include_frame* frame = &state->include_stack[--state->include_depth];
+        // Unless the spliced content ended with a newline, its last line also ended the directive line.
+        if (remaining < frame->tail_length) {
+            state->include_stack[state->include_depth - 1].line++;
+        }
+        rgsl_free(frame->path);
+    }
+}
+
+bool rgsl_parser_is_active(const struct rgsl_parser_state* state) {
+    if (state->condition_depth == 0) {
+        return true;
+    }
+    const struct rgsl_condition_frame* frame = &state->conditions[state->condition_depth - 1];
+    return frame->parent_active && frame->branch_active;
+}
+
+bool rgsl_parser_is_uncertain(const struct rgsl_parser_state* state) {
+    for (size_t i = 0; i < state->condition_depth; i++) {
+        if (state->conditions[i].passthrough) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static char* rgsl_empty_line() {
+    char* line = (char *)rgsl_malloc(1);
+    line[0] = '\0';
+    return line;
+}
+
+static void rgsl_push_condition(struct rgsl_parser_state* state, enum rgsl_condition_result result, void* out) {
+    if (state->condition_depth == state->condition_capacity) {
+        state->condition_capacity = state->condition_capacity ? state->condition_capacity * 2 : 8;
+        state->conditions = (struct rgsl_condition_frame *)rgsl_realloc(state->conditions, state->condition_capacity * sizeof(struct rgsl_condition_frame));
+    }
+    struct rgsl_condition_frame frame;
+    frame.parent_active = rgsl_parser_is_active(state);
+    frame.seen_else = false;
+    frame.passthrough = false;
+    if (!frame.parent_active) {
+        // Nothing in a skipped region can become active.
+        frame.branch_active = false;
+        frame.branch_taken = true;
+    } else if (result == RGSL_CONDITION_UNKNOWN) {
+        // Leave the whole conditional to glslang, keeping its directives.
+        frame.branch_active = true;
+        frame.branch_taken = false;
+        frame.passthrough = true;
     } else {
+        frame.branch_active = (result == RGSL_CONDITION_TRUE);
+        frame.branch_taken = frame.branch_active;
+    }
+    state->conditions[state->condition_depth++] = frame;
+    if (!frame.passthrough) {
+        *(char **)out = rgsl_empty_line();
+    }
+}
+
+static bool rgsl_check_spec_constant_use(const char* directive, const char* value, bool first_only) {
+    // Promoted macros are not defined, a condition on them would silently take the wrong branch.
+    const char* c = value;
+    while (c != NULL && *c != '\0') {
+        if (isalpha((unsigned char)*c) || *c == '_') {
+            const char* start = c;
+            while (isalnum((unsigned char)*c) || *c == '_') {
+                c++;
+            }
+            if (rgsl_find_spec_constant(start, (size_t)(c - start)) >= 0) {
+                rgsl_printf_error("Specialization constant %.*s cannot be used in a #%s directive\n", (int)(c - start), start, directive);
+                return false;
+            }
+            if (first_only) {
+                return true;
+            }
+        } else if (isdigit((unsigned char)*c)) {
+            while (isalnum((unsigned char)*c) || *c == '_' || *c == '.') {
+                c++;
+            }
+        } else {
+            c++;
+        }
+    }
+    return true;
+}
+
+int rgsl_handle_if_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    enum rgsl_condition_result result = RGSL_CONDITION_FALSE;
+    if (rgsl_parser_is_active(state)) {
+        if (!rgsl_check_spec_constant_use("if", value, false)) {
+            return -1;
+        }
+        result = rgsl_macro_evaluate(&state->macros, value);
+    }
+    rgsl_push_condition(state, result, out);
+    return 0;
+}
+
+int rgsl_handle_ifdef_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    enum rgsl_condition_result result = RGSL_CONDITION_FALSE;
+    if (rgsl_parser_is_active(state)) {
+        if (!rgsl_check_spec_constant_use("ifdef", value, true)) {
+            return -1;
+        }
+        result = rgsl_macro_evaluate_defined(&state->macros, value);
+    }
+    rgsl_push_condition(state, result, out);
+    return 0;
+}
+
+int rgsl_handle_ifndef_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    enum rgsl_condition_result result = RGSL_CONDITION_FALSE;
+    if (rgsl_parser_is_active(state)) {
+        if (!rgsl_check_spec_constant_use("ifndef", value, true)) {
+            return -1;
+        }
+        result = rgsl_macro_evaluate_defined(&state->macros, value);
+        if (result != RGSL_CONDITION_UNKNOWN) {
+            result = (result == RGSL_CONDITION_TRUE) ? RGSL_CONDITION_FALSE : RGSL_CONDITION_TRUE;
+        }
+    }
+    rgsl_push_condition(state, result, out);
+    return 0;
+}
+
+int rgsl_handle_elif_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    if (state->condition_depth == 0) {
+        rgsl_print_error("#elif without matching #if\n");
+        return -1;
+    }
+    struct rgsl_condition_frame* frame = &state->conditions[state->condition_depth - 1];
+    if (frame->seen_else) {
+        rgsl_print_error("#elif after #else\n");
+        return -1;
+    }
+    char **replaced_line = (char **)out;
+    if (!frame->parent_active || frame->branch_taken) {
+        frame->branch_active = false;
+        *replaced_line = rgsl_empty_line();
+        return 0;
+    }
+    if (!rgsl_check_spec_constant_use("elif", value, false)) {
+        return -1;
+    }
+    enum rgsl_condition_result result = rgsl_macro_evaluate(&state->macros, value);
+    state->reprocess_replacement = false;
+    if (frame->passthrough) {
+        if (result == RGSL_CONDITION_TRUE) {
+            // Branches after a certainly true one are dead for glslang too.
+            *replaced_line = rgsl_strdup("#else");
+            frame->branch_taken = true;
+            frame->branch_active = true;
+        } else if (result == RGSL_CONDITION_FALSE) {
+            *replaced_line = rgsl_empty_line();
+            frame->branch_active = false;
+        } else {
+            frame->branch_active = true;
+        }
+        return 0;
+    }
+    if (result == RGSL_CONDITION_UNKNOWN) {
+        // Every previous branch was false and removed, so this one opens the conditional for glslang.
+        size_t len = strlen(value) + 5;
+        *replaced_line = (char *)rgsl_malloc(len);
+        snprintf(*replaced_line, len, "#if %s", value);
+        frame->passthrough = true;
+        frame->branch_active = true;
+        return 0;
+    }
+    frame->branch_active = (result == RGSL_CONDITION_TRUE);
+    frame->branch_taken = frame->branch_active;
+    *replaced_line = rgsl_empty_line();
+    return 0;
+}
+
+int rgsl_handle_else_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)value;
+    if (state->condition_depth == 0) {
+        rgsl_print_error("#else without matching #if\n");
+        return -1;
+    }
+    struct rgsl_condition_frame* frame = &state->conditions[state->condition_depth - 1];
+    if (frame->seen_else) {
+        rgsl_print_error("#else after #else\n");
+        return -1;
+    }
+    frame->seen_else = true;
+    if (frame->passthrough && !frame->branch_taken && frame->parent_active) {
+        frame->branch_active = true;
+        return 0; // Kept for glslang
+    }
+    frame->branch_active = frame->parent_active && !frame->branch_taken;
+    frame->branch_taken = true;
+    *(char **)out = rgsl_empty_line();
+    return 0;
+}
+
+int rgsl_handle_endif_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)value;
+    if (state->condition_depth == 0) {
+        rgsl_print_error("#endif without matching #if\n");
+        return -1;
+    }
+    struct rgsl_condition_frame* frame = &state->conditions[--state->condition_depth];
+    if (!(frame->passthrough && frame->parent_active)) {
+        *(char **)out = rgsl_empty_line();
+    }
+    return 0;
+}
+
+int rgsl_handle_define_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)out;
+    if (!rgsl_check_spec_constant_use("define", value, true)) {
+        return -1;
+    }
+    if (!rgsl_macro_define(&state->macros, value, rgsl_parser_is_uncertain(state))) {
+        rgsl_printf_error("Malformed #define directive: %s\n", value);
+        return -1;
+    }
+    return 0; // The definition is kept, glslang expands the macros in the code
+}
+
+int rgsl_handle_undef_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)out;
+    rgsl_macro_undefine(&state->macros, value, rgsl_parser_is_uncertain(state));
+    return 0;
+}
+
+bool rgsl_read_stage_pragma(const char* value, const char** out_stage) {
+    *out_stage = NULL;
+    if (strncmp(value, "rgsl", 4) != 0 || !isspace((unsigned char)value[4])) {
+        return false;
+    }
+    const char* cursor = value + 4;
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    if (strncmp(cursor, "stage", 5) != 0) {
+        return false;
+    }
+    cursor += 5;
+    while (*cursor == ' ' || *cursor == '\t') {
+        cursor++;
+    }
+    if (*cursor != '(') {
         return false;
     }
+    const char* name = ++cursor;
+    while (*cursor != ')' && *cursor != '\0') {
+        cursor++;
+    }
+    if (*cursor == ')' && cursor[1] == '\0') {
+        *out_stage = rgsl_find_shader_stage(name, (size_t)(cursor - name));
+    }
     return true;
 }
 
-void rgsl_free_directive(struct rgsl_directive* directive) {
-    if (directive != NULL) {
-        free(directive->name);
-        free(directive->value);
+int rgsl_handle_pragma_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)out;
+    const char* stage;
+    if (!rgsl_read_stage_pragma(value, &stage)) {
+        return 0; // Other pragmas are left to glslang
+    }
+    if (stage == NULL) {
+        rgsl_printf_error("Unknown stage in #pragma %s (expected vert, frag, geom, tesc, tese or comp)\n", value);
+        return -1;
+    }
+    if (state->include_depth > 1 || state->condition_depth > 0) {
+        rgsl_printf_error("#pragma %s must be in the shader file, outside of any conditional\n", value);
+        return -1;
     }
+    // The pragma stays in the code to mark the section; each section starts from the prologue macros.
+    if (state->stage_count++ == 0) {
+        rgsl_macro_table_copy(&state->stage_macros, &state->macros);
+    } else {
+        rgsl_macro_table_free(&state->macros);
+        rgsl_macro_table_copy(&state->macros, &state->stage_macros);
+    }
+    return 0;
 }
 
-bool rgsl_process_directive(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], const struct rgsl_directive directive, struct rgsl_parser_state* state) {
-    for (size_t i = 0; DIRECTIVE_MAPPINGS[i].directive != NULL; i++) {
-        if (strcmp(directive.name, DIRECTIVE_MAPPINGS[i].directive) == 0) {
-            char * replaced_line = NULL;
-            int result = DIRECTIVE_MAPPINGS[i].handler_func(state, directive.value, &replaced_line);
-            if (result != 0) {
-                rgsl_printf_error("Error processing directive %s with value %s\n", directive.name, directive.value);
+void rgsl_parser_add_preamble(struct rgsl_parser_state* state, const char* line) {
+    size_t line_length = strlen(line);
+    for (const char* existing = state->preamble; existing != NULL && *existing != '\0'; existing = strchr(existing, '\n') + 1) {
+        if (strncmp(existing, line, line_length) == 0 && existing[line_length] == '\n') {
+            return;
+        }
+    }
+    state->preamble = (char *)rgsl_realloc(state->preamble, state->preamble_length + line_length + 2);
+    memcpy(state->preamble + state->preamble_length, line, line_length);
+    state->preamble_length += line_length;
+    state->preamble[state->preamble_length++] = '\n';
+    state->preamble[state->preamble_length] = '\0';
+}
+
+static bool rgsl_parser_specialize(struct rgsl_parser_state* state, int constant_id, const char* define) {
+    // The value of a promoted macro is kept for the packager, the code only sees the constant.
+    const char* equal = strchr(define, '=');
+    uint32_t value;
+    if (!rgsl_spec_constant_value((size_t)constant_id, equal ? equal + 1 : "1", &value)) {
+        rgsl_printf_error("Invalid value for specialization constant: %s\n", define);
+        return false;
+    }
+    struct rgsl_shader_data* shader = state->shader;
+    size_t index = 0;
+    while (index < shader->specialization_count && shader->specializations[index].constant_id != (uint32_t)constant_id) {
+        index++;
+    }
+    if (index == shader->specialization_count) {
+        shader->specializations = (struct rgsl_specialization *)rgsl_realloc(shader->specializations, (index + 1) * sizeof(struct rgsl_specialization));
+        shader->specialization_count++;
+    }
+    shader->specializations[index].constant_id = (uint32_t)constant_id;
+    shader->specializations[index].value = value;
+    return true;
+}
+
+static bool rgsl_parser_define_options(struct rgsl_parser_state* state, const char** defines) {
+    for (size_t i = 0; defines != NULL && defines[i] != NULL; i++) {
+        const char* equal = strchr(defines[i], '=');
+        int constant_id = rgsl_find_spec_constant(defines[i], equal ? (size_t)(equal - defines[i]) : strlen(defines[i]));
+        if (constant_id >= 0) {
+            if (!rgsl_parser_specialize(state, constant_id, defines[i])) {
                 return false;
             }
-            if (replaced_line != NULL) {
-                size_t replaced_length = strlen(replaced_line);
-                size_t original_length = state->line_end - state->current_line;
-                size_t line_offset = state->current_line - state->processed_code;
-                size_t line_end_offset = state->line_end - state->processed_code;
-                if (replaced_length <= original_length) {
-                    memcpy(state->current_line, replaced_line, replaced_length);
-                    // Fill the rest with spaces to maintain line length
-                    memset(state->current_line + replaced_length, ' ', original_length - replaced_length);
-                } else {
-                    size_t tail_length = strlen(state->line_end);
-                    state->processed_code = (char *)realloc(state->processed_code, strlen(state->processed_code) + (replaced_length - original_length) + 1);
-                    state->current_line = state->processed_code + line_offset;
-                    state->line_end = state->processed_code + line_end_offset;
-                    memmove(state->current_line + replaced_length, state->line_end, tail_length + 1);
-                    memcpy(state->current_line, replaced_line, replaced_length);
+            continue;
+        }
+        if (!rgsl_macro_define_option(&state->macros, defines[i])) {
+            rgsl_printf_error("Malformed macro definition: %s\n", defines[i]);
+            return false;
+        }
+        // "NAME=VALUE" becomes "#define NAME VALUE", "NAME" becomes "#define NAME 1".
+        size_t name_length = equal ? (size_t)(equal - defines[i]) : strlen(defines[i]);
+        const char* value = equal ? equal + 1 : "1";
+        size_t line_length = name_length + strlen(value) + 10;
+        char* line = (char *)rgsl_malloc(line_length);
+        snprintf(line, line_length, "#define %.*s %s", (int)name_length, defines[i], value);
+        rgsl_parser_add_preamble(state, line);
+        rgsl_free(line);
+    }
+    return true;
+}
+
+static void rgsl_parser_insert(struct rgsl_parser_state* state, size_t offset, const char* text, size_t length) {
+    // The inserted lines have no source; they follow the line split at the offset, if any.
+    size_t line_index = 0;
+    for (size_t i = 0; i < offset; i++) {
+        line_index += (state->processed_code[i] == '\n');
+    }
+    if (offset > 0 && state->processed_code[offset - 1] != '\n') {
+        line_index++;
+    }
+    size_t line_count = 0;
+    for (size_t i = 0; i < length; i++) {
+        line_count += (text[i] == '\n');
+    }
+    struct rgsl_line_origin generated = {0, 0};
+    rgsl_line_map_insert(state->line_map, line_index, line_count, generated);
+
+    state->processed_code = (char *)rgsl_realloc(state->processed_code, state->processed_length + length + 1);
+    memmove(state->processed_code + offset + length, state->processed_code + offset, state->processed_length - offset + 1);
+    memcpy(state->processed_code + offset, text, length);
+    state->processed_length += length;
+}
+
+static size_t rgsl_parser_code_start(const struct rgsl_parser_state* state) {
+    // Declarations must follow the #version and #extension directives, outside of any conditional.
+    const char* code = state->processed_code;
+    const char* line = code;
+    const char* outer_conditional = NULL;
+    size_t depth = 0;
+    bool in_comment = false;
+    while (*line != '\0') {
+        const char* c = line;
+        const char* end = strchr(line, '\n');
+        if (end == NULL) {
+            end = line + strlen(line);
+        }
+        while (c < end) {
+            if (in_comment) {
+                const char* close = strstr(c, "*/");
+                in_comment = (close == NULL || close >= end);
+                c = in_comment ? end : close + 2;
+            } else if (isspace((unsigned char)*c)) {
+                c++;
+            } else if (c[0] == '/' && c[1] == '*') {
+                in_comment = true;
+                c += 2;
+            } else if (c[0] == '/' && c[1] == '/') {
+                c = end;
+            } else if (c[0] == '#') {
+                c++;
+                while (*c == ' ' || *c == '\t') {
+                    c++;
+                }
+                struct rgsl_directive directive;
+                const char* stage;
+                bool stage_pragma = rgsl_read_preprocessor_directives(line, &directive) && strcmp(directive.name, "pragma") == 0 && rgsl_read_stage_pragma(directive.value, &stage);
+                rgsl_free_directive(&directive);
+                if (stage_pragma) {
+                    // The prologue is shared by the stage sections, so are the declarations.
+                    return (size_t)(line - code);
                 }
-                // This make like the line never existed so it can be reprocessed.
-                state->line_end = state->current_line - 1;
-                free(replaced_line);
+                if (strncmp(c, "if", 2) == 0) {
+                    if (depth++ == 0) {
+                        outer_conditional = line;
+                    }
+                } else if (strncmp(c, "endif", 5) == 0 && depth > 0) {
+                    depth--;
+                }
+                c = end;
+            } else {
+                return (size_t)(((depth > 0) ? outer_conditional : line) - code);
             }
-            return true;
         }
+        line = (*end == '\0') ? end : end + 1;
     }
-    return true;
+    return (size_t)(line - code);
 }
 
-char * rgsl_parse_shader(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], struct rgsl_shader_data* shader) {
+static void rgsl_parser_strip_trailing_spaces(struct rgsl_parser_state* state) {
+    // Removed lines are blanked with spaces while parsing, drop them once at the end.
+    char* read = state->processed_code;
+    char* write = state->processed_code;
+    char* line_start = write;
+    for (; *read != '\0'; read++) {
+        if (*read == '\n') {
+            while (write > line_start && (write[-1] == ' ' || write[-1] == '\t')) {
+                write--;
+            }
+            *write++ = '\n';
+            line_start = write;
+        } else {
+            *write++ = *read;
+        }
+    }
+    while (write > line_start && (write[-1] == ' ' || write[-1] == '\t')) {
+        write--;
+    }
+    *write = '\0';
+    state->processed_length = (size_t)(write - state->processed_code);
+}
+
+char * rgsl_parse_shader(const struct rgsl_directive_mapping DIRECTIVE_MAPPINGS[], struct rgsl_shader_data* shader, bool native_includes) {
+    enum rgsl_memory_phase phase = rgsl_memory_enter_phase(RGSL_PHASE_PREPROCESS);
     struct rgsl_parser_state state;
     state.shader = shader;
-    state.processed_code = _strdup(shader->code);
+    state.processed_code = rgsl_strdup(shader->code);
+    state.processed_length = strlen(state.processed_code);
     state.current_line = state.processed_code;
+    state.include_stack = NULL;
+    state.include_depth = 0;
+    state.include_capacity = 0;
+    state.conditions = NULL;
+    state.condition_depth = 0;
+    state.condition_capacity = 0;
+    state.preamble = NULL;
+    state.preamble_length = 0;
     state.version_directive_found = false;
-    while (*state.current_line != '\0') {
+    state.version_line_end = 0;
+    state.reprocess_replacement = true;
+    state.native_includes = native_includes;
+    state.line_map = &shader->line_map;
+    state.stage_count = 0;
+    state.in_comment = false;
+    bool failed = false;
+    rgsl_line_map_free(&shader->line_map);
+    rgsl_free(shader->specializations);
+    shader->specializations = NULL;
+    shader->specialization_count = 0;
+    rgsl_macro_table_init(&state.macros);
+    failed |= !rgsl_parser_define_options(&state, rgsl_global_options.defines);
+    failed |= !rgsl_parser_define_options(&state, shader->defines);
+
+    if (shader->path != NULL) {
+        state.line_end = state.processed_code + state.processed_length;
+        rgsl_parser_push_file(&state, shader->path);
+    }
+    while (!failed && *state.current_line != '\0') {
+        rgsl_parser_pop_finished_files(&state);
+        size_t line_offset = (size_t)(state.current_line - state.processed_code);
         state.line_end = strchr(state.current_line, '\n');
         if (state.line_end == NULL) {
             state.line_end = state.current_line + strlen(state.current_line);
         }
-        // Here you can add preprocessing logic, e.g., handling #include directives
-        struct rgsl_directive directive;
-        bool found_directive = rgsl_read_preprocessor_directives(state.current_line, &directive);
-        if (found_directive) {
-            rgsl_process_directive(DIRECTIVE_MAPPINGS, directive, &state);
+        // A line starting inside a block comment holds no directive, even a commented-out #if.
+        bool comment_after = rgsl_line_ends_in_comment(state.current_line, state.in_comment);
+        struct rgsl_directive directive = {0};
+        bool found_directive = !state.in_comment && rgsl_read_preprocessor_directives(state.current_line, &directive);
+        bool active = rgsl_parser_is_active(&state);
+        const struct rgsl_directive_mapping* mapping = found_directive ? rgsl_find_directive(DIRECTIVE_MAPPINGS, directive.name) : NULL;
+        if (found_directive && (active || (mapping != NULL && mapping->conditional))) {
+            failed |= !rgsl_process_directive(DIRECTIVE_MAPPINGS, directive, &state);
+        } else if (!active) {
+            // Skipped regions never reach glslang, nor do their includes.
+            memset(state.current_line, ' ', (size_t)(state.line_end - state.current_line));
         }
         rgsl_free_directive(&directive);
-        
-        state.current_line = (*state.line_end == '\0') ? state.line_end : state.line_end + 1;
+
+        if (state.line_end != NULL) {
+            state.current_line = (*state.line_end == '\0') ? state.line_end : state.line_end + 1;
+            state.in_comment = comment_after; // A replaced line is parsed again from the same state
+        }
+        if ((size_t)(state.current_line - state.processed_code) > line_offset) {
+            // A replaced line is parsed again, its origin is only known once it is kept.
+            rgsl_parser_map_line(&state);
+        }
+    }
+    if (!failed && state.condition_depth > 0) {
+        rgsl_print_error("Unterminated conditional directive\n");
+        failed = true;
+    }
+    if (!failed && state.preamble_length > 0) {
+        if (state.version_line_end > 0 && state.processed_code[state.version_line_end - 1] != '\n') {
+            rgsl_parser_insert(&state, state.version_line_end++, "\n", 1);
+        }
+        rgsl_parser_insert(&state, state.version_line_end, state.preamble, state.preamble_length);
+    }
+    if (!failed) {
+        rgsl_parser_strip_trailing_spaces(&state);
+    }
+    if (!failed && rgsl_spec_constant_count() > 0) {
+        struct rgsl_text declarations;
+        rgsl_text_init(&declarations);
+        size_t offset = rgsl_parser_code_start(&state);
+        if (offset > 0 && state.processed_code[offset - 1] != '\n') {
+            rgsl_parser_insert(&state, offset++, "\n", 1);
+        }
+        rgsl_write_spec_constant_declarations(&declarations);
+        rgsl_parser_insert(&state, offset, declarations.data, declarations.length);
+        rgsl_text_free(&declarations);
+    }
+
+    while (state.include_depth > 0) {
+        rgsl_free(state.include_stack[--state.include_depth].path);
+    }
+    rgsl_free(state.include_stack);
+    rgsl_free(state.conditions);
+    rgsl_free(state.preamble);
+    rgsl_macro_table_free(&state.macros);
+    if (state.stage_count > 0) {
+        rgsl_macro_table_free(&state.stage_macros);
+    }
+    if (failed) {
+        rgsl_free(state.processed_code);
+        rgsl_line_map_free(&shader->line_map);
+        rgsl_memory_leave_phase(phase);
+        return NULL;
     }
+    rgsl_memory_leave_phase(phase);
     return state.processed_code;
 }
\ No newline at end of file
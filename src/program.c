@@ -0,0 +1,208 @@
+#include <RGSL/program.h>
+#include <RGSL/parser.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/target.h>
+#include <RGSL/lint.h>
+#include <RGSL/termio.h>
+#include <RGSL/thread.h>
+#include <RGSL/clock.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Most programs hold a vertex and a fragment stage, a pipeline at most five.
+#define RGSL_MAX_PROGRAM_STAGES 8
+
+/**
+ * A section of a preprocessed program file: its stage, the line of its pragma,
+ * and its lines in the processed code, following that one.
+ */
+struct rgsl_stage_section {
+    const char* stage;
+    const char* pragma;
+    const char* start;
+    const char* end;
+    size_t first_line;
+    size_t line_count;
+};
+
+/**
+ * One stage of a program built on its own thread.
+ */
+struct rgsl_stage_build {
+    struct rgsl_shader_data* shader;
+    rgsl_thread thread;
+    bool threaded;
+};
+
+// Reads the stage of a line, if it is a stage pragma.
+static bool rgsl_read_stage_line(const char* line, const char** out_stage) {
+    struct rgsl_directive directive;
+    bool found = rgsl_read_preprocessor_directives(line, &directive) && strcmp(directive.name, "pragma") == 0 && rgsl_read_stage_pragma(directive.value, out_stage);
+    rgsl_free_directive(&directive);
+    return found;
+}
+
+static const char* rgsl_next_line(const char* line) {
+    const char* end = strchr(line, '\n');
+    return end != NULL ? end + 1 : line + strlen(line);
+}
+
+bool rgsl_is_program_code(const char* code) {
+    if (strstr(code, "rgsl") == NULL) {
+        return false;
+    }
+    for (const char* line = code; *line != '\0'; line = rgsl_next_line(line)) {
+        const char* stage;
+        if (rgsl_read_stage_line(line, &stage)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static size_t rgsl_find_stage_sections(const struct rgsl_shader_data* program, struct rgsl_stage_section* sections) {
+    size_t count = 0;
+    size_t index = 0;
+    for (const char* line = program->processed_code; *line != '\0'; line = rgsl_next_line(line), index++) {
+        const char* stage;
+        if (!rgsl_read_stage_line(line, &stage)) {
+            continue;
+        }
+        if (count > 0) {
+            sections[count - 1].end = line;
+            sections[count - 1].line_count = index - sections[count - 1].first_line;
+        }
+        if (count == RGSL_MAX_PROGRAM_STAGES) {
+            rgsl_printf_error("%s holds more than %d stages\n", program->path, RGSL_MAX_PROGRAM_STAGES);
+            return 0;
+        }
+        for (size_t i = 0; i < count; i++) {
+            if (sections[i].stage == stage) {
+                rgsl_printf_error("%s holds several %s stages\n", program->path, stage);
+                return 0;
+            }
+        }
+        sections[count].stage = stage;
+        sections[count].pragma = line;
+        sections[count].start = rgsl_next_line(line);
+        sections[count].first_line = index + 1;
+        count++;
+    }
+    if (count == 0) {
+        rgsl_printf_error("%s has no stage left once preprocessed\n", program->path);
+        return 0;
+    }
+    sections[count - 1].end = sections[count - 1].start + strlen(sections[count - 1].start);
+    sections[count - 1].line_count = index - sections[count - 1].first_line;
+    return count;
+}
+
+static void rgsl_init_stage(struct rgsl_shader_data* shader, const struct rgsl_shader_data* program, const struct rgsl_stage_section* section, size_t prologue_length, size_t prologue_lines) {
+    shader->name = rgsl_strdup(program->name);
+    shader->path = program->path;
+    shader->language = program->language;
+    shader->stage = section->stage;
+    shader->profile = program->profile;
+    shader->requested_profile = program->requested_profile;
+    shader->defines = program->defines;
+
+    size_t section_length = (size_t)(section->end - section->start);
+    shader->processed_code = (char *)rgsl_malloc(prologue_length + section_length + 1);
+    memcpy(shader->processed_code, program->processed_code, prologue_length);
+    memcpy(shader->processed_code + prologue_length, section->start, section_length);
+    shader->processed_code[prologue_length + section_length] = '\0';
+    shader->code = rgsl_strdup(shader->processed_code);
+    shader->native_includes = false;
+    rgsl_line_map_append(&shader->line_map, &program->line_map, 0, prologue_lines);
+    rgsl_line_map_append(&shader->line_map, &program->line_map, section->first_line, section->line_count);
+
+    if (program->specialization_count > 0) {
+        size_t size = program->specialization_count * sizeof(struct rgsl_specialization);
+        shader->specializations = (struct rgsl_specialization *)rgsl_malloc(size);
+        memcpy(shader->specializations, program->specializations, size);
+        shader->specialization_count = program->specialization_count;
+    }
+    if (strcmp(shader->language, "glsl") == 0) {
+        rgsl_glsl_rewrite_interface(shader);
+    }
+}
+
+bool rgsl_split_program(struct rgsl_shader_data* program, struct rgsl_shader_data** out_stages, size_t* out_count) {
+    *out_stages = NULL;
+    *out_count = 0;
+    rgsl_print_info(1, "Preprocessing the stages of the program...\n");
+    double start = rgsl_clock_seconds();
+    // The sections are cut out of the spliced code, includes are never left to glslang.
+    bool rgsl = strcmp(program->language, "rgsl") == 0;
+    program->processed_code = rgsl_parse_shader(rgsl ? RGSL_DIRECTIVE_MAPPINGS : GLSL_DIRECTIVE_MAPPINGS, program, false);
+    program->native_includes = false;
+    if (program->processed_code == NULL) {
+        rgsl_printf_error("Failed to preprocess program %s\n", program->path);
+        return false;
+    }
+
+    struct rgsl_stage_section sections[RGSL_MAX_PROGRAM_STAGES];
+    size_t count = rgsl_find_stage_sections(program, sections);
+    if (count > 0) {
+        // The prologue ends before the pragma of the first section.
+        size_t prologue_length = (size_t)(sections[0].pragma - program->processed_code);
+        size_t prologue_lines = sections[0].first_line - 1;
+        struct rgsl_shader_data* stages = (struct rgsl_shader_data *)rgsl_calloc(count, sizeof(struct rgsl_shader_data));
+        for (size_t i = 0; i < count; i++) {
+            rgsl_init_stage(&stages[i], program, &sections[i], prologue_length, prologue_lines);
+        }
+        *out_stages = stages;
+        *out_count = count;
+        rgsl_printf_info(2, "Preprocessed %zu stages in %.3f ms\n", count, rgsl_clock_elapsed_ms(start));
+    }
+    rgsl_release_shader_intermediates(program);
+    return count > 0;
+}
+
+static bool rgsl_stage_needs_program(const struct rgsl_shader_data* shader) {
+    if (strcmp(shader->language, "rgsl") == 0) {
+        return true; // Every backend emits from the module
+    }
+    // The targets are compiled by their own threads, plain GLSL output needs no program.
+    return !rgsl_targets_enabled() && (rgsl_perf_lint_enabled() || (rgsl_global_options.action & (RGSL_ACTION_VALIDATE | RGSL_ACTION_COMPILE_SPIRV | RGSL_ACTION_COMPILE_EMBED)));
+}
+
+static void rgsl_build_stage(void* user) {
+    struct rgsl_stage_build* build = (struct rgsl_stage_build*)user;
+    struct rgsl_shader_data* shader = build->shader;
+    if (strcmp(shader->language, "rgsl") == 0) {
+        rgsl_rgsl_build_module(shader);
+        return;
+    }
+    // Errors are reported by the action building the program again, in stage order.
+    char* log = NULL;
+    rgsl_glsl_build_program(shader, &log);
+    rgsl_free(log);
+}
+
+void rgsl_build_program_stages(struct rgsl_shader_data* stages, size_t count) {
+    struct rgsl_stage_build builds[RGSL_MAX_PROGRAM_STAGES];
+    double start = rgsl_clock_seconds();
+    size_t built = 0;
+    for (size_t i = 0; i < count; i++) {
+        builds[i].shader = &stages[i];
+        builds[i].threaded = false;
+        if (rgsl_stage_needs_program(&stages[i])) {
+            builds[i].threaded = rgsl_thread_create(&builds[i].thread, rgsl_build_stage, &builds[i]);
+            if (!builds[i].threaded) {
+                rgsl_build_stage(&builds[i]);
+            }
+            built++;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (builds[i].threaded) {
+            rgsl_thread_join(builds[i].thread);
+        }
+    }
+    if (built > 0) {
+        rgsl_printf_info(2, "Built %zu stages in parallel in %.3f ms\n", built, rgsl_clock_elapsed_ms(start));
+    }
+}
\ No newline at end of file
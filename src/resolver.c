@@ -0,0 +1,223 @@
+#include <RGSL/resolver.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/fileio.h>
+#include <RGSL/termio.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+/**
+ * Files found in one directory, keyed by entry name.
+ * A listing that does not exist is kept too, so missing directories are not reopened.
+ */
+struct rgsl_directory_listing {
+    bool exists;
+    struct rgsl_hashmap files;
+};
+
+/**
+ * Content of an included file, converted to LF line endings.
+ */
+struct rgsl_cached_file {
+    char* content;
+    size_t size;
+};
+
+static struct rgsl_hashmap directory_index;
+static struct rgsl_hashmap lookup_cache;
+static struct rgsl_hashmap content_cache;
+
+// Marks names known not to resolve in the lookup cache.
+static char missing_marker;
+#define RGSL_RESOLVER_MISSING ((void*)&missing_marker)
+
+static void rgsl_normalize_entry_name(char* name) {
+#ifdef _WIN32
+    // Windows file systems are case-insensitive, so should be the index.
+    for (char* c = name; *c != '\0'; c++) {
+        *c = (char)tolower((unsigned char)*c);
+    }
+#else
+    (void)name;
+#endif
+}
+
+static void rgsl_release_listing(void* value) {
+    struct rgsl_directory_listing* listing = (struct rgsl_directory_listing*)value;
+    rgsl_hashmap_free(&listing->files, NULL);
+    rgsl_free(listing);
+}
+
+static void rgsl_release_lookup(void* value) {
+    if (value != RGSL_RESOLVER_MISSING) {
+        rgsl_free(value);
+    }
+}
+
+static void rgsl_release_cached_file(void* value) {
+    struct rgsl_cached_file* file = (struct rgsl_cached_file*)value;
+    rgsl_free(file->content);
+    rgsl_free(file);
+}
+
+static void rgsl_index_entry(const char* entry, bool is_directory, void* user) {
+    struct rgsl_directory_listing* listing = (struct rgsl_directory_listing*)user;
+    if (is_directory) {
+        return;
+    }
+    char* name = rgsl_strdup(entry);
+    rgsl_normalize_entry_name(name);
+    rgsl_hashmap_set(&listing->files, name, RGSL_RESOLVER_MISSING);
+    rgsl_free(name);
+}
+
+static const char* rgsl_directory_key(const char* directory) {
+    // "./common" and "common" must share one listing, and be invalidated together.
+    while (directory[0] == '.' && (directory[1] == '/' || directory[1] == '\\')) {
+        directory += 2;
+    }
+    return (directory[0] != '\0') ? directory : ".";
+}
+
+static const struct rgsl_directory_listing* rgsl_get_listing(const char* directory) {
+    directory = rgsl_directory_key(directory);
+    struct rgsl_directory_listing* listing = (struct rgsl_directory_listing*)rgsl_hashmap_get(&directory_index, directory);
+    if (listing == NULL) {
+        listing = (struct rgsl_directory_listing*)rgsl_malloc(sizeof(struct rgsl_directory_listing));
+        rgsl_hashmap_init(&listing->files);
+        listing->exists = rgsl_list_directory(directory, rgsl_index_entry, listing);
+        rgsl_hashmap_set(&directory_index, directory, listing);
+        rgsl_printf_info(3, "Indexed include directory %s (%zu files)\n", directory, listing->files.count);
+    }
+    return listing;
+}
+
+static size_t rgsl_directory_length(const char* path) {
+    const char* slash = strrchr(path, '/');
+    const char* backslash = strrchr(path, '\\');
+    if (slash < backslash) {
+        slash = backslash;
+    }
+    return (slash != NULL) ? (size_t)(slash - path) : 0;
+}
+
+static char* rgsl_join_path(const char* directory, size_t directory_length, const char* name) {
+    size_t len = directory_length + strlen(name) + 2;
+    char* path = (char*)rgsl_malloc(len);
+    snprintf(path, len, "%.*s/%s", (int)directory_length, directory, name);
+    return path;
+}
+
+static char* rgsl_probe_directory(const char* directory, size_t directory_length, const char* name) {
+    char* path = rgsl_join_path(directory, directory_length, name);
+    size_t split = rgsl_directory_length(path);
+    char* parent = (char*)rgsl_malloc(split + 1);
+    memcpy(parent, path, split);
+    parent[split] = '\0';
+    char* file = rgsl_strdup(path + split + 1);
+    rgsl_normalize_entry_name(file);
+
+    const struct rgsl_directory_listing* listing = rgsl_get_listing(parent);
+    bool found = listing->exists && rgsl_hashmap_find(&listing->files, file, NULL);
+    rgsl_free(parent);
+    rgsl_free(file);
+    if (!found) {
+        rgsl_free(path);
+        return NULL;
+    }
+    return path;
+}
+
+char* rgsl_resolve_include(const char* name, const char* includer_path) {
+    size_t includer_length = 0;
+    if (includer_path != NULL) {
+        includer_length = rgsl_directory_length(includer_path);
+    }
+
+    // Quoted lookups depend on the including directory, system lookups do not.
+    size_t key_length = strlen(name) + includer_length + 3;
+    char* key = (char*)rgsl_malloc(key_length);
+    if (includer_path != NULL) {
+        snprintf(key, key_length, "\"%.*s\n%s", (int)includer_length, includer_path, name);
+    } else {
+        snprintf(key, key_length, "<%s", name);
+    }
+
+    void* cached;
+    if (rgsl_hashmap_find(&lookup_cache, key, &cached)) {
+        rgsl_free(key);
+        return (cached != RGSL_RESOLVER_MISSING) ? rgsl_strdup((const char*)cached) : NULL;
+    }
+
+    char* resolved = NULL;
+    if (includer_path != NULL) {
+        if (includer_length > 0) {
+            resolved = rgsl_probe_directory(includer_path, includer_length, name);
+        } else {
+            resolved = rgsl_probe_directory(".", 1, name);
+        }
+    }
+    for (size_t i = 0; resolved == NULL && rgsl_global_options.include_paths[i] != NULL; i++) {
+        const char* include_path = rgsl_global_options.include_paths[i];
+        resolved = rgsl_probe_directory(include_path, strlen(include_path), name);
+    }
+
+    rgsl_hashmap_set(&lookup_cache, key, (resolved != NULL) ? rgsl_strdup(resolved) : RGSL_RESOLVER_MISSING);
+    rgsl_free(key);
+    return resolved;
+}
+
+bool rgsl_resolver_read(const char* path, const char** out_content, size_t* out_size) {
+    struct rgsl_cached_file* file = (struct rgsl_cached_file*)rgsl_hashmap_get(&content_cache, path);
+    if (file == NULL) {
+        char* raw_content = NULL;
+        rgsl_read_file(path, &raw_content);
+        if (raw_content == NULL) {
+            return false;
+        }
+        char* content = rgsl_crlf_to_lf(raw_content);
+        rgsl_free_file_buffer(raw_content);
+        if (content == NULL) {
+            return false;
+        }
+        file = (struct rgsl_cached_file*)rgsl_malloc(sizeof(struct rgsl_cached_file));
+        file->content = content;
+        file->size = strlen(content);
+        rgsl_hashmap_set(&content_cache, path, file);
+    }
+    *out_content = file->content;
+    if (out_size != NULL) {
+        *out_size = file->size;
+    }
+    return true;
+}
+
+void rgsl_resolver_invalidate(const char* path) {
+    // Any cached lookup may change once a file appears or disappears.
+    rgsl_hashmap_free(&lookup_cache, rgsl_release_lookup);
+    if (path == NULL) {
+        rgsl_hashmap_free(&directory_index, rgsl_release_listing);
+        rgsl_hashmap_free(&content_cache, rgsl_release_cached_file);
+        return;
+    }
+    void* file;
+    if (rgsl_hashmap_remove(&content_cache, path, &file)) {
+        rgsl_release_cached_file(file);
+    }
+    size_t split = rgsl_directory_length(path);
+    char* parent = (char*)rgsl_malloc(split + 1);
+    memcpy(parent, path, split);
+    parent[split] = '\0';
+    void* listing;
+    if (rgsl_hashmap_remove(&directory_index, rgsl_directory_key(parent), &listing)) {
+        rgsl_release_listing(listing);
+    }
+    rgsl_free(parent);
+}
+
+void rgsl_resolver_finalize() {
+    rgsl_resolver_invalidate(NULL);
+}
\ No newline at end of file
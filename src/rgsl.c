@@ -1,5 +1,12 @@
 #include <RGSL/termio.h>
+#include <RGSL/fileio.h>
 #include <RGSL/rgsl.h>
+#include <RGSL/parser.h>
+#include <RGSL/layout.h>
+#include <RGSL/rgsl/ast.h>
+#include <RGSL/target.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
@@ -78,6 +85,20 @@ static const struct rgsl_stage_mapping STAGE_MAPPINGS[] = {
     /** tessellation evaluation shaders */
     {".tese", "tese"},
     {".te", "tese"},
+
+    /** RGSL shaders */
+    {".rvert", "vert"},
+    {".rvs", "vert"},
+    {".rfrag", "frag"},
+    {".rfs", "frag"},
+    {".rgeom", "geom"},
+    {".rgs", "geom"},
+    {".rcomp", "comp"},
+    {".rcs", "comp"},
+    {".rtesc", "tesc"},
+    {".rtc", "tesc"},
+    {".rtese", "tese"},
+    {".rte", "tese"},
 };
 
 void rgsl_print_version() {
@@ -90,12 +111,45 @@ void rgsl_print_version() {
 void rgsl_initialize() {
     rgsl_global_options.input_files = NULL;
     rgsl_global_options.output_file = NULL;
-    rgsl_global_options.include_paths = malloc(sizeof(char*) * 2);
+    rgsl_global_options.manifest_file = NULL;
+    rgsl_global_options.include_paths = rgsl_malloc(sizeof(char*) * 2);
     rgsl_global_options.include_paths[0] = ".";
     rgsl_global_options.include_paths[1] = NULL;
+    rgsl_global_options.defines = NULL;
+    rgsl_global_options.stage = NULL;
+    rgsl_global_options.profile = NULL;
     rgsl_global_options.action = RGSL_ACTION_NONE;
+    rgsl_global_options.native_includes = 0;
+    rgsl_global_options.serial_io = 0;
+    rgsl_global_options.split_embed = 0;
+    rgsl_global_options.shared_chunks = 0;
+    rgsl_global_options.spec_constants = NULL;
+    rgsl_global_options.cost_report = NULL;
+    rgsl_global_options.cost_baseline = NULL;
+    rgsl_global_options.cost_threshold = 10;
+    rgsl_global_options.perf_lint = 0;
+    rgsl_global_options.perf_lint_suppress = NULL;
+    rgsl_global_options.demote_precision = 0;
+    rgsl_global_options.mediump_texture_size = 0;
+    rgsl_global_options.mediump_outputs = 0;
+    rgsl_global_options.pack_uniforms = 0;
+    rgsl_global_options.pack_uniforms_binding = 0;
+    rgsl_global_options.layout_report = 0;
+    rgsl_global_options.layout_reorder = 0;
+    rgsl_global_options.benchmark = 0;
+    rgsl_global_options.targets = NULL;
+    rgsl_global_options.glslang_spirv = 0;
+    rgsl_global_options.spirv_validate = 0;
+    rgsl_global_options.program_module = 0;
+    rgsl_global_options.log_json = NULL;
+    rgsl_global_options.mem_report = NULL;
+    rgsl_global_options.usage_profile = NULL;
+    rgsl_global_options.startup_time = 0;
+    rgsl_global_options.split_cold = 0;
+    rgsl_global_options.usage_faults = 0;
     rgsl_global_options.show_version = false;
     rgsl_global_options.verbose = 1;
+    rgsl_log_initialize();
 }
 
 const char* rgsl_determine_shader_stage(const char* filename) {
@@ -111,6 +165,16 @@ const char* rgsl_determine_shader_stage(const char* filename) {
     return NULL;
 }
 
+const char* rgsl_find_shader_stage(const char* name, size_t length) {
+    size_t num_mappings = sizeof(STAGE_MAPPINGS) / sizeof(STAGE_MAPPINGS[0]);
+    for (size_t i = 0; i < num_mappings; i++) {
+        if (strncmp(name, STAGE_MAPPINGS[i].stage, length) == 0 && STAGE_MAPPINGS[i].stage[length] == '\0') {
+            return STAGE_MAPPINGS[i].stage;
+        }
+    }
+    return NULL;
+}
+
 const char* rgsl_determine_shader_language(const char* filename) {
     size_t num_mappings = sizeof(LANGUAGE_MAPPINGS) / sizeof(LANGUAGE_MAPPINGS[0]);
     const char* extension = strrchr(filename, '.');
@@ -141,8 +205,76 @@ const char* rgsl_determine_shader_name(const char* filename) {
     } else {
         name_length = strlen(base);
     }
-    char* name = (char *)malloc((name_length + 1) * sizeof(char));
+    char* name = (char *)rgsl_malloc((name_length + 1) * sizeof(char));
     strncpy_s(name, name_length + 1, base, name_length);
     name[name_length] = '\0';
     return name;
+}
+
+static const char* const PROFILE_NAMES[] = {
+    "core",
+    "compatibility",
+    "es",
+    NULL
+};
+
+bool rgsl_parse_profile(const char* text, struct rgsl_shader_profile* out_profile) {
+    char* name_start;
+    long version = strtol(text, &name_start, 10);
+    if (name_start == text || version <= 0) {
+        return false;
+    }
+    while (*name_start == ' ') {
+        name_start++;
+    }
+    out_profile->version = (int)version;
+    if (*name_start == '\0') {
+        out_profile->name = (version == 100) ? "es" : "core";
+        return true;
+    }
+    for (size_t i = 0; PROFILE_NAMES[i] != NULL; i++) {
+        if (strcmp(name_start, PROFILE_NAMES[i]) == 0) {
+            out_profile->name = PROFILE_NAMES[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+void rgsl_release_shader_intermediates(struct rgsl_shader_data* shader) {
+    rgsl_free(shader->processed_code);
+    shader->processed_code = NULL;
+    rgsl_line_map_free(&shader->line_map);
+    if (shader->program != NULL) {
+        rgsl_glslang_destroy_program(shader->program);
+        shader->program = NULL;
+    }
+    if (shader->module != NULL) {
+        rgsl_module_free(shader->module);
+        rgsl_free(shader->module);
+        shader->module = NULL;
+    }
+}
+
+void rgsl_release_shader(struct rgsl_shader_data* shader) {
+    rgsl_release_shader_intermediates(shader);
+    rgsl_free((void*)shader->name);
+    shader->name = NULL;
+    rgsl_free_file_buffer(shader->code);
+    shader->code = NULL;
+    rgsl_release_target_outputs(shader);
+    rgsl_free(shader->specializations);
+    shader->specializations = NULL;
+    shader->specialization_count = 0;
+    rgsl_free(shader->chunk_ends);
+    shader->chunk_ends = NULL;
+    shader->chunk_count = 0;
+    rgsl_block_layout_free(shader->uniform_block);
+    shader->uniform_block = NULL;
+    for (size_t i = 0; i < shader->layout_count; i++) {
+        rgsl_block_layout_free(shader->layouts[i]);
+    }
+    rgsl_free(shader->layouts);
+    shader->layouts = NULL;
+    shader->layout_count = 0;
 }
\ No newline at end of file
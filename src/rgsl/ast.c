@@ -0,0 +1,92 @@
+#include <RGSL/rgsl/ast.h>
+#include <RGSL/parser.h>
+#include <RGSL/termio.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Size of the first chunk of a module arena, enough for a small shader.
+#define RGSL_MODULE_ARENA_CHUNK (16 * 1024)
+
+void rgsl_module_init(struct rgsl_module* module, const char* path, const char* stage, const struct rgsl_line_map* line_map) {
+    memset(module, 0, sizeof(*module));
+    rgsl_arena_init(&module->arena, RGSL_MODULE_ARENA_CHUNK);
+    module->path = path;
+    module->stage = stage;
+    module->line_map = line_map;
+}
+
+void rgsl_module_free(struct rgsl_module* module) {
+    rgsl_arena_free(&module->arena);
+    module->globals = NULL;
+    module->last_global = NULL;
+    module->entry_point = NULL;
+}
+
+struct rgsl_global* rgsl_module_add_global(struct rgsl_module* module, enum rgsl_global_kind kind, uint32_t line) {
+    struct rgsl_global* global = (struct rgsl_global *)rgsl_arena_alloc(&module->arena, sizeof(struct rgsl_global));
+    global->kind = kind;
+    global->line = line;
+    if (module->last_global != NULL) {
+        module->last_global->next = global;
+    } else {
+        module->globals = global;
+    }
+    module->last_global = global;
+    return global;
+}
+
+static void rgsl_module_report(struct rgsl_module* module, uint32_t line, bool error, const char* format, va_list args) {
+    char* message = NULL;
+    rgsl_format_parser(format, args, &message);
+    if (message == NULL) {
+        return;
+    }
+    const char* source = module->path;
+    int source_line = (int)line;
+    if (module->line_map == NULL || !rgsl_line_map_lookup(module->line_map, (int)line, &source, &source_line)) {
+        source = module->path;
+        source_line = (int)line;
+    }
+    if (error) {
+        rgsl_printf_error("%s:%d: error: %s\n", source, source_line, message);
+    } else {
+        rgsl_printf_warning("%s:%d: warning: %s\n", source, source_line, message);
+    }
+    rgsl_free(message);
+}
+
+void rgsl_module_error(struct rgsl_module* module, uint32_t line, const char* format, ...) {
+    module->error_count++;
+    if (module->quiet) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    rgsl_module_report(module, line, true, format, args);
+    va_end(args);
+}
+
+void rgsl_module_warning(struct rgsl_module* module, uint32_t line, const char* format, ...) {
+    if (module->quiet) {
+        return;
+    }
+    va_list args;
+    va_start(args, format);
+    rgsl_module_report(module, line, false, format, args);
+    va_end(args);
+}
+
+void rgsl_module_require(struct rgsl_module* module, const char* feature, uint32_t desktop_version, uint32_t es_version) {
+    if (desktop_version > module->desktop_version) {
+        module->desktop_version = desktop_version;
+        module->desktop_feature = feature;
+    }
+    // An ESSL version of 0 means OpenGL ES lacks the feature, which no later requirement lifts.
+    if (module->es_feature == NULL || module->es_version != 0) {
+        if (es_version == 0 || es_version > module->es_version) {
+            module->es_version = es_version;
+            module->es_feature = feature;
+        }
+    }
+}
\ No newline at end of file
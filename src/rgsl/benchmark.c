@@ -0,0 +1,129 @@
+#include <RGSL/rgsl/benchmark.h>
+#include <RGSL/rgsl/lexer.h>
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/rgsl/checker.h>
+#include <RGSL/rgsl/ast.h>
+#include <RGSL/rgsl/glsl.h>
+#include <RGSL/rgsl/spirv.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/text.h>
+#include <RGSL/termio.h>
+#include <RGSL/clock.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+
+bool rgsl_rgsl_benchmark_enabled() {
+    return rgsl_global_options.benchmark > 0;
+}
+
+static void rgsl_print_throughput(const char* pass, size_t size, size_t tokens, double seconds) {
+    // Timers can round a pass of a tiny shader down to zero.
+    if (seconds <= 0.0) {
+        seconds = 1e-9;
+    }
+    rgsl_printf_info(0, "  %-16s %10.3f ms %10.1f MB/s %10.2f Mtokens/s\n", pass, seconds * 1000.0,
+                     (double)size / seconds / 1e6, (double)tokens / seconds / 1e6);
+}
+
+// Emits SPIR-V straight from the syntax tree.
+static bool rgsl_benchmark_native_spirv(const struct rgsl_shader_data* shader) {
+    uint32_t* words = NULL;
+    size_t word_count = 0;
+    bool success = rgsl_spirv_emit(shader->module, &words, &word_count);
+    rgsl_free(words);
+    return success;
+}
+
+// Emits GLSL and has glslang compile it to SPIR-V, as --glslang-spirv does.
+static bool rgsl_benchmark_glslang_spirv(const struct rgsl_shader_data* shader, const struct rgsl_shader_profile* profile) {
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    rgsl_glsl_emit(shader->module, profile, &text);
+    char* log = NULL;
+    struct rgsl_glslang_program* program = rgsl_glslang_create_program(text.data, shader->path, shader->stage, false, false, &log);
+    rgsl_free(text.data);
+    rgsl_free(log);
+    if (program == NULL) {
+        return false;
+    }
+    struct rgsl_glslang_result result = rgsl_glslang_generate_spirv(program);
+    bool success = result.success;
+    rgsl_glslang_free_result(&result);
+    rgsl_glslang_destroy_program(program);
+    return success;
+}
+
+// Times the two ways to SPIR-V, from the module the compilation goes on with.
+static void rgsl_benchmark_spirv(const struct rgsl_shader_data* shader, size_t size, size_t tokens, int iterations) {
+    struct rgsl_shader_profile profile;
+    bool glslang = rgsl_glsl_choose_profile(shader->module, &shader->requested_profile, &profile);
+    double best_native = -1.0;
+    double best_glslang = -1.0;
+    for (int i = 0; i < iterations; i++) {
+        double start = rgsl_clock_seconds();
+        if (!rgsl_benchmark_native_spirv(shader)) {
+            return;
+        }
+        double elapsed = rgsl_clock_seconds() - start;
+        if (best_native < 0.0 || elapsed < best_native) {
+            best_native = elapsed;
+        }
+        start = rgsl_clock_seconds();
+        glslang = glslang && rgsl_benchmark_glslang_spirv(shader, &profile);
+        elapsed = rgsl_clock_seconds() - start;
+        if (glslang && (best_glslang < 0.0 || elapsed < best_glslang)) {
+            best_glslang = elapsed;
+        }
+    }
+    rgsl_print_throughput("spirv (native)", size, tokens, best_native);
+    if (glslang) {
+        rgsl_print_throughput("glsl + glslang", size, tokens, best_glslang);
+    }
+}
+
+void rgsl_rgsl_benchmark(const struct rgsl_shader_data* shader) {
+    const char* code = shader->processed_code;
+    size_t size = strlen(code);
+    int iterations = rgsl_global_options.benchmark;
+    double best_lex = -1.0;
+    double best_parse = -1.0;
+    size_t tokens = 0;
+    for (int i = 0; i < iterations; i++) {
+        double start = rgsl_clock_seconds();
+        struct rgsl_lexer lexer;
+        struct rgsl_token token;
+        rgsl_lexer_init(&lexer, code, size, 1);
+        size_t count = 0;
+        do {
+            rgsl_lexer_next(&lexer, &token);
+            count++;
+        } while (token.kind != RGSL_TOKEN_END);
+        double elapsed = rgsl_clock_seconds() - start;
+        if (best_lex < 0.0 || elapsed < best_lex) {
+            best_lex = elapsed;
+        }
+        tokens = count;
+    }
+    for (int i = 0; i < iterations; i++) {
+        double start = rgsl_clock_seconds();
+        struct rgsl_module module;
+        rgsl_module_init(&module, shader->path, shader->stage, &shader->line_map);
+        module.quiet = true;
+        if (rgsl_rgsl_parse(&module, code, size)) {
+            rgsl_rgsl_check(&module);
+        }
+        double elapsed = rgsl_clock_seconds() - start;
+        rgsl_module_free(&module);
+        if (best_parse < 0.0 || elapsed < best_parse) {
+            best_parse = elapsed;
+        }
+    }
+    rgsl_printf_info(0, "Frontend benchmark of %s: %zu bytes, %zu tokens, best of %d passes\n", shader->path, size, tokens, iterations);
+    rgsl_print_throughput("lex", size, tokens, best_lex);
+    rgsl_print_throughput("parse and check", size, tokens, best_parse);
+    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
+        rgsl_benchmark_spirv(shader, size, tokens, iterations);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,1645 @@
+#include <RGSL/rgsl/checker.h>
+#include <RGSL/termio.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number of buckets of the scope table, a power of two.
+#define RGSL_SCOPE_BUCKETS 256
+// Number of built-in variables a shader can use.
+#define RGSL_MAX_BUILTIN_VARIABLES 16
+
+/**
+ * Declaration visible in a scope. Entries are pushed as declarations are met and
+ * popped when their scope closes; each one links to the previous entry of its
+ * bucket, so that popping restores the names it shadowed.
+ */
+struct rgsl_scope_entry {
+    const char* name;
+    struct rgsl_variable* variable;
+    struct rgsl_function* function;
+    uint32_t depth;
+    int32_t previous;
+};
+
+struct rgsl_checker {
+    struct rgsl_module* module;
+    struct rgsl_scope_entry* entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    int32_t buckets[RGSL_SCOPE_BUCKETS];
+    uint32_t depth;
+    struct rgsl_variable* builtins[RGSL_MAX_BUILTIN_VARIABLES];
+    size_t builtin_count;
+    const struct rgsl_function* function;
+    uint32_t loop_depth;
+    uint32_t switch_depth;
+    uint32_t fragment_outputs;
+    uint32_t fragment_outputs_located;
+};
+
+static const char* const SWIZZLE_SETS[] = {"xyzw", "rgba", "stpq"};
+
+static const struct rgsl_type* rgsl_error_type() {
+    return rgsl_builtin_type(RGSL_BUILTIN_ERROR);
+}
+
+static bool rgsl_is_error(const struct rgsl_type* type) {
+    return type->kind == RGSL_TYPE_ERROR;
+}
+
+static bool rgsl_is_scalar(const struct rgsl_type* type, enum rgsl_scalar_kind scalar) {
+    return type->kind == RGSL_TYPE_SCALAR && type->scalar == scalar;
+}
+
+static bool rgsl_is_integer(const struct rgsl_type* type) {
+    return (type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) && (type->scalar == RGSL_SCALAR_INT || type->scalar == RGSL_SCALAR_UINT);
+}
+
+// Writes a type for diagnostics, in a buffer owned by the caller.
+static const char* rgsl_type_name(const struct rgsl_type* type, char* buffer, size_t size) {
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    rgsl_type_write(&text, type);
+    snprintf(buffer, size, "%s", text.data != NULL ? text.data : "");
+    rgsl_text_free(&text);
+    return buffer;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Scopes                                                                     */
+/* -------------------------------------------------------------------------- */
+
+static size_t rgsl_scope_bucket(const char* name) {
+    // Names are interned by the parser, so their address identifies them.
+    uintptr_t address = (uintptr_t)name;
+    return (size_t)((address >> 4) ^ (address >> 12)) & (RGSL_SCOPE_BUCKETS - 1);
+}
+
+static const struct rgsl_scope_entry* rgsl_scope_lookup(const struct rgsl_checker* checker, const char* name) {
+    int32_t index = checker->buckets[rgsl_scope_bucket(name)];
+    while (index >= 0) {
+        const struct rgsl_scope_entry* entry = &checker->entries[index];
+        if (entry->name == name) {
+            return entry;
+        }
+        index = entry->previous;
+    }
+    return NULL;
+}
+
+static struct rgsl_scope_entry* rgsl_scope_declare(struct rgsl_checker* checker, const char* name, uint32_t line) {
+    const struct rgsl_scope_entry* existing = rgsl_scope_lookup(checker, name);
+    if (existing != NULL && existing->depth == checker->depth) {
+        rgsl_module_error(checker->module, line, "%s is already declared in this scope", name);
+        return NULL;
+    }
+    if (checker->entry_count == checker->entry_capacity) {
+        checker->entry_capacity = checker->entry_capacity ? checker->entry_capacity * 2 : 64;
+        checker->entries = (struct rgsl_scope_entry *)rgsl_realloc(checker->entries, checker->entry_capacity * sizeof(struct rgsl_scope_entry));
+    }
+    size_t bucket = rgsl_scope_bucket(name);
+    struct rgsl_scope_entry* entry = &checker->entries[checker->entry_count];
+    entry->name = name;
+    entry->variable = NULL;
+    entry->function = NULL;
+    entry->depth = checker->depth;
+    entry->previous = checker->buckets[bucket];
+    checker->buckets[bucket] = (int32_t)checker->entry_count++;
+    return entry;
+}
+
+static size_t rgsl_scope_push(struct rgsl_checker* checker) {
+    checker->depth++;
+    return checker->entry_count;
+}
+
+static void rgsl_scope_pop(struct rgsl_checker* checker, size_t mark) {
+    while (checker->entry_count > mark) {
+        const struct rgsl_scope_entry* entry = &checker->entries[--checker->entry_count];
+        checker->buckets[rgsl_scope_bucket(entry->name)] = entry->previous;
+    }
+    checker->depth--;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Constants and conversions                                                  */
+/* -------------------------------------------------------------------------- */
+
+// Tells whether an expression is a constant whose value is known.
+static bool rgsl_has_value(const struct rgsl_expr* expr) {
+    return expr->constant && expr->type->kind == RGSL_TYPE_SCALAR;
+}
+
+static union rgsl_scalar_value rgsl_convert_value(union rgsl_scalar_value value, enum rgsl_scalar_kind from, enum rgsl_scalar_kind to) {
+    union rgsl_scalar_value result;
+    result.u = 0;
+    if (from == to) {
+        return value;
+    }
+    switch (to) {
+        case RGSL_SCALAR_FLOAT:
+            result.f = (from == RGSL_SCALAR_INT) ? (float)value.i : (from == RGSL_SCALAR_UINT) ? (float)value.u : (value.b ? 1.0f : 0.0f);
+            break;
+        case RGSL_SCALAR_INT:
+            result.i = (from == RGSL_SCALAR_FLOAT) ? (int32_t)value.f : (from == RGSL_SCALAR_UINT) ? (int32_t)value.u : (value.b ? 1 : 0);
+            break;
+        case RGSL_SCALAR_UINT:
+            result.u = (from == RGSL_SCALAR_FLOAT) ? (uint32_t)value.f : (from == RGSL_SCALAR_INT) ? (uint32_t)value.i : (value.b ? 1u : 0u);
+            break;
+        case RGSL_SCALAR_BOOL:
+            result.b = (from == RGSL_SCALAR_FLOAT) ? value.f != 0.0f : (from == RGSL_SCALAR_INT) ? value.i != 0 : value.u != 0;
+            break;
+    }
+    return result;
+}
+
+static bool rgsl_is_literal_convertible(const struct rgsl_expr* expr, const struct rgsl_type* to) {
+    // An int literal that is not negative converts to uint, so that "x + 1" works on uints.
+    return expr->kind == RGSL_EXPR_LITERAL && rgsl_is_scalar(expr->type, RGSL_SCALAR_INT) && rgsl_is_scalar(to, RGSL_SCALAR_UINT) && expr->value.i >= 0;
+}
+
+static bool rgsl_converts(const struct rgsl_expr* expr, const struct rgsl_type* to) {
+    return rgsl_type_converts(expr->type, to) || rgsl_is_literal_convertible(expr, to);
+}
+
+/**
+ * Converts an expression to a type it converts to. Literals are converted in
+ * place, their text being dropped; other expressions are wrapped in a conversion.
+ */
+static void rgsl_convert(struct rgsl_checker* checker, struct rgsl_expr** expr_slot, const struct rgsl_type* to) {
+    struct rgsl_expr* expr = *expr_slot;
+    if (rgsl_type_equal(expr->type, to) || rgsl_is_error(expr->type)) {
+        return;
+    }
+    if (expr->kind == RGSL_EXPR_LITERAL && expr->type->kind == RGSL_TYPE_SCALAR) {
+        expr->value = rgsl_convert_value(expr->value, expr->type->scalar, to->scalar);
+        expr->op = (to->scalar == RGSL_SCALAR_FLOAT) ? RGSL_TOKEN_FLOAT_LITERAL : RGSL_TOKEN_UINT_LITERAL;
+        expr->type = to;
+        expr->name = NULL;
+        expr->text_length = 0;
+        return;
+    }
+    struct rgsl_expr* conversion = (struct rgsl_expr *)rgsl_arena_alloc(&checker->module->arena, sizeof(struct rgsl_expr));
+    conversion->kind = RGSL_EXPR_CONVERT;
+    conversion->line = expr->line;
+    conversion->type = to;
+    conversion->operands[0] = expr;
+    conversion->constant = expr->constant;
+    if (rgsl_has_value(expr)) {
+        conversion->value = rgsl_convert_value(expr->value, expr->type->scalar, to->scalar);
+    }
+    *expr_slot = conversion;
+}
+
+static bool rgsl_fold_unary(struct rgsl_expr* expr) {
+    const struct rgsl_expr* operand = expr->operands[0];
+    union rgsl_scalar_value value = operand->value;
+    enum rgsl_scalar_kind scalar = operand->type->scalar;
+    switch (expr->op) {
+        case RGSL_TOKEN_PLUS: break;
+        case RGSL_TOKEN_MINUS:
+            if (scalar == RGSL_SCALAR_FLOAT) {
+                value.f = -value.f;
+            } else {
+                value.u = 0u - value.u;
+            }
+            break;
+        case RGSL_TOKEN_BANG: value.b = !value.b; break;
+        case RGSL_TOKEN_TILDE: value.u = ~value.u; break;
+        default:
+            return false;
+    }
+    expr->value = value;
+    return true;
+}
+
+static bool rgsl_fold_binary(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const union rgsl_scalar_value a = expr->operands[0]->value;
+    const union rgsl_scalar_value b = expr->operands[1]->value;
+    enum rgsl_scalar_kind scalar = expr->operands[0]->type->scalar;
+    bool is_float = scalar == RGSL_SCALAR_FLOAT;
+    bool is_int = scalar == RGSL_SCALAR_INT;
+    union rgsl_scalar_value value;
+    value.u = 0;
+    switch (expr->op) {
+        case RGSL_TOKEN_PLUS: if (is_float) value.f = a.f + b.f; else value.u = a.u + b.u; break;
+        case RGSL_TOKEN_MINUS: if (is_float) value.f = a.f - b.f; else value.u = a.u - b.u; break;
+        case RGSL_TOKEN_STAR: if (is_float) value.f = a.f * b.f; else value.u = a.u * b.u; break;
+        case RGSL_TOKEN_SLASH:
+        case RGSL_TOKEN_PERCENT:
+            if (is_float) {
+                value.f = a.f / b.f;
+                break;
+            }
+            if (b.u == 0) {
+                rgsl_module_error(checker->module, expr->line, "division by zero in a constant expression");
+                return false;
+            }
+            if (is_int && a.i == INT32_MIN && b.i == -1) {
+                value.i = (expr->op == RGSL_TOKEN_SLASH) ? INT32_MIN : 0;
+            } else if (expr->op == RGSL_TOKEN_SLASH) {
+                if (is_int) value.i = a.i / b.i; else value.u = a.u / b.u;
+            } else {
+                if (is_int) value.i = a.i % b.i; else value.u = a.u % b.u;
+            }
+            break;
+        case RGSL_TOKEN_LEFT_SHIFT: value.u = (b.u < 32) ? a.u << b.u : 0; break;
+        case RGSL_TOKEN_RIGHT_SHIFT:
+            if (b.u >= 32) {
+                value.u = (is_int && a.i < 0) ? UINT32_MAX : 0;
+            } else if (is_int) {
+                value.i = (a.i < 0) ? ~(~a.i >> b.u) : a.i >> b.u;
+            } else {
+                value.u = a.u >> b.u;
+            }
+            break;
+        case RGSL_TOKEN_AMPERSAND: value.u = a.u & b.u; break;
+        case RGSL_TOKEN_BAR: value.u = a.u | b.u; break;
+        case RGSL_TOKEN_CARET: value.u = a.u ^ b.u; break;
+        case RGSL_TOKEN_AND_AND: value.b = a.b && b.b; break;
+        case RGSL_TOKEN_OR_OR: value.b = a.b || b.b; break;
+        case RGSL_TOKEN_XOR_XOR: value.b = a.b != b.b; break;
+        case RGSL_TOKEN_EQUAL_EQUAL:
+        case RGSL_TOKEN_BANG_EQUAL:
+            value.b = is_float ? a.f == b.f : (scalar == RGSL_SCALAR_BOOL) ? a.b == b.b : a.u == b.u;
+            if (expr->op == RGSL_TOKEN_BANG_EQUAL) {
+                value.b = !value.b;
+            }
+            break;
+        case RGSL_TOKEN_LESS: value.b = is_float ? a.f < b.f : is_int ? a.i < b.i : a.u < b.u; break;
+        case RGSL_TOKEN_GREATER: value.b = is_float ? a.f > b.f : is_int ? a.i > b.i : a.u > b.u; break;
+        case RGSL_TOKEN_LESS_EQUAL: value.b = is_float ? a.f <= b.f : is_int ? a.i <= b.i : a.u <= b.u; break;
+        case RGSL_TOKEN_GREATER_EQUAL: value.b = is_float ? a.f >= b.f : is_int ? a.i >= b.i : a.u >= b.u; break;
+        default:
+            return false;
+    }
+    expr->value = value;
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Types                                                                      */
+/* -------------------------------------------------------------------------- */
+
+static const struct rgsl_type* rgsl_check_expr(struct rgsl_checker* checker, struct rgsl_expr* expr);
+
+/**
+ * Folds the sizes of an array type. Unsized arrays keep a size of 0, to be taken
+ * from their initializer, or RGSL_RUNTIME_ARRAY if the caller allows it.
+ */
+static bool rgsl_resolve_type(struct rgsl_checker* checker, const struct rgsl_type* type, uint32_t line) {
+    if (type->kind != RGSL_TYPE_ARRAY) {
+        return true;
+    }
+    struct rgsl_type* array = (struct rgsl_type *)type;
+    if (!rgsl_resolve_type(checker, array->element, line)) {
+        return false;
+    }
+    if (array->element->kind == RGSL_TYPE_ARRAY) {
+        rgsl_module_require(checker->module, "arrays of arrays", 430, 310);
+    }
+    if (array->size_expr == NULL || array->array_size != 0) {
+        return true;
+    }
+    const struct rgsl_type* size_type = rgsl_check_expr(checker, array->size_expr);
+    if (rgsl_is_error(size_type)) {
+        return false;
+    }
+    if (!rgsl_has_value(array->size_expr) || (size_type->scalar != RGSL_SCALAR_INT && size_type->scalar != RGSL_SCALAR_UINT)) {
+        rgsl_module_error(checker->module, line, "array sizes must be constant integer expressions");
+        return false;
+    }
+    if (array->size_expr->value.i <= 0 && size_type->scalar == RGSL_SCALAR_INT) {
+        rgsl_module_error(checker->module, line, "array size %d is not positive", array->size_expr->value.i);
+        return false;
+    }
+    if (array->size_expr->value.u == 0) {
+        rgsl_module_error(checker->module, line, "array size 0 is not positive");
+        return false;
+    }
+    array->array_size = array->size_expr->value.u;
+    return true;
+}
+
+static bool rgsl_is_unsized(const struct rgsl_type* type) {
+    return type->kind == RGSL_TYPE_ARRAY && (type->array_size == 0 || type->array_size == RGSL_RUNTIME_ARRAY);
+}
+
+static bool rgsl_type_contains(const struct rgsl_type* type, bool (*predicate)(const struct rgsl_type*)) {
+    while (type->kind == RGSL_TYPE_ARRAY) {
+        type = type->element;
+    }
+    if (type->kind == RGSL_TYPE_STRUCT) {
+        for (uint32_t i = 0; i < type->structure->field_count; i++) {
+            if (rgsl_type_contains(type->structure->fields[i].type, predicate)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    return predicate(type);
+}
+
+static bool rgsl_is_integer_or_bool(const struct rgsl_type* type) {
+    return type->kind != RGSL_TYPE_SAMPLER && type->kind != RGSL_TYPE_STRUCT && type->scalar != RGSL_SCALAR_FLOAT;
+}
+
+static bool rgsl_is_bool(const struct rgsl_type* type) {
+    return (type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) && type->scalar == RGSL_SCALAR_BOOL;
+}
+
+static bool rgsl_is_opaque(const struct rgsl_type* type) {
+    return type->kind == RGSL_TYPE_SAMPLER;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Expressions                                                                */
+/* -------------------------------------------------------------------------- */
+
+static const struct rgsl_type* rgsl_expr_error(struct rgsl_expr* expr) {
+    expr->type = rgsl_error_type();
+    return expr->type;
+}
+
+static struct rgsl_variable* rgsl_builtin_variable(struct rgsl_checker* checker, const char* name, uint32_t line) {
+    for (size_t i = 0; i < checker->builtin_count; i++) {
+        if (checker->builtins[i]->name == name) {
+            return checker->builtins[i];
+        }
+    }
+    const struct rgsl_builtin_variable* builtin = rgsl_find_builtin_variable(name);
+    if (builtin == NULL) {
+        return NULL;
+    }
+    struct rgsl_module* module = checker->module;
+    if (strcmp(builtin->stage, module->stage) != 0) {
+        rgsl_module_error(module, line, "%s is not available in %s shaders", name, module->stage);
+        return NULL;
+    }
+    rgsl_module_require(module, builtin->name, builtin->desktop_version, builtin->es_version);
+    struct rgsl_variable* variable = (struct rgsl_variable *)rgsl_arena_alloc(&module->arena, sizeof(struct rgsl_variable));
+    variable->name = name;
+    variable->type = rgsl_builtin_type(builtin->type);
+    variable->storage = RGSL_STORAGE_BUILTIN;
+    variable->direction = builtin->output ? RGSL_DIRECTION_OUT : RGSL_DIRECTION_IN;
+    variable->layout.location = variable->layout.binding = variable->layout.constant_id = variable->layout.packing = -1;
+    variable->builtin = builtin;
+    variable->line = line;
+    variable->id = module->variable_count++;
+    checker->builtins[checker->builtin_count++] = variable;
+    return variable;
+}
+
+// Tells whether an expression can be written to, and reports why it cannot otherwise.
+static bool rgsl_check_lvalue(struct rgsl_checker* checker, const struct rgsl_expr* expr) {
+    const struct rgsl_expr* base = expr;
+    while (base->kind == RGSL_EXPR_INDEX || base->kind == RGSL_EXPR_FIELD || base->kind == RGSL_EXPR_SWIZZLE) {
+        if (base->kind == RGSL_EXPR_SWIZZLE) {
+            for (uint32_t i = 0; i < base->swizzle_count; i++) {
+                for (uint32_t j = i + 1; j < base->swizzle_count; j++) {
+                    if (base->swizzle[i] == base->swizzle[j]) {
+                        rgsl_module_error(checker->module, expr->line, "a swizzle writing a component twice cannot be assigned");
+                        return false;
+                    }
+                }
+            }
+        }
+        base = base->operands[0];
+    }
+    const struct rgsl_variable* variable = (base->kind == RGSL_EXPR_VARIABLE) ? base->variable : NULL;
+    if (variable == NULL) {
+        if (!rgsl_is_error(base->type)) {
+            rgsl_module_error(checker->module, expr->line, "the expression cannot be assigned");
+        }
+        return false;
+    }
+    const char* reason = NULL;
+    if (variable->is_const) {
+        reason = "constant";
+    } else if (variable->storage == RGSL_STORAGE_IN || variable->storage == RGSL_STORAGE_UNIFORM) {
+        reason = (variable->storage == RGSL_STORAGE_IN) ? "an input" : "a uniform";
+    } else if (variable->storage == RGSL_STORAGE_BUILTIN && variable->direction == RGSL_DIRECTION_IN) {
+        reason = "a built-in input";
+    } else if (variable->storage == RGSL_STORAGE_BUFFER && (variable->memory & RGSL_MEMORY_READONLY)) {
+        reason = "readonly";
+    } else if (variable->storage == RGSL_STORAGE_PARAMETER && variable->direction == RGSL_DIRECTION_IN && variable->is_const) {
+        reason = "a const parameter";
+    }
+    if (reason != NULL) {
+        rgsl_module_error(checker->module, expr->line, "%s cannot be assigned, it is %s", variable->name, reason);
+        return false;
+    }
+    return true;
+}
+
+static const struct rgsl_type* rgsl_check_variable(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_scope_entry* entry = rgsl_scope_lookup(checker, expr->name);
+    struct rgsl_variable* variable = (entry != NULL) ? entry->variable : NULL;
+    if (entry != NULL && variable == NULL) {
+        rgsl_module_error(checker->module, expr->line, "function %s is used as a variable", expr->name);
+        return rgsl_expr_error(expr);
+    }
+    if (variable == NULL) {
+        variable = rgsl_builtin_variable(checker, expr->name, expr->line);
+        if (variable == NULL) {
+            if (rgsl_find_builtin_variable(expr->name) == NULL) {
+                rgsl_module_error(checker->module, expr->line, "%s is not declared", expr->name);
+            }
+            return rgsl_expr_error(expr);
+        }
+    }
+    expr->variable = variable;
+    expr->constant = variable->constant;
+    expr->value = variable->value;
+    expr->type = variable->type;
+    return expr->type;
+}
+
+// Brings the scalar types of the operands of a binary operation together, converting one of them.
+static bool rgsl_unify_operands(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* a = expr->operands[0]->type;
+    const struct rgsl_type* b = expr->operands[1]->type;
+    if (a->scalar == b->scalar) {
+        return true;
+    }
+    for (int side = 0; side < 2; side++) {
+        struct rgsl_expr* from = expr->operands[side];
+        const struct rgsl_type* other = expr->operands[1 - side]->type;
+        const struct rgsl_type* target = NULL;
+        if (from->type->kind == RGSL_TYPE_MATRIX) {
+            continue;
+        }
+        target = rgsl_vector_type(other->scalar, from->type->rows);
+        if (rgsl_converts(from, target)) {
+            rgsl_convert(checker, &expr->operands[side], target);
+            return true;
+        }
+    }
+    return false;
+}
+
+static const struct rgsl_type* rgsl_arithmetic_result(const struct rgsl_type* a, const struct rgsl_type* b, enum rgsl_token_kind op) {
+    if (a->kind == RGSL_TYPE_SCALAR) {
+        return b;
+    }
+    if (b->kind == RGSL_TYPE_SCALAR) {
+        return a;
+    }
+    if (a->kind == RGSL_TYPE_VECTOR && b->kind == RGSL_TYPE_VECTOR) {
+        return (a->rows == b->rows) ? a : NULL;
+    }
+    if (op != RGSL_TOKEN_STAR) {
+        // Component-wise operations on matrices need matching sizes.
+        return (a == b) ? a : NULL;
+    }
+    if (a->kind == RGSL_TYPE_MATRIX && b->kind == RGSL_TYPE_VECTOR) {
+        return (a->columns == b->rows) ? rgsl_vector_type(RGSL_SCALAR_FLOAT, a->rows) : NULL;
+    }
+    if (a->kind == RGSL_TYPE_VECTOR && b->kind == RGSL_TYPE_MATRIX) {
+        return (a->rows == b->rows) ? rgsl_vector_type(RGSL_SCALAR_FLOAT, b->columns) : NULL;
+    }
+    return (a->columns == b->rows) ? rgsl_matrix_type(b->columns, a->rows) : NULL;
+}
+
+static const struct rgsl_type* rgsl_binary_result(struct rgsl_checker* checker, struct rgsl_expr* expr, enum rgsl_token_kind op) {
+    const struct rgsl_type* a = expr->operands[0]->type;
+    const struct rgsl_type* b = expr->operands[1]->type;
+    switch (op) {
+        case RGSL_TOKEN_AND_AND:
+        case RGSL_TOKEN_OR_OR:
+        case RGSL_TOKEN_XOR_XOR:
+            return (rgsl_is_scalar(a, RGSL_SCALAR_BOOL) && rgsl_is_scalar(b, RGSL_SCALAR_BOOL)) ? a : NULL;
+        case RGSL_TOKEN_EQUAL_EQUAL:
+        case RGSL_TOKEN_BANG_EQUAL:
+            if (rgsl_type_contains(a, rgsl_is_opaque) || rgsl_is_unsized(a)) {
+                return NULL;
+            }
+            if (!rgsl_type_equal(a, b) && !((a->kind == RGSL_TYPE_SCALAR || a->kind == RGSL_TYPE_VECTOR) && rgsl_unify_operands(checker, expr))) {
+                return NULL;
+            }
+            return rgsl_type_equal(expr->operands[0]->type, expr->operands[1]->type) ? rgsl_builtin_type(RGSL_BUILTIN_BOOL) : NULL;
+        case RGSL_TOKEN_LESS:
+        case RGSL_TOKEN_GREATER:
+        case RGSL_TOKEN_LESS_EQUAL:
+        case RGSL_TOKEN_GREATER_EQUAL:
+            if (a->kind != RGSL_TYPE_SCALAR || b->kind != RGSL_TYPE_SCALAR || !rgsl_type_is_numeric(a) || !rgsl_type_is_numeric(b) || !rgsl_unify_operands(checker, expr)) {
+                return NULL;
+            }
+            return rgsl_builtin_type(RGSL_BUILTIN_BOOL);
+        case RGSL_TOKEN_LEFT_SHIFT:
+        case RGSL_TOKEN_RIGHT_SHIFT:
+            // The operands of shifts may differ in signedness, the result has the type of the left one.
+            if (!rgsl_is_integer(a) || !rgsl_is_integer(b) || (b->kind == RGSL_TYPE_VECTOR && b->rows != a->rows)) {
+                return NULL;
+            }
+            return a;
+        case RGSL_TOKEN_PERCENT:
+        case RGSL_TOKEN_AMPERSAND:
+        case RGSL_TOKEN_BAR:
+        case RGSL_TOKEN_CARET:
+            if (!rgsl_is_integer(a) || !rgsl_is_integer(b) || !rgsl_unify_operands(checker, expr)) {
+                return NULL;
+            }
+            return rgsl_arithmetic_result(expr->operands[0]->type, expr->operands[1]->type, op);
+        default:
+            if ((!rgsl_type_is_numeric(a) && a->kind != RGSL_TYPE_MATRIX) || (!rgsl_type_is_numeric(b) && b->kind != RGSL_TYPE_MATRIX) ||
+                !rgsl_unify_operands(checker, expr)) {
+                return NULL;
+            }
+            return rgsl_arithmetic_result(expr->operands[0]->type, expr->operands[1]->type, op);
+    }
+}
+
+static const struct rgsl_type* rgsl_check_binary(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* a = rgsl_check_expr(checker, expr->operands[0]);
+    const struct rgsl_type* b = rgsl_check_expr(checker, expr->operands[1]);
+    if (rgsl_is_error(a) || rgsl_is_error(b)) {
+        return rgsl_expr_error(expr);
+    }
+    const struct rgsl_type* result = rgsl_binary_result(checker, expr, expr->op);
+    if (result == NULL) {
+        char left[64];
+        char right[64];
+        rgsl_module_error(checker->module, expr->line, "operator %s cannot be applied to %s and %s", rgsl_token_spelling(expr->op),
+                          rgsl_type_name(a, left, sizeof(left)), rgsl_type_name(b, right, sizeof(right)));
+        return rgsl_expr_error(expr);
+    }
+    expr->type = result;
+    expr->constant = expr->operands[0]->constant && expr->operands[1]->constant;
+    if (expr->constant && rgsl_has_value(expr->operands[0]) && rgsl_has_value(expr->operands[1]) && result->kind == RGSL_TYPE_SCALAR) {
+        rgsl_fold_binary(checker, expr);
+    }
+    return result;
+}
+
+static const struct rgsl_type* rgsl_check_unary(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* type = rgsl_check_expr(checker, expr->operands[0]);
+    if (rgsl_is_error(type)) {
+        return rgsl_expr_error(expr);
+    }
+    bool valid;
+    switch (expr->op) {
+        case RGSL_TOKEN_BANG:
+            valid = rgsl_is_scalar(type, RGSL_SCALAR_BOOL);
+            break;
+        case RGSL_TOKEN_TILDE:
+            valid = rgsl_is_integer(type);
+            break;
+        case RGSL_TOKEN_PLUS_PLUS:
+        case RGSL_TOKEN_MINUS_MINUS:
+            valid = rgsl_type_is_numeric(type) || type->kind == RGSL_TYPE_MATRIX;
+            if (valid && !rgsl_check_lvalue(checker, expr->operands[0])) {
+                return rgsl_expr_error(expr);
+            }
+            break;
+        default:
+            valid = rgsl_type_is_numeric(type) || type->kind == RGSL_TYPE_MATRIX;
+            break;
+    }
+    if (!valid) {
+        char name[64];
+        rgsl_module_error(checker->module, expr->line, "operator %s cannot be applied to %s", rgsl_token_spelling(expr->op), rgsl_type_name(type, name, sizeof(name)));
+        return rgsl_expr_error(expr);
+    }
+    expr->type = type;
+    if (expr->op != RGSL_TOKEN_PLUS_PLUS && expr->op != RGSL_TOKEN_MINUS_MINUS) {
+        expr->constant = expr->operands[0]->constant;
+        if (rgsl_has_value(expr->operands[0])) {
+            rgsl_fold_unary(expr);
+        }
+    }
+    return type;
+}
+
+static const struct rgsl_type* rgsl_check_assign(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* target = rgsl_check_expr(checker, expr->operands[0]);
+    const struct rgsl_type* value = rgsl_check_expr(checker, expr->operands[1]);
+    if (rgsl_is_error(target) || rgsl_is_error(value) || !rgsl_check_lvalue(checker, expr->operands[0])) {
+        return rgsl_expr_error(expr);
+    }
+    expr->type = target;
+    if (expr->op == RGSL_TOKEN_EQUAL) {
+        if (rgsl_type_contains(target, rgsl_is_opaque)) {
+            rgsl_module_error(checker->module, expr->line, "samplers cannot be assigned");
+            return rgsl_expr_error(expr);
+        }
+        if (!rgsl_converts(expr->operands[1], target)) {
+            char left[64];
+            char right[64];
+            rgsl_module_error(checker->module, expr->line, "cannot assign %s to %s", rgsl_type_name(value, right, sizeof(right)), rgsl_type_name(target, left, sizeof(left)));
+            return rgsl_expr_error(expr);
+        }
+        rgsl_convert(checker, &expr->operands[1], target);
+        return target;
+    }
+    // "a op= b" is "a = a op b", whose result must keep the type of a.
+    static const enum rgsl_token_kind COMPOUND_OPERATORS[] = {
+        RGSL_TOKEN_PLUS, RGSL_TOKEN_MINUS, RGSL_TOKEN_STAR, RGSL_TOKEN_SLASH, RGSL_TOKEN_PERCENT,
+        RGSL_TOKEN_AMPERSAND, RGSL_TOKEN_BAR, RGSL_TOKEN_CARET, RGSL_TOKEN_LEFT_SHIFT, RGSL_TOKEN_RIGHT_SHIFT
+    };
+    enum rgsl_token_kind op = COMPOUND_OPERATORS[expr->op - RGSL_TOKEN_PLUS_EQUAL];
+    if (value->kind != RGSL_TYPE_MATRIX && op != RGSL_TOKEN_LEFT_SHIFT && op != RGSL_TOKEN_RIGHT_SHIFT) {
+        // Only the value is converted, the target being written back with its own type.
+        const struct rgsl_type* converted = rgsl_vector_type(target->scalar, value->rows);
+        if (rgsl_converts(expr->operands[1], converted)) {
+            rgsl_convert(checker, &expr->operands[1], converted);
+        }
+    }
+    const struct rgsl_type* result = NULL;
+    if (target->scalar == expr->operands[1]->type->scalar || op == RGSL_TOKEN_LEFT_SHIFT || op == RGSL_TOKEN_RIGHT_SHIFT) {
+        result = rgsl_binary_result(checker, expr, op);
+    }
+    if (result == NULL || !rgsl_type_equal(result, target)) {
+        char left[64];
+        char right[64];
+        rgsl_module_error(checker->module, expr->line, "operator %s cannot be applied to %s and %s", rgsl_token_spelling(expr->op),
+                          rgsl_type_name(target, left, sizeof(left)), rgsl_type_name(expr->operands[1]->type, right, sizeof(right)));
+        return rgsl_expr_error(expr);
+    }
+    return target;
+}
+
+static const struct rgsl_type* rgsl_check_conditional(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* condition = rgsl_check_expr(checker, expr->operands[0]);
+    const struct rgsl_type* a = rgsl_check_expr(checker, expr->operands[1]);
+    const struct rgsl_type* b = rgsl_check_expr(checker, expr->operands[2]);
+    if (rgsl_is_error(condition) || rgsl_is_error(a) || rgsl_is_error(b)) {
+        return rgsl_expr_error(expr);
+    }
+    if (!rgsl_is_scalar(condition, RGSL_SCALAR_BOOL)) {
+        rgsl_module_error(checker->module, expr->line, "the condition of ?: must be a bool");
+        return rgsl_expr_error(expr);
+    }
+    if (rgsl_converts(expr->operands[2], a)) {
+        rgsl_convert(checker, &expr->operands[2], a);
+    } else if (rgsl_converts(expr->operands[1], b)) {
+        rgsl_convert(checker, &expr->operands[1], b);
+    } else {
+        char left[64];
+        char right[64];
+        rgsl_module_error(checker->module, expr->line, "the branches of ?: have different types, %s and %s", rgsl_type_name(a, left, sizeof(left)), rgsl_type_name(b, right, sizeof(right)));
+        return rgsl_expr_error(expr);
+    }
+    expr->type = expr->operands[1]->type;
+    expr->constant = expr->operands[0]->constant && expr->operands[1]->constant && expr->operands[2]->constant;
+    if (expr->constant && rgsl_has_value(expr->operands[0]) && rgsl_has_value(expr->operands[1]) && rgsl_has_value(expr->operands[2])) {
+        expr->value = expr->operands[0]->value.b ? expr->operands[1]->value : expr->operands[2]->value;
+    }
+    return expr->type;
+}
+
+static bool rgsl_check_arguments(struct rgsl_checker* checker, struct rgsl_expr* expr, bool* out_constant) {
+    bool valid = true;
+    *out_constant = true;
+    for (uint32_t i = 0; i < expr->argument_count; i++) {
+        const struct rgsl_type* type = rgsl_check_expr(checker, expr->arguments[i]);
+        valid = valid && !rgsl_is_error(type);
+        *out_constant = *out_constant && expr->arguments[i]->constant;
+    }
+    return valid;
+}
+
+static void rgsl_report_no_overload(struct rgsl_checker* checker, const struct rgsl_expr* expr, const char* what) {
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    for (uint32_t i = 0; i < expr->argument_count; i++) {
+        if (i > 0) {
+            rgsl_text_append(&text, ", ", 2);
+        }
+        rgsl_type_write(&text, expr->arguments[i]->type);
+    }
+    rgsl_module_error(checker->module, expr->line, "no %s %s takes (%s)", what, expr->name, text.data != NULL ? text.data : "");
+    rgsl_text_free(&text);
+}
+
+// Generic overloads meet on scalars, as min(genType, genType) and min(genType, float) do.
+static bool rgsl_same_builtin_match(const struct rgsl_builtin_match* a, const struct rgsl_builtin_match* b, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        if (!rgsl_type_equal(a->parameters[i], b->parameters[i])) {
+            return false;
+        }
+    }
+    return rgsl_type_equal(a->result, b->result);
+}
+
+static const struct rgsl_type* rgsl_check_builtin_call(struct rgsl_checker* checker, struct rgsl_expr* expr, bool constant) {
+    size_t count = 0;
+    const struct rgsl_builtin_function* functions = rgsl_find_builtin_functions(expr->name, &count);
+    const struct rgsl_type* arguments[4];
+    if (expr->argument_count > 4) {
+        rgsl_report_no_overload(checker, expr, "built-in function");
+        return rgsl_expr_error(expr);
+    }
+    for (uint32_t i = 0; i < expr->argument_count; i++) {
+        arguments[i] = expr->arguments[i]->type;
+    }
+    const struct rgsl_builtin_function* best = NULL;
+    struct rgsl_builtin_match best_match = {0};
+    bool ambiguous = false;
+    for (size_t i = 0; i < count; i++) {
+        struct rgsl_builtin_match match;
+        if (!rgsl_match_builtin_function(&functions[i], arguments, expr->argument_count, &match)) {
+            continue;
+        }
+        if (best == NULL || match.cost < best_match.cost) {
+            best = &functions[i];
+            best_match = match;
+            ambiguous = false;
+        } else if (match.cost == best_match.cost && !rgsl_same_builtin_match(&match, &best_match, expr->argument_count)) {
+            ambiguous = true;
+        }
+    }
+    if (best == NULL || ambiguous) {
+        rgsl_report_no_overload(checker, expr, ambiguous ? "single built-in function" : "built-in function");
+        return rgsl_expr_error(expr);
+    }
+    struct rgsl_module* module = checker->module;
+    if ((best->flags & RGSL_BUILTIN_FRAGMENT_ONLY) && strcmp(module->stage, "frag") != 0) {
+        rgsl_module_error(module, expr->line, "%s is only available in fragment shaders", expr->name);
+        return rgsl_expr_error(expr);
+    }
+    rgsl_module_require(module, best->name, best->desktop_version, best->es_version);
+    for (uint32_t i = 0; i < expr->argument_count; i++) {
+        rgsl_convert(checker, &expr->arguments[i], best_match.parameters[i]);
+    }
+    expr->builtin = best;
+    expr->type = best_match.result;
+    // Built-in functions of constants are constant expressions, except texture lookups.
+    expr->constant = constant && expr->argument_count > 0 && arguments[0]->kind != RGSL_TYPE_SAMPLER;
+    return expr->type;
+}
+
+static const struct rgsl_type* rgsl_check_call(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    bool constant;
+    if (!rgsl_check_arguments(checker, expr, &constant)) {
+        return rgsl_expr_error(expr);
+    }
+    const struct rgsl_scope_entry* entry = rgsl_scope_lookup(checker, expr->name);
+    if (entry == NULL) {
+        size_t count = 0;
+        if (rgsl_find_builtin_functions(expr->name, &count) == NULL) {
+            rgsl_module_error(checker->module, expr->line, "function %s is not declared", expr->name);
+            return rgsl_expr_error(expr);
+        }
+        return rgsl_check_builtin_call(checker, expr, constant);
+    }
+    if (entry->function == NULL) {
+        rgsl_module_error(checker->module, expr->line, "%s is not a function", expr->name);
+        return rgsl_expr_error(expr);
+    }
+    struct rgsl_function* best = NULL;
+    uint32_t best_cost = UINT32_MAX;
+    bool ambiguous = false;
+    for (struct rgsl_function* function = entry->function; function != NULL; function = function->next_overload) {
+        if (function->parameter_count != expr->argument_count) {
+            continue;
+        }
+        uint32_t cost = 0;
+        uint32_t i = 0;
+        for (; i < function->parameter_count; i++) {
+            const struct rgsl_variable* parameter = function->parameters[i];
+            const struct rgsl_expr* argument = expr->arguments[i];
+            if (rgsl_type_equal(argument->type, parameter->type)) {
+                continue;
+            }
+            // Outputs are copied back into the argument, so they take no conversion.
+            if (parameter->direction != RGSL_DIRECTION_IN || !rgsl_converts(argument, parameter->type)) {
+                break;
+            }
+            cost++;
+        }
+        if (i < function->parameter_count) {
+            continue;
+        }
+        if (cost < best_cost) {
+            best = function;
+            best_cost = cost;
+            ambiguous = false;
+        } else if (cost == best_cost) {
+            ambiguous = true;
+        }
+    }
+    if (best == NULL || ambiguous) {
+        rgsl_report_no_overload(checker, expr, ambiguous ? "single overload of" : "overload of");
+        return rgsl_expr_error(expr);
+    }
+    for (uint32_t i = 0; i < best->parameter_count; i++) {
+        if (best->parameters[i]->direction != RGSL_DIRECTION_IN) {
+            if (!rgsl_check_lvalue(checker, expr->arguments[i])) {
+                return rgsl_expr_error(expr);
+            }
+        } else {
+            rgsl_convert(checker, &expr->arguments[i], best->parameters[i]->type);
+        }
+    }
+    expr->function = best;
+    expr->type = best->return_type;
+    return expr->type;
+}
+
+static uint32_t rgsl_component_count(const struct rgsl_type* type) {
+    switch (type->kind) {
+        case RGSL_TYPE_SCALAR: return 1;
+        case RGSL_TYPE_VECTOR: return type->rows;
+        case RGSL_TYPE_MATRIX: return type->columns * type->rows;
+        default: return 0;
+    }
+}
+
+static const struct rgsl_type* rgsl_check_construct(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    bool constant;
+    if (!rgsl_check_arguments(checker, expr, &constant) || !rgsl_resolve_type(checker, expr->type, expr->line)) {
+        return rgsl_expr_error(expr);
+    }
+    const struct rgsl_type* type = expr->type;
+    struct rgsl_module* module = checker->module;
+    char name[64];
+    rgsl_type_name(type, name, sizeof(name));
+    expr->constant = constant;
+    if (type->kind == RGSL_TYPE_ARRAY) {
+        struct rgsl_type* array = (struct rgsl_type *)type;
+        if (array->array_size == 0) {
+            array->array_size = expr->argument_count;
+        }
+        if (expr->argument_count != array->array_size) {
+            rgsl_module_error(module, expr->line, "%s is constructed from %u elements", name, expr->argument_count);
+            return rgsl_expr_error(expr);
+        }
+        for (uint32_t i = 0; i < expr->argument_count; i++) {
+            if (!rgsl_converts(expr->arguments[i], array->element)) {
+                rgsl_module_error(module, expr->line, "element %u of %s has the wrong type", i, name);
+                return rgsl_expr_error(expr);
+            }
+            rgsl_convert(checker, &expr->arguments[i], array->element);
+        }
+        return type;
+    }
+    if (type->kind == RGSL_TYPE_STRUCT) {
+        const struct rgsl_struct_decl* structure = type->structure;
+        if (expr->argument_count != structure->field_count) {
+            rgsl_module_error(module, expr->line, "%s has %u members, not %u", name, structure->field_count, expr->argument_count);
+            return rgsl_expr_error(expr);
+        }
+        for (uint32_t i = 0; i < expr->argument_count; i++) {
+            if (!rgsl_converts(expr->arguments[i], structure->fields[i].type)) {
+                rgsl_module_error(module, expr->line, "member %s of %s has the wrong type", structure->fields[i].name, name);
+                return rgsl_expr_error(expr);
+            }
+            rgsl_convert(checker, &expr->arguments[i], structure->fields[i].type);
+        }
+        return type;
+    }
+    if (type->kind != RGSL_TYPE_SCALAR && type->kind != RGSL_TYPE_VECTOR && type->kind != RGSL_TYPE_MATRIX) {
+        rgsl_module_error(module, expr->line, "%s values cannot be constructed", name);
+        return rgsl_expr_error(expr);
+    }
+    if (expr->argument_count == 0) {
+        rgsl_module_error(module, expr->line, "%s is constructed from nothing", name);
+        return rgsl_expr_error(expr);
+    }
+    uint32_t needed = rgsl_component_count(type);
+    uint32_t given = 0;
+    for (uint32_t i = 0; i < expr->argument_count; i++) {
+        const struct rgsl_type* argument = expr->arguments[i]->type;
+        uint32_t components = rgsl_component_count(argument);
+        if (components == 0) {
+            char argument_name[64];
+            rgsl_module_error(module, expr->line, "%s cannot be constructed from %s", name, rgsl_type_name(argument, argument_name, sizeof(argument_name)));
+            return rgsl_expr_error(expr);
+        }
+        if (given >= needed) {
+            rgsl_module_error(module, expr->line, "too many arguments to construct %s", name);
+            return rgsl_expr_error(expr);
+        }
+        if (type->kind == RGSL_TYPE_MATRIX && argument->kind == RGSL_TYPE_MATRIX && expr->argument_count > 1) {
+            rgsl_module_error(module, expr->line, "a matrix is constructed from a single matrix");
+            return rgsl_expr_error(expr);
+        }
+        given += components;
+    }
+    // A single scalar fills a vector, or the diagonal of a matrix, and a single matrix resizes to another.
+    const struct rgsl_type* first = expr->arguments[0]->type;
+    bool single = expr->argument_count == 1 && (first->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_SCALAR ||
+                                                 (type->kind == RGSL_TYPE_MATRIX && first->kind == RGSL_TYPE_MATRIX));
+    if (!single && given < needed) {
+        rgsl_module_error(module, expr->line, "not enough arguments to construct %s", name);
+        return rgsl_expr_error(expr);
+    }
+    if (type->kind == RGSL_TYPE_SCALAR && rgsl_has_value(expr->arguments[0])) {
+        expr->value = rgsl_convert_value(expr->arguments[0]->value, expr->arguments[0]->type->scalar, type->scalar);
+    }
+    return type;
+}
+
+static const struct rgsl_type* rgsl_check_index(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* base = rgsl_check_expr(checker, expr->operands[0]);
+    const struct rgsl_type* index = rgsl_check_expr(checker, expr->operands[1]);
+    if (rgsl_is_error(base) || rgsl_is_error(index)) {
+        return rgsl_expr_error(expr);
+    }
+    if (!rgsl_is_scalar(index, RGSL_SCALAR_INT) && !rgsl_is_scalar(index, RGSL_SCALAR_UINT)) {
+        rgsl_module_error(checker->module, expr->line, "indices must be int or uint scalars");
+        return rgsl_expr_error(expr);
+    }
+    uint32_t size;
+    switch (base->kind) {
+        case RGSL_TYPE_ARRAY:
+            expr->type = base->element;
+            size = (base->array_size == RGSL_RUNTIME_ARRAY) ? 0 : base->array_size;
+            if (rgsl_is_opaque(base->element) && !expr->operands[1]->constant) {
+                // Dynamically uniform sampler indexing is a GLSL 4.00 feature, missing from ES 3.x.
+                rgsl_module_require(checker->module, "sampler arrays indexed by variables", 400, 320);
+            }
+            break;
+        case RGSL_TYPE_VECTOR:
+            expr->type = rgsl_vector_type(base->scalar, 1);
+            size = base->rows;
+            break;
+        case RGSL_TYPE_MATRIX:
+            expr->type = rgsl_vector_type(RGSL_SCALAR_FLOAT, base->rows);
+            size = base->columns;
+            break;
+        default: {
+            char name[64];
+            rgsl_module_error(checker->module, expr->line, "%s cannot be indexed", rgsl_type_name(base, name, sizeof(name)));
+            return rgsl_expr_error(expr);
+        }
+    }
+    const struct rgsl_expr* index_expr = expr->operands[1];
+    if (rgsl_has_value(index_expr) && size != 0 && (index_expr->value.u >= size)) {
+        rgsl_module_error(checker->module, expr->line, "index %d is out of bounds [0, %u)", index_expr->value.i, size);
+        return rgsl_expr_error(expr);
+    }
+    expr->constant = expr->operands[0]->constant && index_expr->constant;
+    return expr->type;
+}
+
+static const struct rgsl_type* rgsl_check_field(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* base = rgsl_check_expr(checker, expr->operands[0]);
+    if (rgsl_is_error(base)) {
+        return rgsl_expr_error(expr);
+    }
+    char name[64];
+    if (base->kind == RGSL_TYPE_STRUCT) {
+        const struct rgsl_struct_decl* structure = base->structure;
+        for (uint32_t i = 0; i < structure->field_count; i++) {
+            if (structure->fields[i].name == expr->name) {
+                expr->field = i;
+                expr->type = structure->fields[i].type;
+                expr->constant = expr->operands[0]->constant;
+                return expr->type;
+            }
+        }
+        rgsl_module_error(checker->module, expr->line, "%s has no member %s", structure->name, expr->name);
+        return rgsl_expr_error(expr);
+    }
+    if (base->kind != RGSL_TYPE_VECTOR) {
+        rgsl_module_error(checker->module, expr->line, "%s has no member %s", rgsl_type_name(base, name, sizeof(name)), expr->name);
+        return rgsl_expr_error(expr);
+    }
+    size_t count = strlen(expr->name);
+    const char* set = NULL;
+    for (size_t s = 0; s < sizeof(SWIZZLE_SETS) / sizeof(SWIZZLE_SETS[0]) && set == NULL; s++) {
+        if (strchr(SWIZZLE_SETS[s], expr->name[0]) != NULL) {
+            set = SWIZZLE_SETS[s];
+        }
+    }
+    bool valid = set != NULL && count <= 4;
+    for (size_t i = 0; valid && i < count; i++) {
+        const char* component = strchr(set, expr->name[i]);
+        valid = component != NULL && (uint32_t)(component - set) < base->rows;
+        if (valid) {
+            expr->swizzle[i] = (uint8_t)(component - set);
+        }
+    }
+    if (!valid) {
+        rgsl_module_error(checker->module, expr->line, "invalid swizzle .%s of %s", expr->name, rgsl_type_name(base, name, sizeof(name)));
+        return rgsl_expr_error(expr);
+    }
+    expr->kind = RGSL_EXPR_SWIZZLE;
+    expr->swizzle_count = (uint32_t)count;
+    expr->type = rgsl_vector_type(base->scalar, (uint32_t)count);
+    expr->constant = expr->operands[0]->constant;
+    return expr->type;
+}
+
+static const struct rgsl_type* rgsl_check_length(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    const struct rgsl_type* base = rgsl_check_expr(checker, expr->operands[0]);
+    if (rgsl_is_error(base)) {
+        return rgsl_expr_error(expr);
+    }
+    if (base->kind != RGSL_TYPE_ARRAY) {
+        char name[64];
+        rgsl_module_error(checker->module, expr->line, "length() applies to arrays, not to %s", rgsl_type_name(base, name, sizeof(name)));
+        return rgsl_expr_error(expr);
+    }
+    expr->type = rgsl_builtin_type(RGSL_BUILTIN_INT);
+    if (base->array_size != RGSL_RUNTIME_ARRAY) {
+        expr->constant = true;
+        expr->value.i = (int32_t)base->array_size;
+    }
+    return expr->type;
+}
+
+static const struct rgsl_type* rgsl_check_expr(struct rgsl_checker* checker, struct rgsl_expr* expr) {
+    switch (expr->kind) {
+        case RGSL_EXPR_LITERAL:
+            expr->constant = true;
+            switch (expr->op) {
+                case RGSL_TOKEN_FLOAT_LITERAL: expr->type = rgsl_builtin_type(RGSL_BUILTIN_FLOAT); break;
+                case RGSL_TOKEN_UINT_LITERAL: expr->type = rgsl_builtin_type(RGSL_BUILTIN_UINT); break;
+                case RGSL_TOKEN_INT_LITERAL: expr->type = rgsl_builtin_type(RGSL_BUILTIN_INT); break;
+                default: expr->type = rgsl_builtin_type(RGSL_BUILTIN_BOOL); break;
+            }
+            return expr->type;
+        case RGSL_EXPR_VARIABLE:
+            return rgsl_check_variable(checker, expr);
+        case RGSL_EXPR_UNARY:
+            return rgsl_check_unary(checker, expr);
+        case RGSL_EXPR_BINARY:
+            return rgsl_check_binary(checker, expr);
+        case RGSL_EXPR_ASSIGN:
+            return rgsl_check_assign(checker, expr);
+        case RGSL_EXPR_CONDITIONAL:
+            return rgsl_check_conditional(checker, expr);
+        case RGSL_EXPR_SEQUENCE:
+            if (rgsl_is_error(rgsl_check_expr(checker, expr->operands[0]))) {
+                return rgsl_expr_error(expr);
+            }
+            expr->type = rgsl_check_expr(checker, expr->operands[1]);
+            return expr->type;
+        case RGSL_EXPR_CALL:
+            return rgsl_check_call(checker, expr);
+        case RGSL_EXPR_CONSTRUCT:
+            return rgsl_check_construct(checker, expr);
+        case RGSL_EXPR_INDEX:
+            return rgsl_check_index(checker, expr);
+        case RGSL_EXPR_FIELD:
+            return rgsl_check_field(checker, expr);
+        case RGSL_EXPR_LENGTH:
+            return rgsl_check_length(checker, expr);
+        default:
+            // Swizzles and conversions are only created by the checker, already typed.
+            return expr->type;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Declarations and statements                                                */
+/* -------------------------------------------------------------------------- */
+
+static bool rgsl_check_condition(struct rgsl_checker* checker, struct rgsl_expr* expr, const char* statement) {
+    const struct rgsl_type* type = rgsl_check_expr(checker, expr);
+    if (rgsl_is_error(type)) {
+        return false;
+    }
+    if (!rgsl_is_scalar(type, RGSL_SCALAR_BOOL)) {
+        rgsl_module_error(checker->module, expr->line, "the condition of %s must be a bool", statement);
+        return false;
+    }
+    return true;
+}
+
+// Checks the initializer of a variable, and sizes it if it is an unsized array.
+static bool rgsl_check_initializer(struct rgsl_checker* checker, struct rgsl_variable* variable) {
+    struct rgsl_module* module = checker->module;
+    if (variable->initializer == NULL) {
+        if (variable->is_const) {
+            rgsl_module_error(module, variable->line, "constant %s has no initializer", variable->name);
+            return false;
+        }
+        if (rgsl_is_unsized(variable->type)) {
+            rgsl_module_error(module, variable->line, "array %s has no size", variable->name);
+            return false;
+        }
+        return true;
+    }
+    const struct rgsl_type* type = rgsl_check_expr(checker, variable->initializer);
+    if (rgsl_is_error(type)) {
+        return false;
+    }
+    if (variable->type->kind == RGSL_TYPE_ARRAY && variable->type->array_size == 0 && type->kind == RGSL_TYPE_ARRAY) {
+        ((struct rgsl_type *)variable->type)->array_size = type->array_size;
+    }
+    if (!rgsl_converts(variable->initializer, variable->type)) {
+        char left[64];
+        char right[64];
+        rgsl_module_error(module, variable->line, "cannot initialize %s of type %s with %s", variable->name,
+                          rgsl_type_name(variable->type, left, sizeof(left)), rgsl_type_name(type, right, sizeof(right)));
+        return false;
+    }
+    rgsl_convert(checker, &variable->initializer, variable->type);
+    if (variable->is_const) {
+        if (!variable->initializer->constant) {
+            rgsl_module_error(module, variable->line, "constant %s is not initialized with a constant expression", variable->name);
+            return false;
+        }
+        variable->constant = true;
+        variable->value = variable->initializer->value;
+    }
+    return true;
+}
+
+static bool rgsl_declare_variable(struct rgsl_checker* checker, struct rgsl_variable* variable) {
+    struct rgsl_scope_entry* entry = rgsl_scope_declare(checker, variable->name, variable->line);
+    if (entry == NULL) {
+        return false;
+    }
+    entry->variable = variable;
+    return true;
+}
+
+static void rgsl_check_statement(struct rgsl_checker* checker, struct rgsl_stmt* stmt);
+
+static void rgsl_check_statements(struct rgsl_checker* checker, struct rgsl_stmt* first) {
+    for (struct rgsl_stmt* stmt = first; stmt != NULL; stmt = stmt->next) {
+        rgsl_check_statement(checker, stmt);
+    }
+}
+
+static void rgsl_check_local(struct rgsl_checker* checker, struct rgsl_variable* variable) {
+    struct rgsl_module* module = checker->module;
+    if (!rgsl_resolve_type(checker, variable->type, variable->line)) {
+        return;
+    }
+    if (rgsl_type_contains(variable->type, rgsl_is_opaque)) {
+        rgsl_module_error(module, variable->line, "local variable %s cannot hold a sampler", variable->name);
+        return;
+    }
+    // A wrong initializer still declares the variable, so its uses are not reported too.
+    rgsl_check_initializer(checker, variable);
+    rgsl_declare_variable(checker, variable);
+}
+
+static void rgsl_check_switch(struct rgsl_checker* checker, struct rgsl_stmt* stmt) {
+    struct rgsl_module* module = checker->module;
+    const struct rgsl_type* selector = rgsl_check_expr(checker, stmt->expr);
+    if (rgsl_is_error(selector)) {
+        return;
+    }
+    if (!rgsl_is_scalar(selector, RGSL_SCALAR_INT) && !rgsl_is_scalar(selector, RGSL_SCALAR_UINT)) {
+        rgsl_module_error(module, stmt->line, "switch selectors must be int or uint scalars");
+        return;
+    }
+    struct rgsl_stmt* body = stmt->body->body;
+    if (body != NULL && body->kind != RGSL_STMT_CASE && body->kind != RGSL_STMT_DEFAULT) {
+        rgsl_module_error(module, body->line, "the first statement of a switch must be a case label");
+    }
+    size_t mark = rgsl_scope_push(checker);
+    checker->switch_depth++;
+    bool has_default = false;
+    for (struct rgsl_stmt* child = body; child != NULL; child = child->next) {
+        if (child->kind == RGSL_STMT_DEFAULT) {
+            if (has_default) {
+                rgsl_module_error(module, child->line, "switch with two default labels");
+            }
+            has_default = true;
+            continue;
+        }
+        if (child->kind != RGSL_STMT_CASE) {
+            rgsl_check_statement(checker, child);
+            continue;
+        }
+        const struct rgsl_type* label = rgsl_check_expr(checker, child->expr);
+        if (rgsl_is_error(label)) {
+            continue;
+        }
+        if (!rgsl_converts(child->expr, selector) || label->kind != RGSL_TYPE_SCALAR || label->scalar == RGSL_SCALAR_FLOAT || !rgsl_has_value(child->expr)) {
+            rgsl_module_error(module, child->line, "case labels must be constants of the type of the selector");
+            continue;
+        }
+        rgsl_convert(checker, &child->expr, selector);
+        for (struct rgsl_stmt* other = body; other != child; other = other->next) {
+            if (other->kind == RGSL_STMT_CASE && rgsl_has_value(other->expr) && other->expr->type == selector && other->expr->value.u == child->expr->value.u) {
+                rgsl_module_error(module, child->line, "duplicate case label %d", child->expr->value.i);
+                break;
+            }
+        }
+    }
+    checker->switch_depth--;
+    rgsl_scope_pop(checker, mark);
+}
+
+static void rgsl_check_loop_body(struct rgsl_checker* checker, struct rgsl_stmt* body) {
+    // Switches inside a loop body are still left by break, while continue goes to the loop.
+    uint32_t switch_depth = checker->switch_depth;
+    checker->switch_depth = 0;
+    checker->loop_depth++;
+    rgsl_check_statement(checker, body);
+    checker->loop_depth--;
+    checker->switch_depth = switch_depth;
+}
+
+static void rgsl_check_statement(struct rgsl_checker* checker, struct rgsl_stmt* stmt) {
+    struct rgsl_module* module = checker->module;
+    switch (stmt->kind) {
+        case RGSL_STMT_BLOCK: {
+            size_t mark = rgsl_scope_push(checker);
+            rgsl_check_statements(checker, stmt->body);
+            rgsl_scope_pop(checker, mark);
+            break;
+        }
+        case RGSL_STMT_DECLARATION:
+            rgsl_check_local(checker, stmt->variable);
+            break;
+        case RGSL_STMT_EXPRESSION:
+            rgsl_check_expr(checker, stmt->expr);
+            break;
+        case RGSL_STMT_IF:
+            rgsl_check_condition(checker, stmt->expr, "if");
+            rgsl_check_statement(checker, stmt->body);
+            if (stmt->else_branch != NULL) {
+                rgsl_check_statement(checker, stmt->else_branch);
+            }
+            break;
+        case RGSL_STMT_FOR: {
+            size_t mark = rgsl_scope_push(checker);
+            rgsl_check_statements(checker, stmt->init);
+            if (stmt->expr != NULL) {
+                rgsl_check_condition(checker, stmt->expr, "for");
+            }
+            if (stmt->step != NULL) {
+                rgsl_check_expr(checker, stmt->step);
+            }
+            rgsl_check_loop_body(checker, stmt->body);
+            rgsl_scope_pop(checker, mark);
+            break;
+        }
+        case RGSL_STMT_WHILE:
+        case RGSL_STMT_DO_WHILE:
+            rgsl_check_condition(checker, stmt->expr, stmt->kind == RGSL_STMT_WHILE ? "while" : "do-while");
+            rgsl_check_loop_body(checker, stmt->body);
+            break;
+        case RGSL_STMT_SWITCH:
+            rgsl_check_switch(checker, stmt);
+            break;
+        case RGSL_STMT_CASE:
+        case RGSL_STMT_DEFAULT:
+            rgsl_module_error(module, stmt->line, "%s label outside of a switch", stmt->kind == RGSL_STMT_CASE ? "case" : "default");
+            break;
+        case RGSL_STMT_BREAK:
+            if (checker->loop_depth == 0 && checker->switch_depth == 0) {
+                rgsl_module_error(module, stmt->line, "break outside of a loop or a switch");
+            }
+            break;
+        case RGSL_STMT_CONTINUE:
+            if (checker->loop_depth == 0) {
+                rgsl_module_error(module, stmt->line, "continue outside of a loop");
+            }
+            break;
+        case RGSL_STMT_DISCARD:
+            if (strcmp(module->stage, "frag") != 0) {
+                rgsl_module_error(module, stmt->line, "discard is only available in fragment shaders");
+            }
+            break;
+        case RGSL_STMT_RETURN: {
+            const struct rgsl_type* expected = checker->function->return_type;
+            bool returns_void = expected->kind == RGSL_TYPE_VOID;
+            if (stmt->expr == NULL) {
+                if (!returns_void) {
+                    rgsl_module_error(module, stmt->line, "%s must return a value", checker->function->name);
+                }
+                break;
+            }
+            const struct rgsl_type* type = rgsl_check_expr(checker, stmt->expr);
+            if (rgsl_is_error(type)) {
+                break;
+            }
+            if (returns_void || !rgsl_converts(stmt->expr, expected)) {
+                char left[64];
+                char right[64];
+                rgsl_module_error(module, stmt->line, "%s returns %s, not %s", checker->function->name,
+                                  rgsl_type_name(expected, left, sizeof(left)), rgsl_type_name(type, right, sizeof(right)));
+                break;
+            }
+            rgsl_convert(checker, &stmt->expr, expected);
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+static bool rgsl_is_varying(const struct rgsl_module* module, const struct rgsl_variable* variable) {
+    return (variable->storage == RGSL_STORAGE_OUT && strcmp(module->stage, "vert") == 0) ||
+           (variable->storage == RGSL_STORAGE_IN && strcmp(module->stage, "frag") == 0);
+}
+
+static void rgsl_check_interface(struct rgsl_checker* checker, struct rgsl_variable* variable) {
+    struct rgsl_module* module = checker->module;
+    const char* stage = module->stage;
+    const char* direction = (variable->storage == RGSL_STORAGE_IN) ? "input" : "output";
+    if (strcmp(stage, "comp") == 0) {
+        rgsl_module_error(module, variable->line, "compute shaders have no %s variable, %s", direction, variable->name);
+        return;
+    }
+    if (rgsl_type_contains(variable->type, rgsl_is_opaque) || rgsl_type_contains(variable->type, rgsl_is_bool) || variable->type->kind == RGSL_TYPE_STRUCT) {
+        rgsl_module_error(module, variable->line, "%s %s cannot hold samplers, bools or structures", direction, variable->name);
+        return;
+    }
+    bool varying = rgsl_is_varying(module, variable);
+    if (varying && rgsl_type_contains(variable->type, rgsl_is_integer_or_bool) && variable->interpolation != RGSL_INTERPOLATION_FLAT) {
+        rgsl_module_error(module, variable->line, "integer %s %s must be flat", direction, variable->name);
+    }
+    if (!varying && variable->interpolation != RGSL_INTERPOLATION_NONE) {
+        rgsl_module_error(module, variable->line, "%s %s is not interpolated", direction, variable->name);
+    }
+    if (variable->interpolation == RGSL_INTERPOLATION_NOPERSPECTIVE) {
+        rgsl_module_require(module, "noperspective", 130, 0);
+    }
+    if (variable->storage == RGSL_STORAGE_IN && strcmp(stage, "vert") == 0 && variable->type->kind == RGSL_TYPE_ARRAY) {
+        rgsl_module_error(module, variable->line, "vertex input %s cannot be an array", variable->name);
+    }
+    if (variable->storage == RGSL_STORAGE_OUT && strcmp(stage, "frag") == 0) {
+        checker->fragment_outputs++;
+        checker->fragment_outputs_located += (variable->layout.location >= 0) ? 1 : 0;
+    }
+    // Locations of vertex inputs and fragment outputs are core in GLSL 3.30; those of varyings are dropped when missing.
+    if (variable->layout.location >= 0 && !varying) {
+        rgsl_module_require(module, "explicit attribute locations", 330, 300);
+    }
+}
+
+static void rgsl_check_global_variable(struct rgsl_checker* checker, struct rgsl_variable* variable) {
+    struct rgsl_module* module = checker->module;
+    if (!rgsl_resolve_type(checker, variable->type, variable->line)) {
+        return;
+    }
+    const struct rgsl_layout_qualifiers* layout = &variable->layout;
+    bool opaque = rgsl_type_contains(variable->type, rgsl_is_opaque);
+    switch (variable->storage) {
+        case RGSL_STORAGE_IN:
+        case RGSL_STORAGE_OUT:
+            rgsl_check_interface(checker, variable);
+            break;
+        case RGSL_STORAGE_UNIFORM:
+            if (layout->location >= 0) {
+                rgsl_module_require(module, "uniform locations", 430, 310);
+            }
+            if (layout->binding >= 0 && !opaque) {
+                rgsl_module_error(module, variable->line, "only samplers and blocks have a binding, %s has one", variable->name);
+            }
+            break;
+        default:
+            if (opaque) {
+                rgsl_module_error(module, variable->line, "sampler %s must be a uniform", variable->name);
+            }
+            if (layout->constant_id >= 0 && (!variable->is_const || variable->type->kind != RGSL_TYPE_SCALAR)) {
+                rgsl_module_error(module, variable->line, "specialization constant %s must be a const scalar", variable->name);
+            }
+            break;
+    }
+    if (variable->storage != RGSL_STORAGE_GLOBAL && variable->is_const) {
+        rgsl_module_error(module, variable->line, "const %s cannot also be an interface variable", variable->name);
+    }
+    if (variable->storage != RGSL_STORAGE_GLOBAL && variable->initializer != NULL) {
+        rgsl_module_error(module, variable->line, "%s is initialized by the application, not by the shader", variable->name);
+        return;
+    }
+    if ((layout->binding >= 0 || layout->packing >= 0) && variable->storage != RGSL_STORAGE_UNIFORM) {
+        rgsl_module_error(module, variable->line, "%s cannot have a binding nor a packing", variable->name);
+    }
+    if (layout->location >= 0 && variable->storage != RGSL_STORAGE_IN && variable->storage != RGSL_STORAGE_OUT && variable->storage != RGSL_STORAGE_UNIFORM) {
+        rgsl_module_error(module, variable->line, "%s cannot have a location", variable->name);
+    }
+    if (!rgsl_check_initializer(checker, variable)) {
+        return;
+    }
+    if (variable->initializer != NULL && !variable->initializer->constant) {
+        // Global initializers run before main in desktop GLSL, but are constant expressions in GLSL ES.
+        rgsl_module_error(module, variable->line, "global %s must be initialized with a constant expression", variable->name);
+    }
+    rgsl_declare_variable(checker, variable);
+}
+
+static bool rgsl_check_fields(struct rgsl_checker* checker, const struct rgsl_struct_decl* structure, bool buffer) {
+    bool valid = true;
+    for (uint32_t i = 0; i < structure->field_count; i++) {
+        struct rgsl_field* field = &structure->fields[i];
+        if (!rgsl_resolve_type(checker, field->type, field->line)) {
+            valid = false;
+            continue;
+        }
+        if (rgsl_type_contains(field->type, rgsl_is_opaque)) {
+            rgsl_module_error(checker->module, field->line, "member %s of %s cannot hold a sampler", field->name, structure->name);
+            valid = false;
+        }
+        for (uint32_t j = 0; j < i; j++) {
+            if (structure->fields[j].name == field->name) {
+                rgsl_module_error(checker->module, field->line, "%s has two members named %s", structure->name, field->name);
+                valid = false;
+            }
+        }
+        if (rgsl_is_unsized(field->type)) {
+            if (buffer && i + 1 == structure->field_count) {
+                ((struct rgsl_type *)field->type)->array_size = RGSL_RUNTIME_ARRAY;
+            } else {
+                rgsl_module_error(checker->module, field->line, "only the last member of a buffer block may be an array without size, not %s", field->name);
+                valid = false;
+            }
+        }
+    }
+    return valid;
+}
+
+static void rgsl_check_block(struct rgsl_checker* checker, struct rgsl_block* block) {
+    struct rgsl_module* module = checker->module;
+    bool buffer = block->storage == RGSL_STORAGE_BUFFER;
+    if (buffer) {
+        rgsl_module_require(module, "buffer blocks", 430, 310);
+    }
+    if (block->layout.packing < 0) {
+        block->layout.packing = buffer ? RGSL_LAYOUT_STD430 : RGSL_LAYOUT_STD140;
+    } else if (!buffer && block->layout.packing == RGSL_LAYOUT_STD430) {
+        rgsl_module_error(module, block->members.line, "uniform block %s cannot use std430", block->members.name);
+    }
+    if (block->layout.location >= 0 || block->layout.constant_id >= 0) {
+        rgsl_module_error(module, block->members.line, "block %s can only have a binding and a packing", block->members.name);
+    }
+    if (!buffer && block->memory != 0) {
+        rgsl_module_error(module, block->members.line, "memory qualifiers only apply to buffer blocks, not to %s", block->members.name);
+    }
+    if (!rgsl_check_fields(checker, &block->members, buffer)) {
+        return;
+    }
+    if (block->instance != NULL) {
+        if (!rgsl_resolve_type(checker, block->instance->type, block->instance->line)) {
+            return;
+        }
+        block->instance->memory = block->memory;
+        rgsl_declare_variable(checker, block->instance);
+        return;
+    }
+    // The members of a block without instance name are global variables of their own.
+    block->member_variables = (struct rgsl_variable **)rgsl_arena_alloc(&module->arena, block->members.field_count * sizeof(struct rgsl_variable*));
+    for (uint32_t i = 0; i < block->members.field_count; i++) {
+        const struct rgsl_field* field = &block->members.fields[i];
+        struct rgsl_variable* variable = (struct rgsl_variable *)rgsl_arena_alloc(&module->arena, sizeof(struct rgsl_variable));
+        variable->name = field->name;
+        variable->type = field->type;
+        variable->storage = block->storage;
+        variable->precision = field->precision;
+        variable->memory = block->memory | field->memory;
+        variable->layout.location = variable->layout.binding = variable->layout.constant_id = variable->layout.packing = -1;
+        variable->block = block;
+        variable->member = i;
+        variable->line = field->line;
+        variable->id = module->variable_count++;
+        block->member_variables[i] = variable;
+        rgsl_declare_variable(checker, variable);
+    }
+}
+
+static bool rgsl_same_signature(const struct rgsl_function* a, const struct rgsl_function* b) {
+    if (a->parameter_count != b->parameter_count) {
+        return false;
+    }
+    for (uint32_t i = 0; i < a->parameter_count; i++) {
+        if (!rgsl_type_equal(a->parameters[i]->type, b->parameters[i]->type)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void rgsl_check_function(struct rgsl_checker* checker, struct rgsl_function* function) {
+    struct rgsl_module* module = checker->module;
+    bool valid = rgsl_resolve_type(checker, function->return_type, function->line);
+    for (uint32_t i = 0; i < function->parameter_count; i++) {
+        struct rgsl_variable* parameter = function->parameters[i];
+        valid = rgsl_resolve_type(checker, parameter->type, parameter->line) && valid;
+        if (valid && rgsl_is_unsized(parameter->type)) {
+            rgsl_module_error(module, parameter->line, "parameter %s of %s has no size", parameter->name != NULL ? parameter->name : "", function->name);
+            valid = false;
+        }
+        if (parameter->type->kind == RGSL_TYPE_VOID) {
+            rgsl_module_error(module, parameter->line, "parameter of %s cannot be void", function->name);
+            valid = false;
+        }
+    }
+    if (function->return_type->kind == RGSL_TYPE_ARRAY || rgsl_type_contains(function->return_type, rgsl_is_opaque)) {
+        rgsl_module_error(module, function->line, "%s cannot return arrays nor samplers", function->name);
+        valid = false;
+    }
+    if (!valid) {
+        return;
+    }
+    size_t builtin_count = 0;
+    if (rgsl_find_builtin_functions(function->name, &builtin_count) != NULL) {
+        rgsl_module_error(module, function->line, "%s is a built-in function, it cannot be redeclared", function->name);
+        return;
+    }
+    // Overloads are chained from the first declaration, and prototypes linked to their definition.
+    const struct rgsl_scope_entry* entry = rgsl_scope_lookup(checker, function->name);
+    if (entry != NULL && entry->function == NULL) {
+        rgsl_module_error(module, function->line, "%s is already declared as a variable", function->name);
+        return;
+    }
+    struct rgsl_function* declared = NULL;
+    if (entry != NULL) {
+        struct rgsl_function* last = entry->function;
+        for (struct rgsl_function* other = entry->function; other != NULL; other = other->next_overload) {
+            if (rgsl_same_signature(other, function)) {
+                declared = other;
+            }
+            last = other;
+        }
+        if (declared == NULL) {
+            last->next_overload = function;
+        }
+    } else {
+        struct rgsl_scope_entry* new_entry = rgsl_scope_declare(checker, function->name, function->line);
+        new_entry->function = function;
+    }
+    if (declared != NULL) {
+        if (!rgsl_type_equal(declared->return_type, function->return_type)) {
+            rgsl_module_error(module, function->line, "%s is redeclared with another return type", function->name);
+            return;
+        }
+        for (uint32_t i = 0; i < function->parameter_count; i++) {
+            if (declared->parameters[i]->direction != function->parameters[i]->direction) {
+                rgsl_module_error(module, function->line, "%s is redeclared with other parameter qualifiers", function->name);
+                return;
+            }
+        }
+        if (function->body != NULL) {
+            if (declared->definition != NULL) {
+                rgsl_module_error(module, function->line, "%s is already defined", function->name);
+                return;
+            }
+            // Calls resolved to the prototype reach the definition through it.
+            declared->definition = function;
+        }
+    }
+    if (strcmp(function->name, "main") == 0) {
+        if (function->return_type->kind != RGSL_TYPE_VOID || function->parameter_count != 0) {
+            rgsl_module_error(module, function->line, "main must be declared as void main()");
+        } else if (function->body != NULL) {
+            module->entry_point = function;
+        }
+    }
+    if (function->body == NULL) {
+        return;
+    }
+    size_t mark = rgsl_scope_push(checker);
+    for (uint32_t i = 0; i < function->parameter_count; i++) {
+        if (function->parameters[i]->name != NULL) {
+            rgsl_declare_variable(checker, function->parameters[i]);
+        }
+    }
+    checker->function = function;
+    // The body shares the scope of the parameters, which it cannot redeclare.
+    rgsl_check_statements(checker, function->body->body);
+    checker->function = NULL;
+    rgsl_scope_pop(checker, mark);
+}
+
+bool rgsl_rgsl_check(struct rgsl_module* module) {
+    struct rgsl_checker checker;
+    memset(&checker, 0, sizeof(checker));
+    checker.module = module;
+    for (size_t i = 0; i < RGSL_SCOPE_BUCKETS; i++) {
+        checker.buckets[i] = -1;
+    }
+    uint32_t errors = module->error_count;
+    bool compute = strcmp(module->stage, "comp") == 0;
+    if (compute) {
+        rgsl_module_require(module, "compute shaders", 430, 310);
+    }
+    for (struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        switch (global->kind) {
+            case RGSL_GLOBAL_VARIABLE:
+                rgsl_check_global_variable(&checker, global->variable);
+                break;
+            case RGSL_GLOBAL_STRUCT:
+                rgsl_check_fields(&checker, global->structure, false);
+                break;
+            case RGSL_GLOBAL_BLOCK:
+                rgsl_check_block(&checker, global->block);
+                break;
+            case RGSL_GLOBAL_FUNCTION:
+                rgsl_check_function(&checker, global->function);
+                break;
+            case RGSL_GLOBAL_LAYOUT:
+                if (!compute) {
+                    rgsl_module_error(module, global->line, "only compute shaders declare a local size");
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    if (compute && module->local_size[0] == 0) {
+        rgsl_module_error(module, 1, "compute shaders must declare their local size, e.g. layout(local_size_x = 64) in;");
+    }
+    if (checker.fragment_outputs > 1 && checker.fragment_outputs_located != checker.fragment_outputs) {
+        rgsl_module_error(module, 1, "fragment shaders with several outputs must give each one a location");
+    }
+    if (module->entry_point == NULL && module->error_count == errors) {
+        rgsl_module_error(module, 1, "%s defines no void main()", module->path);
+    }
+    rgsl_free(checker.entries);
+    return module->error_count == errors;
+}
\ No newline at end of file
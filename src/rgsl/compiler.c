@@ -1,7 +1,25 @@
 #include <RGSL/rgsl/compile.h>
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/rgsl/glsl.h>
 #include <RGSL/termio.h>
+#include <RGSL/text.h>
+#include <RGSL/rgsl.h>
 
 bool rgsl_rgsl_compile_shader(struct rgsl_shader_data * shader, char** output) {
-    rgsl_print_info(1, "RGSL shader compilation not yet implemented.\n");
-    return false;
+    *output = NULL;
+    if (!rgsl_rgsl_build_module(shader) || !rgsl_glsl_choose_profile(shader->module, &shader->requested_profile, &shader->profile)) {
+        return false;
+    }
+    rgsl_printf_info(2, "Emitting %s as GLSL %d %s\n", shader->path, shader->profile.version, shader->profile.name);
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    rgsl_glsl_emit(shader->module, &shader->profile, &text);
+    *output = text.data;
+    return true;
+}
+
+bool rgsl_rgsl_compile_spirv(struct rgsl_shader_data* shader, char** out_words, size_t* out_size) {
+    *out_words = NULL;
+    *out_size = 0;
+    return rgsl_rgsl_build_module(shader) && rgsl_compile_module_spirv(shader, out_words, out_size);
 }
\ No newline at end of file
@@ -0,0 +1,633 @@
+#include <RGSL/rgsl/glsl.h>
+#include <RGSL/termio.h>
+#include <RGSL/spec.h>
+#include <stdio.h>
+#include <string.h>
+
+// Lowest versions emitted, the first ones with in/out variables and layout qualifiers everywhere.
+#define RGSL_GLSL_MIN_DESKTOP_VERSION 330
+#define RGSL_GLSL_MIN_ES_VERSION 300
+
+/**
+ * Feature a shader can do without, dropped when the profile lacks it.
+ */
+struct rgsl_glsl_soft_feature {
+    const char* name;
+    int desktop_version;
+    int es_version;
+};
+
+static const struct rgsl_glsl_soft_feature VARYING_LOCATIONS = {"varying locations", 410, 310};
+static const struct rgsl_glsl_soft_feature BINDINGS = {"bindings", 420, 310};
+
+// Precedences of the expressions, the operands of an expression being parenthesized below its own.
+enum rgsl_glsl_precedence {
+    RGSL_PRECEDENCE_SEQUENCE,
+    RGSL_PRECEDENCE_ASSIGNMENT,
+    RGSL_PRECEDENCE_CONDITIONAL,
+    // Binary operators follow, from rgsl_token_precedence(op) above this one.
+    RGSL_PRECEDENCE_BINARY,
+    RGSL_PRECEDENCE_UNARY = RGSL_PRECEDENCE_BINARY + 12,
+    RGSL_PRECEDENCE_POSTFIX,
+    RGSL_PRECEDENCE_PRIMARY
+};
+
+static const char* const PRECISION_NAMES[] = {"", "lowp", "mediump", "highp"};
+static const char* const INTERPOLATION_NAMES[] = {"", "smooth", "flat", "noperspective"};
+static const char* const MEMORY_NAMES[] = {"readonly", "writeonly", "coherent", "volatile", "restrict"};
+
+struct rgsl_glsl_emitter {
+    struct rgsl_module* module;
+    struct rgsl_text* output;
+    bool es;
+    bool varying_locations;
+    bool bindings;
+    bool spec_constants;
+};
+
+static bool rgsl_profile_is_es(const struct rgsl_shader_profile* profile) {
+    return profile->name != NULL && strcmp(profile->name, "es") == 0;
+}
+
+static bool rgsl_profile_has(const struct rgsl_shader_profile* profile, const struct rgsl_glsl_soft_feature* feature) {
+    return profile->version >= (rgsl_profile_is_es(profile) ? feature->es_version : feature->desktop_version);
+}
+
+static bool rgsl_is_varying(const struct rgsl_module* module, const struct rgsl_variable* variable) {
+    return (variable->storage == RGSL_STORAGE_OUT && strcmp(module->stage, "vert") == 0) ||
+           (variable->storage == RGSL_STORAGE_IN && strcmp(module->stage, "frag") == 0);
+}
+
+// Tells whether the module uses a feature that would be dropped without the given profile.
+static bool rgsl_module_uses(const struct rgsl_module* module, const struct rgsl_glsl_soft_feature* feature) {
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        if (feature == &BINDINGS) {
+            if ((global->kind == RGSL_GLOBAL_VARIABLE && global->variable->layout.binding >= 0) ||
+                (global->kind == RGSL_GLOBAL_BLOCK && global->block->layout.binding >= 0)) {
+                return true;
+            }
+        } else if (global->kind == RGSL_GLOBAL_VARIABLE && global->variable->layout.location >= 0 && rgsl_is_varying(module, global->variable)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool rgsl_glsl_choose_profile(struct rgsl_module* module, const struct rgsl_shader_profile* requested, struct rgsl_shader_profile* out_profile) {
+    if (requested->version == 0) {
+        int version = RGSL_GLSL_MIN_DESKTOP_VERSION;
+        if ((int)module->desktop_version > version) {
+            version = (int)module->desktop_version;
+        }
+        const struct rgsl_glsl_soft_feature* features[] = {&VARYING_LOCATIONS, &BINDINGS};
+        for (size_t i = 0; i < sizeof(features) / sizeof(features[0]); i++) {
+            if (features[i]->desktop_version > version && rgsl_module_uses(module, features[i])) {
+                version = features[i]->desktop_version;
+            }
+        }
+        out_profile->version = version;
+        out_profile->name = "core";
+        return true;
+    }
+    *out_profile = *requested;
+    bool es = rgsl_profile_is_es(requested);
+    int minimum = es ? RGSL_GLSL_MIN_ES_VERSION : RGSL_GLSL_MIN_DESKTOP_VERSION;
+    if (requested->version < minimum) {
+        rgsl_printf_error("%s: RGSL is emitted for GLSL %d and later, not for %d %s.\n", module->path, minimum, requested->version, requested->name);
+        return false;
+    }
+    const char* feature = es ? module->es_feature : module->desktop_feature;
+    int needed = (int)(es ? module->es_version : module->desktop_version);
+    if (feature != NULL && es && needed == 0) {
+        rgsl_printf_error("%s: %s is not available in OpenGL ES.\n", module->path, feature);
+        return false;
+    }
+    if (feature != NULL && needed > requested->version) {
+        rgsl_printf_error("%s: GLSL %d%s is needed for %s, the requested profile is %d %s.\n", module->path, needed, es ? " es" : "", feature, requested->version, requested->name);
+        return false;
+    }
+    return true;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Types and declarations                                                     */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_glsl_append(struct rgsl_glsl_emitter* emitter, const char* text) {
+    rgsl_text_append(emitter->output, text, strlen(text));
+}
+
+static void rgsl_glsl_indent(struct rgsl_glsl_emitter* emitter, uint32_t depth) {
+    for (uint32_t i = 0; i < depth; i++) {
+        rgsl_text_append(emitter->output, "    ", 4);
+    }
+}
+
+// Writes "type name[N][M]", the array sizes following the name as in C.
+static void rgsl_glsl_write_declarator(struct rgsl_glsl_emitter* emitter, const struct rgsl_type* type, const char* name) {
+    const struct rgsl_type* element = type;
+    while (element->kind == RGSL_TYPE_ARRAY) {
+        element = element->element;
+    }
+    rgsl_glsl_append(emitter, element->name);
+    if (name != NULL) {
+        rgsl_text_printf(emitter->output, " %s", name);
+    }
+    for (; type->kind == RGSL_TYPE_ARRAY; type = type->element) {
+        if (type->array_size == RGSL_RUNTIME_ARRAY) {
+            rgsl_glsl_append(emitter, "[]");
+        } else {
+            rgsl_text_printf(emitter->output, "[%u]", type->array_size);
+        }
+    }
+}
+
+static void rgsl_glsl_write_memory(struct rgsl_glsl_emitter* emitter, uint32_t memory) {
+    for (size_t i = 0; i < sizeof(MEMORY_NAMES) / sizeof(MEMORY_NAMES[0]); i++) {
+        if (memory & (1u << i)) {
+            rgsl_text_printf(emitter->output, "%s ", MEMORY_NAMES[i]);
+        }
+    }
+}
+
+static void rgsl_glsl_write_precision(struct rgsl_glsl_emitter* emitter, enum rgsl_precision precision) {
+    if (precision != RGSL_PRECISION_NONE) {
+        rgsl_text_printf(emitter->output, "%s ", PRECISION_NAMES[precision]);
+    }
+}
+
+// Writes the layout qualifiers the profile has, and warns about the bindings it drops.
+static void rgsl_glsl_write_layout(struct rgsl_glsl_emitter* emitter, const struct rgsl_layout_qualifiers* layout, bool varying, const char* name, uint32_t line) {
+    char qualifiers[128];
+    size_t length = 0;
+    qualifiers[0] = '\0';
+    if (layout->packing >= 0) {
+        length += (size_t)snprintf(qualifiers + length, sizeof(qualifiers) - length, ", %s", rgsl_layout_packing_name((enum rgsl_layout_packing)layout->packing));
+    }
+    if (layout->location >= 0 && (!varying || emitter->varying_locations)) {
+        length += (size_t)snprintf(qualifiers + length, sizeof(qualifiers) - length, ", location = %d", layout->location);
+    }
+    if (layout->binding >= 0) {
+        if (emitter->bindings) {
+            length += (size_t)snprintf(qualifiers + length, sizeof(qualifiers) - length, ", binding = %d", layout->binding);
+        } else {
+            rgsl_module_warning(emitter->module, line, "the profile has no binding qualifier, the application must bind %s to unit %d", name, layout->binding);
+        }
+    }
+    if (layout->constant_id >= 0 && emitter->spec_constants) {
+        length += (size_t)snprintf(qualifiers + length, sizeof(qualifiers) - length, ", constant_id = %d", layout->constant_id);
+    }
+    if (length > 0) {
+        rgsl_text_printf(emitter->output, "layout(%s) ", qualifiers + 2);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Expressions                                                                */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_glsl_write_expr(struct rgsl_glsl_emitter* emitter, const struct rgsl_expr* expr, int precedence);
+
+static int rgsl_glsl_precedence(const struct rgsl_expr* expr) {
+    switch (expr->kind) {
+        case RGSL_EXPR_SEQUENCE: return RGSL_PRECEDENCE_SEQUENCE;
+        case RGSL_EXPR_ASSIGN: return RGSL_PRECEDENCE_ASSIGNMENT;
+        case RGSL_EXPR_CONDITIONAL: return RGSL_PRECEDENCE_CONDITIONAL;
+        case RGSL_EXPR_BINARY: return RGSL_PRECEDENCE_BINARY + (int)rgsl_token_precedence(expr->op);
+        case RGSL_EXPR_UNARY: return expr->postfix ? RGSL_PRECEDENCE_POSTFIX : RGSL_PRECEDENCE_UNARY;
+        case RGSL_EXPR_LITERAL:
+        case RGSL_EXPR_VARIABLE: return RGSL_PRECEDENCE_PRIMARY;
+        default: return RGSL_PRECEDENCE_POSTFIX;
+    }
+}
+
+static void rgsl_glsl_write_literal(struct rgsl_glsl_emitter* emitter, const struct rgsl_expr* expr) {
+    if (expr->name != NULL) {
+        uint32_t length = expr->text_length;
+        // GLSL ES has no float suffix.
+        if (expr->op == RGSL_TOKEN_FLOAT_LITERAL && length > 1 && (expr->name[length - 1] == 'f' || expr->name[length - 1] == 'F')) {
+            length--;
+        }
+        rgsl_text_append(emitter->output, expr->name, length);
+        return;
+    }
+    // Literals converted by the checker are written from their value.
+    switch (expr->type->scalar) {
+        case RGSL_SCALAR_FLOAT: {
+            char buffer[32];
+            snprintf(buffer, sizeof(buffer), "%.9g", expr->value.f);
+            rgsl_glsl_append(emitter, buffer);
+            if (strpbrk(buffer, ".e") == NULL) {
+                rgsl_glsl_append(emitter, ".0");
+            }
+            break;
+        }
+        case RGSL_SCALAR_UINT: rgsl_text_printf(emitter->output, "%uu", expr->value.u); break;
+        case RGSL_SCALAR_INT: rgsl_text_printf(emitter->output, "%d", expr->value.i); break;
+        case RGSL_SCALAR_BOOL: rgsl_glsl_append(emitter, expr->value.b ? "true" : "false"); break;
+    }
+}
+
+static void rgsl_glsl_write_arguments(struct rgsl_glsl_emitter* emitter, struct rgsl_expr* const* arguments, uint32_t count) {
+    rgsl_glsl_append(emitter, "(");
+    for (uint32_t i = 0; i < count; i++) {
+        if (i > 0) {
+            rgsl_glsl_append(emitter, ", ");
+        }
+        rgsl_glsl_write_expr(emitter, arguments[i], RGSL_PRECEDENCE_ASSIGNMENT);
+    }
+    rgsl_glsl_append(emitter, ")");
+}
+
+static bool rgsl_is_sign(enum rgsl_token_kind op) {
+    return op == RGSL_TOKEN_PLUS || op == RGSL_TOKEN_MINUS || op == RGSL_TOKEN_PLUS_PLUS || op == RGSL_TOKEN_MINUS_MINUS;
+}
+
+static void rgsl_glsl_write_expr(struct rgsl_glsl_emitter* emitter, const struct rgsl_expr* expr, int precedence) {
+    int own = rgsl_glsl_precedence(expr);
+    bool parenthesized = own < precedence;
+    if (parenthesized) {
+        rgsl_glsl_append(emitter, "(");
+    }
+    switch (expr->kind) {
+        case RGSL_EXPR_LITERAL:
+            rgsl_glsl_write_literal(emitter, expr);
+            break;
+        case RGSL_EXPR_VARIABLE:
+            rgsl_glsl_append(emitter, expr->variable->name);
+            break;
+        case RGSL_EXPR_UNARY:
+            if (expr->postfix) {
+                rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_POSTFIX);
+                rgsl_glsl_append(emitter, rgsl_token_spelling(expr->op));
+                break;
+            }
+            rgsl_glsl_append(emitter, rgsl_token_spelling(expr->op));
+            // "- -x" must not become "--x".
+            if (rgsl_is_sign(expr->op) && expr->operands[0]->kind == RGSL_EXPR_UNARY && !expr->operands[0]->postfix && rgsl_is_sign(expr->operands[0]->op)) {
+                rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_PRIMARY);
+            } else {
+                rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_UNARY);
+            }
+            break;
+        case RGSL_EXPR_BINARY:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], own);
+            rgsl_text_printf(emitter->output, " %s ", rgsl_token_spelling(expr->op));
+            rgsl_glsl_write_expr(emitter, expr->operands[1], own + 1);
+            break;
+        case RGSL_EXPR_ASSIGN:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_UNARY);
+            rgsl_text_printf(emitter->output, " %s ", rgsl_token_spelling(expr->op));
+            rgsl_glsl_write_expr(emitter, expr->operands[1], RGSL_PRECEDENCE_ASSIGNMENT);
+            break;
+        case RGSL_EXPR_CONDITIONAL:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_BINARY + 1);
+            rgsl_glsl_append(emitter, " ? ");
+            rgsl_glsl_write_expr(emitter, expr->operands[1], RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, " : ");
+            rgsl_glsl_write_expr(emitter, expr->operands[2], RGSL_PRECEDENCE_ASSIGNMENT);
+            break;
+        case RGSL_EXPR_SEQUENCE:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ", ");
+            rgsl_glsl_write_expr(emitter, expr->operands[1], RGSL_PRECEDENCE_ASSIGNMENT);
+            break;
+        case RGSL_EXPR_CALL:
+            rgsl_glsl_append(emitter, expr->name);
+            rgsl_glsl_write_arguments(emitter, expr->arguments, expr->argument_count);
+            break;
+        case RGSL_EXPR_CONSTRUCT:
+            rgsl_type_write(emitter->output, expr->type);
+            rgsl_glsl_write_arguments(emitter, expr->arguments, expr->argument_count);
+            break;
+        case RGSL_EXPR_CONVERT:
+            rgsl_type_write(emitter->output, expr->type);
+            rgsl_glsl_write_arguments(emitter, expr->operands, 1);
+            break;
+        case RGSL_EXPR_INDEX:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_POSTFIX);
+            rgsl_glsl_append(emitter, "[");
+            rgsl_glsl_write_expr(emitter, expr->operands[1], RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, "]");
+            break;
+        case RGSL_EXPR_FIELD:
+        case RGSL_EXPR_SWIZZLE:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_POSTFIX);
+            rgsl_text_printf(emitter->output, ".%s", expr->name);
+            break;
+        case RGSL_EXPR_LENGTH:
+            rgsl_glsl_write_expr(emitter, expr->operands[0], RGSL_PRECEDENCE_POSTFIX);
+            rgsl_glsl_append(emitter, ".length()");
+            break;
+    }
+    if (parenthesized) {
+        rgsl_glsl_append(emitter, ")");
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Statements                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_glsl_write_statement(struct rgsl_glsl_emitter* emitter, const struct rgsl_stmt* stmt, uint32_t depth);
+
+static void rgsl_glsl_write_local(struct rgsl_glsl_emitter* emitter, const struct rgsl_variable* variable) {
+    if (variable->is_const) {
+        rgsl_glsl_append(emitter, "const ");
+    }
+    rgsl_glsl_write_precision(emitter, variable->precision);
+    rgsl_glsl_write_declarator(emitter, variable->type, variable->name);
+    if (variable->initializer != NULL) {
+        rgsl_glsl_append(emitter, " = ");
+        rgsl_glsl_write_expr(emitter, variable->initializer, RGSL_PRECEDENCE_ASSIGNMENT);
+    }
+}
+
+// Writes the statements of a block between braces, the opening one ending the current line.
+static void rgsl_glsl_write_block(struct rgsl_glsl_emitter* emitter, const struct rgsl_stmt* first, uint32_t depth) {
+    rgsl_glsl_append(emitter, "{\n");
+    for (const struct rgsl_stmt* stmt = first; stmt != NULL; stmt = stmt->next) {
+        rgsl_glsl_write_statement(emitter, stmt, depth + 1);
+    }
+    rgsl_glsl_indent(emitter, depth);
+    rgsl_glsl_append(emitter, "}");
+}
+
+// Writes the body of a control statement, after its header.
+static void rgsl_glsl_write_body(struct rgsl_glsl_emitter* emitter, const struct rgsl_stmt* body, uint32_t depth) {
+    if (body->kind == RGSL_STMT_BLOCK) {
+        rgsl_glsl_append(emitter, " ");
+        rgsl_glsl_write_block(emitter, body->body, depth);
+        rgsl_glsl_append(emitter, "\n");
+        return;
+    }
+    rgsl_glsl_append(emitter, "\n");
+    rgsl_glsl_write_statement(emitter, body, depth + 1);
+}
+
+static void rgsl_glsl_write_statement(struct rgsl_glsl_emitter* emitter, const struct rgsl_stmt* stmt, uint32_t depth) {
+    if (stmt->kind == RGSL_STMT_EMPTY) {
+        return;
+    }
+    rgsl_glsl_indent(emitter, depth);
+    switch (stmt->kind) {
+        case RGSL_STMT_BLOCK:
+            rgsl_glsl_write_block(emitter, stmt->body, depth);
+            rgsl_glsl_append(emitter, "\n");
+            break;
+        case RGSL_STMT_DECLARATION:
+            rgsl_glsl_write_local(emitter, stmt->variable);
+            rgsl_glsl_append(emitter, ";\n");
+            break;
+        case RGSL_STMT_EXPRESSION:
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ";\n");
+            break;
+        case RGSL_STMT_IF:
+            rgsl_glsl_append(emitter, "if (");
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ")");
+            rgsl_glsl_write_body(emitter, stmt->body, depth);
+            if (stmt->else_branch != NULL) {
+                rgsl_glsl_indent(emitter, depth);
+                rgsl_glsl_append(emitter, "else");
+                rgsl_glsl_write_body(emitter, stmt->else_branch, depth);
+            }
+            break;
+        case RGSL_STMT_FOR:
+            rgsl_glsl_append(emitter, "for (");
+            if (stmt->init != NULL && stmt->init->kind == RGSL_STMT_DECLARATION) {
+                rgsl_glsl_write_local(emitter, stmt->init->variable);
+                for (const struct rgsl_stmt* next = stmt->init->next; next != NULL; next = next->next) {
+                    rgsl_text_printf(emitter->output, ", %s", next->variable->name);
+                    if (next->variable->initializer != NULL) {
+                        rgsl_glsl_append(emitter, " = ");
+                        rgsl_glsl_write_expr(emitter, next->variable->initializer, RGSL_PRECEDENCE_ASSIGNMENT);
+                    }
+                }
+            } else if (stmt->init != NULL) {
+                rgsl_glsl_write_expr(emitter, stmt->init->expr, RGSL_PRECEDENCE_SEQUENCE);
+            }
+            rgsl_glsl_append(emitter, "; ");
+            if (stmt->expr != NULL) {
+                rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            }
+            rgsl_glsl_append(emitter, "; ");
+            if (stmt->step != NULL) {
+                rgsl_glsl_write_expr(emitter, stmt->step, RGSL_PRECEDENCE_SEQUENCE);
+            }
+            rgsl_glsl_append(emitter, ")");
+            rgsl_glsl_write_body(emitter, stmt->body, depth);
+            break;
+        case RGSL_STMT_WHILE:
+            rgsl_glsl_append(emitter, "while (");
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ")");
+            rgsl_glsl_write_body(emitter, stmt->body, depth);
+            break;
+        case RGSL_STMT_DO_WHILE:
+            rgsl_glsl_append(emitter, "do");
+            rgsl_glsl_write_body(emitter, stmt->body, depth);
+            rgsl_glsl_indent(emitter, depth);
+            rgsl_glsl_append(emitter, "while (");
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ");\n");
+            break;
+        case RGSL_STMT_SWITCH:
+            rgsl_glsl_append(emitter, "switch (");
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            rgsl_glsl_append(emitter, ") {\n");
+            for (const struct rgsl_stmt* child = stmt->body->body; child != NULL; child = child->next) {
+                bool label = child->kind == RGSL_STMT_CASE || child->kind == RGSL_STMT_DEFAULT;
+                rgsl_glsl_write_statement(emitter, child, label ? depth + 1 : depth + 2);
+            }
+            rgsl_glsl_indent(emitter, depth);
+            rgsl_glsl_append(emitter, "}\n");
+            break;
+        case RGSL_STMT_CASE:
+            rgsl_glsl_append(emitter, "case ");
+            rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_CONDITIONAL);
+            rgsl_glsl_append(emitter, ":\n");
+            break;
+        case RGSL_STMT_DEFAULT: rgsl_glsl_append(emitter, "default:\n"); break;
+        case RGSL_STMT_BREAK: rgsl_glsl_append(emitter, "break;\n"); break;
+        case RGSL_STMT_CONTINUE: rgsl_glsl_append(emitter, "continue;\n"); break;
+        case RGSL_STMT_DISCARD: rgsl_glsl_append(emitter, "discard;\n"); break;
+        case RGSL_STMT_RETURN:
+            rgsl_glsl_append(emitter, "return");
+            if (stmt->expr != NULL) {
+                rgsl_glsl_append(emitter, " ");
+                rgsl_glsl_write_expr(emitter, stmt->expr, RGSL_PRECEDENCE_SEQUENCE);
+            }
+            rgsl_glsl_append(emitter, ";\n");
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Global declarations                                                        */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_glsl_write_fields(struct rgsl_glsl_emitter* emitter, const struct rgsl_struct_decl* structure) {
+    rgsl_glsl_append(emitter, " {\n");
+    for (uint32_t i = 0; i < structure->field_count; i++) {
+        const struct rgsl_field* field = &structure->fields[i];
+        rgsl_glsl_indent(emitter, 1);
+        rgsl_glsl_write_memory(emitter, field->memory);
+        rgsl_glsl_write_precision(emitter, field->precision);
+        rgsl_glsl_write_declarator(emitter, field->type, field->name);
+        rgsl_glsl_append(emitter, ";\n");
+    }
+    rgsl_glsl_append(emitter, "}");
+}
+
+static void rgsl_glsl_write_global_variable(struct rgsl_glsl_emitter* emitter, const struct rgsl_variable* variable) {
+    static const char* const STORAGE_KEYWORDS[] = {"", "", "", "in ", "out ", "uniform ", "buffer ", ""};
+    rgsl_glsl_write_layout(emitter, &variable->layout, rgsl_is_varying(emitter->module, variable), variable->name, variable->line);
+    if (variable->interpolation != RGSL_INTERPOLATION_NONE) {
+        rgsl_text_printf(emitter->output, "%s ", INTERPOLATION_NAMES[variable->interpolation]);
+    }
+    if (variable->is_const) {
+        rgsl_glsl_append(emitter, "const ");
+    }
+    rgsl_glsl_append(emitter, STORAGE_KEYWORDS[variable->storage]);
+    rgsl_glsl_write_precision(emitter, variable->precision);
+    rgsl_glsl_write_declarator(emitter, variable->type, variable->name);
+    if (variable->initializer != NULL) {
+        rgsl_glsl_append(emitter, " = ");
+        rgsl_glsl_write_expr(emitter, variable->initializer, RGSL_PRECEDENCE_ASSIGNMENT);
+    }
+    rgsl_glsl_append(emitter, ";\n");
+}
+
+static void rgsl_glsl_write_block_declaration(struct rgsl_glsl_emitter* emitter, const struct rgsl_block* block) {
+    rgsl_glsl_write_layout(emitter, &block->layout, false, block->members.name, block->members.line);
+    rgsl_glsl_write_memory(emitter, block->memory);
+    rgsl_text_printf(emitter->output, "%s %s", block->storage == RGSL_STORAGE_BUFFER ? "buffer" : "uniform", block->members.name);
+    rgsl_glsl_write_fields(emitter, &block->members);
+    if (block->instance != NULL) {
+        rgsl_glsl_append(emitter, " ");
+        // The instance is declared with the type of the block, only its array sizes are written.
+        rgsl_glsl_append(emitter, block->instance->name);
+        for (const struct rgsl_type* type = block->instance->type; type->kind == RGSL_TYPE_ARRAY; type = type->element) {
+            rgsl_text_printf(emitter->output, "[%u]", type->array_size);
+        }
+    }
+    rgsl_glsl_append(emitter, ";\n");
+}
+
+static void rgsl_glsl_write_function(struct rgsl_glsl_emitter* emitter, const struct rgsl_function* function) {
+    static const char* const DIRECTION_KEYWORDS[] = {"", "out ", "inout "};
+    rgsl_type_write(emitter->output, function->return_type);
+    rgsl_text_printf(emitter->output, " %s(", function->name);
+    for (uint32_t i = 0; i < function->parameter_count; i++) {
+        const struct rgsl_variable* parameter = function->parameters[i];
+        if (i > 0) {
+            rgsl_glsl_append(emitter, ", ");
+        }
+        if (parameter->is_const) {
+            rgsl_glsl_append(emitter, "const ");
+        }
+        rgsl_glsl_append(emitter, DIRECTION_KEYWORDS[parameter->direction]);
+        rgsl_glsl_write_precision(emitter, parameter->precision);
+        rgsl_glsl_write_declarator(emitter, parameter->type, parameter->name);
+    }
+    rgsl_glsl_append(emitter, ")");
+    if (function->body == NULL) {
+        rgsl_glsl_append(emitter, ";\n");
+        return;
+    }
+    rgsl_glsl_append(emitter, " ");
+    rgsl_glsl_write_block(emitter, function->body->body, 0);
+    rgsl_glsl_append(emitter, "\n");
+}
+
+static bool rgsl_module_declares_precision(const struct rgsl_module* module, const struct rgsl_type* type) {
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        if (global->kind == RGSL_GLOBAL_PRECISION && global->precision_type == type) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Declares the default precisions GLSL ES lacks: float in fragment shaders, and most sampler types.
+static void rgsl_glsl_write_default_precisions(struct rgsl_glsl_emitter* emitter) {
+    const struct rgsl_module* module = emitter->module;
+    const struct rgsl_type* declared[RGSL_BUILTIN_TYPE_COUNT];
+    size_t declared_count = 0;
+    declared[declared_count++] = rgsl_builtin_type(RGSL_BUILTIN_FLOAT);
+    declared[declared_count++] = rgsl_builtin_type(RGSL_BUILTIN_INT);
+    // sampler2D and samplerCube have a default precision in every stage.
+    declared[declared_count++] = rgsl_builtin_type(RGSL_BUILTIN_SAMPLER2D);
+    declared[declared_count++] = rgsl_builtin_type(RGSL_BUILTIN_SAMPLERCUBE);
+    for (size_t i = 0; i < 2; i++) {
+        if (!rgsl_module_declares_precision(module, declared[i])) {
+            rgsl_text_printf(emitter->output, "precision highp %s;\n", declared[i]->name);
+        }
+    }
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        if (global->kind != RGSL_GLOBAL_VARIABLE) {
+            continue;
+        }
+        const struct rgsl_type* type = global->variable->type;
+        while (type->kind == RGSL_TYPE_ARRAY) {
+            type = type->element;
+        }
+        if (type->kind != RGSL_TYPE_SAMPLER || global->variable->precision != RGSL_PRECISION_NONE || rgsl_module_declares_precision(module, type)) {
+            continue;
+        }
+        bool seen = false;
+        for (size_t i = 0; i < declared_count && !seen; i++) {
+            seen = declared[i] == type;
+        }
+        if (!seen) {
+            declared[declared_count++] = type;
+            rgsl_text_printf(emitter->output, "precision highp %s;\n", type->name);
+        }
+    }
+}
+
+void rgsl_glsl_emit(struct rgsl_module* module, const struct rgsl_shader_profile* profile, struct rgsl_text* output) {
+    struct rgsl_glsl_emitter emitter;
+    emitter.module = module;
+    emitter.output = output;
+    emitter.es = rgsl_profile_is_es(profile);
+    emitter.varying_locations = rgsl_profile_has(profile, &VARYING_LOCATIONS);
+    emitter.bindings = rgsl_profile_has(profile, &BINDINGS);
+    emitter.spec_constants = rgsl_spec_constants_enabled();
+    rgsl_text_printf(output, "#version %d %s\n", profile->version, profile->name);
+    if (emitter.es) {
+        rgsl_glsl_write_default_precisions(&emitter);
+    }
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        switch (global->kind) {
+            case RGSL_GLOBAL_VARIABLE:
+                rgsl_glsl_write_global_variable(&emitter, global->variable);
+                break;
+            case RGSL_GLOBAL_STRUCT:
+                rgsl_text_printf(output, "struct %s", global->structure->name);
+                rgsl_glsl_write_fields(&emitter, global->structure);
+                rgsl_glsl_append(&emitter, ";\n");
+                break;
+            case RGSL_GLOBAL_BLOCK:
+                rgsl_glsl_write_block_declaration(&emitter, global->block);
+                break;
+            case RGSL_GLOBAL_FUNCTION:
+                rgsl_glsl_write_function(&emitter, global->function);
+                break;
+            case RGSL_GLOBAL_PRECISION:
+                // Precision statements have no effect on desktop GLSL.
+                if (emitter.es) {
+                    rgsl_text_printf(output, "precision %s %s;\n", PRECISION_NAMES[global->precision], global->precision_type->name);
+                }
+                break;
+            case RGSL_GLOBAL_LAYOUT:
+                rgsl_text_printf(output, "layout(local_size_x = %u, local_size_y = %u, local_size_z = %u) in;\n",
+                                 module->local_size[0], module->local_size[1], module->local_size[2]);
+                break;
+        }
+    }
+}
\ No newline at end of file
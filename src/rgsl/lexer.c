@@ -0,0 +1,347 @@
+#include <RGSL/rgsl/lexer.h>
+#include <string.h>
+
+// Classes of the characters, generated from the operators of the language.
+#define RGSL_CHAR_SPACE 1
+#define RGSL_CHAR_IDENTIFIER_START 2
+#define RGSL_CHAR_IDENTIFIER 4
+#define RGSL_CHAR_DIGIT 8
+#define RGSL_CHAR_OPERATOR 16
+
+static const uint8_t CHAR_CLASSES[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  1,  0,  1,  1,  1,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     1, 16,  0,  0,  0, 16, 16,  0, 16, 16, 16, 16, 16, 16, 16, 16,
+    12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 16, 16, 16, 16, 16, 16,
+     0,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+     6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6, 16,  0, 16, 16,  6,
+     0,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6,
+     6,  6,  6,  6,  6,  6,  6,  6,  6,  6,  6, 16, 16, 16, 16,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+// Column of each operator character in the transitions, 0 for the other characters.
+static const uint8_t OPERATOR_COLUMNS[256] = {
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0, 21,  0,  0,  0, 16, 17,  0,  1,  2, 14, 12,  8, 13,  7, 15,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 10,  9, 22, 24, 23, 11,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  3,  0,  4, 19,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  5, 18,  6, 20,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,
+     0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0
+};
+
+// Next state of each state on each column, 0 when the operator ends. State 0 is the start.
+static const uint8_t OPERATOR_TRANSITIONS[46][25] = {
+    { 0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24}, // start
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '('
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // ')'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '['
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // ']'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '{'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '}'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '.'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // ','
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // ';'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // ':'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '?'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 25,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 36}, // '+'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 26,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 37}, // '-'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 38}, // '*'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 39}, // '/'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 40}, // '%'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 33,  0,  0,  0,  0,  0,  0, 41}, // '&'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 34,  0,  0,  0,  0,  0, 42}, // '|'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 35,  0,  0,  0,  0, 43}, // '^'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '~'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 32}, // '!'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 27,  0, 29}, // '<'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 28, 30}, // '>'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 31}, // '='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '++'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '--'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 44}, // '<<'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0, 45}, // '>>'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '<='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '>='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '=='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '!='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '&&'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '||'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '^^'
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '+='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '-='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '*='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '/='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '%='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '&='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '|='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '^='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0}, // '<<='
+    { 0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0} // '>>='
+};
+
+// Token of the operator read when ending in each state.
+static const uint8_t OPERATOR_TOKENS[46] = {
+    RGSL_TOKEN_ERROR, RGSL_TOKEN_LEFT_PAREN, RGSL_TOKEN_RIGHT_PAREN, RGSL_TOKEN_LEFT_BRACKET,
+    RGSL_TOKEN_RIGHT_BRACKET, RGSL_TOKEN_LEFT_BRACE, RGSL_TOKEN_RIGHT_BRACE, RGSL_TOKEN_DOT,
+    RGSL_TOKEN_COMMA, RGSL_TOKEN_SEMICOLON, RGSL_TOKEN_COLON, RGSL_TOKEN_QUESTION, RGSL_TOKEN_PLUS,
+    RGSL_TOKEN_MINUS, RGSL_TOKEN_STAR, RGSL_TOKEN_SLASH, RGSL_TOKEN_PERCENT, RGSL_TOKEN_AMPERSAND,
+    RGSL_TOKEN_BAR, RGSL_TOKEN_CARET, RGSL_TOKEN_TILDE, RGSL_TOKEN_BANG, RGSL_TOKEN_LESS, RGSL_TOKEN_GREATER,
+    RGSL_TOKEN_EQUAL, RGSL_TOKEN_PLUS_PLUS, RGSL_TOKEN_MINUS_MINUS, RGSL_TOKEN_LEFT_SHIFT,
+    RGSL_TOKEN_RIGHT_SHIFT, RGSL_TOKEN_LESS_EQUAL, RGSL_TOKEN_GREATER_EQUAL, RGSL_TOKEN_EQUAL_EQUAL,
+    RGSL_TOKEN_BANG_EQUAL, RGSL_TOKEN_AND_AND, RGSL_TOKEN_OR_OR, RGSL_TOKEN_XOR_XOR, RGSL_TOKEN_PLUS_EQUAL,
+    RGSL_TOKEN_MINUS_EQUAL, RGSL_TOKEN_STAR_EQUAL, RGSL_TOKEN_SLASH_EQUAL, RGSL_TOKEN_PERCENT_EQUAL,
+    RGSL_TOKEN_AMPERSAND_EQUAL, RGSL_TOKEN_BAR_EQUAL, RGSL_TOKEN_CARET_EQUAL, RGSL_TOKEN_LEFT_SHIFT_EQUAL,
+    RGSL_TOKEN_RIGHT_SHIFT_EQUAL
+};
+
+// Spellings of the tokens, indexed by kind. Keywords are in alphabetical order.
+static const char* const TOKEN_SPELLINGS[RGSL_TOKEN_KIND_COUNT] = {
+    "end of file", "invalid character", "identifier", "integer literal", "unsigned integer literal", "floating-point literal", "directive",
+    "break", "buffer", "case", "coherent", "const", "continue", "default", "discard", "do", "else", "false", "flat", "for",
+    "highp", "if", "in", "inout", "layout", "lowp", "mediump", "noperspective", "out", "precision", "readonly", "restrict",
+    "return", "smooth", "struct", "switch", "true", "uniform", "volatile", "while", "writeonly",
+    "(", ")", "[", "]", "{", "}", ".", ",", ";", ":", "?", "+", "-", "*", "/", "%", "&", "|", "^", "~", "!", "<", ">", "=",
+    "++", "--", "<<", ">>", "<=", ">=", "==", "!=", "&&", "||", "^^",
+    "+=", "-=", "*=", "/=", "%=", "&=", "|=", "^=", "<<=", ">>="
+};
+
+// Precedence of the binary operators, the other tokens having none.
+static const uint8_t BINARY_PRECEDENCES[RGSL_TOKEN_KIND_COUNT] = {
+    [RGSL_TOKEN_OR_OR] = 1,
+    [RGSL_TOKEN_XOR_XOR] = 2,
+    [RGSL_TOKEN_AND_AND] = 3,
+    [RGSL_TOKEN_BAR] = 4,
+    [RGSL_TOKEN_CARET] = 5,
+    [RGSL_TOKEN_AMPERSAND] = 6,
+    [RGSL_TOKEN_EQUAL_EQUAL] = 7, [RGSL_TOKEN_BANG_EQUAL] = 7,
+    [RGSL_TOKEN_LESS] = 8, [RGSL_TOKEN_GREATER] = 8, [RGSL_TOKEN_LESS_EQUAL] = 8, [RGSL_TOKEN_GREATER_EQUAL] = 8,
+    [RGSL_TOKEN_LEFT_SHIFT] = 9, [RGSL_TOKEN_RIGHT_SHIFT] = 9,
+    [RGSL_TOKEN_PLUS] = 10, [RGSL_TOKEN_MINUS] = 10,
+    [RGSL_TOKEN_STAR] = 11, [RGSL_TOKEN_SLASH] = 11, [RGSL_TOKEN_PERCENT] = 11
+};
+
+const char* rgsl_token_spelling(enum rgsl_token_kind kind) {
+    return (kind < RGSL_TOKEN_KIND_COUNT) ? TOKEN_SPELLINGS[kind] : "?";
+}
+
+uint32_t rgsl_token_precedence(enum rgsl_token_kind kind) {
+    return (kind < RGSL_TOKEN_KIND_COUNT) ? BINARY_PRECEDENCES[kind] : 0;
+}
+
+static enum rgsl_token_kind rgsl_lexer_keyword(const char* start, size_t length) {
+    // Keywords start with a lowercase letter and are at most 13 characters long.
+    if (length > 13 || start[0] < 'b' || start[0] > 'w') {
+        return RGSL_TOKEN_IDENTIFIER;
+    }
+    int low = RGSL_TOKEN_FIRST_KEYWORD;
+    int high = RGSL_TOKEN_LAST_KEYWORD;
+    while (low <= high) {
+        int middle = (low + high) / 2;
+        const char* keyword = TOKEN_SPELLINGS[middle];
+        int comparison = strncmp(start, keyword, length);
+        if (comparison == 0 && keyword[length] != '\0') {
+            comparison = -1; // The identifier is a prefix of the keyword.
+        }
+        if (comparison == 0) {
+            return (enum rgsl_token_kind)middle;
+        }
+        if (comparison < 0) {
+            high = middle - 1;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return RGSL_TOKEN_IDENTIFIER;
+}
+
+void rgsl_lexer_init(struct rgsl_lexer* lexer, const char* code, size_t length, uint32_t line) {
+    lexer->cursor = code;
+    lexer->end = code + length;
+    lexer->line = line;
+    lexer->line_start = true;
+}
+
+static const char* rgsl_lexer_skip_digits(const char* cursor, const char* end) {
+    while (cursor < end && (CHAR_CLASSES[(unsigned char)*cursor] & RGSL_CHAR_DIGIT)) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static enum rgsl_token_kind rgsl_lexer_number(struct rgsl_lexer* lexer) {
+    const char* cursor = lexer->cursor;
+    const char* end = lexer->end;
+    enum rgsl_token_kind kind = RGSL_TOKEN_INT_LITERAL;
+    if (cursor + 1 < end && cursor[0] == '0' && (cursor[1] == 'x' || cursor[1] == 'X')) {
+        cursor += 2;
+        while (cursor < end && (CHAR_CLASSES[(unsigned char)*cursor] & RGSL_CHAR_DIGIT ||
+               (*cursor >= 'a' && *cursor <= 'f') || (*cursor >= 'A' && *cursor <= 'F'))) {
+            cursor++;
+        }
+    } else {
+        cursor = rgsl_lexer_skip_digits(cursor, end);
+        if (cursor < end && *cursor == '.') {
+            kind = RGSL_TOKEN_FLOAT_LITERAL;
+            cursor = rgsl_lexer_skip_digits(cursor + 1, end);
+        }
+        if (cursor < end && (*cursor == 'e' || *cursor == 'E')) {
+            const char* exponent = cursor + 1;
+            if (exponent < end && (*exponent == '+' || *exponent == '-')) {
+                exponent++;
+            }
+            if (exponent < end && (CHAR_CLASSES[(unsigned char)*exponent] & RGSL_CHAR_DIGIT)) {
+                kind = RGSL_TOKEN_FLOAT_LITERAL;
+                cursor = rgsl_lexer_skip_digits(exponent, end);
+            }
+        }
+        if (kind == RGSL_TOKEN_FLOAT_LITERAL && cursor < end && (*cursor == 'f' || *cursor == 'F')) {
+            cursor++;
+        }
+    }
+    if (kind == RGSL_TOKEN_INT_LITERAL && cursor < end && (*cursor == 'u' || *cursor == 'U')) {
+        kind = RGSL_TOKEN_UINT_LITERAL;
+        cursor++;
+    }
+    if (cursor < end && (CHAR_CLASSES[(unsigned char)*cursor] & RGSL_CHAR_IDENTIFIER)) {
+        // A suffix such as in "1.0h" or "12abc" makes the whole run invalid.
+        while (cursor < end && (CHAR_CLASSES[(unsigned char)*cursor] & RGSL_CHAR_IDENTIFIER)) {
+            cursor++;
+        }
+        kind = RGSL_TOKEN_ERROR;
+    }
+    lexer->cursor = cursor;
+    return kind;
+}
+
+static bool rgsl_lexer_skip_space(struct rgsl_lexer* lexer) {
+    const char* cursor = lexer->cursor;
+    const char* end = lexer->end;
+    while (cursor < end) {
+        unsigned char c = (unsigned char)*cursor;
+        if (CHAR_CLASSES[c] & RGSL_CHAR_SPACE) {
+            cursor++;
+        } else if (c == '\n') {
+            lexer->line++;
+            lexer->line_start = true;
+            cursor++;
+        } else if (c == '\\' && cursor + 1 < end && cursor[1] == '\n') {
+            lexer->line++;
+            cursor += 2;
+        } else if (c == '/' && cursor + 1 < end && cursor[1] == '/') {
+            while (cursor < end && *cursor != '\n') {
+                cursor++;
+            }
+        } else if (c == '/' && cursor + 1 < end && cursor[1] == '*') {
+            const char* comment = cursor;
+            uint32_t comment_line = lexer->line;
+            cursor += 2;
+            while (cursor + 1 < end && !(cursor[0] == '*' && cursor[1] == '/')) {
+                lexer->line += (*cursor == '\n');
+                cursor++;
+            }
+            if (cursor + 1 >= end) {
+                // Left for the caller to report, from the start of the comment.
+                lexer->cursor = comment;
+                lexer->line = comment_line;
+                return false;
+            }
+            cursor += 2;
+        } else {
+            break;
+        }
+    }
+    lexer->cursor = cursor;
+    return true;
+}
+
+void rgsl_lexer_next(struct rgsl_lexer* lexer, struct rgsl_token* token) {
+    if (!rgsl_lexer_skip_space(lexer)) {
+        token->kind = RGSL_TOKEN_ERROR;
+        token->start = lexer->cursor;
+        token->length = 2;
+        token->line = lexer->line;
+        lexer->cursor = lexer->end;
+        return;
+    }
+    const char* start = lexer->cursor;
+    const char* end = lexer->end;
+    token->start = start;
+    token->line = lexer->line;
+    bool line_start = lexer->line_start;
+    lexer->line_start = false;
+    if (start >= end) {
+        token->kind = RGSL_TOKEN_END;
+        token->length = 0;
+        return;
+    }
+    unsigned char c = (unsigned char)*start;
+    uint8_t char_class = CHAR_CLASSES[c];
+    if (char_class & RGSL_CHAR_IDENTIFIER_START) {
+        const char* cursor = start + 1;
+        while (cursor < end && (CHAR_CLASSES[(unsigned char)*cursor] & RGSL_CHAR_IDENTIFIER)) {
+            cursor++;
+        }
+        lexer->cursor = cursor;
+        token->length = (uint32_t)(cursor - start);
+        token->kind = rgsl_lexer_keyword(start, token->length);
+        return;
+    }
+    if ((char_class & RGSL_CHAR_DIGIT) || (c == '.' && start + 1 < end && (CHAR_CLASSES[(unsigned char)start[1]] & RGSL_CHAR_DIGIT))) {
+        token->kind = rgsl_lexer_number(lexer);
+        token->length = (uint32_t)(lexer->cursor - start);
+        return;
+    }
+    if (char_class & RGSL_CHAR_OPERATOR) {
+        // Longest match: follow the transitions until the operator cannot grow.
+        const char* cursor = start;
+        uint8_t state = 0;
+        while (cursor < end) {
+            uint8_t next = OPERATOR_TRANSITIONS[state][OPERATOR_COLUMNS[(unsigned char)*cursor]];
+            if (next == 0) {
+                break;
+            }
+            state = next;
+            cursor++;
+        }
+        lexer->cursor = cursor;
+        token->kind = (enum rgsl_token_kind)OPERATOR_TOKENS[state];
+        token->length = (uint32_t)(cursor - start);
+        return;
+    }
+    if (c == '#' && line_start) {
+        // The directive runs to the end of its line, continuations included.
+        const char* cursor = start;
+        while (cursor < end && *cursor != '\n') {
+            if (*cursor == '\\' && cursor + 1 < end && cursor[1] == '\n') {
+                lexer->line++;
+                cursor++;
+            }
+            cursor++;
+        }
+        lexer->cursor = cursor;
+        token->kind = RGSL_TOKEN_DIRECTIVE;
+        token->length = (uint32_t)(cursor - start);
+        return;
+    }
+    lexer->cursor = start + 1;
+    token->kind = RGSL_TOKEN_ERROR;
+    token->length = 1;
+}
\ No newline at end of file
@@ -0,0 +1,1538 @@
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/rgsl/checker.h>
+#include <RGSL/rgsl/benchmark.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/parser.h>
+#include <RGSL/termio.h>
+#include <RGSL/clock.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Depth of nested macro expansions, beyond which a macro is reported as recursive.
+#define RGSL_MACRO_DEPTH 32
+// Number of errors after which parsing stops.
+#define RGSL_MAX_ERRORS 32
+// Initial number of slots of the table of names, a power of two.
+#define RGSL_NAME_TABLE_SIZE 1024
+
+/**
+ * Object-like macro defined by a #define directive, its body pointing into the code.
+ */
+struct rgsl_object_macro {
+    const char* body;
+    uint32_t length;
+    bool function_like;
+};
+
+/**
+ * Identifier interned by the parser, so that the tree compares names by address,
+ * along with what the parser knows the name to be: a built-in type, a structure
+ * or a macro.
+ */
+struct rgsl_name {
+    const char* text;
+    uint32_t length;
+    uint64_t hash;
+    const struct rgsl_type* builtin_type;
+    struct rgsl_struct_decl* structure;
+    struct rgsl_object_macro* macro;
+};
+
+struct rgsl_parser_token {
+    struct rgsl_token token;
+    struct rgsl_name* name;
+};
+
+/**
+ * Qualifiers read before a declaration, in any order.
+ */
+struct rgsl_qualifiers {
+    bool present;
+    bool has_storage;
+    enum rgsl_storage storage;
+    enum rgsl_direction direction;
+    bool is_const;
+    enum rgsl_interpolation interpolation;
+    enum rgsl_precision precision;
+    uint32_t memory;
+    struct rgsl_layout_qualifiers layout;
+    bool has_layout;
+    uint32_t local_size[3];
+    bool has_local_size;
+    uint32_t line;
+};
+
+struct rgsl_parser {
+    struct rgsl_module* module;
+    struct rgsl_lexer lexers[RGSL_MACRO_DEPTH];
+    struct rgsl_name* expanding[RGSL_MACRO_DEPTH];
+    size_t depth;
+    uint32_t expansion_line;
+    struct rgsl_parser_token current;
+    struct rgsl_parser_token lookahead;
+    bool has_lookahead;
+    struct rgsl_name** names;
+    size_t name_capacity;
+    size_t name_count;
+    bool panic;
+};
+
+static const struct rgsl_layout_qualifiers NO_LAYOUT = {-1, -1, -1, -1};
+
+static void rgsl_parser_error(struct rgsl_parser* parser, uint32_t line, const char* format, const char* argument) {
+    // Errors following a first one before the parser synchronizes are usually caused by it.
+    if (parser->panic) {
+        return;
+    }
+    parser->panic = true;
+    rgsl_module_error(parser->module, line, format, argument);
+}
+
+static void rgsl_parser_unexpected(struct rgsl_parser* parser, const char* expected) {
+    const struct rgsl_token* token = &parser->current.token;
+    if (parser->panic) {
+        return;
+    }
+    parser->panic = true;
+    if (token->kind == RGSL_TOKEN_END) {
+        rgsl_module_error(parser->module, token->line, "expected %s at end of file", expected);
+    } else {
+        rgsl_module_error(parser->module, token->line, "expected %s before '%.*s'", expected, (int)token->length, token->start);
+    }
+}
+
+static struct rgsl_name* rgsl_parser_intern(struct rgsl_parser* parser, const char* text, size_t length) {
+    uint64_t hash = rgsl_hash_bytes(text, length);
+    size_t mask = parser->name_capacity - 1;
+    size_t slot = (size_t)hash & mask;
+    while (parser->names[slot] != NULL) {
+        struct rgsl_name* name = parser->names[slot];
+        if (name->hash == hash && name->length == length && memcmp(name->text, text, length) == 0) {
+            return name;
+        }
+        slot = (slot + 1) & mask;
+    }
+    struct rgsl_arena* arena = &parser->module->arena;
+    struct rgsl_name* name = (struct rgsl_name *)rgsl_arena_alloc(arena, sizeof(struct rgsl_name));
+    char* copy = (char *)rgsl_arena_alloc(arena, length + 1);
+    memcpy(copy, text, length);
+    name->text = copy;
+    name->length = (uint32_t)length;
+    name->hash = hash;
+    name->builtin_type = rgsl_find_builtin_type(text, length);
+    parser->names[slot] = name;
+    if (++parser->name_count * 2 > parser->name_capacity) {
+        // Keep the table at most half full, so that probing stays short.
+        struct rgsl_name** old_names = parser->names;
+        size_t old_capacity = parser->name_capacity;
+        parser->name_capacity *= 2;
+        parser->names = (struct rgsl_name **)rgsl_calloc(parser->name_capacity, sizeof(struct rgsl_name*));
+        mask = parser->name_capacity - 1;
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old_names[i] != NULL) {
+                size_t new_slot = (size_t)old_names[i]->hash & mask;
+                while (parser->names[new_slot] != NULL) {
+                    new_slot = (new_slot + 1) & mask;
+                }
+                parser->names[new_slot] = old_names[i];
+            }
+        }
+        rgsl_free(old_names);
+    }
+    return name;
+}
+
+static const char* rgsl_skip_blanks(const char* cursor, const char* end) {
+    while (cursor < end && (*cursor == ' ' || *cursor == '\t' || *cursor == '\\' || *cursor == '\n' || *cursor == '\r')) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static const char* rgsl_skip_word(const char* cursor, const char* end) {
+    while (cursor < end && (*cursor == '_' || (*cursor >= 'a' && *cursor <= 'z') || (*cursor >= 'A' && *cursor <= 'Z') || (*cursor >= '0' && *cursor <= '9'))) {
+        cursor++;
+    }
+    return cursor;
+}
+
+static bool rgsl_directive_is(const char* word, size_t length, const char* name) {
+    return strlen(name) == length && strncmp(word, name, length) == 0;
+}
+
+static void rgsl_parser_directive(struct rgsl_parser* parser, const struct rgsl_token* token) {
+    struct rgsl_module* module = parser->module;
+    const char* end = token->start + token->length;
+    const char* word = rgsl_skip_blanks(token->start + 1, end);
+    const char* word_end = rgsl_skip_word(word, end);
+    size_t length = (size_t)(word_end - word);
+    if (length == 0 || rgsl_directive_is(word, length, "pragma")) {
+        return;
+    }
+    if (rgsl_directive_is(word, length, "define") || rgsl_directive_is(word, length, "undef")) {
+        const char* name_start = rgsl_skip_blanks(word_end, end);
+        const char* name_end = rgsl_skip_word(name_start, end);
+        if (name_end == name_start) {
+            rgsl_module_error(module, token->line, "#%s without a macro name", word[0] == 'd' ? "define" : "undef");
+            return;
+        }
+        struct rgsl_name* name = rgsl_parser_intern(parser, name_start, (size_t)(name_end - name_start));
+        if (word[0] == 'u') {
+            name->macro = NULL;
+            return;
+        }
+        struct rgsl_object_macro* macro = (struct rgsl_object_macro *)rgsl_arena_alloc(&module->arena, sizeof(struct rgsl_object_macro));
+        macro->function_like = name_end < end && *name_end == '(';
+        macro->body = name_end;
+        macro->length = (uint32_t)(end - name_end);
+        name->macro = macro;
+        return;
+    }
+    if (rgsl_directive_is(word, length, "extension")) {
+        rgsl_module_warning(module, token->line, "%.*s is ignored, RGSL enables the extensions its output needs", (int)token->length, token->start);
+    } else if (rgsl_directive_is(word, length, "version")) {
+        rgsl_module_error(module, token->line, "RGSL shaders have no #version directive, the profile is chosen with --profile");
+    } else if (rgsl_directive_is(word, length, "error")) {
+        rgsl_module_error(module, token->line, "%.*s", (int)token->length, token->start);
+    } else if (word[0] == 'i' || word[0] == 'e') {
+        rgsl_module_error(module, token->line, "#%.*s could not be evaluated by the preprocessor, RGSL conditionals may only test macros", (int)length, word);
+    } else {
+        rgsl_module_error(module, token->line, "unsupported directive #%.*s", (int)length, word);
+    }
+}
+
+static bool rgsl_parser_is_expanding(const struct rgsl_parser* parser, const struct rgsl_name* name) {
+    for (size_t i = 1; i <= parser->depth; i++) {
+        if (parser->expanding[i] == name) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void rgsl_parser_read(struct rgsl_parser* parser, struct rgsl_parser_token* out) {
+    for (;;) {
+        struct rgsl_lexer* lexer = &parser->lexers[parser->depth];
+        rgsl_lexer_next(lexer, &out->token);
+        out->name = NULL;
+        if (parser->depth > 0) {
+            // Tokens of a macro body are reported on the line of the outermost expansion.
+            out->token.line = parser->expansion_line;
+            if (out->token.kind == RGSL_TOKEN_END) {
+                parser->depth--;
+                continue;
+            }
+        } else if (out->token.kind == RGSL_TOKEN_DIRECTIVE) {
+            rgsl_parser_directive(parser, &out->token);
+            continue;
+        }
+        if (out->token.kind == RGSL_TOKEN_IDENTIFIER) {
+            struct rgsl_name* name = rgsl_parser_intern(parser, out->token.start, out->token.length);
+            struct rgsl_object_macro* macro = name->macro;
+            if (macro != NULL && !rgsl_parser_is_expanding(parser, name)) {
+                if (macro->function_like) {
+                    rgsl_module_error(parser->module, out->token.line, "function-like macro %s is not supported in RGSL", name->text);
+                } else if (parser->depth + 1 >= RGSL_MACRO_DEPTH) {
+                    rgsl_module_error(parser->module, out->token.line, "macro %s expands too deeply", name->text);
+                } else {
+                    if (parser->depth == 0) {
+                        parser->expansion_line = out->token.line;
+                    }
+                    parser->depth++;
+                    parser->expanding[parser->depth] = name;
+                    rgsl_lexer_init(&parser->lexers[parser->depth], macro->body, macro->length, parser->expansion_line);
+                    parser->lexers[parser->depth].line_start = false;
+                    continue;
+                }
+            }
+            out->name = name;
+        }
+        parser->module->token_count++;
+        return;
+    }
+}
+
+static void rgsl_parser_advance(struct rgsl_parser* parser) {
+    if (parser->has_lookahead) {
+        parser->current = parser->lookahead;
+        parser->has_lookahead = false;
+    } else {
+        rgsl_parser_read(parser, &parser->current);
+    }
+    if (parser->current.token.kind == RGSL_TOKEN_ERROR) {
+        const struct rgsl_token* token = &parser->current.token;
+        if (token->length == 2 && token->start[0] == '/' && token->start[1] == '*') {
+            rgsl_parser_error(parser, token->line, "unterminated comment%s", "");
+        } else {
+            rgsl_module_error(parser->module, token->line, "invalid token '%.*s'", (int)token->length, token->start);
+        }
+    }
+}
+
+static const struct rgsl_parser_token* rgsl_parser_peek(struct rgsl_parser* parser) {
+    if (!parser->has_lookahead) {
+        rgsl_parser_read(parser, &parser->lookahead);
+        parser->has_lookahead = true;
+    }
+    return &parser->lookahead;
+}
+
+static inline enum rgsl_token_kind rgsl_parser_kind(const struct rgsl_parser* parser) {
+    return parser->current.token.kind;
+}
+
+static inline uint32_t rgsl_parser_line(const struct rgsl_parser* parser) {
+    return parser->current.token.line;
+}
+
+static bool rgsl_parser_accept(struct rgsl_parser* parser, enum rgsl_token_kind kind) {
+    if (parser->current.token.kind == kind) {
+        rgsl_parser_advance(parser);
+        return true;
+    }
+    return false;
+}
+
+static bool rgsl_parser_expect(struct rgsl_parser* parser, enum rgsl_token_kind kind) {
+    if (rgsl_parser_accept(parser, kind)) {
+        return true;
+    }
+    char expected[16];
+    snprintf(expected, sizeof(expected), "'%s'", rgsl_token_spelling(kind));
+    rgsl_parser_unexpected(parser, expected);
+    return false;
+}
+
+static bool rgsl_parser_stopped(const struct rgsl_parser* parser) {
+    return parser->current.token.kind == RGSL_TOKEN_END || parser->module->error_count >= RGSL_MAX_ERRORS;
+}
+
+// Skips to the end of the erroneous statement or declaration, a block being skipped whole.
+static void rgsl_parser_synchronize(struct rgsl_parser* parser) {
+    int depth = 0;
+    while (!rgsl_parser_stopped(parser)) {
+        enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+        if (kind == RGSL_TOKEN_LEFT_BRACE) {
+            depth++;
+        } else if (kind == RGSL_TOKEN_RIGHT_BRACE) {
+            if (depth == 0) {
+                break;
+            }
+            if (--depth == 0) {
+                rgsl_parser_advance(parser);
+                break;
+            }
+        } else if (kind == RGSL_TOKEN_SEMICOLON && depth == 0) {
+            rgsl_parser_advance(parser);
+            break;
+        }
+        rgsl_parser_advance(parser);
+    }
+    parser->panic = false;
+}
+
+static const char* rgsl_parser_identifier(struct rgsl_parser* parser, const char* expected) {
+    if (rgsl_parser_kind(parser) != RGSL_TOKEN_IDENTIFIER) {
+        rgsl_parser_unexpected(parser, expected);
+        return NULL;
+    }
+    const char* name = parser->current.name->text;
+    rgsl_parser_advance(parser);
+    return name;
+}
+
+static void* rgsl_parser_alloc(struct rgsl_parser* parser, size_t size) {
+    return rgsl_arena_alloc(&parser->module->arena, size);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Expressions                                                                */
+/* -------------------------------------------------------------------------- */
+
+static struct rgsl_expr* rgsl_parse_expression(struct rgsl_parser* parser);
+static struct rgsl_expr* rgsl_parse_assignment(struct rgsl_parser* parser);
+static struct rgsl_type* rgsl_parse_array_suffix(struct rgsl_parser* parser, const struct rgsl_type* element);
+
+static struct rgsl_expr* rgsl_new_expr(struct rgsl_parser* parser, enum rgsl_expr_kind kind, uint32_t line) {
+    struct rgsl_expr* expr = (struct rgsl_expr *)rgsl_parser_alloc(parser, sizeof(struct rgsl_expr));
+    expr->kind = kind;
+    expr->line = line;
+    return expr;
+}
+
+static bool rgsl_parser_is_type_name(const struct rgsl_parser_token* token) {
+    return token->token.kind == RGSL_TOKEN_IDENTIFIER && (token->name->builtin_type != NULL || token->name->structure != NULL);
+}
+
+static const struct rgsl_type* rgsl_parser_named_type(const struct rgsl_name* name) {
+    return (name->builtin_type != NULL) ? name->builtin_type : name->structure->type;
+}
+
+static bool rgsl_parse_integer(const char* text, size_t length, uint32_t* out_value) {
+    uint64_t value = 0;
+    uint32_t base = 10;
+    size_t i = 0;
+    if (length > 1 && text[0] == '0' && (text[1] == 'x' || text[1] == 'X')) {
+        base = 16;
+        i = 2;
+    } else if (length > 1 && text[0] == '0') {
+        base = 8;
+        i = 1;
+    }
+    for (; i < length && text[i] != 'u' && text[i] != 'U'; i++) {
+        char c = text[i];
+        uint32_t digit = (c >= '0' && c <= '9') ? (uint32_t)(c - '0') : (uint32_t)((c | 0x20) - 'a' + 10);
+        if (digit >= base) {
+            return false;
+        }
+        value = value * base + digit;
+        if (value > UINT32_MAX) {
+            return false;
+        }
+    }
+    *out_value = (uint32_t)value;
+    return true;
+}
+
+static struct rgsl_expr* rgsl_parse_literal(struct rgsl_parser* parser) {
+    const struct rgsl_token* token = &parser->current.token;
+    struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_LITERAL, token->line);
+    expr->op = token->kind;
+    expr->name = token->start;
+    expr->text_length = token->length;
+    if (token->kind == RGSL_TOKEN_FLOAT_LITERAL) {
+        char buffer[64];
+        size_t length = token->length < sizeof(buffer) - 1 ? token->length : sizeof(buffer) - 1;
+        memcpy(buffer, token->start, length);
+        buffer[length] = '\0';
+        expr->value.f = (float)strtod(buffer, NULL);
+    } else if (token->kind == RGSL_TOKEN_TRUE || token->kind == RGSL_TOKEN_FALSE) {
+        expr->value.b = token->kind == RGSL_TOKEN_TRUE;
+    } else if (!rgsl_parse_integer(token->start, token->length, &expr->value.u)) {
+        rgsl_module_error(parser->module, token->line, "invalid integer literal %.*s", (int)token->length, token->start);
+    } else if (token->kind == RGSL_TOKEN_INT_LITERAL && expr->value.u > INT32_MAX && token->start[0] != '0') {
+        // Only hexadecimal and octal literals may set the sign bit of an int.
+        rgsl_module_error(parser->module, token->line, "integer literal %.*s does not fit in an int, add the suffix u", (int)token->length, token->start);
+    }
+    rgsl_parser_advance(parser);
+    return expr;
+}
+
+static bool rgsl_parse_arguments(struct rgsl_parser* parser, struct rgsl_expr* expr) {
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_PAREN)) {
+        return false;
+    }
+    uint32_t capacity = 0;
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_RIGHT_PAREN ||
+        (rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER && parser->current.name->builtin_type == rgsl_builtin_type(RGSL_BUILTIN_VOID) &&
+         rgsl_parser_peek(parser)->token.kind == RGSL_TOKEN_RIGHT_PAREN)) {
+        rgsl_parser_accept(parser, RGSL_TOKEN_IDENTIFIER);
+        return rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN);
+    }
+    do {
+        struct rgsl_expr* argument = rgsl_parse_assignment(parser);
+        if (argument == NULL) {
+            return false;
+        }
+        if (expr->argument_count == capacity) {
+            uint32_t new_capacity = capacity ? capacity * 2 : 4;
+            expr->arguments = (struct rgsl_expr **)rgsl_arena_grow(&parser->module->arena, expr->arguments, capacity * sizeof(struct rgsl_expr*), new_capacity * sizeof(struct rgsl_expr*));
+            capacity = new_capacity;
+        }
+        expr->arguments[expr->argument_count++] = argument;
+    } while (rgsl_parser_accept(parser, RGSL_TOKEN_COMMA));
+    return rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN);
+}
+
+static struct rgsl_expr* rgsl_parse_primary(struct rgsl_parser* parser) {
+    uint32_t line = rgsl_parser_line(parser);
+    switch (rgsl_parser_kind(parser)) {
+        case RGSL_TOKEN_INT_LITERAL:
+        case RGSL_TOKEN_UINT_LITERAL:
+        case RGSL_TOKEN_FLOAT_LITERAL:
+        case RGSL_TOKEN_TRUE:
+        case RGSL_TOKEN_FALSE:
+            return rgsl_parse_literal(parser);
+        case RGSL_TOKEN_LEFT_PAREN: {
+            rgsl_parser_advance(parser);
+            struct rgsl_expr* expr = rgsl_parse_expression(parser);
+            if (expr == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN)) {
+                return NULL;
+            }
+            return expr;
+        }
+        case RGSL_TOKEN_IDENTIFIER: {
+            struct rgsl_name* name = parser->current.name;
+            if (rgsl_parser_is_type_name(&parser->current)) {
+                // Constructor, of an array type if the type is followed by brackets.
+                rgsl_parser_advance(parser);
+                struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_CONSTRUCT, line);
+                const struct rgsl_type* type = rgsl_parser_named_type(name);
+                if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+                    type = rgsl_parse_array_suffix(parser, type);
+                    if (type == NULL) {
+                        return NULL;
+                    }
+                }
+                expr->type = type;
+                return rgsl_parse_arguments(parser, expr) ? expr : NULL;
+            }
+            rgsl_parser_advance(parser);
+            if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_PAREN) {
+                struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_CALL, line);
+                expr->name = name->text;
+                return rgsl_parse_arguments(parser, expr) ? expr : NULL;
+            }
+            struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_VARIABLE, line);
+            expr->name = name->text;
+            return expr;
+        }
+        default:
+            rgsl_parser_unexpected(parser, "an expression");
+            return NULL;
+    }
+}
+
+static struct rgsl_expr* rgsl_parse_postfix(struct rgsl_parser* parser) {
+    struct rgsl_expr* expr = rgsl_parse_primary(parser);
+    while (expr != NULL) {
+        uint32_t line = rgsl_parser_line(parser);
+        enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+        if (kind == RGSL_TOKEN_LEFT_BRACKET) {
+            rgsl_parser_advance(parser);
+            struct rgsl_expr* index = rgsl_new_expr(parser, RGSL_EXPR_INDEX, line);
+            index->operands[0] = expr;
+            index->operands[1] = rgsl_parse_expression(parser);
+            if (index->operands[1] == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_BRACKET)) {
+                return NULL;
+            }
+            expr = index;
+        } else if (kind == RGSL_TOKEN_DOT) {
+            rgsl_parser_advance(parser);
+            const char* field = rgsl_parser_identifier(parser, "a field name");
+            if (field == NULL) {
+                return NULL;
+            }
+            struct rgsl_expr* access = rgsl_new_expr(parser, RGSL_EXPR_FIELD, line);
+            access->operands[0] = expr;
+            access->name = field;
+            if (strcmp(field, "length") == 0 && rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_PAREN) {
+                access->kind = RGSL_EXPR_LENGTH;
+                rgsl_parser_advance(parser);
+                if (!rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN)) {
+                    return NULL;
+                }
+            }
+            expr = access;
+        } else if (kind == RGSL_TOKEN_PLUS_PLUS || kind == RGSL_TOKEN_MINUS_MINUS) {
+            rgsl_parser_advance(parser);
+            struct rgsl_expr* unary = rgsl_new_expr(parser, RGSL_EXPR_UNARY, line);
+            unary->op = kind;
+            unary->postfix = true;
+            unary->operands[0] = expr;
+            expr = unary;
+        } else {
+            break;
+        }
+    }
+    return expr;
+}
+
+static struct rgsl_expr* rgsl_parse_unary(struct rgsl_parser* parser) {
+    enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+    if (kind == RGSL_TOKEN_PLUS || kind == RGSL_TOKEN_MINUS || kind == RGSL_TOKEN_BANG || kind == RGSL_TOKEN_TILDE ||
+        kind == RGSL_TOKEN_PLUS_PLUS || kind == RGSL_TOKEN_MINUS_MINUS) {
+        struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_UNARY, rgsl_parser_line(parser));
+        expr->op = kind;
+        rgsl_parser_advance(parser);
+        expr->operands[0] = rgsl_parse_unary(parser);
+        return expr->operands[0] != NULL ? expr : NULL;
+    }
+    return rgsl_parse_postfix(parser);
+}
+
+static struct rgsl_expr* rgsl_parse_binary(struct rgsl_parser* parser, uint32_t min_precedence) {
+    struct rgsl_expr* left = rgsl_parse_unary(parser);
+    while (left != NULL) {
+        enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+        uint32_t precedence = rgsl_token_precedence(kind);
+        if (precedence == 0 || precedence < min_precedence) {
+            break;
+        }
+        struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_BINARY, rgsl_parser_line(parser));
+        expr->op = kind;
+        rgsl_parser_advance(parser);
+        expr->operands[0] = left;
+        expr->operands[1] = rgsl_parse_binary(parser, precedence + 1);
+        left = expr->operands[1] != NULL ? expr : NULL;
+    }
+    return left;
+}
+
+static struct rgsl_expr* rgsl_parse_conditional(struct rgsl_parser* parser) {
+    struct rgsl_expr* condition = rgsl_parse_binary(parser, 1);
+    if (condition == NULL || rgsl_parser_kind(parser) != RGSL_TOKEN_QUESTION) {
+        return condition;
+    }
+    struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_CONDITIONAL, rgsl_parser_line(parser));
+    rgsl_parser_advance(parser);
+    expr->operands[0] = condition;
+    expr->operands[1] = rgsl_parse_expression(parser);
+    if (expr->operands[1] == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_COLON)) {
+        return NULL;
+    }
+    expr->operands[2] = rgsl_parse_assignment(parser);
+    return expr->operands[2] != NULL ? expr : NULL;
+}
+
+static bool rgsl_token_is_assignment(enum rgsl_token_kind kind) {
+    return kind == RGSL_TOKEN_EQUAL || (kind >= RGSL_TOKEN_PLUS_EQUAL && kind <= RGSL_TOKEN_RIGHT_SHIFT_EQUAL);
+}
+
+static struct rgsl_expr* rgsl_parse_assignment(struct rgsl_parser* parser) {
+    struct rgsl_expr* target = rgsl_parse_conditional(parser);
+    enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+    if (target == NULL || !rgsl_token_is_assignment(kind)) {
+        return target;
+    }
+    struct rgsl_expr* expr = rgsl_new_expr(parser, RGSL_EXPR_ASSIGN, rgsl_parser_line(parser));
+    expr->op = kind;
+    rgsl_parser_advance(parser);
+    expr->operands[0] = target;
+    expr->operands[1] = rgsl_parse_assignment(parser);
+    return expr->operands[1] != NULL ? expr : NULL;
+}
+
+static struct rgsl_expr* rgsl_parse_expression(struct rgsl_parser* parser) {
+    struct rgsl_expr* expr = rgsl_parse_assignment(parser);
+    while (expr != NULL && rgsl_parser_kind(parser) == RGSL_TOKEN_COMMA) {
+        struct rgsl_expr* sequence = rgsl_new_expr(parser, RGSL_EXPR_SEQUENCE, rgsl_parser_line(parser));
+        rgsl_parser_advance(parser);
+        sequence->operands[0] = expr;
+        sequence->operands[1] = rgsl_parse_assignment(parser);
+        expr = sequence->operands[1] != NULL ? sequence : NULL;
+    }
+    return expr;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Types and qualifiers                                                       */
+/* -------------------------------------------------------------------------- */
+
+static struct rgsl_type* rgsl_new_array_type(struct rgsl_parser* parser, const struct rgsl_type* element, struct rgsl_expr* size) {
+    struct rgsl_type* type = (struct rgsl_type *)rgsl_parser_alloc(parser, sizeof(struct rgsl_type));
+    type->kind = RGSL_TYPE_ARRAY;
+    type->element = element;
+    type->size_expr = size;
+    return type;
+}
+
+// Reads "[N]" suffixes, the first one being the outermost dimension.
+static struct rgsl_type* rgsl_parse_array_suffix(struct rgsl_parser* parser, const struct rgsl_type* element) {
+    struct rgsl_expr* sizes[4];
+    size_t count = 0;
+    while (rgsl_parser_accept(parser, RGSL_TOKEN_LEFT_BRACKET)) {
+        if (count == 4) {
+            rgsl_parser_error(parser, rgsl_parser_line(parser), "arrays have at most four dimensions%s", "");
+            return NULL;
+        }
+        sizes[count] = NULL;
+        if (rgsl_parser_kind(parser) != RGSL_TOKEN_RIGHT_BRACKET) {
+            sizes[count] = rgsl_parse_conditional(parser);
+            if (sizes[count] == NULL) {
+                return NULL;
+            }
+        }
+        count++;
+        if (!rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_BRACKET)) {
+            return NULL;
+        }
+    }
+    const struct rgsl_type* type = element;
+    while (count > 0) {
+        type = rgsl_new_array_type(parser, type, sizes[--count]);
+    }
+    return (struct rgsl_type *)type;
+}
+
+static bool rgsl_parse_layout_qualifiers(struct rgsl_parser* parser, struct rgsl_qualifiers* qualifiers) {
+    rgsl_parser_advance(parser);
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_PAREN)) {
+        return false;
+    }
+    qualifiers->has_layout = true;
+    do {
+        uint32_t line = rgsl_parser_line(parser);
+        if (rgsl_parser_kind(parser) != RGSL_TOKEN_IDENTIFIER && rgsl_parser_kind(parser) != RGSL_TOKEN_BUFFER) {
+            rgsl_parser_unexpected(parser, "a layout qualifier");
+            return false;
+        }
+        const char* name = (rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER) ? parser->current.name->text : "buffer";
+        rgsl_parser_advance(parser);
+        uint32_t value = 0;
+        bool has_value = false;
+        if (rgsl_parser_accept(parser, RGSL_TOKEN_EQUAL)) {
+            if (rgsl_parser_kind(parser) != RGSL_TOKEN_INT_LITERAL && rgsl_parser_kind(parser) != RGSL_TOKEN_UINT_LITERAL) {
+                rgsl_parser_unexpected(parser, "an integer");
+                return false;
+            }
+            struct rgsl_expr* literal = rgsl_parse_literal(parser);
+            value = literal->value.u;
+            has_value = true;
+        }
+        int32_t* target = NULL;
+        if (strcmp(name, "location") == 0) {
+            target = &qualifiers->layout.location;
+        } else if (strcmp(name, "binding") == 0) {
+            target = &qualifiers->layout.binding;
+        } else if (strcmp(name, "constant_id") == 0) {
+            target = &qualifiers->layout.constant_id;
+        } else if (strcmp(name, "std140") == 0 || strcmp(name, "std430") == 0) {
+            qualifiers->layout.packing = (name[3] == '1') ? RGSL_LAYOUT_STD140 : RGSL_LAYOUT_STD430;
+            continue;
+        } else if (strncmp(name, "local_size_", 11) == 0 && name[11] >= 'x' && name[11] <= 'z' && name[12] == '\0') {
+            if (!has_value || value == 0) {
+                rgsl_parser_error(parser, line, "%s needs a positive value", name);
+                return false;
+            }
+            qualifiers->local_size[name[11] - 'x'] = value;
+            qualifiers->has_local_size = true;
+            continue;
+        } else if (strcmp(name, "shared") == 0 || strcmp(name, "packed") == 0) {
+            rgsl_parser_error(parser, line, "layout %s is not portable, use std140 or std430", name);
+            return false;
+        } else {
+            rgsl_parser_error(parser, line, "unsupported layout qualifier %s", name);
+            return false;
+        }
+        if (!has_value || value > INT32_MAX) {
+            rgsl_parser_error(parser, line, "layout %s needs a value", name);
+            return false;
+        }
+        *target = (int32_t)value;
+    } while (rgsl_parser_accept(parser, RGSL_TOKEN_COMMA));
+    return rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN);
+}
+
+static bool rgsl_set_storage(struct rgsl_parser* parser, struct rgsl_qualifiers* qualifiers, enum rgsl_storage storage, enum rgsl_direction direction) {
+    if (qualifiers->has_storage) {
+        rgsl_parser_error(parser, rgsl_parser_line(parser), "more than one storage qualifier before '%s'", rgsl_token_spelling(rgsl_parser_kind(parser)));
+        return false;
+    }
+    qualifiers->has_storage = true;
+    qualifiers->storage = storage;
+    qualifiers->direction = direction;
+    return true;
+}
+
+static bool rgsl_parse_qualifiers(struct rgsl_parser* parser, struct rgsl_qualifiers* qualifiers) {
+    memset(qualifiers, 0, sizeof(*qualifiers));
+    qualifiers->layout = NO_LAYOUT;
+    qualifiers->line = rgsl_parser_line(parser);
+    for (;;) {
+        bool ok = true;
+        switch (rgsl_parser_kind(parser)) {
+            case RGSL_TOKEN_LAYOUT:
+                qualifiers->present = true;
+                if (!rgsl_parse_layout_qualifiers(parser, qualifiers)) {
+                    return false;
+                }
+                continue;
+            case RGSL_TOKEN_CONST: qualifiers->is_const = true; break;
+            case RGSL_TOKEN_IN: ok = rgsl_set_storage(parser, qualifiers, RGSL_STORAGE_IN, RGSL_DIRECTION_IN); break;
+            case RGSL_TOKEN_OUT: ok = rgsl_set_storage(parser, qualifiers, RGSL_STORAGE_OUT, RGSL_DIRECTION_OUT); break;
+            case RGSL_TOKEN_INOUT: ok = rgsl_set_storage(parser, qualifiers, RGSL_STORAGE_PARAMETER, RGSL_DIRECTION_INOUT); break;
+            case RGSL_TOKEN_UNIFORM: ok = rgsl_set_storage(parser, qualifiers, RGSL_STORAGE_UNIFORM, RGSL_DIRECTION_IN); break;
+            case RGSL_TOKEN_BUFFER: ok = rgsl_set_storage(parser, qualifiers, RGSL_STORAGE_BUFFER, RGSL_DIRECTION_IN); break;
+            case RGSL_TOKEN_FLAT: qualifiers->interpolation = RGSL_INTERPOLATION_FLAT; break;
+            case RGSL_TOKEN_SMOOTH: qualifiers->interpolation = RGSL_INTERPOLATION_SMOOTH; break;
+            case RGSL_TOKEN_NOPERSPECTIVE: qualifiers->interpolation = RGSL_INTERPOLATION_NOPERSPECTIVE; break;
+            case RGSL_TOKEN_HIGHP: qualifiers->precision = RGSL_PRECISION_HIGH; break;
+            case RGSL_TOKEN_MEDIUMP: qualifiers->precision = RGSL_PRECISION_MEDIUM; break;
+            case RGSL_TOKEN_LOWP: qualifiers->precision = RGSL_PRECISION_LOW; break;
+            case RGSL_TOKEN_READONLY: qualifiers->memory |= RGSL_MEMORY_READONLY; break;
+            case RGSL_TOKEN_WRITEONLY: qualifiers->memory |= RGSL_MEMORY_WRITEONLY; break;
+            case RGSL_TOKEN_COHERENT: qualifiers->memory |= RGSL_MEMORY_COHERENT; break;
+            case RGSL_TOKEN_VOLATILE: qualifiers->memory |= RGSL_MEMORY_VOLATILE; break;
+            case RGSL_TOKEN_RESTRICT: qualifiers->memory |= RGSL_MEMORY_RESTRICT; break;
+            default:
+                return true;
+        }
+        if (!ok) {
+            return false;
+        }
+        qualifiers->present = true;
+        rgsl_parser_advance(parser);
+    }
+}
+
+static struct rgsl_struct_decl* rgsl_parse_struct(struct rgsl_parser* parser);
+
+// Reads a type name, or a structure declaration, without array suffix.
+static const struct rgsl_type* rgsl_parse_type(struct rgsl_parser* parser) {
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_STRUCT) {
+        struct rgsl_struct_decl* structure = rgsl_parse_struct(parser);
+        return structure != NULL ? structure->type : NULL;
+    }
+    if (!rgsl_parser_is_type_name(&parser->current)) {
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER) {
+            rgsl_parser_error(parser, rgsl_parser_line(parser), "unknown type %s", parser->current.name->text);
+        } else {
+            rgsl_parser_unexpected(parser, "a type");
+        }
+        return NULL;
+    }
+    const struct rgsl_type* type = rgsl_parser_named_type(parser->current.name);
+    rgsl_parser_advance(parser);
+    return type;
+}
+
+// Reads the fields of a structure or the members of a block, after the opening brace.
+static bool rgsl_parse_fields(struct rgsl_parser* parser, struct rgsl_struct_decl* structure, bool block) {
+    uint32_t capacity = 0;
+    while (rgsl_parser_kind(parser) != RGSL_TOKEN_RIGHT_BRACE) {
+        if (rgsl_parser_stopped(parser)) {
+            rgsl_parser_unexpected(parser, "'}'");
+            return false;
+        }
+        struct rgsl_qualifiers qualifiers;
+        if (!rgsl_parse_qualifiers(parser, &qualifiers)) {
+            return false;
+        }
+        if (qualifiers.has_storage || qualifiers.is_const || qualifiers.interpolation != RGSL_INTERPOLATION_NONE || qualifiers.has_layout ||
+            (!block && qualifiers.memory != 0)) {
+            rgsl_parser_error(parser, qualifiers.line, "only precision%s qualifiers are allowed on members", block ? " and memory" : "");
+            return false;
+        }
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_STRUCT) {
+            rgsl_parser_error(parser, rgsl_parser_line(parser), "structures must be declared at global scope%s", "");
+            return false;
+        }
+        const struct rgsl_type* type = rgsl_parse_type(parser);
+        if (type == NULL) {
+            return false;
+        }
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+            type = rgsl_parse_array_suffix(parser, type);
+            if (type == NULL) {
+                return false;
+            }
+        }
+        do {
+            uint32_t line = rgsl_parser_line(parser);
+            const char* name = rgsl_parser_identifier(parser, "a member name");
+            if (name == NULL) {
+                return false;
+            }
+            const struct rgsl_type* field_type = type;
+            if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+                field_type = rgsl_parse_array_suffix(parser, type);
+                if (field_type == NULL) {
+                    return false;
+                }
+            }
+            if (structure->field_count == capacity) {
+                uint32_t new_capacity = capacity ? capacity * 2 : 8;
+                structure->fields = (struct rgsl_field *)rgsl_arena_grow(&parser->module->arena, structure->fields, capacity * sizeof(struct rgsl_field), new_capacity * sizeof(struct rgsl_field));
+                capacity = new_capacity;
+            }
+            struct rgsl_field* field = &structure->fields[structure->field_count++];
+            field->name = name;
+            field->type = field_type;
+            field->precision = qualifiers.precision;
+            field->memory = qualifiers.memory;
+            field->line = line;
+        } while (rgsl_parser_accept(parser, RGSL_TOKEN_COMMA));
+        if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+            return false;
+        }
+    }
+    rgsl_parser_advance(parser);
+    if (structure->field_count == 0) {
+        rgsl_parser_error(parser, structure->line, "%s has no member", structure->name);
+        return false;
+    }
+    return true;
+}
+
+static struct rgsl_struct_decl* rgsl_parse_struct(struct rgsl_parser* parser) {
+    uint32_t line = rgsl_parser_line(parser);
+    rgsl_parser_advance(parser);
+    if (rgsl_parser_kind(parser) != RGSL_TOKEN_IDENTIFIER) {
+        rgsl_parser_unexpected(parser, "a structure name");
+        return NULL;
+    }
+    struct rgsl_name* name = parser->current.name;
+    if (name->builtin_type != NULL || name->structure != NULL) {
+        rgsl_parser_error(parser, line, "type %s is already declared", name->text);
+        return NULL;
+    }
+    rgsl_parser_advance(parser);
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_BRACE)) {
+        return NULL;
+    }
+    struct rgsl_struct_decl* structure = (struct rgsl_struct_decl *)rgsl_parser_alloc(parser, sizeof(struct rgsl_struct_decl));
+    structure->name = name->text;
+    structure->line = line;
+    structure->type = (struct rgsl_type *)rgsl_parser_alloc(parser, sizeof(struct rgsl_type));
+    structure->type->kind = RGSL_TYPE_STRUCT;
+    structure->type->name = name->text;
+    structure->type->structure = structure;
+    if (!rgsl_parse_fields(parser, structure, false)) {
+        return NULL;
+    }
+    // Declared once complete, so that a structure cannot hold itself.
+    name->structure = structure;
+    struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_STRUCT, line);
+    global->structure = structure;
+    return structure;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Statements                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static struct rgsl_stmt* rgsl_parse_statement(struct rgsl_parser* parser, struct rgsl_stmt** out_last);
+
+static struct rgsl_stmt* rgsl_new_stmt(struct rgsl_parser* parser, enum rgsl_stmt_kind kind, uint32_t line) {
+    struct rgsl_stmt* stmt = (struct rgsl_stmt *)rgsl_parser_alloc(parser, sizeof(struct rgsl_stmt));
+    stmt->kind = kind;
+    stmt->line = line;
+    return stmt;
+}
+
+static struct rgsl_variable* rgsl_new_variable(struct rgsl_parser* parser, const char* name, const struct rgsl_type* type, const struct rgsl_qualifiers* qualifiers, uint32_t line) {
+    struct rgsl_variable* variable = (struct rgsl_variable *)rgsl_parser_alloc(parser, sizeof(struct rgsl_variable));
+    variable->name = name;
+    variable->type = type;
+    variable->storage = qualifiers->has_storage ? qualifiers->storage : RGSL_STORAGE_LOCAL;
+    variable->direction = qualifiers->direction;
+    variable->interpolation = qualifiers->interpolation;
+    variable->precision = qualifiers->precision;
+    variable->memory = qualifiers->memory;
+    variable->is_const = qualifiers->is_const;
+    variable->layout = qualifiers->layout;
+    variable->line = line;
+    variable->id = parser->module->variable_count++;
+    return variable;
+}
+
+static bool rgsl_token_starts_declaration(struct rgsl_parser* parser) {
+    switch (rgsl_parser_kind(parser)) {
+        case RGSL_TOKEN_CONST:
+        case RGSL_TOKEN_HIGHP:
+        case RGSL_TOKEN_MEDIUMP:
+        case RGSL_TOKEN_LOWP:
+        case RGSL_TOKEN_STRUCT:
+        case RGSL_TOKEN_LAYOUT:
+        case RGSL_TOKEN_IN:
+        case RGSL_TOKEN_OUT:
+        case RGSL_TOKEN_INOUT:
+        case RGSL_TOKEN_UNIFORM:
+        case RGSL_TOKEN_BUFFER:
+        case RGSL_TOKEN_FLAT:
+        case RGSL_TOKEN_SMOOTH:
+        case RGSL_TOKEN_NOPERSPECTIVE:
+            return true;
+        case RGSL_TOKEN_IDENTIFIER: {
+            if (!rgsl_parser_is_type_name(&parser->current)) {
+                return false;
+            }
+            enum rgsl_token_kind next = rgsl_parser_peek(parser)->token.kind;
+            return next == RGSL_TOKEN_IDENTIFIER || next == RGSL_TOKEN_LEFT_BRACKET;
+        }
+        default:
+            return false;
+    }
+}
+
+// Reads the declarators of a local declaration, each becoming a declaration statement.
+static struct rgsl_stmt* rgsl_parse_local_declaration(struct rgsl_parser* parser, struct rgsl_stmt** out_last) {
+    struct rgsl_qualifiers qualifiers;
+    if (!rgsl_parse_qualifiers(parser, &qualifiers)) {
+        return NULL;
+    }
+    if (qualifiers.has_storage || qualifiers.has_layout || qualifiers.interpolation != RGSL_INTERPOLATION_NONE || qualifiers.memory != 0) {
+        rgsl_parser_error(parser, qualifiers.line, "only const and precision qualifiers are allowed on local variables%s", "");
+        return NULL;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_STRUCT) {
+        rgsl_parser_error(parser, rgsl_parser_line(parser), "structures must be declared at global scope%s", "");
+        return NULL;
+    }
+    const struct rgsl_type* type = rgsl_parse_type(parser);
+    if (type == NULL) {
+        return NULL;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+        type = rgsl_parse_array_suffix(parser, type);
+        if (type == NULL) {
+            return NULL;
+        }
+    }
+    struct rgsl_stmt* first = NULL;
+    struct rgsl_stmt* last = NULL;
+    do {
+        uint32_t line = rgsl_parser_line(parser);
+        const char* name = rgsl_parser_identifier(parser, "a variable name");
+        if (name == NULL) {
+            return NULL;
+        }
+        const struct rgsl_type* variable_type = type;
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+            variable_type = rgsl_parse_array_suffix(parser, type);
+            if (variable_type == NULL) {
+                return NULL;
+            }
+        }
+        struct rgsl_stmt* stmt = rgsl_new_stmt(parser, RGSL_STMT_DECLARATION, line);
+        stmt->variable = rgsl_new_variable(parser, name, variable_type, &qualifiers, line);
+        if (rgsl_parser_accept(parser, RGSL_TOKEN_EQUAL)) {
+            stmt->variable->initializer = rgsl_parse_assignment(parser);
+            if (stmt->variable->initializer == NULL) {
+                return NULL;
+            }
+        }
+        if (last != NULL) {
+            last->next = stmt;
+        } else {
+            first = stmt;
+        }
+        last = stmt;
+    } while (rgsl_parser_accept(parser, RGSL_TOKEN_COMMA));
+    *out_last = last;
+    return first;
+}
+
+static struct rgsl_stmt* rgsl_parse_block(struct rgsl_parser* parser) {
+    struct rgsl_stmt* block = rgsl_new_stmt(parser, RGSL_STMT_BLOCK, rgsl_parser_line(parser));
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_BRACE)) {
+        return NULL;
+    }
+    struct rgsl_stmt* last = NULL;
+    while (rgsl_parser_kind(parser) != RGSL_TOKEN_RIGHT_BRACE) {
+        if (rgsl_parser_stopped(parser)) {
+            rgsl_parser_unexpected(parser, "'}'");
+            return block;
+        }
+        struct rgsl_stmt* statement_last = NULL;
+        struct rgsl_stmt* statement = rgsl_parse_statement(parser, &statement_last);
+        if (statement == NULL) {
+            rgsl_parser_synchronize(parser);
+            continue;
+        }
+        if (last != NULL) {
+            last->next = statement;
+        } else {
+            block->body = statement;
+        }
+        last = statement_last;
+    }
+    rgsl_parser_advance(parser);
+    return block;
+}
+
+static struct rgsl_expr* rgsl_parse_condition(struct rgsl_parser* parser) {
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_PAREN)) {
+        return NULL;
+    }
+    struct rgsl_expr* condition = rgsl_parse_expression(parser);
+    if (condition == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN)) {
+        return NULL;
+    }
+    return condition;
+}
+
+// Reads a statement that is its own last statement, as the bodies of loops and branches are.
+static struct rgsl_stmt* rgsl_parse_substatement(struct rgsl_parser* parser) {
+    uint32_t line = rgsl_parser_line(parser);
+    struct rgsl_stmt* last = NULL;
+    struct rgsl_stmt* stmt = rgsl_parse_statement(parser, &last);
+    if (stmt != NULL && stmt != last) {
+        // A declaration of several variables is scoped like a block of its own.
+        struct rgsl_stmt* block = rgsl_new_stmt(parser, RGSL_STMT_BLOCK, line);
+        block->body = stmt;
+        return block;
+    }
+    return stmt;
+}
+
+static struct rgsl_stmt* rgsl_parse_for(struct rgsl_parser* parser, struct rgsl_stmt* stmt) {
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_PAREN)) {
+        return NULL;
+    }
+    if (!rgsl_parser_accept(parser, RGSL_TOKEN_SEMICOLON)) {
+        struct rgsl_stmt* last = NULL;
+        if (rgsl_token_starts_declaration(parser)) {
+            stmt->init = rgsl_parse_local_declaration(parser, &last);
+        } else {
+            stmt->init = rgsl_new_stmt(parser, RGSL_STMT_EXPRESSION, rgsl_parser_line(parser));
+            stmt->init->expr = rgsl_parse_expression(parser);
+            if (stmt->init->expr == NULL) {
+                return NULL;
+            }
+        }
+        if (stmt->init == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+            return NULL;
+        }
+    }
+    if (rgsl_parser_kind(parser) != RGSL_TOKEN_SEMICOLON) {
+        stmt->expr = rgsl_parse_expression(parser);
+        if (stmt->expr == NULL) {
+            return NULL;
+        }
+    }
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+        return NULL;
+    }
+    if (rgsl_parser_kind(parser) != RGSL_TOKEN_RIGHT_PAREN) {
+        stmt->step = rgsl_parse_expression(parser);
+        if (stmt->step == NULL) {
+            return NULL;
+        }
+    }
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_RIGHT_PAREN)) {
+        return NULL;
+    }
+    stmt->body = rgsl_parse_substatement(parser);
+    return stmt->body != NULL ? stmt : NULL;
+}
+
+static struct rgsl_stmt* rgsl_parse_statement(struct rgsl_parser* parser, struct rgsl_stmt** out_last) {
+    uint32_t line = rgsl_parser_line(parser);
+    enum rgsl_token_kind kind = rgsl_parser_kind(parser);
+    struct rgsl_stmt* stmt = NULL;
+    *out_last = NULL;
+    switch (kind) {
+        case RGSL_TOKEN_LEFT_BRACE:
+            stmt = rgsl_parse_block(parser);
+            break;
+        case RGSL_TOKEN_IF:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_IF, line);
+            stmt->expr = rgsl_parse_condition(parser);
+            if (stmt->expr == NULL || (stmt->body = rgsl_parse_substatement(parser)) == NULL) {
+                return NULL;
+            }
+            if (rgsl_parser_accept(parser, RGSL_TOKEN_ELSE) && (stmt->else_branch = rgsl_parse_substatement(parser)) == NULL) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_FOR:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_parse_for(parser, rgsl_new_stmt(parser, RGSL_STMT_FOR, line));
+            break;
+        case RGSL_TOKEN_WHILE:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_WHILE, line);
+            stmt->expr = rgsl_parse_condition(parser);
+            if (stmt->expr == NULL || (stmt->body = rgsl_parse_substatement(parser)) == NULL) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_DO:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_DO_WHILE, line);
+            if ((stmt->body = rgsl_parse_substatement(parser)) == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_WHILE)) {
+                return NULL;
+            }
+            stmt->expr = rgsl_parse_condition(parser);
+            if (stmt->expr == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_SWITCH:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_SWITCH, line);
+            stmt->expr = rgsl_parse_condition(parser);
+            if (stmt->expr == NULL || (stmt->body = rgsl_parse_block(parser)) == NULL) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_CASE:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_CASE, line);
+            stmt->expr = rgsl_parse_conditional(parser);
+            if (stmt->expr == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_COLON)) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_DEFAULT:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_DEFAULT, line);
+            if (!rgsl_parser_expect(parser, RGSL_TOKEN_COLON)) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_BREAK:
+        case RGSL_TOKEN_CONTINUE:
+        case RGSL_TOKEN_DISCARD:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, kind == RGSL_TOKEN_BREAK ? RGSL_STMT_BREAK : kind == RGSL_TOKEN_CONTINUE ? RGSL_STMT_CONTINUE : RGSL_STMT_DISCARD, line);
+            if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_RETURN:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_RETURN, line);
+            if (rgsl_parser_kind(parser) != RGSL_TOKEN_SEMICOLON && (stmt->expr = rgsl_parse_expression(parser)) == NULL) {
+                return NULL;
+            }
+            if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+                return NULL;
+            }
+            break;
+        case RGSL_TOKEN_SEMICOLON:
+            rgsl_parser_advance(parser);
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_EMPTY, line);
+            break;
+        case RGSL_TOKEN_PRECISION:
+            // Default precisions only matter to the backends, which declare their own.
+            while (!rgsl_parser_stopped(parser) && !rgsl_parser_accept(parser, RGSL_TOKEN_SEMICOLON)) {
+                rgsl_parser_advance(parser);
+            }
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_EMPTY, line);
+            break;
+        default:
+            if (rgsl_token_starts_declaration(parser)) {
+                struct rgsl_stmt* last = NULL;
+                stmt = rgsl_parse_local_declaration(parser, &last);
+                if (stmt == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+                    return NULL;
+                }
+                *out_last = last;
+                return stmt;
+            }
+            stmt = rgsl_new_stmt(parser, RGSL_STMT_EXPRESSION, line);
+            stmt->expr = rgsl_parse_expression(parser);
+            if (stmt->expr == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+                return NULL;
+            }
+            break;
+    }
+    *out_last = stmt;
+    return stmt;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Global declarations                                                        */
+/* -------------------------------------------------------------------------- */
+
+static bool rgsl_parse_block_declaration(struct rgsl_parser* parser, const struct rgsl_qualifiers* qualifiers) {
+    struct rgsl_name* name = parser->current.name;
+    uint32_t line = rgsl_parser_line(parser);
+    if (qualifiers->storage != RGSL_STORAGE_UNIFORM && qualifiers->storage != RGSL_STORAGE_BUFFER) {
+        rgsl_parser_error(parser, line, "only uniform and buffer blocks are supported, %s is an %s block", name->text);
+        return false;
+    }
+    rgsl_parser_advance(parser);
+    rgsl_parser_advance(parser);
+    struct rgsl_block* block = (struct rgsl_block *)rgsl_parser_alloc(parser, sizeof(struct rgsl_block));
+    block->members.name = name->text;
+    block->members.line = line;
+    block->members.type = (struct rgsl_type *)rgsl_parser_alloc(parser, sizeof(struct rgsl_type));
+    block->members.type->kind = RGSL_TYPE_STRUCT;
+    block->members.type->name = name->text;
+    block->members.type->structure = &block->members;
+    block->storage = qualifiers->storage;
+    block->layout = qualifiers->layout;
+    block->memory = qualifiers->memory;
+    if (!rgsl_parse_fields(parser, &block->members, true)) {
+        return false;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER) {
+        uint32_t instance_line = rgsl_parser_line(parser);
+        const char* instance_name = rgsl_parser_identifier(parser, "an instance name");
+        const struct rgsl_type* type = block->members.type;
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+            type = rgsl_parse_array_suffix(parser, type);
+            if (type == NULL) {
+                return false;
+            }
+        }
+        block->instance = rgsl_new_variable(parser, instance_name, type, qualifiers, instance_line);
+        block->instance->block = block;
+    }
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+        return false;
+    }
+    struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_BLOCK, line);
+    global->block = block;
+    return true;
+}
+
+static bool rgsl_parse_parameters(struct rgsl_parser* parser, struct rgsl_function* function) {
+    if (!rgsl_parser_expect(parser, RGSL_TOKEN_LEFT_PAREN)) {
+        return false;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER && parser->current.name->builtin_type == rgsl_builtin_type(RGSL_BUILTIN_VOID) &&
+        rgsl_parser_peek(parser)->token.kind == RGSL_TOKEN_RIGHT_PAREN) {
+        rgsl_parser_advance(parser);
+    }
+    uint32_t capacity = 0;
+    while (rgsl_parser_kind(parser) != RGSL_TOKEN_RIGHT_PAREN) {
+        if (function->parameter_count > 0 && !rgsl_parser_expect(parser, RGSL_TOKEN_COMMA)) {
+            return false;
+        }
+        struct rgsl_qualifiers qualifiers;
+        uint32_t line = rgsl_parser_line(parser);
+        if (!rgsl_parse_qualifiers(parser, &qualifiers)) {
+            return false;
+        }
+        if ((qualifiers.has_storage && qualifiers.storage != RGSL_STORAGE_IN && qualifiers.storage != RGSL_STORAGE_OUT && qualifiers.storage != RGSL_STORAGE_PARAMETER) ||
+            qualifiers.has_layout || qualifiers.interpolation != RGSL_INTERPOLATION_NONE || qualifiers.memory != 0) {
+            rgsl_parser_error(parser, line, "only const, in, out, inout and precision qualifiers are allowed on parameters%s", "");
+            return false;
+        }
+        qualifiers.has_storage = true;
+        qualifiers.storage = RGSL_STORAGE_PARAMETER;
+        const struct rgsl_type* type = rgsl_parse_type(parser);
+        if (type == NULL) {
+            return false;
+        }
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+            type = rgsl_parse_array_suffix(parser, type);
+        }
+        const char* name = NULL;
+        if (type != NULL && rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER) {
+            name = parser->current.name->text;
+            rgsl_parser_advance(parser);
+            if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+                type = rgsl_parse_array_suffix(parser, type);
+            }
+        }
+        if (type == NULL) {
+            return false;
+        }
+        if (function->parameter_count == capacity) {
+            uint32_t new_capacity = capacity ? capacity * 2 : 4;
+            function->parameters = (struct rgsl_variable **)rgsl_arena_grow(&parser->module->arena, function->parameters, capacity * sizeof(struct rgsl_variable*), new_capacity * sizeof(struct rgsl_variable*));
+            capacity = new_capacity;
+        }
+        function->parameters[function->parameter_count++] = rgsl_new_variable(parser, name, type, &qualifiers, line);
+    }
+    rgsl_parser_advance(parser);
+    return true;
+}
+
+static bool rgsl_parse_function(struct rgsl_parser* parser, const struct rgsl_type* return_type, const char* name, uint32_t line) {
+    struct rgsl_function* function = (struct rgsl_function *)rgsl_parser_alloc(parser, sizeof(struct rgsl_function));
+    function->name = name;
+    function->return_type = return_type;
+    function->line = line;
+    function->id = parser->module->function_count++;
+    if (!rgsl_parse_parameters(parser, function)) {
+        return false;
+    }
+    struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_FUNCTION, line);
+    global->function = function;
+    if (rgsl_parser_accept(parser, RGSL_TOKEN_SEMICOLON)) {
+        return true;
+    }
+    function->definition = function;
+    function->body = rgsl_parse_block(parser);
+    return function->body != NULL;
+}
+
+static bool rgsl_parse_precision_declaration(struct rgsl_parser* parser) {
+    uint32_t line = rgsl_parser_line(parser);
+    rgsl_parser_advance(parser);
+    struct rgsl_qualifiers qualifiers;
+    if (!rgsl_parse_qualifiers(parser, &qualifiers)) {
+        return false;
+    }
+    const struct rgsl_type* type = rgsl_parse_type(parser);
+    if (type == NULL || !rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+        return false;
+    }
+    if (qualifiers.precision == RGSL_PRECISION_NONE || qualifiers.has_storage || qualifiers.has_layout) {
+        rgsl_parser_error(parser, line, "expected a precision qualifier and a type after precision%s", "");
+        return false;
+    }
+    if (type->kind != RGSL_TYPE_SAMPLER && type != rgsl_builtin_type(RGSL_BUILTIN_FLOAT) && type != rgsl_builtin_type(RGSL_BUILTIN_INT)) {
+        rgsl_parser_error(parser, line, "default precisions apply to float, int and samplers, not to %s", type->name);
+        return false;
+    }
+    struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_PRECISION, line);
+    global->precision_type = type;
+    global->precision = qualifiers.precision;
+    return true;
+}
+
+static bool rgsl_parse_global(struct rgsl_parser* parser) {
+    if (rgsl_parser_accept(parser, RGSL_TOKEN_SEMICOLON)) {
+        return true;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_PRECISION) {
+        return rgsl_parse_precision_declaration(parser);
+    }
+    struct rgsl_qualifiers qualifiers;
+    if (!rgsl_parse_qualifiers(parser, &qualifiers)) {
+        return false;
+    }
+    if (qualifiers.has_local_size || (qualifiers.has_layout && rgsl_parser_kind(parser) == RGSL_TOKEN_SEMICOLON)) {
+        // Layout declaration, e.g. "layout(local_size_x = 8) in;".
+        if (!rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON)) {
+            return false;
+        }
+        if (!qualifiers.has_local_size || qualifiers.storage != RGSL_STORAGE_IN) {
+            rgsl_parser_error(parser, qualifiers.line, "only \"layout(local_size_x = X, ...) in;\" may declare no variable%s", "");
+            return false;
+        }
+        struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_LAYOUT, qualifiers.line);
+        for (int i = 0; i < 3; i++) {
+            parser->module->local_size[i] = qualifiers.local_size[i] ? qualifiers.local_size[i] : 1;
+        }
+        (void)global;
+        return true;
+    }
+    if (qualifiers.has_storage && rgsl_parser_kind(parser) == RGSL_TOKEN_IDENTIFIER && !rgsl_parser_is_type_name(&parser->current) &&
+        rgsl_parser_peek(parser)->token.kind == RGSL_TOKEN_LEFT_BRACE) {
+        return rgsl_parse_block_declaration(parser, &qualifiers);
+    }
+    uint32_t type_line = rgsl_parser_line(parser);
+    bool is_struct = rgsl_parser_kind(parser) == RGSL_TOKEN_STRUCT;
+    const struct rgsl_type* type = rgsl_parse_type(parser);
+    if (type == NULL) {
+        return false;
+    }
+    if (is_struct && rgsl_parser_accept(parser, RGSL_TOKEN_SEMICOLON)) {
+        if (qualifiers.present) {
+            rgsl_parser_error(parser, type_line, "qualifiers on a structure declaration without variable%s", "");
+            return false;
+        }
+        return true;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+        type = rgsl_parse_array_suffix(parser, type);
+        if (type == NULL) {
+            return false;
+        }
+    }
+    uint32_t line = rgsl_parser_line(parser);
+    const char* name = rgsl_parser_identifier(parser, "a name");
+    if (name == NULL) {
+        return false;
+    }
+    if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_PAREN) {
+        if (qualifiers.present && (qualifiers.has_storage || qualifiers.is_const || qualifiers.has_layout || qualifiers.interpolation != RGSL_INTERPOLATION_NONE || qualifiers.memory != 0)) {
+            rgsl_parser_error(parser, qualifiers.line, "only a precision qualifier is allowed on the return type of %s", name);
+            return false;
+        }
+        return rgsl_parse_function(parser, type, name, line);
+    }
+    if (!qualifiers.has_storage) {
+        qualifiers.has_storage = true;
+        qualifiers.storage = RGSL_STORAGE_GLOBAL;
+    } else if (qualifiers.storage == RGSL_STORAGE_BUFFER || qualifiers.storage == RGSL_STORAGE_PARAMETER) {
+        rgsl_parser_error(parser, qualifiers.line, "%s variables must be declared in a block or as parameters", qualifiers.storage == RGSL_STORAGE_BUFFER ? "buffer" : "inout");
+        return false;
+    }
+    for (;;) {
+        const struct rgsl_type* variable_type = type;
+        if (rgsl_parser_kind(parser) == RGSL_TOKEN_LEFT_BRACKET) {
+            variable_type = rgsl_parse_array_suffix(parser, type);
+            if (variable_type == NULL) {
+                return false;
+            }
+        }
+        struct rgsl_global* global = rgsl_module_add_global(parser->module, RGSL_GLOBAL_VARIABLE, line);
+        global->variable = rgsl_new_variable(parser, name, variable_type, &qualifiers, line);
+        if (rgsl_parser_accept(parser, RGSL_TOKEN_EQUAL)) {
+            global->variable->initializer = rgsl_parse_assignment(parser);
+            if (global->variable->initializer == NULL) {
+                return false;
+            }
+        }
+        if (!rgsl_parser_accept(parser, RGSL_TOKEN_COMMA)) {
+            break;
+        }
+        line = rgsl_parser_line(parser);
+        name = rgsl_parser_identifier(parser, "a variable name");
+        if (name == NULL) {
+            return false;
+        }
+    }
+    return rgsl_parser_expect(parser, RGSL_TOKEN_SEMICOLON);
+}
+
+bool rgsl_rgsl_parse(struct rgsl_module* module, const char* code, size_t length) {
+    struct rgsl_parser parser;
+    memset(&parser, 0, sizeof(parser));
+    parser.module = module;
+    parser.name_capacity = RGSL_NAME_TABLE_SIZE;
+    parser.names = (struct rgsl_name **)rgsl_calloc(parser.name_capacity, sizeof(struct rgsl_name*));
+    rgsl_lexer_init(&parser.lexers[0], code, length, 1);
+    uint32_t errors = module->error_count;
+    rgsl_parser_advance(&parser);
+    while (!rgsl_parser_stopped(&parser)) {
+        if (!rgsl_parse_global(&parser)) {
+            rgsl_parser_synchronize(&parser);
+        }
+    }
+    if (module->error_count >= RGSL_MAX_ERRORS) {
+        rgsl_module_warning(module, parser.current.token.line, "too many errors, parsing stopped");
+    }
+    rgsl_free(parser.names);
+    return module->error_count == errors;
+}
+
+static int rgsl_rgsl_handle_version_directive(struct rgsl_parser_state* state, const char* value, void* out) {
+    (void)state;
+    (void)out;
+    rgsl_printf_error("RGSL shaders have no #version directive (#version %s), the profile is chosen with --profile.\n", value);
+    return -1;
+}
+
+const struct rgsl_directive_mapping RGSL_DIRECTIVE_MAPPINGS[] = {
+    {"include", rgsl_glsl_handle_include_directive, false},
+    {"version", rgsl_rgsl_handle_version_directive, false},
+    {"define", rgsl_handle_define_directive, false},
+    {"undef", rgsl_handle_undef_directive, false},
+    {"pragma", rgsl_handle_pragma_directive, false},
+    {"if", rgsl_handle_if_directive, true},
+    {"ifdef", rgsl_handle_ifdef_directive, true},
+    {"ifndef", rgsl_handle_ifndef_directive, true},
+    {"elif", rgsl_handle_elif_directive, true},
+    {"else", rgsl_handle_else_directive, true},
+    {"endif", rgsl_handle_endif_directive, true},
+    {NULL, NULL, false} // Sentinel to mark the end of the array
+};
+
+bool rgsl_rgsl_build_module(struct rgsl_shader_data* shader) {
+    if (shader->module != NULL) {
+        return shader->module->error_count == 0;
+    }
+    if (strcmp(shader->stage, "vert") != 0 && strcmp(shader->stage, "frag") != 0 && strcmp(shader->stage, "comp") != 0) {
+        rgsl_printf_error("RGSL shaders are vertex, fragment or compute shaders, %s is a %s shader.\n", shader->path, shader->stage);
+        return false;
+    }
+    if (shader->processed_code == NULL) {
+        rgsl_print_info(1, "Preprocessing RGSL shader code...\n");
+        double start = rgsl_clock_seconds();
+        shader->processed_code = rgsl_parse_shader(RGSL_DIRECTIVE_MAPPINGS, shader, false);
+        shader->native_includes = false;
+        if (shader->processed_code == NULL) {
+            rgsl_print_error("Failed to preprocess RGSL shader code.\n");
+            return false;
+        }
+        rgsl_printf_info(2, "Preprocessed in %.3f ms\n", rgsl_clock_elapsed_ms(start));
+    }
+    rgsl_print_info(1, "Parsing RGSL shader code...\n");
+    double start = rgsl_clock_seconds();
+    shader->module = (struct rgsl_module *)rgsl_malloc(sizeof(struct rgsl_module));
+    rgsl_module_init(shader->module, shader->path, shader->stage, &shader->line_map);
+    if (rgsl_rgsl_parse(shader->module, shader->processed_code, strlen(shader->processed_code))) {
+        rgsl_rgsl_check(shader->module);
+    }
+    rgsl_printf_info(2, "Parsed and checked %zu tokens in %.3f ms\n", shader->module->token_count, rgsl_clock_elapsed_ms(start));
+    if (shader->module->error_count == 0 && rgsl_rgsl_benchmark_enabled()) {
+        rgsl_rgsl_benchmark(shader);
+    }
+    return shader->module->error_count == 0;
+}
\ No newline at end of file
@@ -0,0 +1,3635 @@
+#include <RGSL/rgsl/spirv.h>
+#include <RGSL/hashmap.h>
+#include <RGSL/layout.h>
+#include <RGSL/spec.h>
+#include <RGSL/termio.h>
+#include <RGSL/text.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define RGSL_SPIRV_MAGIC 0x07230203u
+#define RGSL_SPIRV_VERSION 0x00010000u
+#define RGSL_SPIRV_HEADER_WORDS 5
+
+// Deepest chain of indices and members a reference may go through.
+#define RGSL_SPIRV_MAX_INDICES 32
+// Locations and bindings assigned automatically, per kind of interface.
+#define RGSL_SPIRV_MAX_SLOTS 1024
+// Block index of the code after a branch, until the next block starts.
+#define RGSL_SPIRV_NO_BLOCK UINT32_MAX
+
+enum rgsl_spirv_opcode {
+    RGSL_OP_UNDEF = 1,
+    RGSL_OP_NAME = 5,
+    RGSL_OP_MEMBER_NAME = 6,
+    RGSL_OP_EXTENSION = 10,
+    RGSL_OP_EXT_INST_IMPORT = 11,
+    RGSL_OP_EXT_INST = 12,
+    RGSL_OP_MEMORY_MODEL = 14,
+    RGSL_OP_ENTRY_POINT = 15,
+    RGSL_OP_EXECUTION_MODE = 16,
+    RGSL_OP_CAPABILITY = 17,
+    RGSL_OP_TYPE_VOID = 19,
+    RGSL_OP_TYPE_BOOL = 20,
+    RGSL_OP_TYPE_INT = 21,
+    RGSL_OP_TYPE_FLOAT = 22,
+    RGSL_OP_TYPE_VECTOR = 23,
+    RGSL_OP_TYPE_MATRIX = 24,
+    RGSL_OP_TYPE_IMAGE = 25,
+    RGSL_OP_TYPE_SAMPLED_IMAGE = 27,
+    RGSL_OP_TYPE_ARRAY = 28,
+    RGSL_OP_TYPE_RUNTIME_ARRAY = 29,
+    RGSL_OP_TYPE_STRUCT = 30,
+    RGSL_OP_TYPE_POINTER = 32,
+    RGSL_OP_TYPE_FUNCTION = 33,
+    RGSL_OP_CONSTANT_TRUE = 41,
+    RGSL_OP_CONSTANT_FALSE = 42,
+    RGSL_OP_CONSTANT = 43,
+    RGSL_OP_CONSTANT_COMPOSITE = 44,
+    RGSL_OP_SPEC_CONSTANT_TRUE = 48,
+    RGSL_OP_SPEC_CONSTANT_FALSE = 49,
+    RGSL_OP_SPEC_CONSTANT = 50,
+    RGSL_OP_FUNCTION = 54,
+    RGSL_OP_FUNCTION_PARAMETER = 55,
+    RGSL_OP_FUNCTION_END = 56,
+    RGSL_OP_FUNCTION_CALL = 57,
+    RGSL_OP_VARIABLE = 59,
+    RGSL_OP_LOAD = 61,
+    RGSL_OP_STORE = 62,
+    RGSL_OP_ACCESS_CHAIN = 65,
+    RGSL_OP_ARRAY_LENGTH = 68,
+    RGSL_OP_DECORATE = 71,
+    RGSL_OP_MEMBER_DECORATE = 72,
+    RGSL_OP_VECTOR_EXTRACT_DYNAMIC = 77,
+    RGSL_OP_VECTOR_INSERT_DYNAMIC = 78,
+    RGSL_OP_VECTOR_SHUFFLE = 79,
+    RGSL_OP_COMPOSITE_CONSTRUCT = 80,
+    RGSL_OP_COMPOSITE_EXTRACT = 81,
+    RGSL_OP_COMPOSITE_INSERT = 82,
+    RGSL_OP_TRANSPOSE = 84,
+    RGSL_OP_IMAGE_SAMPLE_IMPLICIT_LOD = 87,
+    RGSL_OP_IMAGE_SAMPLE_EXPLICIT_LOD = 88,
+    RGSL_OP_IMAGE_SAMPLE_DREF_IMPLICIT_LOD = 89,
+    RGSL_OP_IMAGE_SAMPLE_DREF_EXPLICIT_LOD = 90,
+    RGSL_OP_IMAGE_FETCH = 95,
+    RGSL_OP_IMAGE = 100,
+    RGSL_OP_IMAGE_QUERY_SIZE_LOD = 103,
+    RGSL_OP_CONVERT_F_TO_U = 109,
+    RGSL_OP_CONVERT_F_TO_S = 110,
+    RGSL_OP_CONVERT_S_TO_F = 111,
+    RGSL_OP_CONVERT_U_TO_F = 112,
+    RGSL_OP_BITCAST = 124,
+    RGSL_OP_S_NEGATE = 126,
+    RGSL_OP_F_NEGATE = 127,
+    RGSL_OP_I_ADD = 128,
+    RGSL_OP_F_ADD = 129,
+    RGSL_OP_I_SUB = 130,
+    RGSL_OP_F_SUB = 131,
+    RGSL_OP_I_MUL = 132,
+    RGSL_OP_F_MUL = 133,
+    RGSL_OP_U_DIV = 134,
+    RGSL_OP_S_DIV = 135,
+    RGSL_OP_F_DIV = 136,
+    RGSL_OP_U_MOD = 137,
+    RGSL_OP_S_REM = 138,
+    RGSL_OP_F_MOD = 141,
+    RGSL_OP_VECTOR_TIMES_SCALAR = 142,
+    RGSL_OP_MATRIX_TIMES_SCALAR = 143,
+    RGSL_OP_VECTOR_TIMES_MATRIX = 144,
+    RGSL_OP_MATRIX_TIMES_VECTOR = 145,
+    RGSL_OP_MATRIX_TIMES_MATRIX = 146,
+    RGSL_OP_DOT = 148,
+    RGSL_OP_ANY = 154,
+    RGSL_OP_ALL = 155,
+    RGSL_OP_IS_NAN = 156,
+    RGSL_OP_IS_INF = 157,
+    RGSL_OP_LOGICAL_EQUAL = 164,
+    RGSL_OP_LOGICAL_NOT_EQUAL = 165,
+    RGSL_OP_LOGICAL_OR = 166,
+    RGSL_OP_LOGICAL_AND = 167,
+    RGSL_OP_LOGICAL_NOT = 168,
+    RGSL_OP_SELECT = 169,
+    RGSL_OP_I_EQUAL = 170,
+    RGSL_OP_I_NOT_EQUAL = 171,
+    RGSL_OP_U_GREATER_THAN = 172,
+    RGSL_OP_S_GREATER_THAN = 173,
+    RGSL_OP_U_GREATER_THAN_EQUAL = 174,
+    RGSL_OP_S_GREATER_THAN_EQUAL = 175,
+    RGSL_OP_U_LESS_THAN = 176,
+    RGSL_OP_S_LESS_THAN = 177,
+    RGSL_OP_U_LESS_THAN_EQUAL = 178,
+    RGSL_OP_S_LESS_THAN_EQUAL = 179,
+    RGSL_OP_F_ORD_EQUAL = 180,
+    RGSL_OP_F_UNORD_NOT_EQUAL = 183,
+    RGSL_OP_F_ORD_LESS_THAN = 184,
+    RGSL_OP_F_ORD_GREATER_THAN = 186,
+    RGSL_OP_F_ORD_LESS_THAN_EQUAL = 188,
+    RGSL_OP_F_ORD_GREATER_THAN_EQUAL = 190,
+    RGSL_OP_SHIFT_RIGHT_LOGICAL = 194,
+    RGSL_OP_SHIFT_RIGHT_ARITHMETIC = 195,
+    RGSL_OP_SHIFT_LEFT_LOGICAL = 196,
+    RGSL_OP_BITWISE_OR = 197,
+    RGSL_OP_BITWISE_XOR = 198,
+    RGSL_OP_BITWISE_AND = 199,
+    RGSL_OP_NOT = 200,
+    RGSL_OP_DPDX = 207,
+    RGSL_OP_DPDY = 208,
+    RGSL_OP_FWIDTH = 209,
+    RGSL_OP_PHI = 245,
+    RGSL_OP_LOOP_MERGE = 246,
+    RGSL_OP_SELECTION_MERGE = 247,
+    RGSL_OP_LABEL = 248,
+    RGSL_OP_BRANCH = 249,
+    RGSL_OP_BRANCH_CONDITIONAL = 250,
+    RGSL_OP_SWITCH = 251,
+    RGSL_OP_KILL = 252,
+    RGSL_OP_RETURN = 253,
+    RGSL_OP_RETURN_VALUE = 254,
+    RGSL_OP_UNREACHABLE = 255
+};
+
+// Instructions of the GLSL.std.450 extended instruction set.
+enum rgsl_spirv_glsl450 {
+    RGSL_GLSL450_ROUND = 1,
+    RGSL_GLSL450_ROUND_EVEN = 2,
+    RGSL_GLSL450_TRUNC = 3,
+    RGSL_GLSL450_F_ABS = 4,
+    RGSL_GLSL450_S_ABS = 5,
+    RGSL_GLSL450_F_SIGN = 6,
+    RGSL_GLSL450_S_SIGN = 7,
+    RGSL_GLSL450_FLOOR = 8,
+    RGSL_GLSL450_CEIL = 9,
+    RGSL_GLSL450_FRACT = 10,
+    RGSL_GLSL450_RADIANS = 11,
+    RGSL_GLSL450_DEGREES = 12,
+    RGSL_GLSL450_SIN = 13,
+    RGSL_GLSL450_COS = 14,
+    RGSL_GLSL450_TAN = 15,
+    RGSL_GLSL450_ASIN = 16,
+    RGSL_GLSL450_ACOS = 17,
+    RGSL_GLSL450_ATAN = 18,
+    RGSL_GLSL450_SINH = 19,
+    RGSL_GLSL450_COSH = 20,
+    RGSL_GLSL450_TANH = 21,
+    RGSL_GLSL450_ASINH = 22,
+    RGSL_GLSL450_ACOSH = 23,
+    RGSL_GLSL450_ATANH = 24,
+    RGSL_GLSL450_ATAN2 = 25,
+    RGSL_GLSL450_POW = 26,
+    RGSL_GLSL450_EXP = 27,
+    RGSL_GLSL450_LOG = 28,
+    RGSL_GLSL450_EXP2 = 29,
+    RGSL_GLSL450_LOG2 = 30,
+    RGSL_GLSL450_SQRT = 31,
+    RGSL_GLSL450_INVERSE_SQRT = 32,
+    RGSL_GLSL450_DETERMINANT = 33,
+    RGSL_GLSL450_MATRIX_INVERSE = 34,
+    RGSL_GLSL450_F_MIN = 37,
+    RGSL_GLSL450_U_MIN = 38,
+    RGSL_GLSL450_S_MIN = 39,
+    RGSL_GLSL450_F_MAX = 40,
+    RGSL_GLSL450_U_MAX = 41,
+    RGSL_GLSL450_S_MAX = 42,
+    RGSL_GLSL450_F_CLAMP = 43,
+    RGSL_GLSL450_U_CLAMP = 44,
+    RGSL_GLSL450_S_CLAMP = 45,
+    RGSL_GLSL450_F_MIX = 46,
+    RGSL_GLSL450_STEP = 48,
+    RGSL_GLSL450_SMOOTH_STEP = 49,
+    RGSL_GLSL450_PACK_SNORM_2X16 = 56,
+    RGSL_GLSL450_PACK_UNORM_2X16 = 57,
+    RGSL_GLSL450_PACK_HALF_2X16 = 58,
+    RGSL_GLSL450_UNPACK_SNORM_2X16 = 60,
+    RGSL_GLSL450_UNPACK_UNORM_2X16 = 61,
+    RGSL_GLSL450_UNPACK_HALF_2X16 = 62,
+    RGSL_GLSL450_LENGTH = 66,
+    RGSL_GLSL450_DISTANCE = 67,
+    RGSL_GLSL450_CROSS = 68,
+    RGSL_GLSL450_NORMALIZE = 69,
+    RGSL_GLSL450_FACE_FORWARD = 70,
+    RGSL_GLSL450_REFLECT = 71,
+    RGSL_GLSL450_REFRACT = 72
+};
+
+enum rgsl_spirv_storage_class {
+    RGSL_SPIRV_STORAGE_UNIFORM_CONSTANT = 0,
+    RGSL_SPIRV_STORAGE_INPUT = 1,
+    RGSL_SPIRV_STORAGE_UNIFORM = 2,
+    RGSL_SPIRV_STORAGE_OUTPUT = 3,
+    RGSL_SPIRV_STORAGE_PRIVATE = 6,
+    RGSL_SPIRV_STORAGE_FUNCTION = 7
+};
+
+enum rgsl_spirv_decoration {
+    RGSL_DECORATION_SPEC_ID = 1,
+    RGSL_DECORATION_BLOCK = 2,
+    RGSL_DECORATION_BUFFER_BLOCK = 3,
+    RGSL_DECORATION_COL_MAJOR = 5,
+    RGSL_DECORATION_ARRAY_STRIDE = 6,
+    RGSL_DECORATION_MATRIX_STRIDE = 7,
+    RGSL_DECORATION_BUILT_IN = 11,
+    RGSL_DECORATION_NO_PERSPECTIVE = 13,
+    RGSL_DECORATION_FLAT = 14,
+    RGSL_DECORATION_RESTRICT = 19,
+    RGSL_DECORATION_VOLATILE = 21,
+    RGSL_DECORATION_COHERENT = 23,
+    RGSL_DECORATION_NON_WRITABLE = 24,
+    RGSL_DECORATION_NON_READABLE = 25,
+    RGSL_DECORATION_LOCATION = 30,
+    RGSL_DECORATION_BINDING = 33,
+    RGSL_DECORATION_OFFSET = 35
+};
+
+enum rgsl_spirv_capability {
+    RGSL_CAPABILITY_SHADER = 1,
+    RGSL_CAPABILITY_IMAGE_GATHER_EXTENDED = 25,
+    RGSL_CAPABILITY_IMAGE_QUERY = 50,
+    RGSL_CAPABILITY_DRAW_PARAMETERS = 4427
+};
+
+enum rgsl_spirv_image_operand {
+    RGSL_IMAGE_OPERAND_BIAS = 0x1,
+    RGSL_IMAGE_OPERAND_LOD = 0x2,
+    RGSL_IMAGE_OPERAND_GRAD = 0x4,
+    RGSL_IMAGE_OPERAND_CONST_OFFSET = 0x8,
+    RGSL_IMAGE_OPERAND_OFFSET = 0x10
+};
+
+#define RGSL_EXECUTION_MODEL_VERTEX 0
+#define RGSL_EXECUTION_MODEL_FRAGMENT 4
+#define RGSL_EXECUTION_MODEL_GL_COMPUTE 5
+#define RGSL_EXECUTION_MODE_ORIGIN_LOWER_LEFT 8
+#define RGSL_EXECUTION_MODE_DEPTH_REPLACING 12
+#define RGSL_EXECUTION_MODE_LOCAL_SIZE 17
+#define RGSL_ADDRESSING_MODEL_LOGICAL 0
+#define RGSL_MEMORY_MODEL_GLSL450 1
+
+/**
+ * Capability a shader may need, with the extension declaring it if any.
+ */
+struct rgsl_spirv_capability_info {
+    enum rgsl_spirv_capability capability;
+    const char* extension;
+};
+
+static const struct rgsl_spirv_capability_info CAPABILITIES[] = {
+    {RGSL_CAPABILITY_SHADER, NULL},
+    {RGSL_CAPABILITY_IMAGE_GATHER_EXTENDED, NULL},
+    {RGSL_CAPABILITY_IMAGE_QUERY, NULL},
+    {RGSL_CAPABILITY_DRAW_PARAMETERS, "SPV_KHR_shader_draw_parameters"}
+};
+
+// Bits of the capabilities needed, in the order of CAPABILITIES.
+#define RGSL_NEEDS_SHADER 1u
+#define RGSL_NEEDS_IMAGE_GATHER_EXTENDED 2u
+#define RGSL_NEEDS_IMAGE_QUERY 4u
+#define RGSL_NEEDS_DRAW_PARAMETERS 8u
+
+// Built-in whose writes need the DepthReplacing execution mode.
+#define RGSL_SPIRV_BUILTIN_FRAG_DEPTH 22
+
+/**
+ * Built-in variable of RGSL, and the SPIR-V built-in it decorates.
+ */
+struct rgsl_spirv_builtin_variable {
+    const char* name;
+    uint32_t builtin;
+    uint32_t needs;
+};
+
+static const struct rgsl_spirv_builtin_variable BUILTIN_VARIABLES[] = {
+    {"gl_BaseInstance", 4425, RGSL_NEEDS_DRAW_PARAMETERS},
+    {"gl_BaseVertex", 4424, RGSL_NEEDS_DRAW_PARAMETERS},
+    {"gl_DrawID", 4426, RGSL_NEEDS_DRAW_PARAMETERS},
+    {"gl_FragCoord", 15, 0},
+    {"gl_FragDepth", RGSL_SPIRV_BUILTIN_FRAG_DEPTH, 0},
+    {"gl_FrontFacing", 17, 0},
+    {"gl_GlobalInvocationID", 28, 0},
+    {"gl_InstanceID", 6, 0},
+    {"gl_LocalInvocationID", 27, 0},
+    {"gl_LocalInvocationIndex", 29, 0},
+    {"gl_NumWorkGroups", 24, 0},
+    {"gl_PointCoord", 16, 0},
+    {"gl_PointSize", 1, 0},
+    {"gl_Position", 0, 0},
+    {"gl_VertexID", 5, 0},
+    {"gl_WorkGroupID", 26, 0}
+};
+
+/* -------------------------------------------------------------------------- */
+/* Emitter                                                                    */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Growable array of words, a section of the module or the code of a block.
+ */
+struct rgsl_spirv_words {
+    uint32_t* data;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * Slot of the table interning types and constants by the words defining them.
+ * The key is the offset of the words in the key pool, preceded by their count.
+ */
+struct rgsl_spirv_interned {
+    uint64_t hash;
+    uint32_t key;
+    uint32_t id;
+};
+
+// What an ID is, in the two high bits of its info, the low ones locating it.
+#define RGSL_SPIRV_ID_PLAIN 0u
+#define RGSL_SPIRV_ID_CONSTANT 1u
+#define RGSL_SPIRV_ID_COMPOSITE 2u
+#define RGSL_SPIRV_ID_PHI 3u
+#define RGSL_SPIRV_ID_KIND(info) ((info) >> 30)
+#define RGSL_SPIRV_ID_DATA(info) ((info) & 0x3FFFFFFFu)
+#define RGSL_SPIRV_ID_INFO(kind, data) (((uint32_t)(kind) << 30) | (uint32_t)(data))
+
+/**
+ * Enumeration of how the value of a variable is reached.
+ *
+ * Memory variables are pointers, and members of anonymous blocks an access into
+ * the pointer to their block. SSA variables have a value per block, and value
+ * variables a single one: samplers passed by value and specialization constants.
+ */
+enum rgsl_spirv_variable_kind {
+    RGSL_SPIRV_VARIABLE_NONE,
+    RGSL_SPIRV_VARIABLE_MEMORY,
+    RGSL_SPIRV_VARIABLE_MEMBER,
+    RGSL_SPIRV_VARIABLE_SSA,
+    RGSL_SPIRV_VARIABLE_VALUE
+};
+
+/**
+ * SPIR-V side of a variable of the module. The layout is 0 for the types of
+ * variables without explicit layout, the packing plus 1 in blocks.
+ */
+struct rgsl_spirv_variable {
+    uint32_t id;
+    uint32_t storage;
+    uint8_t kind;
+    uint8_t layout;
+    int8_t folded;
+};
+
+/**
+ * Layout of a structure with a packing, computed by layout.c.
+ */
+struct rgsl_spirv_layout_entry {
+    const struct rgsl_struct_decl* structure;
+    enum rgsl_layout_packing packing;
+    struct rgsl_block_layout* layout;
+};
+
+struct rgsl_spirv_layouts {
+    struct rgsl_spirv_layout_entry* entries;
+    size_t count;
+    size_t capacity;
+};
+
+/**
+ * Locations and bindings of the interface, assigned like glslang maps them.
+ */
+struct rgsl_spirv_interface {
+    int32_t* locations;
+    int32_t* bindings;
+};
+
+/**
+ * Basic block of the function being emitted. Phis are placed before the code at
+ * the end, once the trivial ones are removed; the fixups are the positions in
+ * the code of phi IDs, which may then be replaced.
+ */
+struct rgsl_spirv_block {
+    uint32_t label;
+    struct rgsl_spirv_words code;
+    struct rgsl_spirv_words fixups;
+    struct rgsl_spirv_words predecessors;
+    struct rgsl_spirv_words incomplete;
+    uint32_t first_phi;
+    bool sealed;
+};
+
+/**
+ * Phi of an SSA variable, or joining the values of the branches of an
+ * expression, replaced by a value when trivial.
+ */
+struct rgsl_spirv_phi {
+    uint32_t id;
+    uint32_t type;
+    uint32_t block;
+    const struct rgsl_variable* variable;
+    struct rgsl_spirv_words operands;
+    uint32_t replacement;
+    uint32_t next;
+};
+
+/**
+ * Value of an SSA variable at the end of a block.
+ */
+struct rgsl_spirv_definition {
+    uint64_t key;
+    uint32_t value;
+};
+
+/**
+ * Blocks a break or continue statement branches to.
+ */
+struct rgsl_spirv_jump_targets {
+    uint32_t break_block;
+    uint32_t continue_block;
+};
+
+/**
+ * Place an expression can be written to or read from: an SSA variable or a
+ * pointer, then the indices of an access chain, then components of a vector,
+ * selected by a swizzle or a constant index, or by a dynamic index.
+ */
+struct rgsl_spirv_ref {
+    const struct rgsl_variable* variable;
+    uint32_t base;
+    uint32_t storage;
+    uint8_t layout;
+    uint32_t indices[RGSL_SPIRV_MAX_INDICES];
+    uint32_t index_count;
+    const struct rgsl_type* type;
+    uint32_t dynamic_component;
+    uint8_t components[4];
+    uint32_t component_count;
+};
+
+struct rgsl_spirv_emitter {
+    struct rgsl_module* module;
+    bool spec_constants;
+    bool fragment;
+    bool failed;
+    bool depth_replacing;
+    uint32_t needs;
+    uint32_t bound;
+    uint32_t* id_info;
+    size_t id_capacity;
+    uint32_t glsl450;
+
+    struct rgsl_spirv_words names;
+    struct rgsl_spirv_words annotations;
+    struct rgsl_spirv_words globals;
+    struct rgsl_spirv_words functions;
+    struct rgsl_spirv_words interface_ids;
+    struct rgsl_spirv_words scratch;
+
+    struct rgsl_spirv_interned* interned;
+    size_t interned_count;
+    size_t interned_capacity;
+    struct rgsl_spirv_words keys;
+
+    uint32_t vector_types[4][5];
+    uint32_t matrix_types[5][5];
+    uint32_t void_type;
+
+    struct rgsl_spirv_variable* variables;
+    uint32_t* function_ids;
+    const struct rgsl_block** blocks_of_structs;
+    size_t block_count;
+    struct rgsl_spirv_layouts layouts;
+    struct rgsl_spirv_interface interface;
+
+    // Function being emitted.
+    const struct rgsl_function* function;
+    struct rgsl_spirv_block* blocks;
+    size_t function_block_count;
+    size_t function_block_capacity;
+    struct rgsl_spirv_words order;
+    struct rgsl_spirv_phi* phis;
+    size_t phi_count;
+    size_t phi_capacity;
+    struct rgsl_spirv_definition* definitions;
+    size_t definition_count;
+    size_t definition_capacity;
+    struct rgsl_spirv_words local_variables;
+    struct rgsl_spirv_jump_targets targets[64];
+    size_t target_count;
+    uint32_t current;
+};
+
+/* -------------------------------------------------------------------------- */
+/* Words and IDs                                                              */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_spirv_reserve(struct rgsl_spirv_words* words, size_t count) {
+    if (words->count + count <= words->capacity) {
+        return;
+    }
+    size_t capacity = (words->capacity != 0) ? words->capacity * 2 : 32;
+    while (capacity < words->count + count) {
+        capacity *= 2;
+    }
+    words->data = (uint32_t *)rgsl_realloc(words->data, capacity * sizeof(uint32_t));
+    words->capacity = capacity;
+}
+
+static void rgsl_spirv_push(struct rgsl_spirv_words* words, uint32_t word) {
+    rgsl_spirv_reserve(words, 1);
+    words->data[words->count++] = word;
+}
+
+static void rgsl_spirv_push_words(struct rgsl_spirv_words* words, const uint32_t* data, size_t count) {
+    rgsl_spirv_reserve(words, count);
+    memcpy(words->data + words->count, data, count * sizeof(uint32_t));
+    words->count += count;
+}
+
+static void rgsl_spirv_words_free(struct rgsl_spirv_words* words) {
+    rgsl_free(words->data);
+    words->data = NULL;
+    words->count = words->capacity = 0;
+}
+
+// Appends an instruction, its word count and opcode followed by its operands.
+static void rgsl_spirv_instruction(struct rgsl_spirv_words* words, uint32_t op, const uint32_t* operands, size_t count) {
+    rgsl_spirv_push(words, (uint32_t)((count + 1) << 16) | op);
+    rgsl_spirv_push_words(words, operands, count);
+}
+
+static size_t rgsl_spirv_string_words(const char* text) {
+    return strlen(text) / 4 + 1;
+}
+
+// Appends a literal string, null-terminated and padded with zeros to a word.
+static void rgsl_spirv_push_string(struct rgsl_spirv_words* words, const char* text) {
+    size_t count = rgsl_spirv_string_words(text);
+    size_t length = strlen(text);
+    rgsl_spirv_reserve(words, count);
+    memset(words->data + words->count, 0, count * sizeof(uint32_t));
+    memcpy(words->data + words->count, text, length);
+    words->count += count;
+}
+
+static uint32_t rgsl_spirv_new_id(struct rgsl_spirv_emitter* e) {
+    uint32_t id = e->bound++;
+    if (id >= e->id_capacity) {
+        size_t capacity = (e->id_capacity != 0) ? e->id_capacity * 2 : 256;
+        e->id_info = (uint32_t *)rgsl_realloc(e->id_info, capacity * sizeof(uint32_t));
+        e->id_capacity = capacity;
+    }
+    e->id_info[id] = RGSL_SPIRV_ID_PLAIN;
+    return id;
+}
+
+static uint32_t rgsl_spirv_id_kind(const struct rgsl_spirv_emitter* e, uint32_t id) {
+    return RGSL_SPIRV_ID_KIND(e->id_info[id]);
+}
+
+static bool rgsl_spirv_is_constant(const struct rgsl_spirv_emitter* e, uint32_t id) {
+    uint32_t kind = rgsl_spirv_id_kind(e, id);
+    return kind == RGSL_SPIRV_ID_CONSTANT || kind == RGSL_SPIRV_ID_COMPOSITE;
+}
+
+// Reports what the backend cannot express, failing the emission.
+static void rgsl_spirv_error(struct rgsl_spirv_emitter* e, uint32_t line, const char* message, const char* name) {
+    rgsl_module_error(e->module, line, message, name);
+    e->failed = true;
+}
+
+/**
+ * Looks up the words defining a type or constant, allocating an ID on a miss,
+ * for the caller to emit the instruction.
+ */
+static bool rgsl_spirv_intern(struct rgsl_spirv_emitter* e, const uint32_t* key, uint32_t count, uint32_t* out_id, uint32_t* out_key) {
+    if ((e->interned_count + 1) * 4 > e->interned_capacity * 3) {
+        size_t capacity = (e->interned_capacity != 0) ? e->interned_capacity * 2 : 256;
+        struct rgsl_spirv_interned* table = (struct rgsl_spirv_interned *)rgsl_calloc(capacity, sizeof(struct rgsl_spirv_interned));
+        for (size_t i = 0; i < e->interned_capacity; i++) {
+            if (e->interned[i].id != 0) {
+                size_t slot = (size_t)e->interned[i].hash & (capacity - 1);
+                while (table[slot].id != 0) {
+                    slot = (slot + 1) & (capacity - 1);
+                }
+                table[slot] = e->interned[i];
+            }
+        }
+        rgsl_free(e->interned);
+        e->interned = table;
+        e->interned_capacity = capacity;
+    }
+    uint64_t hash = rgsl_hash_bytes(key, count * sizeof(uint32_t));
+    size_t mask = e->interned_capacity - 1;
+    size_t slot = (size_t)hash & mask;
+    while (e->interned[slot].id != 0) {
+        const struct rgsl_spirv_interned* entry = &e->interned[slot];
+        if (entry->hash == hash && e->keys.data[entry->key] == count && memcmp(&e->keys.data[entry->key + 1], key, count * sizeof(uint32_t)) == 0) {
+            *out_id = entry->id;
+            if (out_key != NULL) {
+                *out_key = entry->key;
+            }
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+    uint32_t offset = (uint32_t)e->keys.count;
+    rgsl_spirv_push(&e->keys, count);
+    rgsl_spirv_push_words(&e->keys, key, count);
+    e->interned[slot].hash = hash;
+    e->interned[slot].key = offset;
+    e->interned[slot].id = rgsl_spirv_new_id(e);
+    e->interned_count++;
+    *out_id = e->interned[slot].id;
+    if (out_key != NULL) {
+        *out_key = offset;
+    }
+    return false;
+}
+
+static void rgsl_spirv_decorate(struct rgsl_spirv_emitter* e, uint32_t target, uint32_t decoration, int64_t value) {
+    uint32_t operands[3] = {target, decoration, (uint32_t)value};
+    rgsl_spirv_instruction(&e->annotations, RGSL_OP_DECORATE, operands, value >= 0 ? 3 : 2);
+}
+
+static void rgsl_spirv_member_decorate(struct rgsl_spirv_emitter* e, uint32_t target, uint32_t member, uint32_t decoration, int64_t value) {
+    uint32_t operands[4] = {target, member, decoration, (uint32_t)value};
+    rgsl_spirv_instruction(&e->annotations, RGSL_OP_MEMBER_DECORATE, operands, value >= 0 ? 4 : 3);
+}
+
+static void rgsl_spirv_name(struct rgsl_spirv_emitter* e, uint32_t target, const char* name) {
+    if (name == NULL) {
+        return;
+    }
+    rgsl_spirv_push(&e->names, (uint32_t)((2 + rgsl_spirv_string_words(name)) << 16) | RGSL_OP_NAME);
+    rgsl_spirv_push(&e->names, target);
+    rgsl_spirv_push_string(&e->names, name);
+}
+
+static void rgsl_spirv_member_name(struct rgsl_spirv_emitter* e, uint32_t target, uint32_t member, const char* name) {
+    rgsl_spirv_push(&e->names, (uint32_t)((3 + rgsl_spirv_string_words(name)) << 16) | RGSL_OP_MEMBER_NAME);
+    rgsl_spirv_push(&e->names, target);
+    rgsl_spirv_push(&e->names, member);
+    rgsl_spirv_push_string(&e->names, name);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Layouts                                                                    */
+/* -------------------------------------------------------------------------- */
+
+static struct rgsl_block_layout* rgsl_spirv_struct_layout(struct rgsl_spirv_layouts* layouts, const struct rgsl_struct_decl* structure, enum rgsl_layout_packing packing);
+
+// Innermost element of an array type, and the number of elements of all its dimensions.
+static const struct rgsl_type* rgsl_spirv_array_element(const struct rgsl_type* type, uint32_t* out_count) {
+    uint32_t count = 0;
+    while (type->kind == RGSL_TYPE_ARRAY) {
+        if (type->array_size == RGSL_RUNTIME_ARRAY || count == RGSL_RUNTIME_ARRAY) {
+            count = RGSL_RUNTIME_ARRAY;
+        } else {
+            count = ((count == 0) ? 1 : count) * type->array_size;
+        }
+        type = type->element;
+    }
+    if (out_count != NULL) {
+        *out_count = count;
+    }
+    return type;
+}
+
+// Adds a member to a layout, arrays of arrays being laid out as one array of all their elements.
+static void rgsl_spirv_add_layout_member(struct rgsl_spirv_layouts* layouts, struct rgsl_block_layout* layout, const char* name, const struct rgsl_type* type, enum rgsl_layout_packing packing) {
+    uint32_t array_size;
+    const struct rgsl_type* element = rgsl_spirv_array_element(type, &array_size);
+    const struct rgsl_glsl_type* glsl_type = NULL;
+    const struct rgsl_block_layout* structure = NULL;
+    if (element->kind == RGSL_TYPE_STRUCT) {
+        structure = rgsl_spirv_struct_layout(layouts, element->structure, packing);
+    } else {
+        glsl_type = rgsl_find_glsl_type(element->name, strlen(element->name));
+    }
+    rgsl_block_add_member(layout, name, strlen(name), glsl_type, structure, NULL, array_size);
+}
+
+/**
+ * Lays out a structure with a packing, once per structure and packing, with the
+ * rules of layout.c that also give the C mirrors of blocks.
+ */
+static struct rgsl_block_layout* rgsl_spirv_struct_layout(struct rgsl_spirv_layouts* layouts, const struct rgsl_struct_decl* structure, enum rgsl_layout_packing packing) {
+    for (size_t i = 0; i < layouts->count; i++) {
+        if (layouts->entries[i].structure == structure && layouts->entries[i].packing == packing) {
+            return layouts->entries[i].layout;
+        }
+    }
+    struct rgsl_block_layout* layout = (struct rgsl_block_layout *)rgsl_calloc(1, sizeof(struct rgsl_block_layout));
+    layout->name = rgsl_strdup(structure->name);
+    layout->kind = RGSL_LAYOUT_STRUCT;
+    for (uint32_t i = 0; i < structure->field_count; i++) {
+        rgsl_spirv_add_layout_member(layouts, layout, structure->fields[i].name, structure->fields[i].type, packing);
+    }
+    rgsl_layout_block(layout, packing, false);
+    if (layouts->count == layouts->capacity) {
+        layouts->capacity = (layouts->capacity != 0) ? layouts->capacity * 2 : 8;
+        layouts->entries = (struct rgsl_spirv_layout_entry *)rgsl_realloc(layouts->entries, layouts->capacity * sizeof(struct rgsl_spirv_layout_entry));
+    }
+    struct rgsl_spirv_layout_entry* entry = &layouts->entries[layouts->count++];
+    entry->structure = structure;
+    entry->packing = packing;
+    entry->layout = layout;
+    return layout;
+}
+
+// Distance between the elements of an array, the inner arrays of arrays of arrays being elements.
+static uint32_t rgsl_spirv_array_stride(struct rgsl_spirv_layouts* layouts, const struct rgsl_type* array, enum rgsl_layout_packing packing) {
+    if (array->element->kind == RGSL_TYPE_ARRAY) {
+        return rgsl_spirv_array_stride(layouts, array->element, packing) * array->element->array_size;
+    }
+    struct rgsl_block_layout* block = (struct rgsl_block_layout *)rgsl_calloc(1, sizeof(struct rgsl_block_layout));
+    rgsl_spirv_add_layout_member(layouts, block, "element", array, packing);
+    rgsl_layout_block(block, packing, false);
+    uint32_t stride = block->members[0].stride;
+    rgsl_block_layout_free(block);
+    return stride;
+}
+
+static void rgsl_spirv_layouts_free(struct rgsl_spirv_layouts* layouts) {
+    for (size_t i = 0; i < layouts->count; i++) {
+        rgsl_block_layout_free(layouts->entries[i].layout);
+    }
+    rgsl_free(layouts->entries);
+    layouts->entries = NULL;
+    layouts->count = layouts->capacity = 0;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Types and constants                                                        */
+/* -------------------------------------------------------------------------- */
+
+// Key of structure types, which no opcode heads: the address of the structure and the layout.
+#define RGSL_SPIRV_KEY_STRUCT 0u
+
+// Interns a type whose instruction is its key, the result ID following the opcode.
+static uint32_t rgsl_spirv_intern_type(struct rgsl_spirv_emitter* e, const uint32_t* key, uint32_t count, uint32_t operand_count) {
+    uint32_t id;
+    if (!rgsl_spirv_intern(e, key, count, &id, NULL)) {
+        rgsl_spirv_push(&e->globals, (uint32_t)((operand_count + 2) << 16) | key[0]);
+        rgsl_spirv_push(&e->globals, id);
+        rgsl_spirv_push_words(&e->globals, key + 1, operand_count);
+    }
+    return id;
+}
+
+static uint32_t rgsl_spirv_void_type(struct rgsl_spirv_emitter* e) {
+    if (e->void_type == 0) {
+        e->void_type = rgsl_spirv_new_id(e);
+        rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_VOID, &e->void_type, 1);
+    }
+    return e->void_type;
+}
+
+static uint32_t rgsl_spirv_vector_type(struct rgsl_spirv_emitter* e, enum rgsl_scalar_kind scalar, uint32_t rows) {
+    uint32_t* slot = &e->vector_types[scalar][rows];
+    if (*slot != 0) {
+        return *slot;
+    }
+    if (rows > 1) {
+        uint32_t operands[3] = {0, rgsl_spirv_vector_type(e, scalar, 1), rows};
+        operands[0] = *slot = rgsl_spirv_new_id(e);
+        rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_VECTOR, operands, 3);
+        return *slot;
+    }
+    uint32_t operands[3] = {rgsl_spirv_new_id(e), 32, (scalar == RGSL_SCALAR_INT) ? 1u : 0u};
+    *slot = operands[0];
+    switch (scalar) {
+        case RGSL_SCALAR_FLOAT: rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_FLOAT, operands, 2); break;
+        case RGSL_SCALAR_BOOL: rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_BOOL, operands, 1); break;
+        default: rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_INT, operands, 3); break;
+    }
+    return *slot;
+}
+
+static uint32_t rgsl_spirv_matrix_type(struct rgsl_spirv_emitter* e, uint32_t columns, uint32_t rows) {
+    uint32_t* slot = &e->matrix_types[columns][rows];
+    if (*slot == 0) {
+        uint32_t operands[3] = {0, rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, rows), columns};
+        operands[0] = *slot = rgsl_spirv_new_id(e);
+        rgsl_spirv_instruction(&e->globals, RGSL_OP_TYPE_MATRIX, operands, 3);
+    }
+    return *slot;
+}
+
+static uint32_t rgsl_spirv_pointer_type(struct rgsl_spirv_emitter* e, uint32_t storage, uint32_t type) {
+    uint32_t key[3] = {RGSL_OP_TYPE_POINTER, storage, type};
+    return rgsl_spirv_intern_type(e, key, 3, 2);
+}
+
+static uint32_t rgsl_spirv_function_type(struct rgsl_spirv_emitter* e, uint32_t result, const uint32_t* parameters, uint32_t count) {
+    uint32_t* key = (uint32_t *)rgsl_malloc((count + 2) * sizeof(uint32_t));
+    key[0] = RGSL_OP_TYPE_FUNCTION;
+    key[1] = result;
+    memcpy(key + 2, parameters, count * sizeof(uint32_t));
+    uint32_t id = rgsl_spirv_intern_type(e, key, count + 2, count + 1);
+    rgsl_free(key);
+    return id;
+}
+
+// Image dimensions of the sampler dimensions, 2D arrays being arrayed 2D images.
+static const uint32_t IMAGE_DIMENSIONS[] = {1, 2, 3, 1};
+
+static uint32_t rgsl_spirv_image_type(struct rgsl_spirv_emitter* e, const struct rgsl_type* sampler) {
+    uint32_t key[8] = {
+        RGSL_OP_TYPE_IMAGE, rgsl_spirv_vector_type(e, sampler->scalar, 1), IMAGE_DIMENSIONS[sampler->dim],
+        sampler->shadow ? 1u : 0u, (sampler->dim == RGSL_SAMPLER_2D_ARRAY) ? 1u : 0u, 0, 1, 0
+    };
+    return rgsl_spirv_intern_type(e, key, 8, 7);
+}
+
+static uint32_t rgsl_spirv_sampler_type(struct rgsl_spirv_emitter* e, const struct rgsl_type* sampler) {
+    uint32_t key[2] = {RGSL_OP_TYPE_SAMPLED_IMAGE, rgsl_spirv_image_type(e, sampler)};
+    return rgsl_spirv_intern_type(e, key, 2, 1);
+}
+
+static uint32_t rgsl_spirv_constant(struct rgsl_spirv_emitter* e, enum rgsl_scalar_kind scalar, uint32_t bits) {
+    uint32_t key[3] = {RGSL_OP_CONSTANT, rgsl_spirv_vector_type(e, scalar, 1), bits};
+    uint32_t count = 3;
+    if (scalar == RGSL_SCALAR_BOOL) {
+        key[0] = (bits != 0) ? RGSL_OP_CONSTANT_TRUE : RGSL_OP_CONSTANT_FALSE;
+        count = 2;
+    }
+    uint32_t id;
+    uint32_t offset;
+    if (!rgsl_spirv_intern(e, key, count, &id, &offset)) {
+        uint32_t operands[3] = {key[1], id, bits};
+        rgsl_spirv_instruction(&e->globals, key[0], operands, count);
+        e->id_info[id] = RGSL_SPIRV_ID_INFO(RGSL_SPIRV_ID_CONSTANT, offset);
+    }
+    return id;
+}
+
+static uint32_t rgsl_spirv_float(struct rgsl_spirv_emitter* e, float value) {
+    union rgsl_scalar_value bits;
+    bits.u = 0;
+    bits.f = value;
+    return rgsl_spirv_constant(e, RGSL_SCALAR_FLOAT, bits.u);
+}
+
+static uint32_t rgsl_spirv_int(struct rgsl_spirv_emitter* e, int32_t value) {
+    return rgsl_spirv_constant(e, RGSL_SCALAR_INT, (uint32_t)value);
+}
+
+static uint32_t rgsl_spirv_scalar_constant(struct rgsl_spirv_emitter* e, enum rgsl_scalar_kind scalar, union rgsl_scalar_value value) {
+    return rgsl_spirv_constant(e, scalar, (scalar == RGSL_SCALAR_BOOL) ? (value.b ? 1u : 0u) : value.u);
+}
+
+// The bits of a scalar constant.
+static uint32_t rgsl_spirv_constant_bits(const struct rgsl_spirv_emitter* e, uint32_t id) {
+    const uint32_t* key = &e->keys.data[RGSL_SPIRV_ID_DATA(e->id_info[id]) + 1];
+    return (key[0] == RGSL_OP_CONSTANT) ? key[2] : (key[0] == RGSL_OP_CONSTANT_TRUE) ? 1u : 0u;
+}
+
+// The constituents of a constant composite, themselves constants.
+static uint32_t rgsl_spirv_constituent(const struct rgsl_spirv_emitter* e, uint32_t id, uint32_t index) {
+    return e->keys.data[RGSL_SPIRV_ID_DATA(e->id_info[id]) + 3 + index];
+}
+
+static uint32_t rgsl_spirv_constant_composite(struct rgsl_spirv_emitter* e, uint32_t type, const uint32_t* constituents, uint32_t count) {
+    uint32_t* key = (uint32_t *)rgsl_malloc((count + 2) * sizeof(uint32_t));
+    key[0] = RGSL_OP_CONSTANT_COMPOSITE;
+    key[1] = type;
+    memcpy(key + 2, constituents, count * sizeof(uint32_t));
+    uint32_t id;
+    uint32_t offset;
+    if (!rgsl_spirv_intern(e, key, count + 2, &id, &offset)) {
+        rgsl_spirv_push(&e->globals, (uint32_t)((count + 3) << 16) | RGSL_OP_CONSTANT_COMPOSITE);
+        rgsl_spirv_push(&e->globals, type);
+        rgsl_spirv_push(&e->globals, id);
+        rgsl_spirv_push_words(&e->globals, constituents, count);
+        e->id_info[id] = RGSL_SPIRV_ID_INFO(RGSL_SPIRV_ID_COMPOSITE, offset);
+    }
+    rgsl_free(key);
+    return id;
+}
+
+static uint32_t rgsl_spirv_undef(struct rgsl_spirv_emitter* e, uint32_t type) {
+    uint32_t key[2] = {RGSL_OP_UNDEF, type};
+    uint32_t id;
+    if (!rgsl_spirv_intern(e, key, 2, &id, NULL)) {
+        uint32_t operands[2] = {type, id};
+        rgsl_spirv_instruction(&e->globals, RGSL_OP_UNDEF, operands, 2);
+    }
+    return id;
+}
+
+static const struct rgsl_block* rgsl_spirv_find_block(const struct rgsl_spirv_emitter* e, const struct rgsl_struct_decl* structure) {
+    for (size_t i = 0; i < e->block_count; i++) {
+        if (&e->blocks_of_structs[i]->members == structure) {
+            return e->blocks_of_structs[i];
+        }
+    }
+    return NULL;
+}
+
+static uint32_t rgsl_spirv_type(struct rgsl_spirv_emitter* e, const struct rgsl_type* type, uint8_t layout);
+
+static void rgsl_spirv_decorate_memory(struct rgsl_spirv_emitter* e, uint32_t structure, uint32_t member, uint32_t memory) {
+    static const uint32_t MEMORY_DECORATIONS[][2] = {
+        {RGSL_MEMORY_READONLY, RGSL_DECORATION_NON_WRITABLE},
+        {RGSL_MEMORY_WRITEONLY, RGSL_DECORATION_NON_READABLE},
+        {RGSL_MEMORY_COHERENT, RGSL_DECORATION_COHERENT},
+        {RGSL_MEMORY_VOLATILE, RGSL_DECORATION_VOLATILE}
+    };
+    for (size_t i = 0; i < sizeof(MEMORY_DECORATIONS) / sizeof(MEMORY_DECORATIONS[0]); i++) {
+        if (memory & MEMORY_DECORATIONS[i][0]) {
+            rgsl_spirv_member_decorate(e, structure, member, MEMORY_DECORATIONS[i][1], -1);
+        }
+    }
+}
+
+/**
+ * Emits a structure type. Laid out structures get the offsets of their members,
+ * and those of blocks are decorated as blocks, with their memory qualifiers.
+ */
+static uint32_t rgsl_spirv_struct_type(struct rgsl_spirv_emitter* e, const struct rgsl_struct_decl* structure, uint8_t layout) {
+    uint64_t address = (uint64_t)(uintptr_t)structure;
+    uint32_t key[4] = {RGSL_SPIRV_KEY_STRUCT, (uint32_t)address, (uint32_t)(address >> 32), layout};
+    uint32_t id;
+    if (rgsl_spirv_intern(e, key, 4, &id, NULL)) {
+        return id;
+    }
+    uint32_t* members = (uint32_t *)rgsl_malloc((structure->field_count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < structure->field_count; i++) {
+        members[i] = rgsl_spirv_type(e, structure->fields[i].type, layout);
+    }
+    rgsl_spirv_push(&e->globals, (uint32_t)((structure->field_count + 2) << 16) | RGSL_OP_TYPE_STRUCT);
+    rgsl_spirv_push(&e->globals, id);
+    rgsl_spirv_push_words(&e->globals, members, structure->field_count);
+    rgsl_free(members);
+    rgsl_spirv_name(e, id, structure->name);
+    for (uint32_t i = 0; i < structure->field_count; i++) {
+        rgsl_spirv_member_name(e, id, i, structure->fields[i].name);
+    }
+    if (layout != 0) {
+        const struct rgsl_block_layout* block_layout = rgsl_spirv_struct_layout(&e->layouts, structure, (enum rgsl_layout_packing)(layout - 1));
+        for (uint32_t i = 0; i < structure->field_count; i++) {
+            const struct rgsl_block_member* member = &block_layout->members[i];
+            rgsl_spirv_member_decorate(e, id, i, RGSL_DECORATION_OFFSET, member->offset);
+            if (rgsl_spirv_array_element(structure->fields[i].type, NULL)->kind == RGSL_TYPE_MATRIX) {
+                rgsl_spirv_member_decorate(e, id, i, RGSL_DECORATION_COL_MAJOR, -1);
+                rgsl_spirv_member_decorate(e, id, i, RGSL_DECORATION_MATRIX_STRIDE, member->column_stride);
+            }
+        }
+    }
+    const struct rgsl_block* block = rgsl_spirv_find_block(e, structure);
+    if (block != NULL) {
+        bool buffer = block->storage == RGSL_STORAGE_BUFFER;
+        rgsl_spirv_decorate(e, id, buffer ? RGSL_DECORATION_BUFFER_BLOCK : RGSL_DECORATION_BLOCK, -1);
+        for (uint32_t i = 0; buffer && i < structure->field_count; i++) {
+            rgsl_spirv_decorate_memory(e, id, i, block->memory | structure->fields[i].memory);
+        }
+    }
+    return id;
+}
+
+static uint32_t rgsl_spirv_array_type(struct rgsl_spirv_emitter* e, const struct rgsl_type* array, uint8_t layout) {
+    uint32_t element = rgsl_spirv_type(e, array->element, layout);
+    uint32_t key[4] = {RGSL_OP_TYPE_RUNTIME_ARRAY, element, layout, 0};
+    uint32_t count = 3;
+    uint32_t operand_count = 1;
+    if (array->array_size != RGSL_RUNTIME_ARRAY) {
+        key[0] = RGSL_OP_TYPE_ARRAY;
+        key[2] = rgsl_spirv_constant(e, RGSL_SCALAR_UINT, array->array_size);
+        key[3] = layout;
+        count = 4;
+        operand_count = 2;
+    }
+    uint32_t id;
+    if (rgsl_spirv_intern(e, key, count, &id, NULL)) {
+        return id;
+    }
+    rgsl_spirv_push(&e->globals, (uint32_t)((operand_count + 2) << 16) | key[0]);
+    rgsl_spirv_push(&e->globals, id);
+    rgsl_spirv_push_words(&e->globals, key + 1, operand_count);
+    // Arrays of blocks are arrays of interfaces, not laid out in memory.
+    bool blocks = array->element->kind == RGSL_TYPE_STRUCT && rgsl_spirv_find_block(e, array->element->structure) != NULL;
+    if (layout != 0 && !blocks) {
+        rgsl_spirv_decorate(e, id, RGSL_DECORATION_ARRAY_STRIDE, rgsl_spirv_array_stride(&e->layouts, array, (enum rgsl_layout_packing)(layout - 1)));
+    }
+    return id;
+}
+
+/**
+ * Emits a type. Laid out types are distinct from the others, since their
+ * arrays and structures are decorated with offsets and strides, and their
+ * booleans are uints.
+ */
+static uint32_t rgsl_spirv_type(struct rgsl_spirv_emitter* e, const struct rgsl_type* type, uint8_t layout) {
+    switch (type->kind) {
+        case RGSL_TYPE_VOID:
+            return rgsl_spirv_void_type(e);
+        case RGSL_TYPE_SCALAR:
+        case RGSL_TYPE_VECTOR:
+            return rgsl_spirv_vector_type(e, (type->scalar == RGSL_SCALAR_BOOL && layout != 0) ? RGSL_SCALAR_UINT : type->scalar, type->rows);
+        case RGSL_TYPE_MATRIX:
+            return rgsl_spirv_matrix_type(e, type->columns, type->rows);
+        case RGSL_TYPE_SAMPLER:
+            return rgsl_spirv_sampler_type(e, type);
+        case RGSL_TYPE_ARRAY:
+            return rgsl_spirv_array_type(e, type, layout);
+        case RGSL_TYPE_STRUCT:
+            return rgsl_spirv_struct_type(e, type->structure, layout);
+        default:
+            return rgsl_spirv_void_type(e);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Blocks and code                                                            */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t rgsl_spirv_new_block(struct rgsl_spirv_emitter* e) {
+    if (e->function_block_count == e->function_block_capacity) {
+        e->function_block_capacity = (e->function_block_capacity != 0) ? e->function_block_capacity * 2 : 16;
+        e->blocks = (struct rgsl_spirv_block *)rgsl_realloc(e->blocks, e->function_block_capacity * sizeof(struct rgsl_spirv_block));
+    }
+    struct rgsl_spirv_block* block = &e->blocks[e->function_block_count];
+    memset(block, 0, sizeof(struct rgsl_spirv_block));
+    block->label = rgsl_spirv_new_id(e);
+    block->first_phi = UINT32_MAX;
+    return (uint32_t)e->function_block_count++;
+}
+
+static void rgsl_spirv_start_block(struct rgsl_spirv_emitter* e, uint32_t block) {
+    e->current = block;
+    rgsl_spirv_push(&e->order, block);
+}
+
+static void rgsl_spirv_add_predecessor(struct rgsl_spirv_emitter* e, uint32_t block, uint32_t predecessor) {
+    struct rgsl_spirv_words* predecessors = &e->blocks[block].predecessors;
+    for (size_t i = 0; i < predecessors->count; i++) {
+        if (predecessors->data[i] == predecessor) {
+            return;
+        }
+    }
+    rgsl_spirv_push(predecessors, predecessor);
+}
+
+// Starts an instruction of the current block, with its operand count.
+static void rgsl_spirv_begin(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t operand_count) {
+    rgsl_spirv_push(&e->blocks[e->current].code, ((operand_count + 1) << 16) | op);
+}
+
+static void rgsl_spirv_code_literal(struct rgsl_spirv_emitter* e, uint32_t word) {
+    rgsl_spirv_push(&e->blocks[e->current].code, word);
+}
+
+// Appends an ID operand, remembering where phis are used as they may turn out trivial.
+static void rgsl_spirv_code_id(struct rgsl_spirv_emitter* e, uint32_t id) {
+    struct rgsl_spirv_block* block = &e->blocks[e->current];
+    if (rgsl_spirv_id_kind(e, id) == RGSL_SPIRV_ID_PHI) {
+        rgsl_spirv_push(&block->fixups, (uint32_t)block->code.count);
+    }
+    rgsl_spirv_push(&block->code, id);
+}
+
+static uint32_t rgsl_spirv_op(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t type, const uint32_t* operands, uint32_t count) {
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, op, count + 2);
+    rgsl_spirv_code_literal(e, type);
+    rgsl_spirv_code_literal(e, result);
+    for (uint32_t i = 0; i < count; i++) {
+        rgsl_spirv_code_id(e, operands[i]);
+    }
+    return result;
+}
+
+static uint32_t rgsl_spirv_op1(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t type, uint32_t a) {
+    return rgsl_spirv_op(e, op, type, &a, 1);
+}
+
+static uint32_t rgsl_spirv_op2(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t type, uint32_t a, uint32_t b) {
+    uint32_t operands[2] = {a, b};
+    return rgsl_spirv_op(e, op, type, operands, 2);
+}
+
+static uint32_t rgsl_spirv_op3(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t type, uint32_t a, uint32_t b, uint32_t c) {
+    uint32_t operands[3] = {a, b, c};
+    return rgsl_spirv_op(e, op, type, operands, 3);
+}
+
+// Emits an instruction of GLSL.std.450.
+static uint32_t rgsl_spirv_ext(struct rgsl_spirv_emitter* e, uint32_t instruction, uint32_t type, const uint32_t* operands, uint32_t count) {
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_EXT_INST, count + 4);
+    rgsl_spirv_code_literal(e, type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_literal(e, e->glsl450);
+    rgsl_spirv_code_literal(e, instruction);
+    for (uint32_t i = 0; i < count; i++) {
+        rgsl_spirv_code_id(e, operands[i]);
+    }
+    return result;
+}
+
+// Extracts a member, component or column, reading constant composites directly.
+static uint32_t rgsl_spirv_extract(struct rgsl_spirv_emitter* e, uint32_t type, uint32_t composite, uint32_t index) {
+    if (rgsl_spirv_id_kind(e, composite) == RGSL_SPIRV_ID_COMPOSITE) {
+        return rgsl_spirv_constituent(e, composite, index);
+    }
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_COMPOSITE_EXTRACT, 4);
+    rgsl_spirv_code_literal(e, type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_id(e, composite);
+    rgsl_spirv_code_literal(e, index);
+    return result;
+}
+
+static uint32_t rgsl_spirv_insert(struct rgsl_spirv_emitter* e, uint32_t type, uint32_t object, uint32_t composite, uint32_t index) {
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_COMPOSITE_INSERT, 5);
+    rgsl_spirv_code_literal(e, type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_id(e, object);
+    rgsl_spirv_code_id(e, composite);
+    rgsl_spirv_code_literal(e, index);
+    return result;
+}
+
+static uint32_t rgsl_spirv_shuffle(struct rgsl_spirv_emitter* e, uint32_t type, uint32_t a, uint32_t b, const uint32_t* components, uint32_t count) {
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_VECTOR_SHUFFLE, count + 4);
+    rgsl_spirv_code_literal(e, type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_id(e, a);
+    rgsl_spirv_code_id(e, b);
+    for (uint32_t i = 0; i < count; i++) {
+        rgsl_spirv_code_literal(e, components[i]);
+    }
+    return result;
+}
+
+// Builds a composite, as a constant if its constituents are scalar constants.
+static uint32_t rgsl_spirv_construct(struct rgsl_spirv_emitter* e, uint32_t type, const uint32_t* constituents, uint32_t count) {
+    bool constant = true;
+    for (uint32_t i = 0; i < count && constant; i++) {
+        constant = rgsl_spirv_is_constant(e, constituents[i]);
+    }
+    if (constant) {
+        return rgsl_spirv_constant_composite(e, type, constituents, count);
+    }
+    return rgsl_spirv_op(e, RGSL_OP_COMPOSITE_CONSTRUCT, type, constituents, count);
+}
+
+// Repeats a scalar in a vector of a size, returning it unchanged for a size of 1.
+static uint32_t rgsl_spirv_splat(struct rgsl_spirv_emitter* e, uint32_t scalar, enum rgsl_scalar_kind kind, uint32_t size) {
+    if (size <= 1) {
+        return scalar;
+    }
+    uint32_t constituents[4] = {scalar, scalar, scalar, scalar};
+    return rgsl_spirv_construct(e, rgsl_spirv_vector_type(e, kind, size), constituents, size);
+}
+
+// Ends the current block with a branch, the target gaining it as predecessor.
+static void rgsl_spirv_branch(struct rgsl_spirv_emitter* e, uint32_t target) {
+    if (e->current == RGSL_SPIRV_NO_BLOCK) {
+        return;
+    }
+    rgsl_spirv_begin(e, RGSL_OP_BRANCH, 1);
+    rgsl_spirv_code_literal(e, e->blocks[target].label);
+    rgsl_spirv_add_predecessor(e, target, e->current);
+    e->current = RGSL_SPIRV_NO_BLOCK;
+}
+
+static void rgsl_spirv_branch_conditional(struct rgsl_spirv_emitter* e, uint32_t condition, uint32_t when_true, uint32_t when_false) {
+    rgsl_spirv_begin(e, RGSL_OP_BRANCH_CONDITIONAL, 3);
+    rgsl_spirv_code_id(e, condition);
+    rgsl_spirv_code_literal(e, e->blocks[when_true].label);
+    rgsl_spirv_code_literal(e, e->blocks[when_false].label);
+    rgsl_spirv_add_predecessor(e, when_true, e->current);
+    rgsl_spirv_add_predecessor(e, when_false, e->current);
+    e->current = RGSL_SPIRV_NO_BLOCK;
+}
+
+static void rgsl_spirv_selection_merge(struct rgsl_spirv_emitter* e, uint32_t merge) {
+    rgsl_spirv_begin(e, RGSL_OP_SELECTION_MERGE, 2);
+    rgsl_spirv_code_literal(e, e->blocks[merge].label);
+    rgsl_spirv_code_literal(e, 0);
+}
+
+// Ends the current block with an instruction leaving it without successor.
+static void rgsl_spirv_terminate(struct rgsl_spirv_emitter* e, uint32_t op, uint32_t value) {
+    rgsl_spirv_begin(e, op, value != 0 ? 1 : 0);
+    if (value != 0) {
+        rgsl_spirv_code_id(e, value);
+    }
+    e->current = RGSL_SPIRV_NO_BLOCK;
+}
+
+/* -------------------------------------------------------------------------- */
+/* SSA                                                                        */
+/* -------------------------------------------------------------------------- */
+
+/*
+ * Local scalars and vectors are never stored: their values are tracked per
+ * block while the code is emitted, and joined by phis where blocks meet, as in
+ * "Simple and Efficient Construction of Static Single Assignment Form" (Braun et
+ * al.). Blocks are sealed once their predecessors are known, which for loop
+ * headers is after the back edge; the phis read before are completed then.
+ */
+
+static uint32_t rgsl_spirv_resolve(const struct rgsl_spirv_emitter* e, uint32_t id) {
+    while (rgsl_spirv_id_kind(e, id) == RGSL_SPIRV_ID_PHI) {
+        uint32_t replacement = e->phis[RGSL_SPIRV_ID_DATA(e->id_info[id])].replacement;
+        if (replacement == 0) {
+            break;
+        }
+        id = replacement;
+    }
+    return id;
+}
+
+static uint64_t rgsl_spirv_definition_key(uint32_t block, const struct rgsl_variable* variable) {
+    return (((uint64_t)block << 32) | variable->id) + 1;
+}
+
+static struct rgsl_spirv_definition* rgsl_spirv_find_definition(struct rgsl_spirv_emitter* e, uint64_t key) {
+    size_t mask = e->definition_capacity - 1;
+    size_t slot = (size_t)(key * 0x9E3779B97F4A7C15ull >> 32) & mask;
+    while (e->definitions[slot].key != 0 && e->definitions[slot].key != key) {
+        slot = (slot + 1) & mask;
+    }
+    return &e->definitions[slot];
+}
+
+static void rgsl_spirv_write_variable(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable, uint32_t block, uint32_t value) {
+    if ((e->definition_count + 1) * 4 > e->definition_capacity * 3) {
+        struct rgsl_spirv_definition* old = e->definitions;
+        size_t old_capacity = e->definition_capacity;
+        e->definition_capacity = (old_capacity != 0) ? old_capacity * 2 : 256;
+        e->definitions = (struct rgsl_spirv_definition *)rgsl_calloc(e->definition_capacity, sizeof(struct rgsl_spirv_definition));
+        for (size_t i = 0; i < old_capacity; i++) {
+            if (old[i].key != 0) {
+                *rgsl_spirv_find_definition(e, old[i].key) = old[i];
+            }
+        }
+        rgsl_free(old);
+    }
+    uint64_t key = rgsl_spirv_definition_key(block, variable);
+    struct rgsl_spirv_definition* definition = rgsl_spirv_find_definition(e, key);
+    if (definition->key == 0) {
+        definition->key = key;
+        e->definition_count++;
+    }
+    definition->value = value;
+}
+
+static uint32_t rgsl_spirv_new_phi(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable, uint32_t block) {
+    uint32_t type = (variable != NULL) ? rgsl_spirv_type(e, variable->type, 0) : 0;
+    if (e->phi_count == e->phi_capacity) {
+        e->phi_capacity = (e->phi_capacity != 0) ? e->phi_capacity * 2 : 32;
+        e->phis = (struct rgsl_spirv_phi *)rgsl_realloc(e->phis, e->phi_capacity * sizeof(struct rgsl_spirv_phi));
+    }
+    uint32_t index = (uint32_t)e->phi_count++;
+    struct rgsl_spirv_phi* phi = &e->phis[index];
+    memset(phi, 0, sizeof(struct rgsl_spirv_phi));
+    phi->id = rgsl_spirv_new_id(e);
+    phi->type = type;
+    phi->block = block;
+    phi->variable = variable;
+    phi->next = e->blocks[block].first_phi;
+    e->blocks[block].first_phi = index;
+    e->id_info[phi->id] = RGSL_SPIRV_ID_INFO(RGSL_SPIRV_ID_PHI, index);
+    return index;
+}
+
+// Replaces a phi whose operands are itself and a single value by that value.
+static uint32_t rgsl_spirv_try_remove_trivial_phi(struct rgsl_spirv_emitter* e, uint32_t index) {
+    struct rgsl_spirv_phi* phi = &e->phis[index];
+    uint32_t same = 0;
+    for (size_t i = 0; i < phi->operands.count; i++) {
+        uint32_t operand = rgsl_spirv_resolve(e, phi->operands.data[i]);
+        if (operand == same || operand == phi->id) {
+            continue;
+        }
+        if (same != 0) {
+            return phi->id;
+        }
+        same = operand;
+    }
+    if (same == 0) {
+        same = rgsl_spirv_undef(e, phi->type);
+        phi = &e->phis[index];
+    }
+    phi->replacement = same;
+    return same;
+}
+
+static uint32_t rgsl_spirv_read_variable(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable, uint32_t block);
+
+static uint32_t rgsl_spirv_add_phi_operands(struct rgsl_spirv_emitter* e, uint32_t index) {
+    uint32_t block = e->phis[index].block;
+    const struct rgsl_variable* variable = e->phis[index].variable;
+    for (size_t i = 0; i < e->blocks[block].predecessors.count; i++) {
+        uint32_t value = rgsl_spirv_read_variable(e, variable, e->blocks[block].predecessors.data[i]);
+        rgsl_spirv_push(&e->phis[index].operands, value);
+    }
+    return rgsl_spirv_try_remove_trivial_phi(e, index);
+}
+
+static uint32_t rgsl_spirv_read_variable(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable, uint32_t block) {
+    if (e->definition_capacity != 0) {
+        const struct rgsl_spirv_definition* definition = rgsl_spirv_find_definition(e, rgsl_spirv_definition_key(block, variable));
+        if (definition->key != 0) {
+            return rgsl_spirv_resolve(e, definition->value);
+        }
+    }
+    const struct rgsl_spirv_block* info = &e->blocks[block];
+    uint32_t value;
+    if (!info->sealed) {
+        uint32_t index = rgsl_spirv_new_phi(e, variable, block);
+        rgsl_spirv_push(&e->blocks[block].incomplete, index);
+        value = e->phis[index].id;
+    } else if (info->predecessors.count == 0) {
+        value = rgsl_spirv_undef(e, rgsl_spirv_type(e, variable->type, 0));
+    } else if (info->predecessors.count == 1) {
+        value = rgsl_spirv_read_variable(e, variable, info->predecessors.data[0]);
+    } else {
+        uint32_t index = rgsl_spirv_new_phi(e, variable, block);
+        // The phi is the value while its operands are read, breaking cycles through loops.
+        rgsl_spirv_write_variable(e, variable, block, e->phis[index].id);
+        value = rgsl_spirv_add_phi_operands(e, index);
+    }
+    rgsl_spirv_write_variable(e, variable, block, value);
+    return value;
+}
+
+static void rgsl_spirv_seal_block(struct rgsl_spirv_emitter* e, uint32_t block) {
+    e->blocks[block].sealed = true;
+    for (size_t i = 0; i < e->blocks[block].incomplete.count; i++) {
+        rgsl_spirv_add_phi_operands(e, e->blocks[block].incomplete.data[i]);
+    }
+    e->blocks[block].incomplete.count = 0;
+}
+
+// Seals and starts a block, marked unreachable when no branch reaches it.
+static void rgsl_spirv_start_merge(struct rgsl_spirv_emitter* e, uint32_t block) {
+    rgsl_spirv_seal_block(e, block);
+    rgsl_spirv_start_block(e, block);
+    if (e->blocks[block].predecessors.count == 0) {
+        rgsl_spirv_terminate(e, RGSL_OP_UNREACHABLE, 0);
+    }
+}
+
+// Replaces the phis left trivial once the phis they were waiting for were resolved.
+static void rgsl_spirv_remove_trivial_phis(struct rgsl_spirv_emitter* e) {
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t i = 0; i < e->phi_count; i++) {
+            if (e->phis[i].replacement == 0 && rgsl_spirv_try_remove_trivial_phi(e, (uint32_t)i) != e->phis[i].id) {
+                changed = true;
+            }
+        }
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Variables and references                                                   */
+/* -------------------------------------------------------------------------- */
+
+static bool rgsl_spirv_folded(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr);
+
+// Tells whether a constant scalar variable is folded into its uses, unless it is specialized.
+static bool rgsl_spirv_variable_folded(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    if (!variable->constant || variable->type->kind != RGSL_TYPE_SCALAR || variable->initializer == NULL ||
+        (e->spec_constants && variable->layout.constant_id >= 0)) {
+        return false;
+    }
+    struct rgsl_spirv_variable* info = &e->variables[variable->id];
+    if (info->folded == 0) {
+        info->folded = rgsl_spirv_folded(e, variable->initializer) ? 1 : -1;
+    }
+    return info->folded > 0;
+}
+
+/**
+ * Tells whether an expression is a scalar constant whose value the checker
+ * computed. Constant expressions calling built-in functions are constant in
+ * GLSL, but have no value and are emitted as instructions.
+ */
+static bool rgsl_spirv_folded(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    if (!expr->constant || expr->type->kind != RGSL_TYPE_SCALAR) {
+        return false;
+    }
+    switch (expr->kind) {
+        case RGSL_EXPR_LITERAL:
+        case RGSL_EXPR_LENGTH:
+            return true;
+        case RGSL_EXPR_VARIABLE:
+            return rgsl_spirv_variable_folded(e, expr->variable);
+        case RGSL_EXPR_UNARY:
+            return expr->op != RGSL_TOKEN_PLUS_PLUS && expr->op != RGSL_TOKEN_MINUS_MINUS && rgsl_spirv_folded(e, expr->operands[0]);
+        case RGSL_EXPR_BINARY:
+            return rgsl_spirv_folded(e, expr->operands[0]) && rgsl_spirv_folded(e, expr->operands[1]);
+        case RGSL_EXPR_CONDITIONAL:
+            return rgsl_spirv_folded(e, expr->operands[0]) && rgsl_spirv_folded(e, expr->operands[1]) && rgsl_spirv_folded(e, expr->operands[2]);
+        case RGSL_EXPR_CONVERT:
+            return rgsl_spirv_folded(e, expr->operands[0]);
+        case RGSL_EXPR_CONSTRUCT:
+            return expr->argument_count == 1 && rgsl_spirv_folded(e, expr->arguments[0]);
+        default:
+            return false;
+    }
+}
+
+static int rgsl_spirv_compare_builtin(const void* key, const void* element) {
+    return strcmp((const char *)key, ((const struct rgsl_spirv_builtin_variable *)element)->name);
+}
+
+// Declares a built-in variable on its first use.
+static void rgsl_spirv_declare_builtin(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    const struct rgsl_spirv_builtin_variable* builtin = (const struct rgsl_spirv_builtin_variable *)bsearch(variable->name, BUILTIN_VARIABLES,
+        sizeof(BUILTIN_VARIABLES) / sizeof(BUILTIN_VARIABLES[0]), sizeof(BUILTIN_VARIABLES[0]), rgsl_spirv_compare_builtin);
+    if (builtin == NULL) {
+        rgsl_spirv_error(e, variable->line, "%s has no SPIR-V built-in", variable->name);
+        return;
+    }
+    struct rgsl_spirv_variable* info = &e->variables[variable->id];
+    info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+    info->storage = (variable->direction == RGSL_DIRECTION_OUT) ? RGSL_SPIRV_STORAGE_OUTPUT : RGSL_SPIRV_STORAGE_INPUT;
+    info->id = rgsl_spirv_new_id(e);
+    uint32_t operands[3] = {rgsl_spirv_pointer_type(e, info->storage, rgsl_spirv_type(e, variable->type, 0)), info->id, info->storage};
+    rgsl_spirv_instruction(&e->globals, RGSL_OP_VARIABLE, operands, 3);
+    rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_BUILT_IN, builtin->builtin);
+    rgsl_spirv_name(e, info->id, variable->name);
+    rgsl_spirv_push(&e->interface_ids, info->id);
+    e->needs |= builtin->needs;
+    e->depth_replacing |= builtin->builtin == RGSL_SPIRV_BUILTIN_FRAG_DEPTH;
+}
+
+static const struct rgsl_spirv_variable* rgsl_spirv_variable(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    if (variable->storage == RGSL_STORAGE_BUILTIN && e->variables[variable->id].kind == RGSL_SPIRV_VARIABLE_NONE) {
+        rgsl_spirv_declare_builtin(e, variable);
+    }
+    return &e->variables[variable->id];
+}
+
+// Declares a variable of the function being emitted, in its first block.
+static uint32_t rgsl_spirv_local(struct rgsl_spirv_emitter* e, const struct rgsl_type* type) {
+    uint32_t operands[3] = {rgsl_spirv_pointer_type(e, RGSL_SPIRV_STORAGE_FUNCTION, rgsl_spirv_type(e, type, 0)), rgsl_spirv_new_id(e), RGSL_SPIRV_STORAGE_FUNCTION};
+    rgsl_spirv_instruction(&e->local_variables, RGSL_OP_VARIABLE, operands, 3);
+    return operands[1];
+}
+
+static uint32_t rgsl_spirv_expr(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr);
+
+static bool rgsl_spirv_is_ref(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    while (expr->kind == RGSL_EXPR_INDEX || expr->kind == RGSL_EXPR_FIELD || expr->kind == RGSL_EXPR_SWIZZLE) {
+        // Swizzles repeating a scalar make a vector, which is no place in memory.
+        if (expr->kind == RGSL_EXPR_SWIZZLE && expr->operands[0]->type->kind == RGSL_TYPE_SCALAR && expr->swizzle_count > 1) {
+            return false;
+        }
+        expr = expr->operands[0];
+    }
+    if (expr->kind != RGSL_EXPR_VARIABLE || expr->variable == NULL || rgsl_spirv_variable_folded(e, expr->variable)) {
+        return false;
+    }
+    uint8_t kind = rgsl_spirv_variable(e, expr->variable)->kind;
+    return kind == RGSL_SPIRV_VARIABLE_MEMORY || kind == RGSL_SPIRV_VARIABLE_MEMBER || kind == RGSL_SPIRV_VARIABLE_SSA;
+}
+
+static void rgsl_spirv_ref_index(struct rgsl_spirv_emitter* e, struct rgsl_spirv_ref* ref, uint32_t index, uint32_t line) {
+    if (ref->index_count == RGSL_SPIRV_MAX_INDICES) {
+        rgsl_spirv_error(e, line, "%s", "the access is too deep for the SPIR-V backend");
+        return;
+    }
+    ref->indices[ref->index_count++] = index;
+}
+
+// Type of the value of a reference, once its components are selected.
+static const struct rgsl_type* rgsl_spirv_ref_type(const struct rgsl_spirv_ref* ref) {
+    if (ref->dynamic_component != 0) {
+        return rgsl_vector_type(ref->type->scalar, 1);
+    }
+    return (ref->component_count != 0) ? rgsl_vector_type(ref->type->scalar, ref->component_count) : ref->type;
+}
+
+// Builds the reference an lvalue, or a variable read through indices and members, designates.
+static void rgsl_spirv_ref(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr, struct rgsl_spirv_ref* ref) {
+    switch (expr->kind) {
+        case RGSL_EXPR_VARIABLE: {
+            const struct rgsl_spirv_variable* info = rgsl_spirv_variable(e, expr->variable);
+            memset(ref, 0, sizeof(struct rgsl_spirv_ref));
+            ref->type = expr->variable->type;
+            if (info->kind == RGSL_SPIRV_VARIABLE_SSA) {
+                ref->variable = expr->variable;
+                return;
+            }
+            ref->base = info->id;
+            ref->storage = info->storage;
+            ref->layout = info->layout;
+            if (info->kind == RGSL_SPIRV_VARIABLE_MEMBER) {
+                rgsl_spirv_ref_index(e, ref, rgsl_spirv_int(e, (int32_t)expr->variable->member), expr->line);
+            }
+            return;
+        }
+        case RGSL_EXPR_INDEX: {
+            rgsl_spirv_ref(e, expr->operands[0], ref);
+            const struct rgsl_expr* index = expr->operands[1];
+            bool folded = rgsl_spirv_folded(e, index);
+            if (ref->type->kind != RGSL_TYPE_VECTOR) {
+                rgsl_spirv_ref_index(e, ref, folded ? rgsl_spirv_int(e, index->value.i) : rgsl_spirv_expr(e, index), expr->line);
+                ref->type = expr->type;
+                return;
+            }
+            if (folded && ref->component_count != 0) {
+                ref->components[0] = ref->components[index->value.u];
+                ref->component_count = 1;
+            } else if (folded) {
+                ref->components[0] = (uint8_t)index->value.u;
+                ref->component_count = 1;
+            } else if (ref->component_count != 0) {
+                // A variable index into a swizzle picks the component through the swizzle.
+                uint32_t components[4];
+                for (uint32_t i = 0; i < ref->component_count; i++) {
+                    components[i] = rgsl_spirv_constant(e, RGSL_SCALAR_UINT, ref->components[i]);
+                }
+                uint32_t selection = rgsl_spirv_constant_composite(e, rgsl_spirv_vector_type(e, RGSL_SCALAR_UINT, ref->component_count), components, ref->component_count);
+                uint32_t value = rgsl_spirv_expr(e, index);
+                ref->dynamic_component = rgsl_spirv_op2(e, RGSL_OP_VECTOR_EXTRACT_DYNAMIC, rgsl_spirv_vector_type(e, RGSL_SCALAR_UINT, 1), selection, value);
+                ref->component_count = 0;
+            } else {
+                ref->dynamic_component = rgsl_spirv_expr(e, index);
+            }
+            return;
+        }
+        case RGSL_EXPR_FIELD:
+            rgsl_spirv_ref(e, expr->operands[0], ref);
+            rgsl_spirv_ref_index(e, ref, rgsl_spirv_int(e, (int32_t)expr->field), expr->line);
+            ref->type = expr->type;
+            return;
+        case RGSL_EXPR_SWIZZLE: {
+            rgsl_spirv_ref(e, expr->operands[0], ref);
+            if (expr->operands[0]->type->kind == RGSL_TYPE_SCALAR) {
+                return;
+            }
+            uint8_t components[4];
+            for (uint32_t i = 0; i < expr->swizzle_count; i++) {
+                components[i] = (ref->component_count != 0) ? ref->components[expr->swizzle[i]] : expr->swizzle[i];
+            }
+            memcpy(ref->components, components, sizeof(components));
+            ref->component_count = expr->swizzle_count;
+            return;
+        }
+        default:
+            memset(ref, 0, sizeof(struct rgsl_spirv_ref));
+            ref->type = expr->type;
+            return;
+    }
+}
+
+// Pointer to the memory of a reference, through its indices and maybe a component.
+static uint32_t rgsl_spirv_ref_pointer(struct rgsl_spirv_emitter* e, const struct rgsl_spirv_ref* ref, const struct rgsl_type* type, uint32_t component) {
+    if (ref->index_count == 0 && component == 0) {
+        return ref->base;
+    }
+    uint32_t pointer = rgsl_spirv_pointer_type(e, ref->storage, rgsl_spirv_type(e, type, ref->layout));
+    uint32_t result = rgsl_spirv_new_id(e);
+    uint32_t count = ref->index_count + (component != 0 ? 1 : 0);
+    rgsl_spirv_begin(e, RGSL_OP_ACCESS_CHAIN, count + 3);
+    rgsl_spirv_code_literal(e, pointer);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_id(e, ref->base);
+    for (uint32_t i = 0; i < ref->index_count; i++) {
+        rgsl_spirv_code_id(e, ref->indices[i]);
+    }
+    if (component != 0) {
+        rgsl_spirv_code_id(e, component);
+    }
+    return result;
+}
+
+/**
+ * Converts a value between the types of two layouts: laid out arrays and
+ * structures are other types, rebuilt member by member, and laid out booleans
+ * are uints.
+ */
+static uint32_t rgsl_spirv_relayout(struct rgsl_spirv_emitter* e, uint32_t value, const struct rgsl_type* type, uint8_t from, uint8_t to) {
+    if (from == to) {
+        return value;
+    }
+    switch (type->kind) {
+        case RGSL_TYPE_SCALAR:
+        case RGSL_TYPE_VECTOR: {
+            if (type->scalar != RGSL_SCALAR_BOOL || (from == 0) == (to == 0)) {
+                return value;
+            }
+            uint32_t zero = rgsl_spirv_splat(e, rgsl_spirv_constant(e, RGSL_SCALAR_UINT, 0), RGSL_SCALAR_UINT, type->rows);
+            if (to == 0) {
+                return rgsl_spirv_op2(e, RGSL_OP_I_NOT_EQUAL, rgsl_spirv_type(e, type, 0), value, zero);
+            }
+            uint32_t one = rgsl_spirv_splat(e, rgsl_spirv_constant(e, RGSL_SCALAR_UINT, 1), RGSL_SCALAR_UINT, type->rows);
+            return rgsl_spirv_op3(e, RGSL_OP_SELECT, rgsl_spirv_type(e, type, to), value, one, zero);
+        }
+        case RGSL_TYPE_ARRAY:
+        case RGSL_TYPE_STRUCT: {
+            bool array = type->kind == RGSL_TYPE_ARRAY;
+            uint32_t count = array ? type->array_size : type->structure->field_count;
+            uint32_t* members = (uint32_t *)rgsl_malloc((count + 1) * sizeof(uint32_t));
+            for (uint32_t i = 0; i < count; i++) {
+                const struct rgsl_type* member = array ? type->element : type->structure->fields[i].type;
+                uint32_t element = rgsl_spirv_extract(e, rgsl_spirv_type(e, member, from), value, i);
+                members[i] = rgsl_spirv_relayout(e, element, member, from, to);
+            }
+            uint32_t result = rgsl_spirv_op(e, RGSL_OP_COMPOSITE_CONSTRUCT, rgsl_spirv_type(e, type, to), members, count);
+            rgsl_free(members);
+            return result;
+        }
+        default:
+            return value;
+    }
+}
+
+static uint32_t rgsl_spirv_load(struct rgsl_spirv_emitter* e, const struct rgsl_spirv_ref* ref) {
+    const struct rgsl_type* scalar = rgsl_vector_type(ref->type->scalar, 1);
+    uint32_t value;
+    if (ref->variable == NULL) {
+        if (ref->dynamic_component != 0 || ref->component_count == 1) {
+            // Single components are loaded alone, without the rest of their vector.
+            uint32_t component = (ref->dynamic_component != 0) ? ref->dynamic_component : rgsl_spirv_int(e, ref->components[0]);
+            uint32_t pointer = rgsl_spirv_ref_pointer(e, ref, scalar, component);
+            value = rgsl_spirv_op1(e, RGSL_OP_LOAD, rgsl_spirv_type(e, scalar, ref->layout), pointer);
+            return rgsl_spirv_relayout(e, value, scalar, ref->layout, 0);
+        }
+        uint32_t pointer = rgsl_spirv_ref_pointer(e, ref, ref->type, 0);
+        value = rgsl_spirv_op1(e, RGSL_OP_LOAD, rgsl_spirv_type(e, ref->type, ref->layout), pointer);
+        value = rgsl_spirv_relayout(e, value, ref->type, ref->layout, 0);
+    } else {
+        value = rgsl_spirv_read_variable(e, ref->variable, e->current);
+    }
+    if (ref->dynamic_component != 0) {
+        return rgsl_spirv_op2(e, RGSL_OP_VECTOR_EXTRACT_DYNAMIC, rgsl_spirv_type(e, scalar, 0), value, ref->dynamic_component);
+    }
+    if (ref->component_count == 1) {
+        return rgsl_spirv_extract(e, rgsl_spirv_type(e, scalar, 0), value, ref->components[0]);
+    }
+    if (ref->component_count > 1) {
+        uint32_t components[4];
+        for (uint32_t i = 0; i < ref->component_count; i++) {
+            components[i] = ref->components[i];
+        }
+        return rgsl_spirv_shuffle(e, rgsl_spirv_type(e, rgsl_spirv_ref_type(ref), 0), value, value, components, ref->component_count);
+    }
+    return value;
+}
+
+static void rgsl_spirv_store_pointer(struct rgsl_spirv_emitter* e, uint32_t pointer, uint32_t value) {
+    rgsl_spirv_begin(e, RGSL_OP_STORE, 2);
+    rgsl_spirv_code_id(e, pointer);
+    rgsl_spirv_code_id(e, value);
+}
+
+static void rgsl_spirv_store(struct rgsl_spirv_emitter* e, const struct rgsl_spirv_ref* ref, uint32_t value) {
+    const struct rgsl_type* scalar = rgsl_vector_type(ref->type->scalar, 1);
+    if (ref->variable != NULL) {
+        uint32_t type = rgsl_spirv_type(e, ref->type, 0);
+        if (ref->dynamic_component != 0 || ref->component_count != 0) {
+            uint32_t old = rgsl_spirv_read_variable(e, ref->variable, e->current);
+            if (ref->dynamic_component != 0) {
+                value = rgsl_spirv_op3(e, RGSL_OP_VECTOR_INSERT_DYNAMIC, type, old, value, ref->dynamic_component);
+            } else if (ref->component_count == 1) {
+                value = rgsl_spirv_insert(e, type, value, old, ref->components[0]);
+            } else {
+                uint32_t components[4];
+                for (uint32_t i = 0; i < ref->type->rows; i++) {
+                    components[i] = i;
+                }
+                for (uint32_t i = 0; i < ref->component_count; i++) {
+                    components[ref->components[i]] = ref->type->rows + i;
+                }
+                value = rgsl_spirv_shuffle(e, type, old, value, components, ref->type->rows);
+            }
+        }
+        rgsl_spirv_write_variable(e, ref->variable, e->current, value);
+        return;
+    }
+    if (ref->dynamic_component != 0) {
+        uint32_t pointer = rgsl_spirv_ref_pointer(e, ref, scalar, ref->dynamic_component);
+        rgsl_spirv_store_pointer(e, pointer, rgsl_spirv_relayout(e, value, scalar, 0, ref->layout));
+        return;
+    }
+    if (ref->component_count == 0) {
+        uint32_t pointer = rgsl_spirv_ref_pointer(e, ref, ref->type, 0);
+        rgsl_spirv_store_pointer(e, pointer, rgsl_spirv_relayout(e, value, ref->type, 0, ref->layout));
+        return;
+    }
+    // Components are stored one by one, leaving the others of the vector untouched.
+    for (uint32_t i = 0; i < ref->component_count; i++) {
+        uint32_t component = (ref->component_count == 1) ? value : rgsl_spirv_extract(e, rgsl_spirv_type(e, scalar, 0), value, i);
+        uint32_t pointer = rgsl_spirv_ref_pointer(e, ref, scalar, rgsl_spirv_int(e, ref->components[i]));
+        rgsl_spirv_store_pointer(e, pointer, rgsl_spirv_relayout(e, component, scalar, 0, ref->layout));
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Operators                                                                  */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Opcodes of an operator per scalar kind of its operands: float, int, uint and
+ * bool, 0 where the operator does not apply.
+ */
+struct rgsl_spirv_operator {
+    enum rgsl_token_kind token;
+    uint16_t ops[4];
+};
+
+static const struct rgsl_spirv_operator OPERATORS[] = {
+    {RGSL_TOKEN_PLUS, {RGSL_OP_F_ADD, RGSL_OP_I_ADD, RGSL_OP_I_ADD, 0}},
+    {RGSL_TOKEN_MINUS, {RGSL_OP_F_SUB, RGSL_OP_I_SUB, RGSL_OP_I_SUB, 0}},
+    {RGSL_TOKEN_STAR, {RGSL_OP_F_MUL, RGSL_OP_I_MUL, RGSL_OP_I_MUL, 0}},
+    {RGSL_TOKEN_SLASH, {RGSL_OP_F_DIV, RGSL_OP_S_DIV, RGSL_OP_U_DIV, 0}},
+    {RGSL_TOKEN_PERCENT, {0, RGSL_OP_S_REM, RGSL_OP_U_MOD, 0}},
+    {RGSL_TOKEN_AMPERSAND, {0, RGSL_OP_BITWISE_AND, RGSL_OP_BITWISE_AND, 0}},
+    {RGSL_TOKEN_BAR, {0, RGSL_OP_BITWISE_OR, RGSL_OP_BITWISE_OR, 0}},
+    {RGSL_TOKEN_CARET, {0, RGSL_OP_BITWISE_XOR, RGSL_OP_BITWISE_XOR, 0}},
+    {RGSL_TOKEN_LEFT_SHIFT, {0, RGSL_OP_SHIFT_LEFT_LOGICAL, RGSL_OP_SHIFT_LEFT_LOGICAL, 0}},
+    {RGSL_TOKEN_RIGHT_SHIFT, {0, RGSL_OP_SHIFT_RIGHT_ARITHMETIC, RGSL_OP_SHIFT_RIGHT_LOGICAL, 0}},
+    {RGSL_TOKEN_EQUAL_EQUAL, {RGSL_OP_F_ORD_EQUAL, RGSL_OP_I_EQUAL, RGSL_OP_I_EQUAL, RGSL_OP_LOGICAL_EQUAL}},
+    {RGSL_TOKEN_BANG_EQUAL, {RGSL_OP_F_UNORD_NOT_EQUAL, RGSL_OP_I_NOT_EQUAL, RGSL_OP_I_NOT_EQUAL, RGSL_OP_LOGICAL_NOT_EQUAL}},
+    {RGSL_TOKEN_LESS, {RGSL_OP_F_ORD_LESS_THAN, RGSL_OP_S_LESS_THAN, RGSL_OP_U_LESS_THAN, 0}},
+    {RGSL_TOKEN_GREATER, {RGSL_OP_F_ORD_GREATER_THAN, RGSL_OP_S_GREATER_THAN, RGSL_OP_U_GREATER_THAN, 0}},
+    {RGSL_TOKEN_LESS_EQUAL, {RGSL_OP_F_ORD_LESS_THAN_EQUAL, RGSL_OP_S_LESS_THAN_EQUAL, RGSL_OP_U_LESS_THAN_EQUAL, 0}},
+    {RGSL_TOKEN_GREATER_EQUAL, {RGSL_OP_F_ORD_GREATER_THAN_EQUAL, RGSL_OP_S_GREATER_THAN_EQUAL, RGSL_OP_U_GREATER_THAN_EQUAL, 0}},
+    {RGSL_TOKEN_XOR_XOR, {0, 0, 0, RGSL_OP_LOGICAL_NOT_EQUAL}},
+    {RGSL_TOKEN_AND_AND, {0, 0, 0, RGSL_OP_LOGICAL_AND}},
+    {RGSL_TOKEN_OR_OR, {0, 0, 0, RGSL_OP_LOGICAL_OR}}
+};
+
+static uint32_t rgsl_spirv_operator(enum rgsl_token_kind token, enum rgsl_scalar_kind scalar) {
+    for (size_t i = 0; i < sizeof(OPERATORS) / sizeof(OPERATORS[0]); i++) {
+        if (OPERATORS[i].token == token) {
+            return OPERATORS[i].ops[scalar];
+        }
+    }
+    return 0;
+}
+
+// "a op= b" is "a = a op b", in the order of the compound assignment tokens.
+static const enum rgsl_token_kind COMPOUND_OPERATORS[] = {
+    RGSL_TOKEN_PLUS, RGSL_TOKEN_MINUS, RGSL_TOKEN_STAR, RGSL_TOKEN_SLASH, RGSL_TOKEN_PERCENT,
+    RGSL_TOKEN_AMPERSAND, RGSL_TOKEN_BAR, RGSL_TOKEN_CARET, RGSL_TOKEN_LEFT_SHIFT, RGSL_TOKEN_RIGHT_SHIFT
+};
+
+/**
+ * Applies an arithmetic or bitwise operator. Scalars meet vectors by being
+ * repeated, and matrices are operated on column by column but for the products
+ * of linear algebra.
+ */
+static uint32_t rgsl_spirv_arithmetic(struct rgsl_spirv_emitter* e, enum rgsl_token_kind op, uint32_t a, const struct rgsl_type* a_type, uint32_t b, const struct rgsl_type* b_type,
+                                      const struct rgsl_type* result) {
+    uint32_t type = rgsl_spirv_type(e, result, 0);
+    bool a_matrix = a_type->kind == RGSL_TYPE_MATRIX;
+    bool b_matrix = b_type->kind == RGSL_TYPE_MATRIX;
+    if (op == RGSL_TOKEN_STAR) {
+        if (a_matrix && b_matrix) {
+            return rgsl_spirv_op2(e, RGSL_OP_MATRIX_TIMES_MATRIX, type, a, b);
+        }
+        if (a_matrix && b_type->kind == RGSL_TYPE_VECTOR) {
+            return rgsl_spirv_op2(e, RGSL_OP_MATRIX_TIMES_VECTOR, type, a, b);
+        }
+        if (a_type->kind == RGSL_TYPE_VECTOR && b_matrix) {
+            return rgsl_spirv_op2(e, RGSL_OP_VECTOR_TIMES_MATRIX, type, a, b);
+        }
+        if (a_matrix || b_matrix) {
+            return a_matrix ? rgsl_spirv_op2(e, RGSL_OP_MATRIX_TIMES_SCALAR, type, a, b) : rgsl_spirv_op2(e, RGSL_OP_MATRIX_TIMES_SCALAR, type, b, a);
+        }
+        if (result->scalar == RGSL_SCALAR_FLOAT && a_type->kind != b_type->kind) {
+            return (a_type->kind == RGSL_TYPE_VECTOR) ? rgsl_spirv_op2(e, RGSL_OP_VECTOR_TIMES_SCALAR, type, a, b) : rgsl_spirv_op2(e, RGSL_OP_VECTOR_TIMES_SCALAR, type, b, a);
+        }
+    }
+    if (a_matrix || b_matrix) {
+        const struct rgsl_type* column = rgsl_vector_type(RGSL_SCALAR_FLOAT, result->rows);
+        uint32_t column_type = rgsl_spirv_type(e, column, 0);
+        uint32_t columns[4];
+        uint32_t a_column = a_matrix ? 0 : rgsl_spirv_splat(e, a, RGSL_SCALAR_FLOAT, result->rows);
+        uint32_t b_column = b_matrix ? 0 : rgsl_spirv_splat(e, b, RGSL_SCALAR_FLOAT, result->rows);
+        for (uint32_t i = 0; i < result->columns; i++) {
+            uint32_t x = a_matrix ? rgsl_spirv_extract(e, column_type, a, i) : a_column;
+            uint32_t y = b_matrix ? rgsl_spirv_extract(e, column_type, b, i) : b_column;
+            columns[i] = rgsl_spirv_arithmetic(e, op, x, column, y, column, column);
+        }
+        return rgsl_spirv_construct(e, type, columns, result->columns);
+    }
+    if (op == RGSL_TOKEN_LEFT_SHIFT || op == RGSL_TOKEN_RIGHT_SHIFT) {
+        // Shifts keep the type of their left operand, the shift amount may have another signedness.
+        if (a_type->kind == RGSL_TYPE_VECTOR && b_type->kind == RGSL_TYPE_SCALAR) {
+            b = rgsl_spirv_splat(e, b, b_type->scalar, a_type->rows);
+        }
+        return rgsl_spirv_op2(e, rgsl_spirv_operator(op, a_type->scalar), type, a, b);
+    }
+    if (a_type->kind == RGSL_TYPE_SCALAR && b_type->kind == RGSL_TYPE_VECTOR) {
+        a = rgsl_spirv_splat(e, a, a_type->scalar, b_type->rows);
+    } else if (a_type->kind == RGSL_TYPE_VECTOR && b_type->kind == RGSL_TYPE_SCALAR) {
+        b = rgsl_spirv_splat(e, b, b_type->scalar, a_type->rows);
+    }
+    return rgsl_spirv_op2(e, rgsl_spirv_operator(op, a_type->scalar), type, a, b);
+}
+
+// Compares two values of any type but samplers, giving a single bool.
+static uint32_t rgsl_spirv_equal(struct rgsl_spirv_emitter* e, uint32_t a, uint32_t b, const struct rgsl_type* type) {
+    uint32_t bool_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_BOOL, 1);
+    switch (type->kind) {
+        case RGSL_TYPE_SCALAR:
+        case RGSL_TYPE_VECTOR: {
+            uint32_t result = rgsl_spirv_op2(e, rgsl_spirv_operator(RGSL_TOKEN_EQUAL_EQUAL, type->scalar), rgsl_spirv_vector_type(e, RGSL_SCALAR_BOOL, type->rows), a, b);
+            return (type->kind == RGSL_TYPE_VECTOR) ? rgsl_spirv_op1(e, RGSL_OP_ALL, bool_type, result) : result;
+        }
+        case RGSL_TYPE_MATRIX:
+        case RGSL_TYPE_ARRAY:
+        case RGSL_TYPE_STRUCT: {
+            uint32_t count = (type->kind == RGSL_TYPE_MATRIX) ? type->columns : (type->kind == RGSL_TYPE_ARRAY) ? type->array_size : type->structure->field_count;
+            uint32_t result = 0;
+            for (uint32_t i = 0; i < count; i++) {
+                const struct rgsl_type* member = (type->kind == RGSL_TYPE_MATRIX) ? rgsl_vector_type(RGSL_SCALAR_FLOAT, type->rows) :
+                                                 (type->kind == RGSL_TYPE_ARRAY) ? type->element : type->structure->fields[i].type;
+                uint32_t member_type = rgsl_spirv_type(e, member, 0);
+                uint32_t equal = rgsl_spirv_equal(e, rgsl_spirv_extract(e, member_type, a, i), rgsl_spirv_extract(e, member_type, b, i), member);
+                result = (result == 0) ? equal : rgsl_spirv_op2(e, RGSL_OP_LOGICAL_AND, bool_type, result, equal);
+            }
+            return result;
+        }
+        default:
+            return rgsl_spirv_constant(e, RGSL_SCALAR_BOOL, 0);
+    }
+}
+
+/**
+ * Tells whether an expression can be evaluated even when its value is not
+ * needed, having no side effect and no access that could be out of bounds.
+ * Such operands of && and ?: are selected instead of branched over.
+ */
+static bool rgsl_spirv_simple(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    if (rgsl_spirv_folded(e, expr)) {
+        return true;
+    }
+    switch (expr->kind) {
+        case RGSL_EXPR_LITERAL:
+        case RGSL_EXPR_VARIABLE:
+            return true;
+        case RGSL_EXPR_FIELD:
+        case RGSL_EXPR_SWIZZLE:
+        case RGSL_EXPR_CONVERT:
+            return rgsl_spirv_simple(e, expr->operands[0]);
+        case RGSL_EXPR_UNARY:
+            return expr->op != RGSL_TOKEN_PLUS_PLUS && expr->op != RGSL_TOKEN_MINUS_MINUS && rgsl_spirv_simple(e, expr->operands[0]);
+        case RGSL_EXPR_BINARY:
+            return rgsl_spirv_simple(e, expr->operands[0]) && rgsl_spirv_simple(e, expr->operands[1]);
+        default:
+            return false;
+    }
+}
+
+// Converts a scalar or vector to another scalar kind, as constructors and implicit conversions do.
+static uint32_t rgsl_spirv_convert(struct rgsl_spirv_emitter* e, uint32_t value, const struct rgsl_type* from, enum rgsl_scalar_kind to) {
+    if (from->scalar == to) {
+        return value;
+    }
+    uint32_t rows = from->rows;
+    uint32_t type = rgsl_spirv_vector_type(e, to, rows);
+    if (from->scalar == RGSL_SCALAR_BOOL) {
+        uint32_t one = (to == RGSL_SCALAR_FLOAT) ? rgsl_spirv_float(e, 1.0f) : rgsl_spirv_constant(e, to, 1);
+        uint32_t zero = rgsl_spirv_constant(e, to, 0);
+        return rgsl_spirv_op3(e, RGSL_OP_SELECT, type, value, rgsl_spirv_splat(e, one, to, rows), rgsl_spirv_splat(e, zero, to, rows));
+    }
+    if (to == RGSL_SCALAR_BOOL) {
+        uint32_t zero = rgsl_spirv_splat(e, rgsl_spirv_constant(e, from->scalar, 0), from->scalar, rows);
+        return rgsl_spirv_op2(e, rgsl_spirv_operator(RGSL_TOKEN_BANG_EQUAL, from->scalar), type, value, zero);
+    }
+    static const uint32_t CONVERSIONS[3][3] = {
+        {0, RGSL_OP_CONVERT_F_TO_S, RGSL_OP_CONVERT_F_TO_U},
+        {RGSL_OP_CONVERT_S_TO_F, 0, RGSL_OP_BITCAST},
+        {RGSL_OP_CONVERT_U_TO_F, RGSL_OP_BITCAST, 0}
+    };
+    return rgsl_spirv_op1(e, CONVERSIONS[from->scalar][to], type, value);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Constructors                                                               */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Piece of a constructed vector or matrix: a scalar, or a whole vector taken
+ * as is, converted to the scalar kind of the result.
+ */
+struct rgsl_spirv_piece {
+    uint32_t id;
+    uint32_t size;
+};
+
+/**
+ * Breaks the arguments of a constructor into pieces, vectors that fit being
+ * kept whole unless the columns of a matrix need them split.
+ */
+static uint32_t rgsl_spirv_pieces(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr, uint32_t needed, uint32_t column_rows, struct rgsl_spirv_piece* pieces) {
+    enum rgsl_scalar_kind scalar = expr->type->scalar;
+    uint32_t given = 0;
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < expr->argument_count && given < needed; i++) {
+        const struct rgsl_type* type = expr->arguments[i]->type;
+        uint32_t value = rgsl_spirv_expr(e, expr->arguments[i]);
+        if (type->kind == RGSL_TYPE_SCALAR) {
+            pieces[count].id = rgsl_spirv_convert(e, value, type, scalar);
+            pieces[count++].size = 1;
+            given++;
+            continue;
+        }
+        bool whole = type->kind == RGSL_TYPE_VECTOR && given + type->rows <= needed &&
+                     (column_rows == 0 || (given % column_rows == 0 && type->rows == column_rows));
+        if (whole) {
+            pieces[count].id = rgsl_spirv_convert(e, value, type, scalar);
+            pieces[count++].size = type->rows;
+            given += type->rows;
+            continue;
+        }
+        // Vectors crossing columns and matrices are taken component by component.
+        const struct rgsl_type* column = rgsl_vector_type(type->scalar, type->rows);
+        const struct rgsl_type* component = rgsl_vector_type(type->scalar, 1);
+        uint32_t columns = (type->kind == RGSL_TYPE_MATRIX) ? type->columns : 1;
+        for (uint32_t c = 0; c < columns && given < needed; c++) {
+            uint32_t vector = (type->kind == RGSL_TYPE_MATRIX) ? rgsl_spirv_extract(e, rgsl_spirv_type(e, column, 0), value, c) : value;
+            for (uint32_t r = 0; r < type->rows && given < needed; r++) {
+                uint32_t element = rgsl_spirv_extract(e, rgsl_spirv_type(e, component, 0), vector, r);
+                pieces[count].id = rgsl_spirv_convert(e, element, component, scalar);
+                pieces[count++].size = 1;
+                given++;
+            }
+        }
+    }
+    return count;
+}
+
+// Builds a vector of pieces, constant vectors being broken into the scalars constants are made of.
+static uint32_t rgsl_spirv_construct_pieces(struct rgsl_spirv_emitter* e, uint32_t type, const struct rgsl_spirv_piece* pieces, uint32_t count) {
+    uint32_t ids[16];
+    uint32_t id_count = 0;
+    bool constant = true;
+    for (uint32_t i = 0; i < count; i++) {
+        constant = constant && rgsl_spirv_is_constant(e, pieces[i].id);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (constant && pieces[i].size > 1) {
+            for (uint32_t k = 0; k < pieces[i].size; k++) {
+                ids[id_count++] = rgsl_spirv_constituent(e, pieces[i].id, k);
+            }
+        } else {
+            ids[id_count++] = pieces[i].id;
+        }
+    }
+    return rgsl_spirv_construct(e, type, ids, id_count);
+}
+
+// Resizes a matrix, the columns and rows it lacks coming from the identity.
+static uint32_t rgsl_spirv_resize_matrix(struct rgsl_spirv_emitter* e, uint32_t value, const struct rgsl_type* from, const struct rgsl_type* to) {
+    uint32_t zero = rgsl_spirv_float(e, 0.0f);
+    uint32_t one = rgsl_spirv_float(e, 1.0f);
+    uint32_t float_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, 1);
+    uint32_t from_column = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, from->rows);
+    uint32_t to_column = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, to->rows);
+    uint32_t columns[4];
+    for (uint32_t c = 0; c < to->columns; c++) {
+        uint32_t column = (c < from->columns) ? rgsl_spirv_extract(e, from_column, value, c) : 0;
+        if (column != 0 && from->rows == to->rows) {
+            columns[c] = column;
+            continue;
+        }
+        uint32_t components[4];
+        for (uint32_t r = 0; r < to->rows; r++) {
+            components[r] = (column != 0 && r < from->rows) ? rgsl_spirv_extract(e, float_type, column, r) : (r == c) ? one : zero;
+        }
+        columns[c] = rgsl_spirv_construct(e, to_column, components, to->rows);
+    }
+    return rgsl_spirv_construct(e, rgsl_spirv_type(e, to, 0), columns, to->columns);
+}
+
+static uint32_t rgsl_spirv_construct_expr(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    const struct rgsl_type* type = expr->type;
+    uint32_t type_id = rgsl_spirv_type(e, type, 0);
+    if (type->kind == RGSL_TYPE_ARRAY || type->kind == RGSL_TYPE_STRUCT) {
+        uint32_t* members = (uint32_t *)rgsl_malloc((expr->argument_count + 1) * sizeof(uint32_t));
+        for (uint32_t i = 0; i < expr->argument_count; i++) {
+            members[i] = rgsl_spirv_expr(e, expr->arguments[i]);
+        }
+        uint32_t result = rgsl_spirv_construct(e, type_id, members, expr->argument_count);
+        rgsl_free(members);
+        return result;
+    }
+    const struct rgsl_type* first = expr->arguments[0]->type;
+    if (type->kind == RGSL_TYPE_SCALAR || (expr->argument_count == 1 && first->kind == RGSL_TYPE_SCALAR)) {
+        uint32_t value = rgsl_spirv_expr(e, expr->arguments[0]);
+        if (first->kind != RGSL_TYPE_SCALAR) {
+            // A scalar constructed from a vector or matrix takes its first component.
+            if (first->kind == RGSL_TYPE_MATRIX) {
+                value = rgsl_spirv_extract(e, rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, first->rows), value, 0);
+            }
+            value = rgsl_spirv_extract(e, rgsl_spirv_vector_type(e, first->scalar, 1), value, 0);
+        }
+        value = rgsl_spirv_convert(e, value, rgsl_vector_type(first->scalar, 1), type->scalar);
+        if (type->kind == RGSL_TYPE_SCALAR) {
+            return value;
+        }
+        if (type->kind == RGSL_TYPE_VECTOR) {
+            return rgsl_spirv_splat(e, value, type->scalar, type->rows);
+        }
+        // A single scalar fills the diagonal of a matrix.
+        uint32_t zero = rgsl_spirv_float(e, 0.0f);
+        uint32_t column_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, type->rows);
+        uint32_t columns[4];
+        for (uint32_t c = 0; c < type->columns; c++) {
+            uint32_t components[4];
+            for (uint32_t r = 0; r < type->rows; r++) {
+                components[r] = (r == c) ? value : zero;
+            }
+            columns[c] = rgsl_spirv_construct(e, column_type, components, type->rows);
+        }
+        return rgsl_spirv_construct(e, type_id, columns, type->columns);
+    }
+    if (type->kind == RGSL_TYPE_MATRIX && first->kind == RGSL_TYPE_MATRIX) {
+        return rgsl_spirv_resize_matrix(e, rgsl_spirv_expr(e, expr->arguments[0]), first, type);
+    }
+    struct rgsl_spirv_piece pieces[16];
+    if (type->kind == RGSL_TYPE_VECTOR) {
+        uint32_t count = rgsl_spirv_pieces(e, expr, type->rows, 0, pieces);
+        if (count == 1) {
+            return pieces[0].id;
+        }
+        return rgsl_spirv_construct_pieces(e, type_id, pieces, count);
+    }
+    uint32_t count = rgsl_spirv_pieces(e, expr, type->columns * type->rows, type->rows, pieces);
+    uint32_t column_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, type->rows);
+    uint32_t columns[4];
+    uint32_t column = 0;
+    for (uint32_t i = 0; i < count;) {
+        if (pieces[i].size == type->rows) {
+            columns[column++] = pieces[i++].id;
+            continue;
+        }
+        columns[column++] = rgsl_spirv_construct_pieces(e, column_type, &pieces[i], type->rows);
+        i += type->rows;
+    }
+    return rgsl_spirv_construct(e, type_id, columns, type->columns);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Expressions                                                                */
+/* -------------------------------------------------------------------------- */
+
+static uint32_t rgsl_spirv_builtin_call(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr);
+
+// Joins the values an expression has at the end of the branches reaching the current block.
+static uint32_t rgsl_spirv_join(struct rgsl_spirv_emitter* e, uint32_t type, const uint32_t* values, const uint32_t* blocks, uint32_t count) {
+    if (e->current == RGSL_SPIRV_NO_BLOCK) {
+        return rgsl_spirv_undef(e, type);
+    }
+    uint32_t index = rgsl_spirv_new_phi(e, NULL, e->current);
+    e->phis[index].type = type;
+    const struct rgsl_spirv_words* predecessors = &e->blocks[e->current].predecessors;
+    for (size_t i = 0; i < predecessors->count; i++) {
+        uint32_t value = 0;
+        for (uint32_t k = 0; k < count; k++) {
+            if (blocks[k] == predecessors->data[i]) {
+                value = values[k];
+            }
+        }
+        rgsl_spirv_push(&e->phis[index].operands, (value != 0) ? value : rgsl_spirv_undef(e, type));
+    }
+    return e->phis[index].id;
+}
+
+static uint32_t rgsl_spirv_increment(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    struct rgsl_spirv_ref ref;
+    rgsl_spirv_ref(e, expr->operands[0], &ref);
+    const struct rgsl_type* type = expr->type;
+    uint32_t one = (type->scalar == RGSL_SCALAR_FLOAT) ? rgsl_spirv_float(e, 1.0f) : rgsl_spirv_constant(e, type->scalar, 1);
+    uint32_t old = rgsl_spirv_load(e, &ref);
+    enum rgsl_token_kind op = (expr->op == RGSL_TOKEN_PLUS_PLUS) ? RGSL_TOKEN_PLUS : RGSL_TOKEN_MINUS;
+    uint32_t value = rgsl_spirv_arithmetic(e, op, old, type, one, rgsl_vector_type(type->scalar, 1), type);
+    rgsl_spirv_store(e, &ref, value);
+    return expr->postfix ? old : value;
+}
+
+static uint32_t rgsl_spirv_unary(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    if (expr->op == RGSL_TOKEN_PLUS_PLUS || expr->op == RGSL_TOKEN_MINUS_MINUS) {
+        return rgsl_spirv_increment(e, expr);
+    }
+    const struct rgsl_type* type = expr->type;
+    uint32_t type_id = rgsl_spirv_type(e, type, 0);
+    uint32_t value = rgsl_spirv_expr(e, expr->operands[0]);
+    switch (expr->op) {
+        case RGSL_TOKEN_MINUS:
+            if (type->kind == RGSL_TYPE_MATRIX) {
+                uint32_t column_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, type->rows);
+                uint32_t columns[4];
+                for (uint32_t i = 0; i < type->columns; i++) {
+                    columns[i] = rgsl_spirv_op1(e, RGSL_OP_F_NEGATE, column_type, rgsl_spirv_extract(e, column_type, value, i));
+                }
+                return rgsl_spirv_construct(e, type_id, columns, type->columns);
+            }
+            return rgsl_spirv_op1(e, (type->scalar == RGSL_SCALAR_FLOAT) ? RGSL_OP_F_NEGATE : RGSL_OP_S_NEGATE, type_id, value);
+        case RGSL_TOKEN_BANG:
+            return rgsl_spirv_op1(e, RGSL_OP_LOGICAL_NOT, type_id, value);
+        case RGSL_TOKEN_TILDE:
+            return rgsl_spirv_op1(e, RGSL_OP_NOT, type_id, value);
+        default:
+            return value;
+    }
+}
+
+// && and || evaluate their right operand only when it decides the result, unless it has no effect.
+static uint32_t rgsl_spirv_logical(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    uint32_t bool_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_BOOL, 1);
+    uint32_t left = rgsl_spirv_expr(e, expr->operands[0]);
+    if (rgsl_spirv_simple(e, expr->operands[1])) {
+        return rgsl_spirv_op2(e, rgsl_spirv_operator(expr->op, RGSL_SCALAR_BOOL), bool_type, left, rgsl_spirv_expr(e, expr->operands[1]));
+    }
+    bool conjunction = expr->op == RGSL_TOKEN_AND_AND;
+    uint32_t right = rgsl_spirv_new_block(e);
+    uint32_t merge = rgsl_spirv_new_block(e);
+    uint32_t values[2] = {rgsl_spirv_constant(e, RGSL_SCALAR_BOOL, conjunction ? 0 : 1), 0};
+    uint32_t blocks[2] = {e->current, 0};
+    rgsl_spirv_selection_merge(e, merge);
+    rgsl_spirv_branch_conditional(e, left, conjunction ? right : merge, conjunction ? merge : right);
+    rgsl_spirv_seal_block(e, right);
+    rgsl_spirv_start_block(e, right);
+    values[1] = rgsl_spirv_expr(e, expr->operands[1]);
+    blocks[1] = e->current;
+    rgsl_spirv_branch(e, merge);
+    rgsl_spirv_start_merge(e, merge);
+    return rgsl_spirv_join(e, bool_type, values, blocks, 2);
+}
+
+static uint32_t rgsl_spirv_binary(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    enum rgsl_token_kind op = expr->op;
+    if (op == RGSL_TOKEN_AND_AND || op == RGSL_TOKEN_OR_OR) {
+        return rgsl_spirv_logical(e, expr);
+    }
+    const struct rgsl_type* a_type = expr->operands[0]->type;
+    const struct rgsl_type* b_type = expr->operands[1]->type;
+    uint32_t a = rgsl_spirv_expr(e, expr->operands[0]);
+    uint32_t b = rgsl_spirv_expr(e, expr->operands[1]);
+    uint32_t bool_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_BOOL, 1);
+    switch (op) {
+        case RGSL_TOKEN_EQUAL_EQUAL:
+        case RGSL_TOKEN_BANG_EQUAL:
+            if (a_type->kind != RGSL_TYPE_SCALAR) {
+                uint32_t equal = rgsl_spirv_equal(e, a, b, a_type);
+                return (op == RGSL_TOKEN_EQUAL_EQUAL) ? equal : rgsl_spirv_op1(e, RGSL_OP_LOGICAL_NOT, bool_type, equal);
+            }
+            return rgsl_spirv_op2(e, rgsl_spirv_operator(op, a_type->scalar), bool_type, a, b);
+        case RGSL_TOKEN_LESS:
+        case RGSL_TOKEN_GREATER:
+        case RGSL_TOKEN_LESS_EQUAL:
+        case RGSL_TOKEN_GREATER_EQUAL:
+        case RGSL_TOKEN_XOR_XOR:
+            return rgsl_spirv_op2(e, rgsl_spirv_operator(op, a_type->scalar), bool_type, a, b);
+        default:
+            return rgsl_spirv_arithmetic(e, op, a, a_type, b, b_type, expr->type);
+    }
+}
+
+static uint32_t rgsl_spirv_assign(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    struct rgsl_spirv_ref ref;
+    rgsl_spirv_ref(e, expr->operands[0], &ref);
+    uint32_t value;
+    if (expr->op == RGSL_TOKEN_EQUAL) {
+        value = rgsl_spirv_expr(e, expr->operands[1]);
+    } else {
+        uint32_t old = rgsl_spirv_load(e, &ref);
+        uint32_t operand = rgsl_spirv_expr(e, expr->operands[1]);
+        enum rgsl_token_kind op = COMPOUND_OPERATORS[expr->op - RGSL_TOKEN_PLUS_EQUAL];
+        value = rgsl_spirv_arithmetic(e, op, old, expr->operands[0]->type, operand, expr->operands[1]->type, expr->type);
+    }
+    rgsl_spirv_store(e, &ref, value);
+    return value;
+}
+
+static uint32_t rgsl_spirv_conditional(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    const struct rgsl_expr* condition = expr->operands[0];
+    if (rgsl_spirv_folded(e, condition)) {
+        return rgsl_spirv_expr(e, expr->operands[condition->value.b ? 1 : 2]);
+    }
+    const struct rgsl_type* type = expr->type;
+    uint32_t selector = rgsl_spirv_expr(e, condition);
+    if ((type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) && rgsl_spirv_simple(e, expr->operands[1]) && rgsl_spirv_simple(e, expr->operands[2])) {
+        uint32_t a = rgsl_spirv_expr(e, expr->operands[1]);
+        uint32_t b = rgsl_spirv_expr(e, expr->operands[2]);
+        return rgsl_spirv_op3(e, RGSL_OP_SELECT, rgsl_spirv_type(e, type, 0), rgsl_spirv_splat(e, selector, RGSL_SCALAR_BOOL, type->rows), a, b);
+    }
+    uint32_t branches[2] = {rgsl_spirv_new_block(e), rgsl_spirv_new_block(e)};
+    uint32_t merge = rgsl_spirv_new_block(e);
+    rgsl_spirv_selection_merge(e, merge);
+    rgsl_spirv_branch_conditional(e, selector, branches[0], branches[1]);
+    uint32_t values[2];
+    uint32_t blocks[2];
+    for (uint32_t i = 0; i < 2; i++) {
+        rgsl_spirv_seal_block(e, branches[i]);
+        rgsl_spirv_start_block(e, branches[i]);
+        values[i] = rgsl_spirv_expr(e, expr->operands[1 + i]);
+        blocks[i] = e->current;
+        rgsl_spirv_branch(e, merge);
+    }
+    rgsl_spirv_start_merge(e, merge);
+    if (type->kind == RGSL_TYPE_VOID) {
+        return 0;
+    }
+    return rgsl_spirv_join(e, rgsl_spirv_type(e, type, 0), values, blocks, 2);
+}
+
+// Indexes, fields and swizzles of values which are not in variables, like the results of calls.
+static uint32_t rgsl_spirv_access(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    if (rgsl_spirv_is_ref(e, expr)) {
+        struct rgsl_spirv_ref ref;
+        rgsl_spirv_ref(e, expr, &ref);
+        return rgsl_spirv_load(e, &ref);
+    }
+    const struct rgsl_expr* base = expr->operands[0];
+    uint32_t value = rgsl_spirv_expr(e, base);
+    uint32_t type = rgsl_spirv_type(e, expr->type, 0);
+    if (expr->kind == RGSL_EXPR_FIELD) {
+        return rgsl_spirv_extract(e, type, value, expr->field);
+    }
+    if (expr->kind == RGSL_EXPR_SWIZZLE) {
+        if (base->type->kind == RGSL_TYPE_SCALAR) {
+            return rgsl_spirv_splat(e, value, base->type->scalar, expr->swizzle_count);
+        }
+        if (expr->swizzle_count == 1) {
+            return rgsl_spirv_extract(e, type, value, expr->swizzle[0]);
+        }
+        uint32_t components[4];
+        for (uint32_t i = 0; i < expr->swizzle_count; i++) {
+            components[i] = expr->swizzle[i];
+        }
+        return rgsl_spirv_shuffle(e, type, value, value, components, expr->swizzle_count);
+    }
+    const struct rgsl_expr* index = expr->operands[1];
+    if (rgsl_spirv_folded(e, index)) {
+        return rgsl_spirv_extract(e, type, value, index->value.u);
+    }
+    uint32_t dynamic = rgsl_spirv_expr(e, index);
+    if (base->type->kind == RGSL_TYPE_VECTOR) {
+        return rgsl_spirv_op2(e, RGSL_OP_VECTOR_EXTRACT_DYNAMIC, type, value, dynamic);
+    }
+    // Arrays and matrices are only indexed dynamically through pointers.
+    uint32_t local = rgsl_spirv_local(e, base->type);
+    rgsl_spirv_store_pointer(e, local, value);
+    uint32_t pointer = rgsl_spirv_op2(e, RGSL_OP_ACCESS_CHAIN, rgsl_spirv_pointer_type(e, RGSL_SPIRV_STORAGE_FUNCTION, type), local, dynamic);
+    return rgsl_spirv_op1(e, RGSL_OP_LOAD, type, pointer);
+}
+
+// Length of the runtime array ending a buffer block, the only length not known at compile time.
+static uint32_t rgsl_spirv_length(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    const struct rgsl_expr* array = expr->operands[0];
+    uint32_t int_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_INT, 1);
+    struct rgsl_spirv_ref ref;
+    if (!rgsl_spirv_is_ref(e, array) || (array->kind != RGSL_EXPR_FIELD && array->kind != RGSL_EXPR_VARIABLE)) {
+        rgsl_spirv_error(e, expr->line, "%s", "the length of this array is not known to the SPIR-V backend");
+        return rgsl_spirv_undef(e, int_type);
+    }
+    rgsl_spirv_ref(e, array, &ref);
+    if (ref.index_count == 0) {
+        rgsl_spirv_error(e, expr->line, "%s", "the length of this array is not known to the SPIR-V backend");
+        return rgsl_spirv_undef(e, int_type);
+    }
+    uint32_t member = rgsl_spirv_constant_bits(e, ref.indices[--ref.index_count]);
+    const struct rgsl_type* container = (array->kind == RGSL_EXPR_FIELD) ? array->operands[0]->type : array->variable->block->members.type;
+    uint32_t pointer = rgsl_spirv_ref_pointer(e, &ref, container, 0);
+    uint32_t uint_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_UINT, 1);
+    uint32_t length = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_ARRAY_LENGTH, 4);
+    rgsl_spirv_code_literal(e, uint_type);
+    rgsl_spirv_code_literal(e, length);
+    rgsl_spirv_code_id(e, pointer);
+    rgsl_spirv_code_literal(e, member);
+    return rgsl_spirv_op1(e, RGSL_OP_BITCAST, int_type, length);
+}
+
+/**
+ * Calls a function of the module. Out and inout arguments are passed as
+ * pointers to temporaries, copied back once the function returns as GLSL
+ * specifies.
+ */
+static uint32_t rgsl_spirv_call(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    const struct rgsl_function* function = expr->function->definition;
+    uint32_t result_type = rgsl_spirv_type(e, expr->type, 0);
+    if (function == NULL) {
+        rgsl_spirv_error(e, expr->line, "%s is called but never defined", expr->name);
+        return (expr->type->kind == RGSL_TYPE_VOID) ? 0 : rgsl_spirv_undef(e, result_type);
+    }
+    uint32_t count = expr->argument_count;
+    uint32_t* arguments = (uint32_t *)rgsl_malloc((count + 1) * sizeof(uint32_t));
+    uint32_t* locals = (uint32_t *)rgsl_calloc(count + 1, sizeof(uint32_t));
+    struct rgsl_spirv_ref* refs = (struct rgsl_spirv_ref *)rgsl_calloc(count + 1, sizeof(struct rgsl_spirv_ref));
+    for (uint32_t i = 0; i < count; i++) {
+        const struct rgsl_variable* parameter = function->parameters[i];
+        if (parameter->direction == RGSL_DIRECTION_IN) {
+            if (parameter->type->kind == RGSL_TYPE_ARRAY && rgsl_type_is_opaque(parameter->type)) {
+                rgsl_spirv_error(e, expr->line, "%s takes an array of samplers, which the SPIR-V backend cannot pass (use --glslang-spirv)", expr->name);
+            }
+            arguments[i] = rgsl_spirv_expr(e, expr->arguments[i]);
+            continue;
+        }
+        rgsl_spirv_ref(e, expr->arguments[i], &refs[i]);
+        locals[i] = rgsl_spirv_local(e, parameter->type);
+        if (parameter->direction == RGSL_DIRECTION_INOUT) {
+            rgsl_spirv_store_pointer(e, locals[i], rgsl_spirv_load(e, &refs[i]));
+        }
+        arguments[i] = locals[i];
+    }
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, RGSL_OP_FUNCTION_CALL, count + 3);
+    rgsl_spirv_code_literal(e, result_type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_literal(e, e->function_ids[function->id]);
+    for (uint32_t i = 0; i < count; i++) {
+        rgsl_spirv_code_id(e, arguments[i]);
+    }
+    for (uint32_t i = 0; i < count; i++) {
+        if (locals[i] != 0) {
+            const struct rgsl_type* type = function->parameters[i]->type;
+            rgsl_spirv_store(e, &refs[i], rgsl_spirv_op1(e, RGSL_OP_LOAD, rgsl_spirv_type(e, type, 0), locals[i]));
+        }
+    }
+    rgsl_free(refs);
+    rgsl_free(locals);
+    rgsl_free(arguments);
+    return (expr->type->kind == RGSL_TYPE_VOID) ? 0 : result;
+}
+
+static uint32_t rgsl_spirv_expr(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    if (rgsl_spirv_folded(e, expr)) {
+        return rgsl_spirv_scalar_constant(e, expr->type->scalar, expr->value);
+    }
+    switch (expr->kind) {
+        case RGSL_EXPR_VARIABLE: {
+            const struct rgsl_spirv_variable* info = rgsl_spirv_variable(e, expr->variable);
+            if (info->kind == RGSL_SPIRV_VARIABLE_VALUE) {
+                return info->id;
+            }
+            if (info->kind == RGSL_SPIRV_VARIABLE_NONE) {
+                rgsl_spirv_error(e, expr->line, "%s cannot be used by the SPIR-V backend", expr->variable->name);
+                return rgsl_spirv_undef(e, rgsl_spirv_type(e, expr->type, 0));
+            }
+            struct rgsl_spirv_ref ref;
+            rgsl_spirv_ref(e, expr, &ref);
+            return rgsl_spirv_load(e, &ref);
+        }
+        case RGSL_EXPR_UNARY:
+            return rgsl_spirv_unary(e, expr);
+        case RGSL_EXPR_BINARY:
+            return rgsl_spirv_binary(e, expr);
+        case RGSL_EXPR_ASSIGN:
+            return rgsl_spirv_assign(e, expr);
+        case RGSL_EXPR_CONDITIONAL:
+            return rgsl_spirv_conditional(e, expr);
+        case RGSL_EXPR_SEQUENCE:
+            rgsl_spirv_expr(e, expr->operands[0]);
+            return rgsl_spirv_expr(e, expr->operands[1]);
+        case RGSL_EXPR_CALL:
+            return (expr->builtin != NULL) ? rgsl_spirv_builtin_call(e, expr) : rgsl_spirv_call(e, expr);
+        case RGSL_EXPR_CONSTRUCT:
+            return rgsl_spirv_construct_expr(e, expr);
+        case RGSL_EXPR_INDEX:
+        case RGSL_EXPR_FIELD:
+        case RGSL_EXPR_SWIZZLE:
+            return rgsl_spirv_access(e, expr);
+        case RGSL_EXPR_LENGTH:
+            return rgsl_spirv_length(e, expr);
+        case RGSL_EXPR_CONVERT:
+            return rgsl_spirv_convert(e, rgsl_spirv_expr(e, expr->operands[0]), expr->operands[0]->type, expr->type->scalar);
+        default:
+            return rgsl_spirv_scalar_constant(e, expr->type->scalar, expr->value);
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Built-in functions                                                         */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Enumeration of how built-in functions are emitted: as instructions of
+ * GLSL.std.450, as core instructions, by code of their own, or as image
+ * instructions.
+ */
+enum rgsl_spirv_builtin_kind {
+    RGSL_SPIRV_BUILTIN_EXT,
+    RGSL_SPIRV_BUILTIN_CORE,
+    RGSL_SPIRV_BUILTIN_SPECIAL,
+    RGSL_SPIRV_BUILTIN_TEXTURE
+};
+
+/**
+ * Built-in function, with its instructions per scalar kind of its first
+ * argument: float, int, uint and bool. Broadcasting functions repeat their
+ * scalar arguments when the others are vectors.
+ */
+struct rgsl_spirv_builtin_function {
+    const char* name;
+    uint8_t kind;
+    uint16_t ops[4];
+    bool broadcast;
+};
+
+// Sorted by name for bsearch.
+static const struct rgsl_spirv_builtin_function BUILTIN_FUNCTIONS[] = {
+    {"abs", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_F_ABS, RGSL_GLSL450_S_ABS, 0, 0}, false},
+    {"acos", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ACOS, 0, 0, 0}, false},
+    {"acosh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ACOSH, 0, 0, 0}, false},
+    {"all", RGSL_SPIRV_BUILTIN_CORE, {0, 0, 0, RGSL_OP_ALL}, false},
+    {"any", RGSL_SPIRV_BUILTIN_CORE, {0, 0, 0, RGSL_OP_ANY}, false},
+    {"asin", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ASIN, 0, 0, 0}, false},
+    {"asinh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ASINH, 0, 0, 0}, false},
+    {"atan", RGSL_SPIRV_BUILTIN_SPECIAL, {RGSL_GLSL450_ATAN, 0, 0, 0}, false},
+    {"atanh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ATANH, 0, 0, 0}, false},
+    {"ceil", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_CEIL, 0, 0, 0}, false},
+    {"clamp", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_F_CLAMP, RGSL_GLSL450_S_CLAMP, RGSL_GLSL450_U_CLAMP, 0}, true},
+    {"cos", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_COS, 0, 0, 0}, false},
+    {"cosh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_COSH, 0, 0, 0}, false},
+    {"cross", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_CROSS, 0, 0, 0}, false},
+    {"dFdx", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_DPDX, 0, 0, 0}, false},
+    {"dFdy", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_DPDY, 0, 0, 0}, false},
+    {"degrees", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_DEGREES, 0, 0, 0}, false},
+    {"determinant", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_DETERMINANT, 0, 0, 0}, false},
+    {"distance", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_DISTANCE, 0, 0, 0}, false},
+    {"dot", RGSL_SPIRV_BUILTIN_SPECIAL, {RGSL_OP_DOT, 0, 0, 0}, false},
+    {"equal", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_ORD_EQUAL, RGSL_OP_I_EQUAL, RGSL_OP_I_EQUAL, RGSL_OP_LOGICAL_EQUAL}, false},
+    {"exp", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_EXP, 0, 0, 0}, false},
+    {"exp2", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_EXP2, 0, 0, 0}, false},
+    {"faceforward", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_FACE_FORWARD, 0, 0, 0}, false},
+    {"floatBitsToInt", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_BITCAST, 0, 0, 0}, false},
+    {"floatBitsToUint", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_BITCAST, 0, 0, 0}, false},
+    {"floor", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_FLOOR, 0, 0, 0}, false},
+    {"fract", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_FRACT, 0, 0, 0}, false},
+    {"fwidth", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_FWIDTH, 0, 0, 0}, false},
+    {"greaterThan", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_ORD_GREATER_THAN, RGSL_OP_S_GREATER_THAN, RGSL_OP_U_GREATER_THAN, 0}, false},
+    {"greaterThanEqual", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_ORD_GREATER_THAN_EQUAL, RGSL_OP_S_GREATER_THAN_EQUAL, RGSL_OP_U_GREATER_THAN_EQUAL, 0}, false},
+    {"intBitsToFloat", RGSL_SPIRV_BUILTIN_CORE, {0, RGSL_OP_BITCAST, 0, 0}, false},
+    {"inverse", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_MATRIX_INVERSE, 0, 0, 0}, false},
+    {"inversesqrt", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_INVERSE_SQRT, 0, 0, 0}, false},
+    {"isinf", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_IS_INF, 0, 0, 0}, false},
+    {"isnan", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_IS_NAN, 0, 0, 0}, false},
+    {"length", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_LENGTH, 0, 0, 0}, false},
+    {"lessThan", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_ORD_LESS_THAN, RGSL_OP_S_LESS_THAN, RGSL_OP_U_LESS_THAN, 0}, false},
+    {"lessThanEqual", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_ORD_LESS_THAN_EQUAL, RGSL_OP_S_LESS_THAN_EQUAL, RGSL_OP_U_LESS_THAN_EQUAL, 0}, false},
+    {"log", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_LOG, 0, 0, 0}, false},
+    {"log2", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_LOG2, 0, 0, 0}, false},
+    {"matrixCompMult", RGSL_SPIRV_BUILTIN_SPECIAL, {RGSL_OP_F_MUL, 0, 0, 0}, false},
+    {"max", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_F_MAX, RGSL_GLSL450_S_MAX, RGSL_GLSL450_U_MAX, 0}, true},
+    {"min", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_F_MIN, RGSL_GLSL450_S_MIN, RGSL_GLSL450_U_MIN, 0}, true},
+    {"mix", RGSL_SPIRV_BUILTIN_SPECIAL, {RGSL_GLSL450_F_MIX, 0, 0, 0}, true},
+    {"mod", RGSL_SPIRV_BUILTIN_SPECIAL, {RGSL_OP_F_MOD, 0, 0, 0}, true},
+    {"normalize", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_NORMALIZE, 0, 0, 0}, false},
+    {"not", RGSL_SPIRV_BUILTIN_CORE, {0, 0, 0, RGSL_OP_LOGICAL_NOT}, false},
+    {"notEqual", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_F_UNORD_NOT_EQUAL, RGSL_OP_I_NOT_EQUAL, RGSL_OP_I_NOT_EQUAL, RGSL_OP_LOGICAL_NOT_EQUAL}, false},
+    {"packHalf2x16", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_PACK_HALF_2X16, 0, 0, 0}, false},
+    {"packSnorm2x16", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_PACK_SNORM_2X16, 0, 0, 0}, false},
+    {"packUnorm2x16", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_PACK_UNORM_2X16, 0, 0, 0}, false},
+    {"pow", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_POW, 0, 0, 0}, false},
+    {"radians", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_RADIANS, 0, 0, 0}, false},
+    {"reflect", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_REFLECT, 0, 0, 0}, false},
+    {"refract", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_REFRACT, 0, 0, 0}, false},
+    {"round", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ROUND, 0, 0, 0}, false},
+    {"roundEven", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_ROUND_EVEN, 0, 0, 0}, false},
+    {"sign", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_F_SIGN, RGSL_GLSL450_S_SIGN, 0, 0}, false},
+    {"sin", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_SIN, 0, 0, 0}, false},
+    {"sinh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_SINH, 0, 0, 0}, false},
+    {"smoothstep", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_SMOOTH_STEP, 0, 0, 0}, true},
+    {"sqrt", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_SQRT, 0, 0, 0}, false},
+    {"step", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_STEP, 0, 0, 0}, true},
+    {"tan", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_TAN, 0, 0, 0}, false},
+    {"tanh", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_TANH, 0, 0, 0}, false},
+    {"texelFetch", RGSL_SPIRV_BUILTIN_TEXTURE, {RGSL_OP_IMAGE_FETCH, 0, 0, 0}, false},
+    {"texture", RGSL_SPIRV_BUILTIN_TEXTURE, {0, 0, 0, 0}, false},
+    {"textureGrad", RGSL_SPIRV_BUILTIN_TEXTURE, {RGSL_IMAGE_OPERAND_GRAD, 0, 0, 0}, false},
+    {"textureLod", RGSL_SPIRV_BUILTIN_TEXTURE, {RGSL_IMAGE_OPERAND_LOD, 0, 0, 0}, false},
+    {"textureOffset", RGSL_SPIRV_BUILTIN_TEXTURE, {RGSL_IMAGE_OPERAND_CONST_OFFSET, 0, 0, 0}, false},
+    {"textureSize", RGSL_SPIRV_BUILTIN_TEXTURE, {RGSL_OP_IMAGE_QUERY_SIZE_LOD, 0, 0, 0}, false},
+    {"transpose", RGSL_SPIRV_BUILTIN_CORE, {RGSL_OP_TRANSPOSE, 0, 0, 0}, false},
+    {"trunc", RGSL_SPIRV_BUILTIN_EXT, {RGSL_GLSL450_TRUNC, 0, 0, 0}, false},
+    {"uintBitsToFloat", RGSL_SPIRV_BUILTIN_CORE, {0, 0, RGSL_OP_BITCAST, 0}, false},
+    {"unpackHalf2x16", RGSL_SPIRV_BUILTIN_EXT, {0, 0, RGSL_GLSL450_UNPACK_HALF_2X16, 0}, false},
+    {"unpackSnorm2x16", RGSL_SPIRV_BUILTIN_EXT, {0, 0, RGSL_GLSL450_UNPACK_SNORM_2X16, 0}, false},
+    {"unpackUnorm2x16", RGSL_SPIRV_BUILTIN_EXT, {0, 0, RGSL_GLSL450_UNPACK_UNORM_2X16, 0}, false}
+};
+
+static int rgsl_spirv_compare_builtin_function(const void* key, const void* element) {
+    return strcmp((const char *)key, ((const struct rgsl_spirv_builtin_function *)element)->name);
+}
+
+/**
+ * Samples, fetches from or queries a texture. Outside of fragment shaders,
+ * which have no implicit level of detail, sampling reads the base level.
+ */
+static uint32_t rgsl_spirv_texture(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr, const struct rgsl_spirv_builtin_function* function, const uint32_t* arguments) {
+    const struct rgsl_type* sampler = expr->arguments[0]->type;
+    uint32_t result_type = rgsl_spirv_type(e, expr->type, 0);
+    if (function->ops[0] == RGSL_OP_IMAGE_QUERY_SIZE_LOD || function->ops[0] == RGSL_OP_IMAGE_FETCH) {
+        uint32_t image = rgsl_spirv_op1(e, RGSL_OP_IMAGE, rgsl_spirv_image_type(e, sampler), arguments[0]);
+        if (function->ops[0] == RGSL_OP_IMAGE_QUERY_SIZE_LOD) {
+            e->needs |= RGSL_NEEDS_IMAGE_QUERY;
+            return rgsl_spirv_op2(e, RGSL_OP_IMAGE_QUERY_SIZE_LOD, result_type, image, arguments[1]);
+        }
+        uint32_t result = rgsl_spirv_new_id(e);
+        rgsl_spirv_begin(e, RGSL_OP_IMAGE_FETCH, 6);
+        rgsl_spirv_code_literal(e, result_type);
+        rgsl_spirv_code_literal(e, result);
+        rgsl_spirv_code_id(e, image);
+        rgsl_spirv_code_id(e, arguments[1]);
+        rgsl_spirv_code_literal(e, RGSL_IMAGE_OPERAND_LOD);
+        rgsl_spirv_code_id(e, arguments[2]);
+        return result;
+    }
+    uint32_t operand = function->ops[0];
+    bool explicit_lod = !e->fragment || operand == RGSL_IMAGE_OPERAND_LOD || operand == RGSL_IMAGE_OPERAND_GRAD;
+    uint32_t mask = 0;
+    uint32_t operands[3];
+    uint32_t operand_count = 0;
+    if (operand == 0 && expr->argument_count == 3) {
+        mask |= RGSL_IMAGE_OPERAND_BIAS;
+        operands[operand_count++] = arguments[2];
+    }
+    if (operand == RGSL_IMAGE_OPERAND_LOD) {
+        mask |= RGSL_IMAGE_OPERAND_LOD;
+        operands[operand_count++] = arguments[2];
+    } else if (explicit_lod && operand != RGSL_IMAGE_OPERAND_GRAD) {
+        mask |= RGSL_IMAGE_OPERAND_LOD;
+        operands[operand_count++] = rgsl_spirv_float(e, 0.0f);
+    }
+    if (operand == RGSL_IMAGE_OPERAND_GRAD) {
+        mask |= RGSL_IMAGE_OPERAND_GRAD;
+        operands[operand_count++] = arguments[2];
+        operands[operand_count++] = arguments[3];
+    }
+    if (operand == RGSL_IMAGE_OPERAND_CONST_OFFSET) {
+        // Offsets computed at run time need the extended gathers of desktop GL.
+        bool constant = rgsl_spirv_is_constant(e, arguments[2]);
+        mask |= constant ? RGSL_IMAGE_OPERAND_CONST_OFFSET : RGSL_IMAGE_OPERAND_OFFSET;
+        e->needs |= constant ? 0 : RGSL_NEEDS_IMAGE_GATHER_EXTENDED;
+        operands[operand_count++] = arguments[2];
+    }
+    uint32_t op = explicit_lod ? RGSL_OP_IMAGE_SAMPLE_EXPLICIT_LOD : RGSL_OP_IMAGE_SAMPLE_IMPLICIT_LOD;
+    uint32_t reference = 0;
+    if (sampler->shadow) {
+        // The reference depth is the last component of the coordinate, which keeps it as unused.
+        op = explicit_lod ? RGSL_OP_IMAGE_SAMPLE_DREF_EXPLICIT_LOD : RGSL_OP_IMAGE_SAMPLE_DREF_IMPLICIT_LOD;
+        uint32_t rows = expr->arguments[1]->type->rows;
+        reference = rgsl_spirv_extract(e, rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, 1), arguments[1], rows - 1);
+    }
+    uint32_t result = rgsl_spirv_new_id(e);
+    rgsl_spirv_begin(e, op, 4 + (reference != 0 ? 1 : 0) + (mask != 0 ? 1 + operand_count : 0));
+    rgsl_spirv_code_literal(e, result_type);
+    rgsl_spirv_code_literal(e, result);
+    rgsl_spirv_code_id(e, arguments[0]);
+    rgsl_spirv_code_id(e, arguments[1]);
+    if (reference != 0) {
+        rgsl_spirv_code_id(e, reference);
+    }
+    if (mask != 0) {
+        rgsl_spirv_code_literal(e, mask);
+        for (uint32_t i = 0; i < operand_count; i++) {
+            rgsl_spirv_code_id(e, operands[i]);
+        }
+    }
+    return result;
+}
+
+static uint32_t rgsl_spirv_builtin_call(struct rgsl_spirv_emitter* e, const struct rgsl_expr* expr) {
+    const struct rgsl_spirv_builtin_function* function = (const struct rgsl_spirv_builtin_function *)bsearch(expr->builtin->name, BUILTIN_FUNCTIONS,
+        sizeof(BUILTIN_FUNCTIONS) / sizeof(BUILTIN_FUNCTIONS[0]), sizeof(BUILTIN_FUNCTIONS[0]), rgsl_spirv_compare_builtin_function);
+    const struct rgsl_type* type = expr->type;
+    uint32_t result_type = rgsl_spirv_type(e, type, 0);
+    if (function == NULL) {
+        rgsl_spirv_error(e, expr->line, "%s is not supported by the SPIR-V backend", expr->builtin->name);
+        return rgsl_spirv_undef(e, result_type);
+    }
+    uint32_t arguments[4];
+    uint32_t count = expr->argument_count;
+    for (uint32_t i = 0; i < count; i++) {
+        arguments[i] = rgsl_spirv_expr(e, expr->arguments[i]);
+        const struct rgsl_type* argument = expr->arguments[i]->type;
+        if (function->broadcast && type->kind == RGSL_TYPE_VECTOR && argument->kind == RGSL_TYPE_SCALAR) {
+            arguments[i] = rgsl_spirv_splat(e, arguments[i], argument->scalar, type->rows);
+        }
+    }
+    const struct rgsl_type* first = expr->arguments[0]->type;
+    uint32_t op = function->ops[first->scalar];
+    switch (function->kind) {
+        case RGSL_SPIRV_BUILTIN_EXT:
+            return rgsl_spirv_ext(e, op, result_type, arguments, count);
+        case RGSL_SPIRV_BUILTIN_CORE:
+            return rgsl_spirv_op(e, op, result_type, arguments, count);
+        case RGSL_SPIRV_BUILTIN_TEXTURE:
+            return rgsl_spirv_texture(e, expr, function, arguments);
+        default:
+            break;
+    }
+    if (strcmp(function->name, "atan") == 0) {
+        return rgsl_spirv_ext(e, (count == 2) ? RGSL_GLSL450_ATAN2 : RGSL_GLSL450_ATAN, result_type, arguments, count);
+    }
+    if (strcmp(function->name, "dot") == 0) {
+        return rgsl_spirv_op(e, (first->kind == RGSL_TYPE_SCALAR) ? RGSL_OP_F_MUL : RGSL_OP_DOT, result_type, arguments, 2);
+    }
+    if (strcmp(function->name, "mod") == 0) {
+        return rgsl_spirv_op(e, RGSL_OP_F_MOD, result_type, arguments, 2);
+    }
+    if (strcmp(function->name, "mix") == 0) {
+        if (expr->arguments[2]->type->scalar == RGSL_SCALAR_BOOL) {
+            // mix() with booleans selects y where they are true.
+            return rgsl_spirv_op3(e, RGSL_OP_SELECT, result_type, arguments[2], arguments[1], arguments[0]);
+        }
+        return rgsl_spirv_ext(e, RGSL_GLSL450_F_MIX, result_type, arguments, 3);
+    }
+    // matrixCompMult() multiplies column by column.
+    uint32_t column_type = rgsl_spirv_vector_type(e, RGSL_SCALAR_FLOAT, type->rows);
+    uint32_t columns[4];
+    for (uint32_t i = 0; i < type->columns; i++) {
+        uint32_t a = rgsl_spirv_extract(e, column_type, arguments[0], i);
+        uint32_t b = rgsl_spirv_extract(e, column_type, arguments[1], i);
+        columns[i] = rgsl_spirv_op2(e, RGSL_OP_F_MUL, column_type, a, b);
+    }
+    return rgsl_spirv_construct(e, result_type, columns, type->columns);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Statements                                                                 */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_spirv_statement(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* stmt);
+
+static void rgsl_spirv_statements(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* first) {
+    for (const struct rgsl_stmt* stmt = first; stmt != NULL; stmt = stmt->next) {
+        rgsl_spirv_statement(e, stmt);
+    }
+}
+
+static void rgsl_spirv_declaration(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    if (rgsl_spirv_variable_folded(e, variable)) {
+        return;
+    }
+    struct rgsl_spirv_variable* info = &e->variables[variable->id];
+    const struct rgsl_type* type = variable->type;
+    if (type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) {
+        info->kind = RGSL_SPIRV_VARIABLE_SSA;
+        uint32_t value = (variable->initializer != NULL) ? rgsl_spirv_expr(e, variable->initializer) : rgsl_spirv_undef(e, rgsl_spirv_type(e, type, 0));
+        rgsl_spirv_write_variable(e, variable, e->current, value);
+        return;
+    }
+    uint32_t value = (variable->initializer != NULL) ? rgsl_spirv_expr(e, variable->initializer) : 0;
+    info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+    info->storage = RGSL_SPIRV_STORAGE_FUNCTION;
+    info->layout = 0;
+    info->id = rgsl_spirv_local(e, type);
+    if (value != 0) {
+        rgsl_spirv_store_pointer(e, info->id, value);
+    }
+}
+
+static void rgsl_spirv_push_targets(struct rgsl_spirv_emitter* e, uint32_t break_block, uint32_t continue_block, uint32_t line) {
+    if (e->target_count == sizeof(e->targets) / sizeof(e->targets[0])) {
+        rgsl_spirv_error(e, line, "%s", "loops and switches are nested too deeply for the SPIR-V backend");
+        return;
+    }
+    e->targets[e->target_count].break_block = break_block;
+    e->targets[e->target_count].continue_block = continue_block;
+    e->target_count++;
+}
+
+static void rgsl_spirv_pop_targets(struct rgsl_spirv_emitter* e) {
+    if (e->target_count != 0) {
+        e->target_count--;
+    }
+}
+
+static void rgsl_spirv_if(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* stmt) {
+    if (rgsl_spirv_folded(e, stmt->expr)) {
+        // Branches a constant condition never takes are left out.
+        const struct rgsl_stmt* taken = stmt->expr->value.b ? stmt->body : stmt->else_branch;
+        if (taken != NULL) {
+            rgsl_spirv_statement(e, taken);
+        }
+        return;
+    }
+    uint32_t condition = rgsl_spirv_expr(e, stmt->expr);
+    uint32_t then_block = rgsl_spirv_new_block(e);
+    uint32_t else_block = (stmt->else_branch != NULL) ? rgsl_spirv_new_block(e) : RGSL_SPIRV_NO_BLOCK;
+    uint32_t merge = rgsl_spirv_new_block(e);
+    rgsl_spirv_selection_merge(e, merge);
+    rgsl_spirv_branch_conditional(e, condition, then_block, (else_block != RGSL_SPIRV_NO_BLOCK) ? else_block : merge);
+    rgsl_spirv_seal_block(e, then_block);
+    rgsl_spirv_start_block(e, then_block);
+    rgsl_spirv_statement(e, stmt->body);
+    rgsl_spirv_branch(e, merge);
+    if (else_block != RGSL_SPIRV_NO_BLOCK) {
+        rgsl_spirv_seal_block(e, else_block);
+        rgsl_spirv_start_block(e, else_block);
+        rgsl_spirv_statement(e, stmt->else_branch);
+        rgsl_spirv_branch(e, merge);
+    }
+    rgsl_spirv_start_merge(e, merge);
+}
+
+/**
+ * Emits a loop in the shape SPIR-V requires: a header holding only the loop
+ * merge, the condition, the body, then a continue block stepping the loop and
+ * branching back to the header. Do-while loops test their condition in the
+ * continue block instead.
+ */
+static void rgsl_spirv_loop(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* stmt) {
+    if (stmt->kind == RGSL_STMT_FOR) {
+        rgsl_spirv_statements(e, stmt->init);
+        if (e->current == RGSL_SPIRV_NO_BLOCK) {
+            return;
+        }
+    }
+    bool do_while = stmt->kind == RGSL_STMT_DO_WHILE;
+    uint32_t header = rgsl_spirv_new_block(e);
+    uint32_t body = rgsl_spirv_new_block(e);
+    uint32_t continue_block = rgsl_spirv_new_block(e);
+    uint32_t merge = rgsl_spirv_new_block(e);
+    rgsl_spirv_branch(e, header);
+    rgsl_spirv_start_block(e, header);
+    rgsl_spirv_begin(e, RGSL_OP_LOOP_MERGE, 3);
+    rgsl_spirv_code_literal(e, e->blocks[merge].label);
+    rgsl_spirv_code_literal(e, e->blocks[continue_block].label);
+    rgsl_spirv_code_literal(e, 0);
+    if (do_while || stmt->expr == NULL) {
+        rgsl_spirv_branch(e, body);
+    } else {
+        uint32_t condition_block = rgsl_spirv_new_block(e);
+        rgsl_spirv_branch(e, condition_block);
+        rgsl_spirv_seal_block(e, condition_block);
+        rgsl_spirv_start_block(e, condition_block);
+        uint32_t condition = rgsl_spirv_expr(e, stmt->expr);
+        rgsl_spirv_branch_conditional(e, condition, body, merge);
+    }
+    rgsl_spirv_seal_block(e, body);
+    rgsl_spirv_start_block(e, body);
+    rgsl_spirv_push_targets(e, merge, continue_block, stmt->line);
+    rgsl_spirv_statement(e, stmt->body);
+    rgsl_spirv_pop_targets(e);
+    rgsl_spirv_branch(e, continue_block);
+    rgsl_spirv_seal_block(e, continue_block);
+    rgsl_spirv_start_block(e, continue_block);
+    if (e->blocks[continue_block].predecessors.count == 0) {
+        // The body never reaches the end of an iteration, but the continue block is still the back edge.
+        rgsl_spirv_branch(e, header);
+    } else if (do_while) {
+        uint32_t condition = rgsl_spirv_expr(e, stmt->expr);
+        rgsl_spirv_branch_conditional(e, condition, header, merge);
+    } else {
+        if (stmt->step != NULL) {
+            rgsl_spirv_expr(e, stmt->step);
+        }
+        rgsl_spirv_branch(e, header);
+    }
+    rgsl_spirv_seal_block(e, header);
+    rgsl_spirv_start_merge(e, merge);
+}
+
+/**
+ * Emits a switch, the labels following each other sharing a block. Blocks
+ * falling through must be listed right before the block they fall into, so
+ * the cases are listed in the order of their blocks, starting after the
+ * default, which OpSwitch lists first.
+ */
+static void rgsl_spirv_switch(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* stmt) {
+    uint32_t selector = rgsl_spirv_expr(e, stmt->expr);
+    const struct rgsl_stmt* children = stmt->body->body;
+    uint32_t label_count = 0;
+    for (const struct rgsl_stmt* child = children; child != NULL; child = child->next) {
+        label_count += (child->kind == RGSL_STMT_CASE || child->kind == RGSL_STMT_DEFAULT) ? 1 : 0;
+    }
+    if (label_count == 0) {
+        return;
+    }
+    uint32_t merge = rgsl_spirv_new_block(e);
+    uint32_t* values = (uint32_t *)rgsl_malloc(label_count * sizeof(uint32_t));
+    uint32_t* targets = (uint32_t *)rgsl_malloc(label_count * sizeof(uint32_t));
+    uint32_t case_count = 0;
+    uint32_t default_block = merge;
+    uint32_t group = RGSL_SPIRV_NO_BLOCK;
+    bool after_label = false;
+    for (const struct rgsl_stmt* child = children; child != NULL; child = child->next) {
+        bool label = child->kind == RGSL_STMT_CASE || child->kind == RGSL_STMT_DEFAULT;
+        if (label && !after_label) {
+            group = rgsl_spirv_new_block(e);
+        }
+        after_label = label;
+        if (child->kind == RGSL_STMT_DEFAULT) {
+            default_block = group;
+        } else if (child->kind == RGSL_STMT_CASE) {
+            values[case_count] = child->expr->value.u;
+            targets[case_count++] = group;
+        }
+    }
+    // Blocks are numbered in order, so the cases are rotated to follow the default.
+    uint32_t first = 0;
+    while (first < case_count && default_block != merge && targets[first] <= default_block) {
+        first++;
+    }
+    rgsl_spirv_selection_merge(e, merge);
+    rgsl_spirv_begin(e, RGSL_OP_SWITCH, 2 + case_count * 2);
+    rgsl_spirv_code_id(e, selector);
+    rgsl_spirv_code_literal(e, e->blocks[default_block].label);
+    for (uint32_t i = 0; i < case_count; i++) {
+        uint32_t k = (first + i) % case_count;
+        rgsl_spirv_code_literal(e, values[k]);
+        rgsl_spirv_code_literal(e, e->blocks[targets[k]].label);
+        rgsl_spirv_add_predecessor(e, targets[k], e->current);
+    }
+    rgsl_spirv_add_predecessor(e, default_block, e->current);
+    e->current = RGSL_SPIRV_NO_BLOCK;
+    uint32_t outer_continue = (e->target_count != 0) ? e->targets[e->target_count - 1].continue_block : RGSL_SPIRV_NO_BLOCK;
+    rgsl_spirv_push_targets(e, merge, outer_continue, stmt->line);
+    uint32_t next = merge + 1;
+    after_label = false;
+    for (const struct rgsl_stmt* child = children; child != NULL; child = child->next) {
+        bool label = child->kind == RGSL_STMT_CASE || child->kind == RGSL_STMT_DEFAULT;
+        if (label && !after_label) {
+            // Falling through from the previous case.
+            rgsl_spirv_branch(e, next);
+            rgsl_spirv_seal_block(e, next);
+            rgsl_spirv_start_block(e, next);
+            next++;
+        }
+        after_label = label;
+        if (!label) {
+            rgsl_spirv_statement(e, child);
+        }
+    }
+    rgsl_spirv_pop_targets(e);
+    rgsl_spirv_branch(e, merge);
+    rgsl_spirv_start_merge(e, merge);
+    rgsl_free(targets);
+    rgsl_free(values);
+}
+
+static void rgsl_spirv_statement(struct rgsl_spirv_emitter* e, const struct rgsl_stmt* stmt) {
+    // Code after a jump is unreachable, and left out.
+    if (e->current == RGSL_SPIRV_NO_BLOCK || e->failed) {
+        return;
+    }
+    switch (stmt->kind) {
+        case RGSL_STMT_BLOCK:
+            rgsl_spirv_statements(e, stmt->body);
+            break;
+        case RGSL_STMT_DECLARATION:
+            rgsl_spirv_declaration(e, stmt->variable);
+            break;
+        case RGSL_STMT_EXPRESSION:
+            rgsl_spirv_expr(e, stmt->expr);
+            break;
+        case RGSL_STMT_IF:
+            rgsl_spirv_if(e, stmt);
+            break;
+        case RGSL_STMT_FOR:
+        case RGSL_STMT_WHILE:
+        case RGSL_STMT_DO_WHILE:
+            rgsl_spirv_loop(e, stmt);
+            break;
+        case RGSL_STMT_SWITCH:
+            rgsl_spirv_switch(e, stmt);
+            break;
+        case RGSL_STMT_BREAK:
+        case RGSL_STMT_CONTINUE:
+            if (e->target_count != 0) {
+                const struct rgsl_spirv_jump_targets* targets = &e->targets[e->target_count - 1];
+                rgsl_spirv_branch(e, (stmt->kind == RGSL_STMT_BREAK) ? targets->break_block : targets->continue_block);
+            }
+            break;
+        case RGSL_STMT_RETURN:
+            if (stmt->expr != NULL) {
+                rgsl_spirv_terminate(e, RGSL_OP_RETURN_VALUE, rgsl_spirv_expr(e, stmt->expr));
+            } else {
+                rgsl_spirv_terminate(e, RGSL_OP_RETURN, 0);
+            }
+            break;
+        case RGSL_STMT_DISCARD:
+            rgsl_spirv_terminate(e, RGSL_OP_KILL, 0);
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Functions                                                                  */
+/* -------------------------------------------------------------------------- */
+
+static void rgsl_spirv_initialize_globals(struct rgsl_spirv_emitter* e);
+
+// Appends the code of a block, the uses of trivial phis replaced by their values.
+static void rgsl_spirv_write_block(struct rgsl_spirv_emitter* e, const struct rgsl_spirv_block* block, bool entry) {
+    struct rgsl_spirv_words* output = &e->functions;
+    uint32_t label[1] = {block->label};
+    rgsl_spirv_instruction(output, RGSL_OP_LABEL, label, 1);
+    if (entry && e->local_variables.count != 0) {
+        rgsl_spirv_push_words(output, e->local_variables.data, e->local_variables.count);
+    }
+    for (uint32_t index = block->first_phi; index != UINT32_MAX; index = e->phis[index].next) {
+        const struct rgsl_spirv_phi* phi = &e->phis[index];
+        if (phi->replacement != 0) {
+            continue;
+        }
+        rgsl_spirv_push(output, (uint32_t)((3 + phi->operands.count * 2) << 16) | RGSL_OP_PHI);
+        rgsl_spirv_push(output, phi->type);
+        rgsl_spirv_push(output, phi->id);
+        for (size_t i = 0; i < phi->operands.count; i++) {
+            rgsl_spirv_push(output, rgsl_spirv_resolve(e, phi->operands.data[i]));
+            rgsl_spirv_push(output, e->blocks[block->predecessors.data[i]].label);
+        }
+    }
+    size_t start = output->count;
+    if (block->code.count != 0) {
+        rgsl_spirv_push_words(output, block->code.data, block->code.count);
+    }
+    for (size_t i = 0; i < block->fixups.count; i++) {
+        uint32_t* word = &output->data[start + block->fixups.data[i]];
+        *word = rgsl_spirv_resolve(e, *word);
+    }
+}
+
+static void rgsl_spirv_function(struct rgsl_spirv_emitter* e, const struct rgsl_function* function) {
+    for (size_t i = 0; i < e->function_block_count; i++) {
+        rgsl_spirv_words_free(&e->blocks[i].code);
+        rgsl_spirv_words_free(&e->blocks[i].fixups);
+        rgsl_spirv_words_free(&e->blocks[i].predecessors);
+        rgsl_spirv_words_free(&e->blocks[i].incomplete);
+    }
+    for (size_t i = 0; i < e->phi_count; i++) {
+        rgsl_spirv_words_free(&e->phis[i].operands);
+    }
+    e->function_block_count = 0;
+    e->phi_count = 0;
+    e->order.count = 0;
+    e->local_variables.count = 0;
+    e->target_count = 0;
+    e->definition_count = 0;
+    if (e->definitions != NULL) {
+        memset(e->definitions, 0, e->definition_capacity * sizeof(struct rgsl_spirv_definition));
+    }
+    e->function = function;
+
+    uint32_t entry = rgsl_spirv_new_block(e);
+    rgsl_spirv_seal_block(e, entry);
+    rgsl_spirv_start_block(e, entry);
+    uint32_t count = function->parameter_count;
+    uint32_t* parameters = (uint32_t *)rgsl_malloc((count + 1) * 2 * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        const struct rgsl_variable* parameter = function->parameters[i];
+        struct rgsl_spirv_variable* info = &e->variables[parameter->id];
+        const struct rgsl_type* type = parameter->type;
+        uint32_t id = rgsl_spirv_new_id(e);
+        parameters[i * 2] = rgsl_spirv_type(e, type, 0);
+        parameters[i * 2 + 1] = id;
+        rgsl_spirv_name(e, id, parameter->name);
+        if (parameter->direction != RGSL_DIRECTION_IN) {
+            parameters[i * 2] = rgsl_spirv_pointer_type(e, RGSL_SPIRV_STORAGE_FUNCTION, parameters[i * 2]);
+            info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+            info->storage = RGSL_SPIRV_STORAGE_FUNCTION;
+            info->id = id;
+        } else if (type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) {
+            info->kind = RGSL_SPIRV_VARIABLE_SSA;
+            rgsl_spirv_write_variable(e, parameter, entry, id);
+        } else if (type->kind == RGSL_TYPE_SAMPLER) {
+            info->kind = RGSL_SPIRV_VARIABLE_VALUE;
+            info->id = id;
+        } else {
+            // Parameters are writable copies, kept in memory like local aggregates.
+            info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+            info->storage = RGSL_SPIRV_STORAGE_FUNCTION;
+            info->id = rgsl_spirv_local(e, type);
+            rgsl_spirv_store_pointer(e, info->id, id);
+        }
+        info->layout = 0;
+    }
+    const struct rgsl_function* entry_point = e->module->entry_point;
+    if (entry_point != NULL && (function == entry_point || function == entry_point->definition)) {
+        rgsl_spirv_initialize_globals(e);
+    }
+    rgsl_spirv_statements(e, function->body->body);
+    if (e->current != RGSL_SPIRV_NO_BLOCK) {
+        // Flowing off the end of a function returning a value leaves it undefined.
+        uint32_t result = (function->return_type->kind == RGSL_TYPE_VOID) ? 0 : rgsl_spirv_undef(e, rgsl_spirv_type(e, function->return_type, 0));
+        rgsl_spirv_terminate(e, (result != 0) ? RGSL_OP_RETURN_VALUE : RGSL_OP_RETURN, result);
+    }
+    rgsl_spirv_remove_trivial_phis(e);
+
+    uint32_t result_type = rgsl_spirv_type(e, function->return_type, 0);
+    uint32_t* types = (uint32_t *)rgsl_malloc((count + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < count; i++) {
+        types[i] = parameters[i * 2];
+    }
+    uint32_t header[4] = {result_type, e->function_ids[function->id], 0, rgsl_spirv_function_type(e, result_type, types, count)};
+    rgsl_free(types);
+    rgsl_spirv_name(e, header[1], function->name);
+    rgsl_spirv_instruction(&e->functions, RGSL_OP_FUNCTION, header, 4);
+    for (uint32_t i = 0; i < count; i++) {
+        rgsl_spirv_instruction(&e->functions, RGSL_OP_FUNCTION_PARAMETER, &parameters[i * 2], 2);
+    }
+    rgsl_free(parameters);
+    for (size_t i = 0; i < e->order.count; i++) {
+        rgsl_spirv_write_block(e, &e->blocks[e->order.data[i]], i == 0);
+    }
+    rgsl_spirv_push(&e->functions, (1u << 16) | RGSL_OP_FUNCTION_END);
+}
+
+/* -------------------------------------------------------------------------- */
+/* Interface                                                                  */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Enumeration of the kinds of slots the interface is assigned, each from its
+ * own range: locations of inputs, outputs and uniforms, bindings of samplers,
+ * uniform blocks and buffer blocks.
+ */
+enum rgsl_spirv_slot_kind {
+    RGSL_SPIRV_SLOT_INPUT,
+    RGSL_SPIRV_SLOT_OUTPUT,
+    RGSL_SPIRV_SLOT_UNIFORM,
+    RGSL_SPIRV_SLOT_SAMPLER,
+    RGSL_SPIRV_SLOT_UNIFORM_BLOCK,
+    RGSL_SPIRV_SLOT_BUFFER_BLOCK,
+    RGSL_SPIRV_SLOT_KIND_COUNT
+};
+
+typedef uint32_t rgsl_spirv_slots[RGSL_SPIRV_SLOT_KIND_COUNT][RGSL_SPIRV_MAX_SLOTS / 32];
+
+// Locations taken by an input or output, a matrix taking one per column.
+static uint32_t rgsl_spirv_location_count(const struct rgsl_type* type) {
+    switch (type->kind) {
+        case RGSL_TYPE_ARRAY:
+            return type->array_size * rgsl_spirv_location_count(type->element);
+        case RGSL_TYPE_MATRIX:
+            return type->columns;
+        case RGSL_TYPE_STRUCT: {
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < type->structure->field_count; i++) {
+                count += rgsl_spirv_location_count(type->structure->fields[i].type);
+            }
+            return count;
+        }
+        default:
+            return 1;
+    }
+}
+
+// Locations taken by a uniform, one per element of arrays and member of structures.
+static uint32_t rgsl_spirv_uniform_location_count(const struct rgsl_type* type) {
+    switch (type->kind) {
+        case RGSL_TYPE_ARRAY:
+            return type->array_size * rgsl_spirv_uniform_location_count(type->element);
+        case RGSL_TYPE_STRUCT: {
+            uint32_t count = 0;
+            for (uint32_t i = 0; i < type->structure->field_count; i++) {
+                count += rgsl_spirv_uniform_location_count(type->structure->fields[i].type);
+            }
+            return count;
+        }
+        default:
+            return 1;
+    }
+}
+
+// Tells whether a range of slots is free, marking it taken if so.
+static bool rgsl_spirv_take_slots(uint32_t* slots, int32_t first, uint32_t count) {
+    if (first < 0 || (uint32_t)first + count > RGSL_SPIRV_MAX_SLOTS) {
+        return false;
+    }
+    for (uint32_t i = (uint32_t)first; i < (uint32_t)first + count; i++) {
+        if (slots[i / 32] & (1u << (i % 32))) {
+            return false;
+        }
+    }
+    for (uint32_t i = (uint32_t)first; i < (uint32_t)first + count; i++) {
+        slots[i / 32] |= 1u << (i % 32);
+    }
+    return true;
+}
+
+// First free range of slots, -1 if none is left.
+static int32_t rgsl_spirv_first_free_slots(uint32_t* slots, uint32_t count) {
+    for (int32_t first = 0; (uint32_t)first + count <= RGSL_SPIRV_MAX_SLOTS; first++) {
+        if (rgsl_spirv_take_slots(slots, first, count)) {
+            return first;
+        }
+    }
+    return -1;
+}
+
+/**
+ * Slot of the interface a variable needs, or a block through the variable
+ * keying it: the kind of slot, its count and the explicit slot if any.
+ */
+struct rgsl_spirv_slot_request {
+    const struct rgsl_variable* key;
+    const char* name;
+    const struct rgsl_global* global;
+    enum rgsl_spirv_slot_kind kind;
+    uint32_t count;
+    int32_t explicit_slot;
+    bool binding;
+    bool by_name;
+    uint32_t order;
+};
+
+// Variable holding the location and binding of a block: its instance, or its first member.
+static const struct rgsl_variable* rgsl_spirv_block_key(const struct rgsl_block* block) {
+    if (block->instance != NULL) {
+        return block->instance;
+    }
+    return (block->members.field_count != 0) ? block->member_variables[0] : NULL;
+}
+
+// Lists the slots the globals of a module need, at most two per global.
+static uint32_t rgsl_spirv_slot_requests(const struct rgsl_global* global, struct rgsl_spirv_slot_request* requests) {
+    if (global->kind == RGSL_GLOBAL_BLOCK) {
+        const struct rgsl_block* block = global->block;
+        requests[0].key = rgsl_spirv_block_key(block);
+        requests[0].name = block->members.name;
+        requests[0].kind = (block->storage == RGSL_STORAGE_BUFFER) ? RGSL_SPIRV_SLOT_BUFFER_BLOCK : RGSL_SPIRV_SLOT_UNIFORM_BLOCK;
+        requests[0].count = 1;
+        if (block->instance != NULL) {
+            rgsl_spirv_array_element(block->instance->type, &requests[0].count);
+            requests[0].count = (requests[0].count != 0) ? requests[0].count : 1;
+        }
+        requests[0].explicit_slot = block->layout.binding;
+        requests[0].binding = true;
+        return (requests[0].key != NULL) ? 1 : 0;
+    }
+    if (global->kind != RGSL_GLOBAL_VARIABLE) {
+        return 0;
+    }
+    const struct rgsl_variable* variable = global->variable;
+    if (variable->block != NULL) {
+        return 0;
+    }
+    requests[0].key = variable;
+    requests[0].name = variable->name;
+    requests[0].explicit_slot = variable->layout.location;
+    requests[0].binding = false;
+    switch (variable->storage) {
+        case RGSL_STORAGE_IN:
+        case RGSL_STORAGE_OUT:
+            requests[0].kind = (variable->storage == RGSL_STORAGE_IN) ? RGSL_SPIRV_SLOT_INPUT : RGSL_SPIRV_SLOT_OUTPUT;
+            requests[0].count = rgsl_spirv_location_count(variable->type);
+            return 1;
+        case RGSL_STORAGE_UNIFORM:
+            requests[0].kind = RGSL_SPIRV_SLOT_UNIFORM;
+            requests[0].count = rgsl_spirv_uniform_location_count(variable->type);
+            if (!rgsl_type_is_opaque(variable->type)) {
+                return 1;
+            }
+            requests[1].key = variable;
+            requests[1].name = variable->name;
+            requests[1].kind = RGSL_SPIRV_SLOT_SAMPLER;
+            rgsl_spirv_array_element(variable->type, &requests[1].count);
+            requests[1].count = (requests[1].count != 0) ? requests[1].count : 1;
+            requests[1].explicit_slot = variable->layout.binding;
+            requests[1].binding = true;
+            return 2;
+        default:
+            return 0;
+    }
+}
+
+// Orders the automatic slots: by name where other stages must agree, in declaration order elsewhere.
+static int rgsl_spirv_compare_slot_requests(const void* a, const void* b) {
+    const struct rgsl_spirv_slot_request* left = (const struct rgsl_spirv_slot_request *)a;
+    const struct rgsl_spirv_slot_request* right = (const struct rgsl_spirv_slot_request *)b;
+    if (left->by_name && right->by_name) {
+        int order = strcmp(left->name, right->name);
+        if (order != 0) {
+            return order;
+        }
+    }
+    return (left->order > right->order) - (left->order < right->order);
+}
+
+/**
+ * Assigns the locations and bindings of the interface, indexed by variable ID:
+ * explicit slots are taken first, then the others get the first free ones.
+ * The slots seen by another stage or by the whole program, varyings, uniforms
+ * and bindings, go in name order, so that the stages declaring the same
+ * interface agree without a layout qualifier; the vertex inputs and fragment
+ * outputs, seen by the application, go in declaration order. Slots used twice
+ * or running out are reported.
+ */
+static bool rgsl_spirv_assign_interface(struct rgsl_module* module, struct rgsl_spirv_interface* interface) {
+    interface->locations = (int32_t *)rgsl_malloc((module->variable_count + 1) * sizeof(int32_t));
+    interface->bindings = (int32_t *)rgsl_malloc((module->variable_count + 1) * sizeof(int32_t));
+    for (uint32_t i = 0; i <= module->variable_count; i++) {
+        interface->locations[i] = interface->bindings[i] = -1;
+    }
+    static const char* const SLOT_NAMES[] = {"input location", "output location", "uniform location", "sampler binding", "uniform block binding", "buffer binding"};
+    bool vertex = strcmp(module->stage, "vert") == 0;
+    bool fragment = strcmp(module->stage, "frag") == 0;
+    rgsl_spirv_slots slots;
+    memset(slots, 0, sizeof(slots));
+    struct rgsl_spirv_slot_request* automatic = NULL;
+    uint32_t automatic_count = 0;
+    uint32_t automatic_capacity = 0;
+    bool success = true;
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        struct rgsl_spirv_slot_request requests[2];
+        uint32_t count = rgsl_spirv_slot_requests(global, requests);
+        for (uint32_t i = 0; i < count; i++) {
+            struct rgsl_spirv_slot_request* request = &requests[i];
+            if (request->explicit_slot >= 0) {
+                if (!rgsl_spirv_take_slots(slots[request->kind], request->explicit_slot, request->count)) {
+                    rgsl_module_error(module, global->line, "%s overlaps another %s", request->name, SLOT_NAMES[request->kind]);
+                    success = false;
+                }
+                (request->binding ? interface->bindings : interface->locations)[request->key->id] = request->explicit_slot;
+                continue;
+            }
+            if (automatic_count == automatic_capacity) {
+                automatic_capacity = (automatic_capacity != 0) ? automatic_capacity * 2 : 16;
+                automatic = (struct rgsl_spirv_slot_request *)rgsl_realloc(automatic, automatic_capacity * sizeof(struct rgsl_spirv_slot_request));
+            }
+            request->global = global;
+            request->by_name = !(vertex && request->kind == RGSL_SPIRV_SLOT_INPUT) && !(fragment && request->kind == RGSL_SPIRV_SLOT_OUTPUT);
+            request->order = automatic_count;
+            automatic[automatic_count++] = *request;
+        }
+    }
+    if (automatic_count != 0) {
+        qsort(automatic, automatic_count, sizeof(struct rgsl_spirv_slot_request), rgsl_spirv_compare_slot_requests);
+    }
+    for (uint32_t i = 0; i < automatic_count; i++) {
+        const struct rgsl_spirv_slot_request* request = &automatic[i];
+        int32_t slot = rgsl_spirv_first_free_slots(slots[request->kind], request->count);
+        if (slot < 0) {
+            rgsl_module_error(module, request->global->line, "no %s is left for %s", SLOT_NAMES[request->kind], request->name);
+            success = false;
+        }
+        (request->binding ? interface->bindings : interface->locations)[request->key->id] = slot;
+    }
+    rgsl_free(automatic);
+    return success;
+}
+
+static void rgsl_spirv_interface_free(struct rgsl_spirv_interface* interface) {
+    rgsl_free(interface->locations);
+    rgsl_free(interface->bindings);
+    interface->locations = interface->bindings = NULL;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Globals                                                                    */
+/* -------------------------------------------------------------------------- */
+
+// Stores the initializers of the private globals, at the start of the entry point.
+static void rgsl_spirv_initialize_globals(struct rgsl_spirv_emitter* e) {
+    for (const struct rgsl_global* global = e->module->globals; global != NULL; global = global->next) {
+        if (global->kind != RGSL_GLOBAL_VARIABLE || global->variable->initializer == NULL) {
+            continue;
+        }
+        const struct rgsl_variable* variable = global->variable;
+        const struct rgsl_spirv_variable* info = &e->variables[variable->id];
+        if (variable->storage == RGSL_STORAGE_GLOBAL && info->kind == RGSL_SPIRV_VARIABLE_MEMORY) {
+            rgsl_spirv_store_pointer(e, info->id, rgsl_spirv_expr(e, variable->initializer));
+        }
+    }
+}
+
+static uint32_t rgsl_spirv_global_variable(struct rgsl_spirv_emitter* e, uint32_t type, uint32_t storage, const char* name) {
+    uint32_t operands[3] = {rgsl_spirv_pointer_type(e, storage, type), rgsl_spirv_new_id(e), storage};
+    rgsl_spirv_instruction(&e->globals, RGSL_OP_VARIABLE, operands, 3);
+    rgsl_spirv_name(e, operands[1], name);
+    return operands[1];
+}
+
+// Declares a uniform or buffer block, and the members of anonymous ones.
+static void rgsl_spirv_declare_block(struct rgsl_spirv_emitter* e, const struct rgsl_block* block) {
+    uint8_t layout = (uint8_t)(block->layout.packing + 1);
+    const struct rgsl_variable* key = rgsl_spirv_block_key(block);
+    if (key == NULL) {
+        return;
+    }
+    uint32_t type = (block->instance != NULL) ? rgsl_spirv_type(e, block->instance->type, layout) : rgsl_spirv_struct_type(e, &block->members, layout);
+    uint32_t id = rgsl_spirv_global_variable(e, type, RGSL_SPIRV_STORAGE_UNIFORM, (block->instance != NULL) ? block->instance->name : NULL);
+    rgsl_spirv_decorate(e, id, RGSL_DECORATION_BINDING, e->interface.bindings[key->id]);
+    if (block->memory & RGSL_MEMORY_RESTRICT) {
+        rgsl_spirv_decorate(e, id, RGSL_DECORATION_RESTRICT, -1);
+    }
+    if (block->instance != NULL) {
+        struct rgsl_spirv_variable* info = &e->variables[block->instance->id];
+        info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+        info->id = id;
+        info->storage = RGSL_SPIRV_STORAGE_UNIFORM;
+        info->layout = layout;
+        return;
+    }
+    for (uint32_t i = 0; i < block->members.field_count; i++) {
+        struct rgsl_spirv_variable* info = &e->variables[block->member_variables[i]->id];
+        info->kind = RGSL_SPIRV_VARIABLE_MEMBER;
+        info->id = id;
+        info->storage = RGSL_SPIRV_STORAGE_UNIFORM;
+        info->layout = layout;
+    }
+}
+
+// Declares a specialization constant, its default being the value of its initializer.
+static void rgsl_spirv_declare_spec_constant(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    struct rgsl_spirv_variable* info = &e->variables[variable->id];
+    const struct rgsl_expr* initializer = variable->initializer;
+    if (initializer == NULL || !rgsl_spirv_folded(e, initializer)) {
+        rgsl_spirv_error(e, variable->line, "the default of the specialization constant %s is not a constant the SPIR-V backend can compute", variable->name);
+        return;
+    }
+    enum rgsl_scalar_kind scalar = variable->type->scalar;
+    uint32_t operands[3] = {rgsl_spirv_vector_type(e, scalar, 1), rgsl_spirv_new_id(e), initializer->value.u};
+    if (scalar == RGSL_SCALAR_BOOL) {
+        rgsl_spirv_instruction(&e->globals, initializer->value.b ? RGSL_OP_SPEC_CONSTANT_TRUE : RGSL_OP_SPEC_CONSTANT_FALSE, operands, 2);
+    } else {
+        rgsl_spirv_instruction(&e->globals, RGSL_OP_SPEC_CONSTANT, operands, 3);
+    }
+    rgsl_spirv_decorate(e, operands[1], RGSL_DECORATION_SPEC_ID, variable->layout.constant_id);
+    rgsl_spirv_name(e, operands[1], variable->name);
+    info->kind = RGSL_SPIRV_VARIABLE_VALUE;
+    info->id = operands[1];
+}
+
+static void rgsl_spirv_declare_global(struct rgsl_spirv_emitter* e, const struct rgsl_variable* variable) {
+    struct rgsl_spirv_variable* info = &e->variables[variable->id];
+    if (variable->block != NULL || rgsl_spirv_variable_folded(e, variable)) {
+        return;
+    }
+    if (variable->storage == RGSL_STORAGE_GLOBAL && e->spec_constants && variable->layout.constant_id >= 0) {
+        rgsl_spirv_declare_spec_constant(e, variable);
+        return;
+    }
+    static const uint32_t STORAGE_CLASSES[] = {
+        RGSL_SPIRV_STORAGE_FUNCTION, RGSL_SPIRV_STORAGE_PRIVATE, RGSL_SPIRV_STORAGE_FUNCTION, RGSL_SPIRV_STORAGE_INPUT,
+        RGSL_SPIRV_STORAGE_OUTPUT, RGSL_SPIRV_STORAGE_UNIFORM_CONSTANT, RGSL_SPIRV_STORAGE_UNIFORM, RGSL_SPIRV_STORAGE_INPUT
+    };
+    info->kind = RGSL_SPIRV_VARIABLE_MEMORY;
+    info->storage = STORAGE_CLASSES[variable->storage];
+    info->layout = 0;
+    info->id = rgsl_spirv_global_variable(e, rgsl_spirv_type(e, variable->type, 0), info->storage, variable->name);
+    switch (variable->storage) {
+        case RGSL_STORAGE_IN:
+        case RGSL_STORAGE_OUT:
+            rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_LOCATION, e->interface.locations[variable->id]);
+            if (variable->interpolation == RGSL_INTERPOLATION_FLAT) {
+                rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_FLAT, -1);
+            } else if (variable->interpolation == RGSL_INTERPOLATION_NOPERSPECTIVE) {
+                rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_NO_PERSPECTIVE, -1);
+            }
+            rgsl_spirv_push(&e->interface_ids, info->id);
+            break;
+        case RGSL_STORAGE_UNIFORM:
+            rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_LOCATION, e->interface.locations[variable->id]);
+            if (e->interface.bindings[variable->id] >= 0) {
+                rgsl_spirv_decorate(e, info->id, RGSL_DECORATION_BINDING, e->interface.bindings[variable->id]);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Module                                                                     */
+/* -------------------------------------------------------------------------- */
+
+// Execution models of the stages, in the order of the stage names.
+static const char* const STAGE_NAMES[] = {"vert", "frag", "comp"};
+static const uint32_t EXECUTION_MODELS[] = {RGSL_EXECUTION_MODEL_VERTEX, RGSL_EXECUTION_MODEL_FRAGMENT, RGSL_EXECUTION_MODEL_GL_COMPUTE};
+
+static uint32_t rgsl_spirv_execution_model(const char* stage) {
+    for (size_t i = 0; i < sizeof(STAGE_NAMES) / sizeof(STAGE_NAMES[0]); i++) {
+        if (strcmp(stage, STAGE_NAMES[i]) == 0) {
+            return EXECUTION_MODELS[i];
+        }
+    }
+    return RGSL_EXECUTION_MODEL_VERTEX;
+}
+
+// Lays out the module: header, capabilities, imports, entry point and modes, then the sections.
+static void rgsl_spirv_assemble(struct rgsl_spirv_emitter* e, struct rgsl_spirv_words* output) {
+    const struct rgsl_function* entry_point = e->module->entry_point;
+    uint32_t main_id = e->function_ids[entry_point->id];
+    uint32_t header[RGSL_SPIRV_HEADER_WORDS] = {RGSL_SPIRV_MAGIC, RGSL_SPIRV_VERSION, 0, e->bound, 0};
+    rgsl_spirv_push_words(output, header, RGSL_SPIRV_HEADER_WORDS);
+    for (size_t i = 0; i < sizeof(CAPABILITIES) / sizeof(CAPABILITIES[0]); i++) {
+        if (e->needs & (1u << i)) {
+            uint32_t capability = CAPABILITIES[i].capability;
+            rgsl_spirv_instruction(output, RGSL_OP_CAPABILITY, &capability, 1);
+        }
+    }
+    for (size_t i = 0; i < sizeof(CAPABILITIES) / sizeof(CAPABILITIES[0]); i++) {
+        if ((e->needs & (1u << i)) && CAPABILITIES[i].extension != NULL) {
+            rgsl_spirv_push(output, (uint32_t)((1 + rgsl_spirv_string_words(CAPABILITIES[i].extension)) << 16) | RGSL_OP_EXTENSION);
+            rgsl_spirv_push_string(output, CAPABILITIES[i].extension);
+        }
+    }
+    rgsl_spirv_push(output, (uint32_t)((2 + rgsl_spirv_string_words("GLSL.std.450")) << 16) | RGSL_OP_EXT_INST_IMPORT);
+    rgsl_spirv_push(output, e->glsl450);
+    rgsl_spirv_push_string(output, "GLSL.std.450");
+    uint32_t memory_model[2] = {RGSL_ADDRESSING_MODEL_LOGICAL, RGSL_MEMORY_MODEL_GLSL450};
+    rgsl_spirv_instruction(output, RGSL_OP_MEMORY_MODEL, memory_model, 2);
+
+    rgsl_spirv_push(output, (uint32_t)((3 + rgsl_spirv_string_words("main") + e->interface_ids.count) << 16) | RGSL_OP_ENTRY_POINT);
+    rgsl_spirv_push(output, rgsl_spirv_execution_model(e->module->stage));
+    rgsl_spirv_push(output, main_id);
+    rgsl_spirv_push_string(output, "main");
+    if (e->interface_ids.count != 0) {
+        rgsl_spirv_push_words(output, e->interface_ids.data, e->interface_ids.count);
+    }
+    if (e->fragment) {
+        uint32_t mode[2] = {main_id, RGSL_EXECUTION_MODE_ORIGIN_LOWER_LEFT};
+        rgsl_spirv_instruction(output, RGSL_OP_EXECUTION_MODE, mode, 2);
+        if (e->depth_replacing) {
+            mode[1] = RGSL_EXECUTION_MODE_DEPTH_REPLACING;
+            rgsl_spirv_instruction(output, RGSL_OP_EXECUTION_MODE, mode, 2);
+        }
+    }
+    if (strcmp(e->module->stage, "comp") == 0) {
+        uint32_t mode[5] = {main_id, RGSL_EXECUTION_MODE_LOCAL_SIZE, e->module->local_size[0], e->module->local_size[1], e->module->local_size[2]};
+        rgsl_spirv_instruction(output, RGSL_OP_EXECUTION_MODE, mode, 5);
+    }
+    struct rgsl_spirv_words* sections[] = {&e->names, &e->annotations, &e->globals, &e->functions};
+    for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+        if (sections[i]->count != 0) {
+            rgsl_spirv_push_words(output, sections[i]->data, sections[i]->count);
+        }
+    }
+}
+
+static void rgsl_spirv_emitter_free(struct rgsl_spirv_emitter* e) {
+    struct rgsl_spirv_words* sections[] = {&e->names, &e->annotations, &e->globals, &e->functions, &e->interface_ids, &e->scratch, &e->keys, &e->order, &e->local_variables};
+    for (size_t i = 0; i < sizeof(sections) / sizeof(sections[0]); i++) {
+        rgsl_spirv_words_free(sections[i]);
+    }
+    for (size_t i = 0; i < e->function_block_count; i++) {
+        rgsl_spirv_words_free(&e->blocks[i].code);
+        rgsl_spirv_words_free(&e->blocks[i].fixups);
+        rgsl_spirv_words_free(&e->blocks[i].predecessors);
+        rgsl_spirv_words_free(&e->blocks[i].incomplete);
+    }
+    for (size_t i = 0; i < e->phi_count; i++) {
+        rgsl_spirv_words_free(&e->phis[i].operands);
+    }
+    rgsl_free(e->blocks);
+    rgsl_free(e->phis);
+    rgsl_free(e->definitions);
+    rgsl_free(e->interned);
+    rgsl_free(e->id_info);
+    rgsl_free(e->variables);
+    rgsl_free(e->function_ids);
+    rgsl_free((void *)e->blocks_of_structs);
+    rgsl_spirv_layouts_free(&e->layouts);
+    rgsl_spirv_interface_free(&e->interface);
+}
+
+bool rgsl_spirv_emit(struct rgsl_module* module, uint32_t** out_words, size_t* out_word_count) {
+    if (module->entry_point == NULL) {
+        rgsl_printf_error("%s: the module has no entry point to emit.\n", module->path);
+        return false;
+    }
+    struct rgsl_spirv_emitter emitter;
+    struct rgsl_spirv_emitter* e = &emitter;
+    memset(e, 0, sizeof(struct rgsl_spirv_emitter));
+    e->module = module;
+    e->spec_constants = rgsl_spec_constants_enabled();
+    e->fragment = strcmp(module->stage, "frag") == 0;
+    e->needs = RGSL_NEEDS_SHADER;
+    // ID 0 is invalid in SPIR-V.
+    e->bound = 1;
+    e->variables = (struct rgsl_spirv_variable *)rgsl_calloc(module->variable_count + 1, sizeof(struct rgsl_spirv_variable));
+    e->function_ids = (uint32_t *)rgsl_calloc(module->function_count + 1, sizeof(uint32_t));
+    e->failed = !rgsl_spirv_assign_interface(module, &e->interface);
+
+    // Structures are decorated as blocks when emitted, so blocks are known first.
+    size_t block_count = 0;
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        block_count += (global->kind == RGSL_GLOBAL_BLOCK) ? 1 : 0;
+    }
+    e->blocks_of_structs = (const struct rgsl_block **)rgsl_malloc((block_count + 1) * sizeof(const struct rgsl_block*));
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        if (global->kind == RGSL_GLOBAL_BLOCK) {
+            e->blocks_of_structs[e->block_count++] = global->block;
+        }
+    }
+    e->glsl450 = rgsl_spirv_new_id(e);
+    for (const struct rgsl_global* global = module->globals; global != NULL && !e->failed; global = global->next) {
+        if (global->kind == RGSL_GLOBAL_BLOCK) {
+            rgsl_spirv_declare_block(e, global->block);
+        } else if (global->kind == RGSL_GLOBAL_VARIABLE) {
+            rgsl_spirv_declare_global(e, global->variable);
+        } else if (global->kind == RGSL_GLOBAL_FUNCTION && global->function->body != NULL) {
+            e->function_ids[global->function->id] = rgsl_spirv_new_id(e);
+        }
+    }
+    for (const struct rgsl_global* global = module->globals; global != NULL && !e->failed; global = global->next) {
+        if (global->kind == RGSL_GLOBAL_FUNCTION && global->function->body != NULL) {
+            rgsl_spirv_function(e, global->function);
+        }
+    }
+    bool success = !e->failed;
+    if (success) {
+        struct rgsl_spirv_words output = {NULL, 0, 0};
+        rgsl_spirv_assemble(e, &output);
+        *out_words = output.data;
+        *out_word_count = output.count;
+    }
+    rgsl_spirv_emitter_free(e);
+    return success;
+}
+
+/* -------------------------------------------------------------------------- */
+/* Interface description                                                      */
+/* -------------------------------------------------------------------------- */
+
+/**
+ * Lines of the description of an interface, sorted once all are written.
+ */
+struct rgsl_spirv_lines {
+    char** data;
+    size_t count;
+    size_t capacity;
+};
+
+static int rgsl_spirv_compare_lines(const void* a, const void* b) {
+    return strcmp(*(const char* const *)a, *(const char* const *)b);
+}
+
+// Appends a line of the description, its type written as in RGSL.
+static void rgsl_spirv_describe_line(struct rgsl_spirv_lines* lines, struct rgsl_text* text, const char* prefix, const struct rgsl_type* type, const char* suffix) {
+    rgsl_text_clear(text);
+    rgsl_text_append(text, prefix, strlen(prefix));
+    if (type != NULL) {
+        rgsl_text_append(text, " ", 1);
+        rgsl_type_write(text, type);
+    }
+    rgsl_text_append(text, suffix, strlen(suffix));
+    if (lines->count == lines->capacity) {
+        lines->capacity = (lines->capacity != 0) ? lines->capacity * 2 : 16;
+        lines->data = (char **)rgsl_realloc(lines->data, lines->capacity * sizeof(char*));
+    }
+    lines->data[lines->count++] = rgsl_strdup(text->data);
+}
+char* rgsl_spirv_describe_interface(struct rgsl_module* module) {
+    struct rgsl_spirv_interface interface;
+    rgsl_spirv_assign_interface(module, &interface);
+    struct rgsl_spirv_layouts layouts = {NULL, 0, 0};
+    struct rgsl_spirv_lines lines = {NULL, 0, 0};
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    char prefix[256];
+    char suffix[64];
+    for (const struct rgsl_global* global = module->globals; global != NULL; global = global->next) {
+        if (global->kind == RGSL_GLOBAL_BLOCK) {
+            const struct rgsl_block* block = global->block;
+            const struct rgsl_variable* key = rgsl_spirv_block_key(block);
+            if (key == NULL) {
+                continue;
+            }
+            const struct rgsl_block_layout* layout = rgsl_spirv_struct_layout(&layouts, &block->members, (enum rgsl_layout_packing)block->layout.packing);
+            const char* kind = (block->storage == RGSL_STORAGE_BUFFER) ? "storage" : "block";
+            snprintf(prefix, sizeof(prefix), "%s %s", kind, block->members.name);
+            snprintf(suffix, sizeof(suffix), " binding=%d size=%u", interface.bindings[key->id], layout->size);
+            rgsl_spirv_describe_line(&lines, &text, prefix, NULL, suffix);
+            for (uint32_t i = 0; i < block->members.field_count; i++) {
+                snprintf(prefix, sizeof(prefix), "%s %s.%s", kind, block->members.name, block->members.fields[i].name);
+                snprintf(suffix, sizeof(suffix), " offset=%u", layout->members[i].offset);
+                rgsl_spirv_describe_line(&lines, &text, prefix, block->members.fields[i].type, suffix);
+            }
+            continue;
+        }
+        if (global->kind != RGSL_GLOBAL_VARIABLE || global->variable->block != NULL) {
+            continue;
+        }
+        const struct rgsl_variable* variable = global->variable;
+        static const char* const STORAGE_NAMES[] = {NULL, NULL, NULL, "in", "out", "uniform", NULL, NULL};
+        const char* storage = STORAGE_NAMES[variable->storage];
+        if (storage == NULL) {
+            continue;
+        }
+        int length = snprintf(suffix, sizeof(suffix), " %s location=%d", variable->name, interface.locations[variable->id]);
+        if (interface.bindings[variable->id] >= 0 && length > 0 && (size_t)length < sizeof(suffix)) {
+            snprintf(suffix + length, sizeof(suffix) - (size_t)length, " binding=%d", interface.bindings[variable->id]);
+        }
+        rgsl_spirv_describe_line(&lines, &text, storage, variable->type, suffix);
+    }
+    if (lines.count != 0) {
+        qsort(lines.data, lines.count, sizeof(char*), rgsl_spirv_compare_lines);
+    }
+    rgsl_text_clear(&text);
+    rgsl_text_printf(&text, "stage %s\n", module->stage);
+    for (size_t i = 0; i < lines.count; i++) {
+        rgsl_text_printf(&text, "%s\n", lines.data[i]);
+        rgsl_free(lines.data[i]);
+    }
+    rgsl_free(lines.data);
+    rgsl_spirv_layouts_free(&layouts);
+    rgsl_spirv_interface_free(&interface);
+    return text.data;
+}
\ No newline at end of file
@@ -0,0 +1,473 @@
+#include <RGSL/rgsl/types.h>
+#include <string.h>
+
+struct rgsl_builtin_type_name {
+    const char* name;
+    enum rgsl_builtin_type id;
+};
+
+// Built-in types, in the order of enum rgsl_builtin_type.
+static const struct rgsl_type BUILTIN_TYPES[RGSL_BUILTIN_TYPE_COUNT] = {
+    {RGSL_TYPE_VOID, "void", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SCALAR, "float", RGSL_SCALAR_FLOAT, 1, 1, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "vec2", RGSL_SCALAR_FLOAT, 1, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "vec3", RGSL_SCALAR_FLOAT, 1, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "vec4", RGSL_SCALAR_FLOAT, 1, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SCALAR, "int", RGSL_SCALAR_INT, 1, 1, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "ivec2", RGSL_SCALAR_INT, 1, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "ivec3", RGSL_SCALAR_INT, 1, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "ivec4", RGSL_SCALAR_INT, 1, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SCALAR, "uint", RGSL_SCALAR_UINT, 1, 1, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "uvec2", RGSL_SCALAR_UINT, 1, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "uvec3", RGSL_SCALAR_UINT, 1, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "uvec4", RGSL_SCALAR_UINT, 1, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SCALAR, "bool", RGSL_SCALAR_BOOL, 1, 1, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "bvec2", RGSL_SCALAR_BOOL, 1, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "bvec3", RGSL_SCALAR_BOOL, 1, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_VECTOR, "bvec4", RGSL_SCALAR_BOOL, 1, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat2", RGSL_SCALAR_FLOAT, 2, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat2x3", RGSL_SCALAR_FLOAT, 2, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat2x4", RGSL_SCALAR_FLOAT, 2, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat3x2", RGSL_SCALAR_FLOAT, 3, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat3", RGSL_SCALAR_FLOAT, 3, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat3x4", RGSL_SCALAR_FLOAT, 3, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat4x2", RGSL_SCALAR_FLOAT, 4, 2, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat4x3", RGSL_SCALAR_FLOAT, 4, 3, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_MATRIX, "mat4", RGSL_SCALAR_FLOAT, 4, 4, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "sampler2D", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "sampler3D", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_3D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "samplerCube", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_CUBE, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "sampler2DArray", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D_ARRAY, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "isampler2D", RGSL_SCALAR_INT, 0, 0, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "isampler3D", RGSL_SCALAR_INT, 0, 0, RGSL_SAMPLER_3D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "isamplerCube", RGSL_SCALAR_INT, 0, 0, RGSL_SAMPLER_CUBE, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "isampler2DArray", RGSL_SCALAR_INT, 0, 0, RGSL_SAMPLER_2D_ARRAY, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "usampler2D", RGSL_SCALAR_UINT, 0, 0, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "usampler3D", RGSL_SCALAR_UINT, 0, 0, RGSL_SAMPLER_3D, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "usamplerCube", RGSL_SCALAR_UINT, 0, 0, RGSL_SAMPLER_CUBE, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "usampler2DArray", RGSL_SCALAR_UINT, 0, 0, RGSL_SAMPLER_2D_ARRAY, false, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "sampler2DShadow", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D, true, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "samplerCubeShadow", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_CUBE, true, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_SAMPLER, "sampler2DArrayShadow", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D_ARRAY, true, NULL, NULL, 0, NULL},
+    {RGSL_TYPE_ERROR, "<error>", RGSL_SCALAR_FLOAT, 0, 0, RGSL_SAMPLER_2D, false, NULL, NULL, 0, NULL}
+};
+
+// Names of the built-in types, in alphabetical order for binary search.
+static const struct rgsl_builtin_type_name BUILTIN_TYPE_NAMES[] = {
+    {"bool", RGSL_BUILTIN_BOOL},
+    {"bvec2", RGSL_BUILTIN_BVEC2},
+    {"bvec3", RGSL_BUILTIN_BVEC3},
+    {"bvec4", RGSL_BUILTIN_BVEC4},
+    {"float", RGSL_BUILTIN_FLOAT},
+    {"int", RGSL_BUILTIN_INT},
+    {"isampler2D", RGSL_BUILTIN_ISAMPLER2D},
+    {"isampler2DArray", RGSL_BUILTIN_ISAMPLER2DARRAY},
+    {"isampler3D", RGSL_BUILTIN_ISAMPLER3D},
+    {"isamplerCube", RGSL_BUILTIN_ISAMPLERCUBE},
+    {"ivec2", RGSL_BUILTIN_IVEC2},
+    {"ivec3", RGSL_BUILTIN_IVEC3},
+    {"ivec4", RGSL_BUILTIN_IVEC4},
+    {"mat2", RGSL_BUILTIN_MAT2},
+    {"mat2x2", RGSL_BUILTIN_MAT2},
+    {"mat2x3", RGSL_BUILTIN_MAT2X3},
+    {"mat2x4", RGSL_BUILTIN_MAT2X4},
+    {"mat3", RGSL_BUILTIN_MAT3},
+    {"mat3x2", RGSL_BUILTIN_MAT3X2},
+    {"mat3x3", RGSL_BUILTIN_MAT3},
+    {"mat3x4", RGSL_BUILTIN_MAT3X4},
+    {"mat4", RGSL_BUILTIN_MAT4},
+    {"mat4x2", RGSL_BUILTIN_MAT4X2},
+    {"mat4x3", RGSL_BUILTIN_MAT4X3},
+    {"mat4x4", RGSL_BUILTIN_MAT4},
+    {"sampler2D", RGSL_BUILTIN_SAMPLER2D},
+    {"sampler2DArray", RGSL_BUILTIN_SAMPLER2DARRAY},
+    {"sampler2DArrayShadow", RGSL_BUILTIN_SAMPLER2DARRAYSHADOW},
+    {"sampler2DShadow", RGSL_BUILTIN_SAMPLER2DSHADOW},
+    {"sampler3D", RGSL_BUILTIN_SAMPLER3D},
+    {"samplerCube", RGSL_BUILTIN_SAMPLERCUBE},
+    {"samplerCubeShadow", RGSL_BUILTIN_SAMPLERCUBESHADOW},
+    {"uint", RGSL_BUILTIN_UINT},
+    {"usampler2D", RGSL_BUILTIN_USAMPLER2D},
+    {"usampler2DArray", RGSL_BUILTIN_USAMPLER2DARRAY},
+    {"usampler3D", RGSL_BUILTIN_USAMPLER3D},
+    {"usamplerCube", RGSL_BUILTIN_USAMPLERCUBE},
+    {"uvec2", RGSL_BUILTIN_UVEC2},
+    {"uvec3", RGSL_BUILTIN_UVEC3},
+    {"uvec4", RGSL_BUILTIN_UVEC4},
+    {"vec2", RGSL_BUILTIN_VEC2},
+    {"vec3", RGSL_BUILTIN_VEC3},
+    {"vec4", RGSL_BUILTIN_VEC4},
+    {"void", RGSL_BUILTIN_VOID}
+};
+
+// Overloads of the built-in functions, sorted by name for binary search.
+static const struct rgsl_builtin_function BUILTIN_FUNCTIONS[] = {
+    {"abs", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"abs", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"acos", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"acosh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"all", RGSL_ARG_BOOL, {RGSL_ARG_VEC_BOOL, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"any", RGSL_ARG_BOOL, {RGSL_ARG_VEC_BOOL, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"asin", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"asinh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"atan", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"atan", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"atanh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"ceil", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"clamp", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"clamp", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"clamp", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_GEN_INT, RGSL_ARG_GEN_INT, RGSL_ARG_NONE}, 0, 130, 300},
+    {"clamp", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_INT, RGSL_ARG_INT, RGSL_ARG_NONE}, 0, 130, 300},
+    {"clamp", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_GEN_UINT, RGSL_ARG_GEN_UINT, RGSL_ARG_NONE}, 0, 130, 300},
+    {"clamp", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_UINT, RGSL_ARG_UINT, RGSL_ARG_NONE}, 0, 130, 300},
+    {"cos", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"cosh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"cross", RGSL_ARG_VEC3, {RGSL_ARG_VEC3, RGSL_ARG_VEC3, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"dFdx", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, RGSL_BUILTIN_FRAGMENT_ONLY, 110, 100},
+    {"dFdy", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, RGSL_BUILTIN_FRAGMENT_ONLY, 110, 100},
+    {"degrees", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"determinant", RGSL_ARG_FLOAT, {RGSL_ARG_SQUARE_MAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 150, 300},
+    {"distance", RGSL_ARG_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"dot", RGSL_ARG_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"equal", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"equal", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"equal", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"equal", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_BOOL, RGSL_ARG_VEC_BOOL, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"exp", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"exp2", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"faceforward", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"floatBitsToInt", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 330, 300},
+    {"floatBitsToUint", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 330, 300},
+    {"floor", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"fract", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"fwidth", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, RGSL_BUILTIN_FRAGMENT_ONLY, 110, 100},
+    {"greaterThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"greaterThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"greaterThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"greaterThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"greaterThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"greaterThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"intBitsToFloat", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_INT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 330, 300},
+    {"inverse", RGSL_ARG_SQUARE_MAT, {RGSL_ARG_SQUARE_MAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 140, 300},
+    {"inversesqrt", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"isinf", RGSL_ARG_GEN_BOOL, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"isnan", RGSL_ARG_GEN_BOOL, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"length", RGSL_ARG_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"lessThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"lessThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"lessThan", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"lessThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"lessThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"lessThanEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"log", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"log2", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"matrixCompMult", RGSL_ARG_MAT, {RGSL_ARG_MAT, RGSL_ARG_MAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"max", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"max", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"max", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_GEN_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"max", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"max", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_GEN_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"max", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"min", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"min", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"min", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_GEN_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"min", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"min", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_GEN_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"min", RGSL_ARG_GEN_UINT, {RGSL_ARG_GEN_UINT, RGSL_ARG_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"mix", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"mix", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"mix", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_BOOL, RGSL_ARG_NONE}, 0, 130, 300},
+    {"mod", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"mod", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"normalize", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"not", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_BOOL, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"notEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_FLOAT, RGSL_ARG_VEC_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"notEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_INT, RGSL_ARG_VEC_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"notEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_UINT, RGSL_ARG_VEC_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"notEqual", RGSL_ARG_VEC_BOOL, {RGSL_ARG_VEC_BOOL, RGSL_ARG_VEC_BOOL, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"packHalf2x16", RGSL_ARG_UINT, {RGSL_ARG_VEC2, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 420, 300},
+    {"packSnorm2x16", RGSL_ARG_UINT, {RGSL_ARG_VEC2, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 420, 300},
+    {"packUnorm2x16", RGSL_ARG_UINT, {RGSL_ARG_VEC2, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 400, 300},
+    {"pow", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"radians", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"reflect", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"refract", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"round", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"roundEven", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"sign", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"sign", RGSL_ARG_GEN_INT, {RGSL_ARG_GEN_INT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"sin", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"sinh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"smoothstep", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"smoothstep", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_FLOAT, RGSL_ARG_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE}, 0, 110, 100},
+    {"sqrt", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"step", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"step", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_FLOAT, RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"tan", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 110, 100},
+    {"tanh", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"texelFetch", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_FETCH_COORD, RGSL_ARG_INT, RGSL_ARG_NONE}, RGSL_BUILTIN_NO_SHADOW | RGSL_BUILTIN_NO_CUBE, 130, 300},
+    {"texture", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_COORD, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"texture", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_COORD, RGSL_ARG_FLOAT, RGSL_ARG_NONE}, RGSL_BUILTIN_FRAGMENT_ONLY, 130, 300},
+    {"textureGrad", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_COORD, RGSL_ARG_GRADIENT, RGSL_ARG_GRADIENT}, 0, 130, 300},
+    {"textureLod", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_COORD, RGSL_ARG_FLOAT, RGSL_ARG_NONE}, 0, 130, 300},
+    {"textureOffset", RGSL_ARG_TEXEL, {RGSL_ARG_SAMPLER, RGSL_ARG_COORD, RGSL_ARG_OFFSET, RGSL_ARG_NONE}, RGSL_BUILTIN_NO_CUBE, 130, 300},
+    {"textureSize", RGSL_ARG_SIZE, {RGSL_ARG_SAMPLER, RGSL_ARG_INT, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"transpose", RGSL_ARG_TRANSPOSED_MAT, {RGSL_ARG_MAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 120, 300},
+    {"trunc", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_FLOAT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 130, 300},
+    {"uintBitsToFloat", RGSL_ARG_GEN_FLOAT, {RGSL_ARG_GEN_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 330, 300},
+    {"unpackHalf2x16", RGSL_ARG_VEC2, {RGSL_ARG_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 420, 300},
+    {"unpackSnorm2x16", RGSL_ARG_VEC2, {RGSL_ARG_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 420, 300},
+    {"unpackUnorm2x16", RGSL_ARG_VEC2, {RGSL_ARG_UINT, RGSL_ARG_NONE, RGSL_ARG_NONE, RGSL_ARG_NONE}, 0, 400, 300}
+};
+
+static const struct rgsl_builtin_variable BUILTIN_VARIABLES[] = {
+    {"gl_VertexID", RGSL_BUILTIN_INT, "vert", false, 130, 300},
+    {"gl_InstanceID", RGSL_BUILTIN_INT, "vert", false, 140, 300},
+    {"gl_BaseVertex", RGSL_BUILTIN_INT, "vert", false, 460, 0},
+    {"gl_BaseInstance", RGSL_BUILTIN_INT, "vert", false, 460, 0},
+    {"gl_DrawID", RGSL_BUILTIN_INT, "vert", false, 460, 0},
+    {"gl_Position", RGSL_BUILTIN_VEC4, "vert", true, 110, 100},
+    {"gl_PointSize", RGSL_BUILTIN_FLOAT, "vert", true, 110, 100},
+    {"gl_FragCoord", RGSL_BUILTIN_VEC4, "frag", false, 110, 100},
+    {"gl_FrontFacing", RGSL_BUILTIN_BOOL, "frag", false, 110, 100},
+    {"gl_PointCoord", RGSL_BUILTIN_VEC2, "frag", false, 110, 100},
+    {"gl_FragDepth", RGSL_BUILTIN_FLOAT, "frag", true, 110, 300},
+    {"gl_NumWorkGroups", RGSL_BUILTIN_UVEC3, "comp", false, 430, 310},
+    {"gl_WorkGroupID", RGSL_BUILTIN_UVEC3, "comp", false, 430, 310},
+    {"gl_LocalInvocationID", RGSL_BUILTIN_UVEC3, "comp", false, 430, 310},
+    {"gl_GlobalInvocationID", RGSL_BUILTIN_UVEC3, "comp", false, 430, 310},
+    {"gl_LocalInvocationIndex", RGSL_BUILTIN_UINT, "comp", false, 430, 310}
+};
+
+// First scalar or vector type of each scalar kind, the vectors following it.
+static const enum rgsl_builtin_type VECTOR_TYPES[] = {RGSL_BUILTIN_FLOAT, RGSL_BUILTIN_INT, RGSL_BUILTIN_UINT, RGSL_BUILTIN_BOOL};
+
+// Float matrix types, by number of columns then rows, from 2 to 4.
+static const enum rgsl_builtin_type MATRIX_TYPES[3][3] = {
+    {RGSL_BUILTIN_MAT2, RGSL_BUILTIN_MAT2X3, RGSL_BUILTIN_MAT2X4},
+    {RGSL_BUILTIN_MAT3X2, RGSL_BUILTIN_MAT3, RGSL_BUILTIN_MAT3X4},
+    {RGSL_BUILTIN_MAT4X2, RGSL_BUILTIN_MAT4X3, RGSL_BUILTIN_MAT4}
+};
+
+const struct rgsl_type* rgsl_builtin_type(enum rgsl_builtin_type id) {
+    return &BUILTIN_TYPES[id];
+}
+
+const struct rgsl_type* rgsl_find_builtin_type(const char* name, size_t length) {
+    size_t low = 0;
+    size_t high = sizeof(BUILTIN_TYPE_NAMES) / sizeof(BUILTIN_TYPE_NAMES[0]);
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        const char* candidate = BUILTIN_TYPE_NAMES[middle].name;
+        int comparison = strncmp(name, candidate, length);
+        if (comparison == 0 && candidate[length] != '\0') {
+            comparison = -1;
+        }
+        if (comparison == 0) {
+            return &BUILTIN_TYPES[BUILTIN_TYPE_NAMES[middle].id];
+        }
+        if (comparison < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return NULL;
+}
+
+const struct rgsl_type* rgsl_vector_type(enum rgsl_scalar_kind scalar, uint32_t size) {
+    return &BUILTIN_TYPES[VECTOR_TYPES[scalar] + size - 1];
+}
+
+const struct rgsl_type* rgsl_matrix_type(uint32_t columns, uint32_t rows) {
+    return &BUILTIN_TYPES[MATRIX_TYPES[columns - 2][rows - 2]];
+}
+
+bool rgsl_type_equal(const struct rgsl_type* a, const struct rgsl_type* b) {
+    if (a == b) {
+        return true;
+    }
+    if (a->kind != RGSL_TYPE_ARRAY || b->kind != RGSL_TYPE_ARRAY) {
+        return false;
+    }
+    return a->array_size == b->array_size && rgsl_type_equal(a->element, b->element);
+}
+
+bool rgsl_type_is_numeric(const struct rgsl_type* type) {
+    return (type->kind == RGSL_TYPE_SCALAR || type->kind == RGSL_TYPE_VECTOR) && type->scalar != RGSL_SCALAR_BOOL;
+}
+
+bool rgsl_type_is_opaque(const struct rgsl_type* type) {
+    while (type->kind == RGSL_TYPE_ARRAY) {
+        type = type->element;
+    }
+    return type->kind == RGSL_TYPE_SAMPLER;
+}
+
+void rgsl_type_write(struct rgsl_text* output, const struct rgsl_type* type) {
+    if (type->kind != RGSL_TYPE_ARRAY) {
+        rgsl_text_append(output, type->name, strlen(type->name));
+        return;
+    }
+    rgsl_type_write(output, type->element);
+    if (type->array_size == 0 || type->array_size == RGSL_RUNTIME_ARRAY) {
+        rgsl_text_append(output, "[]", 2);
+    } else {
+        rgsl_text_printf(output, "[%u]", type->array_size);
+    }
+}
+
+bool rgsl_type_converts(const struct rgsl_type* from, const struct rgsl_type* to) {
+    if (rgsl_type_equal(from, to)) {
+        return true;
+    }
+    return (from->kind == RGSL_TYPE_SCALAR || from->kind == RGSL_TYPE_VECTOR) && from->kind == to->kind &&
+           from->rows == to->rows && to->scalar == RGSL_SCALAR_FLOAT &&
+           (from->scalar == RGSL_SCALAR_INT || from->scalar == RGSL_SCALAR_UINT);
+}
+
+const struct rgsl_builtin_function* rgsl_find_builtin_functions(const char* name, size_t* out_count) {
+    size_t total = sizeof(BUILTIN_FUNCTIONS) / sizeof(BUILTIN_FUNCTIONS[0]);
+    size_t low = 0;
+    size_t high = total;
+    while (low < high) {
+        size_t middle = (low + high) / 2;
+        if (strcmp(BUILTIN_FUNCTIONS[middle].name, name) < 0) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    size_t end = low;
+    while (end < total && strcmp(BUILTIN_FUNCTIONS[end].name, name) == 0) {
+        end++;
+    }
+    *out_count = end - low;
+    return (end > low) ? &BUILTIN_FUNCTIONS[low] : NULL;
+}
+
+// Number of components of the coordinates of a sampler, without array layer nor depth reference.
+static uint32_t rgsl_sampler_dimensions(const struct rgsl_type* sampler) {
+    return (sampler->dim == RGSL_SAMPLER_3D || sampler->dim == RGSL_SAMPLER_CUBE) ? 3 : 2;
+}
+
+static const struct rgsl_type* rgsl_texture_type(enum rgsl_builtin_kind kind, const struct rgsl_type* sampler) {
+    uint32_t dimensions = rgsl_sampler_dimensions(sampler);
+    uint32_t layer = (sampler->dim == RGSL_SAMPLER_2D_ARRAY) ? 1 : 0;
+    switch (kind) {
+        case RGSL_ARG_COORD:
+            return rgsl_vector_type(RGSL_SCALAR_FLOAT, dimensions + layer + (sampler->shadow ? 1 : 0));
+        case RGSL_ARG_FETCH_COORD:
+            return rgsl_vector_type(RGSL_SCALAR_INT, dimensions + layer);
+        case RGSL_ARG_GRADIENT:
+            return rgsl_vector_type(RGSL_SCALAR_FLOAT, dimensions);
+        case RGSL_ARG_OFFSET:
+            return rgsl_vector_type(RGSL_SCALAR_INT, dimensions);
+        case RGSL_ARG_SIZE:
+            return rgsl_vector_type(RGSL_SCALAR_INT, (sampler->dim == RGSL_SAMPLER_CUBE) ? 2 : dimensions + layer);
+        default:
+            return sampler->shadow ? &BUILTIN_TYPES[RGSL_BUILTIN_FLOAT] : rgsl_vector_type(sampler->scalar, 4);
+    }
+}
+
+/**
+ * State of the generic parameters of a built-in function, bound by the first
+ * argument using them.
+ */
+struct rgsl_builtin_binding {
+    uint32_t size;
+    const struct rgsl_type* matrix;
+    const struct rgsl_type* sampler;
+};
+
+// Scalar kind of the generic and vector parameter kinds, from RGSL_ARG_GEN_FLOAT.
+static const enum rgsl_scalar_kind GENERIC_SCALARS[] = {RGSL_SCALAR_FLOAT, RGSL_SCALAR_INT, RGSL_SCALAR_UINT, RGSL_SCALAR_BOOL};
+
+// Fixed parameter types, from RGSL_ARG_FLOAT.
+static const enum rgsl_builtin_type FIXED_TYPES[] = {RGSL_BUILTIN_FLOAT, RGSL_BUILTIN_INT, RGSL_BUILTIN_UINT, RGSL_BUILTIN_BOOL, RGSL_BUILTIN_VEC2, RGSL_BUILTIN_VEC3};
+
+static const struct rgsl_type* rgsl_builtin_parameter_type(enum rgsl_builtin_kind kind, const struct rgsl_type* argument, uint8_t flags, struct rgsl_builtin_binding* binding) {
+    if (kind >= RGSL_ARG_GEN_FLOAT && kind <= RGSL_ARG_VEC_BOOL) {
+        if (argument->kind != RGSL_TYPE_SCALAR && argument->kind != RGSL_TYPE_VECTOR) {
+            return NULL;
+        }
+        bool vector_only = kind >= RGSL_ARG_VEC_FLOAT;
+        enum rgsl_scalar_kind scalar = GENERIC_SCALARS[vector_only ? kind - RGSL_ARG_VEC_FLOAT : kind - RGSL_ARG_GEN_FLOAT];
+        if ((vector_only && argument->rows < 2) || (binding->size != 0 && binding->size != argument->rows)) {
+            return NULL;
+        }
+        binding->size = argument->rows;
+        return rgsl_vector_type(scalar, argument->rows);
+    }
+    if (kind >= RGSL_ARG_FLOAT && kind <= RGSL_ARG_VEC3) {
+        return &BUILTIN_TYPES[FIXED_TYPES[kind - RGSL_ARG_FLOAT]];
+    }
+    if (kind == RGSL_ARG_MAT || kind == RGSL_ARG_SQUARE_MAT) {
+        if (argument->kind != RGSL_TYPE_MATRIX || (binding->matrix != NULL && binding->matrix != argument) ||
+            (kind == RGSL_ARG_SQUARE_MAT && argument->columns != argument->rows)) {
+            return NULL;
+        }
+        binding->matrix = argument;
+        return argument;
+    }
+    if (kind == RGSL_ARG_SAMPLER) {
+        if (argument->kind != RGSL_TYPE_SAMPLER || ((flags & RGSL_BUILTIN_NO_SHADOW) && argument->shadow) ||
+            ((flags & RGSL_BUILTIN_NO_CUBE) && argument->dim == RGSL_SAMPLER_CUBE)) {
+            return NULL;
+        }
+        binding->sampler = argument;
+        return argument;
+    }
+    return (binding->sampler != NULL) ? rgsl_texture_type(kind, binding->sampler) : NULL;
+}
+
+static const struct rgsl_type* rgsl_builtin_result_type(enum rgsl_builtin_kind kind, const struct rgsl_builtin_binding* binding) {
+    if (kind >= RGSL_ARG_GEN_FLOAT && kind <= RGSL_ARG_VEC_BOOL) {
+        bool vector_only = kind >= RGSL_ARG_VEC_FLOAT;
+        return rgsl_vector_type(GENERIC_SCALARS[vector_only ? kind - RGSL_ARG_VEC_FLOAT : kind - RGSL_ARG_GEN_FLOAT], binding->size);
+    }
+    if (kind >= RGSL_ARG_FLOAT && kind <= RGSL_ARG_VEC3) {
+        return &BUILTIN_TYPES[FIXED_TYPES[kind - RGSL_ARG_FLOAT]];
+    }
+    if (kind == RGSL_ARG_MAT || kind == RGSL_ARG_SQUARE_MAT) {
+        return binding->matrix;
+    }
+    if (kind == RGSL_ARG_TRANSPOSED_MAT) {
+        return rgsl_matrix_type(binding->matrix->rows, binding->matrix->columns);
+    }
+    return rgsl_texture_type(kind, binding->sampler);
+}
+
+bool rgsl_match_builtin_function(const struct rgsl_builtin_function* function, const struct rgsl_type* const* arguments, size_t count, struct rgsl_builtin_match* out_match) {
+    struct rgsl_builtin_binding binding = {0, NULL, NULL};
+    out_match->cost = 0;
+    size_t i = 0;
+    for (; i < 4 && function->parameters[i] != RGSL_ARG_NONE; i++) {
+        if (i >= count) {
+            return false;
+        }
+        const struct rgsl_type* parameter = rgsl_builtin_parameter_type((enum rgsl_builtin_kind)function->parameters[i], arguments[i], function->flags, &binding);
+        if (parameter == NULL || !rgsl_type_converts(arguments[i], parameter)) {
+            return false;
+        }
+        out_match->cost += rgsl_type_equal(arguments[i], parameter) ? 0 : 1;
+        out_match->parameters[i] = parameter;
+    }
+    if (i != count) {
+        return false;
+    }
+    out_match->result = rgsl_builtin_result_type((enum rgsl_builtin_kind)function->result, &binding);
+    return true;
+}
+
+const struct rgsl_builtin_variable* rgsl_find_builtin_variable(const char* name) {
+    if (name[0] != 'g' || name[1] != 'l' || name[2] != '_') {
+        return NULL;
+    }
+    for (size_t i = 0; i < sizeof(BUILTIN_VARIABLES) / sizeof(BUILTIN_VARIABLES[0]); i++) {
+        if (strcmp(BUILTIN_VARIABLES[i].name, name) == 0) {
+            return &BUILTIN_VARIABLES[i];
+        }
+    }
+    return NULL;
+}
\ No newline at end of file
@@ -1,12 +1,25 @@
 #include <RGSL/validator.h>
 #include <RGSL/rgsl/validator.h>
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/rgsl/glsl.h>
+#include <RGSL/target.h>
 #include <RGSL/termio.h>
+#include <RGSL/rgsl.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdarg.h>
 
 bool rgsl_rgsl_validate_shader(struct rgsl_shader_data * shader) {
-    rgsl_print_error("RGSL validation not yet implemented.\n");
-    return true;
+    // The profile is part of validity, features of the shader may be missing from the requested one.
+    bool valid = rgsl_rgsl_build_module(shader) && rgsl_glsl_choose_profile(shader->module, &shader->requested_profile, &shader->profile);
+    // Each of the --targets must be able to hold the shader as well.
+    for (size_t i = 0; valid && i < rgsl_target_count(); i++) {
+        struct rgsl_shader_profile profile;
+        valid = rgsl_glsl_choose_profile(shader->module, &rgsl_get_target(i)->profile, &profile);
+    }
+    if (valid) {
+        rgsl_print_info(1, "RGSL shader code is valid.\n");
+    }
+    return valid;
 }
\ No newline at end of file
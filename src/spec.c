@@ -0,0 +1,180 @@
+#include <RGSL/spec.h>
+#include <RGSL/termio.h>
+#include <RGSL/rgsl.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+static const char* const SPEC_TYPE_NAMES[] = {
+    "bool",
+    "highp int",
+    "highp uint",
+    "highp float"
+};
+
+bool rgsl_spec_constants_enabled() {
+    return rgsl_global_options.spec_constants != NULL && (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV);
+}
+
+static size_t rgsl_spec_name_length(const char* option) {
+    const char* equal = strchr(option, '=');
+    return equal ? (size_t)(equal - option) : strlen(option);
+}
+
+static const char* rgsl_spec_default_text(const char* option) {
+    const char* equal = strchr(option, '=');
+    return equal ? equal + 1 : "0";
+}
+
+static bool rgsl_parse_spec_literal(const char* text, enum rgsl_spec_type* out_type, uint32_t* out_value) {
+    while (isspace((unsigned char)*text)) {
+        text++;
+    }
+    size_t length = strlen(text);
+    while (length > 0 && isspace((unsigned char)text[length - 1])) {
+        length--;
+    }
+    if (length == 4 && strncmp(text, "true", 4) == 0) {
+        *out_type = RGSL_SPEC_BOOL;
+        *out_value = 1;
+        return true;
+    }
+    if (length == 5 && strncmp(text, "false", 5) == 0) {
+        *out_type = RGSL_SPEC_BOOL;
+        *out_value = 0;
+        return true;
+    }
+    if (length == 0 || length > 63) {
+        return false;
+    }
+    char literal[64];
+    memcpy(literal, text, length);
+    literal[length] = '\0';
+
+    bool hex = length > 2 && literal[0] == '0' && (literal[1] == 'x' || literal[1] == 'X');
+    bool is_float = !hex && (strpbrk(literal, ".eE") != NULL || literal[length - 1] == 'f' || literal[length - 1] == 'F');
+    char* end;
+    if (is_float) {
+        if (literal[length - 1] == 'f' || literal[length - 1] == 'F') {
+            literal[--length] = '\0';
+        }
+        float value = (float)strtod(literal, &end);
+        memcpy(out_value, &value, sizeof(float));
+        *out_type = RGSL_SPEC_FLOAT;
+    } else if (literal[length - 1] == 'u' || literal[length - 1] == 'U') {
+        literal[--length] = '\0';
+        unsigned long value = strtoul(literal, &end, 0);
+        if (value > 0xFFFFFFFFul || literal[0] == '-') {
+            return false;
+        }
+        *out_value = (uint32_t)value;
+        *out_type = RGSL_SPEC_UINT;
+    } else {
+        long long value = strtoll(literal, &end, 0);
+        if (value < INT32_MIN || value > INT32_MAX) {
+            return false;
+        }
+        *out_value = (uint32_t)(int32_t)value;
+        *out_type = RGSL_SPEC_INT;
+    }
+    return length > 0 && *end == '\0';
+}
+
+bool rgsl_check_spec_constants() {
+    for (size_t i = 0; rgsl_global_options.spec_constants != NULL && rgsl_global_options.spec_constants[i] != NULL; i++) {
+        const char* option = rgsl_global_options.spec_constants[i];
+        size_t name_length = rgsl_spec_name_length(option);
+        bool valid = name_length > 0 && (isalpha((unsigned char)option[0]) || option[0] == '_');
+        for (size_t j = 1; valid && j < name_length; j++) {
+            valid = isalnum((unsigned char)option[j]) || option[j] == '_';
+        }
+        enum rgsl_spec_type type;
+        uint32_t value;
+        if (!valid || !rgsl_parse_spec_literal(rgsl_spec_default_text(option), &type, &value)) {
+            rgsl_printf_error("Malformed specialization constant: %s\n", option);
+            return false;
+        }
+        for (size_t j = 0; j < i; j++) {
+            const char* other = rgsl_global_options.spec_constants[j];
+            if (rgsl_spec_name_length(other) == name_length && strncmp(other, option, name_length) == 0) {
+                rgsl_printf_error("Specialization constant given twice: %.*s\n", (int)name_length, option);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+size_t rgsl_spec_constant_count() {
+    size_t count = 0;
+    if (rgsl_spec_constants_enabled()) {
+        while (rgsl_global_options.spec_constants[count] != NULL) {
+            count++;
+        }
+    }
+    return count;
+}
+
+int rgsl_find_spec_constant(const char* name, size_t length) {
+    size_t count = rgsl_spec_constant_count();
+    for (size_t i = 0; i < count; i++) {
+        const char* option = rgsl_global_options.spec_constants[i];
+        if (rgsl_spec_name_length(option) == length && strncmp(option, name, length) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool rgsl_spec_constant_value(size_t constant_id, const char* text, uint32_t* out_value) {
+    enum rgsl_spec_type constant_type;
+    uint32_t default_value;
+    rgsl_parse_spec_literal(rgsl_spec_default_text(rgsl_global_options.spec_constants[constant_id]), &constant_type, &default_value);
+    enum rgsl_spec_type type;
+    uint32_t value;
+    if (!rgsl_parse_spec_literal(text, &type, &value)) {
+        return false;
+    }
+    if (type == constant_type) {
+        *out_value = value;
+        return true;
+    }
+    // Integers convert to the other scalar types, like they would in a #define.
+    if (type == RGSL_SPEC_INT && constant_type == RGSL_SPEC_FLOAT) {
+        float converted = (float)(int32_t)value;
+        memcpy(out_value, &converted, sizeof(float));
+        return true;
+    }
+    if (type == RGSL_SPEC_INT && constant_type == RGSL_SPEC_UINT && (int32_t)value >= 0) {
+        *out_value = value;
+        return true;
+    }
+    if (type == RGSL_SPEC_INT && constant_type == RGSL_SPEC_BOOL && value <= 1) {
+        *out_value = value;
+        return true;
+    }
+    return false;
+}
+
+void rgsl_write_spec_constant_declarations(struct rgsl_text* output) {
+    size_t count = rgsl_spec_constant_count();
+    for (size_t i = 0; i < count; i++) {
+        const char* option = rgsl_global_options.spec_constants[i];
+        const char* default_text = rgsl_spec_default_text(option);
+        enum rgsl_spec_type type;
+        uint32_t value;
+        rgsl_parse_spec_literal(default_text, &type, &value);
+        rgsl_text_printf(output, "layout(constant_id = %zu) const %s %.*s = %s;\n", i, SPEC_TYPE_NAMES[type], (int)rgsl_spec_name_length(option), option, default_text);
+    }
+}
+
+void rgsl_write_spec_constant_enum(struct rgsl_text* output) {
+    size_t count = rgsl_spec_constant_count();
+    rgsl_text_printf(output, "enum rgsl_spec_constant_id {\n");
+    for (size_t i = 0; i < count; i++) {
+        const char* option = rgsl_global_options.spec_constants[i];
+        rgsl_text_printf(output, "    RGSL_SPEC_%.*s = %zu,\n", (int)rgsl_spec_name_length(option), option, i);
+    }
+    rgsl_text_printf(output, "    RGSL_SPEC_CONSTANT_COUNT = %zu\n", count);
+    rgsl_text_printf(output, "};\n\n");
+}
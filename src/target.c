@@ -0,0 +1,430 @@
+#include <RGSL/target.h>
+#include <RGSL/rgsl/parser.h>
+#include <RGSL/rgsl/glsl.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/compile.h>
+#include <RGSL/fileio.h>
+#include <RGSL/termio.h>
+#include <RGSL/thread.h>
+#include <RGSL/clock.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// With --glslang-spirv, SPIR-V is compiled by glslang from GLSL written for the OpenGL SPIR-V environment.
+static const struct rgsl_shader_profile SPIRV_PROFILE = {450, "core"};
+
+// GLSL for Vulkan, compiled to SPIR-V by glslang.
+static const struct rgsl_shader_profile VULKAN_PROFILE = {450, "core"};
+
+// Types GLSL ES gives no default precision to in some stage, declared ahead of GLSL shaders.
+static const char* const ES_PRECISION_TYPES[] = {
+    "float", "int", "sampler2D", "sampler3D", "samplerCube", "sampler2DShadow", "samplerCubeShadow",
+    "sampler2DArray", "sampler2DArrayShadow", "isampler2D", "isampler3D", "isamplerCube", "isampler2DArray",
+    "usampler2D", "usampler3D", "usamplerCube", "usampler2DArray", NULL
+};
+
+static struct rgsl_target targets[RGSL_MAX_TARGETS];
+static size_t target_count;
+
+/**
+ * One backend emitting a module for a target, on its own thread when it can.
+ */
+struct rgsl_target_job {
+    struct rgsl_module* module;
+    struct rgsl_target_output* output;
+    struct rgsl_text text;
+    rgsl_thread thread;
+    bool threaded;
+};
+
+/**
+ * One target of a GLSL shader: the shared body behind the preamble of the target,
+ * parsed, linked and for SPIR-V targets compiled by glslang on its own thread.
+ */
+struct rgsl_glsl_target_job {
+    const struct rgsl_shader_data* shader;
+    const char* body;
+    struct rgsl_target_output* output;
+    struct rgsl_glslang_program* program;
+    char* log;
+    rgsl_thread thread;
+    bool threaded;
+    bool success;
+};
+
+bool rgsl_targets_enabled() {
+    return rgsl_global_options.targets != NULL;
+}
+
+static bool rgsl_add_target(const char* name, size_t length) {
+    if (target_count == RGSL_MAX_TARGETS) {
+        rgsl_printf_error("At most %d targets can be given to --targets\n", RGSL_MAX_TARGETS);
+        return false;
+    }
+    struct rgsl_target* target = &targets[target_count];
+    target->name = (char *)rgsl_malloc(length + 1);
+    memcpy(target->name, name, length);
+    target->name[length] = '\0';
+    target->spirv = strcmp(target->name, "spirv") == 0;
+    target->vulkan = 0;
+    int major;
+    int minor;
+    char end;
+    if (sscanf(target->name, "vulkan%d.%d%c", &major, &minor, &end) == 2 && major == 1 && minor >= 0 && minor <= 3) {
+        target->spirv = true;
+        target->vulkan = major * 100 + minor * 10;
+        target->profile = VULKAN_PROFILE;
+    } else if (target->spirv) {
+        target->profile = SPIRV_PROFILE;
+    } else if (!rgsl_parse_profile(target->name, &target->profile)) {
+        rgsl_printf_error("Invalid target: %s (expected a profile such as 330core or 300es, spirv, or vulkan1.0 to vulkan1.3)\n", target->name);
+        rgsl_free(target->name);
+        return false;
+    }
+    for (size_t i = 0; i < target_count; i++) {
+        bool same_profile = targets[i].profile.version == target->profile.version && strcmp(targets[i].profile.name, target->profile.name) == 0;
+        if (targets[i].spirv == target->spirv && targets[i].vulkan == target->vulkan && same_profile) {
+            rgsl_printf_error("Target given twice: %s\n", target->name);
+            rgsl_free(target->name);
+            return false;
+        }
+    }
+    target_count++;
+    return true;
+}
+
+bool rgsl_check_targets() {
+    const char* list = rgsl_global_options.targets;
+    if (list == NULL) {
+        return true;
+    }
+    if (rgsl_global_options.action & RGSL_ACTION_COMPILE_SPIRV) {
+        rgsl_print_error("--targets chooses the outputs, SPIR-V is requested with the spirv target instead of --spirv\n");
+        return false;
+    }
+    while (*list != '\0') {
+        const char* end = strchr(list, ',');
+        size_t length = (end != NULL) ? (size_t)(end - list) : strlen(list);
+        if (length == 0 || !rgsl_add_target(list, length)) {
+            if (length == 0) {
+                rgsl_printf_error("Empty target in --targets %s\n", rgsl_global_options.targets);
+            }
+            return false;
+        }
+        list += length + (end != NULL ? 1 : 0);
+    }
+    if (target_count == 0) {
+        rgsl_print_error("--targets needs at least one target\n");
+        return false;
+    }
+    return true;
+}
+
+size_t rgsl_target_count() {
+    return target_count;
+}
+
+const struct rgsl_target* rgsl_get_target(size_t index) {
+    return &targets[index];
+}
+
+void rgsl_targets_finalize() {
+    for (size_t i = 0; i < target_count; i++) {
+        rgsl_free(targets[i].name);
+    }
+    target_count = 0;
+}
+
+char* rgsl_target_output_path(const char* output_file, const struct rgsl_target* target) {
+    size_t length = strlen(output_file) + strlen(target->name) + 2;
+    char* path = (char *)rgsl_malloc(length);
+    snprintf(path, length, "%s.%s", output_file, target->name);
+    return path;
+}
+
+static void rgsl_emit_target(void* user) {
+    struct rgsl_target_job* job = (struct rgsl_target_job*)user;
+    rgsl_text_init(&job->text);
+    rgsl_glsl_emit(job->module, &job->output->profile, &job->text);
+}
+
+static bool rgsl_compile_rgsl_targets(struct rgsl_shader_data* shader) {
+    for (size_t i = 0; i < target_count; i++) {
+        if (targets[i].vulkan != 0) {
+            rgsl_printf_error("The %s target applies to GLSL shaders, %s is an RGSL shader\n", targets[i].name, shader->path);
+            return false;
+        }
+    }
+    if (!rgsl_rgsl_build_module(shader)) {
+        return false;
+    }
+    struct rgsl_target_output* outputs = (struct rgsl_target_output *)rgsl_calloc(target_count, sizeof(struct rgsl_target_output));
+    bool success = true;
+    for (size_t i = 0; i < target_count; i++) {
+        outputs[i].target = &targets[i];
+        success &= rgsl_glsl_choose_profile(shader->module, &targets[i].profile, &outputs[i].profile);
+    }
+    if (!success) {
+        rgsl_free(outputs);
+        return false;
+    }
+
+    double start = rgsl_clock_seconds();
+    struct rgsl_target_job jobs[RGSL_MAX_TARGETS];
+    // The GLSL backends only read the module, so they share it without locking.
+    for (size_t i = 0; i < target_count; i++) {
+        jobs[i].module = shader->module;
+        jobs[i].output = &outputs[i];
+        jobs[i].threaded = !targets[i].spirv && rgsl_thread_create(&jobs[i].thread, rgsl_emit_target, &jobs[i]);
+    }
+    // SPIR-V is emitted on this thread, glslang being only used from it, overlapping with the other backends.
+    for (size_t i = 0; i < target_count; i++) {
+        if (jobs[i].threaded) {
+            continue;
+        }
+        if (targets[i].spirv && !rgsl_global_options.glslang_spirv) {
+            success &= rgsl_compile_module_spirv(shader, &outputs[i].code, &outputs[i].size);
+            rgsl_text_init(&jobs[i].text);
+            continue;
+        }
+        rgsl_emit_target(&jobs[i]);
+        if (targets[i].spirv) {
+            success &= rgsl_compile_spirv(shader, jobs[i].text.data, &outputs[i].code, &outputs[i].size);
+            rgsl_text_init(&jobs[i].text);
+        }
+    }
+    const char* glsl_code = NULL;
+    bool spirv = false;
+    for (size_t i = 0; i < target_count; i++) {
+        if (jobs[i].threaded) {
+            rgsl_thread_join(jobs[i].thread);
+        }
+        if (!targets[i].spirv) {
+            outputs[i].code = jobs[i].text.data;
+            outputs[i].size = jobs[i].text.length;
+            glsl_code = (glsl_code != NULL) ? glsl_code : outputs[i].code;
+        }
+        spirv |= targets[i].spirv;
+    }
+    rgsl_printf_info(2, "Emitted %zu targets in %.3f ms\n", target_count, rgsl_clock_elapsed_ms(start));
+    shader->target_outputs = outputs;
+    shader->target_output_count = target_count;
+    // The SPIR-V target hashed the interface already.
+    if (success && !spirv && (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED)) {
+        rgsl_hash_shader_interface(shader, glsl_code);
+    }
+    rgsl_release_shader_intermediates(shader);
+    if (!success) {
+        rgsl_release_target_outputs(shader);
+    }
+    return success;
+}
+
+char* rgsl_target_glsl_code(const struct rgsl_target* target, const char* body) {
+    struct rgsl_text text;
+    rgsl_text_init(&text);
+    bool es = strcmp(target->profile.name, "es") == 0;
+    if (target->profile.version < 150 && !es) {
+        rgsl_text_printf(&text, "#version %d\n", target->profile.version);
+    } else {
+        rgsl_text_printf(&text, "#version %d %s\n", target->profile.version, target->profile.name);
+    }
+    for (size_t i = 0; es && ES_PRECISION_TYPES[i] != NULL; i++) {
+        rgsl_text_printf(&text, "precision highp %s;\n", ES_PRECISION_TYPES[i]);
+    }
+    rgsl_text_printf(&text, "#define ");
+    rgsl_write_target_name(&text, target);
+    rgsl_text_printf(&text, " 1\n");
+    rgsl_text_append(&text, body, strlen(body));
+    return text.data;
+}
+
+struct rgsl_glslang_program* rgsl_create_target_program(const struct rgsl_target* target, const struct rgsl_shader_data* shader, const char* code, char** out_log) {
+    if (target->vulkan != 0) {
+        return rgsl_glslang_create_vulkan_program(code, shader->path, shader->stage, target->vulkan, out_log);
+    }
+    return rgsl_glslang_create_program(code, shader->path, shader->stage, false, target->spirv, out_log);
+}
+
+static void rgsl_compile_glsl_target(void* user) {
+    struct rgsl_glsl_target_job* job = (struct rgsl_glsl_target_job*)user;
+    const struct rgsl_target* target = job->output->target;
+    char* code = rgsl_target_glsl_code(target, job->body);
+    job->program = rgsl_create_target_program(target, job->shader, code, &job->log);
+    job->success = job->program != NULL;
+    if (!target->spirv) {
+        job->output->code = code;
+        return;
+    }
+    rgsl_free(code);
+    if (job->success) {
+        struct rgsl_glslang_result result = rgsl_glslang_generate_spirv(job->program);
+        job->success = result.success != 0;
+        if (job->success) {
+            job->output->size = result.word_count * sizeof(uint32_t);
+            job->output->code = (char *)rgsl_malloc(job->output->size);
+            memcpy(job->output->code, result.words, job->output->size);
+        } else {
+            rgsl_free(job->log);
+            job->log = rgsl_strdup(result.log);
+        }
+        rgsl_glslang_free_result(&result);
+    }
+}
+
+static bool rgsl_compile_glsl_targets(struct rgsl_shader_data* shader) {
+    // Workers share the spliced body; includes left to glslang would share the include caches.
+    if (!rgsl_glsl_preprocess_shader(shader, false)) {
+        return false;
+    }
+    struct rgsl_target_output* outputs = (struct rgsl_target_output *)rgsl_calloc(target_count, sizeof(struct rgsl_target_output));
+    struct rgsl_glsl_target_job jobs[RGSL_MAX_TARGETS];
+    double start = rgsl_clock_seconds();
+    // glslang parses shaders on several threads once initialized, each target runs on its own.
+    for (size_t i = 0; i < target_count; i++) {
+        outputs[i].target = &targets[i];
+        outputs[i].profile = targets[i].profile;
+        jobs[i].shader = shader;
+        jobs[i].body = shader->processed_code;
+        jobs[i].output = &outputs[i];
+        jobs[i].program = NULL;
+        jobs[i].log = NULL;
+        jobs[i].threaded = rgsl_thread_create(&jobs[i].thread, rgsl_compile_glsl_target, &jobs[i]);
+    }
+    bool success = true;
+    for (size_t i = 0; i < target_count; i++) {
+        if (jobs[i].threaded) {
+            rgsl_thread_join(jobs[i].thread);
+        } else {
+            rgsl_compile_glsl_target(&jobs[i]);
+        }
+        if (!jobs[i].success) {
+            rgsl_printf_error("%s failed to compile for %s:\n%s\n", shader->path, targets[i].name, jobs[i].log != NULL ? jobs[i].log : "");
+            success = false;
+        } else if (targets[i].spirv) {
+            success &= rgsl_validate_spirv(shader, outputs[i].code, outputs[i].size, targets[i].vulkan);
+        }
+        rgsl_free(jobs[i].log);
+    }
+    rgsl_printf_info(2, "Compiled %zu targets in %.3f ms\n", target_count, rgsl_clock_elapsed_ms(start));
+    // The interface is reflected from the program of the first target, the others are done.
+    for (size_t i = 0; i < target_count; i++) {
+        if (success && shader->program == NULL && jobs[i].program != NULL) {
+            shader->program = jobs[i].program;
+        } else if (jobs[i].program != NULL) {
+            rgsl_glslang_destroy_program(jobs[i].program);
+        }
+    }
+    shader->target_outputs = outputs;
+    shader->target_output_count = target_count;
+    if (success && (rgsl_global_options.action & RGSL_ACTION_COMPILE_EMBED)) {
+        rgsl_hash_shader_interface(shader, NULL);
+    }
+    rgsl_release_shader_intermediates(shader);
+    if (!success) {
+        rgsl_release_target_outputs(shader);
+    }
+    return success;
+}
+
+bool rgsl_compile_targets(struct rgsl_shader_data* shader) {
+    if (strcmp(shader->language, "glsl") == 0) {
+        return rgsl_compile_glsl_targets(shader);
+    }
+    if (strcmp(shader->language, "rgsl") == 0) {
+        return rgsl_compile_rgsl_targets(shader);
+    }
+    rgsl_printf_error("--targets applies to RGSL and GLSL shaders, %s is a %s shader\n", shader->path, shader->language);
+    return false;
+}
+
+void rgsl_release_target_outputs(struct rgsl_shader_data* shader) {
+    for (size_t i = 0; i < shader->target_output_count; i++) {
+        rgsl_free_file_buffer(shader->target_outputs[i].code);
+    }
+    rgsl_free(shader->target_outputs);
+    shader->target_outputs = NULL;
+    shader->target_output_count = 0;
+}
+
+bool rgsl_has_target(bool spirv) {
+    for (size_t i = 0; i < target_count; i++) {
+        if (targets[i].spirv == spirv) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void rgsl_write_target_name(struct rgsl_text* output, const struct rgsl_target* target) {
+    rgsl_text_printf(output, "RGSL_TARGET_");
+    for (const char* c = target->name; *c != '\0'; c++) {
+        char upper = isalnum((unsigned char)*c) ? (char)toupper((unsigned char)*c) : '_';
+        rgsl_text_append(output, &upper, 1);
+    }
+}
+
+void rgsl_write_target_enum(struct rgsl_text* output) {
+    rgsl_text_printf(output, "enum rgsl_target {\n");
+    for (size_t i = 0; i < target_count; i++) {
+        rgsl_text_printf(output, "    ");
+        rgsl_write_target_name(output, &targets[i]);
+        rgsl_text_printf(output, ",\n");
+    }
+    rgsl_text_printf(output, "    RGSL_TARGET_COUNT\n};\n\n");
+}
+
+void rgsl_write_target_info_types(struct rgsl_text* output) {
+    rgsl_text_printf(output,
+        "enum rgsl_api {\n"
+        "    RGSL_API_OPENGL,\n"
+        "    RGSL_API_OPENGL_ES,\n"
+        "    RGSL_API_OPENGL_SPIRV,\n"
+        "    RGSL_API_VULKAN\n"
+        "};\n"
+        "\n"
+        "struct rgsl_target_info {\n"
+        "    const char *name;\n"
+        "    enum rgsl_api api;\n"
+        "    int version;\n"
+        "};\n"
+        "\n"
+    );
+}
+
+void rgsl_write_target_infos(struct rgsl_text* output) {
+    rgsl_text_printf(output, "\nconst struct rgsl_target_info rgsl_target_infos[RGSL_TARGET_COUNT] = {\n");
+    for (size_t i = 0; i < target_count; i++) {
+        const struct rgsl_target* target = &targets[i];
+        const char* api = "RGSL_API_OPENGL";
+        int version = target->profile.version;
+        if (target->vulkan != 0) {
+            api = "RGSL_API_VULKAN";
+            version = target->vulkan;
+        } else if (target->spirv) {
+            api = "RGSL_API_OPENGL_SPIRV";
+        } else if (strcmp(target->profile.name, "es") == 0) {
+            api = "RGSL_API_OPENGL_ES";
+        }
+        rgsl_text_printf(output, "\t{\"%s\", %s, %d},\n", target->name, api, version);
+    }
+    rgsl_text_printf(output,
+        "};\n"
+        "\n"
+        "enum rgsl_target rgsl_select_target(enum rgsl_api api, int version) {\n"
+        "    enum rgsl_target best = RGSL_TARGET_COUNT;\n"
+        "    for (int i = 0; i < RGSL_TARGET_COUNT; i++) {\n"
+        "        const struct rgsl_target_info *info = &rgsl_target_infos[i];\n"
+        "        if (info->api == api && info->version <= version && (best == RGSL_TARGET_COUNT || info->version > rgsl_target_infos[best].version)) {\n"
+        "            best = (enum rgsl_target)i;\n"
+        "        }\n"
+        "    }\n"
+        "    return best;\n"
+        "}\n"
+    );
+}
\ No newline at end of file
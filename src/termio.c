@@ -1,63 +1,278 @@
 #include <RGSL/termio.h>
 #include <RGSL/rgsl.h>
+#include <RGSL/text.h>
+#include <RGSL/thread.h>
+#include <RGSL/clock.h>
+#include <RGSL/memory.h>
 #include <stdarg.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <stdbool.h>
+#include <string.h>
+#include <ctype.h>
+
+// Most messages fit on the stack, longer ones are formatted again on the heap.
+#define RGSL_LOG_LINE_SIZE 512
+
+/**
+ * Messages of the shader a thread is working on, written together when it is done.
+ * They share one buffer in their order, each record telling where a run of messages
+ * ends and its channel: 0 for stdout (or the JSON log), 1 for stderr.
+ */
+struct rgsl_log_record {
+    int channel;
+    size_t end;
+};
+
+struct rgsl_log_scope {
+    const char* shader;
+    struct rgsl_text messages;
+    struct rgsl_log_record* records;
+    size_t record_count;
+    size_t record_capacity;
+    int depth;
+};
+
+static RGSL_THREAD_LOCAL struct rgsl_log_scope rgsl_log_scope;
+static rgsl_mutex rgsl_log_mutex;
+static bool rgsl_log_ready = false;
+static FILE* rgsl_log_json = NULL;
+static double rgsl_log_start = 0.0;
+
+void rgsl_log_initialize() {
+    rgsl_mutex_init(&rgsl_log_mutex);
+    rgsl_log_ready = true;
+    rgsl_log_start = rgsl_clock_seconds();
+}
+
+void rgsl_log_finalize() {
+    if (rgsl_log_json != NULL && rgsl_log_json != stdout) {
+        fclose(rgsl_log_json);
+    }
+    rgsl_log_json = NULL;
+    if (rgsl_log_ready) {
+        rgsl_log_ready = false;
+        rgsl_mutex_destroy(&rgsl_log_mutex);
+    }
+}
+
+bool rgsl_log_open_json(const char* path) {
+    if (strcmp(path, "-") == 0) {
+        rgsl_log_json = stdout;
+        return true;
+    }
+    FILE* file = NULL;
+    fopen_s(&file, path, "w");
+    if (file == NULL) {
+        rgsl_printf_error("Failed to open log file: %s\n", path);
+        return false;
+    }
+    rgsl_log_json = file;
+    return true;
+}
+
+static void rgsl_log_lock() {
+    if (rgsl_log_ready) {
+        rgsl_mutex_lock(&rgsl_log_mutex);
+    }
+}
+
+static void rgsl_log_unlock() {
+    if (rgsl_log_ready) {
+        rgsl_mutex_unlock(&rgsl_log_mutex);
+    }
+}
+
+static void rgsl_append_json_string(struct rgsl_text* text, const char* str, size_t length, bool lower) {
+    rgsl_text_append(text, "\"", 1);
+    for (size_t i = 0; i < length; i++) {
+        unsigned char c = (unsigned char)str[i];
+        if (c == '"' || c == '\\') {
+            char escaped[2] = {'\\', (char)c};
+            rgsl_text_append(text, escaped, 2);
+        } else if (c == '\n') {
+            rgsl_text_append(text, "\\n", 2);
+        } else if (c == '\t') {
+            rgsl_text_append(text, "\\t", 2);
+        } else if (c < 0x20) {
+            rgsl_text_printf(text, "\\u%04x", c);
+        } else {
+            char plain = lower ? (char)tolower(c) : (char)c;
+            rgsl_text_append(text, &plain, 1);
+        }
+    }
+    rgsl_text_append(text, "\"", 1);
+}
+
+// One object per line: {"time_ms": 12.500, "level": "info", "shader": "main.vs", "message": "..."}
+static void rgsl_append_json_line(struct rgsl_text* text, const char* prefix, const char* message, size_t length) {
+    while (length > 0 && (message[length - 1] == '\n' || message[length - 1] == '\r')) {
+        length--;
+    }
+    rgsl_text_printf(text, "{\"time_ms\": %.3f, \"level\": ", rgsl_clock_elapsed_ms(rgsl_log_start));
+    rgsl_append_json_string(text, prefix, strlen(prefix), true);
+    rgsl_text_append(text, ", \"shader\": ", 12);
+    if (rgsl_log_scope.shader != NULL) {
+        rgsl_append_json_string(text, rgsl_log_scope.shader, strlen(rgsl_log_scope.shader), false);
+    } else {
+        rgsl_text_append(text, "null", 4);
+    }
+    rgsl_text_append(text, ", \"message\": ", 13);
+    rgsl_append_json_string(text, message, length, false);
+    rgsl_text_append(text, "}\n", 2);
+}
+
+static void rgsl_log_end_record(int channel) {
+    // Consecutive messages of a channel make one record.
+    struct rgsl_log_scope* scope = &rgsl_log_scope;
+    if (scope->record_count > 0 && scope->records[scope->record_count - 1].channel == channel) {
+        scope->records[scope->record_count - 1].end = scope->messages.length;
+        return;
+    }
+    if (scope->record_count == scope->record_capacity) {
+        scope->record_capacity = (scope->record_capacity == 0) ? 8 : scope->record_capacity * 2;
+        scope->records = (struct rgsl_log_record*)rgsl_realloc(scope->records, scope->record_capacity * sizeof(struct rgsl_log_record));
+    }
+    scope->records[scope->record_count].channel = channel;
+    scope->records[scope->record_count].end = scope->messages.length;
+    scope->record_count++;
+}
+
+static void rgsl_log_write(FILE* stream, const char* prefix, const char* message, size_t length) {
+    int channel = (stream == stderr) ? 1 : 0;
+    if (rgsl_log_json != NULL) {
+        // JSON lines go to their own file, in one channel keeping their order.
+        if (rgsl_log_scope.depth > 0) {
+            rgsl_append_json_line(&rgsl_log_scope.messages, prefix, message, length);
+            rgsl_log_end_record(0);
+            return;
+        }
+        struct rgsl_text line = {0};
+        rgsl_append_json_line(&line, prefix, message, length);
+        rgsl_log_lock();
+        fwrite(line.data, 1, line.length, rgsl_log_json);
+        fflush(rgsl_log_json);
+        rgsl_log_unlock();
+        rgsl_text_free(&line);
+        return;
+    }
+    if (rgsl_log_scope.depth > 0) {
+        struct rgsl_text* text = &rgsl_log_scope.messages;
+        rgsl_text_printf(text, "[RGSL %s] ", prefix);
+        rgsl_text_append(text, message, length);
+        rgsl_log_end_record(channel);
+        return;
+    }
+    rgsl_log_lock();
+    fprintf(stream, "[RGSL %s] %.*s", prefix, (int)length, message);
+    rgsl_log_unlock();
+}
+
+void rgsl_log_begin_shader(const char* shader) {
+    if (rgsl_log_scope.depth++ == 0) {
+        rgsl_log_scope.shader = shader;
+    }
+}
+
+void rgsl_log_end_shader() {
+    if (rgsl_log_scope.depth == 0 || --rgsl_log_scope.depth > 0) {
+        return;
+    }
+    struct rgsl_log_scope* scope = &rgsl_log_scope;
+    if (scope->record_count > 0) {
+        // Replayed in order, so the errors stay between the messages around them.
+        FILE* streams[2] = {rgsl_log_json != NULL ? rgsl_log_json : stdout, stderr};
+        size_t start = 0;
+        rgsl_log_lock();
+        for (size_t i = 0; i < scope->record_count; i++) {
+            FILE* stream = streams[scope->records[i].channel];
+            fwrite(scope->messages.data + start, 1, scope->records[i].end - start, stream);
+            fflush(stream);
+            start = scope->records[i].end;
+        }
+        rgsl_log_unlock();
+    }
+    rgsl_text_free(&scope->messages);
+    rgsl_free(scope->records);
+    scope->records = NULL;
+    scope->record_count = 0;
+    scope->record_capacity = 0;
+    scope->shader = NULL;
+}
 
 void rgsl_fprint(FILE *stream, const char* prefix, const char* message) {
-    fprintf(stream, "[RGSL %s] %s", prefix, message);
+    rgsl_log_write(stream, prefix, message, strlen(message));
 }
 
 void rgsl_format_parser(const char* format, va_list args, char** out_buffer) {
-    size_t size = 1024;
-    *out_buffer = (char *)malloc(size * sizeof(char));
     va_list args_copy;
     va_copy(args_copy, args);
-    for (int n = 0; 
-        (size_t)n < size;
-        size = (size_t)n + 1, *out_buffer = (char *)realloc(*out_buffer, size * sizeof(char))
-    ) {
-        n = vsnprintf(*out_buffer, size, format, args_copy);
-        if (n < 0) {
-            free(*out_buffer);
-            *out_buffer = NULL;
-            va_end(args_copy);
-            return;
-        }
-        if ((size_t)n < size) {
-            break;
-        }
+    int n = vsnprintf(NULL, 0, format, args_copy);
+    va_end(args_copy);
+    if (n < 0) {
+        *out_buffer = NULL;
+        return;
     }
+    *out_buffer = (char *)rgsl_malloc((size_t)n + 1);
+    va_copy(args_copy, args);
+    vsnprintf(*out_buffer, (size_t)n + 1, format, args_copy);
     va_end(args_copy);
 }
 
-void rgsl_fprintf(FILE *stream, const char* prefix, const char* format, ...) {
-    va_list args;
-    va_start(args, format);
+// Formats on the stack, and only allocates for the messages too long for it.
+static void rgsl_vfprintf(FILE *stream, const char* prefix, const char* format, va_list args) {
+    char line[RGSL_LOG_LINE_SIZE];
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int n = vsnprintf(line, sizeof(line), format, args_copy);
+    va_end(args_copy);
+    if (n < 0) {
+        return;
+    }
+    if ((size_t)n < sizeof(line)) {
+        rgsl_log_write(stream, prefix, line, (size_t)n);
+        return;
+    }
     char* buffer = NULL;
     rgsl_format_parser(format, args, &buffer);
     if (buffer != NULL) {
-        rgsl_fprint(stream, prefix, buffer);
-        free(buffer);
+        rgsl_log_write(stream, prefix, buffer, (size_t)n);
+        rgsl_free(buffer);
     }
+}
+
+void rgsl_fprintf(FILE *stream, const char* prefix, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    rgsl_vfprintf(stream, prefix, format, args);
     va_end(args);
 }
 
 void rgsl_print_info(int verbose_level, const char* message) {
-    if (rgsl_global_options.verbose >= verbose_level)
+    if (rgsl_global_options.verbose >= verbose_level) {
         rgsl_fprint(stdout, "Info", message);
+    }
 }
 
 void rgsl_printf_info(int verbose_level, const char* format, ...) {
+    // Filtered messages are never formatted.
+    if (rgsl_global_options.verbose < verbose_level) {
+        return;
+    }
     va_list args;
     va_start(args, format);
-    char* buffer = NULL;
-    rgsl_format_parser(format, args, &buffer);
-    if (buffer != NULL) {
-        rgsl_print_info(verbose_level, buffer);
-        free(buffer);
-    }
+    rgsl_vfprintf(stdout, "Info", format, args);
+    va_end(args);
+}
+
+void rgsl_print_warning(const char* message) {
+    rgsl_fprint(stderr, "Warning", message);
+}
+
+void rgsl_printf_warning(const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    rgsl_vfprintf(stderr, "Warning", format, args);
     va_end(args);
 }
 
@@ -68,11 +283,6 @@ void rgsl_print_error(const char* message) {
 void rgsl_printf_error(const char* format, ...) {
     va_list args;
     va_start(args, format);
-    char* buffer = NULL;
-    rgsl_format_parser(format, args, &buffer);
-    if (buffer != NULL) {
-        rgsl_print_error(buffer);
-        free(buffer);
-    }
+    rgsl_vfprintf(stderr, "Error", format, args);
     va_end(args);
 }
\ No newline at end of file
@@ -0,0 +1,58 @@
+#include <RGSL/text.h>
+#include <RGSL/memory.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void rgsl_text_init(struct rgsl_text* text) {
+    text->data = NULL;
+    text->length = 0;
+    text->capacity = 0;
+}
+
+void rgsl_text_free(struct rgsl_text* text) {
+    rgsl_free(text->data);
+    rgsl_text_init(text);
+}
+
+void rgsl_text_clear(struct rgsl_text* text) {
+    text->length = 0;
+    if (text->data != NULL) {
+        text->data[0] = '\0';
+    }
+}
+
+static void rgsl_text_reserve(struct rgsl_text* text, size_t length) {
+    if (text->length + length + 1 <= text->capacity) {
+        return;
+    }
+    size_t capacity = text->capacity ? text->capacity : 256;
+    while (capacity < text->length + length + 1) {
+        capacity *= 2;
+    }
+    text->data = (char*)rgsl_realloc(text->data, capacity);
+    text->capacity = capacity;
+}
+
+void rgsl_text_append(struct rgsl_text* text, const char* str, size_t length) {
+    rgsl_text_reserve(text, length);
+    memcpy(text->data + text->length, str, length);
+    text->length += length;
+    text->data[text->length] = '\0';
+}
+
+void rgsl_text_printf(struct rgsl_text* text, const char* format, ...) {
+    va_list args;
+    va_start(args, format);
+    va_list args_copy;
+    va_copy(args_copy, args);
+    int length = vsnprintf(NULL, 0, format, args_copy);
+    va_end(args_copy);
+    if (length > 0) {
+        rgsl_text_reserve(text, (size_t)length);
+        vsnprintf(text->data + text->length, (size_t)length + 1, format, args);
+        text->length += (size_t)length;
+    }
+    va_end(args);
+}
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <RGSL/thread.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+
+/**
+ * Thread entry point and argument, adapted to the signature of each platform,
+ * and the memory accounting context of the thread starting it.
+ */
+struct rgsl_thread_start {
+    void (*func)(void* user);
+    void* user;
+    struct rgsl_memory_context memory;
+};
+
+#ifdef _WIN32
+static DWORD WINAPI rgsl_thread_main(LPVOID param) {
+    struct rgsl_thread_start start = *(struct rgsl_thread_start*)param;
+    rgsl_memory_restore_context(&start.memory);
+    rgsl_free(param);
+    start.func(start.user);
+    return 0;
+}
+
+bool rgsl_thread_create(rgsl_thread* thread, void (*func)(void* user), void* user) {
+    struct rgsl_thread_start* start = (struct rgsl_thread_start*)rgsl_malloc(sizeof(struct rgsl_thread_start));
+    start->func = func;
+    start->user = user;
+    rgsl_memory_save_context(&start->memory);
+    *thread = CreateThread(NULL, 0, rgsl_thread_main, start, 0, NULL);
+    if (*thread == NULL) {
+        rgsl_free(start);
+        return false;
+    }
+    return true;
+}
+
+void rgsl_thread_join(rgsl_thread thread) {
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+}
+
+void rgsl_mutex_init(rgsl_mutex* mutex) { InitializeCriticalSection(mutex); }
+void rgsl_mutex_destroy(rgsl_mutex* mutex) { DeleteCriticalSection(mutex); }
+void rgsl_mutex_lock(rgsl_mutex* mutex) { EnterCriticalSection(mutex); }
+void rgsl_mutex_unlock(rgsl_mutex* mutex) { LeaveCriticalSection(mutex); }
+void rgsl_cond_init(rgsl_cond* cond) { InitializeConditionVariable(cond); }
+void rgsl_cond_destroy(rgsl_cond* cond) { (void)cond; }
+void rgsl_cond_wait(rgsl_cond* cond, rgsl_mutex* mutex) { SleepConditionVariableCS(cond, mutex, INFINITE); }
+void rgsl_cond_signal(rgsl_cond* cond) { WakeConditionVariable(cond); }
+void rgsl_cond_broadcast(rgsl_cond* cond) { WakeAllConditionVariable(cond); }
+#else
+static void* rgsl_thread_main(void* param) {
+    struct rgsl_thread_start start = *(struct rgsl_thread_start*)param;
+    rgsl_memory_restore_context(&start.memory);
+    rgsl_free(param);
+    start.func(start.user);
+    return NULL;
+}
+
+bool rgsl_thread_create(rgsl_thread* thread, void (*func)(void* user), void* user) {
+    struct rgsl_thread_start* start = (struct rgsl_thread_start*)rgsl_malloc(sizeof(struct rgsl_thread_start));
+    start->func = func;
+    start->user = user;
+    rgsl_memory_save_context(&start->memory);
+    if (pthread_create(thread, NULL, rgsl_thread_main, start) != 0) {
+        rgsl_free(start);
+        return false;
+    }
+    return true;
+}
+
+void rgsl_thread_join(rgsl_thread thread) {
+    pthread_join(thread, NULL);
+}
+
+void rgsl_mutex_init(rgsl_mutex* mutex) { pthread_mutex_init(mutex, NULL); }
+void rgsl_mutex_destroy(rgsl_mutex* mutex) { pthread_mutex_destroy(mutex); }
+void rgsl_mutex_lock(rgsl_mutex* mutex) { pthread_mutex_lock(mutex); }
+void rgsl_mutex_unlock(rgsl_mutex* mutex) { pthread_mutex_unlock(mutex); }
+void rgsl_cond_init(rgsl_cond* cond) { pthread_cond_init(cond, NULL); }
+void rgsl_cond_destroy(rgsl_cond* cond) { pthread_cond_destroy(cond); }
+void rgsl_cond_wait(rgsl_cond* cond, rgsl_mutex* mutex) { pthread_cond_wait(cond, mutex); }
+void rgsl_cond_signal(rgsl_cond* cond) { pthread_cond_signal(cond); }
+void rgsl_cond_broadcast(rgsl_cond* cond) { pthread_cond_broadcast(cond); }
+#endif
+
+void rgsl_queue_init(struct rgsl_queue* queue, size_t capacity) {
+    queue->items = (void**)rgsl_malloc(sizeof(void*) * capacity);
+    queue->capacity = capacity;
+    queue->head = 0;
+    queue->count = 0;
+    queue->closed = false;
+    rgsl_mutex_init(&queue->mutex);
+    rgsl_cond_init(&queue->not_empty);
+    rgsl_cond_init(&queue->not_full);
+}
+
+void rgsl_queue_free(struct rgsl_queue* queue) {
+    rgsl_cond_destroy(&queue->not_full);
+    rgsl_cond_destroy(&queue->not_empty);
+    rgsl_mutex_destroy(&queue->mutex);
+    rgsl_free(queue->items);
+    queue->items = NULL;
+}
+
+bool rgsl_queue_push(struct rgsl_queue* queue, void* item) {
+    rgsl_mutex_lock(&queue->mutex);
+    while (queue->count == queue->capacity && !queue->closed) {
+        rgsl_cond_wait(&queue->not_full, &queue->mutex);
+    }
+    bool pushed = !queue->closed;
+    if (pushed) {
+        queue->items[(queue->head + queue->count) % queue->capacity] = item;
+        queue->count++;
+        rgsl_cond_signal(&queue->not_empty);
+    }
+    rgsl_mutex_unlock(&queue->mutex);
+    return pushed;
+}
+
+bool rgsl_queue_pop(struct rgsl_queue* queue, void** out_item) {
+    rgsl_mutex_lock(&queue->mutex);
+    while (queue->count == 0 && !queue->closed) {
+        rgsl_cond_wait(&queue->not_empty, &queue->mutex);
+    }
+    bool popped = queue->count > 0;
+    if (popped) {
+        *out_item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        rgsl_cond_signal(&queue->not_full);
+    }
+    rgsl_mutex_unlock(&queue->mutex);
+    return popped;
+}
+
+void rgsl_queue_close(struct rgsl_queue* queue) {
+    rgsl_mutex_lock(&queue->mutex);
+    queue->closed = true;
+    rgsl_cond_broadcast(&queue->not_empty);
+    rgsl_cond_broadcast(&queue->not_full);
+    rgsl_mutex_unlock(&queue->mutex);
+}
\ No newline at end of file
@@ -0,0 +1,345 @@
+#include <RGSL/usage.h>
+#include <RGSL/rgsl.h>
+#include <RGSL/manifest.h>
+#include <RGSL/fileio.h>
+#include <RGSL/termio.h>
+#include <RGSL/memory.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdio.h>
+
+// Pages of the package as the engine maps them, the usual size of a virtual memory page.
+#define RGSL_USAGE_PAGE_SIZE 4096
+
+static struct rgsl_usage_profile usage_profile;
+static bool usage_profile_loaded = false;
+
+/**
+ * A shader to order, with its entry in the profile and its previous position.
+ */
+struct rgsl_usage_rank {
+    const struct rgsl_usage_entry* entry;
+    bool startup;
+    size_t index;
+};
+
+bool rgsl_check_usage_profile() {
+    if (rgsl_global_options.usage_profile == NULL) {
+        return true;
+    }
+    if (rgsl_global_options.startup_time < 0) {
+        rgsl_printf_error("Invalid --startup-time %d, expected milliseconds\n", rgsl_global_options.startup_time);
+        return false;
+    }
+    if (!rgsl_usage_profile_load(&usage_profile, rgsl_global_options.usage_profile)) {
+        rgsl_usage_profile_free(&usage_profile);
+        return false;
+    }
+    usage_profile.startup_ms = (double)rgsl_global_options.startup_time;
+    usage_profile_loaded = true;
+    return true;
+}
+
+void rgsl_usage_profile_finalize() {
+    if (usage_profile_loaded) {
+        rgsl_usage_profile_free(&usage_profile);
+        usage_profile_loaded = false;
+    }
+}
+
+struct rgsl_usage_profile* rgsl_global_usage_profile() {
+    return usage_profile_loaded ? &usage_profile : NULL;
+}
+
+bool rgsl_cold_split_enabled() {
+    return rgsl_global_options.split_cold != 0;
+}
+
+static bool rgsl_parse_usage_line(struct rgsl_usage_profile* profile, const char* path, size_t line_number, char** arguments, size_t count, size_t* capacity) {
+    if (count != 3) {
+        rgsl_printf_error("%s:%zu: expected a shader, its first use in milliseconds and its number of uses\n", path, line_number);
+        return false;
+    }
+    char* end = NULL;
+    double first_use_ms = strtod(arguments[1], &end);
+    if (*end != '\0' || first_use_ms < 0.0) {
+        rgsl_printf_error("%s:%zu: invalid first use time: %s\n", path, line_number, arguments[1]);
+        return false;
+    }
+    unsigned long long uses = strtoull(arguments[2], &end, 10);
+    if (*end != '\0' || arguments[2][0] == '-') {
+        rgsl_printf_error("%s:%zu: invalid number of uses: %s\n", path, line_number, arguments[2]);
+        return false;
+    }
+    if (rgsl_hashmap_find(&profile->index, arguments[0], NULL)) {
+        rgsl_printf_error("%s:%zu: shader %s is listed twice\n", path, line_number, arguments[0]);
+        return false;
+    }
+    if (profile->count == *capacity) {
+        *capacity = (*capacity != 0) ? *capacity * 2 : 64;
+        profile->entries = (struct rgsl_usage_entry *)rgsl_realloc(profile->entries, *capacity * sizeof(struct rgsl_usage_entry));
+    }
+    struct rgsl_usage_entry* entry = &profile->entries[profile->count++];
+    entry->name = rgsl_strdup(arguments[0]);
+    entry->first_use_ms = first_use_ms;
+    entry->uses = (size_t)uses;
+    // Indices rather than pointers, the entries move while the profile grows.
+    rgsl_hashmap_set(&profile->index, entry->name, (void*)(uintptr_t)profile->count);
+    return true;
+}
+
+bool rgsl_usage_profile_load(struct rgsl_usage_profile* profile, const char* path) {
+    profile->entries = NULL;
+    profile->count = 0;
+    profile->startup_ms = 0.0;
+    rgsl_hashmap_init(&profile->index);
+    rgsl_hashmap_init(&profile->job_order);
+
+    char* raw_content = NULL;
+    rgsl_read_file(path, &raw_content);
+    if (raw_content == NULL) {
+        rgsl_printf_error("Failed to read usage profile: %s\n", path);
+        return false;
+    }
+    char* content = rgsl_crlf_to_lf(raw_content);
+    rgsl_free_file_buffer(raw_content);
+
+    bool success = true;
+    size_t capacity = 0;
+    size_t line_number = 0;
+    for (char* line = content; success && line != NULL; ) {
+        char* line_end = strchr(line, '\n');
+        if (line_end != NULL) {
+            *line_end = '\0';
+        }
+        line_number++;
+        size_t count;
+        char** arguments = rgsl_split_arguments(line, &count);
+        if (count > 0) {
+            success = rgsl_parse_usage_line(profile, path, line_number, arguments, count, &capacity);
+        }
+        rgsl_free_arguments(arguments);
+        line = (line_end != NULL) ? line_end + 1 : NULL;
+    }
+    rgsl_free(content);
+    rgsl_printf_info(2, "Loaded the usage of %zu shaders from %s\n", profile->count, path);
+    return success;
+}
+
+void rgsl_usage_profile_free(struct rgsl_usage_profile* profile) {
+    for (size_t i = 0; i < profile->count; i++) {
+        rgsl_free(profile->entries[i].name);
+    }
+    rgsl_free(profile->entries);
+    profile->entries = NULL;
+    profile->count = 0;
+    rgsl_hashmap_free(&profile->index, NULL);
+    rgsl_hashmap_free(&profile->job_order, NULL);
+}
+
+static const struct rgsl_usage_entry* rgsl_usage_lookup(const struct rgsl_usage_profile* profile, const char* name) {
+    uintptr_t index = (uintptr_t)rgsl_hashmap_get(&profile->index, name);
+    return (index != 0) ? &profile->entries[index - 1] : NULL;
+}
+
+const struct rgsl_usage_entry* rgsl_usage_profile_find(const struct rgsl_usage_profile* profile, const char* path, const char* name) {
+    const struct rgsl_usage_entry* entry = (path != NULL) ? rgsl_usage_lookup(profile, path) : NULL;
+    if (entry != NULL || name == NULL) {
+        return entry;
+    }
+    // The engine knows the shaders by the name of their blobs.
+    size_t length = strlen(name) + 8;
+    char* blob_name = (char *)rgsl_malloc(length);
+    snprintf(blob_name, length, "shader_%s", name);
+    entry = rgsl_usage_lookup(profile, blob_name);
+    rgsl_free(blob_name);
+    return (entry != NULL) ? entry : rgsl_usage_lookup(profile, name);
+}
+
+static bool rgsl_usage_entry_is_startup(const struct rgsl_usage_profile* profile, const struct rgsl_usage_entry* entry) {
+    return entry != NULL && (profile->startup_ms == 0.0 || entry->first_use_ms <= profile->startup_ms);
+}
+
+bool rgsl_usage_is_startup(const struct rgsl_usage_profile* profile, const char* path, const char* name) {
+    return rgsl_usage_entry_is_startup(profile, rgsl_usage_profile_find(profile, path, name));
+}
+
+static int rgsl_compare_usage_entries(const struct rgsl_usage_entry* a, const struct rgsl_usage_entry* b) {
+    if (a->first_use_ms != b->first_use_ms) {
+        return (a->first_use_ms < b->first_use_ms) ? -1 : 1;
+    }
+    if (a->uses != b->uses) {
+        return (a->uses > b->uses) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int rgsl_compare_usage_ranks(const void* a, const void* b) {
+    const struct rgsl_usage_rank* rank_a = (const struct rgsl_usage_rank*)a;
+    const struct rgsl_usage_rank* rank_b = (const struct rgsl_usage_rank*)b;
+    int class_a = rank_a->startup ? 0 : (rank_a->entry != NULL) ? 1 : 2;
+    int class_b = rank_b->startup ? 0 : (rank_b->entry != NULL) ? 1 : 2;
+    if (class_a != class_b) {
+        return class_a - class_b;
+    }
+    if (class_a < 2) {
+        int order = rgsl_compare_usage_entries(rank_a->entry, rank_b->entry);
+        if (order != 0) {
+            return order;
+        }
+    }
+    // qsort is not stable, the previous order breaks the ties.
+    return (rank_a->index < rank_b->index) ? -1 : (rank_a->index > rank_b->index) ? 1 : 0;
+}
+
+void rgsl_usage_order(struct rgsl_usage_profile* profile, const char* const* paths, const char* const* names, size_t count, size_t* out_order) {
+    struct rgsl_usage_rank* ranks = (struct rgsl_usage_rank *)rgsl_malloc((count > 0 ? count : 1) * sizeof(struct rgsl_usage_rank));
+    size_t startup_count = 0;
+    for (size_t i = 0; i < count; i++) {
+        ranks[i].entry = rgsl_usage_profile_find(profile, paths[i], names[i]);
+        ranks[i].startup = rgsl_usage_entry_is_startup(profile, ranks[i].entry);
+        ranks[i].index = i;
+        startup_count += ranks[i].startup ? 1 : 0;
+        if (!rgsl_hashmap_find(&profile->job_order, paths[i], NULL)) {
+            rgsl_hashmap_set(&profile->job_order, paths[i], (void*)(uintptr_t)(i + 1));
+        }
+    }
+    qsort(ranks, count, sizeof(struct rgsl_usage_rank), rgsl_compare_usage_ranks);
+    for (size_t i = 0; i < count; i++) {
+        out_order[i] = ranks[i].index;
+    }
+    rgsl_free(ranks);
+    rgsl_printf_info(2, "Ordered %zu shaders by first use, %zu of them used at startup\n", count, startup_count);
+}
+
+/**
+ * Offsets of the blobs of a layout, blobs sharing their content sharing their offset.
+ * The cold part starts on a page of its own, as it is another file.
+ */
+static size_t rgsl_usage_layout(const struct rgsl_usage_blob* blobs, const size_t* order, size_t count, bool parts, size_t* offsets) {
+    struct rgsl_hashmap placed;
+    rgsl_hashmap_init(&placed);
+    size_t part_sizes[2] = {0, 0};
+    for (size_t pass = 0; pass < 2; pass++) {
+        for (size_t i = 0; i < count; i++) {
+            const struct rgsl_usage_blob* blob = &blobs[order[i]];
+            size_t part = (parts && blob->cold) ? 1 : 0;
+            if (part != pass) {
+                continue;
+            }
+            char key[36];
+            snprintf(key, sizeof(key), "%zu%016llx%016llx", part, (unsigned long long)blob->content_hash.low, (unsigned long long)blob->content_hash.high);
+            uintptr_t offset = (uintptr_t)rgsl_hashmap_get(&placed, key);
+            if (offset == 0) {
+                size_t base = (part == 1) ? (part_sizes[0] + RGSL_USAGE_PAGE_SIZE - 1) / RGSL_USAGE_PAGE_SIZE * RGSL_USAGE_PAGE_SIZE : 0;
+                offset = (uintptr_t)(base + part_sizes[part]) + 1;
+                part_sizes[part] += blob->size;
+                rgsl_hashmap_set(&placed, key, (void*)offset);
+            }
+            offsets[order[i]] = (size_t)offset - 1;
+        }
+    }
+    rgsl_hashmap_free(&placed, NULL);
+    size_t base = (part_sizes[0] + RGSL_USAGE_PAGE_SIZE - 1) / RGSL_USAGE_PAGE_SIZE * RGSL_USAGE_PAGE_SIZE;
+    return (part_sizes[1] > 0) ? base + part_sizes[1] : part_sizes[0];
+}
+
+// Touches the blobs of each shader in order of first use, counting the pages not resident yet.
+static void rgsl_usage_replay(const struct rgsl_usage_profile* profile, const struct rgsl_usage_entry** trace, const struct rgsl_usage_blob* blobs, const size_t* offsets, size_t count, size_t size, size_t* out_startup, size_t* out_total) {
+    size_t page_count = size / RGSL_USAGE_PAGE_SIZE + 1;
+    bool* resident = (bool *)rgsl_calloc(page_count, sizeof(bool));
+    *out_startup = 0;
+    *out_total = 0;
+    for (size_t t = 0; t < profile->count; t++) {
+        bool startup = rgsl_usage_entry_is_startup(profile, trace[t]);
+        for (size_t i = 0; i < count; i++) {
+            if (blobs[i].size == 0 || rgsl_usage_profile_find(profile, blobs[i].path, blobs[i].name) != trace[t]) {
+                continue;
+            }
+            size_t last = (offsets[i] + blobs[i].size - 1) / RGSL_USAGE_PAGE_SIZE;
+            for (size_t page = offsets[i] / RGSL_USAGE_PAGE_SIZE; page <= last; page++) {
+                if (!resident[page]) {
+                    resident[page] = true;
+                    *out_total += 1;
+                    *out_startup += startup ? 1 : 0;
+                }
+            }
+        }
+    }
+    rgsl_free(resident);
+}
+
+static int rgsl_compare_trace_entries(const void* a, const void* b) {
+    return rgsl_compare_usage_entries(*(const struct rgsl_usage_entry* const*)a, *(const struct rgsl_usage_entry* const*)b);
+}
+
+/**
+ * A blob in the order of the command line: the position of its job, then its own.
+ */
+struct rgsl_usage_job_key {
+    size_t job;
+    size_t blob;
+};
+
+static int rgsl_compare_job_keys(const void* a, const void* b) {
+    const struct rgsl_usage_job_key* key_a = (const struct rgsl_usage_job_key*)a;
+    const struct rgsl_usage_job_key* key_b = (const struct rgsl_usage_job_key*)b;
+    if (key_a->job != key_b->job) {
+        return (key_a->job < key_b->job) ? -1 : 1;
+    }
+    return (key_a->blob < key_b->blob) ? -1 : (key_a->blob > key_b->blob) ? 1 : 0;
+}
+
+// Order of the blobs had the shaders been packaged in the order of the command line.
+static void rgsl_usage_job_order(const struct rgsl_usage_profile* profile, const struct rgsl_usage_blob* blobs, size_t count, size_t* out_order) {
+    struct rgsl_usage_job_key* keys = (struct rgsl_usage_job_key *)rgsl_malloc(count * sizeof(struct rgsl_usage_job_key));
+    for (size_t i = 0; i < count; i++) {
+        uintptr_t job = (uintptr_t)rgsl_hashmap_get(&profile->job_order, blobs[i].path);
+        keys[i].job = (job != 0) ? (size_t)job : SIZE_MAX;
+        keys[i].blob = i;
+    }
+    qsort(keys, count, sizeof(struct rgsl_usage_job_key), rgsl_compare_job_keys);
+    for (size_t i = 0; i < count; i++) {
+        out_order[i] = keys[i].blob;
+    }
+    rgsl_free(keys);
+}
+
+void rgsl_usage_count_faults(const struct rgsl_usage_profile* profile, const struct rgsl_usage_blob* blobs, const size_t* order, size_t count, bool parts, size_t* out_startup, size_t* out_total) {
+    *out_startup = 0;
+    *out_total = 0;
+    if (count == 0 || profile->count == 0) {
+        return;
+    }
+    const struct rgsl_usage_entry** trace = (const struct rgsl_usage_entry **)rgsl_malloc(profile->count * sizeof(struct rgsl_usage_entry*));
+    for (size_t i = 0; i < profile->count; i++) {
+        trace[i] = &profile->entries[i];
+    }
+    qsort(trace, profile->count, sizeof(struct rgsl_usage_entry*), rgsl_compare_trace_entries);
+    size_t* offsets = (size_t *)rgsl_malloc(count * sizeof(size_t));
+    size_t size = rgsl_usage_layout(blobs, order, count, parts, offsets);
+    rgsl_usage_replay(profile, trace, blobs, offsets, count, size, out_startup, out_total);
+    rgsl_free(offsets);
+    rgsl_free(trace);
+}
+
+void rgsl_usage_simulate_faults(const struct rgsl_usage_profile* profile, const struct rgsl_usage_blob* blobs, size_t count) {
+    if (count == 0 || profile->count == 0) {
+        return;
+    }
+    size_t* order = (size_t *)rgsl_malloc(count * sizeof(size_t));
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    size_t startup, total;
+    rgsl_usage_count_faults(profile, blobs, order, count, true, &startup, &total);
+
+    // The baseline is a single file, as packaged without a profile.
+    rgsl_usage_job_order(profile, blobs, count, order);
+    size_t baseline_startup, baseline_total;
+    rgsl_usage_count_faults(profile, blobs, order, count, false, &baseline_startup, &baseline_total);
+
+    rgsl_printf_info(1, "Startup faults in %zu pages of %d bytes (%zu for the whole profile), instead of %zu (%zu) in command-line order\n", startup, RGSL_USAGE_PAGE_SIZE, total, baseline_startup, baseline_total);
+    rgsl_free(order);
+}
\ No newline at end of file
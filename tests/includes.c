@@ -0,0 +1,248 @@
+#include <RGSL/rgsl.h>
+#include <RGSL/compile.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/fileio.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Compiles shaders including files, nested and more than once, with the includes
+ * spliced by RGSL and left to glslang with --native-includes, and checks that
+ * both give the same SPIR-V and report errors at the same file and line.
+ */
+struct rgsl_include_file {
+    const char* path;
+    const char* content;
+};
+
+static const struct rgsl_include_file INCLUDE_FILES[] = {
+    {"includes_constants.glsl",
+        "#ifndef INCLUDES_CONSTANTS\n"
+        "#define INCLUDES_CONSTANTS\n"
+        "const float PI = 3.14159265;\n"
+        "#endif\n"},
+    {"includes_math.glsl",
+        "#ifndef INCLUDES_MATH\n"
+        "#define INCLUDES_MATH\n"
+        "#include \"includes_constants.glsl\"\n"
+        "float wrap_angle(float angle) {\n"
+        "    return mod(angle, 2.0 * PI);\n"
+        "}\n"
+        "#endif\n"},
+    {"includes_lighting.glsl",
+        "#ifndef INCLUDES_LIGHTING\n"
+        "#define INCLUDES_LIGHTING\n"
+        "#include \"includes_constants.glsl\"\n"
+        "#include \"includes_math.glsl\"\n"
+        "float lambert(vec3 normal, vec3 light) {\n"
+        "    return max(dot(normal, light), 0.0) / PI;\n"
+        "}\n"
+        "#endif\n"},
+    {"includes_broken.glsl",
+        "#include \"includes_constants.glsl\"\n"
+        "float broken() {\n"
+        "    return PI * undefined_value;\n"
+        "}\n"},
+    {"includes_main.frag",
+        "#version 450\n"
+        "#include \"includes_math.glsl\"\n"
+        "#include \"includes_lighting.glsl\"\n"
+        "layout(location = 0) in vec3 normal;\n"
+        "layout(location = 0) out vec4 color;\n"
+        "void main() {\n"
+        "    color = vec4(vec3(lambert(normalize(normal), vec3(0.0, 0.0, 1.0))), wrap_angle(PI));\n"
+        "}\n"},
+    {"includes_error_main.frag",
+        "#version 450\n"
+        "#include \"includes_lighting.glsl\"\n"
+        "layout(location = 0) out vec4 color;\n"
+        "void main() {\n"
+        "    color = vec4(lambert(vec3(undefined_value), vec3(1.0)));\n"
+        "}\n"},
+    {"includes_error_include.frag",
+        "#version 450\n"
+        "#include \"includes_math.glsl\"\n"
+        "#include \"includes_broken.glsl\"\n"
+        "layout(location = 0) out vec4 color;\n"
+        "void main() {\n"
+        "    color = vec4(broken());\n"
+        "}\n"},
+};
+
+struct rgsl_include_error_case {
+    const char* shader;
+    const char* file;
+    int line;
+};
+
+static const struct rgsl_include_error_case INCLUDE_ERROR_CASES[] = {
+    {"includes_error_main.frag", "includes_error_main.frag", 5},
+    {"includes_error_include.frag", "includes_broken.glsl", 3},
+};
+
+static bool rgsl_write_include_files() {
+    size_t count = sizeof(INCLUDE_FILES) / sizeof(INCLUDE_FILES[0]);
+    for (size_t i = 0; i < count; i++) {
+        if (!rgsl_write_file(INCLUDE_FILES[i].path, INCLUDE_FILES[i].content, strlen(INCLUDE_FILES[i].content))) {
+            fprintf(stderr, "Failed to write %s\n", INCLUDE_FILES[i].path);
+            return false;
+        }
+    }
+    return true;
+}
+
+static void rgsl_remove_include_files() {
+    size_t count = sizeof(INCLUDE_FILES) / sizeof(INCLUDE_FILES[0]);
+    for (size_t i = 0; i < count; i++) {
+        remove(INCLUDE_FILES[i].path);
+    }
+}
+
+static void rgsl_load_include_shader(const char* path, struct rgsl_shader_data* shader) {
+    memset(shader, 0, sizeof(*shader));
+    shader->name = rgsl_determine_shader_name(path);
+    shader->path = path;
+    shader->language = "glsl";
+    shader->stage = "frag";
+    for (size_t i = 0; i < sizeof(INCLUDE_FILES) / sizeof(INCLUDE_FILES[0]); i++) {
+        if (strcmp(INCLUDE_FILES[i].path, path) == 0) {
+            shader->code = rgsl_strdup(INCLUDE_FILES[i].content);
+        }
+    }
+}
+
+// Debug instructions name the sources and the include extension, which differ between the two modes.
+static bool rgsl_is_debug_instruction(uint32_t opcode) {
+    return (opcode >= 2 && opcode <= 8) || opcode == 317 || opcode == 330;
+}
+
+static bool rgsl_same_spirv(const uint32_t* first, size_t first_count, const uint32_t* second, size_t second_count) {
+    // The header is skipped, the bound of the IDs included; the instructions must be the same.
+    size_t i = 5;
+    size_t j = 5;
+    while (i < first_count && j < second_count) {
+        size_t first_length = first[i] >> 16;
+        size_t second_length = second[j] >> 16;
+        if (first_length == 0 || second_length == 0 || i + first_length > first_count || j + second_length > second_count) {
+            return first_count - i == second_count - j && memcmp(first + i, second + j, (first_count - i) * sizeof(uint32_t)) == 0;
+        }
+        if (rgsl_is_debug_instruction(first[i] & 0xFFFF)) {
+            i += first_length;
+        } else if (rgsl_is_debug_instruction(second[j] & 0xFFFF)) {
+            j += second_length;
+        } else if (first_length != second_length || memcmp(first + i, second + j, first_length * sizeof(uint32_t)) != 0) {
+            return false;
+        } else {
+            i += first_length;
+            j += second_length;
+        }
+    }
+    while (i < first_count && (first[i] >> 16) != 0 && rgsl_is_debug_instruction(first[i] & 0xFFFF)) {
+        i += first[i] >> 16;
+    }
+    while (j < second_count && (second[j] >> 16) != 0 && rgsl_is_debug_instruction(second[j] & 0xFFFF)) {
+        j += second[j] >> 16;
+    }
+    return i >= first_count && j >= second_count;
+}
+
+static bool rgsl_compile_include_shader(const char* path, bool native_includes, char** out_words, size_t* out_size) {
+    rgsl_global_options.native_includes = native_includes;
+    struct rgsl_shader_data shader;
+    rgsl_load_include_shader(path, &shader);
+    bool success = rgsl_compile_shader(&shader, out_words, out_size);
+    rgsl_release_shader(&shader);
+    return success;
+}
+
+static int rgsl_check_include_output() {
+    char* spliced = NULL;
+    char* native = NULL;
+    size_t spliced_size = 0;
+    size_t native_size = 0;
+    int failures = 0;
+    if (!rgsl_compile_include_shader("includes_main.frag", false, &spliced, &spliced_size) ||
+        !rgsl_compile_include_shader("includes_main.frag", true, &native, &native_size)) {
+        fprintf(stderr, "FAIL: includes_main.frag does not compile in both modes\n");
+        failures++;
+    } else if (!rgsl_same_spirv((const uint32_t *)spliced, spliced_size / sizeof(uint32_t), (const uint32_t *)native, native_size / sizeof(uint32_t))) {
+        fprintf(stderr, "FAIL: includes_main.frag compiles to other SPIR-V with --native-includes\n");
+        failures++;
+    }
+    rgsl_free_file_buffer(spliced);
+    rgsl_free_file_buffer(native);
+    return failures;
+}
+
+// Returns the "<file>:<line>" of the first error of the log, or NULL.
+static char* rgsl_first_error_location(const char* log) {
+    const char* error = log != NULL ? strstr(log, "ERROR: ") : NULL;
+    if (error == NULL) {
+        return NULL;
+    }
+    const char* start = error + strlen("ERROR: ");
+    const char* end = strstr(start, ": ");
+    if (end == NULL) {
+        return NULL;
+    }
+    size_t length = (size_t)(end - start);
+    char* location = (char *)rgsl_malloc(length + 1);
+    memcpy(location, start, length);
+    location[length] = '\0';
+    return location;
+}
+
+static char* rgsl_include_error_location(const char* path, bool native_includes) {
+    rgsl_global_options.native_includes = native_includes;
+    struct rgsl_shader_data shader;
+    rgsl_load_include_shader(path, &shader);
+    char* log = NULL;
+    char* location = NULL;
+    if (!rgsl_glsl_build_program(&shader, &log)) {
+        location = rgsl_first_error_location(log);
+    }
+    rgsl_free(log);
+    rgsl_release_shader(&shader);
+    return location;
+}
+
+static int rgsl_check_include_error(const struct rgsl_include_error_case* test) {
+    char* spliced = rgsl_include_error_location(test->shader, false);
+    char* native = rgsl_include_error_location(test->shader, true);
+    char expected[256];
+    snprintf(expected, sizeof(expected), "%s:%d", test->file, test->line);
+    int failures = 0;
+    // The resolver may prefix the directory of the includer, only the end of the location is compared.
+    size_t expected_length = strlen(expected);
+    bool spliced_matches = spliced != NULL && strlen(spliced) >= expected_length && strcmp(spliced + strlen(spliced) - expected_length, expected) == 0;
+    if (!spliced_matches || native == NULL || strcmp(spliced, native) != 0) {
+        fprintf(stderr, "FAIL: %s reports its error at %s when spliced, %s with --native-includes, expected %s\n", test->shader,
+            spliced != NULL ? spliced : "(none)", native != NULL ? native : "(none)", expected);
+        failures++;
+    }
+    rgsl_free(spliced);
+    rgsl_free(native);
+    return failures;
+}
+
+int main() {
+    rgsl_initialize();
+    rgsl_global_options.verbose = 0;
+    rgsl_global_options.action = RGSL_ACTION_COMPILE_SPIRV;
+    rgsl_glslang_initialize();
+    if (!rgsl_write_include_files()) {
+        rgsl_remove_include_files();
+        return 1;
+    }
+    int failures = rgsl_check_include_output();
+    size_t case_count = sizeof(INCLUDE_ERROR_CASES) / sizeof(INCLUDE_ERROR_CASES[0]);
+    for (size_t i = 0; i < case_count; i++) {
+        failures += rgsl_check_include_error(&INCLUDE_ERROR_CASES[i]);
+    }
+    rgsl_remove_include_files();
+    rgsl_glslang_finalize();
+    printf("%zu include cases, %d failed\n", case_count + 1, failures);
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
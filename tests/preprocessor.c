@@ -0,0 +1,128 @@
+#include <RGSL/rgsl.h>
+#include <RGSL/glsl/parser.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Regression cases of the conditional evaluator, each checked against glslang.
+ * The evaluator may leave a conditional to glslang, but a conditional it decides
+ * must take the branch glslang takes, and one glslang rejects must be left to it.
+ */
+struct rgsl_conditional_case {
+    const char* version;
+    const char* prologue;
+    const char* expression;
+};
+
+static const struct rgsl_conditional_case CONDITIONAL_CASES[] = {
+    {"330 core", "", "1 + 2 * 3 == 7"},
+    {"330 core", "", "-1 < 0 && (7 >> 1) == 3 && 5 % 3 == 2"},
+    {"330 core", "", "1 ? 0 : 1"},
+    {"330 core", "#define A 4\n#define B A * 2\n", "B == 8"},
+    {"330 core", "#define A\n#undef A\n", "defined(A)"},
+    {"330 core", "", "UNDEFINED == 0"},
+    {"330 core", "", "defined(GL_core_profile) && __VERSION__ >= 330"},
+    {"330 core", "", "defined GL_ES"},
+    {"330 core", "#define X 2 /* two */\n", "X == 2 /* comment */ && 1"},
+    {"330 core", "/*\n#if 0\n#endif\n#endif\n*/\n", "1"},
+    {"330 core", "/* #if 0 */\n", "0"},
+    {"330 core", "#if 1 /* open\n#else */\n#endif\n", "1"},
+    {"330 core", "#define A 1 // #if 0\n", "A"},
+    {"300 es", "", "GL_ES == 1 && __VERSION__ == 300"},
+    {"300 es", "", "UNDEFINED"},
+    {"300 es", "", "UNDEFINED == 0"},
+    {"300 es", "#define A 1\n", "A || UNDEFINED"},
+    {"100", "", "defined(GL_ES) && GL_ES"},
+};
+
+enum rgsl_case_result {
+    RGSL_CASE_FALSE,
+    RGSL_CASE_TRUE,
+    RGSL_CASE_KEPT,
+    RGSL_CASE_ERROR
+};
+
+static const char* const CASE_RESULT_NAMES[] = {"false", "true", "left to glslang", "error"};
+
+static char* rgsl_write_case(const struct rgsl_conditional_case* test, bool true_branch, bool false_branch) {
+    // Each branch holding an #error can be told apart: glslang fails on it, RGSL keeps it.
+    size_t length = strlen(test->version) + strlen(test->prologue) + strlen(test->expression) + 128;
+    char* code = (char *)rgsl_malloc(length);
+    snprintf(code, length, "#version %s\n%s#if %s\n%s#else\n%s#endif\nvoid main() {}\n",
+        test->version, test->prologue, test->expression,
+        true_branch ? "#error rgsl_true_branch\n" : "",
+        false_branch ? "#error rgsl_false_branch\n" : "");
+    return code;
+}
+
+static enum rgsl_case_result rgsl_evaluate_with_rgsl(const struct rgsl_conditional_case* test) {
+    struct rgsl_shader_data shader;
+    memset(&shader, 0, sizeof(shader));
+    shader.name = "case";
+    shader.language = "glsl";
+    shader.stage = "frag";
+    shader.code = rgsl_write_case(test, true, true);
+    enum rgsl_case_result result = RGSL_CASE_ERROR;
+    if (rgsl_glsl_preprocess_shader(&shader, false)) {
+        bool true_branch = strstr(shader.processed_code, "rgsl_true_branch") != NULL;
+        bool false_branch = strstr(shader.processed_code, "rgsl_false_branch") != NULL;
+        if (true_branch && false_branch) {
+            result = RGSL_CASE_KEPT;
+        } else if (true_branch || false_branch) {
+            result = true_branch ? RGSL_CASE_TRUE : RGSL_CASE_FALSE;
+        }
+    }
+    rgsl_release_shader_intermediates(&shader);
+    rgsl_free(shader.code);
+    return result;
+}
+
+static bool rgsl_compiles_with_glslang(const char* code) {
+    char* log = NULL;
+    struct rgsl_glslang_program* program = rgsl_glslang_create_program(code, "case", "frag", false, false, &log);
+    rgsl_free(log);
+    if (program == NULL) {
+        return false;
+    }
+    rgsl_glslang_destroy_program(program);
+    return true;
+}
+
+static enum rgsl_case_result rgsl_evaluate_with_glslang(const struct rgsl_conditional_case* test) {
+    char* true_code = rgsl_write_case(test, false, true);
+    char* false_code = rgsl_write_case(test, true, false);
+    enum rgsl_case_result result = RGSL_CASE_ERROR;
+    if (rgsl_compiles_with_glslang(true_code)) {
+        result = RGSL_CASE_TRUE;
+    } else if (rgsl_compiles_with_glslang(false_code)) {
+        result = RGSL_CASE_FALSE;
+    }
+    rgsl_free(true_code);
+    rgsl_free(false_code);
+    return result;
+}
+
+int main() {
+    rgsl_initialize();
+    rgsl_global_options.verbose = 0;
+    rgsl_glslang_initialize();
+    int failures = 0;
+    size_t case_count = sizeof(CONDITIONAL_CASES) / sizeof(CONDITIONAL_CASES[0]);
+    for (size_t i = 0; i < case_count; i++) {
+        const struct rgsl_conditional_case* test = &CONDITIONAL_CASES[i];
+        enum rgsl_case_result expected = rgsl_evaluate_with_glslang(test);
+        enum rgsl_case_result result = rgsl_evaluate_with_rgsl(test);
+        // Leaving a conditional to glslang is never wrong, only slower.
+        bool passed = (result == RGSL_CASE_KEPT) || (result == expected && result != RGSL_CASE_ERROR);
+        if (!passed) {
+            fprintf(stderr, "FAIL: #version %s, #if %s: glslang %s, RGSL %s\n", test->version, test->expression,
+                CASE_RESULT_NAMES[expected], CASE_RESULT_NAMES[result]);
+            failures++;
+        }
+    }
+    rgsl_glslang_finalize();
+    printf("%zu conditional cases, %d failed\n", case_count, failures);
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
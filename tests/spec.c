@@ -0,0 +1,127 @@
+#include <RGSL/rgsl.h>
+#include <RGSL/compile.h>
+#include <RGSL/spec.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Compiles each value of a macro once with -D NAME=VALUE and once with
+ * --spec-constant NAME, and checks that both are valid SPIR-V with the same
+ * interface, that the specialization holds the value of the macro, and that
+ * the specialized variants share one module.
+ */
+static const char* const SPEC_SHADER =
+    "#version 450\n"
+    "layout(location = 0) in vec2 uv;\n"
+    "layout(location = 0) out vec4 color;\n"
+    "layout(binding = 0) uniform sampler2D image;\n"
+    "void main() {\n"
+    "    vec4 texel = texture(image, uv);\n"
+    "    color = (MODE == 0) ? texel : texel * float(MODE);\n"
+    "}\n";
+
+static const char* const SPEC_VALUES[] = {"0", "1", "3"};
+
+// The default of the constant is not one of the values, so that they all come from the specialization.
+static const char* SPEC_CONSTANTS[] = {"MODE=2", NULL};
+
+struct rgsl_spec_variant {
+    char* words;
+    size_t size;
+    struct rgsl_hash128 interface_hash;
+    struct rgsl_specialization* specializations;
+    size_t specialization_count;
+};
+
+static bool rgsl_compile_variant(const char* value, bool promoted, struct rgsl_spec_variant* out_variant) {
+    char define[32];
+    snprintf(define, sizeof(define), "MODE=%s", value);
+    const char* defines[] = {define, NULL};
+    rgsl_global_options.spec_constants = promoted ? SPEC_CONSTANTS : NULL;
+
+    struct rgsl_shader_data shader;
+    memset(&shader, 0, sizeof(shader));
+    shader.name = rgsl_determine_shader_name("spec.frag");
+    shader.path = "spec.frag";
+    shader.code = rgsl_strdup(SPEC_SHADER);
+    shader.language = "glsl";
+    shader.stage = "frag";
+    shader.defines = defines;
+    memset(out_variant, 0, sizeof(*out_variant));
+    bool success = rgsl_compile_shader(&shader, &out_variant->words, &out_variant->size);
+    out_variant->interface_hash = shader.interface_hash;
+    out_variant->specializations = shader.specializations;
+    out_variant->specialization_count = shader.specialization_count;
+    shader.specializations = NULL;
+    shader.specialization_count = 0;
+    rgsl_release_shader(&shader);
+    rgsl_global_options.spec_constants = NULL;
+    if (!success) {
+        fprintf(stderr, "FAIL: MODE=%s does not compile %s\n", value, promoted ? "as a specialization constant" : "as a macro");
+        return false;
+    }
+    char* log = rgsl_glslang_validate_spirv((const uint32_t *)out_variant->words, out_variant->size / sizeof(uint32_t), 0);
+    if (log != NULL) {
+        fprintf(stderr, "FAIL: MODE=%s is not valid SPIR-V %s:\n%s\n", value, promoted ? "as a specialization constant" : "as a macro", log);
+        rgsl_free(log);
+        return false;
+    }
+    return true;
+}
+
+static void rgsl_free_variant(struct rgsl_spec_variant* variant) {
+    rgsl_free(variant->words);
+    rgsl_free(variant->specializations);
+}
+
+static int rgsl_check_spec_value(const char* value, struct rgsl_spec_variant* first_specialized) {
+    struct rgsl_spec_variant defined, specialized;
+    bool success = rgsl_compile_variant(value, false, &defined);
+    success &= rgsl_compile_variant(value, true, &specialized);
+    int failures = success ? 0 : 1;
+    if (success && memcmp(&defined.interface_hash, &specialized.interface_hash, sizeof(struct rgsl_hash128)) != 0) {
+        fprintf(stderr, "FAIL: MODE=%s has another interface as a specialization constant\n", value);
+        failures++;
+    }
+    // The specialization is read with the type of the default, as the engine passes it.
+    rgsl_global_options.spec_constants = SPEC_CONSTANTS;
+    uint32_t expected = 0;
+    bool converted = rgsl_spec_constant_value(0, value, &expected);
+    rgsl_global_options.spec_constants = NULL;
+    if (success && (!converted || specialized.specialization_count != 1 || specialized.specializations[0].constant_id != 0 || specialized.specializations[0].value != expected)) {
+        fprintf(stderr, "FAIL: MODE=%s is not recorded as the specialization of constant 0\n", value);
+        failures++;
+    }
+    if (success && first_specialized->words == NULL) {
+        *first_specialized = specialized;
+        specialized.words = NULL;
+        specialized.specializations = NULL;
+    } else if (success && (specialized.size != first_specialized->size || memcmp(specialized.words, first_specialized->words, specialized.size) != 0)) {
+        fprintf(stderr, "FAIL: MODE=%s is not compiled to the module of the other specialized variants\n", value);
+        failures++;
+    }
+    rgsl_free_variant(&defined);
+    rgsl_free_variant(&specialized);
+    return failures;
+}
+
+int main() {
+    rgsl_initialize();
+    rgsl_global_options.verbose = 0;
+    rgsl_global_options.action = RGSL_ACTION_COMPILE_SPIRV | RGSL_ACTION_COMPILE_EMBED;
+    rgsl_glslang_initialize();
+    rgsl_compile_initialize();
+    struct rgsl_spec_variant first_specialized = {0};
+    int failures = 0;
+    size_t case_count = sizeof(SPEC_VALUES) / sizeof(SPEC_VALUES[0]);
+    for (size_t i = 0; i < case_count; i++) {
+        failures += rgsl_check_spec_value(SPEC_VALUES[i], &first_specialized);
+    }
+    rgsl_free_variant(&first_specialized);
+    rgsl_compile_finalize();
+    rgsl_glslang_finalize();
+    printf("%zu specialization cases, %d failed\n", case_count, failures);
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
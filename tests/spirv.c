@@ -0,0 +1,96 @@
+#include <RGSL/rgsl.h>
+#include <RGSL/compile.h>
+#include <RGSL/program.h>
+#include <RGSL/fileio.h>
+#include <RGSL/external/glslang_c.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Compiles the RGSL examples to SPIR-V with the backend of RGSL, and checks each
+ * module with the validator of SPIRV-Tools, which the driver only runs with
+ * --spirv-validate.
+ */
+#define RGSL_EXAMPLES_DIR RGSL_SOURCE_DIR "/examples/raeptor_cogs"
+
+static const char* const SPIRV_CASES[] = {
+    RGSL_EXAMPLES_DIR "/rgsl/main.rvert",
+    RGSL_EXAMPLES_DIR "/rgsl/main.rfrag",
+    RGSL_EXAMPLES_DIR "/rgsl/mask.rfrag",
+    RGSL_EXAMPLES_DIR "/rgsl/main.rgsl",
+};
+
+static int rgsl_check_stage(struct rgsl_shader_data* shader) {
+    char* words = NULL;
+    size_t size = 0;
+    if (!rgsl_compile_shader(shader, &words, &size)) {
+        fprintf(stderr, "FAIL: %s (%s) does not compile\n", shader->path, shader->stage);
+        return 1;
+    }
+    int failures = 0;
+    char* log = rgsl_glslang_validate_spirv((const uint32_t *)words, size / sizeof(uint32_t), 0);
+    if (log != NULL) {
+        fprintf(stderr, "FAIL: %s (%s) is not valid SPIR-V:\n%s\n", shader->path, shader->stage, log);
+        rgsl_free(log);
+        failures++;
+    }
+    rgsl_free_file_buffer(words);
+    return failures;
+}
+
+static int rgsl_check_spirv_case(const char* path, size_t* out_stage_count) {
+    char* raw_code = NULL;
+    if (rgsl_read_file(path, &raw_code) == 0) {
+        fprintf(stderr, "FAIL: cannot read %s\n", path);
+        return 1;
+    }
+    struct rgsl_shader_data shader;
+    memset(&shader, 0, sizeof(shader));
+    shader.name = rgsl_determine_shader_name(path);
+    shader.path = path;
+    shader.code = rgsl_crlf_to_lf(raw_code);
+    shader.language = rgsl_determine_shader_language(path);
+    shader.stage = rgsl_determine_shader_stage(path);
+    rgsl_free_file_buffer(raw_code);
+    if (!rgsl_is_program_code(shader.code)) {
+        int failures = rgsl_check_stage(&shader);
+        rgsl_release_shader(&shader);
+        *out_stage_count += 1;
+        return failures;
+    }
+    struct rgsl_shader_data* stages = NULL;
+    size_t count = 0;
+    bool split = rgsl_split_program(&shader, &stages, &count);
+    rgsl_release_shader(&shader);
+    if (!split) {
+        fprintf(stderr, "FAIL: %s cannot be split into its stages\n", path);
+        return 1;
+    }
+    rgsl_build_program_stages(stages, count);
+    int failures = 0;
+    for (size_t i = 0; i < count; i++) {
+        failures += rgsl_check_stage(&stages[i]);
+        rgsl_release_shader(&stages[i]);
+    }
+    rgsl_free(stages);
+    *out_stage_count += count;
+    return failures;
+}
+
+int main() {
+    rgsl_initialize();
+    rgsl_global_options.verbose = 0;
+    rgsl_global_options.action = RGSL_ACTION_COMPILE_SPIRV;
+    rgsl_global_options.include_paths[0] = RGSL_EXAMPLES_DIR;
+    rgsl_glslang_initialize();
+    int failures = 0;
+    size_t stage_count = 0;
+    size_t case_count = sizeof(SPIRV_CASES) / sizeof(SPIRV_CASES[0]);
+    for (size_t i = 0; i < case_count; i++) {
+        failures += rgsl_check_spirv_case(SPIRV_CASES[i], &stage_count);
+    }
+    rgsl_glslang_finalize();
+    printf("%zu SPIR-V modules, %d failed\n", stage_count, failures);
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file
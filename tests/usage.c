@@ -0,0 +1,128 @@
+#include <RGSL/rgsl.h>
+#include <RGSL/usage.h>
+#include <RGSL/memory.h>
+#include <stdio.h>
+#include <string.h>
+
+/**
+ * Checks the order a usage profile gives the shaders of a package, which the
+ * driver compiles and the packager writes them in, the startup shaders the hot
+ * part keeps with --split-cold, for a startup time, and that this layout faults
+ * in fewer pages than the order of the command line.
+ */
+struct rgsl_usage_case {
+    int startup_ms;
+    size_t order[6];
+    bool startup[6];
+};
+
+static const char* const USAGE_PROFILE =
+    "# shader          first use (ms)  uses\n"
+    "shader_c          1.5             100\n"
+    "a                 4.0             50\n"
+    "shader_d          4.0             80\n"
+    "shaders/e.frag    900             2\n"
+    "shader_unused     2.0             10\n";
+
+// In the order of the command line, b and f are not in the profile.
+static const char* const USAGE_PATHS[6] = {"shaders/a.frag", "shaders/b.frag", "shaders/c.frag", "shaders/d.frag", "shaders/e.frag", "shaders/f.frag"};
+static const char* const USAGE_NAMES[6] = {"a", "b", "c", "d", "e", "f"};
+
+static const struct rgsl_usage_case USAGE_CASES[] = {
+    // c first, d before a as it is used more at the same time, e after startup, then b and f as given.
+    {500, {2, 3, 0, 4, 1, 5}, {true, false, true, true, false, false}},
+    // Without a startup time, every shader of the profile is a startup shader.
+    {0, {2, 3, 0, 4, 1, 5}, {true, false, true, true, true, false}},
+    // Startup ends before d and a are used, their order stays the same.
+    {3, {2, 3, 0, 4, 1, 5}, {false, false, true, false, false, false}},
+};
+
+static bool rgsl_write_profile(const char* path) {
+    FILE* file = NULL;
+    fopen_s(&file, path, "w");
+    if (file == NULL) {
+        fprintf(stderr, "Failed to write %s\n", path);
+        return false;
+    }
+    fputs(USAGE_PROFILE, file);
+    fclose(file);
+    return true;
+}
+
+static int rgsl_check_usage_case(const char* path, const struct rgsl_usage_case* test) {
+    struct rgsl_usage_profile profile;
+    if (!rgsl_usage_profile_load(&profile, path)) {
+        rgsl_usage_profile_free(&profile);
+        return 1;
+    }
+    profile.startup_ms = (double)test->startup_ms;
+    int failures = 0;
+    size_t order[6];
+    rgsl_usage_order(&profile, USAGE_PATHS, USAGE_NAMES, 6, order);
+    for (size_t i = 0; i < 6; i++) {
+        if (order[i] != test->order[i]) {
+            fprintf(stderr, "FAIL: startup %d ms, position %zu holds %s instead of %s\n", test->startup_ms, i,
+                USAGE_NAMES[order[i]], USAGE_NAMES[test->order[i]]);
+            failures++;
+        }
+        bool startup = rgsl_usage_is_startup(&profile, USAGE_PATHS[i], USAGE_NAMES[i]);
+        if (startup != test->startup[i]) {
+            fprintf(stderr, "FAIL: startup %d ms, %s is %s instead of %s\n", test->startup_ms, USAGE_NAMES[i],
+                startup ? "hot" : "cold", test->startup[i] ? "hot" : "cold");
+            failures++;
+        }
+    }
+    rgsl_usage_profile_free(&profile);
+    return failures;
+}
+
+static int rgsl_check_usage_faults(const char* path) {
+    // Blobs of 5000 bytes: the three startup shaders span 4 pages together, 5 in command-line order.
+    struct rgsl_usage_profile profile;
+    if (!rgsl_usage_profile_load(&profile, path)) {
+        rgsl_usage_profile_free(&profile);
+        return 1;
+    }
+    profile.startup_ms = 500.0;
+    size_t order[6];
+    rgsl_usage_order(&profile, USAGE_PATHS, USAGE_NAMES, 6, order);
+    struct rgsl_usage_blob blobs[6];
+    size_t command_line[6];
+    for (size_t i = 0; i < 6; i++) {
+        blobs[i].path = USAGE_PATHS[i];
+        blobs[i].name = (char *)USAGE_NAMES[i];
+        blobs[i].content_hash.low = i + 1;
+        blobs[i].content_hash.high = 0;
+        blobs[i].size = 5000;
+        blobs[i].cold = !rgsl_usage_is_startup(&profile, USAGE_PATHS[i], USAGE_NAMES[i]);
+        command_line[i] = i;
+    }
+    size_t startup, total, baseline_startup, baseline_total;
+    rgsl_usage_count_faults(&profile, blobs, order, 6, true, &startup, &total);
+    rgsl_usage_count_faults(&profile, blobs, command_line, 6, false, &baseline_startup, &baseline_total);
+    rgsl_usage_profile_free(&profile);
+    if (startup != 4 || total != 6 || baseline_startup != 5 || baseline_total != 7 || startup >= baseline_startup) {
+        fprintf(stderr, "FAIL: startup faults %zu (%zu in total), %zu (%zu) in command-line order, expected 4 (6) and 5 (7)\n",
+            startup, total, baseline_startup, baseline_total);
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    rgsl_initialize();
+    rgsl_global_options.verbose = 0;
+    const char* path = "usage_profile.txt";
+    if (!rgsl_write_profile(path)) {
+        return 1;
+    }
+    int failures = 0;
+    size_t case_count = sizeof(USAGE_CASES) / sizeof(USAGE_CASES[0]);
+    for (size_t i = 0; i < case_count; i++) {
+        failures += rgsl_check_usage_case(path, &USAGE_CASES[i]);
+    }
+    failures += rgsl_check_usage_faults(path);
+    remove(path);
+    printf("%zu usage cases, %d failed\n", case_count, failures);
+    return failures == 0 ? 0 : 1;
+}
\ No newline at end of file